@@ -1,6 +1,7 @@
 using BenchmarkDotNet.Attributes;
 using AcornDB;
 using AcornDB.Storage;
+using AcornDB.Indexing;
 
 namespace AcornDB.Benchmarks
 {
@@ -13,6 +14,7 @@ namespace AcornDB.Benchmarks
     {
         private Tree<TestItem>? _memoryTree;
         private Tree<TestItem>? _fileTree;
+        private Tree<TestItem>? _indexedTree;
         private const int ItemCount = 1000;
 
         public class TestItem
@@ -29,6 +31,14 @@ namespace AcornDB.Benchmarks
             // Create trees with different trunk types
             _memoryTree = new Tree<TestItem>(new MemoryTrunk<TestItem>());
             _fileTree = new Tree<TestItem>(new FileTrunk<TestItem>());
+
+            // Every stash extracts the ID and three index keys through compiled accessors
+            _indexedTree = new Tree<TestItem>(new MemoryTrunk<TestItem>());
+            _indexedTree.AddIndex(new ManagedScalarIndex<TestItem, string>(i => i.Name));
+            _indexedTree.AddIndex(new ManagedScalarIndex<TestItem, int>(i => i.Value));
+            _indexedTree.AddIndex(new ManagedCompositeIndex<TestItem>(
+                "IX_TestItem_Value_Timestamp",
+                new System.Linq.Expressions.Expression<Func<TestItem, object>>[] { i => i.Value, i => i.Timestamp }));
         }
 
         [GlobalCleanup]
@@ -56,6 +66,21 @@ namespace AcornDB.Benchmarks
             }
         }
 
+        [Benchmark]
+        public void Stash_MemoryTrunk_ThreeIndexes_1000Items()
+        {
+            for (int i = 0; i < ItemCount; i++)
+            {
+                _indexedTree!.Stash(new TestItem
+                {
+                    Id = $"item-{i}",
+                    Name = $"Test Item {i}",
+                    Value = i,
+                    Timestamp = DateTime.UtcNow
+                });
+            }
+        }
+
         [Benchmark]
         public void Stash_FileTrunk_1000Items()
         {
@@ -63,7 +63,12 @@ namespace AcornDB.Benchmarks
 
         private Tree<TestDocument> CreateTreeWithCache(ITrunk<TestDocument> trunk, int maxCacheSize)
         {
-            var tree = new Tree<TestDocument>(trunk, new LRUCacheStrategy<TestDocument>(maxCacheSize));
+            return CreateTreeWithCache(trunk, new LRUCacheStrategy<TestDocument>(maxCacheSize));
+        }
+
+        private Tree<TestDocument> CreateTreeWithCache(ITrunk<TestDocument> trunk, ICacheStrategy<TestDocument> strategy)
+        {
+            var tree = new Tree<TestDocument>(trunk, strategy);
             tree.TtlEnforcementEnabled = false;
             tree.CacheEvictionEnabled = true;
             return tree;
@@ -516,6 +521,114 @@ namespace AcornDB.Benchmarks
             _btreeTrunk = null;
         }
 
+        // ===== Scan Resistance (hot set + one-off full scan) =====
+
+        /// <summary>
+        /// Warm a hot set half the size of the cache, run one pass over the whole dataset (an
+        /// export or cold-branch sync) while the hot set keeps getting occasional reads, then
+        /// read the hot set again. Returns the hit rate of the reads after the scan.
+        /// </summary>
+        private static double RunHotSetWithScan(Func<string, TestDocument?> read, Func<CacheStats> stats, int datasetSize, int cacheSize)
+        {
+            int hotSetSize = Math.Max(1, cacheSize / 2);
+
+            for (int round = 0; round < 5; round++)
+            {
+                for (int i = 0; i < hotSetSize; i++)
+                {
+                    read($"doc-{i}");
+                }
+            }
+
+            for (int i = hotSetSize; i < datasetSize; i++)
+            {
+                read($"doc-{i}");
+                if (i % 10 == 0)
+                    read($"doc-{i / 10 % hotSetSize}");
+            }
+
+            var before = stats();
+            var random = new Random(42);
+            for (int i = 0; i < 10_000; i++)
+            {
+                read($"doc-{random.Next(0, hotSetSize)}");
+            }
+            var after = stats();
+
+            var hits = after.HitCount - before.HitCount;
+            var misses = after.MissCount - before.MissCount;
+            return hits + misses == 0 ? 0 : (double)hits / (hits + misses);
+        }
+
+        private double RunTreeScanScenario(string name, ICacheStrategy<TestDocument> strategy)
+        {
+            var dir = Path.Combine(_tempDir, $"{name}_{Guid.NewGuid()}");
+            _btreeTrunk = new BTreeTrunk<TestDocument>(dir);
+            _tree = CreateTreeWithCache(_btreeTrunk, strategy);
+
+            for (int i = 0; i < DatasetSize; i++)
+            {
+                _tree.Stash(CreateDocument(i));
+            }
+
+            var tree = _tree;
+            var hitRate = RunHotSetWithScan(tree.Crack, tree.GetCacheStats, DatasetSize, CacheSize);
+
+            _btreeTrunk.Dispose();
+            _btreeTrunk = null;
+            return hitRate;
+        }
+
+        private double RunCachedTrunkScanScenario(string name, CacheEvictionPolicy policy)
+        {
+            var dir = Path.Combine(_tempDir, $"{name}_{Guid.NewGuid()}");
+            _btreeTrunk = new BTreeTrunk<TestDocument>(dir);
+            for (int i = 0; i < DatasetSize; i++)
+            {
+                var doc = CreateDocument(i);
+                _btreeTrunk.Stash(doc.Id, new Nut<TestDocument> { Id = doc.Id, Payload = doc, Timestamp = DateTime.UtcNow });
+            }
+
+            var cached = new CachedTrunk<TestDocument>(_btreeTrunk, new CacheOptions
+            {
+                TimeToLive = null,
+                MaxCacheSize = CacheSize,
+                EvictionPolicy = policy
+            });
+            var hitRate = RunHotSetWithScan(id => cached.Crack(id)?.Payload, cached.GetCacheStats, DatasetSize, CacheSize);
+
+            _btreeTrunk.Dispose();
+            _btreeTrunk = null;
+            return hitRate;
+        }
+
+        [Benchmark]
+        public double ScanResistance_Tree_LRU()
+        {
+            // The scan pushes most of the hot set out; post-scan reads start cold
+            return RunTreeScanScenario("scan_lru", new LRUCacheStrategy<TestDocument>(CacheSize));
+        }
+
+        [Benchmark]
+        public double ScanResistance_Tree_WTinyLFU()
+        {
+            // Scan items lose the admission contest, so the hot set stays cached (~100% hit rate)
+            return RunTreeScanScenario("scan_tinylfu", new WTinyLFUCacheStrategy<TestDocument>(CacheSize));
+        }
+
+        [Benchmark]
+        public double ScanResistance_CachedTrunk_OldestTimestamp()
+        {
+            return RunCachedTrunkScanScenario("scan_cached_oldest", CacheEvictionPolicy.OldestTimestamp);
+        }
+
+        [Benchmark]
+        public double ScanResistance_CachedTrunk_WTinyLFU()
+        {
+            // Also avoids the full load-and-sort that timestamp eviction does on every insert
+            return RunCachedTrunkScanScenario("scan_cached_tinylfu", CacheEvictionPolicy.WTinyLFU);
+        }
+
         // ===== Mixed Read/Write Workload =====
 
         [Benchmark]
@@ -574,6 +687,11 @@ namespace AcornDB.Benchmarks
     /// - No Eviction: 0% overhead, but unbounded memory growth
     /// - Cache Thrashing: Performance degrades when working set > cache size
     ///
+    /// Scan Resistance (hot set = CacheSize / 2, one pass over the dataset):
+    /// - LRU: the scan flushes the hot set, which then has to be re-read from disk
+    /// - W-TinyLFU: scan items are rejected at admission, hot set hit rate stays ~100%
+    /// - CachedTrunk W-TinyLFU: O(1) per eviction instead of loading and sorting the cache
+    ///
     /// Memory Footprint:
     /// - Small Cache (100): ~50KB (minimal memory, high disk I/O)
     /// - Medium Cache (1000): ~500KB (balanced)
@@ -534,6 +534,88 @@ namespace AcornDB.Benchmarks
         }
     }
 
+    /// <summary>
+    /// Tree cache scaling under mixed workloads: each thread performs a fixed number of
+    /// operations on a shared tree over a shared key space, split between Crack and Stash by
+    /// ReadPercent (90 = read-heavy, 10 = write-heavy). Cache hits take no lock, so the
+    /// read-heavy mix should scale with cores; writes serialize only per key stripe.
+    ///
+    /// Uses ShardedLRUCacheStrategy: the single-lock LRU would serialize every hit on its
+    /// recency update and hide the cache's own scaling.
+    /// </summary>
+    [MemoryDiagnoser]
+    [SimpleJob(warmupCount: 2, iterationCount: 5)]
+    public class TreeCacheScalingBenchmarks
+    {
+        private const int KeyCount = 10_000;
+        private const int OperationsPerThread = 20_000;
+
+        private Tree<ConcurrencyBenchmarks.TestDocument> _tree = null!;
+        private string[] _keys = Array.Empty<string>();
+
+        [Params(1, 2, 4, 8, 16, 32, 64)]
+        public int ThreadCount;
+
+        [Params(90, 10)]
+        public int ReadPercent;
+
+        [GlobalSetup]
+        public void Setup()
+        {
+            _tree = new Tree<ConcurrencyBenchmarks.TestDocument>(
+                new MemoryTrunk<ConcurrencyBenchmarks.TestDocument>(),
+                new AcornDB.Cache.ShardedLRUCacheStrategy<ConcurrencyBenchmarks.TestDocument>(maxSize: KeyCount * 2));
+            _tree.TtlEnforcementEnabled = false;
+
+            _keys = Enumerable.Range(0, KeyCount).Select(i => $"doc-{i}").ToArray();
+            foreach (var key in _keys)
+            {
+                _tree.Stash(key, new ConcurrencyBenchmarks.TestDocument { Id = key, Name = key });
+            }
+        }
+
+        [Benchmark(OperationsPerInvoke = OperationsPerThread)]
+        public void Mixed_Crack_Stash()
+        {
+            // Dedicated threads released together, so the thread count is the real concurrency
+            using var start = new ManualResetEventSlim(false);
+            var threads = new Thread[ThreadCount];
+            for (int t = 0; t < ThreadCount; t++)
+            {
+                int seed = t;
+                threads[t] = new Thread(() =>
+                {
+                    var random = new Random(seed);
+                    start.Wait();
+                    for (int i = 0; i < OperationsPerThread; i++)
+                    {
+                        var key = _keys[random.Next(_keys.Length)];
+                        if (random.Next(100) < ReadPercent)
+                        {
+                            _tree.Crack(key);
+                        }
+                        else
+                        {
+                            _tree.Stash(key, new ConcurrencyBenchmarks.TestDocument { Id = key, Name = key, Value = i });
+                        }
+                    }
+                });
+                threads[t].Start();
+            }
+
+            start.Set();
+            foreach (var thread in threads)
+            {
+                thread.Join();
+            }
+
+            if (_tree.NutCount != KeyCount)
+            {
+                throw new Exception($"Expected {KeyCount} documents, got {_tree.NutCount}");
+            }
+        }
+    }
+
     /// <summary>
     /// Expected Concurrency Results:
     ///
@@ -1,3 +1,4 @@
+using System.Text.Json;
 using BenchmarkDotNet.Attributes;
 using AcornDB;
 using AcornDB.Storage;
@@ -281,6 +282,151 @@ namespace AcornDB.Benchmarks
         }
     }
 
+    /// <summary>
+    /// Bytes on the wire to bring a replica up to date after 0.1%, 1% and 10% of the other
+    /// side's nuts changed: shipping every nut (what an export shake does) vs Merkle
+    /// anti-entropy, which compares hashes top-down and ships only the divergent nuts.
+    /// Requests and responses are serialized with System.Text.Json, as Branch sends them;
+    /// the byte counts are printed once per parameter set and returned by each benchmark.
+    /// </summary>
+    [MemoryDiagnoser]
+    [SimpleJob(warmupCount: 2, iterationCount: 5)]
+    public class MerkleAntiEntropyBenchmarks
+    {
+        private Tree<DeltaSyncBenchmarks.TestItem> _local = null!;
+        private Tree<DeltaSyncBenchmarks.TestItem> _remote = null!;
+
+        [Params(10_000, 100_000)]
+        public int TotalDocuments;
+
+        [Params(0.001, 0.01, 0.10)]  // 0.1%, 1%, 10% divergent
+        public double DivergencePercentage;
+
+        [GlobalSetup]
+        public void ReportBytesOnWire()
+        {
+            Setup();
+            var full = FullShake_BytesOnWire();
+            Setup();
+            var merkle = MerkleReconcile_BytesOnWire().GetAwaiter().GetResult();
+
+            Console.WriteLine($"// {TotalDocuments} docs, {DivergencePercentage:P1} divergent: " +
+                              $"full shake {full:N0} B, Merkle reconcile {merkle:N0} B ({(double)merkle / full:P2})");
+        }
+
+        [IterationSetup]
+        public void Setup()
+        {
+            _local = new Tree<DeltaSyncBenchmarks.TestItem>(new MemoryTrunk<DeltaSyncBenchmarks.TestItem>());
+            _remote = new Tree<DeltaSyncBenchmarks.TestItem>(new MemoryTrunk<DeltaSyncBenchmarks.TestItem>());
+
+            for (int i = 0; i < TotalDocuments; i++)
+            {
+                _remote.Stash(new DeltaSyncBenchmarks.TestItem
+                {
+                    Id = $"item-{i}",
+                    Name = $"Item {i}",
+                    Value = i,
+                    Modified = DateTime.UtcNow
+                });
+            }
+
+            // Replicate, then diverge: the remote's copies of every k-th nut move on
+            foreach (var nut in _remote.NutShells())
+            {
+                _local.Squabble(nut.Id, nut);
+            }
+
+            int divergent = Math.Max(1, (int)(TotalDocuments * DivergencePercentage));
+            int stride = TotalDocuments / divergent;
+            for (int i = 0; i < divergent; i++)
+            {
+                _remote.Stash(new DeltaSyncBenchmarks.TestItem
+                {
+                    Id = $"item-{i * stride}",
+                    Name = $"Updated Item {i}",
+                    Value = i * 2,
+                    Modified = DateTime.UtcNow
+                });
+            }
+        }
+
+        [Benchmark(Baseline = true)]
+        public long FullShake_BytesOnWire()
+        {
+            var bytes = JsonSerializer.SerializeToUtf8Bytes(_remote.ExportChanges().ToList());
+            var nuts = JsonSerializer.Deserialize<List<Nut<DeltaSyncBenchmarks.TestItem>>>(bytes)!;
+
+            foreach (var nut in nuts)
+            {
+                _local.Squabble(nut.Id, nut);
+            }
+
+            return bytes.Length;
+        }
+
+        [Benchmark]
+        public async Task<long> MerkleReconcile_BytesOnWire()
+        {
+            var peer = new WireCountingPeer<DeltaSyncBenchmarks.TestItem>(new TreeMerklePeer<DeltaSyncBenchmarks.TestItem>(_remote));
+            var diff = await MerkleReconciler.SyncAsync(_local, peer, pull: true, push: false);
+
+            if (_local.Merkle.RootHash != _remote.Merkle.RootHash)
+            {
+                throw new Exception($"Replicas still differ after pulling {diff.NutsPulled} nuts");
+            }
+
+            return peer.BytesOnWire;
+        }
+
+        /// <summary>
+        /// Peer that serializes every request and response, counting the bytes
+        /// </summary>
+        private sealed class WireCountingPeer<T> : IMerklePeer<T> where T : class
+        {
+            private readonly IMerklePeer<T> _inner;
+
+            public long BytesOnWire { get; private set; }
+
+            public WireCountingPeer(IMerklePeer<T> inner)
+            {
+                _inner = inner;
+            }
+
+            public async Task<MerkleSummary> GetSummaryAsync() => Count(await _inner.GetSummaryAsync());
+
+            public async Task<IReadOnlyList<ulong>> GetChildHashesAsync(int level, IReadOnlyList<int> nodes)
+            {
+                Count(new { level, nodes });
+                return Count(await _inner.GetChildHashesAsync(level, nodes));
+            }
+
+            public async Task<IReadOnlyDictionary<string, long>> GetLeafEntriesAsync(IReadOnlyList<int> leaves)
+            {
+                Count(leaves);
+                return Count(await _inner.GetLeafEntriesAsync(leaves));
+            }
+
+            public async Task<IReadOnlyList<Nut<T>>> FetchAsync(IReadOnlyList<string> ids)
+            {
+                Count(ids);
+                return Count(await _inner.FetchAsync(ids));
+            }
+
+            public Task StoreAsync(IReadOnlyList<Nut<T>> nuts)
+            {
+                Count(nuts);
+                return _inner.StoreAsync(nuts);
+            }
+
+            private TValue Count<TValue>(TValue value)
+            {
+                BytesOnWire += JsonSerializer.SerializeToUtf8Bytes(value).Length;
+                return value;
+            }
+        }
+    }
+
     /// <summary>
     /// Expected Results:
     ///
@@ -234,6 +234,54 @@ namespace AcornDB.Benchmarks
             _docStoreTrunk = null;
         }
 
+        [Benchmark]
+        public void CrashRecovery_DocumentStoreTrunk_Rewrites_FullLogReplay()
+        {
+            ReopenAfterRewrites(snapshot: false);
+        }
+
+        [Benchmark]
+        public void CrashRecovery_DocumentStoreTrunk_Rewrites_FromSnapshot()
+        {
+            ReopenAfterRewrites(snapshot: true);
+        }
+
+        /// <summary>
+        /// Rewrite every document 10 times, then reopen: without a snapshot the whole log is
+        /// replayed, with one only the live documents are loaded (history stays on disk)
+        /// </summary>
+        private void ReopenAfterRewrites(bool snapshot)
+        {
+            var dir = Path.Combine(_tempDir, $"docstore_rewrites_{Guid.NewGuid()}");
+            _docStoreTrunk = new DocumentStoreTrunk<TestDocument>(dir) { SnapshotIntervalBytes = 0 };
+            _tree = CreateTree(_docStoreTrunk);
+
+            for (int round = 0; round < 10; round++)
+            {
+                for (int i = 0; i < DocumentCount; i++)
+                {
+                    var doc = CreateDocument(i);
+                    doc.Value = round;
+                    _tree.Stash(doc);
+                }
+            }
+
+            if (snapshot)
+                _docStoreTrunk.Snapshot();
+            _docStoreTrunk.Dispose();
+
+            _docStoreTrunk = new DocumentStoreTrunk<TestDocument>(dir) { SnapshotIntervalBytes = 0 };
+            _tree = CreateTree(_docStoreTrunk);
+
+            if (_tree.NutCount != DocumentCount || _docStoreTrunk.GetHistory("doc-0").Count != 9)
+            {
+                throw new Exception("Recovery failed after rewrites");
+            }
+
+            _docStoreTrunk.Dispose();
+            _docStoreTrunk = null;
+        }
+
         // ===== Incremental Updates (Durability Under Modifications) =====
 
         [Benchmark]
@@ -618,6 +666,109 @@ namespace AcornDB.Benchmarks
         }
     }
 
+    /// <summary>
+    /// Throughput vs commit latency for each <see cref="DurabilityMode"/> with concurrent
+    /// writers awaiting <c>StashAsync</c> on a BTreeTrunk. BenchmarkDotNet reports per-write
+    /// throughput; the p50/p99 time from StashAsync to completion is printed after each
+    /// iteration, since that is the number GroupCommit trades against Sync.
+    /// </summary>
+    [MemoryDiagnoser]
+    [SimpleJob(warmupCount: 2, iterationCount: 5)]
+    public class DurabilityModeBenchmarks
+    {
+        // Fixed total so per-operation numbers compare across writer counts
+        private const int TotalWrites = 3_200;
+
+        private BTreeTrunk<DurabilityBenchmarks.TestDocument>? _trunk;
+        private string _tempDir = string.Empty;
+        private readonly List<double> _latenciesMs = new();
+
+        [Params(DurabilityMode.None, DurabilityMode.Buffered, DurabilityMode.GroupCommit, DurabilityMode.Sync)]
+        public DurabilityMode Mode;
+
+        [Params(1, 16)]
+        public int Writers;
+
+        [GlobalSetup]
+        public void Setup()
+        {
+            _tempDir = Path.Combine(Path.GetTempPath(), $"acorndb_durability_modes_{Guid.NewGuid()}");
+            Directory.CreateDirectory(_tempDir);
+        }
+
+        [GlobalCleanup]
+        public void Cleanup()
+        {
+            if (Directory.Exists(_tempDir))
+            {
+                try { Directory.Delete(_tempDir, recursive: true); } catch { }
+            }
+        }
+
+        [IterationSetup]
+        public void IterationSetup()
+        {
+            _trunk = new BTreeTrunk<DurabilityBenchmarks.TestDocument>(Path.Combine(_tempDir, Guid.NewGuid().ToString("N")));
+            _trunk.Durability = Mode;
+            _latenciesMs.Clear();
+        }
+
+        [IterationCleanup]
+        public void IterationCleanup()
+        {
+            var stats = _trunk!.GetDurabilityStats();
+            _trunk.Dispose();
+            _trunk = null;
+
+            _latenciesMs.Sort();
+            Console.WriteLine(
+                $"// {Mode} x{Writers}: p50={Percentile(0.50):F3}ms p99={Percentile(0.99):F3}ms " +
+                $"fsyncs={stats.DiskFlushes} avgGroup={stats.AverageGroupSize:F1}");
+        }
+
+        [Benchmark(OperationsPerInvoke = TotalWrites)]
+        public void ConcurrentStashAsync()
+        {
+            var trunk = _trunk!;
+            var perWriter = TotalWrites / Writers;
+            var tasks = new Task<double[]>[Writers];
+            for (int w = 0; w < Writers; w++)
+            {
+                int writer = w;
+                tasks[w] = Task.Run(async () =>
+                {
+                    var latencies = new double[perWriter];
+                    for (int i = 0; i < perWriter; i++)
+                    {
+                        var id = $"doc-{writer}-{i}";
+                        var nut = new Nut<DurabilityBenchmarks.TestDocument>
+                        {
+                            Id = id,
+                            Payload = new DurabilityBenchmarks.TestDocument { Id = id, Name = id, Content = new string('x', 256), Value = i },
+                            Timestamp = DateTime.UtcNow
+                        };
+
+                        var start = Stopwatch.GetTimestamp();
+                        await trunk.StashAsync(id, nut);
+                        latencies[i] = Stopwatch.GetElapsedTime(start).TotalMilliseconds;
+                    }
+                    return latencies;
+                });
+            }
+
+            foreach (var latencies in Task.WhenAll(tasks).GetAwaiter().GetResult())
+            {
+                _latenciesMs.AddRange(latencies);
+            }
+        }
+
+        private double Percentile(double p)
+        {
+            if (_latenciesMs.Count == 0) return 0;
+            return _latenciesMs[Math.Min(_latenciesMs.Count - 1, (int)(p * _latenciesMs.Count))];
+        }
+    }
+
     /// <summary>
     /// Expected Durability Results:
     ///
@@ -630,6 +781,8 @@ namespace AcornDB.Benchmarks
     /// Crash Recovery Time (RTO):
     /// - BTreeTrunk: ~20ms for 1K docs, ~200ms for 10K docs (fast startup)
     /// - DocumentStoreTrunk: ~50ms for 1K docs, ~800ms for 10K docs (log replay)
+    /// - DocumentStoreTrunk after 10 rewrites per doc: replay time grows with the log; from a
+    ///   snapshot it only depends on the live documents, and history is read back on demand
     /// - FileTrunk: ~30ms for 1K docs (directory scan + metadata read)
     ///
     /// Write Throughput vs Durability Tradeoff:
@@ -645,7 +798,7 @@ namespace AcornDB.Benchmarks
     ///
     /// Bulk Delete:
     /// - BTreeTrunk: Physical deletion, reclaims disk space
-    /// - DocumentStoreTrunk: Logical deletion (tombstones), disk space grows
+    /// - DocumentStoreTrunk: Logical deletion (tombstones) until the next snapshot drops them
     /// - FileTrunk: Physical deletion (file removal)
     ///
     /// Concurrent Writes Durability:
@@ -657,7 +810,7 @@ namespace AcornDB.Benchmarks
     /// Data Integrity:
     /// - Zero data corruption expected across all trunks
     /// - BTreeTrunk: CRC checks on memory-mapped file pages
-    /// - DocumentStoreTrunk: Sequential log with checksums
+    /// - DocumentStoreTrunk: Binary log and snapshot records with FNV-1a checksums; torn tails cut on open
     /// - FileTrunk: OS file system guarantees
     ///
     /// Recommendation:
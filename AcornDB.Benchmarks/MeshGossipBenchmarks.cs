@@ -0,0 +1,83 @@
+using BenchmarkDotNet.Attributes;
+using AcornDB;
+using AcornDB.Storage;
+using AcornDB.Sync;
+
+namespace AcornDB.Benchmarks
+{
+    /// <summary>
+    /// Time for a burst of writes on random nodes to reach every node of a 100-1000 node
+    /// in-process mesh by gossip, at different fanouts. Nodes have no links, so each round
+    /// every node reconciles with Fanout random peers. The rounds and nuts transferred for
+    /// each configuration are printed once during setup.
+    /// </summary>
+    [MemoryDiagnoser]
+    [SimpleJob(warmupCount: 1, iterationCount: 5)]
+    public class MeshGossipBenchmarks
+    {
+        public class Reading
+        {
+            public string Id { get; set; } = string.Empty;
+            public string Sensor { get; set; } = string.Empty;
+            public double Value { get; set; }
+        }
+
+        [Params(100, 1000)]
+        public int NodeCount;
+
+        [Params(2, 4)]
+        public int Fanout;
+
+        private const int Writes = 20;
+        private MeshCoordinator<Reading> _mesh = null!;
+
+        [GlobalSetup]
+        public void GlobalSetup()
+        {
+            var trial = BuildMesh();
+            trial.GossipUntilConvergedAsync().GetAwaiter().GetResult();
+            var stats = trial.GetNetworkStats().Gossip;
+            Console.WriteLine($"// {NodeCount} nodes, fanout {Fanout}: converged={stats.Converged} in " +
+                              $"{stats.LastConvergenceRounds} rounds, {stats.NutsTransferred} nuts transferred, " +
+                              $"{stats.DuplicatesSuppressed} duplicates suppressed");
+        }
+
+        [IterationSetup]
+        public void IterationSetup()
+        {
+            _mesh = BuildMesh();
+        }
+
+        [Benchmark]
+        public bool Gossip_UntilConverged()
+        {
+            return _mesh.GossipUntilConvergedAsync().GetAwaiter().GetResult();
+        }
+
+        private MeshCoordinator<Reading> BuildMesh()
+        {
+            var mesh = new MeshCoordinator<Reading>().EnableGossip(Fanout, seed: 7);
+            var nodes = new List<Tree<Reading>>(NodeCount);
+            for (int i = 0; i < NodeCount; i++)
+            {
+                var tree = new Tree<Reading>(new MemoryTrunk<Reading>());
+                tree.TtlEnforcementEnabled = false;
+                mesh.AddNode($"node-{i}", tree);
+                nodes.Add(tree);
+            }
+
+            var random = new Random(11);
+            for (int i = 0; i < Writes; i++)
+            {
+                nodes[random.Next(NodeCount)].Stash(new Reading
+                {
+                    Id = $"reading-{i}",
+                    Sensor = $"sensor-{i % 5}",
+                    Value = random.NextDouble()
+                });
+            }
+
+            return mesh;
+        }
+    }
+}
@@ -40,10 +40,28 @@ namespace AcornDB.Benchmarks
                         break;
                     case "delta":
                         BenchmarkRunner.Run<DeltaSyncBenchmarks>();
+                        BenchmarkRunner.Run<MerkleAntiEntropyBenchmarks>();
                         break;
                     case "redis":
                         BenchmarkRunner.Run<RedisCacheBenchmarks>();
                         break;
+                    case "roots":
+                        BenchmarkRunner.Run<RootPipelineAllocationBenchmarks>();
+                        BenchmarkRunner.Run<RootPipelineBenchmarks>();
+                        break;
+                    case "durability":
+                        BenchmarkRunner.Run<DurabilityModeBenchmarks>();
+                        break;
+                    case "concurrency":
+                        BenchmarkRunner.Run<ConcurrencyBenchmarks>();
+                        BenchmarkRunner.Run<TreeCacheScalingBenchmarks>();
+                        break;
+                    case "serialization":
+                        BenchmarkRunner.Run<SerializationBenchmarks>();
+                        break;
+                    case "mesh":
+                        BenchmarkRunner.Run<MeshGossipBenchmarks>();
+                        break;
                     case "all":
                         RunAllBenchmarks();
                         break;
@@ -84,8 +102,13 @@ namespace AcornDB.Benchmarks
             Console.WriteLine("  sync         - Sync performance (in-process)");
             Console.WriteLine("  conflict     - Conflict resolution (Squabble)");
             Console.WriteLine("  competitive  - AcornDB vs competitors (1K/10K/50K docs)");
-            Console.WriteLine("  delta        - Delta sync efficiency (1%/5%/10%/50% changes)");
+            Console.WriteLine("  delta        - Delta sync efficiency (1%/5%/10%/50% changes), Merkle anti-entropy bytes on the wire");
             Console.WriteLine("  redis        - AcornDB vs Redis cache comparison");
+            Console.WriteLine("  roots        - IRoot pipeline allocations and compression/encryption overhead");
+            Console.WriteLine("  durability   - Durability modes: write throughput vs commit latency (p99)");
+            Console.WriteLine("  concurrency  - Multi-threaded access, cache scaling at 1-64 threads (90/10 and 10/90 mixes)");
+            Console.WriteLine("  serialization - Newtonsoft vs System.Text.Json vs MessagePack encode/decode and size");
+            Console.WriteLine("  mesh         - Gossip convergence time in 100/1000-node in-process meshes (fanout 2/4)");
             Console.WriteLine("  all          - Run all benchmarks (default)");
             Console.WriteLine("\nExamples:");
             Console.WriteLine("  dotnet run");
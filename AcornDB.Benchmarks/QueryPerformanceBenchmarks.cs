@@ -2,6 +2,7 @@ using BenchmarkDotNet.Attributes;
 using AcornDB;
 using AcornDB.Storage;
 using AcornDB.Query;
+using AcornDB.Indexing;
 
 namespace AcornDB.Benchmarks
 {
@@ -14,7 +15,10 @@ namespace AcornDB.Benchmarks
     public class QueryPerformanceBenchmarks
     {
         private Tree<Product>? _tree;
+        private Tree<Product>? _indexedTree;
         private Tree<Order>? _orderTree;
+        private ManagedTimeSeriesIndex<Order>? _orderTimeSeries;
+        private DateTime _now;
 
         public class Product
         {
@@ -24,6 +28,7 @@ namespace AcornDB.Benchmarks
             public decimal Price { get; set; }
             public int StockQuantity { get; set; }
             public string[] Tags { get; set; } = Array.Empty<string>();
+            public string Description { get; set; } = string.Empty;
             public DateTime CreatedDate { get; set; }
             public bool IsActive { get; set; }
         }
@@ -50,13 +55,24 @@ namespace AcornDB.Benchmarks
             _tree.TtlEnforcementEnabled = false;
             _tree.CacheEvictionEnabled = false;
 
+            // Same products, with indexes the query planner can seek
+            _indexedTree = new Tree<Product>(new MemoryTrunk<Product>());
+            _indexedTree.TtlEnforcementEnabled = false;
+            _indexedTree.CacheEvictionEnabled = false;
+            _indexedTree.AddIndex(new ManagedScalarIndex<Product, string>(p => p.Name));
+            _indexedTree.AddIndex(new ManagedScalarIndex<Product, decimal>(p => p.Price));
+            _indexedTree.AddIndex(new ManagedScalarIndex<Product, string>(p => p.Category));
+            _indexedTree.AddIndex(new ManagedTextIndex<Product>(p => p.Description));
+
             var random = new Random(42);
             var categories = new[] { "Electronics", "Clothing", "Books", "Home", "Sports" };
             var tags = new[] { "sale", "new", "featured", "clearance", "premium" };
+            var words = new[] { "wireless", "compact", "durable", "classic", "portable", "ergonomic", "organic",
+                                "vintage", "smart", "waterproof", "lightweight", "handmade", "stainless", "deluxe" };
 
             for (int i = 0; i < ProductCount; i++)
             {
-                _tree.Stash(new Product
+                var product = new Product
                 {
                     Id = $"product-{i}",
                     Name = $"Product {i}",
@@ -64,9 +80,12 @@ namespace AcornDB.Benchmarks
                     Price = (decimal)(random.NextDouble() * 1000),
                     StockQuantity = random.Next(0, 1000),
                     Tags = new[] { tags[i % tags.Length], tags[(i + 1) % tags.Length] },
+                    Description = string.Join(" ", Enumerable.Range(0, 12).Select(_ => words[random.Next(words.Length)])),
                     CreatedDate = DateTime.UtcNow.AddDays(-random.Next(0, 365)),
                     IsActive = i % 10 != 0 // 90% active
-                });
+                };
+                _tree.Stash(product);
+                _indexedTree.Stash(product);
             }
 
             // Setup Orders
@@ -74,6 +93,10 @@ namespace AcornDB.Benchmarks
             _orderTree = new Tree<Order>(orderTrunk);
             _orderTree.TtlEnforcementEnabled = false;
             _orderTree.CacheEvictionEnabled = false;
+            _orderTimeSeries = new ManagedTimeSeriesIndex<Order>(
+                o => o.OrderDate, new IndexConfiguration().BucketHours(1), o => (double)o.TotalAmount);
+            _orderTree.AddIndex(_orderTimeSeries);
+            _now = DateTime.UtcNow;
 
             var statuses = new[] { "Pending", "Processing", "Shipped", "Delivered", "Cancelled" };
 
@@ -83,7 +106,7 @@ namespace AcornDB.Benchmarks
                 {
                     Id = $"order-{i}",
                     CustomerId = $"customer-{random.Next(0, ProductCount / 100)}",
-                    OrderDate = DateTime.UtcNow.AddDays(-random.Next(0, 90)),
+                    OrderDate = _now.AddMinutes(-random.Next(0, 90 * 24 * 60)),
                     TotalAmount = (decimal)(random.NextDouble() * 5000),
                     Status = statuses[i % statuses.Length],
                     ProductIds = Enumerable.Range(0, random.Next(1, 5))
@@ -97,7 +120,9 @@ namespace AcornDB.Benchmarks
         public void Cleanup()
         {
             _tree = null;
+            _indexedTree = null;
             _orderTree = null;
+            _orderTimeSeries = null;
         }
 
         // ===== Simple Filtering =====
@@ -485,6 +510,126 @@ namespace AcornDB.Benchmarks
             var results = query.ToList();
         }
 
+        // ===== Index-Driven FluentQuery (same query, without and with indexes) =====
+
+        [Benchmark]
+        public int FluentQuery_Where_Name_FullScan()
+        {
+            return _tree!.Query().Where(p => p.Name == "Product 42").ToList().Count;
+        }
+
+        [Benchmark]
+        public int FluentQuery_Where_Name_IndexSeek()
+        {
+            return _indexedTree!.Query().Where(p => p.Name == "Product 42").ToList().Count;
+        }
+
+        [Benchmark]
+        public int FluentQuery_Where_NarrowPriceRange_FullScan()
+        {
+            return _tree!.Query().Where(p => p.Price >= 100 && p.Price <= 101).ToList().Count;
+        }
+
+        [Benchmark]
+        public int FluentQuery_Where_NarrowPriceRange_IndexRangeScan()
+        {
+            return _indexedTree!.Query().Where(p => p.Price >= 100 && p.Price <= 101).ToList().Count;
+        }
+
+        [Benchmark]
+        public int FluentQuery_Where_CategoryAndPrice_FullScan()
+        {
+            return _tree!.Query().Where(p => p.Category == "Electronics" && p.Price < 50).ToList().Count;
+        }
+
+        [Benchmark]
+        public int FluentQuery_Where_CategoryAndPrice_IndexMerge()
+        {
+            return _indexedTree!.Query().Where(p => p.Category == "Electronics" && p.Price < 50).ToList().Count;
+        }
+
+        [Benchmark]
+        public int FluentQuery_OrderBy_Price_Take10_FullScan()
+        {
+            return _tree!.Query().OrderBy(p => p.Price).Take(10).ToList().Count;
+        }
+
+        [Benchmark]
+        public int FluentQuery_OrderBy_Price_Take10_IndexScan()
+        {
+            return _indexedTree!.Query().OrderBy(p => p.Price).Take(10).ToList().Count;
+        }
+
+        [Benchmark]
+        public int FluentQuery_Count_Category_FullScan()
+        {
+            return _tree!.Query().Where(p => p.Category == "Electronics").Count();
+        }
+
+        [Benchmark]
+        public int FluentQuery_Count_Category_CoveredIndex()
+        {
+            return _indexedTree!.Query().Where(p => p.Category == "Electronics").Count();
+        }
+
+        [Benchmark]
+        public int FluentQuery_Contains_Description_Take10_FullScan()
+        {
+            return _tree!.Query().Where(p => p.Description.Contains("waterproof")).Take(10).ToList().Count;
+        }
+
+        [Benchmark]
+        public int FluentQuery_Search_Description_Take10_TextIndex()
+        {
+            return _indexedTree!.Query().Search("waterproof").Take(10).ToList().Count;
+        }
+
+        [Benchmark]
+        public int FluentQuery_Contains_TwoWords_FullScan()
+        {
+            return _tree!.Query().Where(p => p.Description.Contains("vintage") && p.Description.Contains("handmade")).ToList().Count;
+        }
+
+        [Benchmark]
+        public int FluentQuery_Search_TwoWords_TextIndex()
+        {
+            return _indexedTree!.Query().Search("vintage AND handmade").ToList().Count;
+        }
+
+        // ===== Time-Series Aggregation =====
+
+        [Benchmark]
+        public int TimeSeries_HourlyAverage_Last24h_GroupBy()
+        {
+            var since = _now.AddHours(-24);
+            return _orderTree!.NutShells()
+                .Where(n => n.Payload.OrderDate >= since)
+                .GroupBy(n => n.Payload.OrderDate.Ticks / TimeSpan.TicksPerHour)
+                .Select(g => new { Hour = g.Key, Count = g.Count(), Average = g.Average(n => n.Payload.TotalAmount) })
+                .ToList()
+                .Count;
+        }
+
+        [Benchmark]
+        public int TimeSeries_HourlyAverage_Last24h_Buckets()
+        {
+            return _orderTimeSeries!.Summarize(_now.AddHours(-24), _now).Count();
+        }
+
+        [Benchmark]
+        public double TimeSeries_DailyTotal_Last30d_Buckets()
+        {
+            return _orderTimeSeries!.Summarize(_now.AddDays(-30), _now, TimeSpan.FromDays(1))
+                .Sum(day => day.Values["TotalAmount"].Sum);
+        }
+
+        [Benchmark]
+        public int TimeSeries_Count_LastWeek_FluentQuery()
+        {
+            var since = _now.AddDays(-7);
+            return _orderTree!.Query().Where(o => o.OrderDate >= since).Count();
+        }
+
         // ===== Top-N Queries =====
 
         [Benchmark]
@@ -629,12 +774,26 @@ namespace AcornDB.Benchmarks
     /// - First: ~0.1ms for 1K docs (short-circuits on first match)
     ///
     /// FluentQuery API:
-    /// - Similar performance to LINQ (thin wrapper)
-    /// - Slightly better for chained operations (query optimization)
+    /// - Similar performance to LINQ (thin wrapper) when the tree has no indexes
+    ///
+    /// Index-Driven FluentQuery (100K docs):
+    /// - Name equality: O(log n) seek + 1 fetch vs O(n) scan (1000x+ faster)
+    /// - Narrow Price range (~0.1% of rows): range seek fetches only matches (~100x faster)
+    /// - Category AND Price: intersects two index results before fetching (~10x faster)
+    /// - OrderBy Price Take 10: ordered index scan stops after 10 entries, no sort
+    /// - Count by Category (covered): counted from the index, no documents fetched
+    /// - Unselective predicates (e.g. IsActive, 90% of rows) still scan: the planner
+    ///   compares index and scan costs using IndexStatistics estimates
+    ///
+    /// Time-Series Aggregation (ManagedTimeSeriesIndex, hourly buckets):
+    /// - Hourly count/average over the last 24h: O(buckets) from running totals vs a full
+    ///   scan plus GroupBy; independent of how many orders fall in the window
+    /// - Daily roll-up of 30 days: 720 hourly buckets merged, no documents read
+    /// - Count over a date range: answered from bucket totals, only the edge buckets are walked
     ///
     /// Key Insights:
-    /// - All queries are O(n) full scans (no indexes in current implementation)
-    /// - Adding indexes would improve filter/sort performance dramatically
+    /// - Without indexes all queries are O(n) full scans
+    /// - Indexes help selective filters, ORDER BY + Take and counts; see Explain()
     /// - String operations (Contains, StartsWith) are most expensive
     /// - Pagination with Skip is inefficient for large offsets
     /// - GroupBy with aggregates requires multiple passes over data
@@ -4,6 +4,8 @@ using AcornDB.Storage;
 using AcornDB.Storage.Roots;
 using AcornDB.Compression;
 using AcornDB.Security;
+using AcornDB.Storage.Serialization;
+using AcornDB.Policy;
 
 namespace AcornDB.Benchmarks
 {
@@ -410,6 +412,95 @@ namespace AcornDB.Benchmarks
         }
     }
 
+    /// <summary>
+    /// Allocations per operation for the root pipeline itself, without trunk I/O.
+    /// Compares the byte[]-per-stage path (serialize to string, UTF-8 encode, compress to a new
+    /// array, Base64 + encrypt through strings) with the pooled IBufferWriter path that
+    /// TrunkBase.SerializeThroughRoots now uses. Read the Allocated column.
+    /// </summary>
+    [MemoryDiagnoser]
+    [SimpleJob(warmupCount: 3, iterationCount: 10)]
+    public class RootPipelineAllocationBenchmarks
+    {
+        private readonly ISerializer _serializer = new NewtonsoftJsonSerializer();
+        private readonly GzipCompressionProvider _gzip = new();
+        private readonly AesEncryptionProvider _aes = AesEncryptionProvider.FromPassword("benchmark", "salt");
+        private CompressionRoot _compressionRoot = null!;
+        private EncryptionRoot _encryptionRoot = null!;
+        private Nut<RootPipelineBenchmarks.TestDocument> _nut = null!;
+        private byte[] _stored = Array.Empty<byte>();
+
+        [Params(1024, 10240, 102400)] // 1KB, 10KB, 100KB documents
+        public int DocumentSize;
+
+        [GlobalSetup]
+        public void Setup()
+        {
+            _compressionRoot = new CompressionRoot(_gzip, sequence: 100);
+            _encryptionRoot = new EncryptionRoot(_aes, sequence: 200);
+
+            var baseText = "This is a test document with repeated content for compression testing. ";
+            var content = string.Concat(Enumerable.Repeat(baseText, DocumentSize / baseText.Length + 1)).Substring(0, DocumentSize);
+            _nut = new Nut<RootPipelineBenchmarks.TestDocument>
+            {
+                Id = "doc-1",
+                Payload = new RootPipelineBenchmarks.TestDocument { Id = "doc-1", Name = "Document 1", Content = content, Value = 1, Created = DateTime.UtcNow },
+                Timestamp = DateTime.UtcNow
+            };
+            _stored = Stash_ByteArrayPerStage();
+        }
+
+        private static RootProcessingContext Context(string operation) => new()
+        {
+            PolicyContext = new PolicyContext { Operation = operation },
+            DocumentId = "doc-1"
+        };
+
+        [Benchmark(Baseline = true)]
+        public byte[] Stash_ByteArrayPerStage()
+        {
+            var json = _serializer.Serialize(_nut);
+            var bytes = System.Text.Encoding.UTF8.GetBytes(json);
+            var compressed = _gzip.Compress(bytes);
+            var encrypted = _aes.Encrypt(Convert.ToBase64String(compressed));
+            return System.Text.Encoding.UTF8.GetBytes(encrypted);
+        }
+
+        [Benchmark]
+        public int Stash_PooledBufferWriter()
+        {
+            using var current = new PooledBufferWriter(1024);
+            using var spare = new PooledBufferWriter(1024);
+            var context = Context("Write");
+
+            _serializer.Serialize(_nut, current);
+            _compressionRoot.OnStash(current.WrittenSpan, spare, context);
+            current.Clear();
+            _encryptionRoot.OnStash(spare.WrittenSpan, current, context);
+            return current.WrittenCount;
+        }
+
+        [Benchmark]
+        public int Crack_ByteArrayPerStage()
+        {
+            var decrypted = Convert.FromBase64String(_aes.Decrypt(System.Text.Encoding.UTF8.GetString(_stored)));
+            var decompressed = _gzip.Decompress(decrypted);
+            return _serializer.Deserialize<Nut<RootPipelineBenchmarks.TestDocument>>(System.Text.Encoding.UTF8.GetString(decompressed)).Payload.Value;
+        }
+
+        [Benchmark]
+        public int Crack_PooledBufferWriter()
+        {
+            using var current = new PooledBufferWriter(_stored.Length);
+            using var spare = new PooledBufferWriter(_stored.Length);
+            var context = Context("Read");
+
+            _encryptionRoot.OnCrack(_stored, current, context);
+            _compressionRoot.OnCrack(current.WrittenSpan, spare, context);
+            return _serializer.Deserialize<Nut<RootPipelineBenchmarks.TestDocument>>(spare.WrittenSpan).Payload.Value;
+        }
+    }
+
     /// <summary>
     /// Expected Performance Impact:
     ///
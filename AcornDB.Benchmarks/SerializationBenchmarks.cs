@@ -0,0 +1,102 @@
+using System.Buffers;
+using BenchmarkDotNet.Attributes;
+using AcornDB;
+using AcornDB.Storage;
+using AcornDB.Storage.Serialization;
+
+namespace AcornDB.Benchmarks
+{
+    /// <summary>
+    /// Encode/decode cost and stored size of a nut under each serializer: Newtonsoft JSON
+    /// (the default), System.Text.Json and MessagePack. Encoding writes into a reused
+    /// buffer, the way trunks do, so the numbers reflect the serializer rather than copies.
+    /// The encoded size of each is printed once during setup.
+    /// </summary>
+    [MemoryDiagnoser]
+    [SimpleJob(warmupCount: 3, iterationCount: 10)]
+    public class SerializationBenchmarks
+    {
+        public class Order
+        {
+            public string Id { get; set; } = string.Empty;
+            public string Customer { get; set; } = string.Empty;
+            public int Quantity { get; set; }
+            public double Price { get; set; }
+            public DateTime Placed { get; set; }
+            public List<string> Tags { get; set; } = new();
+            public Dictionary<string, int> Counters { get; set; } = new();
+        }
+
+        private readonly ArrayBufferWriter<byte> _buffer = new(4096);
+        private Nut<Order> _nut = null!;
+        private ISerializer _newtonsoft = null!;
+        private ISerializer _systemTextJson = null!;
+        private ISerializer _msgPack = null!;
+        private byte[] _newtonsoftBytes = Array.Empty<byte>();
+        private byte[] _systemTextJsonBytes = Array.Empty<byte>();
+        private byte[] _msgPackBytes = Array.Empty<byte>();
+
+        [GlobalSetup]
+        public void Setup()
+        {
+            _nut = new Nut<Order>
+            {
+                Id = "order-42",
+                Version = 3,
+                Payload = new Order
+                {
+                    Id = "order-42",
+                    Customer = "customer-1337",
+                    Quantity = 12,
+                    Price = 199.99,
+                    Placed = DateTime.UtcNow,
+                    Tags = Enumerable.Range(0, 8).Select(i => $"tag-{i}").ToList(),
+                    Counters = Enumerable.Range(0, 8).ToDictionary(i => $"counter-{i}", i => i * 1000)
+                }
+            };
+
+            _newtonsoft = new NewtonsoftJsonSerializer();
+            _systemTextJson = new SystemTextJsonSerializer();
+            _msgPack = new MsgPackSerializer();
+
+            _newtonsoftBytes = Encode(_newtonsoft);
+            _systemTextJsonBytes = Encode(_systemTextJson);
+            _msgPackBytes = Encode(_msgPack);
+
+            Console.WriteLine($"// Encoded nut: Newtonsoft {_newtonsoftBytes.Length} B, " +
+                              $"System.Text.Json {_systemTextJsonBytes.Length} B, MessagePack {_msgPackBytes.Length} B");
+        }
+
+        private byte[] Encode(ISerializer serializer)
+        {
+            _buffer.Clear();
+            serializer.Serialize(_nut, _buffer);
+            return _buffer.WrittenSpan.ToArray();
+        }
+
+        [Benchmark(Baseline = true)]
+        public int Serialize_Newtonsoft() => SerializeWith(_newtonsoft);
+
+        [Benchmark]
+        public int Serialize_SystemTextJson() => SerializeWith(_systemTextJson);
+
+        [Benchmark]
+        public int Serialize_MsgPack() => SerializeWith(_msgPack);
+
+        [Benchmark]
+        public Nut<Order> Deserialize_Newtonsoft() => _newtonsoft.Deserialize<Nut<Order>>(_newtonsoftBytes.AsSpan());
+
+        [Benchmark]
+        public Nut<Order> Deserialize_SystemTextJson() => _systemTextJson.Deserialize<Nut<Order>>(_systemTextJsonBytes.AsSpan());
+
+        [Benchmark]
+        public Nut<Order> Deserialize_MsgPack() => _msgPack.Deserialize<Nut<Order>>(_msgPackBytes.AsSpan());
+
+        private int SerializeWith(ISerializer serializer)
+        {
+            _buffer.Clear();
+            serializer.Serialize(_nut, _buffer);
+            return _buffer.WrittenCount;
+        }
+    }
+}
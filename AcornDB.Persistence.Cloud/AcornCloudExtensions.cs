@@ -107,12 +107,16 @@ namespace AcornDB.Persistence.Cloud
         /// <summary>
         /// Use custom cloud storage provider
         /// </summary>
+        /// <param name="cloudProvider">Cloud storage provider</param>
+        /// <param name="prefix">Optional prefix for all keys (like a folder path)</param>
+        /// <param name="options">Packing and disk cache options (e.g. CloudTrunkOptions.Packed)</param>
         public static Acorn<T> WithCloudStorage<T>(
             this Acorn<T> acorn,
             ICloudStorageProvider cloudProvider,
-            string? prefix = null) where T : class
+            string? prefix = null,
+            CloudTrunkOptions? options = null) where T : class
         {
-            var cloudTrunk = new CloudTrunk<T>(cloudProvider, prefix);
+            var cloudTrunk = new CloudTrunk<T>(cloudProvider, prefix, options: options);
             return acorn.WithTrunk(cloudTrunk);
         }
     }
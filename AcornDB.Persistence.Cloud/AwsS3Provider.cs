@@ -3,6 +3,7 @@ using System.Collections.Generic;
 using System.IO;
 using System.Linq;
 using System.Text;
+using System.Threading;
 using System.Threading.Tasks;
 using Amazon;
 using Amazon.S3;
@@ -13,6 +14,8 @@ namespace AcornDB.Persistence.Cloud
     /// <summary>
     /// AWS S3 implementation of cloud storage provider.
     /// Supports AWS S3, MinIO, DigitalOcean Spaces, and any S3-compatible storage.
+    /// Objects above MultipartThresholdBytes are uploaded as parallel multipart uploads;
+    /// binary downloads support ETag revalidation and byte ranges.
     /// </summary>
     public class AwsS3Provider : ICloudStorageProvider, IDisposable
     {
@@ -22,6 +25,21 @@ namespace AcornDB.Persistence.Cloud
         private readonly string? _endpoint;
         private bool _disposed;
 
+        /// <summary>
+        /// Uploads larger than this use multipart upload. Default: 16 MB
+        /// </summary>
+        public long MultipartThresholdBytes { get; set; } = 16 * 1024 * 1024;
+
+        /// <summary>
+        /// Size of each multipart part (S3 minimum is 5 MB). Default: 8 MB
+        /// </summary>
+        public int MultipartPartBytes { get; set; } = 8 * 1024 * 1024;
+
+        /// <summary>
+        /// Parts of one multipart upload sent at once. Default: 4
+        /// </summary>
+        public int MaxParallelParts { get; set; } = 4;
+
         /// <summary>
         /// Create AWS S3 provider with explicit credentials
         /// </summary>
@@ -94,15 +112,141 @@ namespace AcornDB.Persistence.Cloud
 
         public async Task UploadAsync(string key, string content)
         {
+            await UploadAsync(key, Encoding.UTF8.GetBytes(content), "application/json");
+        }
+
+        public bool SupportsBinaryObjects => true;
+
+        public bool SupportsRangeReads => true;
+
+        public Task<string?> UploadBytesAsync(string key, byte[] content)
+        {
+            return UploadAsync(key, content, "application/octet-stream");
+        }
+
+        public async Task<CloudObject?> DownloadBytesAsync(string key, string? ifNoneMatch = null)
+        {
+            try
+            {
+                var request = new GetObjectRequest
+                {
+                    BucketName = _bucketName,
+                    Key = key,
+                    EtagToNotMatch = ifNoneMatch
+                };
+
+                using var response = await _s3Client.GetObjectAsync(request);
+                using var buffer = new MemoryStream();
+                await response.ResponseStream.CopyToAsync(buffer);
+                return new CloudObject { Content = buffer.ToArray(), ETag = response.ETag };
+            }
+            catch (AmazonS3Exception ex) when (ex.StatusCode == System.Net.HttpStatusCode.NotModified)
+            {
+                return new CloudObject { ETag = ifNoneMatch, NotModified = true };
+            }
+            catch (AmazonS3Exception ex) when (ex.StatusCode == System.Net.HttpStatusCode.NotFound)
+            {
+                return null;
+            }
+        }
+
+        public async Task<byte[]?> DownloadRangeAsync(string key, long offset, int length)
+        {
+            if (length == 0)
+                return Array.Empty<byte>();
+
+            try
+            {
+                var request = new GetObjectRequest
+                {
+                    BucketName = _bucketName,
+                    Key = key,
+                    ByteRange = new ByteRange(offset, offset + length - 1) // Inclusive
+                };
+
+                using var response = await _s3Client.GetObjectAsync(request);
+                using var buffer = new MemoryStream(length);
+                await response.ResponseStream.CopyToAsync(buffer);
+                return buffer.ToArray();
+            }
+            catch (AmazonS3Exception ex) when (ex.StatusCode == System.Net.HttpStatusCode.NotFound)
+            {
+                return null;
+            }
+        }
+
+        private async Task<string?> UploadAsync(string key, byte[] content, string contentType)
+        {
+            if (content.Length > MultipartThresholdBytes)
+                return await UploadMultipartAsync(key, content, contentType);
+
             var request = new PutObjectRequest
             {
                 BucketName = _bucketName,
                 Key = key,
-                ContentBody = content,
-                ContentType = "application/json"
+                InputStream = new MemoryStream(content, writable: false),
+                ContentType = contentType
             };
 
-            await _s3Client.PutObjectAsync(request);
+            var response = await _s3Client.PutObjectAsync(request);
+            return response.ETag;
+        }
+
+        /// <summary>
+        /// Upload in MultipartPartBytes parts, MaxParallelParts at a time. A failed upload is
+        /// aborted so S3 does not keep (and bill for) the parts already sent.
+        /// </summary>
+        private async Task<string?> UploadMultipartAsync(string key, byte[] content, string contentType)
+        {
+            var initiated = await _s3Client.InitiateMultipartUploadAsync(new InitiateMultipartUploadRequest
+            {
+                BucketName = _bucketName,
+                Key = key,
+                ContentType = contentType
+            });
+
+            var partSize = Math.Max(5 * 1024 * 1024, MultipartPartBytes);
+            var partCount = (int)((content.Length + (long)partSize - 1) / partSize);
+            var partETags = new PartETag[partCount];
+
+            try
+            {
+                var options = new ParallelOptions { MaxDegreeOfParallelism = Math.Max(1, MaxParallelParts) };
+                await Parallel.ForEachAsync(Enumerable.Range(0, partCount), options, async (part, cancellationToken) =>
+                {
+                    var offset = part * partSize;
+                    var size = Math.Min(partSize, content.Length - offset);
+                    var response = await _s3Client.UploadPartAsync(new UploadPartRequest
+                    {
+                        BucketName = _bucketName,
+                        Key = key,
+                        UploadId = initiated.UploadId,
+                        PartNumber = part + 1,
+                        PartSize = size,
+                        InputStream = new MemoryStream(content, offset, size, writable: false)
+                    }, cancellationToken);
+                    partETags[part] = new PartETag(part + 1, response.ETag);
+                });
+
+                var completed = await _s3Client.CompleteMultipartUploadAsync(new CompleteMultipartUploadRequest
+                {
+                    BucketName = _bucketName,
+                    Key = key,
+                    UploadId = initiated.UploadId,
+                    PartETags = partETags.ToList()
+                });
+                return completed.ETag;
+            }
+            catch
+            {
+                await _s3Client.AbortMultipartUploadAsync(new AbortMultipartUploadRequest
+                {
+                    BucketName = _bucketName,
+                    Key = key,
+                    UploadId = initiated.UploadId
+                });
+                throw;
+            }
         }
 
         public async Task<string?> DownloadAsync(string key)
@@ -4,13 +4,17 @@ using System.IO;
 using System.Linq;
 using System.Text;
 using System.Threading.Tasks;
+using Azure;
+using Azure.Storage;
 using Azure.Storage.Blobs;
 using Azure.Storage.Blobs.Models;
 
 namespace AcornDB.Persistence.Cloud
 {
     /// <summary>
-    /// Azure Blob Storage implementation of cloud storage provider
+    /// Azure Blob Storage implementation of cloud storage provider.
+    /// Blobs above MultipartThresholdBytes are uploaded as blocks staged in parallel;
+    /// binary downloads support ETag revalidation and byte ranges.
     /// </summary>
     public class AzureBlobProvider : ICloudStorageProvider, IDisposable
     {
@@ -19,6 +23,21 @@ namespace AcornDB.Persistence.Cloud
         private readonly string? _accountName;
         private bool _disposed;
 
+        /// <summary>
+        /// Uploads larger than this are split into blocks. Default: 16 MB
+        /// </summary>
+        public long MultipartThresholdBytes { get; set; } = 16 * 1024 * 1024;
+
+        /// <summary>
+        /// Size of each block. Default: 8 MB
+        /// </summary>
+        public int MultipartPartBytes { get; set; } = 8 * 1024 * 1024;
+
+        /// <summary>
+        /// Blocks of one upload sent at once. Default: 4
+        /// </summary>
+        public int MaxParallelParts { get; set; } = 4;
+
         /// <summary>
         /// Create Azure Blob provider with connection string
         /// </summary>
@@ -71,11 +90,78 @@ namespace AcornDB.Persistence.Cloud
         }
 
         public async Task UploadAsync(string key, string content)
+        {
+            await UploadBytesAsync(key, Encoding.UTF8.GetBytes(content));
+        }
+
+        public bool SupportsBinaryObjects => true;
+
+        public bool SupportsRangeReads => true;
+
+        public async Task<string?> UploadBytesAsync(string key, byte[] content)
         {
             var blobClient = _containerClient.GetBlobClient(key);
-            using var stream = new MemoryStream(Encoding.UTF8.GetBytes(content));
+            using var stream = new MemoryStream(content, writable: false);
 
-            await blobClient.UploadAsync(stream, overwrite: true);
+            // No conditions, so this overwrites like UploadAsync(stream, overwrite: true)
+            var response = await blobClient.UploadAsync(stream, new BlobUploadOptions
+            {
+                TransferOptions = new StorageTransferOptions
+                {
+                    InitialTransferSize = MultipartThresholdBytes,
+                    MaximumTransferSize = MultipartPartBytes,
+                    MaximumConcurrency = Math.Max(1, MaxParallelParts)
+                }
+            });
+            return response.Value.ETag.ToString();
+        }
+
+        public async Task<CloudObject?> DownloadBytesAsync(string key, string? ifNoneMatch = null)
+        {
+            try
+            {
+                var blobClient = _containerClient.GetBlobClient(key);
+                var options = new BlobDownloadOptions();
+                if (ifNoneMatch != null)
+                {
+                    options.Conditions = new BlobRequestConditions { IfNoneMatch = new ETag(ifNoneMatch) };
+                }
+
+                var response = await blobClient.DownloadContentAsync(options);
+                return new CloudObject
+                {
+                    Content = response.Value.Content.ToArray(),
+                    ETag = response.Value.Details.ETag.ToString()
+                };
+            }
+            catch (RequestFailedException ex) when (ex.Status == 304)
+            {
+                return new CloudObject { ETag = ifNoneMatch, NotModified = true };
+            }
+            catch (RequestFailedException ex) when (ex.Status == 404)
+            {
+                return null;
+            }
+        }
+
+        public async Task<byte[]?> DownloadRangeAsync(string key, long offset, int length)
+        {
+            if (length == 0)
+                return Array.Empty<byte>();
+
+            try
+            {
+                var blobClient = _containerClient.GetBlobClient(key);
+                var response = await blobClient.DownloadContentAsync(new BlobDownloadOptions
+                {
+                    Range = new HttpRange(offset, length)
+                });
+                return response.Value.Content.ToArray();
+            }
+            catch (RequestFailedException ex) when (ex.Status == 404)
+            {
+                return null;
+            }
         }
 
         public async Task<string?> DownloadAsync(string key)
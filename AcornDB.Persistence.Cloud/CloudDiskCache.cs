@@ -0,0 +1,180 @@
+using System;
+using System.IO;
+using System.Security.Cryptography;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
+using AcornDB.Logging;
+
+namespace AcornDB.Persistence.Cloud
+{
+    /// <summary>
+    /// On-disk read-through cache of cloud objects, one file per key (named by the SHA-256 of
+    /// the key) plus its ETag. Immutable objects (packs and their indexes) are served from disk
+    /// without contacting the provider; mutable ones are revalidated with If-None-Match, so an
+    /// unchanged object costs a 304 instead of a full download.
+    /// </summary>
+    internal sealed class CloudDiskCache
+    {
+        private readonly string _directory;
+        private long _hits;
+        private long _revalidated;
+        private long _downloads;
+
+        public CloudDiskCache(string directory)
+        {
+            _directory = directory;
+            Directory.CreateDirectory(_directory);
+        }
+
+        /// <summary>
+        /// Reads served from disk without a request
+        /// </summary>
+        public long HitCount => Interlocked.Read(ref _hits);
+
+        /// <summary>
+        /// Reads served from disk after the provider confirmed the ETag
+        /// </summary>
+        public long RevalidatedCount => Interlocked.Read(ref _revalidated);
+
+        /// <summary>
+        /// Reads that downloaded the object
+        /// </summary>
+        public long DownloadCount => Interlocked.Read(ref _downloads);
+
+        /// <summary>
+        /// Object that never changes once written: download once, then read from disk
+        /// </summary>
+        public async Task<byte[]?> GetImmutableAsync(ICloudStorageProvider provider, string key)
+        {
+            var path = ContentPath(key);
+            if (File.Exists(path))
+            {
+                Interlocked.Increment(ref _hits);
+                return await File.ReadAllBytesAsync(path);
+            }
+
+            var obj = await provider.DownloadBytesAsync(key);
+            if (obj == null)
+                return null;
+
+            Interlocked.Increment(ref _downloads);
+            Store(key, obj.Content, obj.ETag);
+            return obj.Content;
+        }
+
+        /// <summary>
+        /// Object that may be overwritten: revalidate the cached copy's ETag on every read
+        /// </summary>
+        public async Task<byte[]?> GetValidatedAsync(ICloudStorageProvider provider, string key)
+        {
+            var path = ContentPath(key);
+            var etagPath = path + ".etag";
+            string? etag = null;
+            if (File.Exists(path) && File.Exists(etagPath))
+            {
+                etag = await File.ReadAllTextAsync(etagPath);
+            }
+
+            var obj = await provider.DownloadBytesAsync(key, etag);
+            if (obj == null)
+            {
+                Invalidate(key);
+                return null;
+            }
+
+            if (obj.NotModified)
+            {
+                try
+                {
+                    var cached = await File.ReadAllBytesAsync(path);
+                    Interlocked.Increment(ref _revalidated);
+                    return cached;
+                }
+                catch (IOException)
+                {
+                    // Evicted between the check and the read; fetch it again unconditionally
+                    obj = await provider.DownloadBytesAsync(key);
+                    if (obj == null)
+                        return null;
+                }
+            }
+
+            Interlocked.Increment(ref _downloads);
+            Store(key, obj.Content, obj.ETag);
+            return obj.Content;
+        }
+
+        /// <summary>
+        /// Read part of a cached object without touching the provider
+        /// </summary>
+        public bool TryReadRange(string key, long offset, int length, out byte[] bytes)
+        {
+            bytes = Array.Empty<byte>();
+            var path = ContentPath(key);
+            if (!File.Exists(path))
+                return false;
+
+            try
+            {
+                using var file = new FileStream(path, FileMode.Open, FileAccess.Read, FileShare.ReadWrite | FileShare.Delete);
+                if (offset + length > file.Length)
+                    return false;
+
+                bytes = new byte[length];
+                file.Position = offset;
+                file.ReadExactly(bytes);
+                Interlocked.Increment(ref _hits);
+                return true;
+            }
+            catch (IOException)
+            {
+                return false;
+            }
+        }
+
+        /// <summary>
+        /// Cache bytes this process just uploaded
+        /// </summary>
+        public void Store(string key, byte[] content, string? etag)
+        {
+            var path = ContentPath(key);
+            try
+            {
+                // Write then rename so a concurrent reader never sees a partial file
+                var temp = $"{path}.{Guid.NewGuid():N}.tmp";
+                File.WriteAllBytes(temp, content);
+                File.Move(temp, path, overwrite: true);
+
+                if (etag != null)
+                    File.WriteAllText(path + ".etag", etag);
+                else
+                    File.Delete(path + ".etag");
+            }
+            catch (IOException ex)
+            {
+                AcornLog.Info($"   ⚠ Failed to cache {key} on disk: {ex.Message}");
+            }
+        }
+
+        public void Invalidate(string key)
+        {
+            var path = ContentPath(key);
+            try
+            {
+                File.Delete(path + ".etag");
+                File.Delete(path);
+            }
+            catch (IOException)
+            {
+                // A stale file is revalidated by ETag on the next read anyway
+            }
+        }
+
+        private string ContentPath(string key)
+        {
+            var hash = SHA256.HashData(Encoding.UTF8.GetBytes(key));
+            return Path.Combine(_directory, Convert.ToHexString(hash).ToLowerInvariant());
+        }
+    }
+}
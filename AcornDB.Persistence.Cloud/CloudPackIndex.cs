@@ -0,0 +1,168 @@
+using System;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading;
+using Newtonsoft.Json;
+
+namespace AcornDB.Persistence.Cloud
+{
+    /// <summary>
+    /// Where the current version of a packed nut lives. Entries with a later sequence win, and
+    /// of equal sequences the one from the later index file, so index files can be applied in
+    /// any order.
+    /// </summary>
+    internal sealed class PackLocation
+    {
+        public string Sequence { get; init; } = "";
+        public string IndexKey { get; init; } = "";
+        public string? PackKey { get; init; }
+        public string? ObjectKey { get; init; }
+        public long Offset { get; init; }
+        public int Length { get; init; }
+        public bool Deleted { get; init; }
+    }
+
+    /// <summary>
+    /// On-cloud index file written next to each pack ({prefix}/_packs/{sequence}.idx). It is
+    /// uploaded after the pack and any large objects it references, so it is the commit point.
+    /// </summary>
+    internal sealed class PackIndexFile
+    {
+        public string Sequence { get; set; } = "";
+        public string? Pack { get; set; }
+        public List<PackIndexEntry> Entries { get; set; } = new();
+    }
+
+    internal sealed class PackIndexEntry
+    {
+        public string Id { get; set; } = "";
+        public long Offset { get; set; }
+        public int Length { get; set; }
+
+        /// <summary>
+        /// Key of a nut too large to pack, stored as its own object
+        /// </summary>
+        [JsonProperty(NullValueHandling = NullValueHandling.Ignore)]
+        public string? Object { get; set; }
+
+        [JsonProperty(DefaultValueHandling = DefaultValueHandling.Ignore)]
+        public bool Deleted { get; set; }
+
+        /// <summary>
+        /// Sequence of the write this entry records when it differs from the file's: compaction
+        /// copies entries into new files but keeps the sequence they were written with
+        /// </summary>
+        [JsonProperty(NullValueHandling = NullValueHandling.Ignore)]
+        public string? Sequence { get; set; }
+    }
+
+    /// <summary>
+    /// In-memory view of all pack index files under a prefix
+    /// </summary>
+    internal sealed class CloudPackIndex
+    {
+        private readonly ConcurrentDictionary<string, PackLocation> _locations = new(StringComparer.Ordinal);
+        private readonly ConcurrentDictionary<string, bool> _applied = new(StringComparer.Ordinal);
+        private long _lastTicks;
+
+        public string PacksPrefix { get; }
+
+        public CloudPackIndex(string prefix)
+        {
+            PacksPrefix = $"{prefix}/_packs/";
+        }
+
+        public string PackKey(string sequence) => $"{PacksPrefix}{sequence}.pack";
+
+        public string IndexKey(string sequence) => $"{PacksPrefix}{sequence}.idx";
+
+        public bool IsIndexKey(string key) => key.StartsWith(PacksPrefix, StringComparison.Ordinal) && key.EndsWith(".idx", StringComparison.Ordinal);
+
+        public bool IsPackObject(string key) => key.StartsWith(PacksPrefix, StringComparison.Ordinal);
+
+        public bool IsApplied(string indexKey) => _applied.ContainsKey(indexKey);
+
+        /// <summary>
+        /// A new sequence that sorts after every sequence this process issued before (UTC ticks,
+        /// bumped on collisions, plus a random suffix to keep writers apart)
+        /// </summary>
+        public string NextSequence()
+        {
+            long ticks, last;
+            do
+            {
+                last = Interlocked.Read(ref _lastTicks);
+                ticks = Math.Max(DateTime.UtcNow.Ticks, last + 1);
+            }
+            while (Interlocked.CompareExchange(ref _lastTicks, ticks, last) != last);
+
+            return $"{ticks:D19}-{Guid.NewGuid():N}";
+        }
+
+        public bool TryGet(string id, out PackLocation location) => _locations.TryGetValue(id, out location!);
+
+        /// <summary>
+        /// Every id with an entry, live or deleted
+        /// </summary>
+        public IEnumerable<string> Ids => _locations.Keys;
+
+        /// <summary>
+        /// Live (not deleted) locations
+        /// </summary>
+        public IEnumerable<KeyValuePair<string, PackLocation>> Live => _locations.Where(kv => !kv.Value.Deleted);
+
+        /// <summary>
+        /// Current locations, live or deleted
+        /// </summary>
+        public IEnumerable<KeyValuePair<string, PackLocation>> Locations => _locations;
+
+        /// <summary>
+        /// Whether the index has an entry for <paramref name="id"/>, live or deleted; such ids
+        /// ignore any per-nut object left from before packing was enabled
+        /// </summary>
+        public bool References(string id) => _locations.ContainsKey(id);
+
+        public void Apply(string indexKey, PackIndexFile file)
+        {
+            foreach (var entry in file.Entries)
+            {
+                var location = new PackLocation
+                {
+                    Sequence = entry.Sequence ?? file.Sequence,
+                    IndexKey = indexKey,
+                    PackKey = entry.Object == null && !entry.Deleted ? file.Pack : null,
+                    ObjectKey = entry.Object,
+                    Offset = entry.Offset,
+                    Length = entry.Length,
+                    Deleted = entry.Deleted
+                };
+
+                // Later entries of the same file win over earlier ones
+                _locations.AddOrUpdate(entry.Id, location, (_, current) => Wins(location, current) ? location : current);
+            }
+
+            _applied[indexKey] = true;
+        }
+
+        /// <summary>
+        /// Stop tracking index files deleted after their entries were compacted into others
+        /// </summary>
+        public void Forget(IEnumerable<string> indexKeys)
+        {
+            foreach (var indexKey in indexKeys)
+                _applied.TryRemove(indexKey, out _);
+        }
+
+        private static bool Wins(PackLocation location, PackLocation current)
+        {
+            var bySequence = string.CompareOrdinal(location.Sequence, current.Sequence);
+            return bySequence != 0 ? bySequence > 0 : string.CompareOrdinal(location.IndexKey, current.IndexKey) >= 0;
+        }
+
+        public static byte[] Serialize(PackIndexFile file) => Encoding.UTF8.GetBytes(JsonConvert.SerializeObject(file));
+
+        public static PackIndexFile? Deserialize(byte[] bytes) => JsonConvert.DeserializeObject<PackIndexFile>(Encoding.UTF8.GetString(bytes));
+    }
+}
@@ -26,6 +26,13 @@ namespace AcornDB.Persistence.Cloud
     /// Storage Pipeline:
     /// Write: Nut<T> → Serialize → Root Chain (ascending) → byte[] → Base64 → Upload to cloud
     /// Read: Download from cloud → Base64 decode → byte[] → Root Chain (descending) → Deserialize → Nut<T>
+    ///
+    /// With CloudTrunkOptions.PackSmallNuts, each flush writes its small nuts into one pack object
+    /// ({prefix}/_packs/{sequence}.pack, raw stored bytes back to back) followed by an index file
+    /// ({sequence}.idx) giving each nut's offset and length. Nuts above PackThresholdBytes keep
+    /// their own object and are only referenced from the index. Single reads are byte-range GETs
+    /// into the pack; CrackAll downloads whole packs in parallel. Later index files win, and a
+    /// Toss writes a tombstone entry. CompactPacksAsync folds the packs of many flushes into few.
     /// </summary>
     /// <typeparam name="T">Payload type</typeparam>
     public class CloudTrunk<T> : TrunkBase<T> where T : class
@@ -36,10 +43,20 @@ namespace AcornDB.Persistence.Cloud
         private readonly bool _enableLocalCache;
         private readonly int _batchSize;
         private readonly int _parallelDownloads;
+        private readonly CloudTrunkOptions _options;
 
         // Optional local cache
         private readonly ConcurrentDictionary<string, Nut<T>>? _localCache;
 
+        // Optional on-disk cache of downloaded objects
+        private readonly CloudDiskCache? _diskCache;
+
+        // Pack index (PackSmallNuts only), loaded on first use
+        private readonly CloudPackIndex? _packIndex;
+        private readonly SemaphoreSlim _packIndexLoad = new(1, 1);
+        private bool _packIndexLoaded;
+        private readonly SemaphoreSlim _compactGate = new(1, 1);
+
         private const int DEFAULT_BATCH_SIZE = 50;
         private const int DEFAULT_PARALLEL_DOWNLOADS = 10;
         private const int FLUSH_INTERVAL_MS = 500;
@@ -54,6 +71,7 @@ namespace AcornDB.Persistence.Cloud
         /// <param name="enableLocalCache">Enable in-memory caching of frequently accessed nuts</param>
         /// <param name="batchSize">Number of writes to buffer before auto-flush (default: 50)</param>
         /// <param name="parallelDownloads">Maximum parallel downloads for bulk operations (default: 10)</param>
+        /// <param name="options">Packing and disk cache options (default: one object per nut, no disk cache)</param>
         public CloudTrunk(
             ICloudStorageProvider cloudStorage,
             string? prefix = null,
@@ -61,7 +79,8 @@ namespace AcornDB.Persistence.Cloud
             bool enableCompression = true,
             bool enableLocalCache = true,
             int batchSize = DEFAULT_BATCH_SIZE,
-            int parallelDownloads = DEFAULT_PARALLEL_DOWNLOADS)
+            int parallelDownloads = DEFAULT_PARALLEL_DOWNLOADS,
+            CloudTrunkOptions? options = null)
             : base(
                 serializer,
                 enableBatching: true,            // Enable batching via TrunkBase
@@ -73,13 +92,24 @@ namespace AcornDB.Persistence.Cloud
             _enableCompression = enableCompression;
             _enableLocalCache = enableLocalCache;
             _batchSize = batchSize;
-            _parallelDownloads = parallelDownloads;
+            _parallelDownloads = Math.Max(1, parallelDownloads);
+            _options = options ?? CloudTrunkOptions.Default;
 
             if (_enableLocalCache)
             {
                 _localCache = new ConcurrentDictionary<string, Nut<T>>();
             }
 
+            if (_options.LocalCacheDirectory != null)
+            {
+                _diskCache = new CloudDiskCache(_options.LocalCacheDirectory);
+            }
+
+            if (_options.PackSmallNuts)
+            {
+                _packIndex = new CloudPackIndex(_prefix);
+            }
+
             var info = _cloudStorage.GetInfo();
             AcornLog.Info($"☁️ CloudTrunk initialized:");
             AcornLog.Info($"   Provider: {info.ProviderName}");
@@ -88,6 +118,8 @@ namespace AcornDB.Persistence.Cloud
             AcornLog.Info($"   Compression: {(_enableCompression ? "Enabled" : "Disabled")}");
             AcornLog.Info($"   Local Cache: {(_enableLocalCache ? "Enabled" : "Disabled")}");
             AcornLog.Info($"   Batch Size: {_batchSize}");
+            AcornLog.Info($"   Layout: {(_options.PackSmallNuts ? $"Packed (≤{_options.PackThresholdBytes} bytes per nut)" : "One object per nut")}");
+            AcornLog.Info($"   Disk Cache: {_options.LocalCacheDirectory ?? "Disabled"}");
         }
 
         // Synchronous methods - use sparingly, prefer async versions
@@ -105,7 +137,7 @@ namespace AcornDB.Persistence.Cloud
         }
 
         [MethodImpl(MethodImplOptions.AggressiveInlining)]
-        public async Task StashAsync(string id, Nut<T> nut)
+        public override async Task StashAsync(string id, Nut<T> nut)
         {
             // Update local cache immediately
             if (_enableLocalCache)
@@ -134,35 +166,28 @@ namespace AcornDB.Persistence.Cloud
                 return cached;
             }
 
-            var key = GetKey(id);
-            var data = await _cloudStorage.DownloadAsync(key);
-
-            if (data == null)
-                return null;
-
-            // Step 1: Convert from storage format to bytes
-            byte[] storedBytes;
-            if (_enableCompression && !_roots.Any(r => r.Name.Contains("Compression", StringComparison.OrdinalIgnoreCase)))
+            byte[]? storedBytes;
+            if (_packIndex != null && await GetPackLocationAsync(id) is { } location)
             {
-                // Legacy compression path
-                var decompressedJson = Decompress(data);
-                storedBytes = Encoding.UTF8.GetBytes(decompressedJson);
+                if (location.Deleted)
+                    return null;
+
+                storedBytes = location.ObjectKey != null
+                    ? await DownloadObjectAsync(location.ObjectKey)
+                    : await ReadPackedAsync(location);
             }
             else
             {
-                // IRoot pipeline path - data is base64
-                storedBytes = Convert.FromBase64String(data);
+                storedBytes = await DownloadObjectAsync(GetKey(id));
             }
 
-            // Step 2: Process through IRoot chain using base class helper
-            var processedBytes = ProcessThroughRootsDescending(storedBytes, id);
+            if (storedBytes == null)
+                return null;
 
-            // Step 3: Deserialize from bytes to Nut<T>
             Nut<T>? nut;
             try
             {
-                var json = Encoding.UTF8.GetString(processedBytes);
-                nut = _serializer.Deserialize<Nut<T>>(json);
+                nut = DecodeNut(id, storedBytes);
             }
             catch (Exception ex)
             {
@@ -196,8 +221,28 @@ namespace AcornDB.Persistence.Cloud
                 _localCache!.TryRemove(id, out _);
             }
 
+            // A buffered stash of this id must not land after the delete
+            await FlushBatchAsync();
+
+            if (_packIndex != null)
+            {
+                // Tombstone first, so the nut stays deleted even if its own object is re-listed
+                var sequence = _packIndex.NextSequence();
+                var tombstone = new PackIndexFile
+                {
+                    Sequence = sequence,
+                    Entries = { new PackIndexEntry { Id = id, Deleted = true } }
+                };
+                var indexKey = _packIndex.IndexKey(sequence);
+                var indexBytes = CloudPackIndex.Serialize(tombstone);
+                var etag = await _cloudStorage.UploadBytesAsync(indexKey, indexBytes);
+                _diskCache?.Store(indexKey, indexBytes, etag);
+                _packIndex.Apply(indexKey, tombstone);
+            }
+
             var key = GetKey(id);
             await _cloudStorage.DeleteAsync(key);
+            _diskCache?.Invalidate(key);
             AcornLog.Info($"   ☁️ Deleted {id} from cloud");
         }
 
@@ -212,55 +257,197 @@ namespace AcornDB.Persistence.Cloud
 
         public async Task<IEnumerable<Nut<T>>> CrackAllAsync()
         {
-            var keys = await _cloudStorage.ListAsync(_prefix);
-            var nuts = new ConcurrentBag<Nut<T>>();
+            var keys = await _cloudStorage.ListAsync(_prefix + "/");
+            var nuts = new ConcurrentDictionary<string, Nut<T>>();
+            var options = new ParallelOptions { MaxDegreeOfParallelism = _parallelDownloads };
+
+            // The index decides for every id it knows, so per-nut objects of those ids (written
+            // before packing, or large nuts loaded below) are skipped
+            var objectKeys = keys;
+            if (_packIndex != null)
+            {
+                await RefreshPackIndexAsync(keys);
+                var indexed = _packIndex.Ids.Select(GetKey).ToHashSet(StringComparer.Ordinal);
+                objectKeys = keys.Where(key => !_packIndex.IsPackObject(key) && !indexed.Contains(key)).ToList();
+            }
 
-            // Parallel downloads for better performance
-            var keyGroups = keys.Chunk(_parallelDownloads);
+            // Per-nut objects, at most _parallelDownloads in flight at a time
+            await Parallel.ForEachAsync(objectKeys, options, async (key, _) =>
+            {
+                try
+                {
+                    var storedBytes = await DownloadObjectAsync(key);
+                    if (storedBytes != null)
+                    {
+                        var nut = DecodeNut(key, storedBytes);
+                        if (nut != null && (_packIndex == null || !_packIndex.References(nut.Id)))
+                            nuts[nut.Id] = nut;
+                    }
+                }
+                catch (Exception ex)
+                {
+                    AcornLog.Info($"   ⚠ Failed to load {key}: {ex.Message}");
+                }
+            });
+
+            if (_packIndex == null)
+                return nuts.Values.ToList();
+
+            // Whole packs in parallel, each sliced into its live nuts
+            var live = _packIndex.Live.ToList();
+            var byPack = live.Where(kv => kv.Value.PackKey != null).GroupBy(kv => kv.Value.PackKey!).ToList();
+            await Parallel.ForEachAsync(byPack, options, async (pack, _) =>
+            {
+                try
+                {
+                    var packBytes = await DownloadPackAsync(pack.Key);
+                    if (packBytes == null)
+                    {
+                        AcornLog.Info($"   ⚠ Pack {pack.Key} is missing");
+                        return;
+                    }
+
+                    foreach (var (id, location) in pack)
+                    {
+                        var nut = DecodeNut(id, DecodePacked(packBytes.AsSpan((int)location.Offset, location.Length).ToArray()));
+                        if (nut != null)
+                            nuts[id] = nut;
+                    }
+                }
+                catch (Exception ex)
+                {
+                    AcornLog.Info($"   ⚠ Failed to load pack {pack.Key}: {ex.Message}");
+                }
+            });
 
-            foreach (var keyGroup in keyGroups)
+            // Nuts too large to pack
+            var large = live.Where(kv => kv.Value.ObjectKey != null).ToList();
+            await Parallel.ForEachAsync(large, options, async (entry, _) =>
             {
-                var downloadTasks = keyGroup.Select(async key =>
+                try
                 {
+                    var storedBytes = await DownloadObjectAsync(entry.Value.ObjectKey!);
+                    if (storedBytes != null && DecodeNut(entry.Key, storedBytes) is { } nut)
+                        nuts[entry.Key] = nut;
+                }
+                catch (Exception ex)
+                {
+                    AcornLog.Info($"   ⚠ Failed to load {entry.Value.ObjectKey}: {ex.Message}");
+                }
+            });
+
+            return nuts.Values.ToList();
+        }
+
+        /// <summary>
+        /// Pick up index files written by other instances since the index was loaded
+        /// (PackSmallNuts only; CrackAll does this itself)
+        /// </summary>
+        public async Task RefreshPackIndexAsync()
+        {
+            if (_packIndex == null)
+                return;
+
+            await RefreshPackIndexAsync(await _cloudStorage.ListAsync(_packIndex.PacksPrefix));
+        }
+
+        /// <summary>
+        /// Fold every pack index file under the prefix, and the packs they own, into as few packs
+        /// as TargetPackBytes allows (PackSmallNuts only). Only the current entry of each nut is
+        /// copied, with the sequence it was written with, so writes made meanwhile here or by other
+        /// instances still win; tombstones are copied too so tossed nuts stay deleted. Other
+        /// instances read from the new packs after RefreshPackIndexAsync or CrackAll.
+        /// </summary>
+        /// <returns>Number of index files replaced (0 when there were fewer than two)</returns>
+        public async Task<int> CompactPacksAsync()
+        {
+            if (_packIndex == null)
+                return 0;
+
+            await _compactGate.WaitAsync();
+            try
+            {
+                await FlushBatchAsync();
+
+                var listed = (await _cloudStorage.ListAsync(_packIndex.PacksPrefix)).ToHashSet(StringComparer.Ordinal);
+                await RefreshPackIndexAsync(listed);
+
+                var replaced = listed.Where(key => _packIndex.IsIndexKey(key) && _packIndex.IsApplied(key)).ToList();
+                if (replaced.Count < 2)
+                    return 0;
+
+                var replacedKeys = replaced.ToHashSet(StringComparer.Ordinal);
+                var current = _packIndex.Locations.Where(kv => replacedKeys.Contains(kv.Value.IndexKey)).ToList();
+                var options = new ParallelOptions { MaxDegreeOfParallelism = _parallelDownloads };
+
+                var byPack = current
+                    .Where(kv => kv.Value.PackKey != null)
+                    .GroupBy(kv => kv.Value.PackKey!)
+                    .OrderBy(pack => pack.Key, StringComparer.Ordinal)
+                    .ToList();
+                var bodies = new ConcurrentDictionary<string, byte[]>(StringComparer.Ordinal);
+                await Parallel.ForEachAsync(byPack, options, async (pack, _) =>
+                {
+                    bodies[pack.Key] = await DownloadPackAsync(pack.Key)
+                        ?? throw new InvalidOperationException($"Pack {pack.Key} is missing");
+                });
+
+                // Stored bytes are copied as they are, without going through the roots
+                var packs = new List<(PackIndexFile Index, MemoryStream Body)>();
+                foreach (var pack in byPack)
+                {
+                    foreach (var (id, location) in pack.OrderBy(kv => kv.Value.Offset))
+                    {
+                        var stored = bodies[pack.Key].AsSpan((int)location.Offset, location.Length).ToArray();
+                        AddToPack(packs, new PackIndexEntry { Id = id, Sequence = location.Sequence }, stored);
+                    }
+                }
+
+                var unpacked = current.Where(kv => kv.Value.PackKey == null).ToList();
+                if (unpacked.Count > 0)
+                {
+                    var index = new PackIndexFile { Sequence = _packIndex.NextSequence() };
+                    index.Entries.AddRange(unpacked.Select(kv => new PackIndexEntry
+                    {
+                        Id = kv.Key,
+                        Object = kv.Value.ObjectKey,
+                        Deleted = kv.Value.Deleted,
+                        Sequence = kv.Value.Sequence
+                    }));
+                    packs.Add((index, new MemoryStream()));
+                }
+
+                // Nothing is deleted unless every copy is committed
+                await Parallel.ForEachAsync(packs, options, async (pack, _) => await UploadPackAsync(pack.Index, pack.Body));
+                _packIndex.Forget(replaced);
+
+                // Index files before their packs, so no remaining index points at a deleted pack
+                foreach (var indexKey in replaced)
+                {
+                    var packKey = indexKey[..^".idx".Length] + ".pack";
                     try
                     {
-                        var data = await _cloudStorage.DownloadAsync(key);
-                        if (data != null)
+                        await _cloudStorage.DeleteAsync(indexKey);
+                        _diskCache?.Invalidate(indexKey);
+                        if (listed.Contains(packKey))
                         {
-                            // Step 1: Convert from storage format to bytes
-                            byte[] storedBytes;
-                            if (_enableCompression && !_roots.Any(r => r.Name.Contains("Compression", StringComparison.OrdinalIgnoreCase)))
-                            {
-                                // Legacy compression path
-                                var decompressedJson = Decompress(data);
-                                storedBytes = Encoding.UTF8.GetBytes(decompressedJson);
-                            }
-                            else
-                            {
-                                // IRoot pipeline path - data is base64
-                                storedBytes = Convert.FromBase64String(data);
-                            }
-
-                            // Step 2: Process through IRoot chain using base class helper
-                            var processedBytes = ProcessThroughRootsDescending(storedBytes, key);
-
-                            // Step 3: Deserialize from bytes to Nut<T>
-                            var json = Encoding.UTF8.GetString(processedBytes);
-                            var nut = _serializer.Deserialize<Nut<T>>(json);
-                            if (nut != null)
-                                nuts.Add(nut);
+                            await _cloudStorage.DeleteAsync(packKey);
+                            _diskCache?.Invalidate(packKey);
                         }
                     }
                     catch (Exception ex)
                     {
-                        AcornLog.Info($"   ⚠ Failed to load {key}: {ex.Message}");
+                        AcornLog.Info($"   ⚠ Failed to delete compacted {indexKey}: {ex.Message}");
                     }
-                });
+                }
 
-                await Task.WhenAll(downloadTasks);
+                AcornLog.Info($"   ☁️ Compacted {replaced.Count} pack indexes into {packs.Count}");
+                return replaced.Count;
+            }
+            finally
+            {
+                _compactGate.Release();
             }
-
-            return nuts.ToList();
         }
 
         [Obsolete("Use CrackAllAsync() instead. This method will be removed in a future version.")]
@@ -355,11 +542,135 @@ namespace AcornDB.Persistence.Cloud
             return $"{_prefix}/{sanitized}.json";
         }
 
+        private bool UsesLegacyCompression =>
+            _enableCompression && !_roots.Any(r => r.Name.Contains("Compression", StringComparison.OrdinalIgnoreCase));
+
+        /// <summary>
+        /// Download a per-nut object and convert it from its storage format to stored bytes
+        /// </summary>
+        private async Task<byte[]?> DownloadObjectAsync(string key)
+        {
+            string? data;
+            if (_diskCache != null && _cloudStorage.SupportsBinaryObjects)
+            {
+                var bytes = await _diskCache.GetValidatedAsync(_cloudStorage, key);
+                data = bytes == null ? null : Encoding.UTF8.GetString(bytes);
+            }
+            else
+            {
+                data = await _cloudStorage.DownloadAsync(key);
+            }
+
+            if (data == null)
+                return null;
+
+            if (UsesLegacyCompression)
+            {
+                // Legacy compression path
+                var decompressedJson = Decompress(data);
+                return Encoding.UTF8.GetBytes(decompressedJson);
+            }
+
+            // IRoot pipeline path - data is base64
+            return Convert.FromBase64String(data);
+        }
+
+        /// <summary>
+        /// Root chain (descending) and deserialize
+        /// </summary>
+        private Nut<T>? DecodeNut(string id, byte[] storedBytes)
+        {
+            var processedBytes = ProcessThroughRootsDescending(storedBytes, id);
+            var json = Encoding.UTF8.GetString(processedBytes);
+            return _serializer.Deserialize<Nut<T>>(json);
+        }
+
+        /// <summary>
+        /// Packs hold the stored bytes raw (GZip when legacy compression applies), not Base64
+        /// </summary>
+        private byte[] EncodePacked(byte[] processedBytes) =>
+            UsesLegacyCompression ? CompressBytes(processedBytes) : processedBytes;
+
+        private byte[] DecodePacked(byte[] packedBytes) =>
+            UsesLegacyCompression ? DecompressBytes(packedBytes) : packedBytes;
+
+        private async Task<PackLocation?> GetPackLocationAsync(string id)
+        {
+            if (!_packIndexLoaded)
+            {
+                await _packIndexLoad.WaitAsync();
+                try
+                {
+                    if (!_packIndexLoaded)
+                    {
+                        await RefreshPackIndexAsync();
+                        _packIndexLoaded = true;
+                    }
+                }
+                finally
+                {
+                    _packIndexLoad.Release();
+                }
+            }
+
+            return _packIndex!.TryGet(id, out var location) ? location : null;
+        }
+
+        private async Task RefreshPackIndexAsync(IEnumerable<string> keys)
+        {
+            var pending = keys.Where(key => _packIndex!.IsIndexKey(key) && !_packIndex.IsApplied(key)).ToList();
+            var options = new ParallelOptions { MaxDegreeOfParallelism = _parallelDownloads };
+            await Parallel.ForEachAsync(pending, options, async (key, _) =>
+            {
+                var bytes = _diskCache != null
+                    ? await _diskCache.GetImmutableAsync(_cloudStorage, key)
+                    : (await _cloudStorage.DownloadBytesAsync(key))?.Content;
+                if (bytes != null && CloudPackIndex.Deserialize(bytes) is { } file)
+                {
+                    _packIndex!.Apply(key, file);
+                }
+            });
+            _packIndexLoaded = true;
+        }
+
+        /// <summary>
+        /// Stored bytes of one packed nut: from the disk cache, a range GET, or the whole pack
+        /// </summary>
+        private async Task<byte[]?> ReadPackedAsync(PackLocation location)
+        {
+            var packKey = location.PackKey!;
+            if (_diskCache != null && _diskCache.TryReadRange(packKey, location.Offset, location.Length, out var cached))
+                return DecodePacked(cached);
+
+            if (_options.UseRangeReads && _cloudStorage.SupportsRangeReads)
+            {
+                var range = await _cloudStorage.DownloadRangeAsync(packKey, location.Offset, location.Length);
+                return range == null ? null : DecodePacked(range);
+            }
+
+            var pack = await DownloadPackAsync(packKey);
+            return pack == null ? null : DecodePacked(pack.AsSpan((int)location.Offset, location.Length).ToArray());
+        }
+
+        private async Task<byte[]?> DownloadPackAsync(string packKey)
+        {
+            if (_diskCache != null)
+                return await _diskCache.GetImmutableAsync(_cloudStorage, packKey);
+
+            return (await _cloudStorage.DownloadBytesAsync(packKey))?.Content;
+        }
+
         /// <summary>
         /// Write a single item to cloud storage (used by TrunkBase for immediate writes if needed)
         /// </summary>
         protected override async Task WriteToStorageAsync(string id, byte[] processedBytes, DateTime timestamp, int version)
         {
+            if (_packIndex != null)
+            {
+                await WritePacksAsync(new List<(string, byte[])> { (id, processedBytes) });
+                return;
+            }
+
             await UploadToCloud(id, processedBytes);
         }
 
@@ -368,6 +679,13 @@ namespace AcornDB.Persistence.Cloud
         /// </summary>
         protected override async Task WriteBatchToStorageAsync(List<PendingWrite> batch)
         {
+            if (_packIndex != null)
+            {
+                await WritePacksAsync(batch.Select(write => (write.Id, write.ProcessedData)).ToList());
+                AcornLog.Info($"   ☁️ Flushed {batch.Count} nuts to cloud");
+                return;
+            }
+
             // Upload all buffered writes in parallel for performance
             var uploadTasks = batch.Select(async write =>
             {
@@ -385,6 +703,101 @@ namespace AcornDB.Persistence.Cloud
             AcornLog.Info($"   ☁️ Flushed {batch.Count} nuts to cloud");
         }
 
+        /// <summary>
+        /// Write nuts as packs of up to TargetPackBytes, each followed by its index file. Nuts
+        /// above PackThresholdBytes are uploaded as their own object first and the index points
+        /// at them. An index is only applied (and uploaded) once everything it references is stored.
+        /// </summary>
+        private async Task WritePacksAsync(List<(string Id, byte[] ProcessedData)> writes)
+        {
+            var packs = new List<(PackIndexFile Index, MemoryStream Body)>();
+            var large = new List<(string Id, byte[] ProcessedData)>();
+
+            // Only the last write of an id in the batch is kept
+            var latest = writes
+                .Select((write, order) => (write.Id, write.ProcessedData, order))
+                .GroupBy(write => write.Id, StringComparer.Ordinal)
+                .Select(group => group.Last())
+                .OrderBy(write => write.order);
+
+            foreach (var (id, processedData, _) in latest)
+            {
+                var stored = EncodePacked(processedData);
+                if (stored.Length > _options.PackThresholdBytes)
+                {
+                    large.Add((id, processedData));
+                    continue;
+                }
+
+                AddToPack(packs, new PackIndexEntry { Id = id }, stored);
+            }
+
+            if (large.Count > 0)
+            {
+                var options = new ParallelOptions { MaxDegreeOfParallelism = _parallelDownloads };
+                await Parallel.ForEachAsync(large, options, async (write, _) =>
+                {
+                    await UploadToCloud(write.Id, write.ProcessedData);
+                });
+
+                // Large nuts are listed in an index of their own
+                var sequence = _packIndex!.NextSequence();
+                var largeIndex = new PackIndexFile { Sequence = sequence };
+                largeIndex.Entries.AddRange(large.Select(write => new PackIndexEntry { Id = write.Id, Object = GetKey(write.Id) }));
+                packs.Add((largeIndex, new MemoryStream()));
+            }
+
+            await Parallel.ForEachAsync(packs, new ParallelOptions { MaxDegreeOfParallelism = _parallelDownloads }, async (pack, _) =>
+            {
+                try
+                {
+                    await UploadPackAsync(pack.Index, pack.Body);
+                }
+                catch (Exception ex)
+                {
+                    AcornLog.Info($"   ⚠ Failed to upload pack {pack.Index.Sequence}: {ex.Message}");
+                }
+            });
+        }
+
+        /// <summary>
+        /// Append stored bytes to the last pack, starting a new one when there is none or it
+        /// would grow past TargetPackBytes
+        /// </summary>
+        private void AddToPack(List<(PackIndexFile Index, MemoryStream Body)> packs, PackIndexEntry entry, byte[] stored)
+        {
+            if (packs.Count == 0 || (packs[^1].Body.Length > 0 && packs[^1].Body.Length + stored.Length > _options.TargetPackBytes))
+            {
+                var sequence = _packIndex!.NextSequence();
+                packs.Add((new PackIndexFile { Sequence = sequence, Pack = _packIndex.PackKey(sequence) }, new MemoryStream()));
+            }
+
+            var (index, body) = packs[^1];
+            entry.Offset = body.Length;
+            entry.Length = stored.Length;
+            index.Entries.Add(entry);
+            body.Write(stored);
+        }
+
+        /// <summary>
+        /// Upload a pack, if the index has one, then the index itself, and apply it
+        /// </summary>
+        private async Task UploadPackAsync(PackIndexFile index, MemoryStream body)
+        {
+            if (index.Pack != null)
+            {
+                var packBytes = body.ToArray();
+                var etag = await _cloudStorage.UploadBytesAsync(index.Pack, packBytes);
+                _diskCache?.Store(index.Pack, packBytes, etag);
+            }
+
+            var indexKey = _packIndex!.IndexKey(index.Sequence);
+            var indexBytes = CloudPackIndex.Serialize(index);
+            var indexETag = await _cloudStorage.UploadBytesAsync(indexKey, indexBytes);
+            _diskCache?.Store(indexKey, indexBytes, indexETag);
+            _packIndex.Apply(indexKey, index);
+        }
+
         /// <summary>
         /// Helper method to upload processed data to cloud storage
         /// </summary>
@@ -406,6 +819,7 @@ namespace AcornDB.Persistence.Cloud
             }
 
             await _cloudStorage.UploadAsync(key, data);
+            _diskCache?.Invalidate(key);
         }
 
         /// <summary>
@@ -423,6 +837,25 @@ namespace AcornDB.Persistence.Cloud
             return Convert.ToBase64String(output.ToArray());
         }
 
+        private static byte[] CompressBytes(byte[] bytes)
+        {
+            using var output = new MemoryStream();
+            using (var gzip = new GZipStream(output, CompressionLevel.Optimal))
+            {
+                gzip.Write(bytes, 0, bytes.Length);
+            }
+            return output.ToArray();
+        }
+
+        private static byte[] DecompressBytes(byte[] bytes)
+        {
+            using var input = new MemoryStream(bytes);
+            using var gzip = new GZipStream(input, CompressionMode.Decompress);
+            using var output = new MemoryStream();
+            gzip.CopyTo(output);
+            return output.ToArray();
+        }
+
         /// <summary>
         /// Decompress Base64-encoded GZip data to string
         /// </summary>
@@ -447,7 +880,8 @@ namespace AcornDB.Persistence.Cloud
             // This ensures proper batching cleanup
             base.Dispose();
 
-            // CloudTrunk has no additional resources to dispose
+            _packIndexLoad.Dispose();
+            _compactGate.Dispose();
         }
     }
 }
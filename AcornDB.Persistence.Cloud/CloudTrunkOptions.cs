@@ -0,0 +1,60 @@
+using System;
+
+namespace AcornDB.Persistence.Cloud
+{
+    /// <summary>
+    /// Object layout and read-path options for CloudTrunk
+    /// </summary>
+    public class CloudTrunkOptions
+    {
+        /// <summary>
+        /// Pack small nuts into shared pack objects with an index instead of one object per nut.
+        /// Loading a tree then takes one GET per pack rather than one per nut. Objects written
+        /// without packing are still read.
+        /// Default: false (one object per nut)
+        /// </summary>
+        public bool PackSmallNuts { get; set; } = false;
+
+        /// <summary>
+        /// Nuts whose stored size is above this are uploaded as their own object (in multipart
+        /// chunks where the provider supports it) and only referenced from the pack index.
+        /// Default: 64 KB
+        /// </summary>
+        public int PackThresholdBytes { get; set; } = 64 * 1024;
+
+        /// <summary>
+        /// A flush starts a new pack once the current one reaches this size
+        /// Default: 8 MB
+        /// </summary>
+        public int TargetPackBytes { get; set; } = 8 * 1024 * 1024;
+
+        /// <summary>
+        /// Read single packed nuts with a byte-range GET when the provider supports it, instead
+        /// of downloading the whole pack
+        /// Default: true
+        /// </summary>
+        public bool UseRangeReads { get; set; } = true;
+
+        /// <summary>
+        /// Directory for an on-disk read-through cache of downloaded objects. Packs never change
+        /// once written, so cached packs are used as is; per-nut objects are revalidated with
+        /// their ETag on every read. Null disables the cache.
+        /// Default: null
+        /// </summary>
+        public string? LocalCacheDirectory { get; set; }
+
+        /// <summary>
+        /// Default options (one object per nut, no disk cache)
+        /// </summary>
+        public static CloudTrunkOptions Default => new CloudTrunkOptions();
+
+        /// <summary>
+        /// Packed layout for trees with many small nuts
+        /// Best for: Fast startup loads, large numbers of small documents
+        /// </summary>
+        public static CloudTrunkOptions Packed => new CloudTrunkOptions
+        {
+            PackSmallNuts = true
+        };
+    }
+}
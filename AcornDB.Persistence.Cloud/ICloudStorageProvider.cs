@@ -47,6 +47,76 @@ namespace AcornDB.Persistence.Cloud
         /// Get metadata about the cloud storage
         /// </summary>
         CloudStorageInfo GetInfo();
+
+        /// <summary>
+        /// Whether UploadBytesAsync/DownloadBytesAsync store raw bytes with ETags. When false they
+        /// fall back to Base64 over the string methods, which round-trips but is not interchangeable
+        /// with objects written by UploadAsync.
+        /// </summary>
+        bool SupportsBinaryObjects => false;
+
+        /// <summary>
+        /// Whether DownloadRangeAsync fetches only the requested bytes (HTTP Range) instead of the
+        /// whole object
+        /// </summary>
+        bool SupportsRangeReads => false;
+
+        /// <summary>
+        /// Upload raw bytes, in parallel multipart chunks where the provider supports it
+        /// </summary>
+        /// <param name="key">Object key/path</param>
+        /// <param name="content">Content to upload</param>
+        /// <returns>ETag of the stored object, if the provider reports one</returns>
+        async Task<string?> UploadBytesAsync(string key, byte[] content)
+        {
+            await UploadAsync(key, Convert.ToBase64String(content));
+            return null;
+        }
+
+        /// <summary>
+        /// Download raw bytes
+        /// </summary>
+        /// <param name="key">Object key/path</param>
+        /// <param name="ifNoneMatch">ETag of a cached copy; when it still matches the object is not
+        /// transferred and CloudObject.NotModified is set</param>
+        /// <returns>The object, or null if not found</returns>
+        async Task<CloudObject?> DownloadBytesAsync(string key, string? ifNoneMatch = null)
+        {
+            var content = await DownloadAsync(key);
+            return content == null ? null : new CloudObject { Content = Convert.FromBase64String(content) };
+        }
+
+        /// <summary>
+        /// Download <paramref name="length"/> bytes starting at <paramref name="offset"/> of an object
+        /// written by UploadBytesAsync
+        /// </summary>
+        /// <returns>The bytes, or null if the object was not found</returns>
+        async Task<byte[]?> DownloadRangeAsync(string key, long offset, int length)
+        {
+            var obj = await DownloadBytesAsync(key);
+            return obj?.Content.AsSpan((int)offset, length).ToArray();
+        }
+    }
+
+    /// <summary>
+    /// A downloaded object and its ETag
+    /// </summary>
+    public class CloudObject
+    {
+        /// <summary>
+        /// Object bytes (empty when NotModified)
+        /// </summary>
+        public byte[] Content { get; set; } = Array.Empty<byte>();
+
+        /// <summary>
+        /// Entity tag of this version of the object, if the provider reports one
+        /// </summary>
+        public string? ETag { get; set; }
+
+        /// <summary>
+        /// The ETag passed as ifNoneMatch still matches, so the cached copy is current
+        /// </summary>
+        public bool NotModified { get; set; }
     }
 
     /// <summary>
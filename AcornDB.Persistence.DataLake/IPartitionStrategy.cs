@@ -11,5 +11,12 @@ namespace AcornDB.Persistence.DataLake
         /// Get partition path for a nut (e.g., "year=2025/month=10/day=14")
         /// </summary>
         string GetPartitionPath<T>(Nut<T> nut);
+
+        /// <summary>
+        /// Whether a partition path produced by this strategy can hold nuts stamped between
+        /// from and to (null = open bound). Time-range scans skip partitions that can't;
+        /// strategies that don't partition by time keep every partition.
+        /// </summary>
+        bool MayContain(string partitionPath, DateTime? from, DateTime? to) => true;
     }
 }
@@ -0,0 +1,93 @@
+using System;
+using System.Collections.Generic;
+using System.Linq;
+
+namespace AcornDB.Persistence.DataLake
+{
+    /// <summary>
+    /// Min/max statistics of one row group, written to the file footer so a scan can rule the
+    /// row group out without reading it. Ids are compared by their UTF-8 bytes.
+    /// </summary>
+    internal sealed class ParquetRowGroupStats
+    {
+        public int Index { get; set; }
+        public long Rows { get; set; }
+        public string IdMin { get; set; } = string.Empty;
+        public string IdMax { get; set; } = string.Empty;
+        public long TimestampMin { get; set; }
+        public long TimestampMax { get; set; }
+        public long GenerationMin { get; set; }
+        public long GenerationMax { get; set; }
+
+        /// <summary>
+        /// Whether rows are in id order, so lookups can binary search the Id column
+        /// </summary>
+        public bool Sorted { get; set; }
+    }
+
+    /// <summary>
+    /// A Parquet file of the trunk and the statistics of its row groups. Files are never
+    /// modified once written, so an entry stays valid until the file is merged away.
+    /// </summary>
+    internal sealed class ParquetFileEntry
+    {
+        public ParquetFileEntry(string path, string partition, List<ParquetRowGroupStats> rowGroups)
+        {
+            Path = path;
+            Partition = partition;
+            RowGroups = rowGroups;
+            GenerationMin = rowGroups.Count == 0 ? 0 : rowGroups.Min(g => g.GenerationMin);
+            GenerationMax = rowGroups.Count == 0 ? 0 : rowGroups.Max(g => g.GenerationMax);
+        }
+
+        public string Path { get; }
+
+        /// <summary>
+        /// Partition path relative to the trunk's base path ("" for the base itself)
+        /// </summary>
+        public string Partition { get; }
+
+        public List<ParquetRowGroupStats> RowGroups { get; }
+        public long GenerationMin { get; }
+        public long GenerationMax { get; }
+    }
+
+    /// <summary>
+    /// One stored row. Payloads stay as JSON until a nut is actually returned, so merges and
+    /// key-only lookups never deserialize them.
+    /// </summary>
+    internal sealed class ParquetRow
+    {
+        public string Id { get; set; } = string.Empty;
+        public long Generation { get; set; }
+        public bool Deleted { get; set; }
+        public int Version { get; set; }
+        public long Timestamp { get; set; }
+        public string Payload { get; set; } = string.Empty;
+        public long? ExpiresAt { get; set; }
+    }
+
+    /// <summary>
+    /// ParquetTrunk statistics: files on disk plus totals since the trunk was opened
+    /// </summary>
+    public class ParquetTrunkStats
+    {
+        public int Files { get; set; }
+        public int RowGroups { get; set; }
+        public int BufferedWrites { get; set; }
+        public long Flushes { get; set; }
+        public long Merges { get; set; }
+
+        /// <summary>
+        /// Partitions skipped by the partition strategy during scans
+        /// </summary>
+        public long PartitionsPruned { get; set; }
+
+        /// <summary>
+        /// Row groups skipped on their min/max statistics during scans
+        /// </summary>
+        public long RowGroupsPruned { get; set; }
+
+        public long RowGroupsRead { get; set; }
+    }
+}
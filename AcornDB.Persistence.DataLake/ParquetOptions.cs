@@ -31,6 +31,24 @@ namespace AcornDB.Persistence.DataLake
         /// </summary>
         public int RowGroupSize { get; set; } = 100_000;
 
+        /// <summary>
+        /// Buffered writes that trigger a flush to new delta files
+        /// Default: 10,000 (writes are also flushed every FlushInterval and on dispose)
+        /// </summary>
+        public int WriteBufferSize { get; set; } = 10_000;
+
+        /// <summary>
+        /// How often buffered writes are flushed in the background
+        /// Default: 1 second (TimeSpan.Zero flushes only when the buffer fills)
+        /// </summary>
+        public TimeSpan FlushInterval { get; set; } = TimeSpan.FromSeconds(1);
+
+        /// <summary>
+        /// Files in a partition that trigger a background merge into one file
+        /// Default: 8 (0 disables background merges; CompactAsync still works)
+        /// </summary>
+        public int MergeThreshold { get; set; } = 8;
+
         /// <summary>
         /// Default options with Snappy compression and no partitioning
         /// </summary>
@@ -43,6 +61,7 @@ namespace AcornDB.Persistence.DataLake
         {
             CompressionMethod = CompressionMethod.Gzip,
             RowGroupSize = 1_000_000,
+            WriteBufferSize = 100_000,
             AppendMode = false // Immutable files
         };
 
@@ -53,6 +72,8 @@ namespace AcornDB.Persistence.DataLake
         {
             CompressionMethod = CompressionMethod.Snappy,
             RowGroupSize = 10_000,
+            WriteBufferSize = 1_000,
+            FlushInterval = TimeSpan.FromMilliseconds(200),
             AppendMode = true
         };
     }
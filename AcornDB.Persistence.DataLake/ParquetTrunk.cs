@@ -4,6 +4,7 @@ using System.Collections.Generic;
 using System.IO;
 using System.Linq;
 using System.Runtime.CompilerServices;
+using System.Threading;
 using System.Threading.Tasks;
 using AcornDB;
 using AcornDB.Storage;
@@ -28,19 +29,66 @@ namespace AcornDB.Persistence.DataLake
     /// - Cloud storage integration (S3, Azure Data Lake via ICloudStorageProvider)
     /// - Bidirectional sync with data lakes
     ///
+    /// Storage layout:
+    /// - Writes are buffered and flushed as a new delta file per partition
+    ///   ({Type}.g{generation}.parquet); existing files are never rewritten in place
+    /// - Every row carries the generation of the flush that wrote it; the highest generation
+    ///   of an id wins, and tosses are stored as tombstone rows in the base partition
+    /// - Background merges fold a partition's deltas into one file once it has
+    ///   ParquetOptions.MergeThreshold of them; CompactAsync also drops tombstones
+    /// - Rows are sorted by id, and each row group's id/timestamp/generation ranges are kept
+    ///   in the file footer, so lookups and scans skip partitions, files and row groups
+    ///
     /// Use Cases:
     /// - Export AcornDB data to data lakes for analytics
     /// - Import data lake datasets into AcornDB
     /// - Cold storage with columnar compression
     /// - Interoperability with Spark, Athena, Synapse Analytics
     /// </summary>
-    public class ParquetTrunk<T> : TrunkBase<T> where T : class
+    public class ParquetTrunk<T> : TrunkBase<T>, IScanTrunk<T> where T : class
     {
+        private const string RowGroupMetadataKey = "acorn.rowgroups";
+        private const int MaxReadAttempts = 3;
+        private static readonly IComparer<string> KeyOrder = TrunkScanFilter<T>.KeyComparer;
+
         private readonly string _basePath;
         private readonly ICloudStorageProvider? _cloudStorage;
         private readonly ParquetOptions _options;
         private readonly string _typeName;
 
+        // Writes not yet in a file, and the batch currently being flushed; reads check both
+        // before the files. _catalog is replaced, never modified, so readers can hold a copy.
+        private readonly object _sync = new();
+        private Dictionary<string, PendingRow> _buffer = new();
+        private Dictionary<string, PendingRow>? _flushing;
+        private List<ParquetFileEntry>? _catalog;
+        private long _nextGeneration = 1;
+
+        private readonly SemaphoreSlim _catalogGate = new(1, 1);
+        private readonly SemaphoreSlim _flushGate = new(1, 1);
+        private readonly SemaphoreSlim _mergeGate = new(1, 1);
+        private readonly Timer? _bufferFlushTimer;
+        private int _mergeScheduled;
+        private Task _mergeTask = Task.CompletedTask;
+
+        private long _flushes;
+        private long _merges;
+        private long _partitionsPruned;
+        private long _rowGroupsPruned;
+        private long _rowGroupsRead;
+
+        private readonly struct PendingRow
+        {
+            public PendingRow(ParquetRow row, string partition)
+            {
+                Row = row;
+                Partition = partition;
+            }
+
+            public ParquetRow Row { get; }
+            public string Partition { get; }
+        }
+
         /// <summary>
         /// Create Parquet trunk for local file system
         /// </summary>
@@ -61,11 +109,28 @@ namespace AcornDB.Persistence.DataLake
                 Directory.CreateDirectory(_basePath);
             }
 
+            if (_options.FlushInterval > TimeSpan.Zero)
+            {
+                _bufferFlushTimer = new Timer(_ =>
+                {
+                    if (_disposed) return;
+                    try
+                    {
+                        FlushAsync().GetAwaiter().GetResult();
+                    }
+                    catch (Exception ex)
+                    {
+                        AcornLog.Warning($"⚠️ ParquetTrunk flush failed, writes stay buffered: {ex.Message}");
+                    }
+                }, null, _options.FlushInterval, _options.FlushInterval);
+            }
+
             AcornLog.Info($"📊 ParquetTrunk initialized:");
             AcornLog.Info($"   Type: {_typeName}");
             AcornLog.Info($"   Path: {_basePath}");
             AcornLog.Info($"   Compression: {_options.CompressionMethod}");
             AcornLog.Info($"   Partitioning: {(_options.PartitionStrategy != null ? "Enabled" : "Disabled")}");
+            AcornLog.Info($"   Write Buffer: {_options.WriteBufferSize} nuts, flushed every {_options.FlushInterval.TotalMilliseconds:F0}ms");
         }
 
         /// <summary>
@@ -88,94 +153,118 @@ namespace AcornDB.Persistence.DataLake
         [MethodImpl(MethodImplOptions.AggressiveInlining)]
         public override void Stash(string id, Nut<T> nut)
         {
-            StashAsync(id, nut).GetAwaiter().GetResult();
-        }
-
-        public async Task StashAsync(string id, Nut<T> nut)
-        {
-            // Parquet is optimized for batch writes (columnar format)
-            // Single-item writes are inefficient - buffer and flush periodically
-            var filePath = GetPartitionedPath(nut);
-            var nuts = new List<Nut<T>> { nut };
-
-            // For append mode, we need to read existing data, append, and rewrite
-            // This is expensive for single items - consider using in-memory buffer
-            if (_options.AppendMode && await FileExistsAsync(filePath))
+            if (Buffer(id, ToRow(id, nut), PartitionFor(nut)))
             {
-                var existing = await ReadParquetFileAsync(filePath);
-
-                // Replace or append based on ID
-                var existingDict = existing.ToDictionary(n => n.Id);
-                existingDict[id] = nut;
-                nuts = existingDict.Values.ToList();
+                FlushAsync().GetAwaiter().GetResult();
             }
+        }
 
-            await WriteParquetFileAsync(filePath, nuts);
+        public override Task StashAsync(string id, Nut<T> nut)
+        {
+            // Only a full buffer costs I/O; the nut is visible to reads as soon as it is buffered
+            return Buffer(id, ToRow(id, nut), PartitionFor(nut))
+                ? FlushAsync()
+                : Task.CompletedTask;
         }
 
         [MethodImpl(MethodImplOptions.AggressiveInlining)]
         public override Nut<T>? Crack(string id)
         {
+            if (TryGetPending(id, out var pending))
+                return pending.Deleted ? null : ToNut(pending);
+
             return CrackAsync(id).GetAwaiter().GetResult();
         }
 
         public async Task<Nut<T>?> CrackAsync(string id)
         {
-            // Parquet doesn't support indexed lookups - need to scan files
-            // For production: maintain a separate index (Hive metastore, Delta Lake, etc.)
-            var allNuts = await CrackAllAsync();
-            return allNuts.FirstOrDefault(n => n.Id == id);
+            if (TryGetPending(id, out var pending))
+                return pending.Deleted ? null : ToNut(pending);
+
+            var newest = await RetryIfFileVanishedAsync(async () =>
+            {
+                var catalog = await GetCatalogAsync();
+                ParquetRow? best = null;
+
+                // Newest files first: once a version is found, only files that can hold a
+                // later generation are still opened
+                foreach (var file in catalog.OrderByDescending(f => f.GenerationMax))
+                {
+                    if (best != null && file.GenerationMax <= best.Generation)
+                        continue;
+
+                    var row = await FindInFileAsync(file, id, best?.Generation ?? -1);
+                    if (row != null)
+                        best = row;
+                }
+
+                return best;
+            });
+
+            return newest == null || newest.Deleted ? null : ToNut(newest);
         }
 
         [MethodImpl(MethodImplOptions.AggressiveInlining)]
         public override void Toss(string id)
         {
-            TossAsync(id).GetAwaiter().GetResult();
+            if (Buffer(id, Tombstone(id), string.Empty))
+            {
+                FlushAsync().GetAwaiter().GetResult();
+            }
         }
 
-        public async Task TossAsync(string id)
+        public Task TossAsync(string id)
         {
-            // Parquet is immutable - need to read, filter, and rewrite
-            // Expensive operation - consider using Delta Lake format for ACID deletes
-            var files = await ListParquetFilesAsync();
+            return Buffer(id, Tombstone(id), string.Empty)
+                ? FlushAsync()
+                : Task.CompletedTask;
+        }
 
-            foreach (var file in files)
+        public override IEnumerable<Nut<T>> CrackAll()
+        {
+            return CrackAllAsync().GetAwaiter().GetResult();
+        }
+
+        public async Task<IEnumerable<Nut<T>>> CrackAllAsync()
+        {
+            var pending = SnapshotPending();
+            var newest = await RetryIfFileVanishedAsync(async () =>
             {
-                var nuts = await ReadParquetFileAsync(file);
-                var filtered = nuts.Where(n => n.Id != id).ToList();
+                var catalog = await GetCatalogAsync();
+                var rows = new Dictionary<string, ParquetRow>(StringComparer.Ordinal);
 
-                if (filtered.Count != nuts.Count)
+                foreach (var file in catalog)
                 {
-                    if (filtered.Count > 0)
-                    {
-                        await WriteParquetFileAsync(file, filtered);
-                    }
-                    else
+                    foreach (var row in await ReadRowGroupsAsync(file, file.RowGroups.Select(g => g.Index), includeValues: true))
                     {
-                        // Delete empty partition
-                        await DeleteFileAsync(file);
+                        KeepNewest(rows, row);
                     }
                 }
-            }
+
+                return rows;
+            });
+
+            return Resolve(newest.Values, pending, filter: null);
         }
 
-        public override IEnumerable<Nut<T>> CrackAll()
+        /// <summary>
+        /// Nuts that may match the filter. Partitions are pruned through the partition
+        /// strategy and row groups through their id and timestamp ranges; only the row groups
+        /// left are read. Where expressions are not evaluated here: payloads are stored as one
+        /// JSON column, so there are no statistics to prune on.
+        /// </summary>
+        public IEnumerable<Nut<T>> CrackWhere(TrunkScanFilter<T> filter)
         {
-            return CrackAllAsync().GetAwaiter().GetResult();
+            return CrackWhereAsync(filter).GetAwaiter().GetResult();
         }
 
-        public async Task<IEnumerable<Nut<T>>> CrackAllAsync()
+        public async Task<IReadOnlyList<Nut<T>>> CrackWhereAsync(TrunkScanFilter<T> filter)
         {
-            var files = await ListParquetFilesAsync();
-            var allNuts = new List<Nut<T>>();
+            if (filter == null) throw new ArgumentNullException(nameof(filter));
 
-            foreach (var file in files)
-            {
-                var nuts = await ReadParquetFileAsync(file);
-                allNuts.AddRange(nuts);
-            }
-
-            return allNuts;
+            var pending = SnapshotPending();
+            var rows = await RetryIfFileVanishedAsync(() => ScanAsync(filter));
+            return Resolve(rows, pending, filter);
         }
 
         public override IReadOnlyList<Nut<T>> GetHistory(string id)
@@ -201,181 +290,789 @@ namespace AcornDB.Persistence.DataLake
             SupportsSync = true,
             IsDurable = true,
             SupportsAsync = true,
+            SupportsScanPushdown = true,
             TrunkType = "ParquetTrunk"
         };
 
+        /// <summary>
+        /// Import a batch as one delta file per partition. Without AppendMode the batch
+        /// replaces the files of the partitions it touches.
+        /// </summary>
         public async Task ImportChangesAsync(IEnumerable<Nut<T>> incoming)
         {
-            var incomingList = incoming.ToList();
-            if (!incomingList.Any()) return;
-
-            // Group by partition for efficient writes
-            var partitionedNuts = incomingList
-                .GroupBy(nut => GetPartitionedPath(nut))
+            var rows = incoming
+                .Select(nut => (nut.Id, Row: new PendingRow(ToRow(nut.Id, nut), PartitionFor(nut))))
                 .ToList();
+            if (rows.Count == 0) return;
+
+            lock (_sync)
+            {
+                foreach (var (id, row) in rows)
+                {
+                    _buffer[id] = row;
+                }
+            }
+
+            int count = rows.Count;
+
+            AcornLog.Info($"   📊 Importing {count} nuts");
+            await FlushAsync();
+            AcornLog.Info($"   📊 Import complete: {count} nuts");
+        }
+
+        /// <summary>
+        /// Write buffered writes and tosses as one new delta file per partition
+        /// </summary>
+        public async Task FlushAsync()
+        {
+            await _flushGate.WaitAsync();
+            try
+            {
+                Dictionary<string, PendingRow> batch;
+                lock (_sync)
+                {
+                    if (_buffer.Count == 0) return;
+                    batch = _buffer;
+                    _flushing = batch;
+                    _buffer = new Dictionary<string, PendingRow>();
+                }
 
-            AcornLog.Info($"   📊 Importing {incomingList.Count} nuts across {partitionedNuts.Count} partitions");
+                try
+                {
+                    await FlushBatchAsync(batch);
+                }
+                catch
+                {
+                    // Put the batch back behind anything written since, so nothing is lost
+                    lock (_sync)
+                    {
+                        foreach (var entry in batch)
+                        {
+                            _buffer.TryAdd(entry.Key, entry.Value);
+                        }
+                        _flushing = null;
+                    }
+                    throw;
+                }
+            }
+            finally
+            {
+                _flushGate.Release();
+            }
+
+            ScheduleMerges();
+        }
+
+        private async Task FlushBatchAsync(Dictionary<string, PendingRow> batch)
+        {
+            await GetCatalogAsync();
 
-            foreach (var partition in partitionedNuts)
+            long generation;
+            lock (_sync)
             {
-                var filePath = partition.Key;
-                var nuts = partition.ToList();
+                generation = _nextGeneration++;
+            }
 
-                // Merge with existing data if append mode
-                if (_options.AppendMode && await FileExistsAsync(filePath))
+            var written = new List<ParquetFileEntry>();
+            foreach (var partition in batch.Values.GroupBy(p => p.Partition))
+            {
+                var rows = partition.Select(p =>
                 {
-                    var existing = await ReadParquetFileAsync(filePath);
-                    var existingDict = existing.ToDictionary(n => n.Id);
+                    p.Row.Generation = generation;
+                    return p.Row;
+                }).ToList();
+
+                written.Add(await WriteFileAsync(partition.Key, DeltaFileName(generation), rows));
+            }
+
+            List<ParquetFileEntry> replaced;
+            lock (_sync)
+            {
+                var partitions = written.Select(f => f.Partition).ToHashSet();
+                replaced = _options.AppendMode
+                    ? new List<ParquetFileEntry>()
+                    : _catalog!.Where(f => partitions.Contains(f.Partition)).ToList();
+
+                _catalog = _catalog!.Except(replaced).Concat(written).ToList();
+                _flushing = null;
+            }
+
+            foreach (var file in replaced)
+            {
+                await DeleteFileAsync(file.Path);
+            }
 
-                    foreach (var nut in nuts)
+            Interlocked.Increment(ref _flushes);
+        }
+
+        /// <summary>
+        /// Merge every partition into a single file, keeping only the newest live version of
+        /// each nut. Unlike background merges this drops tombstones, since every older version
+        /// is rewritten at the same time.
+        /// </summary>
+        public async Task CompactAsync()
+        {
+            await FlushAsync();
+            await _mergeGate.WaitAsync();
+            try
+            {
+                var inputs = (await GetCatalogAsync()).ToList();
+                if (inputs.Count == 0) return;
+
+                var newest = new Dictionary<string, (ParquetRow Row, string Partition)>(StringComparer.Ordinal);
+                foreach (var file in inputs)
+                {
+                    foreach (var row in await ReadRowGroupsAsync(file, file.RowGroups.Select(g => g.Index), includeValues: true))
                     {
-                        existingDict[nut.Id] = nut; // Upsert
+                        if (!newest.TryGetValue(row.Id, out var current) || row.Generation > current.Row.Generation)
+                            newest[row.Id] = (row, file.Partition);
                     }
+                }
+
+                var written = new List<ParquetFileEntry>();
+                foreach (var partition in newest.Values.Where(v => !v.Row.Deleted).GroupBy(v => v.Partition))
+                {
+                    var rows = partition.Select(v => v.Row).ToList();
+                    var name = MergedFileName(rows.Min(r => r.Generation), rows.Max(r => r.Generation));
+                    written.Add(await WriteFileAsync(partition.Key, name, rows));
+                }
+
+                await ReplaceFilesAsync(inputs, written);
+                AcornLog.Info($"📊 ParquetTrunk compacted {inputs.Count} files into {written.Count}");
+            }
+            finally
+            {
+                _mergeGate.Release();
+            }
+        }
+
+        public ParquetTrunkStats GetStats()
+        {
+            lock (_sync)
+            {
+                return new ParquetTrunkStats
+                {
+                    Files = _catalog?.Count ?? 0,
+                    RowGroups = _catalog?.Sum(f => f.RowGroups.Count) ?? 0,
+                    BufferedWrites = _buffer.Count + (_flushing?.Count ?? 0),
+                    Flushes = Interlocked.Read(ref _flushes),
+                    Merges = Interlocked.Read(ref _merges),
+                    PartitionsPruned = Interlocked.Read(ref _partitionsPruned),
+                    RowGroupsPruned = Interlocked.Read(ref _rowGroupsPruned),
+                    RowGroupsRead = Interlocked.Read(ref _rowGroupsRead)
+                };
+            }
+        }
+
+        private bool Buffer(string id, ParquetRow row, string partition)
+        {
+            lock (_sync)
+            {
+                _buffer[id] = new PendingRow(row, partition);
+                return _buffer.Count >= _options.WriteBufferSize;
+            }
+        }
+
+        private bool TryGetPending(string id, out ParquetRow row)
+        {
+            lock (_sync)
+            {
+                if (_buffer.TryGetValue(id, out var pending) || (_flushing != null && _flushing.TryGetValue(id, out pending)))
+                {
+                    row = pending.Row;
+                    return true;
+                }
+            }
+
+            row = null!;
+            return false;
+        }
+
+        private Dictionary<string, ParquetRow> SnapshotPending()
+        {
+            lock (_sync)
+            {
+                var pending = new Dictionary<string, ParquetRow>(StringComparer.Ordinal);
+                if (_flushing != null)
+                {
+                    foreach (var entry in _flushing)
+                        pending[entry.Key] = entry.Value.Row;
+                }
+                foreach (var entry in _buffer)
+                    pending[entry.Key] = entry.Value.Row;
+                return pending;
+            }
+        }
+
+        /// <summary>
+        /// Current nuts among the stored rows, with buffered writes taking precedence
+        /// </summary>
+        private List<Nut<T>> Resolve(IEnumerable<ParquetRow> stored, Dictionary<string, ParquetRow> pending, TrunkScanFilter<T>? filter)
+        {
+            var nuts = new List<Nut<T>>();
+            foreach (var row in stored)
+            {
+                if (!row.Deleted && !pending.ContainsKey(row.Id) && Matches(row, filter))
+                    nuts.Add(ToNut(row));
+            }
+            foreach (var row in pending.Values)
+            {
+                if (!row.Deleted && Matches(row, filter))
+                    nuts.Add(ToNut(row));
+            }
+            return nuts;
+        }
+
+        private static bool Matches(ParquetRow row, TrunkScanFilter<T>? filter)
+        {
+            return filter == null
+                || (filter.MatchesTimestamp(new DateTime(row.Timestamp)) && filter.MatchesKey(row.Id));
+        }
+
+        private static void KeepNewest(Dictionary<string, ParquetRow> rows, ParquetRow row)
+        {
+            if (!rows.TryGetValue(row.Id, out var current) || row.Generation > current.Generation)
+                rows[row.Id] = row;
+        }
+
+        /// <summary>
+        /// Newest stored version of every id that may match the filter
+        /// </summary>
+        private async Task<List<ParquetRow>> ScanAsync(TrunkScanFilter<T> filter)
+        {
+            var catalog = await GetCatalogAsync();
+            var strategy = _options.PartitionStrategy;
+            var candidates = new Dictionary<string, ParquetRow>(StringComparer.Ordinal);
+            var read = new HashSet<(ParquetFileEntry, int)>();
+
+            foreach (var file in catalog)
+            {
+                // The base partition also holds tombstones, so it is never pruned
+                if (strategy != null && file.Partition.Length > 0 && filter.HasTimestampRange
+                    && !strategy.MayContain(file.Partition, filter.TimestampFrom, filter.TimestampTo))
+                {
+                    Interlocked.Increment(ref _partitionsPruned);
+                    continue;
+                }
 
-                    nuts = existingDict.Values.ToList();
+                var groups = file.RowGroups
+                    .Where(g => filter.OverlapsTimestamps(new DateTime(g.TimestampMin), new DateTime(g.TimestampMax))
+                             && filter.OverlapsKeys(g.IdMin, g.IdMax))
+                    .Select(g => g.Index)
+                    .ToList();
+                Interlocked.Add(ref _rowGroupsPruned, file.RowGroups.Count - groups.Count);
+                if (groups.Count == 0) continue;
+
+                foreach (var row in await ReadRowGroupsAsync(file, groups, includeValues: true))
+                {
+                    // Non-matching versions are kept too: a newer one that no longer matches
+                    // hides an older one that did
+                    KeepNewest(candidates, row);
                 }
+                foreach (var index in groups)
+                    read.Add((file, index));
+            }
 
-                await WriteParquetFileAsync(filePath, nuts);
+            if (candidates.Count == 0)
+                return new List<ParquetRow>();
+
+            // A later version may sit in a row group that was pruned, because it no longer
+            // matches. Only the ids of row groups that are newer than some candidate and
+            // overlap the candidates' id range are read to find those.
+            long oldest = candidates.Values.Min(r => r.Generation);
+            string idMin = candidates.Keys.Min(KeyOrder)!;
+            string idMax = candidates.Keys.Max(KeyOrder)!;
+
+            foreach (var file in catalog)
+            {
+                var groups = file.RowGroups
+                    .Where(g => g.GenerationMax > oldest && !read.Contains((file, g.Index))
+                             && KeyOrder.Compare(g.IdMin, idMax) <= 0 && KeyOrder.Compare(idMin, g.IdMax) <= 0)
+                    .Select(g => g.Index)
+                    .ToList();
+                if (groups.Count == 0) continue;
+
+                foreach (var row in await ReadRowGroupsAsync(file, groups, includeValues: false))
+                {
+                    if (candidates.TryGetValue(row.Id, out var current) && row.Generation > current.Generation)
+                        candidates.Remove(row.Id);
+                }
             }
 
-            AcornLog.Info($"   📊 Import complete: {incomingList.Count} nuts");
+            return candidates.Values.Where(r => !r.Deleted && Matches(r, filter)).ToList();
         }
 
         /// <summary>
-        /// Get partitioned file path based on partition strategy
+        /// Newest version of id in the file that is later than newerThan, or null
         /// </summary>
-        private string GetPartitionedPath(Nut<T> nut)
+        private async Task<ParquetRow?> FindInFileAsync(ParquetFileEntry file, string id, long newerThan)
         {
-            var fileName = $"{_typeName}.parquet";
+            var groups = file.RowGroups
+                .Where(g => g.GenerationMax > newerThan
+                         && KeyOrder.Compare(g.IdMin, id) <= 0 && KeyOrder.Compare(id, g.IdMax) <= 0)
+                .OrderByDescending(g => g.GenerationMax)
+                .ToList();
+            if (groups.Count == 0) return null;
 
-            if (_options.PartitionStrategy == null)
+            using var stream = await OpenFileAsync(file.Path);
+            using var reader = await ParquetReader.CreateAsync(stream);
+            var fields = reader.Schema.DataFields.ToDictionary(f => f.Name);
+
+            ParquetRow? best = null;
+            foreach (var stats in groups)
             {
-                return _cloudStorage == null
-                    ? Path.Combine(_basePath, fileName)
-                    : $"{_basePath}/{fileName}";
+                if (best != null && stats.GenerationMax <= best.Generation)
+                    continue;
+
+                using var groupReader = reader.OpenRowGroupReader(stats.Index);
+                Interlocked.Increment(ref _rowGroupsRead);
+                var ids = await ReadColumn<string>(groupReader, fields["Id"]);
+                int index = stats.Sorted ? Array.BinarySearch(ids, id, KeyOrder) : Array.IndexOf(ids, id);
+                if (index < 0) continue;
+
+                var row = (await ReadRowsAsync(groupReader, fields, includeValues: true, ids))[index];
+                if (best == null || row.Generation > best.Generation)
+                    best = row;
+            }
+
+            return best;
+        }
+
+        private void ScheduleMerges()
+        {
+            if (_options.MergeThreshold < 2 || _disposed) return;
+
+            lock (_sync)
+            {
+                if (_catalog == null || !_catalog.GroupBy(f => f.Partition).Any(p => p.Count() >= _options.MergeThreshold))
+                    return;
+            }
+
+            if (Interlocked.CompareExchange(ref _mergeScheduled, 1, 0) != 0) return;
+
+            _mergeTask = Task.Run(async () =>
+            {
+                try
+                {
+                    await MergeDuePartitionsAsync();
+                }
+                catch (Exception ex)
+                {
+                    AcornLog.Warning($"⚠️ ParquetTrunk background merge failed: {ex.Message}");
+                }
+                finally
+                {
+                    Volatile.Write(ref _mergeScheduled, 0);
+                }
+            });
+        }
+
+        private async Task MergeDuePartitionsAsync()
+        {
+            await _mergeGate.WaitAsync();
+            try
+            {
+                List<List<ParquetFileEntry>> due;
+                lock (_sync)
+                {
+                    due = _catalog!
+                        .GroupBy(f => f.Partition)
+                        .Where(p => p.Count() >= _options.MergeThreshold)
+                        .Select(p => p.ToList())
+                        .ToList();
+                }
+
+                foreach (var inputs in due)
+                {
+                    if (_disposed) return;
+                    await MergeFilesAsync(inputs);
+                }
+            }
+            finally
+            {
+                _mergeGate.Release();
+            }
+        }
+
+        /// <summary>
+        /// Fold one partition's files into one. Row generations and tombstones are kept: other
+        /// partitions may still hold older versions they hide.
+        /// </summary>
+        private async Task MergeFilesAsync(List<ParquetFileEntry> inputs)
+        {
+            var newest = new Dictionary<string, ParquetRow>(StringComparer.Ordinal);
+            foreach (var file in inputs)
+            {
+                foreach (var row in await ReadRowGroupsAsync(file, file.RowGroups.Select(g => g.Index), includeValues: true))
+                {
+                    KeepNewest(newest, row);
+                }
+            }
+
+            var rows = newest.Values.ToList();
+            var name = MergedFileName(inputs.Min(f => f.GenerationMin), inputs.Max(f => f.GenerationMax));
+            var merged = await WriteFileAsync(inputs[0].Partition, name, rows);
+
+            if (await ReplaceFilesAsync(inputs, new List<ParquetFileEntry> { merged }))
+                Interlocked.Increment(ref _merges);
+        }
+
+        /// <summary>
+        /// Swap files in the catalog and delete the old ones. Gives up, deleting the new files
+        /// instead, if a flush has replaced any of the old ones meanwhile.
+        /// </summary>
+        private async Task<bool> ReplaceFilesAsync(List<ParquetFileEntry> inputs, List<ParquetFileEntry> outputs)
+        {
+            bool replaced;
+            lock (_sync)
+            {
+                replaced = inputs.All(_catalog!.Contains);
+                if (replaced)
+                {
+                    // Outputs may reuse an input's name, in which case they already replaced it
+                    var outputPaths = outputs.Select(f => f.Path).ToHashSet();
+                    _catalog = _catalog.Except(inputs).Where(f => !outputPaths.Contains(f.Path)).Concat(outputs).ToList();
+                }
+            }
+
+            var obsolete = replaced ? inputs.Where(f => !outputs.Any(o => o.Path == f.Path)) : outputs;
+            foreach (var file in obsolete)
+            {
+                await DeleteFileAsync(file.Path);
+            }
+
+            return replaced;
+        }
+
+        /// <summary>
+        /// Files are merged away underneath readers; a read that hits a deleted file starts
+        /// over from the current catalog
+        /// </summary>
+        private static async Task<TResult> RetryIfFileVanishedAsync<TResult>(Func<Task<TResult>> read)
+        {
+            for (int attempt = 1; ; attempt++)
+            {
+                try
+                {
+                    return await read();
+                }
+                catch (Exception ex) when ((ex is FileNotFoundException || ex is DirectoryNotFoundException) && attempt < MaxReadAttempts)
+                {
+                }
+            }
+        }
+
+        private async Task<List<ParquetFileEntry>> GetCatalogAsync()
+        {
+            var catalog = Volatile.Read(ref _catalog);
+            if (catalog != null) return catalog;
+
+            await _catalogGate.WaitAsync();
+            try
+            {
+                if (_catalog != null) return _catalog;
+
+                var entries = new List<ParquetFileEntry>();
+                foreach (var file in await ListParquetFilesAsync())
+                {
+                    var entry = await ReadFileEntryAsync(file);
+                    if (entry != null)
+                        entries.Add(entry);
+                }
+
+                lock (_sync)
+                {
+                    _nextGeneration = Math.Max(_nextGeneration, entries.Count == 0 ? 1 : entries.Max(f => f.GenerationMax) + 1);
+                    _catalog = entries;
+                }
+
+                return entries;
+            }
+            finally
+            {
+                _catalogGate.Release();
+            }
+        }
+
+        /// <summary>
+        /// Read a file's row group statistics from its footer. Files written before they were
+        /// recorded (or by other tools) have their Id and Timestamp columns read instead.
+        /// </summary>
+        private async Task<ParquetFileEntry?> ReadFileEntryAsync(string filePath)
+        {
+            try
+            {
+                using var stream = await OpenFileAsync(filePath);
+                using var reader = await ParquetReader.CreateAsync(stream);
+
+                List<ParquetRowGroupStats>? stats = null;
+                if (reader.CustomMetadata != null && reader.CustomMetadata.TryGetValue(RowGroupMetadataKey, out var json))
+                {
+                    stats = JsonConvert.DeserializeObject<List<ParquetRowGroupStats>>(json);
+                }
+
+                if (stats == null)
+                {
+                    var fields = reader.Schema.DataFields.ToDictionary(f => f.Name);
+                    stats = new List<ParquetRowGroupStats>();
+                    for (int i = 0; i < reader.RowGroupCount; i++)
+                    {
+                        using var groupReader = reader.OpenRowGroupReader(i);
+                        var rows = await ReadRowsAsync(groupReader, fields, includeValues: true);
+                        if (rows.Count > 0)
+                            stats.Add(StatsFor(i, rows));
+                    }
+                }
+
+                return new ParquetFileEntry(filePath, PartitionOf(filePath), stats);
+            }
+            catch (Exception ex) when (ex is FileNotFoundException || ex is DirectoryNotFoundException)
+            {
+                return null;
+            }
+        }
+
+        private static ParquetRowGroupStats StatsFor(int index, List<ParquetRow> rows)
+        {
+            var stats = new ParquetRowGroupStats
+            {
+                Index = index,
+                Rows = rows.Count,
+                IdMin = rows[0].Id,
+                IdMax = rows[0].Id,
+                TimestampMin = long.MaxValue,
+                TimestampMax = long.MinValue,
+                GenerationMin = long.MaxValue,
+                GenerationMax = long.MinValue,
+                Sorted = true
+            };
+
+            for (int i = 0; i < rows.Count; i++)
+            {
+                var row = rows[i];
+                if (KeyOrder.Compare(row.Id, stats.IdMin) < 0) stats.IdMin = row.Id;
+                if (KeyOrder.Compare(row.Id, stats.IdMax) > 0) stats.IdMax = row.Id;
+                if (i > 0 && KeyOrder.Compare(rows[i - 1].Id, row.Id) > 0) stats.Sorted = false;
+                stats.TimestampMin = Math.Min(stats.TimestampMin, row.Timestamp);
+                stats.TimestampMax = Math.Max(stats.TimestampMax, row.Timestamp);
+                stats.GenerationMin = Math.Min(stats.GenerationMin, row.Generation);
+                stats.GenerationMax = Math.Max(stats.GenerationMax, row.Generation);
+            }
+
+            return stats;
+        }
+
+        private ParquetRow ToRow(string id, Nut<T> nut)
+        {
+            return new ParquetRow
+            {
+                Id = id,
+                Version = nut.Version,
+                Timestamp = nut.Timestamp.Ticks,
+                Payload = JsonConvert.SerializeObject(nut.Payload),
+                ExpiresAt = nut.ExpiresAt?.Ticks
+            };
+        }
+
+        private static ParquetRow Tombstone(string id)
+        {
+            return new ParquetRow
+            {
+                Id = id,
+                Deleted = true,
+                Timestamp = DateTime.UtcNow.Ticks
+            };
+        }
+
+        private static Nut<T> ToNut(ParquetRow row)
+        {
+            return new Nut<T>
+            {
+                Id = row.Id,
+                Version = row.Version,
+                Timestamp = new DateTime(row.Timestamp),
+                Payload = JsonConvert.DeserializeObject<T>(row.Payload)!,
+                ExpiresAt = row.ExpiresAt.HasValue ? new DateTime(row.ExpiresAt.Value) : null
+            };
+        }
+
+        /// <summary>
+        /// Partition path of a nut based on partition strategy ("" without one)
+        /// </summary>
+        private string PartitionFor(Nut<T> nut)
+        {
+            return _options.PartitionStrategy?.GetPartitionPath(nut).Replace('\\', '/').Trim('/') ?? string.Empty;
+        }
+
+        private string PartitionOf(string filePath)
+        {
+            if (_cloudStorage == null)
+            {
+                var relative = Path.GetRelativePath(_basePath, Path.GetDirectoryName(filePath) ?? _basePath);
+                return relative == "." ? string.Empty : relative.Replace(Path.DirectorySeparatorChar, '/');
             }
 
-            var partitionPath = _options.PartitionStrategy.GetPartitionPath(nut);
+            var prefix = _basePath.TrimEnd('/') + "/";
+            var key = filePath.StartsWith(prefix, StringComparison.Ordinal) ? filePath.Substring(prefix.Length) : filePath;
+            int slash = key.LastIndexOf('/');
+            return slash < 0 ? string.Empty : key.Substring(0, slash);
+        }
+
+        private string GetFilePath(string partition, string fileName)
+        {
+            if (_cloudStorage == null)
+            {
+                return partition.Length == 0
+                    ? Path.Combine(_basePath, fileName)
+                    : Path.Combine(_basePath, partition.Replace('/', Path.DirectorySeparatorChar), fileName);
+            }
 
-            return _cloudStorage == null
-                ? Path.Combine(_basePath, partitionPath, fileName)
-                : $"{_basePath}/{partitionPath}/{fileName}";
+            return partition.Length == 0
+                ? $"{_basePath}/{fileName}"
+                : $"{_basePath}/{partition}/{fileName}";
         }
 
+        private string DeltaFileName(long generation) => $"{_typeName}.g{generation:D12}.parquet";
+
+        private string MergedFileName(long generationMin, long generationMax) =>
+            $"{_typeName}.g{generationMin:D12}-{generationMax:D12}.parquet";
+
         /// <summary>
-        /// Write nuts to Parquet file
+        /// Write rows to a new Parquet file, sorted by id, RowGroupSize rows per row group
         /// </summary>
-        private async Task WriteParquetFileAsync(string filePath, List<Nut<T>> nuts)
+        private async Task<ParquetFileEntry> WriteFileAsync(string partition, string fileName, List<ParquetRow> rows)
         {
-            if (!nuts.Any()) return;
+            rows.Sort((a, b) => KeyOrder.Compare(a.Id, b.Id));
+            var chunks = rows.Chunk(Math.Max(1, _options.RowGroupSize)).Select(c => c.ToList()).ToList();
+            var stats = chunks.Select((chunk, i) => StatsFor(i, chunk)).ToList();
 
             // Create schema from Nut<T> structure
             var schema = CreateParquetSchema();
+            var fields = schema.DataFields.ToDictionary(f => f.Name);
 
             using var ms = new MemoryStream();
 
-            // Write to Parquet format
             using (var writer = await ParquetWriter.CreateAsync(schema, ms))
             {
                 writer.CompressionMethod = _options.CompressionMethod;
+                writer.CustomMetadata = new Dictionary<string, string>
+                {
+                    [RowGroupMetadataKey] = JsonConvert.SerializeObject(stats)
+                };
 
-                using var groupWriter = writer.CreateRowGroup();
-
-                // Write each field as a column
-                await WriteColumn(groupWriter, "Id", nuts.Select(n => n.Id).ToArray());
-                await WriteColumn(groupWriter, "Version", nuts.Select(n => n.Version).ToArray());
-                await WriteColumn(groupWriter, "Timestamp", nuts.Select(n => n.Timestamp.Ticks).ToArray());
-                await WriteColumn(groupWriter, "Payload", nuts.Select(n => JsonConvert.SerializeObject(n.Payload)).ToArray());
-
-                // Optional fields
-                await WriteColumn(groupWriter, "ExpiresAt",
-                    nuts.Select(n => n.ExpiresAt?.Ticks).ToArray());
+                foreach (var chunk in chunks)
+                {
+                    using var groupWriter = writer.CreateRowGroup();
+
+                    await WriteColumn(groupWriter, fields["Id"], chunk.Select(r => r.Id).ToArray());
+                    await WriteColumn(groupWriter, fields["Version"], chunk.Select(r => r.Version).ToArray());
+                    await WriteColumn(groupWriter, fields["Timestamp"], chunk.Select(r => r.Timestamp).ToArray());
+                    await WriteColumn(groupWriter, fields["Payload"], chunk.Select(r => r.Payload).ToArray());
+                    await WriteColumn(groupWriter, fields["ExpiresAt"], chunk.Select(r => r.ExpiresAt).ToArray());
+                    await WriteColumn(groupWriter, fields["Generation"], chunk.Select(r => r.Generation).ToArray());
+                    await WriteColumn(groupWriter, fields["Deleted"], chunk.Select(r => r.Deleted).ToArray());
+                }
             }
 
             ms.Position = 0;
+            var filePath = GetFilePath(partition, fileName);
 
             // Write to local file or cloud storage
             if (_cloudStorage == null)
             {
-                // Local file system
                 var directory = Path.GetDirectoryName(filePath);
                 if (!string.IsNullOrEmpty(directory))
                 {
                     Directory.CreateDirectory(directory);
                 }
 
-                await using var fs = File.Create(filePath);
-                await ms.CopyToAsync(fs);
+                // Readers list *.parquet, so they never see a file that is still being written
+                var tempPath = filePath + ".tmp";
+                await using (var fs = File.Create(tempPath))
+                {
+                    await ms.CopyToAsync(fs);
+                }
+                File.Move(tempPath, filePath, overwrite: true);
             }
             else
             {
                 // Cloud storage - upload as byte array or stream
-                var bytes = ms.ToArray();
-                var base64 = Convert.ToBase64String(bytes);
+                var base64 = Convert.ToBase64String(ms.ToArray());
                 await _cloudStorage.UploadAsync(filePath, base64);
             }
+
+            return new ParquetFileEntry(filePath, partition, stats);
         }
 
         /// <summary>
-        /// Read nuts from Parquet file
+        /// Read rows of the given row groups. Without values only Id, Generation and Deleted
+        /// are read.
         /// </summary>
-        private async Task<List<Nut<T>>> ReadParquetFileAsync(string filePath)
+        private async Task<List<ParquetRow>> ReadRowGroupsAsync(ParquetFileEntry file, IEnumerable<int> rowGroups, bool includeValues)
         {
-            Stream stream;
+            using var stream = await OpenFileAsync(file.Path);
+            using var reader = await ParquetReader.CreateAsync(stream);
+            var fields = reader.Schema.DataFields.ToDictionary(f => f.Name);
 
-            if (_cloudStorage == null)
+            var rows = new List<ParquetRow>();
+            foreach (var index in rowGroups)
             {
-                // Local file system
-                if (!File.Exists(filePath))
-                    return new List<Nut<T>>();
-
-                stream = File.OpenRead(filePath);
+                using var groupReader = reader.OpenRowGroupReader(index);
+                Interlocked.Increment(ref _rowGroupsRead);
+                rows.AddRange(await ReadRowsAsync(groupReader, fields, includeValues));
             }
-            else
-            {
-                // Cloud storage
-                var base64 = await _cloudStorage.DownloadAsync(filePath);
-                if (base64 == null)
-                    return new List<Nut<T>>();
 
-                var bytes = Convert.FromBase64String(base64);
-                stream = new MemoryStream(bytes);
-            }
+            return rows;
+        }
 
-            using (stream)
+        /// <summary>
+        /// Files written before generations existed have neither Generation nor Deleted; their
+        /// rows are live and count as generation 0
+        /// </summary>
+        private async Task<List<ParquetRow>> ReadRowsAsync(
+            ParquetRowGroupReader groupReader,
+            Dictionary<string, DataField> fields,
+            bool includeValues,
+            string[]? ids = null)
+        {
+            ids ??= await ReadColumn<string>(groupReader, fields["Id"]);
+            var generations = fields.TryGetValue("Generation", out var generationField)
+                ? await ReadColumn<long>(groupReader, generationField)
+                : null;
+            var deleted = fields.TryGetValue("Deleted", out var deletedField)
+                ? await ReadColumn<bool>(groupReader, deletedField)
+                : null;
+
+            int[]? versions = null;
+            long[]? timestamps = null;
+            string[]? payloads = null;
+            long?[]? expiresAtTicks = null;
+            if (includeValues)
             {
-                using var reader = await ParquetReader.CreateAsync(stream);
-                var nuts = new List<Nut<T>>();
+                versions = await ReadColumn<int>(groupReader, fields["Version"]);
+                timestamps = await ReadColumn<long>(groupReader, fields["Timestamp"]);
+                payloads = await ReadColumn<string>(groupReader, fields["Payload"]);
+                expiresAtTicks = fields.TryGetValue("ExpiresAt", out var expiresAtField)
+                    ? await ReadColumn<long?>(groupReader, expiresAtField)
+                    : null;
+            }
 
-                for (int i = 0; i < reader.RowGroupCount; i++)
+            var rows = new List<ParquetRow>(ids.Length);
+            for (int j = 0; j < ids.Length; j++)
+            {
+                rows.Add(new ParquetRow
                 {
-                    using var rowGroupReader = reader.OpenRowGroupReader(i);
-
-                    var ids = await ReadColumn<string>(rowGroupReader, "Id");
-                    var versions = await ReadColumn<int>(rowGroupReader, "Version");
-                    var timestamps = await ReadColumn<long>(rowGroupReader, "Timestamp");
-                    var payloads = await ReadColumn<string>(rowGroupReader, "Payload");
-                    var expiresAtTicks = await ReadColumn<long?>(rowGroupReader, "ExpiresAt");
-
-                    for (int j = 0; j < ids.Length; j++)
-                    {
-                        var nut = new Nut<T>
-                        {
-                            Id = ids[j],
-                            Version = versions[j],
-                            Timestamp = new DateTime(timestamps[j]),
-                            Payload = JsonConvert.DeserializeObject<T>(payloads[j])!,
-                            ExpiresAt = expiresAtTicks?[j] != null
-                                ? new DateTime(expiresAtTicks[j]!.Value)
-                                : null
-                        };
-
-                        nuts.Add(nut);
-                    }
-                }
-
-                return nuts;
+                    Id = ids[j],
+                    Generation = generations?[j] ?? 0,
+                    Deleted = deleted?[j] ?? false,
+                    Version = versions?[j] ?? 0,
+                    Timestamp = timestamps?[j] ?? 0,
+                    Payload = payloads?[j] ?? string.Empty,
+                    ExpiresAt = expiresAtTicks?[j]
+                });
             }
+
+            return rows;
         }
 
         /// <summary>
@@ -388,60 +1085,71 @@ namespace AcornDB.Persistence.DataLake
                 new DataField<int>("Version"),
                 new DataField<long>("Timestamp"),
                 new DataField<string>("Payload"),
-                new DataField<long?>("ExpiresAt")
+                new DataField<long?>("ExpiresAt"),
+                new DataField<long>("Generation"),
+                new DataField<bool>("Deleted")
             );
         }
 
         /// <summary>
         /// Write column to Parquet
         /// </summary>
-        private async Task WriteColumn<TCol>(ParquetRowGroupWriter groupWriter, string columnName, TCol[] values)
+        private async Task WriteColumn<TCol>(ParquetRowGroupWriter groupWriter, DataField field, TCol[] values)
         {
-            await groupWriter.WriteColumnAsync(new DataColumn(
-                new DataField<TCol>(columnName),
-                values));
+            await groupWriter.WriteColumnAsync(new DataColumn(field, values));
         }
 
         /// <summary>
         /// Read column from Parquet
         /// </summary>
-        private async Task<TCol[]> ReadColumn<TCol>(ParquetRowGroupReader groupReader, string columnName)
+        private async Task<TCol[]> ReadColumn<TCol>(ParquetRowGroupReader groupReader, DataField field)
         {
-            var dataField = new DataField<TCol>(columnName);
-            var column = await groupReader.ReadColumnAsync(dataField);
+            var column = await groupReader.ReadColumnAsync(field);
             return column.Data.Cast<TCol>().ToArray();
         }
 
         /// <summary>
-        /// List all Parquet files in base path
+        /// Open a file for reading; FileNotFoundException if it has been merged away
+        /// </summary>
+        private async Task<Stream> OpenFileAsync(string filePath)
+        {
+            if (_cloudStorage == null)
+            {
+                return File.OpenRead(filePath);
+            }
+
+            var base64 = await _cloudStorage.DownloadAsync(filePath);
+            if (base64 == null)
+                throw new FileNotFoundException($"Parquet file '{filePath}' no longer exists", filePath);
+
+            return new MemoryStream(Convert.FromBase64String(base64));
+        }
+
+        /// <summary>
+        /// List this trunk's Parquet files under the base path
         /// </summary>
         private async Task<List<string>> ListParquetFilesAsync()
         {
+            var prefix = _typeName + ".";
+
             if (_cloudStorage == null)
             {
                 // Local file system
                 if (!Directory.Exists(_basePath))
                     return new List<string>();
 
-                return Directory.GetFiles(_basePath, "*.parquet", SearchOption.AllDirectories).ToList();
+                return Directory.GetFiles(_basePath, "*.parquet", SearchOption.AllDirectories)
+                    .Where(f => Path.GetFileName(f).StartsWith(prefix, StringComparison.Ordinal))
+                    .ToList();
             }
             else
             {
                 // Cloud storage
                 var keys = await _cloudStorage.ListAsync(_basePath);
-                return keys.Where(k => k.EndsWith(".parquet", StringComparison.OrdinalIgnoreCase)).ToList();
-            }
-        }
-
-        private async Task<bool> FileExistsAsync(string filePath)
-        {
-            if (_cloudStorage == null)
-            {
-                return File.Exists(filePath);
-            }
-            else
-            {
-                return await _cloudStorage.ExistsAsync(filePath);
+                return keys
+                    .Where(k => k.EndsWith(".parquet", StringComparison.OrdinalIgnoreCase)
+                             && k.Substring(k.LastIndexOf('/') + 1).StartsWith(prefix, StringComparison.Ordinal))
+                    .ToList();
             }
         }
 
@@ -469,6 +1177,18 @@ namespace AcornDB.Persistence.DataLake
         {
             if (_disposed) return;
 
+            _bufferFlushTimer?.Dispose();
+
+            try
+            {
+                FlushAsync().GetAwaiter().GetResult();
+                _mergeTask.GetAwaiter().GetResult();
+            }
+            catch (Exception ex)
+            {
+                AcornLog.Error("ParquetTrunk failed to flush buffered writes on dispose", ex);
+            }
+
             // Call base class disposal
             base.Dispose();
         }
@@ -1,5 +1,6 @@
 using System;
 using System.Collections.Generic;
+using System.Globalization;
 using System.Linq;
 using AcornDB;
 
@@ -45,10 +46,19 @@ namespace AcornDB.Persistence.DataLake
         }
     }
 
+    /// <summary>
+    /// Number of path segments a strategy's partition paths have, so a composite strategy
+    /// can split a path back into each strategy's part
+    /// </summary>
+    internal interface IFixedDepthPartitionStrategy
+    {
+        int Depth { get; }
+    }
+
     /// <summary>
     /// Date-based partitioning
     /// </summary>
-    internal class DatePartitionStrategy : IPartitionStrategy
+    internal class DatePartitionStrategy : IPartitionStrategy, IFixedDepthPartitionStrategy
     {
         private readonly string _format;
 
@@ -57,27 +67,90 @@ namespace AcornDB.Persistence.DataLake
             _format = format;
         }
 
+        public int Depth => _format.Replace('-', '/').Split('/').Length;
+
         public string GetPartitionPath<T>(Nut<T> nut)
         {
             return nut.Timestamp.ToString(_format).Replace('-', '/');
         }
+
+        public bool MayContain(string partitionPath, DateTime? from, DateTime? to)
+        {
+            if (!DateTime.TryParseExact(partitionPath, _format.Replace('-', '/'), CultureInfo.InvariantCulture,
+                    DateTimeStyles.None, out var start))
+            {
+                return true;
+            }
+
+            // The partition spans one unit of the finest field in the format
+            DateTime end;
+            if (_format.Contains('m')) end = start.AddMinutes(1);
+            else if (_format.Contains('H') || _format.Contains('h')) end = start.AddHours(1);
+            else if (_format.Contains('d')) end = start.AddDays(1);
+            else if (_format.Contains('M')) end = start.AddMonths(1);
+            else if (_format.Contains('y')) end = start.AddYears(1);
+            else return true;
+
+            return PartitionOverlaps(start, end, from, to);
+        }
+
+        /// <summary>
+        /// Whether [start, end) overlaps [from, to]
+        /// </summary>
+        internal static bool PartitionOverlaps(DateTime start, DateTime end, DateTime? from, DateTime? to)
+        {
+            return (!to.HasValue || start <= to.Value) && (!from.HasValue || end > from.Value);
+        }
     }
 
     /// <summary>
     /// Hive-style date partitioning (year=2025/month=10/day=14)
     /// </summary>
-    internal class HiveDatePartitionStrategy : IPartitionStrategy
+    internal class HiveDatePartitionStrategy : IPartitionStrategy, IFixedDepthPartitionStrategy
     {
+        public int Depth => 3;
+
         public string GetPartitionPath<T>(Nut<T> nut)
         {
             return $"year={nut.Timestamp.Year}/month={nut.Timestamp.Month:D2}/day={nut.Timestamp.Day:D2}";
         }
+
+        public bool MayContain(string partitionPath, DateTime? from, DateTime? to)
+        {
+            var parts = partitionPath.Split('/');
+            if (parts.Length != 3
+                || !TryParseField(parts[0], "year=", out var year)
+                || !TryParseField(parts[1], "month=", out var month)
+                || !TryParseField(parts[2], "day=", out var day))
+            {
+                return true;
+            }
+
+            DateTime start;
+            try
+            {
+                start = new DateTime(year, month, day);
+            }
+            catch (ArgumentOutOfRangeException)
+            {
+                return true;
+            }
+
+            return DatePartitionStrategy.PartitionOverlaps(start, start.AddDays(1), from, to);
+        }
+
+        private static bool TryParseField(string part, string name, out int value)
+        {
+            value = 0;
+            return part.StartsWith(name, StringComparison.Ordinal)
+                && int.TryParse(part.AsSpan(name.Length), NumberStyles.None, CultureInfo.InvariantCulture, out value);
+        }
     }
 
     /// <summary>
     /// Value-based partitioning from payload property
     /// </summary>
-    internal class ValuePartitionStrategy<TPayload> : IPartitionStrategy
+    internal class ValuePartitionStrategy<TPayload> : IPartitionStrategy, IFixedDepthPartitionStrategy
     {
         private readonly Func<TPayload, string> _propertySelector;
 
@@ -86,6 +159,8 @@ namespace AcornDB.Persistence.DataLake
             _propertySelector = propertySelector;
         }
 
+        public int Depth => 1;
+
         public string GetPartitionPath<T>(Nut<T> nut)
         {
             if (nut.Payload is TPayload payload)
@@ -108,7 +183,7 @@ namespace AcornDB.Persistence.DataLake
     /// <summary>
     /// Composite partitioning (combines multiple strategies)
     /// </summary>
-    internal class CompositePartitionStrategy : IPartitionStrategy
+    internal class CompositePartitionStrategy : IPartitionStrategy, IFixedDepthPartitionStrategy
     {
         private readonly IPartitionStrategy[] _strategies;
 
@@ -122,5 +197,42 @@ namespace AcornDB.Persistence.DataLake
             var paths = _strategies.Select(s => s.GetPartitionPath(nut));
             return string.Join("/", paths);
         }
+
+        /// <summary>
+        /// -1 when a part has no fixed depth, in which case paths can't be split apart
+        /// </summary>
+        public int Depth
+        {
+            get
+            {
+                int total = 0;
+                foreach (var strategy in _strategies)
+                {
+                    int depth = strategy is IFixedDepthPartitionStrategy fixedDepth ? fixedDepth.Depth : -1;
+                    if (depth < 0) return -1;
+                    total += depth;
+                }
+                return total;
+            }
+        }
+
+        public bool MayContain(string partitionPath, DateTime? from, DateTime? to)
+        {
+            var segments = partitionPath.Split('/');
+            if (Depth != segments.Length)
+                return true;
+
+            // Every part must allow the range, e.g. the date part of date + region
+            int offset = 0;
+            foreach (var strategy in _strategies)
+            {
+                int depth = ((IFixedDepthPartitionStrategy)strategy).Depth;
+                if (!strategy.MayContain(string.Join("/", segments, offset, depth), from, to))
+                    return false;
+                offset += depth;
+            }
+
+            return true;
+        }
     }
 }
@@ -23,8 +23,10 @@ namespace AcornDB.Persistence.DataLake
     /// - Cost-effective long-term storage (cold tier)
     /// - Automatic data aging/archival
     /// - Query federation across tiers
+    /// - Time-range and key-range scans pushed down to a cold tier that supports them
+    ///   (e.g. ParquetTrunk), so queries on recent data don't read the archive
     /// </summary>
-    public class TieredTrunk<T> : TrunkBase<T> where T : class
+    public class TieredTrunk<T> : TrunkBase<T>, IScanTrunk<T> where T : class
     {
         private readonly ITrunk<T> _hotTrunk;
         private readonly ITrunk<T> _coldTrunk;
@@ -123,6 +125,26 @@ namespace AcornDB.Persistence.DataLake
             return hotNuts.Values;
         }
 
+        /// <summary>
+        /// Nuts that may match the filter. The hot tier is filtered in memory and still takes
+        /// precedence; the cold tier prunes its own files when it can.
+        /// </summary>
+        public IEnumerable<Nut<T>> CrackWhere(TrunkScanFilter<T> filter)
+        {
+            var hotNuts = _hotTrunk.CrackAll().ToDictionary(n => n.Id);
+            var results = hotNuts.Values
+                .Where(n => filter.MatchesTimestamp(n.Timestamp) && filter.MatchesKey(n.Id))
+                .ToList();
+
+            var coldNuts = _coldTrunk is IScanTrunk<T> coldScan
+                ? coldScan.CrackWhere(filter)
+                : _coldTrunk.CrackAll();
+
+            // An id in the hot tier hides its cold copy even when only the cold copy matches
+            results.AddRange(coldNuts.Where(n => !hotNuts.ContainsKey(n.Id)));
+            return results;
+        }
+
         public override IReadOnlyList<Nut<T>> GetHistory(string id)
         {
             // Try hot tier first (likely has most recent history)
@@ -163,6 +185,7 @@ namespace AcornDB.Persistence.DataLake
             SupportsSync = true,
             IsDurable = true,
             SupportsAsync = false,
+            SupportsScanPushdown = true,
             TrunkType = "TieredTrunk"
         };
 
@@ -190,7 +213,7 @@ namespace AcornDB.Persistence.DataLake
 
             AcornLog.Info($"Tiering {oldNuts.Count} nuts from hot to cold storage...");
 
-            // Move to cold tier
+            // Move to cold tier (a ParquetTrunk writes the batch as one delta file per partition)
             _coldTrunk.ImportChanges(oldNuts);
 
             // Remove from hot tier
@@ -1,6 +1,7 @@
 using System;
 using AcornDB.Logging;
 using System.Collections.Generic;
+using System.Data.Common;
 using System.Linq;
 using System.Runtime.CompilerServices;
 using System.Text;
@@ -26,14 +27,18 @@ namespace AcornDB.Persistence.RDBMS
     ///
     /// Supports compression, encryption, and policy enforcement via IRoot processors.
     /// Backward compatible: Reads plain JSON data from before IRoot adoption.
+    ///
+    /// TreeQuery conditions, ordering, paging and counts compile to JSON_EXTRACT() SQL over the
+    /// stored nut (see INativeQueryTrunk&lt;T&gt;).
     /// </summary>
-    public class MySqlTrunk<T> : TrunkBase<T> where T : class
+    public class MySqlTrunk<T> : NativeQueryTrunkBase<T> where T : class
     {
         private readonly string _connectionString;
         private readonly string _tableName;
         private readonly string? _database;
         private readonly int _batchSize;
         private readonly SemaphoreSlim _connectionLock = new(1, 1);
+        private static readonly SqlDialect QueryDialect = new MySqlDialect();
 
         /// <summary>
         /// Create MySQL trunk
@@ -237,6 +242,8 @@ namespace AcornDB.Persistence.RDBMS
             SupportsSync = true,
             IsDurable = true,
             SupportsAsync = true,
+            SupportsScanPushdown = true,
+            SupportsNativeQueries = true,
             TrunkType = "MySqlTrunk"
         };
 
@@ -304,10 +311,9 @@ namespace AcornDB.Persistence.RDBMS
 
         private async Task WriteToMySQL(MySqlConnection conn, MySqlTransaction? transaction, string id, byte[] processedBytes, DateTime timestamp, int version)
         {
-            var dataToStore = EncodeForStorage(processedBytes, "");
-
             // Get expires_at from the nut if needed
             var json = Encoding.UTF8.GetString(processedBytes);
+            var dataToStore = EncodeForStorage(processedBytes, json);
             var nut = _serializer.Deserialize<Nut<T>>(json);
             var expiresAt = nut?.ExpiresAt;
 
@@ -364,6 +370,28 @@ namespace AcornDB.Persistence.RDBMS
             return nuts;
         }
 
+        // Native Query Support
+
+        private protected override SqlDialect Dialect => QueryDialect;
+
+        private protected override string QueryTable => $"`{_tableName}`";
+
+        private protected override string QueryColumns => "json_data";
+
+        private protected override DbConnection OpenQueryConnection()
+        {
+            var conn = new MySqlConnection(_connectionString);
+            conn.Open();
+
+            if (!string.IsNullOrEmpty(_database))
+            {
+                using var useDbCmd = new MySqlCommand($"USE `{_database}`", conn);
+                useDbCmd.ExecuteNonQuery();
+            }
+
+            return conn;
+        }
+
         // ITrunkCapabilities implementation
         public bool SupportsHistory => false;
         public bool SupportsSync => true;
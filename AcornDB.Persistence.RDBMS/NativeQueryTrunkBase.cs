@@ -0,0 +1,127 @@
+using System;
+using System.Collections.Generic;
+using System.Data.Common;
+using System.Linq;
+using System.Text;
+using AcornDB.Storage;
+using AcornDB.Storage.Serialization;
+
+namespace AcornDB.Persistence.RDBMS
+{
+    /// <summary>
+    /// INativeQueryTrunk&lt;T&gt; for trunks that keep one nut per row of a SQL table. Filters
+    /// compile through SqlQueryTranslator with the trunk's dialect and run on its connection;
+    /// whatever the dialect cannot express is finished with TrunkScanFilter&lt;T&gt;.Apply.
+    /// A trunk supplies the dialect, how to open a connection, the table and columns to read,
+    /// and, if its rows differ from the default, how a row becomes a nut.
+    /// </summary>
+    public abstract class NativeQueryTrunkBase<T> : TrunkBase<T>, INativeQueryTrunk<T> where T : class
+    {
+        private protected NativeQueryTrunkBase(
+            ISerializer? serializer = null,
+            bool enableBatching = false,
+            int batchThreshold = 100,
+            int flushIntervalMs = 200)
+            : base(serializer, enableBatching, batchThreshold, flushIntervalMs)
+        {
+        }
+
+        private protected abstract SqlDialect Dialect { get; }
+
+        /// <summary>
+        /// The table as written after FROM, quoted and schema-qualified as the database needs
+        /// </summary>
+        private protected abstract string QueryTable { get; }
+
+        /// <summary>
+        /// Select list of the columns ReadQueryRow reads
+        /// </summary>
+        private protected abstract string QueryColumns { get; }
+
+        /// <summary>
+        /// Open a connection to the database holding QueryTable
+        /// </summary>
+        private protected abstract DbConnection OpenQueryConnection();
+
+        /// <summary>
+        /// json_data holds the nut as JSON only for text serializers without roots
+        /// </summary>
+        private protected virtual bool PayloadQueryable => _roots.Count == 0 && !_serializer.IsBinary;
+
+        /// <summary>
+        /// Nut stored in the current row; by default the first column holds the stored data
+        /// </summary>
+        private protected virtual Nut<T>? ReadQueryRow(DbDataReader reader)
+        {
+            var storedBytes = DecodeStoredData(reader.GetString(0));
+            var processedBytes = ProcessThroughRootsDescending(storedBytes, null);
+
+            return _serializer.Deserialize<Nut<T>>(Encoding.UTF8.GetString(processedBytes));
+        }
+
+        public bool CanQuery(TrunkScanFilter<T> filter)
+        {
+            return SqlQueryTranslator.Translate(Dialect, filter, PayloadQueryable, ordered: true).IsExact;
+        }
+
+        public IEnumerable<Nut<T>> CrackWhere(TrunkScanFilter<T> filter)
+        {
+            return ReadNuts(SqlQueryTranslator.Translate(Dialect, filter, PayloadQueryable, ordered: false));
+        }
+
+        public IEnumerable<Nut<T>> Query(TrunkScanFilter<T> filter)
+        {
+            var query = SqlQueryTranslator.Translate(Dialect, filter, PayloadQueryable, ordered: true);
+            var nuts = ReadNuts(query);
+            return query.IsExact ? nuts : filter.Apply(nuts).ToList();
+        }
+
+        public int CountQuery(TrunkScanFilter<T> filter)
+        {
+            var query = SqlQueryTranslator.Translate(Dialect, filter, PayloadQueryable, ordered: false);
+            if (!query.IsExact)
+                return filter.Apply(ReadNuts(query)).Count();
+
+            FlushBatchAsync().GetAwaiter().GetResult();
+            using var conn = OpenQueryConnection();
+            using var cmd = CreateQueryCommand(conn, $"SELECT COUNT(*) FROM {QueryTable}{query.Where}", query);
+
+            return SqlQueryTranslator.PageCount(Convert.ToInt64(cmd.ExecuteScalar()), filter);
+        }
+
+        private List<Nut<T>> ReadNuts(SqlQuery query)
+        {
+            // Queries must see stashes still waiting in the write batch
+            FlushBatchAsync().GetAwaiter().GetResult();
+            using var conn = OpenQueryConnection();
+            using var cmd = CreateQueryCommand(
+                conn, $"SELECT {QueryColumns} FROM {QueryTable}{query.Where}{query.OrderBy}{query.Page}", query);
+
+            using var reader = cmd.ExecuteReader();
+            var nuts = new List<Nut<T>>();
+            while (reader.Read())
+            {
+                var nut = ReadQueryRow(reader);
+                if (nut != null)
+                    nuts.Add(nut);
+            }
+
+            return nuts;
+        }
+
+        private static DbCommand CreateQueryCommand(DbConnection conn, string sql, SqlQuery query)
+        {
+            var cmd = conn.CreateCommand();
+            cmd.CommandText = sql;
+            foreach (var parameter in query.Parameters)
+            {
+                var dbParameter = cmd.CreateParameter();
+                dbParameter.ParameterName = parameter.Key;
+                dbParameter.Value = parameter.Value;
+                cmd.Parameters.Add(dbParameter);
+            }
+
+            return cmd;
+        }
+    }
+}
@@ -1,6 +1,7 @@
 using System;
 using AcornDB.Logging;
 using System.Collections.Generic;
+using System.Data.Common;
 using System.Linq;
 using System.Runtime.CompilerServices;
 using System.Text;
@@ -26,13 +27,17 @@ namespace AcornDB.Persistence.RDBMS
     ///
     /// Supports compression, encryption, and policy enforcement via IRoot processors.
     /// Backward compatible: Reads plain JSON data from before IRoot adoption.
+    ///
+    /// TreeQuery conditions, ordering, paging and counts compile to jsonb SQL over the
+    /// stored nut (see INativeQueryTrunk&lt;T&gt;).
     /// </summary>
-    public class PostgreSqlTrunk<T> : TrunkBase<T> where T : class
+    public class PostgreSqlTrunk<T> : NativeQueryTrunkBase<T> where T : class
     {
         private readonly string _connectionString;
         private readonly string _tableName;
         private readonly string _schema;
         private readonly SemaphoreSlim _connectionLock = new(1, 1);
+        private static readonly SqlDialect QueryDialect = new PostgreSqlDialect();
 
         private const int BATCH_SIZE = 100;
         private const int FLUSH_INTERVAL_MS = 200;
@@ -231,6 +236,8 @@ namespace AcornDB.Persistence.RDBMS
             SupportsSync = true,
             IsDurable = true,
             SupportsAsync = true,
+            SupportsScanPushdown = true,
+            SupportsNativeQueries = true,
             TrunkType = "PostgreSqlTrunk"
         };
 
@@ -286,10 +293,9 @@ namespace AcornDB.Persistence.RDBMS
 
         private async Task WriteToPostgreSQL(NpgsqlConnection conn, NpgsqlTransaction? transaction, string id, byte[] processedBytes, DateTime timestamp, int version)
         {
-            var dataToStore = EncodeForStorage(processedBytes, "");
-
             // Get expires_at from the nut if needed
             var json = Encoding.UTF8.GetString(processedBytes);
+            var dataToStore = EncodeForStorage(processedBytes, json);
             var nut = _serializer.Deserialize<Nut<T>>(json);
             var expiresAt = nut?.ExpiresAt;
 
@@ -340,6 +346,21 @@ namespace AcornDB.Persistence.RDBMS
             return nuts;
         }
 
+        // Native Query Support
+
+        private protected override SqlDialect Dialect => QueryDialect;
+
+        private protected override string QueryTable => $"{_schema}.{_tableName}";
+
+        private protected override string QueryColumns => "json_data::text";
+
+        private protected override DbConnection OpenQueryConnection()
+        {
+            var conn = new NpgsqlConnection(_connectionString);
+            conn.Open();
+            return conn;
+        }
+
         // ITrunkCapabilities implementation
         public bool SupportsHistory => false;
         public bool SupportsSync => true;
@@ -0,0 +1,570 @@
+using System;
+using System.Collections.Generic;
+using System.Globalization;
+using System.Linq;
+using System.Linq.Expressions;
+using System.Reflection;
+using AcornDB.Query;
+using AcornDB.Storage;
+
+namespace AcornDB.Persistence.RDBMS
+{
+    /// <summary>
+    /// How a payload property is compared once read out of the stored JSON
+    /// </summary>
+    internal enum SqlValueKind
+    {
+        Text,
+        Integer,
+        Real,
+        Boolean
+    }
+
+    /// <summary>
+    /// A TrunkScanFilter&lt;T&gt; compiled to SQL clauses and their parameters. When IsExact is
+    /// false the clauses select a superset of the matches and carry no ORDER BY or paging, so
+    /// the caller finishes the query with TrunkScanFilter&lt;T&gt;.Apply.
+    /// </summary>
+    internal sealed class SqlQuery
+    {
+        public SqlQuery(string where, string orderBy, string page, List<KeyValuePair<string, object>> parameters, bool isExact)
+        {
+            Where = where;
+            OrderBy = orderBy;
+            Page = page;
+            Parameters = parameters;
+            IsExact = isExact;
+        }
+
+        /// <summary>
+        /// " WHERE ..." or empty
+        /// </summary>
+        public string Where { get; }
+
+        /// <summary>
+        /// " ORDER BY ..." or empty
+        /// </summary>
+        public string OrderBy { get; }
+
+        /// <summary>
+        /// LIMIT/OFFSET (or OFFSET/FETCH) clause, or empty
+        /// </summary>
+        public string Page { get; }
+
+        public List<KeyValuePair<string, object>> Parameters { get; }
+
+        public bool IsExact { get; }
+    }
+
+    /// <summary>
+    /// How one database spells the pieces of a pushed-down query: reading a payload property
+    /// out of the stored JSON, comparing ids and timestamps the way TreeQuery does, and paging.
+    /// A method returns null (or false) where the database cannot match LINQ exactly; that
+    /// condition is then left to TrunkScanFilter&lt;T&gt;.Apply.
+    /// </summary>
+    internal abstract class SqlDialect
+    {
+        /// <summary>
+        /// Payload property read as a value of the given kind (name is a plain identifier)
+        /// </summary>
+        public abstract string Property(string name, SqlValueKind kind);
+
+        public virtual string? Compare(string property, SqlValueKind kind, string op, string parameter, object value)
+        {
+            return $"{property} {op} {parameter}";
+        }
+
+        public virtual string IsNull(string property) => $"{property} IS NULL";
+
+        /// <summary>
+        /// Whether IS NULL matches only properties that are null or missing
+        /// </summary>
+        public virtual bool IsNullExact(SqlValueKind kind) => true;
+
+        public virtual object Value(SqlValueKind kind, object value)
+        {
+            return kind == SqlValueKind.Boolean ? ((bool)value ? 1 : 0) : value;
+        }
+
+        /// <summary>
+        /// Id column compared and ordered by UTF-8 bytes, as Utf8KeyComparer orders ids
+        /// </summary>
+        public abstract string Id { get; }
+
+        public abstract string IdStartsWith(string parameter);
+
+        public virtual bool CanCompareId(string bound) => true;
+
+        public abstract string Timestamp { get; }
+
+        /// <summary>
+        /// Most a stored timestamp can differ from Nut.Timestamp (zero when it round trips)
+        /// </summary>
+        public virtual TimeSpan TimestampError => TimeSpan.Zero;
+
+        /// <summary>
+        /// Whether stored timestamps are truncated (never later than Nut.Timestamp) rather than rounded
+        /// </summary>
+        public virtual bool TruncatesTimestamps => true;
+
+        public virtual (string Op, object Value) TimestampBound(DateTime bound, bool lower, bool inclusive)
+        {
+            return (lower ? (inclusive ? ">=" : ">") : (inclusive ? "<=" : "<"), bound);
+        }
+
+        /// <summary>
+        /// Whether ORDER BY on the property sorts like Comparer&lt;object&gt;.Default. Text is
+        /// sorted by culture in .NET and by collation here, so it never is.
+        /// </summary>
+        public virtual bool CanOrderBy(SqlValueKind kind) => kind != SqlValueKind.Text;
+
+        /// <summary>
+        /// ORDER BY term with nulls first ascending and last descending, as LINQ sorts them
+        /// </summary>
+        public virtual string OrderTerm(string expression, bool descending)
+        {
+            return descending ? $"{expression} DESC" : $"{expression} ASC";
+        }
+
+        public abstract string Page(string? skip, string? take);
+    }
+
+    /// <summary>
+    /// SQLite: payload_json via json_extract(), matching the expressions SqliteNativeIndex
+    /// creates so those indexes serve the query. Ids compare as BINARY (UTF-8 bytes) and
+    /// timestamps are ISO 8601 text.
+    /// </summary>
+    internal sealed class SqliteDialect : SqlDialect
+    {
+        public override string Property(string name, SqlValueKind kind) => $"json_extract(payload_json, '$.{name}')";
+
+        public override string Id => "id";
+
+        public override string IdStartsWith(string parameter) => $"(id >= {parameter} AND substr(id, 1, length({parameter})) = {parameter})";
+
+        public override string Timestamp => "timestamp";
+
+        public override (string Op, object Value) TimestampBound(DateTime bound, bool lower, bool inclusive)
+        {
+            // Stored values are ToString("O"): a fixed-width date and time followed by a
+            // zone suffix ("Z", "+01:00" or nothing), all below '~'. Comparing against the
+            // fixed-width part alone, or that part plus '~', orders by ticks like DateTime does.
+            var ticks = bound.ToString("yyyy-MM-dd'T'HH:mm:ss.fffffff", CultureInfo.InvariantCulture);
+            return lower
+                ? (inclusive ? (">=", ticks) : (">", ticks + "~"))
+                : (inclusive ? ("<", ticks + "~") : ("<", ticks));
+        }
+
+        public override string Page(string? skip, string? take) => $" LIMIT {take ?? "-1"} OFFSET {skip ?? "0"}";
+    }
+
+    /// <summary>
+    /// PostgreSQL: json_data is the whole nut as jsonb, so the payload is json_data-&gt;'Payload'.
+    /// TIMESTAMPTZ keeps microseconds.
+    /// </summary>
+    internal sealed class PostgreSqlDialect : SqlDialect
+    {
+        public override string Property(string name, SqlValueKind kind)
+        {
+            var text = $"(json_data->'Payload'->>'{name}')";
+            return kind switch
+            {
+                SqlValueKind.Integer => text + "::bigint",
+                SqlValueKind.Real => text + "::double precision",
+                SqlValueKind.Boolean => text + "::boolean",
+                _ => text
+            };
+        }
+
+        public override object Value(SqlValueKind kind, object value) => value;
+
+        public override string Id => "id COLLATE \"C\"";
+
+        public override string IdStartsWith(string parameter) => $"starts_with(id, {parameter})";
+
+        public override string Timestamp => "timestamp";
+
+        public override TimeSpan TimestampError => TimeSpan.FromTicks(10);
+
+        public override (string Op, object Value) TimestampBound(DateTime bound, bool lower, bool inclusive)
+        {
+            // Nut timestamps are stored as UTC; DateTime compares ticks whatever the Kind
+            var (op, _) = base.TimestampBound(bound, lower, inclusive);
+            return (op, DateTime.SpecifyKind(bound, DateTimeKind.Utc));
+        }
+
+        public override string OrderTerm(string expression, bool descending)
+        {
+            return descending ? $"{expression} DESC NULLS LAST" : $"{expression} ASC NULLS FIRST";
+        }
+
+        public override string Page(string? skip, string? take)
+        {
+            return (take != null ? $" LIMIT {take}" : "") + (skip != null ? $" OFFSET {skip}" : "");
+        }
+    }
+
+    /// <summary>
+    /// SQL Server: JSON_VALUE over JsonData with binary collation. Text compares with padding
+    /// and JSON_VALUE gives up on strings over 4000 characters, so both are guarded. Timestamps
+    /// pass through DATETIME parameters, which round to about 3ms.
+    /// </summary>
+    internal sealed class SqlServerDialect : SqlDialect
+    {
+        private const int MaxJsonValueLength = 4000;
+
+        public override string Property(string name, SqlValueKind kind)
+        {
+            var value = $"JSON_VALUE(JsonData, '$.Payload.{name}')";
+            return kind switch
+            {
+                SqlValueKind.Integer => $"TRY_CAST({value} AS BIGINT)",
+                SqlValueKind.Real => $"TRY_CAST({value} AS FLOAT)",
+                _ => value
+            };
+        }
+
+        public override string? Compare(string property, SqlValueKind kind, string op, string parameter, object value)
+        {
+            if (kind != SqlValueKind.Text)
+                return base.Compare(property, kind, op, parameter, value);
+            if (op != "=" || ((string)value).Length > MaxJsonValueLength)
+                return null;
+            return $"({property} COLLATE Latin1_General_BIN2 = {parameter} AND DATALENGTH({property}) = DATALENGTH({parameter}))";
+        }
+
+        public override bool IsNullExact(SqlValueKind kind) => kind != SqlValueKind.Text;
+
+        public override object Value(SqlValueKind kind, object value)
+        {
+            return kind == SqlValueKind.Boolean ? ((bool)value ? "true" : "false") : value;
+        }
+
+        // BIN2 orders UTF-16 code units, which matches UTF-8 byte order outside the
+        // supplementary planes
+        public override string Id => "Id COLLATE Latin1_General_BIN2";
+
+        public override string IdStartsWith(string parameter) => $"LEFT(Id, DATALENGTH({parameter}) / 2) COLLATE Latin1_General_BIN2 = {parameter}";
+
+        public override bool CanCompareId(string bound) => !bound.EndsWith(' ');
+
+        public override string Timestamp => "Timestamp";
+
+        public override TimeSpan TimestampError => TimeSpan.FromMilliseconds(4);
+
+        public override bool TruncatesTimestamps => false;
+
+        public override string Page(string? skip, string? take)
+        {
+            return $" OFFSET {skip ?? "0"} ROWS" + (take != null ? $" FETCH NEXT {take} ROWS ONLY" : "");
+        }
+    }
+
+    /// <summary>
+    /// MySQL 8: JSON_EXTRACT over json_data, compared as JSON values (strings byte by byte).
+    /// JSON null sorts below every number, so range conditions exclude it explicitly.
+    /// DATETIME(6) keeps microseconds.
+    /// </summary>
+    internal sealed class MySqlDialect : SqlDialect
+    {
+        public override string Property(string name, SqlValueKind kind) => $"JSON_EXTRACT(json_data, '$.Payload.{name}')";
+
+        public override string? Compare(string property, SqlValueKind kind, string op, string parameter, object value)
+        {
+            if (kind == SqlValueKind.Boolean)
+                return $"{property} = CAST({parameter} AS JSON)";
+            if (op == "=")
+                return $"{property} = {parameter}";
+            return $"({property} {op} {parameter} AND JSON_TYPE({property}) <> 'NULL')";
+        }
+
+        public override string IsNull(string property) => $"({property} IS NULL OR JSON_TYPE({property}) = 'NULL')";
+
+        public override object Value(SqlValueKind kind, object value)
+        {
+            return kind == SqlValueKind.Boolean ? ((bool)value ? "true" : "false") : value;
+        }
+
+        public override string Id => "id COLLATE utf8mb4_bin";
+
+        public override string IdStartsWith(string parameter) => $"LEFT(id, CHAR_LENGTH({parameter})) COLLATE utf8mb4_bin = {parameter}";
+
+        // utf8mb4_bin pads with spaces, so only bounds without trailing spaces compare exactly
+        public override bool CanCompareId(string bound) => !bound.EndsWith(' ');
+
+        public override string Timestamp => "timestamp";
+
+        public override TimeSpan TimestampError => TimeSpan.FromTicks(10);
+
+        public override string Page(string? skip, string? take)
+        {
+            return $" LIMIT {skip ?? "0"}, {take ?? ulong.MaxValue.ToString(CultureInfo.InvariantCulture)}";
+        }
+    }
+
+    /// <summary>
+    /// Compiles TrunkScanFilter&lt;T&gt; into parameterized SQL for a dialect. Comparisons of
+    /// string, bool, integer and double properties with constants translate, under any mix of
+    /// AND and OR; anything else (method calls, !=, enums, dates) is left out of an AND and
+    /// makes an OR untranslatable, and the result is then marked inexact.
+    /// Property names are expected as written by the serializer's defaults (no renaming).
+    /// </summary>
+    internal static class SqlQueryTranslator
+    {
+        public static SqlQuery Translate<T>(SqlDialect dialect, TrunkScanFilter<T> filter, bool payloadQueryable, bool ordered)
+            where T : class
+        {
+            var parameters = new List<KeyValuePair<string, object>>();
+            var conditions = new List<string>();
+            var exact = true;
+
+            string Parameter(object value)
+            {
+                var name = $"@p{parameters.Count}";
+                parameters.Add(new KeyValuePair<string, object>(name, value));
+                return name;
+            }
+
+            if (filter.TimestampFrom.HasValue)
+                exact &= AddTimestampBound(dialect, conditions, Parameter, filter.TimestampFrom.Value, lower: true, filter.TimestampFromInclusive);
+            if (filter.TimestampTo.HasValue)
+                exact &= AddTimestampBound(dialect, conditions, Parameter, filter.TimestampTo.Value, lower: false, filter.TimestampToInclusive);
+
+            foreach (var (bound, kind) in new[] { (filter.KeyFrom, ">="), (filter.KeyTo, "<"), (filter.KeyPrefix, "prefix") })
+            {
+                if (bound == null)
+                    continue;
+                if (!dialect.CanCompareId(bound))
+                {
+                    exact = false;
+                    continue;
+                }
+
+                var parameter = Parameter(bound);
+                conditions.Add(kind == "prefix" ? dialect.IdStartsWith(parameter) : $"{dialect.Id} {kind} {parameter}");
+            }
+
+            if (filter.Where != null)
+            {
+                var predicate = payloadQueryable
+                    ? TranslatePredicate<T>(dialect, new ExpressionAnalyzer<T>().AnalyzePredicate(filter.Where), Parameter)
+                    : (null, false);
+                if (predicate.Sql != null)
+                    conditions.Add(predicate.Sql);
+                exact &= predicate.Exact;
+            }
+
+            var where = conditions.Count > 0 ? " WHERE " + string.Join(" AND ", conditions) : "";
+            if (!ordered || !exact)
+                return new SqlQuery(where, "", "", parameters, exact);
+
+            // ORDER BY and paging are only sent when the rows are exactly the matches
+            string? orderBy = null;
+            if (filter.OrderBy != null)
+            {
+                var property = OrderProperty<T>(filter.OrderBy);
+                if (property != null && dialect.CanOrderBy(property.Value.Kind))
+                    orderBy = dialect.OrderTerm(dialect.Property(property.Value.Name, property.Value.Kind), filter.OrderDescending);
+                else
+                    exact = false;
+            }
+            else if (filter.OrderByTimestamp)
+            {
+                if (dialect.TimestampError == TimeSpan.Zero)
+                    orderBy = dialect.OrderTerm(dialect.Timestamp, filter.OrderDescending);
+                else
+                    exact = false;
+            }
+
+            if (!exact)
+                return new SqlQuery(where, "", "", parameters, false);
+
+            var paged = filter.Skip.HasValue || filter.Take.HasValue;
+            var terms = new List<string>();
+            if (orderBy != null)
+                terms.Add(orderBy);
+            // Key ranges come back in key order; ties and pages are made stable by id
+            if (orderBy != null || filter.HasKeyRange || paged)
+                terms.Add($"{dialect.Id} ASC");
+
+            var order = terms.Count > 0 ? " ORDER BY " + string.Join(", ", terms) : "";
+            var page = paged
+                ? dialect.Page(filter.Skip.HasValue ? Parameter(filter.Skip.Value) : null,
+                               filter.Take.HasValue ? Parameter(filter.Take.Value) : null)
+                : "";
+            return new SqlQuery(where, order, page, parameters, true);
+        }
+
+        /// <summary>
+        /// Apply Skip/Take to a count of all matches
+        /// </summary>
+        public static int PageCount<T>(long matches, TrunkScanFilter<T> filter)
+        {
+            if (filter.Skip.HasValue)
+                matches = Math.Max(0, matches - filter.Skip.Value);
+            if (filter.Take.HasValue)
+                matches = Math.Min(matches, filter.Take.Value);
+            return (int)matches;
+        }
+
+        private static bool AddTimestampBound(SqlDialect dialect, List<string> conditions, Func<object, string> parameter,
+            DateTime bound, bool lower, bool inclusive)
+        {
+            var error = dialect.TimestampError;
+            if (error == TimeSpan.Zero)
+            {
+                var (op, value) = dialect.TimestampBound(bound, lower, inclusive);
+                conditions.Add($"{dialect.Timestamp} {op} {parameter(value)}");
+                return true;
+            }
+
+            // A truncated timestamp t' of t satisfies t >= B exactly when t' >= B, and
+            // t < B exactly when t' < B, as long as B itself survives truncation
+            var aligned = dialect.TruncatesTimestamps && bound.Ticks % error.Ticks == 0;
+            if (aligned && lower == inclusive)
+            {
+                var (op, value) = dialect.TimestampBound(bound, lower, inclusive);
+                conditions.Add($"{dialect.Timestamp} {op} {parameter(value)}");
+                return true;
+            }
+
+            // Otherwise widen the bound and leave the rest to Apply: by twice the storage error,
+            // as the widened parameter is itself stored at that precision
+            var slack = error + error;
+            var widened = lower
+                ? (bound.Ticks > slack.Ticks ? bound - slack : DateTime.MinValue)
+                : (DateTime.MaxValue - bound > slack ? bound + slack : DateTime.MaxValue);
+            var (wideOp, wideValue) = dialect.TimestampBound(widened, lower, inclusive: true);
+            conditions.Add($"{dialect.Timestamp} {wideOp} {parameter(wideValue)}");
+            return false;
+        }
+
+        private static (string? Sql, bool Exact) TranslatePredicate<T>(SqlDialect dialect, PredicateNode node, Func<object, string> parameter)
+        {
+            switch (node.Kind)
+            {
+                case PredicateKind.Condition:
+                    return TranslateCondition<T>(dialect, node.Condition!, parameter);
+
+                case PredicateKind.And:
+                {
+                    var parts = new List<string>();
+                    var exact = true;
+                    foreach (var child in node.Children)
+                    {
+                        var (sql, childExact) = TranslatePredicate<T>(dialect, child, parameter);
+                        if (sql != null)
+                            parts.Add(sql);
+                        exact &= childExact && sql != null;
+                    }
+                    return parts.Count > 0 ? ("(" + string.Join(" AND ", parts) + ")", exact) : (null, false);
+                }
+
+                case PredicateKind.Or:
+                {
+                    var parts = new List<string>();
+                    var exact = true;
+                    foreach (var child in node.Children)
+                    {
+                        var (sql, childExact) = TranslatePredicate<T>(dialect, child, parameter);
+                        if (sql == null)
+                            return (null, false);
+                        parts.Add(sql);
+                        exact &= childExact;
+                    }
+                    return ("(" + string.Join(" OR ", parts) + ")", exact);
+                }
+
+                default:
+                    return (null, false);
+            }
+        }
+
+        private static (string? Sql, bool Exact) TranslateCondition<T>(SqlDialect dialect, IndexableCondition condition, Func<object, string> parameter)
+        {
+            var kind = KindOf(condition.PropertyType);
+            if (kind == null || !IsSerializedAsIs(typeof(T), condition.PropertyName))
+                return (null, false);
+
+            var property = dialect.Property(condition.PropertyName, kind.Value);
+            if (condition.Value == null)
+                return (dialect.IsNull(property), dialect.IsNullExact(kind.Value));
+
+            object value = kind.Value switch
+            {
+                SqlValueKind.Integer => Convert.ToInt64(condition.Value, CultureInfo.InvariantCulture),
+                SqlValueKind.Real => Convert.ToDouble(condition.Value, CultureInfo.InvariantCulture),
+                _ => condition.Value
+            };
+
+            var op = condition.Operator switch
+            {
+                ComparisonOperator.Equal => "=",
+                ComparisonOperator.GreaterThan => ">",
+                ComparisonOperator.GreaterThanOrEqual => ">=",
+                ComparisonOperator.LessThan => "<",
+                ComparisonOperator.LessThanOrEqual => "<=",
+                _ => null
+            };
+            if (op == null)
+                return (null, false);
+
+            var sql = dialect.Compare(property, kind.Value, op, parameter(dialect.Value(kind.Value, value)), value);
+            return (sql, sql != null);
+        }
+
+        private static (string Name, SqlValueKind Kind)? OrderProperty<T>(LambdaExpression orderBy)
+        {
+            var body = orderBy.Body is UnaryExpression { NodeType: ExpressionType.Convert } convert ? convert.Operand : orderBy.Body;
+            if (body is not MemberExpression { Expression: ParameterExpression } member)
+                return null;
+
+            var kind = KindOf(member.Type);
+            return kind != null && IsSerializedAsIs(typeof(T), member.Member.Name)
+                ? (member.Member.Name, kind.Value)
+                : null;
+        }
+
+        private static SqlValueKind? KindOf(Type type)
+        {
+            type = Nullable.GetUnderlyingType(type) ?? type;
+            if (type.IsEnum)
+                return null;
+
+            switch (Type.GetTypeCode(type))
+            {
+                case TypeCode.String:
+                    return SqlValueKind.Text;
+                case TypeCode.Boolean:
+                    return SqlValueKind.Boolean;
+                case TypeCode.Byte:
+                case TypeCode.SByte:
+                case TypeCode.Int16:
+                case TypeCode.UInt16:
+                case TypeCode.Int32:
+                case TypeCode.UInt32:
+                case TypeCode.Int64:
+                    return SqlValueKind.Integer;
+                case TypeCode.Double:
+                    return SqlValueKind.Real;
+                default:
+                    // float and decimal lose precision as JSON doubles; ulong overflows BIGINT
+                    return null;
+            }
+        }
+
+        /// <summary>
+        /// Whether the member is written to JSON under its own name (no [JsonProperty] rename
+        /// or [JsonIgnore]) and that name can be spliced into a JSON path
+        /// </summary>
+        private static bool IsSerializedAsIs(Type type, string name)
+        {
+            if (name.Length == 0 || !name.All(c => c < 128 && (char.IsLetterOrDigit(c) || c == '_')))
+                return false;
+
+            var member = (MemberInfo?)type.GetProperty(name) ?? type.GetField(name);
+            return member != null && !member.GetCustomAttributes(true).Any(attribute =>
+                attribute.GetType().Name is "JsonPropertyAttribute" or "JsonPropertyNameAttribute" or "JsonIgnoreAttribute");
+        }
+    }
+}
@@ -1,6 +1,7 @@
 using System;
 using AcornDB.Logging;
 using System.Collections.Generic;
+using System.Data.Common;
 using System.Data;
 using System.Linq;
 using System.Runtime.CompilerServices;
@@ -27,13 +28,17 @@ namespace AcornDB.Persistence.RDBMS
     ///
     /// Supports compression, encryption, and policy enforcement via IRoot processors.
     /// Backward compatible: Reads plain JSON data from before IRoot adoption.
+    ///
+    /// TreeQuery conditions, ordering, paging and counts compile to JSON_VALUE() SQL over the
+    /// stored nut (see INativeQueryTrunk&lt;T&gt;).
     /// </summary>
-    public class SqlServerTrunk<T> : TrunkBase<T> where T : class
+    public class SqlServerTrunk<T> : NativeQueryTrunkBase<T> where T : class
     {
         private readonly string _connectionString;
         private readonly string _tableName;
         private readonly string _schema;
         private readonly SemaphoreSlim _connectionLock = new(1, 1);
+        private static readonly SqlDialect QueryDialect = new SqlServerDialect();
 
         private const int BATCH_SIZE = 100;
         private const int FLUSH_INTERVAL_MS = 200;
@@ -221,6 +226,8 @@ namespace AcornDB.Persistence.RDBMS
             SupportsSync = true,
             IsDurable = true,
             SupportsAsync = true,
+            SupportsScanPushdown = true,
+            SupportsNativeQueries = true,
             TrunkType = "SqlServerTrunk"
         };
 
@@ -276,10 +283,9 @@ namespace AcornDB.Persistence.RDBMS
 
         private async Task WriteToSqlServer(SqlConnection conn, SqlTransaction? transaction, string id, byte[] processedBytes, DateTime timestamp, int version)
         {
-            var dataToStore = EncodeForStorage(processedBytes, "");
-
             // Get expires_at from the nut if needed
             var json = Encoding.UTF8.GetString(processedBytes);
+            var dataToStore = EncodeForStorage(processedBytes, json);
             var nut = _serializer.Deserialize<Nut<T>>(json);
             var expiresAt = nut?.ExpiresAt;
 
@@ -335,6 +341,21 @@ namespace AcornDB.Persistence.RDBMS
             return nuts;
         }
 
+        // Native Query Support
+
+        private protected override SqlDialect Dialect => QueryDialect;
+
+        private protected override string QueryTable => $"[{_schema}].[{_tableName}]";
+
+        private protected override string QueryColumns => "JsonData";
+
+        private protected override DbConnection OpenQueryConnection()
+        {
+            var conn = new SqlConnection(_connectionString);
+            conn.Open();
+            return conn;
+        }
+
         // ITrunkCapabilities implementation
         public bool SupportsHistory => false;
         public bool SupportsSync => true;
@@ -3,6 +3,7 @@ using AcornDB.Logging;
 using System.Collections.Concurrent;
 using System.Collections.Generic;
 using System.Data;
+using System.Data.Common;
 using System.Linq;
 using System.Runtime.CompilerServices;
 using System.Text;
@@ -24,15 +25,24 @@ namespace AcornDB.Persistence.RDBMS
     /// Supports extensible IRoot processors for compression, encryption, policy enforcement, etc.
     ///
     /// Storage Pipeline:
-    /// Write: Nut<T> → Serialize to JSON → Root Chain (ascending) → byte[] → Store in database
+    /// Write: Nut<T> → Serialize → Root Chain (ascending) → byte[] → Store in database
     /// Read: Read from database → byte[] → Root Chain (descending) → Deserialize → Nut<T>
+    ///
+    /// json_data holds plain JSON for text serializers without roots, and a blob for binary
+    /// serializers (MsgPackSerializer) or root output; both read back, as does the Base64 text
+    /// written by earlier versions.
+    ///
+    /// TreeQuery conditions, ordering, paging and counts compile to json_extract() SQL over
+    /// payload_json (see INativeQueryTrunk&lt;T&gt;), so native indexes serve them.
     /// </summary>
-    public class SqliteTrunk<T> : TrunkBase<T>, IDisposable
+    public class SqliteTrunk<T> : NativeQueryTrunkBase<T>, IDisposable
         where T : class
     {
         private readonly string _connectionString;
         private readonly string _tableName;
         private readonly SemaphoreSlim _connectionLock = new(1, 1);
+        private readonly ISerializer _payloadSerializer;
+        private static readonly SqlDialect QueryDialect = new SqliteDialect();
 
         private const int BATCH_SIZE = 100;
         private const int FLUSH_INTERVAL_MS = 200;
@@ -52,6 +62,7 @@ namespace AcornDB.Persistence.RDBMS
         {
             var typeName = typeof(T).Name;
             _tableName = tableName ?? $"acorn_{typeName}";
+            _payloadSerializer = _serializer.IsBinary ? new NewtonsoftJsonSerializer() : _serializer;
 
             // Connection string with pooling and optimization
             _connectionString = $"Data Source={databasePath};Cache=Shared;Mode=ReadWriteCreate;Pooling=True";
@@ -141,37 +152,34 @@ namespace AcornDB.Persistence.RDBMS
             using var reader = await cmd.ExecuteReaderAsync();
             if (await reader.ReadAsync())
             {
-                var dataStr = reader.GetString(0);
+                return DecodeNut(id, reader.GetValue(0));
+            }
 
-                // Step 1: Decode from base64 or use as plain JSON
-                byte[] storedBytes;
-                try
-                {
-                    storedBytes = Convert.FromBase64String(dataStr);
-                }
-                catch
-                {
-                    // Fallback for backward compatibility with plain JSON
-                    storedBytes = Encoding.UTF8.GetBytes(dataStr);
-                }
+            return null;
+        }
 
-                // Step 2: Process through root chain in descending sequence order (reverse)
-                var processedBytes = ProcessThroughRootsDescending(storedBytes, id);
+        /// <summary>
+        /// Decode a json_data value: a blob (binary serializers, IRoot output) or text
+        /// (plain JSON, or Base64 as written by earlier versions)
+        /// </summary>
+        private Nut<T>? DecodeNut(string id, object data)
+        {
+            // Step 1: Raw bytes of the stored document
+            var storedBytes = data as byte[] ?? DecodeStoredData((string)data);
 
-                // Step 3: Deserialize bytes to Nut<T>
-                try
-                {
-                    var json = Encoding.UTF8.GetString(processedBytes);
-                    return _serializer.Deserialize<Nut<T>>(json);
-                }
-                catch (Exception ex)
-                {
-                    AcornLog.Info($"⚠️ Failed to deserialize nut '{id}': {ex.Message}");
-                    return null;
-                }
-            }
+            // Step 2: Process through root chain in descending sequence order (reverse)
+            using var restored = _roots.Count > 0 ? ProcessThroughRootsDescending(storedBytes.AsSpan(), id) : null;
 
-            return null;
+            // Step 3: Deserialize bytes to Nut<T>
+            try
+            {
+                return _serializer.Deserialize<Nut<T>>(restored != null ? restored.WrittenSpan : storedBytes);
+            }
+            catch (Exception ex)
+            {
+                AcornLog.Info($"⚠️ Failed to deserialize nut '{id}': {ex.Message}");
+                return null;
+            }
         }
 
         public override void Toss(string id)
@@ -203,7 +211,7 @@ namespace AcornDB.Persistence.RDBMS
             using var conn = new SqliteConnection(_connectionString);
             await conn.OpenAsync();
 
-            var sql = $"SELECT json_data FROM {_tableName} ORDER BY timestamp DESC";
+            var sql = $"SELECT id, json_data FROM {_tableName} ORDER BY timestamp DESC";
 
             using var cmd = new SqliteCommand(sql, conn);
             using var reader = await cmd.ExecuteReaderAsync();
@@ -211,8 +219,7 @@ namespace AcornDB.Persistence.RDBMS
             var nuts = new List<Nut<T>>();
             while (await reader.ReadAsync())
             {
-                var json = reader.GetString(0);
-                var nut = JsonConvert.DeserializeObject<Nut<T>>(json);
+                var nut = DecodeNut(reader.GetString(0), reader.GetValue(1));
                 if (nut != null)
                     nuts.Add(nut);
             }
@@ -246,6 +253,8 @@ namespace AcornDB.Persistence.RDBMS
             SupportsNativeIndexes = true,
             SupportsFullTextSearch = false,  // TODO: Add FTS5 support
             SupportsComputedIndexes = true,  // SQLite supports expression indexes
+            SupportsScanPushdown = true,
+            SupportsNativeQueries = true,
             TrunkType = "SqliteTrunk"
         };
 
@@ -275,7 +284,7 @@ namespace AcornDB.Persistence.RDBMS
             using var conn = new SqliteConnection(_connectionString);
             conn.Open();
 
-            var sql = $"SELECT json_data FROM {_tableName} WHERE {whereClause} ORDER BY timestamp DESC";
+            var sql = $"SELECT id, json_data FROM {_tableName} WHERE {whereClause} ORDER BY timestamp DESC";
 
             using var cmd = new SqliteCommand(sql, conn);
             using var reader = cmd.ExecuteReader();
@@ -283,8 +292,7 @@ namespace AcornDB.Persistence.RDBMS
             var nuts = new List<Nut<T>>();
             while (reader.Read())
             {
-                var json = reader.GetString(0);
-                var nut = JsonConvert.DeserializeObject<Nut<T>>(json);
+                var nut = DecodeNut(reader.GetString(0), reader.GetValue(1));
                 if (nut != null)
                     nuts.Add(nut);
             }
@@ -385,17 +393,17 @@ namespace AcornDB.Persistence.RDBMS
         /// </summary>
         private async Task WriteToSqlite(SqliteConnection conn, SqliteTransaction? transaction, string id, byte[] processedBytes, DateTime timestamp, int version)
         {
-            // Convert to base64 for storage
-            var dataStr = Convert.ToBase64String(processedBytes);
+            // Text serializers without roots store readable JSON; anything else is a blob
+            object data = _serializer.IsBinary || _roots.Count > 0
+                ? processedBytes
+                : Encoding.UTF8.GetString(processedBytes);
             var timestampStr = timestamp.ToString("O");
 
-            // Get the full nut to extract payload and expires_at
-            // Note: This is a bit inefficient, but maintains compatibility
-            // In the future, we could pass these values directly
-            var json = Encoding.UTF8.GetString(processedBytes);
-            var nut = _serializer.Deserialize<Nut<T>>(json);
+            // payload_json feeds json_extract() indexes, so it is JSON whatever the document
+            // encoding. Root output (encrypted, compressed) cannot be read back here.
+            var nut = _roots.Count == 0 ? _serializer.Deserialize<Nut<T>>(processedBytes.AsSpan()) : null;
             var expiresAtStr = nut?.ExpiresAt?.ToString("O");
-            var payloadJson = nut != null ? _serializer.Serialize(nut.Payload) : "{}";
+            var payloadJson = nut != null ? _payloadSerializer.Serialize(nut.Payload) : "{}";
 
             var sql = $@"
                 INSERT INTO {_tableName} (id, json_data, payload_json, timestamp, version, expires_at)
@@ -412,7 +420,7 @@ namespace AcornDB.Persistence.RDBMS
                 : new SqliteCommand(sql, conn);
 
             cmd.Parameters.AddWithValue("@id", id);
-            cmd.Parameters.AddWithValue("@json", dataStr);
+            cmd.Parameters.AddWithValue("@json", data);
             cmd.Parameters.AddWithValue("@payloadJson", payloadJson);
             cmd.Parameters.AddWithValue("@timestamp", timestampStr);
             cmd.Parameters.AddWithValue("@version", version);
@@ -490,6 +498,31 @@ namespace AcornDB.Persistence.RDBMS
             return indexes;
         }
 
+        // Native Query Support
+
+        /// <summary>
+        /// payload_json mirrors the payload only when no root transforms the document
+        /// </summary>
+        private protected override bool PayloadQueryable => _roots.Count == 0;
+
+        private protected override SqlDialect Dialect => QueryDialect;
+
+        private protected override string QueryTable => _tableName;
+
+        private protected override string QueryColumns => "id, json_data";
+
+        private protected override DbConnection OpenQueryConnection()
+        {
+            var conn = new SqliteConnection(_connectionString);
+            conn.Open();
+            return conn;
+        }
+
+        private protected override Nut<T>? ReadQueryRow(DbDataReader reader)
+        {
+            return DecodeNut(reader.GetString(0), reader.GetValue(1));
+        }
+
         // ITrunkCapabilities implementation
         public bool SupportsHistory => false;
         public bool SupportsSync => true;
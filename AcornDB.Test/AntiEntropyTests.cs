@@ -0,0 +1,166 @@
+using AcornDB.Storage;
+using AcornDB.Sync;
+
+namespace AcornDB.Test
+{
+    public class AntiEntropyTests
+    {
+        public class Item
+        {
+            public string Id { get; set; } = string.Empty;
+            public string Name { get; set; } = string.Empty;
+        }
+
+        private static Tree<Item> NewTree()
+        {
+            var tree = new Tree<Item>(new MemoryTrunk<Item>());
+            tree.TtlEnforcementEnabled = false;
+            return tree;
+        }
+
+        /// <summary>
+        /// Two trees holding the same nuts, the second filled by squabbling the first's copies
+        /// </summary>
+        private static (Tree<Item> source, Tree<Item> replica) Replicas(int count)
+        {
+            var source = NewTree();
+            var replica = NewTree();
+            for (int i = 0; i < count; i++)
+                source.Stash(new Item { Id = $"item-{i}", Name = $"Item {i}" });
+            foreach (var nut in source.NutShells())
+                replica.Squabble(nut.Id, nut);
+            return (source, replica);
+        }
+
+        [Fact]
+        public void MerkleRoot_DependsOnContentNotWriteOrder()
+        {
+            var forward = new MerkleTree();
+            var backward = new MerkleTree();
+            for (int i = 0; i < 500; i++)
+                forward.Set($"k{i}", i);
+            for (int i = 499; i >= 0; i--)
+                backward.Set($"k{i}", i);
+
+            Assert.Equal(forward.RootHash, backward.RootHash);
+            Assert.Equal(500, forward.Count);
+
+            var before = forward.RootHash;
+            forward.Set("extra", 7);
+            Assert.NotEqual(before, forward.RootHash);
+            forward.Remove("extra");
+            Assert.Equal(before, forward.RootHash);
+        }
+
+        [Fact]
+        public void MerkleHashes_MatchVectorsSharedWithRustImplementation()
+        {
+            // The same values are asserted by merkle::tests in acorn-sync
+            Assert.Equal(0xc7eaaf7e73c5935aUL, MerkleTree.EntryHash("user-1", 42));
+
+            var tree = new MerkleTree();
+            tree.Set("user-1", 42);
+            tree.Set("user-2", 7);
+            Assert.Equal(0x173d7c88ab8a345eUL, tree.RootHash);
+            Assert.Equal(3145, tree.LeafOf("user-1"));
+        }
+
+        [Fact]
+        public void TreeMerkle_TracksStashTossAndSquabble()
+        {
+            var (source, replica) = Replicas(200);
+            Assert.Equal(source.Merkle.RootHash, replica.Merkle.RootHash);
+
+            source.Stash(new Item { Id = "item-3", Name = "changed" });
+            Assert.NotEqual(source.Merkle.RootHash, replica.Merkle.RootHash);
+
+            replica.Squabble("item-3", source.NutShells().Single(nut => nut.Id == "item-3"));
+            Assert.Equal(source.Merkle.RootHash, replica.Merkle.RootHash);
+
+            source.Toss("item-4");
+            replica.Toss("item-4");
+            Assert.Equal(source.Merkle.RootHash, replica.Merkle.RootHash);
+            Assert.Equal(199, source.Merkle.Count);
+        }
+
+        [Fact]
+        public async Task Diff_FindsOnlyDivergentIdsWithoutComparingEveryEntry()
+        {
+            var (source, replica) = Replicas(5000);
+            for (int i = 0; i < 50; i++)
+                source.Stash(new Item { Id = $"item-{i * 100}", Name = "changed" });
+            source.Stash(new Item { Id = "only-local", Name = "new" });
+            replica.Stash(new Item { Id = "only-remote", Name = "new" });
+
+            var diff = await MerkleReconciler.DiffAsync(source.Merkle, new TreeMerklePeer<Item>(replica));
+
+            Assert.Equal(Enumerable.Range(0, 50).Select(i => $"item-{i * 100}").OrderBy(id => id),
+                         diff.Divergent.OrderBy(id => id));
+            Assert.Equal(new[] { "only-local" }, diff.LocalOnly);
+            Assert.Equal(new[] { "only-remote" }, diff.RemoteOnly);
+            Assert.Equal(MerkleTree.DefaultDepth + 2, diff.RoundTrips);
+            Assert.True(diff.EntriesCompared < 500, $"compared {diff.EntriesCompared} entries");
+        }
+
+        [Fact]
+        public async Task Diff_OfIdenticalTrees_StopsAtTheRoot()
+        {
+            var (source, replica) = Replicas(1000);
+
+            var diff = await MerkleReconciler.DiffAsync(source.Merkle, new TreeMerklePeer<Item>(replica));
+
+            Assert.True(diff.InSync);
+            Assert.Equal(1, diff.RoundTrips);
+            Assert.Equal(0, diff.EntriesCompared);
+        }
+
+        [Fact]
+        public async Task Diff_RejectsPeersWithADifferentDepth()
+        {
+            var local = new MerkleTree(depth: 2);
+
+            await Assert.ThrowsAsync<InvalidOperationException>(
+                () => MerkleReconciler.DiffAsync(local, new TreeMerklePeer<Item>(NewTree())));
+        }
+
+        [Fact]
+        public async Task Reconcile_PullsAndPushesDivergentNutsUntilTreesMatch()
+        {
+            var (source, replica) = Replicas(1000);
+            System.Threading.Thread.Sleep(5);
+            for (int i = 0; i < 10; i++)
+                replica.Stash(new Item { Id = $"item-{i}", Name = "newer on replica" });
+            source.Stash(new Item { Id = "only-source", Name = "new" });
+
+            var branch = new InProcessBranch<Item>(replica);
+            var diff = await branch.ReconcileAsync(source);
+
+            Assert.NotNull(diff);
+            Assert.Equal(10, diff!.NutsPulled);
+            Assert.Equal(1, diff.NutsPushed);
+            Assert.Equal("newer on replica", source.Crack("item-3")!.Name);
+            Assert.Equal("new", replica.Crack("only-source")!.Name);
+            Assert.Equal(source.Merkle.RootHash, replica.Merkle.RootHash);
+            Assert.Equal(10, branch.GetStats().TotalPulled);
+        }
+
+        [Fact]
+        public async Task InProcessShake_TransfersOnlyDivergentNuts()
+        {
+            var (local, remote) = Replicas(2000);
+            System.Threading.Thread.Sleep(5);
+            for (int i = 0; i < 20; i++)
+                remote.Stash(new Item { Id = $"item-{i}", Name = "remote edit" });
+
+            var branch = new InProcessBranch<Item>(remote);
+            await branch.ShakeAsync(local);
+
+            Assert.Equal(20, branch.GetStats().TotalPulled);
+            Assert.Equal("remote edit", local.Crack("item-19")!.Name);
+            Assert.Equal(local.Merkle.RootHash, remote.Merkle.RootHash);
+
+            await branch.ShakeAsync(local);
+            Assert.Equal(20, branch.GetStats().TotalPulled);
+        }
+    }
+}
@@ -0,0 +1,130 @@
+using AcornDB.Storage;
+
+namespace AcornDB.Test
+{
+    public class BTreeTrunkCheckpointTests : FileTrunkTestBase
+    {
+        public BTreeTrunkCheckpointTests() : base("acorn_btree_ckpt") { }
+
+        private static void Write(BTreeTrunk<User> trunk, IEnumerable<int> ids)
+        {
+            // ImportChanges flushes the write batch before returning
+            trunk.ImportChanges(ids.Select(i => NutFor(i)).ToList());
+        }
+
+        [Fact]
+        public void Reopen_LoadsCheckpoint_WithoutReplayingTheLog()
+        {
+            using (var trunk = new BTreeTrunk<User>(_dir))
+            {
+                Write(trunk, Enumerable.Range(0, 200));
+            }
+
+            Assert.True(File.Exists(Path.Combine(_dir, "btree_v2.idx")));
+
+            using (var reopened = new BTreeTrunk<User>(_dir))
+            {
+                Assert.Equal(0, reopened.RecordsReplayedOnLoad);
+                Assert.True(reopened.CheckpointWatermark > 0);
+                Assert.Equal(200, reopened.CrackAll().Count());
+                Assert.Equal("User 42", reopened.Crack("user42")!.Payload.Name);
+            }
+        }
+
+        [Fact]
+        public void Reopen_ReplaysOnlyTheTailPastTheWatermark()
+        {
+            var copyDir = _dir + "_copy";
+            try
+            {
+                using (var trunk = new BTreeTrunk<User>(_dir))
+                {
+                    trunk.CheckpointIntervalBytes = 0;
+                    Write(trunk, Enumerable.Range(0, 100));
+                    trunk.Checkpoint();
+
+                    trunk.ImportChanges(new[] { NutFor(3, "Renamed", version: 2) });
+                    Write(trunk, Enumerable.Range(100, 10));
+                    trunk.Toss("user7");
+
+                    // Copy the files while the trunk is open, as if the process had crashed here
+                    Directory.CreateDirectory(copyDir);
+                    foreach (var name in new[] { "btree_v2.db", "btree_v2.idx" })
+                    {
+                        using var source = new FileStream(Path.Combine(_dir, name), FileMode.Open, FileAccess.Read, FileShare.ReadWrite);
+                        using var target = File.Create(Path.Combine(copyDir, name));
+                        source.CopyTo(target);
+                    }
+                }
+
+                using var recovered = new BTreeTrunk<User>(copyDir);
+                Assert.Equal(12, recovered.RecordsReplayedOnLoad); // 1 update + 10 new + 1 tombstone
+                Assert.Equal(109, recovered.CrackAll().Count());
+                Assert.Equal("Renamed", recovered.Crack("user3")!.Payload.Name);
+                Assert.Equal(2, recovered.Crack("user3")!.Version);
+                Assert.Null(recovered.Crack("user7"));
+                Assert.NotNull(recovered.Crack("user105"));
+            }
+            finally
+            {
+                try { Directory.Delete(copyDir, recursive: true); } catch { }
+            }
+        }
+
+        [Fact]
+        public void CorruptCheckpoint_FallsBackToFullReplay()
+        {
+            using (var trunk = new BTreeTrunk<User>(_dir))
+            {
+                Write(trunk, Enumerable.Range(0, 50));
+            }
+
+            var checkpointPath = Path.Combine(_dir, "btree_v2.idx");
+            var bytes = File.ReadAllBytes(checkpointPath);
+            bytes[bytes.Length / 2] ^= 0xFF;
+            File.WriteAllBytes(checkpointPath, bytes);
+
+            using var reopened = new BTreeTrunk<User>(_dir);
+            Assert.Equal(50, reopened.RecordsReplayedOnLoad);
+            Assert.Equal(50, reopened.CrackAll().Count());
+            Assert.Equal("User 10", reopened.Crack("user10")!.Payload.Name);
+        }
+
+        [Fact]
+        public void Toss_SurvivesReopen()
+        {
+            using (var trunk = new BTreeTrunk<User>(_dir))
+            {
+                Write(trunk, Enumerable.Range(0, 10));
+                trunk.Toss("user4");
+            }
+
+            File.Delete(Path.Combine(_dir, "btree_v2.idx"));
+
+            using var reopened = new BTreeTrunk<User>(_dir);
+            Assert.Null(reopened.Crack("user4"));
+            Assert.Equal(9, reopened.CrackAll().Count());
+        }
+
+        [Fact]
+        public void Compact_WritesAFreshCheckpoint()
+        {
+            using (var trunk = new BTreeTrunk<User>(_dir))
+            {
+                Write(trunk, Enumerable.Range(0, 20));
+                Write(trunk, Enumerable.Range(0, 20)); // overwrite everything once
+                var before = trunk.CheckpointWatermark;
+
+                trunk.Compact();
+
+                Assert.True(trunk.CheckpointWatermark > 0);
+                Assert.NotEqual(before, trunk.CheckpointWatermark);
+                Assert.Equal(20, trunk.CrackAll().Count());
+            }
+
+            using var reopened = new BTreeTrunk<User>(_dir);
+            Assert.Equal(0, reopened.RecordsReplayedOnLoad);
+            Assert.Equal("User 19", reopened.Crack("user19")!.Payload.Name);
+        }
+    }
+}
@@ -0,0 +1,143 @@
+using AcornDB.Metrics;
+using AcornDB.Storage;
+
+namespace AcornDB.Test
+{
+    public class BTreeTrunkCompactionTests : FileTrunkTestBase
+    {
+        public BTreeTrunkCompactionTests() : base("acorn_btree_compact") { }
+
+        private static void Write(BTreeTrunk<User> trunk, IEnumerable<int> ids, string name)
+        {
+            trunk.ImportChanges(ids.Select(i => NutFor(i, name)).ToList());
+        }
+
+        [Fact]
+        public void Compact_ReclaimsDeadSpace_AndReportsStats()
+        {
+            using (var trunk = new BTreeTrunk<User>(_dir))
+            {
+                trunk.AutoCompactionEnabled = false;
+                Write(trunk, Enumerable.Range(0, 200), "v1");
+                Write(trunk, Enumerable.Range(0, 200), "v2");
+                Write(trunk, Enumerable.Range(0, 200), "v3");
+                for (int i = 150; i < 200; i++)
+                {
+                    trunk.Toss($"user{i}");
+                }
+
+                var before = trunk.GetCompactionStats();
+                Assert.True(before.DeadSpaceRatio > 0.6);
+                Assert.Equal(before.FileBytes, before.LiveBytes + before.DeadBytes);
+
+                trunk.Compact();
+
+                var after = trunk.GetCompactionStats();
+                Assert.False(after.IsCompacting);
+                Assert.Equal(1, after.CompactionCount);
+                Assert.Equal(0, after.DeadBytes);
+                Assert.Equal(before.LiveBytes, after.LiveBytes);
+                Assert.Equal(before.FileBytes - after.FileBytes, after.LastBytesReclaimed);
+                Assert.True(after.LastCompactedAt.HasValue);
+                Assert.Equal(150, trunk.CrackAll().Count());
+                Assert.Equal("v3", trunk.Crack("user7")!.Payload.Name);
+                Assert.Null(trunk.Crack("user160"));
+            }
+
+            Assert.Contains("acorndb_compaction_total", MetricsCollector.Instance.ExportPrometheus());
+
+            using var reopened = new BTreeTrunk<User>(_dir);
+            Assert.Equal(0, reopened.RecordsReplayedOnLoad);
+            Assert.Equal(0, reopened.GetCompactionStats().DeadBytes);
+            Assert.Equal(150, reopened.CrackAll().Count());
+        }
+
+        [Fact]
+        public void CompactAsync_KeepsWritesMadeWhileCopying()
+        {
+            var expected = new Dictionary<string, string>();
+
+            using (var trunk = new BTreeTrunk<User>(_dir))
+            {
+                trunk.AutoCompactionEnabled = false;
+                for (int round = 0; round < 5; round++)
+                {
+                    Write(trunk, Enumerable.Range(0, 300), $"seed{round}");
+                }
+                Write(trunk, Enumerable.Range(1000, 50), "stable");
+                for (int i = 0; i < 300; i++)
+                {
+                    expected[$"user{i}"] = "seed4";
+                }
+
+                // Slow enough that the writes below overlap with the copy
+                trunk.CompactionBytesPerSecond = 64 * 1024;
+                var compaction = trunk.CompactAsync();
+
+                int writes = 0;
+                while (!compaction.IsCompleted || writes < 50)
+                {
+                    var i = writes % 400; // Also creates ids that did not exist before
+                    var name = $"live{writes}";
+                    trunk.Stash($"user{i}", NutFor(i, name));
+                    expected[$"user{i}"] = name;
+
+                    if (writes % 7 == 0)
+                    {
+                        var tossed = $"user{(i + 3) % 400}";
+                        trunk.Toss(tossed);
+                        expected.Remove(tossed);
+                    }
+
+                    Assert.Equal("stable", trunk.Crack($"user{1000 + writes % 50}")?.Payload.Name);
+                    writes++;
+                }
+                compaction.GetAwaiter().GetResult();
+                trunk.ImportChanges(Array.Empty<Nut<User>>());
+
+                AssertMatches(trunk, expected);
+                Assert.Equal(expected.Count + 50, trunk.CrackAll().Count());
+                Assert.Equal(1, trunk.GetCompactionStats().CompactionCount);
+            }
+
+            using var reopened = new BTreeTrunk<User>(_dir);
+            AssertMatches(reopened, expected);
+            Assert.Equal(expected.Count + 50, reopened.CrackAll().Count());
+        }
+
+        private static void AssertMatches(BTreeTrunk<User> trunk, Dictionary<string, string> expected)
+        {
+            foreach (var (id, name) in expected)
+            {
+                Assert.Equal(name, trunk.Crack(id)?.Payload.Name);
+            }
+        }
+
+        [Fact]
+        public void AutoCompaction_StartsWhenDeadSpaceCrossesThreshold()
+        {
+            using var trunk = new BTreeTrunk<User>(_dir);
+            trunk.CompactionMinDeadBytes = 1;
+            trunk.CompactionDeadSpaceRatio = 0.5;
+            trunk.CompactionBytesPerSecond = 0;
+
+            Write(trunk, Enumerable.Range(0, 100), "v1");
+            Assert.Equal(0, trunk.GetCompactionStats().CompactionCount);
+
+            Write(trunk, Enumerable.Range(0, 100), "v2");
+            Write(trunk, Enumerable.Range(0, 100), "v3");
+
+            var deadline = DateTime.UtcNow.AddSeconds(10);
+            while (trunk.GetCompactionStats().CompactionCount == 0 && DateTime.UtcNow < deadline)
+            {
+                Thread.Sleep(20);
+            }
+
+            var stats = trunk.GetCompactionStats();
+            Assert.True(stats.CompactionCount >= 1);
+            Assert.True(stats.TotalBytesReclaimed > 0);
+            Assert.Equal(100, trunk.CrackAll().Count());
+            Assert.Equal("v3", trunk.Crack("user42")!.Payload.Name);
+        }
+    }
+}
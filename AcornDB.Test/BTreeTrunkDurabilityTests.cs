@@ -0,0 +1,83 @@
+using AcornDB.Storage;
+
+namespace AcornDB.Test
+{
+    public class BTreeTrunkDurabilityTests : FileTrunkTestBase
+    {
+        public BTreeTrunkDurabilityTests() : base("acorn_btree_durability") { }
+
+        [Fact]
+        public async Task GroupCommit_CoalescesConcurrentWritersIntoSharedFlushes()
+        {
+            using var trunk = new BTreeTrunk<User>(_dir) { Durability = DurabilityMode.GroupCommit };
+
+            // Dedicated threads, so writers overlap even when the pool has a single worker
+            var writers = Enumerable.Range(0, 16).Select(w => Task.Factory.StartNew(async () =>
+            {
+                for (int i = 0; i < 25; i++)
+                {
+                    await trunk.StashAsync($"w{w}-{i}", NutFor($"w{w}-{i}"));
+                }
+            }, TaskCreationOptions.LongRunning).Unwrap());
+            await Task.WhenAll(writers);
+
+            var stats = trunk.GetDurabilityStats();
+            Assert.Equal(DurabilityMode.GroupCommit, stats.Mode);
+            Assert.Equal(400, stats.WritesCommitted);
+            Assert.True(stats.DiskFlushes < 400, $"expected shared flushes, got {stats.DiskFlushes}");
+            Assert.True(stats.AverageGroupSize > 1);
+            Assert.Equal(400, trunk.CrackAll().Count());
+        }
+
+        [Fact]
+        public async Task GroupCommit_WriteIsOnDiskWhenStashAsyncCompletes()
+        {
+            using var trunk = new BTreeTrunk<User>(_dir) { Durability = DurabilityMode.GroupCommit };
+
+            await trunk.StashAsync("alice", NutFor("alice", "Alice"));
+
+            // No explicit flush: completion already means the batch was written and fsynced
+            Assert.Equal("Alice", trunk.Crack("alice")!.Payload.Name);
+            Assert.Equal(1, trunk.GetDurabilityStats().DiskFlushes);
+        }
+
+        [Fact]
+        public async Task Sync_FlushesEachWriteOnItsOwn()
+        {
+            using var trunk = new BTreeTrunk<User>(_dir) { Durability = DurabilityMode.Sync };
+
+            for (int i = 0; i < 20; i++)
+            {
+                await trunk.StashAsync($"user{i}", NutFor($"user{i}"));
+            }
+            trunk.Stash("blocking", NutFor("blocking"));
+
+            var stats = trunk.GetDurabilityStats();
+            Assert.Equal(21, stats.DiskFlushes);
+            Assert.Equal(21, stats.Commits);
+            Assert.NotNull(trunk.Crack("blocking"));
+        }
+
+        [Fact]
+        public async Task BufferedAndNone_ReturnBeforeTheBatchIsWritten()
+        {
+            using (var trunk = new BTreeTrunk<User>(_dir) { Durability = DurabilityMode.None })
+            {
+                await trunk.StashAsync("early", NutFor("early"));
+                Assert.Null(trunk.Crack("early")); // Still in the batch buffer
+                Assert.Equal(0, trunk.GetDurabilityStats().Commits);
+
+                trunk.ImportChanges(Enumerable.Range(0, 300).Select(i => NutFor($"user{i}")).ToList());
+                Assert.NotNull(trunk.Crack("early"));
+                Assert.Equal(0, trunk.GetDurabilityStats().DiskFlushes);
+
+                trunk.Durability = DurabilityMode.Buffered;
+                trunk.ImportChanges(new[] { NutFor("late") });
+                Assert.Equal(1, trunk.GetDurabilityStats().DiskFlushes);
+            }
+
+            using var reopened = new BTreeTrunk<User>(_dir);
+            Assert.Equal(302, reopened.CrackAll().Count());
+        }
+    }
+}
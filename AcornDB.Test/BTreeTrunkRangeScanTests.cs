@@ -0,0 +1,138 @@
+using AcornDB.Query;
+using AcornDB.Storage;
+
+namespace AcornDB.Test
+{
+    public class BTreeTrunkRangeScanTests : FileTrunkTestBase
+    {
+        public BTreeTrunkRangeScanTests() : base("acorn_btree_range") { }
+
+        [Fact]
+        public void CrackRange_MergesRunAndRecentWrites_InKeyOrder()
+        {
+            using var trunk = new BTreeTrunk<User>(_dir);
+            trunk.ImportChanges(Enumerable.Range(0, 100).Select(i => NutFor($"user{i:D3}")).ToList());
+            trunk.Checkpoint();
+            Assert.Equal(0, trunk.InMemoryIndexEntryCount);
+
+            // Newer writes live in the in-memory delta on top of the run
+            trunk.ImportChanges(new[] { NutFor("user015", "Renamed"), NutFor("user0125") });
+            trunk.Toss("user012");
+
+            var ids = trunk.CrackRange("user010", "user020").Select(n => n.Id).ToList();
+
+            Assert.Equal(new List<string> { "user010", "user011", "user0125", "user013", "user014", "user015",
+                "user016", "user017", "user018", "user019" }, ids);
+            Assert.Equal("Renamed", trunk.CrackRange("user015", "user016").Single().Payload.Name);
+            Assert.Equal(5, trunk.CrackRange(null, "user005").Count());
+            Assert.Equal(3, trunk.CrackRange("user097", null).Count());
+        }
+
+        [Fact]
+        public void CrackPrefix_ReturnsOnlyMatchingIds()
+        {
+            using var trunk = new BTreeTrunk<User>(_dir);
+            trunk.ImportChanges(new[] { "order-1", "order-2", "orders", "invoice-1", "order-10", "ordeq" }
+                .Select(id => NutFor(id)).ToList());
+            trunk.Checkpoint();
+            trunk.Stash("order-3", NutFor("order-3"));
+
+            var ids = trunk.CrackPrefix("order-").Select(n => n.Id).ToList();
+
+            Assert.Equal(new List<string> { "order-1", "order-10", "order-2", "order-3" }, ids);
+            Assert.Empty(trunk.CrackPrefix("zzz"));
+            Assert.Equal(7, trunk.CrackPrefix("").Count());
+        }
+
+        [Fact]
+        public void KeyOrder_IsUtf8ByteOrder_ForSupplementaryCharacters()
+        {
+            // U+1F600 sorts after U+FFFD by code point, though its UTF-16 surrogates sort before it
+            var emoji = "a\U0001F600";
+            var replacement = "a\uFFFD";
+
+            using (var trunk = new BTreeTrunk<User>(_dir))
+            {
+                trunk.ImportChanges(new[] { NutFor(emoji), NutFor(replacement), NutFor("ab") });
+            }
+
+            using var reopened = new BTreeTrunk<User>(_dir);
+            Assert.Equal(0, reopened.RecordsReplayedOnLoad);
+            Assert.Equal(new[] { "ab", replacement, emoji }, reopened.CrackAll().Select(n => n.Id).ToArray());
+            Assert.NotNull(reopened.Crack(emoji));
+            Assert.NotNull(reopened.Crack(replacement));
+        }
+
+        [Fact]
+        public void InMemoryIndex_StaysBounded_AndLookupsFallThroughToTheRun()
+        {
+            using (var trunk = new BTreeTrunk<User>(_dir))
+            {
+                trunk.CheckpointIntervalBytes = 0;
+                trunk.MaxInMemoryIndexEntries = 100;
+
+                for (int batch = 0; batch < 10; batch++)
+                {
+                    trunk.ImportChanges(Enumerable.Range(batch * 100, 100).Select(i => NutFor($"user{i:D4}")).ToList());
+                }
+
+                Assert.True(trunk.InMemoryIndexEntryCount < 100);
+                Assert.Equal(1_000, trunk.CrackAll().Count());
+                Assert.Equal("user0042", trunk.Crack("user0042")!.Id);
+                Assert.Equal("user0999", trunk.Crack("user0999")!.Id);
+                Assert.Null(trunk.Crack("user1000"));
+
+                trunk.Toss("user0042");
+                Assert.Null(trunk.Crack("user0042"));
+            }
+
+            using var reopened = new BTreeTrunk<User>(_dir);
+            Assert.Equal(999, reopened.CrackAll().Count());
+            Assert.Null(reopened.Crack("user0042"));
+        }
+
+        [Fact]
+        public void Capabilities_AdvertiseOrderedScans()
+        {
+            using var trunk = new BTreeTrunk<User>(_dir);
+            Assert.True(trunk.Capabilities.SupportsOrderedScans);
+            Assert.False(new MemoryTrunk<User>().Capabilities.SupportsOrderedScans);
+        }
+
+        [Fact]
+        public void TreeQuery_PushesKeyPrefixDownToOrderedTrunk()
+        {
+            using var trunk = new BTreeTrunk<User>(_dir);
+            var tree = new Tree<User>(trunk);
+            for (int i = 0; i < 20; i++)
+            {
+                tree.Stash($"eu-{i:D2}", new User { Id = $"eu-{i:D2}", Name = $"EU {i}", Age = i });
+                tree.Stash($"us-{i:D2}", new User { Id = $"us-{i:D2}", Name = $"US {i}", Age = i });
+            }
+
+            var query = tree.Query().KeyPrefix("eu-").Where(u => u.Age >= 15);
+
+            Assert.Equal(QueryStrategy.KeyRangeScan, query.Explain().Strategy);
+            Assert.Equal(new[] { "EU 15", "EU 16", "EU 17", "EU 18", "EU 19" }, query.ToList().Select(u => u.Name));
+
+            var range = tree.Query().KeyRange("us-05", "us-08").ToList();
+            Assert.Equal(new[] { "US 5", "US 6", "US 7" }, range.Select(u => u.Name));
+        }
+
+        [Fact]
+        public void TreeQuery_KeyRange_FiltersCacheWhenTrunkIsUnordered()
+        {
+            var tree = new Tree<User>(new MemoryTrunk<User>());
+            foreach (var id in new[] { "b", "a2", "c", "a1", "ab" })
+            {
+                tree.Stash(id, new User { Id = id, Name = id });
+            }
+
+            var query = tree.Query().KeyPrefix("a");
+
+            Assert.NotEqual(QueryStrategy.KeyRangeScan, query.Explain().Strategy);
+            Assert.Equal(new[] { "a1", "a2", "ab" }, query.ToList().Select(u => u.Id));
+            Assert.Equal(new[] { "a2", "ab", "b" }, tree.Query().KeyRange("a2", "c").ToList().Select(u => u.Id));
+        }
+    }
+}
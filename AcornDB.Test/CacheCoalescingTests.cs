@@ -0,0 +1,197 @@
+using AcornDB.Storage;
+
+namespace AcornDB.Test
+{
+    public class CacheCoalescingTests
+    {
+        public class Item
+        {
+            public string Id { get; set; } = string.Empty;
+            public string Value { get; set; } = string.Empty;
+        }
+
+        /// <summary>
+        /// A slow store that counts reads, tracks how many run at once and can hold them on a gate
+        /// </summary>
+        private class SlowTrunk : MemoryTrunk<Item>
+        {
+            private int _running;
+            private int _maxRunning;
+            private int _reads;
+
+            public int DelayMs { get; set; } = 50;
+            public ManualResetEventSlim? Gate { get; set; }
+            // Hold each read until this many have been running at once (or 5s pass), so a
+            // parallelism check doesn't depend on how quickly the thread pool grows
+            public int AwaitConcurrentReads { get; set; }
+            public int Reads => Volatile.Read(ref _reads);
+            public int MaxConcurrentReads => Volatile.Read(ref _maxRunning);
+
+            public override Nut<Item>? Crack(string id)
+            {
+                Interlocked.Increment(ref _reads);
+                var running = Interlocked.Increment(ref _running);
+                int max;
+                while (running > (max = Volatile.Read(ref _maxRunning)) && Interlocked.CompareExchange(ref _maxRunning, running, max) != max)
+                {
+                }
+
+                try
+                {
+                    var nut = base.Crack(id);
+                    Gate?.Wait(TimeSpan.FromSeconds(5));
+                    SpinWait.SpinUntil(() => Volatile.Read(ref _maxRunning) >= AwaitConcurrentReads, TimeSpan.FromSeconds(5));
+                    Thread.Sleep(DelayMs);
+                    return nut;
+                }
+                finally
+                {
+                    Interlocked.Decrement(ref _running);
+                }
+            }
+        }
+
+        private static Nut<Item> NewNut(string id, string value) =>
+            new() { Id = id, Payload = new Item { Id = id, Value = value }, Timestamp = DateTime.UtcNow };
+
+        [Fact]
+        public async Task CachedTrunk_ConcurrentMissesShareOneBackingRead()
+        {
+            var gate = new ManualResetEventSlim(false);
+            var backing = new SlowTrunk { Gate = gate };
+            backing.Stash("hot", NewNut("hot", "v1"));
+            var cached = new CachedTrunk<Item>(backing);
+
+            // Everyone misses while the first read is held in the backing store
+            var leader = Task.Run(() => cached.Crack("hot"));
+            Assert.True(SpinWait.SpinUntil(() => backing.Reads == 1, TimeSpan.FromSeconds(5)));
+            var followers = Enumerable.Range(0, 31).Select(_ => cached.CrackAsync("hot")).ToList();
+            gate.Set();
+
+            var results = await Task.WhenAll(followers.Append(leader));
+            Assert.All(results, nut => Assert.Equal("v1", nut!.Payload.Value));
+            Assert.Equal(1, backing.Reads);
+            var stats = cached.GetCacheStats();
+            Assert.Equal(1, stats.MissCount);
+            Assert.Equal(31, stats.CoalescedCount);
+
+            // The shared result was cached once for everyone
+            Assert.Equal("v1", cached.Crack("hot")!.Payload.Value);
+            Assert.Equal(1, cached.GetCacheStats().HitCount);
+        }
+
+        [Fact]
+        public async Task CachedTrunk_WriteDuringLoadIsNotOverwrittenByTheStaleRead()
+        {
+            var gate = new ManualResetEventSlim(false);
+            var backing = new SlowTrunk { DelayMs = 0, Gate = gate };
+            backing.Stash("k", NewNut("k", "old"));
+            var cached = new CachedTrunk<Item>(backing);
+
+            // The load has read "old" and is held on the gate when the write lands
+            var load = Task.Run(() => cached.Crack("k"));
+            Assert.True(SpinWait.SpinUntil(() => backing.Reads == 1, TimeSpan.FromSeconds(5)));
+            cached.Stash("k", NewNut("k", "new"));
+            gate.Set();
+
+            Assert.Equal("old", (await load)!.Payload.Value);
+            Assert.Equal("new", cached.Crack("k")!.Payload.Value);
+            Assert.Equal(1, backing.Reads);
+        }
+
+        [Fact]
+        public void CachedTrunk_RefreshesHotEntriesBeforeTheyExpire()
+        {
+            var backing = new SlowTrunk { DelayMs = 5 };
+            backing.Stash("k", NewNut("k", "v1"));
+            var cached = new CachedTrunk<Item>(backing, new CacheOptions
+            {
+                TimeToLive = TimeSpan.FromSeconds(2),
+                RefreshAheadBeta = 10_000
+            });
+
+            Assert.Equal("v1", cached.Crack("k")!.Payload.Value);
+            backing.Stash("k", NewNut("k", "v2")); // Another instance wrote past this cache
+
+            Assert.True(SpinWait.SpinUntil(() => cached.Crack("k")!.Payload.Value == "v2", TimeSpan.FromSeconds(5)));
+            var stats = cached.GetCacheStats();
+            Assert.True(stats.RefreshAheadCount >= 1);
+            Assert.Equal(1, stats.MissCount);
+        }
+
+        [Fact]
+        public async Task NearFarTrunk_ConcurrentMissesShareOneFarAndBackingRead()
+        {
+            var gate = new ManualResetEventSlim(false);
+            var far = new SlowTrunk { Gate = gate };
+            var backing = new SlowTrunk();
+            backing.Stash("hot", NewNut("hot", "v1"));
+            var nearFar = new NearFarTrunk<Item>(new MemoryTrunk<Item>(), far, backing);
+
+            var leader = Task.Run(() => nearFar.Crack("hot"));
+            Assert.True(SpinWait.SpinUntil(() => far.Reads == 1, TimeSpan.FromSeconds(5)));
+            var followers = Enumerable.Range(0, 31).Select(_ => nearFar.CrackAsync("hot")).ToList();
+            gate.Set();
+
+            var results = await Task.WhenAll(followers.Append(leader));
+            Assert.All(results, nut => Assert.Equal("v1", nut!.Payload.Value));
+            Assert.Equal(1, far.Reads);
+            Assert.Equal(1, backing.Reads);
+
+            var stats = nearFar.GetStats();
+            Assert.Equal(1, stats.BackingStoreLoadCount);
+            Assert.Equal(31, stats.CoalescedCount);
+        }
+
+        [Fact]
+        public async Task NearFarTrunk_CrackManyFetchesMissesInParallel()
+        {
+            var near = new MemoryTrunk<Item>();
+            var far = new SlowTrunk { DelayMs = 20, AwaitConcurrentReads = 2 };
+            var backing = new SlowTrunk { DelayMs = 20 };
+            var nearFar = new NearFarTrunk<Item>(near, far, backing, new NearFarOptions { MaxParallelFetches = 8 });
+
+            near.Stash("n", NewNut("n", "near"));
+            far.Stash("f", NewNut("f", "far"));
+            for (int i = 0; i < 8; i++)
+                backing.Stash($"b{i}", NewNut($"b{i}", $"backing {i}"));
+
+            var ids = new[] { "n", "f", "missing", "n" }.Concat(Enumerable.Range(0, 8).Select(i => $"b{i}"));
+            var found = await nearFar.CrackManyAsync(ids);
+
+            Assert.Equal(10, found.Count);
+            Assert.Equal("near", found["n"].Payload.Value);
+            Assert.Equal("far", found["f"].Payload.Value);
+            Assert.Equal("backing 7", found["b7"].Payload.Value);
+            Assert.False(found.ContainsKey("missing"));
+            Assert.True(far.MaxConcurrentReads > 1, $"far reads ran one at a time ({far.MaxConcurrentReads})");
+
+            // Misses populated the near cache, so the next batch never leaves it
+            var reads = backing.Reads;
+            Assert.Equal(10, nearFar.CrackMany(ids).Count);
+            Assert.Equal(reads + 1, backing.Reads); // Only "missing" is looked up again
+        }
+
+        [Fact]
+        public void NearFarTrunk_NearEntriesExpireAfterNearCacheTimeToLive()
+        {
+            var near = new MemoryTrunk<Item>();
+            var far = new MemoryTrunk<Item>();
+            var backing = new SlowTrunk { DelayMs = 5 };
+            backing.Stash("k", NewNut("k", "v1"));
+            var nearFar = new NearFarTrunk<Item>(near, far, backing, new NearFarOptions
+            {
+                NearCacheTimeToLive = TimeSpan.FromMilliseconds(100),
+                RefreshAheadBeta = 0
+            });
+
+            Assert.Equal("v1", nearFar.Crack("k")!.Payload.Value);
+            far.Stash("k", NewNut("k", "v2"));
+            Assert.Equal("v1", nearFar.Crack("k")!.Payload.Value);
+
+            Thread.Sleep(150);
+            Assert.Equal("v2", nearFar.Crack("k")!.Payload.Value);
+            Assert.Equal(0, nearFar.GetStats().RefreshAheadCount);
+        }
+    }
+}
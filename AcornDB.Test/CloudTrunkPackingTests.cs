@@ -0,0 +1,260 @@
+using System.Collections.Concurrent;
+using System.Text;
+using AcornDB.Persistence.Cloud;
+
+namespace AcornDB.Test
+{
+    public class CloudTrunkPackingTests : IDisposable
+    {
+        public class Item
+        {
+            public string Id { get; set; } = string.Empty;
+            public string Value { get; set; } = string.Empty;
+        }
+
+        /// <summary>
+        /// In-memory object store with ETags and byte ranges that counts each kind of request
+        /// </summary>
+        private class MemoryCloudProvider : ICloudStorageProvider
+        {
+            private readonly ConcurrentDictionary<string, (byte[] Content, string ETag)> _objects = new();
+            private int _downloads;
+            private int _rangeReads;
+            private int _notModified;
+
+            public int Downloads => Volatile.Read(ref _downloads);
+            public int RangeReads => Volatile.Read(ref _rangeReads);
+            public int NotModified => Volatile.Read(ref _notModified);
+            public IEnumerable<string> Keys => _objects.Keys;
+
+            public bool SupportsBinaryObjects => true;
+            public bool SupportsRangeReads => true;
+
+            public Task UploadAsync(string key, string content) => UploadBytesAsync(key, Encoding.UTF8.GetBytes(content));
+
+            public Task<string?> UploadBytesAsync(string key, byte[] content)
+            {
+                var etag = Guid.NewGuid().ToString("N");
+                _objects[key] = (content.ToArray(), etag);
+                return Task.FromResult<string?>(etag);
+            }
+
+            public Task<string?> DownloadAsync(string key)
+            {
+                Interlocked.Increment(ref _downloads);
+                return Task.FromResult(_objects.TryGetValue(key, out var obj) ? Encoding.UTF8.GetString(obj.Content) : null);
+            }
+
+            public Task<CloudObject?> DownloadBytesAsync(string key, string? ifNoneMatch = null)
+            {
+                if (!_objects.TryGetValue(key, out var obj))
+                    return Task.FromResult<CloudObject?>(null);
+
+                if (ifNoneMatch == obj.ETag)
+                {
+                    Interlocked.Increment(ref _notModified);
+                    return Task.FromResult<CloudObject?>(new CloudObject { ETag = obj.ETag, NotModified = true });
+                }
+
+                Interlocked.Increment(ref _downloads);
+                return Task.FromResult<CloudObject?>(new CloudObject { Content = obj.Content, ETag = obj.ETag });
+            }
+
+            public Task<byte[]?> DownloadRangeAsync(string key, long offset, int length)
+            {
+                Interlocked.Increment(ref _rangeReads);
+                return Task.FromResult(_objects.TryGetValue(key, out var obj) ? obj.Content.AsSpan((int)offset, length).ToArray() : null);
+            }
+
+            public Task DeleteAsync(string key)
+            {
+                _objects.TryRemove(key, out _);
+                return Task.CompletedTask;
+            }
+
+            public Task<bool> ExistsAsync(string key) => Task.FromResult(_objects.ContainsKey(key));
+
+            public Task<List<string>> ListAsync(string? prefix = null) =>
+                Task.FromResult(_objects.Keys.Where(key => prefix == null || key.StartsWith(prefix, StringComparison.Ordinal)).ToList());
+
+            public CloudStorageInfo GetInfo() => new() { ProviderName = "Memory", BucketName = "test" };
+        }
+
+        private readonly string _cacheDirectory = Path.Combine(Path.GetTempPath(), $"acorndb_cloud_cache_{Guid.NewGuid():N}");
+
+        public void Dispose()
+        {
+            if (Directory.Exists(_cacheDirectory))
+                Directory.Delete(_cacheDirectory, recursive: true);
+        }
+
+        private static Nut<Item> NewNut(string id, string value) =>
+            new() { Id = id, Payload = new Item { Id = id, Value = value }, Timestamp = DateTime.UtcNow };
+
+        // Hex digits of random GUIDs do not shrink much under GZip, so the nut stays large
+        private static string Noise(int guids) =>
+            string.Concat(Enumerable.Range(0, guids).Select(_ => Guid.NewGuid().ToString("N")));
+
+        private static CloudTrunk<Item> NewTrunk(ICloudStorageProvider provider, CloudTrunkOptions? options) =>
+            new(provider, "items", enableLocalCache: false, batchSize: 1000, options: options);
+
+        [Fact]
+        public async Task PackedTrunk_LoadsManySmallNutsWithOneRequestPerPack()
+        {
+            var provider = new MemoryCloudProvider();
+            using (var writer = NewTrunk(provider, CloudTrunkOptions.Packed))
+            {
+                await writer.ImportChangesAsync(Enumerable.Range(0, 200).Select(i => NewNut($"item-{i}", $"value {i}")));
+            }
+
+            // Packs and their indexes only, no per-nut objects
+            var objects = provider.Keys.ToList();
+            Assert.All(objects, key => Assert.StartsWith("items/_packs/", key));
+            Assert.True(objects.Count < 10, $"{objects.Count} objects for 200 nuts");
+
+            using var reader = NewTrunk(provider, CloudTrunkOptions.Packed);
+            var all = (await reader.CrackAllAsync()).ToList();
+
+            Assert.Equal(200, all.Count);
+            Assert.Equal("value 42", all.Single(nut => nut.Id == "item-42").Payload.Value);
+            Assert.Equal(objects.Count, provider.Downloads);
+        }
+
+        [Fact]
+        public async Task PackedTrunk_CrackReadsOneNutWithARangeRequest()
+        {
+            var provider = new MemoryCloudProvider();
+            using (var writer = NewTrunk(provider, CloudTrunkOptions.Packed))
+            {
+                await writer.ImportChangesAsync(Enumerable.Range(0, 50).Select(i => NewNut($"item-{i}", $"value {i}")));
+            }
+
+            using var reader = NewTrunk(provider, CloudTrunkOptions.Packed);
+            Assert.Equal("value 7", (await reader.CrackAsync("item-7"))!.Payload.Value);
+            Assert.Equal("value 49", (await reader.CrackAsync("item-49"))!.Payload.Value);
+
+            Assert.Equal(2, provider.RangeReads);
+            Assert.Equal(provider.Keys.Count(key => key.EndsWith(".idx")), provider.Downloads); // The index, loaded once
+        }
+
+        [Fact]
+        public async Task PackedTrunk_LaterWritesAndTombstonesWin()
+        {
+            var provider = new MemoryCloudProvider();
+            var options = new CloudTrunkOptions { PackSmallNuts = true, PackThresholdBytes = 512 };
+            using (var writer = NewTrunk(provider, options))
+            {
+                await writer.ImportChangesAsync(new[] { NewNut("a", "a1"), NewNut("b", "b1"), NewNut("c", "c1") });
+                await writer.ImportChangesAsync(new[] { NewNut("a", "a2"), NewNut("big", Noise(64)) });
+                await writer.TossAsync("b");
+            }
+
+            using var reader = NewTrunk(provider, options);
+            var all = (await reader.CrackAllAsync()).ToDictionary(nut => nut.Id, nut => nut.Payload.Value);
+
+            Assert.Equal(3, all.Count);
+            Assert.Equal("a2", all["a"]);
+            Assert.Equal("c1", all["c"]);
+            Assert.Equal(64 * 32, all["big"].Length);
+            Assert.False(all.ContainsKey("b"));
+            Assert.Null(await reader.CrackAsync("b"));
+            Assert.Contains("items/big.json", provider.Keys); // Too large to pack
+        }
+
+        [Fact]
+        public async Task PackedTrunk_StillReadsNutsWrittenBeforePacking()
+        {
+            var provider = new MemoryCloudProvider();
+            using (var legacy = NewTrunk(provider, null))
+            {
+                await legacy.ImportChangesAsync(new[] { NewNut("old", "unpacked"), NewNut("moved", "before") });
+            }
+
+            using (var packed = NewTrunk(provider, CloudTrunkOptions.Packed))
+            {
+                await packed.ImportChangesAsync(new[] { NewNut("moved", "after"), NewNut("new", "packed") });
+            }
+
+            using var reader = NewTrunk(provider, CloudTrunkOptions.Packed);
+            var all = (await reader.CrackAllAsync()).ToDictionary(nut => nut.Id, nut => nut.Payload.Value);
+
+            Assert.Equal(3, all.Count);
+            Assert.Equal("unpacked", all["old"]);
+            Assert.Equal("after", all["moved"]);
+            Assert.Equal("unpacked", (await reader.CrackAsync("old"))!.Payload.Value);
+        }
+
+        [Fact]
+        public async Task DiskCache_ServesPacksLocallyAndRevalidatesObjectsByETag()
+        {
+            var provider = new MemoryCloudProvider();
+            var options = new CloudTrunkOptions { PackSmallNuts = true, PackThresholdBytes = 512, LocalCacheDirectory = _cacheDirectory };
+            using (var writer = NewTrunk(provider, options))
+            {
+                await writer.ImportChangesAsync(Enumerable.Range(0, 20).Select(i => NewNut($"item-{i}", $"value {i}")).Append(NewNut("big", Noise(64))));
+                Assert.Equal(21, (await writer.CrackAllAsync()).Count());
+            }
+
+            var downloads = provider.Downloads;
+            using var reader = NewTrunk(provider, options);
+            Assert.Equal(21, (await reader.CrackAllAsync()).Count());
+            Assert.Equal(downloads, provider.Downloads); // Packs and indexes from disk, "big" revalidated
+            Assert.True(provider.NotModified >= 1);
+            Assert.Equal(0, provider.RangeReads);
+            Assert.Equal("value 3", (await reader.CrackAsync("item-3"))!.Payload.Value);
+            Assert.Equal(0, provider.RangeReads);
+        }
+
+        [Fact]
+        public async Task CompactPacks_FoldsFlushesKeepingLatestValuesAndTombstones()
+        {
+            var provider = new MemoryCloudProvider();
+            var options = new CloudTrunkOptions { PackSmallNuts = true, PackThresholdBytes = 512 };
+            using (var writer = NewTrunk(provider, options))
+            {
+                for (int round = 0; round < 3; round++)
+                    await writer.ImportChangesAsync(Enumerable.Range(0, 10).Select(i => NewNut($"item-{i}", $"round {round}")));
+                await writer.TossAsync("item-3");
+                await writer.ImportChangesAsync(new[] { NewNut("big", Noise(64)) });
+
+                Assert.Equal(5, await writer.CompactPacksAsync());
+                Assert.Equal("round 2", (await writer.CrackAsync("item-7"))!.Payload.Value);
+            }
+
+            // One pack for the values, one index for it and one for the tombstone and "big"
+            Assert.Single(provider.Keys, key => key.EndsWith(".pack"));
+            Assert.Equal(2, provider.Keys.Count(key => key.EndsWith(".idx")));
+
+            using var reader = NewTrunk(provider, options);
+            var all = (await reader.CrackAllAsync()).ToDictionary(nut => nut.Id, nut => nut.Payload.Value);
+
+            Assert.Equal(10, all.Count);
+            Assert.Equal("round 2", all["item-7"]);
+            Assert.Equal(64 * 32, all["big"].Length);
+            Assert.False(all.ContainsKey("item-3"));
+            Assert.Null(await reader.CrackAsync("item-3"));
+
+            Assert.Equal(2, await reader.CompactPacksAsync());
+            Assert.Equal(10, (await reader.CrackAllAsync()).Count());
+        }
+
+        [Fact]
+        public async Task CompactPacks_LaterWritesWinAndOtherInstancesFollowOnRefresh()
+        {
+            var provider = new MemoryCloudProvider();
+            using var writer = NewTrunk(provider, CloudTrunkOptions.Packed);
+            await writer.ImportChangesAsync(new[] { NewNut("a", "a1"), NewNut("b", "b1") });
+            await writer.ImportChangesAsync(new[] { NewNut("a", "a2"), NewNut("b", "b2") });
+
+            using var reader = NewTrunk(provider, CloudTrunkOptions.Packed);
+            Assert.Equal(2, (await reader.CrackAllAsync()).Count());
+
+            Assert.Equal(2, await writer.CompactPacksAsync());
+            await writer.ImportChangesAsync(new[] { NewNut("a", "after") });
+
+            await reader.RefreshPackIndexAsync();
+            Assert.Equal("after", (await reader.CrackAsync("a"))!.Payload.Value);
+            Assert.Equal("b2", (await reader.CrackAsync("b"))!.Payload.Value);
+        }
+    }
+}
@@ -3,6 +3,8 @@ using System.Linq;
 using System.Linq.Expressions;
 using Xunit;
 using AcornDB.Indexing;
+using AcornDB.Models;
+using AcornDB.Query;
 
 namespace AcornDB.Test
 {
@@ -312,5 +314,40 @@ namespace AcornDB.Test
 
             Assert.Empty(resultsAfterRemove);
         }
+    
+
+        [Fact]
+        public void CompositeIndex_QuerySeeksPrefixThenRange()
+        {
+            // Arrange
+            Expression<Func<Employee, object>> dept = e => e.Department;
+            Expression<Func<Employee, object>> age = e => e.Age;
+
+            var tree = new Acorn<Employee>().InMemory().Sprout();
+            tree.AddIndex(new ManagedCompositeIndex<Employee>("IX_Dept_Age", new[] { dept, age }));
+
+            var departments = new[] { "Engineering", "Sales", "Marketing", "Support" };
+            for (int i = 0; i < 400; i++)
+            {
+                tree.Stash($"{i}", new Employee { Id = $"{i}", Department = departments[i / 100], Age = 20 + i % 40 });
+            }
+
+            // Act - Equality on the first key part, range on the second
+            var query = tree.Query()
+                .Where(e => e.Department == "Engineering" && e.Age >= 50)
+                .OrderBy(e => e.Age);
+            var plan = query.Explain();
+            var results = query.ToList();
+
+            // Assert
+            Assert.Equal(QueryStrategy.IndexRangeScan, plan.Strategy);
+            Assert.Equal("IX_Dept_Age", plan.SelectedIndex?.Name);
+            Assert.True(plan.IsCovered);
+            Assert.DoesNotContain(plan.Operations, op => op.StartsWith("Sort"));
+            Assert.Equal(20, results.Count);
+            Assert.All(results, e => Assert.Equal("Engineering", e.Department));
+            Assert.Equal(results.Select(e => e.Age).OrderBy(a => a), results.Select(e => e.Age));
+            Assert.Equal(50, results[0].Age);
+        }
     }
 }
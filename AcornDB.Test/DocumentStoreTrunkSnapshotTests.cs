@@ -0,0 +1,183 @@
+using AcornDB.Storage;
+using Newtonsoft.Json;
+
+namespace AcornDB.Test
+{
+    public class DocumentStoreTrunkSnapshotTests : FileTrunkTestBase
+    {
+        public DocumentStoreTrunkSnapshotTests() : base("acorn_docstore") { }
+
+        private string LogPath => Path.Combine(_dir, "changes.bin");
+
+        [Fact]
+        public void Snapshot_TruncatesLog_AndReopenReplaysOnlyTheTail()
+        {
+            using (var trunk = new DocumentStoreTrunk<User>(_dir))
+            {
+                for (int round = 0; round < 3; round++)
+                {
+                    for (int i = 0; i < 50; i++)
+                        trunk.Stash($"user{i}", NutFor(i, $"User {i} v{round}"));
+                }
+                trunk.Toss("user7");
+
+                var before = trunk.LogSizeBytes;
+                trunk.Snapshot();
+
+                Assert.Equal(1, trunk.SnapshotGeneration);
+                Assert.True(trunk.LogSizeBytes < before);
+                Assert.Equal(new FileInfo(LogPath).Length, trunk.LogSizeBytes);
+
+                trunk.Stash("user1", NutFor(1, "after snapshot"));
+            }
+
+            using (var reopened = new DocumentStoreTrunk<User>(_dir))
+            {
+                Assert.Equal(49, reopened.CrackAll().Count());
+                Assert.Equal(1, reopened.RecordsReplayedOnLoad);
+                Assert.Equal(1, reopened.SnapshotGeneration);
+                Assert.Equal("after snapshot", reopened.Crack("user1")!.Payload.Name);
+                Assert.Null(reopened.Crack("user7"));
+
+                // History read back from the snapshot, then from the log
+                Assert.Equal(new[] { "User 1 v0", "User 1 v1", "User 1 v2" }, reopened.GetHistory("user1").Select(n => n.Payload.Name));
+                Assert.Equal(new[] { "User 7 v0", "User 7 v1", "User 7 v2" }, reopened.GetHistory("user7").Select(n => n.Payload.Name));
+            }
+        }
+
+        [Fact]
+        public void Snapshot_IsWrittenAutomaticallyOnceTheLogIsLarge()
+        {
+            using (var trunk = new DocumentStoreTrunk<User>(_dir) { SnapshotIntervalBytes = 16 * 1024 })
+            {
+                for (int round = 0; round < 20; round++)
+                {
+                    trunk.ImportChanges(Enumerable.Range(0, 100).Select(i => NutFor(i, $"v{round}")).ToList());
+                }
+
+                Assert.True(trunk.SnapshotGeneration > 0);
+                Assert.True(trunk.LogSizeBytes < 32 * 1024);
+            }
+
+            using var reopened = new DocumentStoreTrunk<User>(_dir);
+            Assert.Equal(100, reopened.CrackAll().Count());
+            Assert.All(reopened.CrackAll(), n => Assert.Equal("v19", n.Payload.Name));
+            Assert.Equal(19, reopened.GetHistory("user5").Count);
+        }
+
+        [Fact]
+        public void History_KeepsOnlyTheLastVersions()
+        {
+            using (var trunk = new DocumentStoreTrunk<User>(_dir) { MaxHistoryVersions = 2 })
+            {
+                for (int v = 0; v < 6; v++)
+                    trunk.Stash("user1", NutFor(1, $"v{v}"));
+
+                Assert.Equal(new[] { "v3", "v4" }, trunk.GetHistory("user1").Select(n => n.Payload.Name));
+
+                trunk.Snapshot();
+                Assert.Equal(2, trunk.RetainedHistoryVersions);
+            }
+
+            // Without limits the versions written since the snapshot are all kept
+            using (var reopened = new DocumentStoreTrunk<User>(_dir))
+            {
+                reopened.Stash("user1", NutFor(1, "v6"));
+                Assert.Equal(new[] { "v3", "v4", "v5" }, reopened.GetHistory("user1").Select(n => n.Payload.Name));
+                Assert.Equal("v6", reopened.Crack("user1")!.Payload.Name);
+            }
+        }
+
+        [Fact]
+        public void History_DropsVersionsOlderThanMaxAge_AndMigratesJsonLog()
+        {
+            // A JSON-lines log as written by earlier versions, spanning several days
+            Directory.CreateDirectory(_dir);
+            var now = DateTime.UtcNow;
+            var lines = new[] { 5, 3, 1 }.Select(daysAgo => JsonConvert.SerializeObject(new ChangeLogEntry<User>
+            {
+                Action = "Stash",
+                Id = "user1",
+                Shell = NutFor(1, $"{daysAgo} days ago"),
+                Timestamp = now.AddDays(-daysAgo)
+            })).ToList();
+            lines.Add(JsonConvert.SerializeObject(new ChangeLogEntry<User> { Action = "Stash", Id = "user1", Shell = NutFor(1, "today"), Timestamp = now }));
+            File.WriteAllLines(Path.Combine(_dir, "changes.log"), lines);
+
+            using (var trunk = new DocumentStoreTrunk<User>(_dir) { MaxHistoryAge = TimeSpan.FromDays(2) })
+            {
+                Assert.Equal("today", trunk.Crack("user1")!.Payload.Name);
+                Assert.Equal(new[] { "1 days ago" }, trunk.GetHistory("user1").Select(n => n.Payload.Name));
+            }
+
+            Assert.False(File.Exists(Path.Combine(_dir, "changes.log")));
+            Assert.True(File.Exists(Path.Combine(_dir, "changes.log.migrated")));
+
+            using (var reopened = new DocumentStoreTrunk<User>(_dir))
+            {
+                Assert.Equal("today", reopened.Crack("user1")!.Payload.Name);
+                Assert.Equal(3, reopened.GetHistory("user1").Count);
+            }
+        }
+
+        [Fact]
+        public void Reopen_CutsOffTornRecordAtTheEndOfTheLog()
+        {
+            using (var trunk = new DocumentStoreTrunk<User>(_dir))
+            {
+                trunk.Stash("user1", NutFor(1));
+                trunk.Stash("user2", NutFor(2));
+            }
+
+            var validLength = new FileInfo(LogPath).Length;
+            using (var log = new FileStream(LogPath, FileMode.Append))
+            {
+                // Half a record header, as left by a crash mid-write
+                log.Write(new byte[] { 0x41, 0x44, 0x53, 0x52, 0x40, 0, 0 });
+            }
+
+            using (var reopened = new DocumentStoreTrunk<User>(_dir))
+            {
+                Assert.Equal(2, reopened.RecordsReplayedOnLoad);
+                reopened.Stash("user3", NutFor(3));
+            }
+
+            Assert.True(new FileInfo(LogPath).Length > validLength);
+            using (var again = new DocumentStoreTrunk<User>(_dir))
+            {
+                Assert.Equal(3, again.RecordsReplayedOnLoad);
+                Assert.Equal(3, again.CrackAll().Count());
+            }
+        }
+
+        [Fact]
+        public void Reopen_IgnoresLogAlreadyFoldedIntoSnapshot()
+        {
+            var staleLog = Path.Combine(Path.GetTempPath(), $"acorn_docstore_log_{Guid.NewGuid():N}");
+            try
+            {
+                using (var trunk = new DocumentStoreTrunk<User>(_dir))
+                {
+                    trunk.Stash("user1", NutFor(1, "v0"));
+                    trunk.Stash("user1", NutFor(1, "v1"));
+                    trunk.GetHistory("user1"); // flushes the log
+
+                    File.Copy(LogPath, staleLog);
+                    trunk.Snapshot();
+                }
+
+                // As if the process died after saving the snapshot but before resetting the log
+                File.Copy(staleLog, LogPath, overwrite: true);
+
+                using var reopened = new DocumentStoreTrunk<User>(_dir);
+                Assert.Equal(0, reopened.RecordsReplayedOnLoad);
+                Assert.Equal("v1", reopened.Crack("user1")!.Payload.Name);
+                Assert.Equal(new[] { "v0" }, reopened.GetHistory("user1").Select(n => n.Payload.Name));
+            }
+            finally
+            {
+                File.Delete(staleLog);
+            }
+        }
+    }
+}
@@ -0,0 +1,45 @@
+namespace AcornDB.Test
+{
+    /// <summary>
+    /// Shared setup for tests of trunks that persist to a directory: a fresh temp directory per
+    /// test, removed on dispose, plus a small document type and nut factories for it.
+    /// </summary>
+    public abstract class FileTrunkTestBase : IDisposable
+    {
+        public class User
+        {
+            public string Id { get; set; } = string.Empty;
+            public string Name { get; set; } = string.Empty;
+            public int Age { get; set; }
+        }
+
+        protected readonly string _dir;
+
+        protected FileTrunkTestBase(string prefix)
+        {
+            _dir = Path.Combine(Path.GetTempPath(), $"{prefix}_{Guid.NewGuid():N}");
+        }
+
+        public void Dispose()
+        {
+            try { Directory.Delete(_dir, recursive: true); } catch { }
+        }
+
+        /// <summary>
+        /// Nut for "user{i}", named "User {i}" unless a name is given
+        /// </summary>
+        protected static Nut<User> NutFor(int i, string? name = null, int version = 1) =>
+            NutFor($"user{i}", name ?? $"User {i}", version: version);
+
+        /// <summary>
+        /// Nut for the given id, named after it unless a name is given
+        /// </summary>
+        protected static Nut<User> NutFor(string id, string? name = null, int age = 30, int version = 1) => new Nut<User>
+        {
+            Id = id,
+            Payload = new User { Id = id, Name = name ?? id, Age = age },
+            Timestamp = DateTime.UtcNow,
+            Version = version
+        };
+    }
+}
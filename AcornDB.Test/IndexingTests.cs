@@ -687,6 +687,31 @@ namespace AcornDB.Test
             Assert.True(condition.IsConstantValue);
         }
 
+        [Fact]
+        public void ExpressionAnalyzer_ExtractsCapturedObjectMembers()
+        {
+            // Arrange
+            var analyzer = new AcornDB.Query.ExpressionAnalyzer<User>();
+            var filter = new User { Age = 42, Department = "Sales" };
+
+            // Act - Members of a captured object, and a static field
+            var result = analyzer.Analyze(u => u.Age >= filter.Age && u.Department == filter.Department && u.Age < MaxAge);
+
+            // Assert
+            Assert.True(result.IsIndexable);
+            Assert.Equal(3, result.Conditions.Count);
+            Assert.Equal(42, result.Conditions.Single(c => c.Operator == ComparisonOperator.GreaterThanOrEqual).Value);
+            Assert.Equal("Sales", result.Conditions.Single(c => c.PropertyName == "Department").Value);
+            Assert.Equal(MaxAge, result.Conditions.Single(c => c.Operator == ComparisonOperator.LessThan).Value);
+            Assert.All(result.Conditions, c => Assert.True(c.IsConstantValue));
+
+            // Values are read when analyzed, not cached with the member
+            filter.Age = 50;
+            Assert.Equal(50, analyzer.Analyze(u => u.Age >= filter.Age).Conditions[0].Value);
+        }
+
+        private static readonly int MaxAge = 65;
+
         [Fact]
         public void ExpressionAnalyzer_AnalyzesOrderByExpression()
         {
@@ -926,6 +951,213 @@ namespace AcornDB.Test
             Assert.Equal(30, results[0].Age);
         }
 
+        [Fact]
+        public void Query_SeeksExclusiveRangeBounds()
+        {
+            // Arrange
+            var tree = CreateStaffTree(1000);
+
+            // Act - Both bounds exclusive: only ages 11 and 12 qualify
+            var query = tree.Query().Where(u => u.Age > 10 && u.Age < 13);
+            var plan = query.Explain();
+            var results = query.ToList();
+
+            // Assert - One range seek answers both conditions exactly
+            Assert.Equal(QueryStrategy.IndexRangeScan, plan.Strategy);
+            Assert.Equal("IX_User_Age", plan.SelectedIndex?.Name);
+            Assert.True(plan.IsCovered);
+            Assert.Equal(40, results.Count);
+            Assert.All(results, u => Assert.InRange(u.Age, 11, 12));
+        }
+
+        [Fact]
+        public void Query_IntersectsIndexesForAndConditions()
+        {
+            // Arrange
+            var tree = CreateStaffTree(1000);
+
+            // Act
+            var query = tree.Query().Where(u => u.Age == 3 && u.Department == "D4");
+            var plan = query.Explain();
+            var results = query.ToList();
+
+            // Assert - Neither index alone is selective, their intersection is
+            Assert.Equal(QueryStrategy.IndexMerge, plan.Strategy);
+            Assert.Contains(plan.Operations, op => op.StartsWith("Intersect"));
+            Assert.True(plan.IsCovered);
+            Assert.Single(results);
+            Assert.Equal("User203", results[0].Name);
+        }
+
+        [Fact]
+        public void Query_UnionsIndexesForOrConditions()
+        {
+            // Arrange
+            var tree = CreateStaffTree(1000);
+
+            // Act
+            var query = tree.Query().Where(u => u.Age == 3 || u.Department == "D4");
+            var plan = query.Explain();
+            var results = query.ToList();
+
+            // Assert - 20 with Age 3, 50 in D4, one of them in both
+            Assert.Equal(QueryStrategy.IndexMerge, plan.Strategy);
+            Assert.Contains(plan.Operations, op => op.StartsWith("Union"));
+            Assert.Equal(69, results.Count);
+            Assert.Equal(69, results.Select(u => u.Id).Distinct().Count());
+            Assert.All(results, u => Assert.True(u.Age == 3 || u.Department == "D4"));
+        }
+
+        [Fact]
+        public void Query_OrderByWithTakeReadsOnlyTheFirstIndexEntries()
+        {
+            // Arrange
+            var tree = CreateStaffTree(1000);
+
+            // Act
+            var query = tree.Query().OrderByDescending(u => u.Age).Take(5);
+            var plan = query.Explain();
+            var results = query.ToList();
+
+            // Assert - Walks the Age index backwards instead of sorting 1000 nuts
+            Assert.Equal(QueryStrategy.IndexScan, plan.Strategy);
+            Assert.Equal("IX_User_Age", plan.SelectedIndex?.Name);
+            Assert.True(plan.EstimatedRowsExamined <= 5, $"Expected at most 5 rows examined, got {plan.EstimatedRowsExamined}");
+            Assert.DoesNotContain(plan.Operations, op => op.StartsWith("Sort"));
+            Assert.Equal(5, results.Count);
+            Assert.All(results, u => Assert.Equal(49, u.Age));
+        }
+
+        [Fact]
+        public void Query_RangeSeekProvidesOrderForMatchingOrderBy()
+        {
+            // Arrange
+            var tree = CreateStaffTree(1000);
+
+            // Act
+            var results = tree.Query()
+                .Where(u => u.Age >= 45)
+                .OrderBy(u => u.Age)
+                .Skip(10)
+                .Take(30)
+                .ToList();
+
+            // Assert - Ages 45..49, 20 each: skip 10 of age 45, then 10 more of 45 and 20 of 46
+            Assert.Equal(30, results.Count);
+            Assert.Equal(10, results.Count(u => u.Age == 45));
+            Assert.Equal(20, results.Count(u => u.Age == 46));
+            Assert.Equal(results.OrderBy(u => u.Age).Select(u => u.Id), results.Select(u => u.Id));
+        }
+
+        [Fact]
+        public void Query_CountUsesCoveringIndexWithoutFetching()
+        {
+            // Arrange
+            var tree = CreateStaffTree(1000);
+
+            // Act
+            var plan = tree.Query().Where(u => u.Department == "D4").Explain();
+            var covered = tree.Query().Where(u => u.Department == "D4").Count();
+            var partial = tree.Query().Where(u => u.Department == "D4" && u.Name.EndsWith("7")).Count();
+            var limited = tree.Query().Where(u => u.Department == "D4").Skip(45).Take(10).Count();
+
+            // Assert - Conditions the index cannot answer are still checked per document
+            Assert.True(plan.IsCovered);
+            Assert.Equal(50, covered);
+            Assert.Equal(5, partial);
+            Assert.Equal(5, limited);
+        }
+
+        [Fact]
+        public void Query_NonExpressionFilterIsNotAnsweredByIndex()
+        {
+            // Arrange
+            var tree = CreateStaffTree(1000);
+
+            // Act - WhereNut replaces the Where clause, so the Age index must not narrow it
+            var count = tree.Query()
+                .Where(u => u.Age == 3)
+                .WhereNut(nut => nut.Payload.Department == "D4")
+                .Count();
+
+            // Assert
+            Assert.Equal(50, count);
+        }
+
+        [Fact]
+        public void Index_RestashMovesEntryToNewKey()
+        {
+            // Arrange
+            var tree = new Acorn<User>()
+                .InMemory()
+                .WithIndex<User, int>(u => u.Age)
+                .Sprout();
+
+            tree.Stash("1", new User { Id = "1", Name = "Alice", Age = 25 });
+            tree.Stash("2", new User { Id = "2", Name = "Bob", Age = 25 });
+
+            // Act
+            tree.Stash("1", new User { Id = "1", Name = "Alice", Age = 40 });
+
+            // Assert - No stale entry is left under the old value
+            var index = (IScalarIndex<User, int>)tree.GetIndex("IX_User_Age")!;
+            Assert.Equal(new[] { "2" }, index.Lookup(25).ToArray());
+            Assert.Equal(new[] { "1" }, index.Lookup(40).ToArray());
+            Assert.Equal(2, index.GetStatistics().EntryCount);
+            Assert.Equal(new[] { "2", "1" }, index.GetAllSorted().ToArray());
+        }
+
+        [Fact]
+        public void Index_TracksNullValues()
+        {
+            // Arrange
+            var index = new ManagedScalarIndex<User, string>(u => u.Email);
+            index.Add("1", new User { Id = "1", Email = "b@example.com" });
+            index.Add("2", new User { Id = "2", Email = null! });
+            index.Add("3", new User { Id = "3", Email = "a@example.com" });
+
+            // Assert - Null keys sort first, like OrderBy, and are excluded from ranges
+            Assert.Equal(new[] { "2" }, index.Lookup(null!).ToArray());
+            Assert.Equal(new[] { "2", "3", "1" }, index.GetAllSorted().ToArray());
+            Assert.Equal(new[] { "1", "3", "2" }, index.GetAllSorted(ascending: false).ToArray());
+            Assert.Equal(new[] { "3", "1" }, index.Range("a", "z").ToArray());
+            Assert.Equal(3, index.GetStatistics().EntryCount);
+
+            // Act - Giving the document a value moves it out of the null bucket
+            index.Add("2", new User { Id = "2", Email = "c@example.com" });
+
+            // Assert
+            Assert.Empty(index.Lookup(null!));
+            Assert.Equal(new[] { "3", "1", "2" }, index.GetAllSorted().ToArray());
+        }
+
+        /// <summary>
+        /// Age = i % 50 (20 users per age), Department = D0..D19 (50 users each), with Age and
+        /// Department indexes. Age and Department are independent: each pair matches one user.
+        /// </summary>
+        private static Tree<User> CreateStaffTree(int count)
+        {
+            var tree = new Acorn<User>()
+                .InMemory()
+                .WithIndex<User, int>(u => u.Age)
+                .WithIndex<User, string>(u => u.Department)
+                .Sprout();
+
+            for (int i = 0; i < count; i++)
+            {
+                tree.Stash($"{i}", new User
+                {
+                    Id = $"{i}",
+                    Email = $"user{i}@example.com",
+                    Name = $"User{i}",
+                    Age = i % 50,
+                    Department = $"D{i / 50 % 20}"
+                });
+            }
+
+            return tree;
+        }
+
         [Fact]
         public void QueryPlanner_PrefersNativeIndexOverManagedIndex()
         {
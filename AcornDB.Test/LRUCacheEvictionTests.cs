@@ -123,6 +123,35 @@ namespace AcornDB.Test
             Assert.True(evicted > 0);
         }
 
+        /// <summary>
+        /// LRU limits with candidates that are never in the cache, as when another writer has
+        /// already removed them
+        /// </summary>
+        private class StaleCandidatesStrategy : LRUCacheStrategy<User>, ICacheStrategy<User>
+        {
+            public StaleCandidatesStrategy(int maxSize) : base(maxSize) { }
+
+            public new IEnumerable<string> GetEvictionCandidates(IDictionary<string, Nut<User>> currentCache)
+            {
+                return new[] { "ghost" };
+            }
+        }
+
+        [Fact]
+        public void LRU_StaleCandidates_DoNotSpinTheEvictionLoop()
+        {
+            var tree = new Tree<User>(new MemoryTrunk<User>(), new StaleCandidatesStrategy(maxSize: 2));
+
+            // Each stash over the limit evicts, removes nothing and must give up
+            for (int i = 0; i < 5; i++)
+            {
+                tree.Stash(new User { Id = $"user{i}", Name = $"User {i}" });
+            }
+
+            Assert.Equal(5, tree.NutCount);
+            Assert.Equal(0, tree.EvictCacheItems());
+        }
+
         [Fact]
         public void LRU_DisableEviction_DoesNotEvict()
         {
@@ -0,0 +1,97 @@
+using AcornDB.Storage;
+using AcornDB.Sync;
+
+namespace AcornDB.Test
+{
+    public class MeshGossipTests
+    {
+        public class Note
+        {
+            public string Id { get; set; } = string.Empty;
+            public string Text { get; set; } = string.Empty;
+        }
+
+        private static MeshCoordinator<Note> NewMesh(int nodes, int fanout = 3)
+        {
+            var mesh = new MeshCoordinator<Note>().EnableGossip(fanout, maxParallelism: 4, seed: 42);
+            for (int i = 0; i < nodes; i++)
+            {
+                var tree = new Tree<Note>(new MemoryTrunk<Note>());
+                tree.TtlEnforcementEnabled = false;
+                mesh.AddNode($"node-{i}", tree);
+            }
+            return mesh;
+        }
+
+        [Fact]
+        public async Task Gossip_ConvergesLargeMeshInLogarithmicRounds()
+        {
+            var mesh = NewMesh(200);
+            for (int i = 0; i < 20; i++)
+                mesh.GetNode($"node-{i * 10}")!.Stash(new Note { Id = $"note-{i}", Text = $"from {i * 10}" });
+
+            Assert.False(mesh.IsConverged());
+            Assert.True(await mesh.GossipUntilConvergedAsync());
+
+            Assert.Equal(20, mesh.GetNode("node-199")!.NutCount);
+            Assert.Equal("from 50", mesh.GetNode("node-3")!.Crack("note-5")!.Text);
+
+            var stats = mesh.GetNetworkStats().Gossip;
+            Assert.True(stats.Converged);
+            Assert.InRange(stats.LastConvergenceRounds, 1, 15);
+            Assert.Equal(200 * 3 * stats.Rounds, stats.Exchanges);
+            Assert.True(stats.NutsTransferred >= 199 * 20, $"transferred {stats.NutsTransferred}");
+            Assert.Equal(0, stats.FailedExchanges);
+        }
+
+        [Fact]
+        public async Task Gossip_LinksOnlyRestrictPeersAndCreateNoTangles()
+        {
+            var mesh = NewMesh(12, fanout: 2);
+            mesh.CreateRing();
+            mesh.GetNode("node-0")!.Stash(new Note { Id = "n", Text = "ring" });
+
+            Assert.Empty(mesh.GetNode("node-0")!.GetTangles());
+            Assert.Equal(0, mesh.GetNode("node-6")!.NutCount);
+
+            Assert.True(await mesh.GossipUntilConvergedAsync());
+            Assert.Equal("ring", mesh.GetNode("node-6")!.Crack("n")!.Text);
+            // Ring nodes have two neighbours, so each round is exactly 12 × 2 exchanges
+            var stats = mesh.GetNetworkStats().Gossip;
+            Assert.Equal(24 * stats.Rounds, stats.Exchanges);
+        }
+
+        [Fact]
+        public async Task Gossip_LoopGuardSuppressesChangesANodeHasAlreadySeen()
+        {
+            var mesh = NewMesh(3);
+            var a = mesh.GetNode("node-0")!;
+            var c = mesh.GetNode("node-2")!;
+
+            a.Stash(new Note { Id = "n", Text = "v1" });
+            await mesh.GossipWithAsync("node-0", "node-1");
+            await mesh.GossipWithAsync("node-1", "node-2");
+
+            System.Threading.Thread.Sleep(5);
+            a.Stash(new Note { Id = "n", Text = "v2" });
+            await mesh.GossipWithAsync("node-0", "node-1");
+
+            // node-1 already applied v1, so node-2's stale copy is dropped by the loop guard
+            // and only v2 moves
+            Assert.Equal(1, await mesh.GossipWithAsync("node-1", "node-2"));
+            Assert.Equal("v2", c.Crack("n")!.Text);
+            Assert.Equal(1, mesh.GetNetworkStats().Gossip.DuplicatesSuppressed);
+            Assert.True(mesh.IsConverged());
+        }
+
+        [Fact]
+        public async Task GossipRound_RequiresGossipMode()
+        {
+            var mesh = new MeshCoordinator<Note>();
+
+            Assert.False(mesh.GossipEnabled);
+            await Assert.ThrowsAsync<InvalidOperationException>(() => mesh.GossipRoundAsync());
+            Assert.Throws<ArgumentException>(() => mesh.EnableGossip(fanout: 0));
+        }
+    }
+}
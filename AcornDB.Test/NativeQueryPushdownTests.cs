@@ -0,0 +1,141 @@
+using AcornDB.Query;
+using AcornDB.Storage;
+
+namespace AcornDB.Test
+{
+    public class NativeQueryPushdownTests
+    {
+        public class Order
+        {
+            public string Id { get; set; } = string.Empty;
+            public string Status { get; set; } = string.Empty;
+            public int Total { get; set; }
+        }
+
+        /// <summary>
+        /// Answers queries with TrunkScanFilter.Apply, as an SQL trunk answers them in the
+        /// database, and records what it was handed
+        /// </summary>
+        private class RecordingQueryTrunk : MemoryTrunk<Order>, INativeQueryTrunk<Order>
+        {
+            public bool CanAnswer { get; set; } = true;
+            public List<TrunkScanFilter<Order>> Checked { get; } = new();
+            public List<TrunkScanFilter<Order>> Queries { get; } = new();
+            public List<TrunkScanFilter<Order>> Counts { get; } = new();
+
+            public override ITrunkCapabilities Capabilities { get; } = new TrunkCapabilities
+            {
+                SupportsScanPushdown = true,
+                SupportsNativeQueries = true,
+                TrunkType = "RecordingQueryTrunk"
+            };
+
+            public bool CanQuery(TrunkScanFilter<Order> filter)
+            {
+                Checked.Add(filter);
+                return CanAnswer;
+            }
+
+            public IEnumerable<Nut<Order>> Query(TrunkScanFilter<Order> filter)
+            {
+                Queries.Add(filter);
+                return filter.Apply(CrackAll()).ToList();
+            }
+
+            public int CountQuery(TrunkScanFilter<Order> filter)
+            {
+                Counts.Add(filter);
+                return filter.Apply(CrackAll()).Count();
+            }
+
+            public IEnumerable<Nut<Order>> CrackWhere(TrunkScanFilter<Order> filter) => CrackAll();
+        }
+
+        private static readonly DateTime Start = new(2026, 1, 1, 0, 0, 0, DateTimeKind.Utc);
+
+        private static (Tree<Order> tree, RecordingQueryTrunk trunk) NewTree()
+        {
+            var trunk = new RecordingQueryTrunk();
+            for (int i = 0; i < 20; i++)
+            {
+                trunk.Stash($"o{i:D2}", new Nut<Order>
+                {
+                    Id = $"o{i:D2}",
+                    Payload = new Order { Id = $"o{i:D2}", Status = i % 2 == 0 ? "open" : "shipped", Total = i * 10 },
+                    Timestamp = Start.AddMinutes(i)
+                });
+            }
+
+            var tree = new Tree<Order>(trunk);
+            tree.TtlEnforcementEnabled = false;
+            return (tree, trunk);
+        }
+
+        [Fact]
+        public void WhereOrderAndPaging_AreHandedToTheTrunk()
+        {
+            var (tree, trunk) = NewTree();
+            Assert.True(tree.SupportsNativeQueries);
+
+            var query = tree.Query()
+                .Where(o => o.Status == "open" && o.Total >= 40)
+                .OrderByDescending(o => o.Total)
+                .Skip(1)
+                .Take(3);
+
+            Assert.Equal(QueryStrategy.NativeQuery, query.Explain().Strategy);
+            Assert.Equal(new[] { 160, 140, 120 }, query.ToList().Select(o => o.Total));
+
+            var filter = Assert.Single(trunk.Queries);
+            Assert.NotNull(filter.Where);
+            Assert.NotNull(filter.OrderBy);
+            Assert.True(filter.OrderDescending);
+            Assert.Equal(1, filter.Skip);
+            Assert.Equal(3, filter.Take);
+        }
+
+        [Fact]
+        public void Count_IsAnsweredByTheTrunk()
+        {
+            var (tree, trunk) = NewTree();
+
+            Assert.Equal(10, tree.Query().Where(o => o.Status == "shipped").Count());
+            Assert.Equal(4, tree.Query().After(Start.AddMinutes(15)).Count());
+
+            Assert.Equal(2, trunk.Counts.Count);
+            Assert.Empty(trunk.Queries);
+            Assert.Equal(Start.AddMinutes(15), trunk.Counts[1].TimestampFrom);
+            Assert.False(trunk.Counts[1].TimestampFromInclusive);
+        }
+
+        [Fact]
+        public void NewestAndKeyRanges_KeepTheirOrder()
+        {
+            var (tree, trunk) = NewTree();
+
+            var newest = tree.Query().Newest().Take(2).ToList().Select(o => o.Id);
+            var slice = tree.Query().KeyRange("o05", "o08").ToList().Select(o => o.Id);
+
+            Assert.Equal(new[] { "o19", "o18" }, newest);
+            Assert.Equal(new[] { "o05", "o06", "o07" }, slice);
+            Assert.True(trunk.Queries[0].OrderByTimestamp);
+            Assert.Null(trunk.Queries[0].OrderBy);
+        }
+
+        [Fact]
+        public void QueriesTheTrunkCannotAnswer_RunOverTheCache()
+        {
+            var (tree, trunk) = NewTree();
+            trunk.CanAnswer = false;
+
+            var totals = tree.Query().Where(o => o.Status.StartsWith("ship")).OrderBy(o => o.Total).Take(2).ToList();
+            Assert.Equal(new[] { 10, 30 }, totals.Select(o => o.Total));
+            Assert.Single(trunk.Checked);
+            Assert.Empty(trunk.Queries);
+
+            // Delegate-only filters are never offered to the trunk
+            Assert.Equal(20, tree.Query().WhereNut(nut => nut.Id.Length == 3).Count());
+            Assert.Single(trunk.Checked);
+        }
+    }
+}
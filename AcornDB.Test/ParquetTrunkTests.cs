@@ -0,0 +1,178 @@
+using AcornDB.Persistence.DataLake;
+using AcornDB.Storage;
+using Newtonsoft.Json;
+using Parquet.Data;
+using Parquet.Schema;
+
+namespace AcornDB.Test
+{
+    public class ParquetTrunkTests : FileTrunkTestBase
+    {
+        public ParquetTrunkTests() : base("acorn_parquet") { }
+
+        private static ParquetOptions Options(int rowGroupSize = 100_000, int mergeThreshold = 8) => new ParquetOptions
+        {
+            FlushInterval = TimeSpan.Zero,
+            RowGroupSize = rowGroupSize,
+            MergeThreshold = mergeThreshold
+        };
+
+        private static async Task WaitForMergesAsync(ParquetTrunk<User> trunk)
+        {
+            for (int i = 0; i < 100 && trunk.GetStats().Merges == 0; i++)
+                await Task.Delay(50);
+        }
+
+        [Fact]
+        public async Task Flush_WritesDeltaFiles_NewestGenerationWins()
+        {
+            using var trunk = new ParquetTrunk<User>(_dir, Options());
+
+            trunk.Stash("user1", NutFor(1, "first"));
+            await trunk.FlushAsync();
+            trunk.Stash("user1", NutFor(1, "second", version: 2));
+            trunk.Stash("user2", NutFor(2));
+            await trunk.FlushAsync();
+
+            Assert.Equal(2, Directory.GetFiles(_dir, "*.parquet").Length);
+            Assert.Equal("second", trunk.Crack("user1")!.Payload.Name);
+            Assert.Equal(2, trunk.CrackAll().Count());
+        }
+
+        [Fact]
+        public async Task Toss_AfterFlush_IsHiddenByTombstone()
+        {
+            using (var trunk = new ParquetTrunk<User>(_dir, Options()))
+            {
+                trunk.Stash("user1", NutFor(1));
+                trunk.Stash("user2", NutFor(2));
+                await trunk.FlushAsync();
+                trunk.Toss("user1");
+                await trunk.FlushAsync();
+
+                Assert.Null(trunk.Crack("user1"));
+            }
+
+            using var reopened = new ParquetTrunk<User>(_dir, Options());
+            Assert.Null(reopened.Crack("user1"));
+            Assert.Equal(new[] { "user2" }, reopened.CrackAll().Select(n => n.Id));
+        }
+
+        [Fact]
+        public async Task Merge_FoldsDeltaFiles_KeepingTheNewestRows()
+        {
+            using var trunk = new ParquetTrunk<User>(_dir, Options(mergeThreshold: 3));
+
+            for (int round = 0; round < 3; round++)
+            {
+                for (int i = 0; i < 10; i++)
+                    trunk.Stash($"user{i}", NutFor(i, $"round {round}", version: round + 1));
+                await trunk.FlushAsync();
+            }
+            await WaitForMergesAsync(trunk);
+
+            var stats = trunk.GetStats();
+            Assert.True(stats.Merges > 0);
+            Assert.Equal(1, stats.Files);
+            Assert.Equal(10, trunk.CrackAll().Count());
+            Assert.Equal("round 2", trunk.Crack("user7")!.Payload.Name);
+        }
+
+        [Fact]
+        public async Task Compact_DropsTombstones()
+        {
+            using var trunk = new ParquetTrunk<User>(_dir, Options());
+
+            for (int i = 0; i < 10; i++)
+                trunk.Stash($"user{i}", NutFor(i));
+            await trunk.FlushAsync();
+            trunk.Toss("user3");
+            await trunk.FlushAsync();
+            await trunk.CompactAsync();
+
+            Assert.Equal(1, trunk.GetStats().Files);
+            Assert.Null(trunk.Crack("user3"));
+            Assert.Equal(9, trunk.CrackAll().Count());
+        }
+
+        [Fact]
+        public async Task CrackWhere_KeyRange_SkipsRowGroupsOutsideIt()
+        {
+            using var trunk = new ParquetTrunk<User>(_dir, Options(rowGroupSize: 10));
+
+            for (int i = 0; i < 100; i++)
+                trunk.Stash($"user{i:D3}", NutFor($"user{i:D3}"));
+            await trunk.FlushAsync();
+
+            var before = trunk.GetStats();
+            var ids = trunk.CrackWhere(new TrunkScanFilter<User> { KeyFrom = "user020", KeyTo = "user030" })
+                .Select(n => n.Id)
+                .OrderBy(id => id)
+                .ToList();
+            var after = trunk.GetStats();
+
+            Assert.Equal(Enumerable.Range(20, 10).Select(i => $"user{i:D3}"), ids);
+            Assert.Equal(1, after.RowGroupsRead - before.RowGroupsRead);
+            Assert.Equal(9, after.RowGroupsPruned - before.RowGroupsPruned);
+        }
+
+        [Fact]
+        public async Task Reopen_UsesFooterStats_AndContinuesGenerations()
+        {
+            using (var trunk = new ParquetTrunk<User>(_dir, Options(rowGroupSize: 10)))
+            {
+                for (int i = 0; i < 30; i++)
+                    trunk.Stash($"user{i}", NutFor(i));
+                await trunk.FlushAsync();
+            }
+
+            using (var reopened = new ParquetTrunk<User>(_dir, Options()))
+            {
+                // The catalog is loaded on first use
+                Assert.NotNull(reopened.Crack("user0"));
+                Assert.Equal(3, reopened.GetStats().RowGroups);
+                reopened.Stash("user5", NutFor(5, "updated", version: 2));
+            }
+
+            using var again = new ParquetTrunk<User>(_dir, Options());
+            Assert.Equal("updated", again.Crack("user5")!.Payload.Name);
+            Assert.Equal(30, again.CrackAll().Count());
+        }
+
+        [Fact]
+        public async Task LegacyFile_WithoutGenerationColumns_IsReadAndOverriddenByNewWrites()
+        {
+            // The single-file layout used before delta files: no Generation/Deleted columns and no
+            // row group stats in the footer
+            Directory.CreateDirectory(_dir);
+            var schema = new ParquetSchema(
+                new DataField<string>("Id"),
+                new DataField<int>("Version"),
+                new DataField<long>("Timestamp"),
+                new DataField<string>("Payload"),
+                new DataField<long?>("ExpiresAt"));
+            var fields = schema.DataFields;
+            var ids = new[] { "user1", "user2" };
+
+            using (var fs = File.Create(Path.Combine(_dir, $"{nameof(User)}.parquet")))
+            using (var writer = await Parquet.ParquetWriter.CreateAsync(schema, fs))
+            using (var group = writer.CreateRowGroup())
+            {
+                await group.WriteColumnAsync(new DataColumn(fields[0], ids));
+                await group.WriteColumnAsync(new DataColumn(fields[1], new[] { 1, 1 }));
+                await group.WriteColumnAsync(new DataColumn(fields[2], new[] { DateTime.UtcNow.Ticks, DateTime.UtcNow.Ticks }));
+                await group.WriteColumnAsync(new DataColumn(fields[3], ids.Select(id => JsonConvert.SerializeObject(new User { Id = id, Name = "legacy" })).ToArray()));
+                await group.WriteColumnAsync(new DataColumn(fields[4], new long?[] { null, null }));
+            }
+
+            using var trunk = new ParquetTrunk<User>(_dir, Options());
+            Assert.Equal("legacy", trunk.Crack("user1")!.Payload.Name);
+
+            trunk.Stash("user1", NutFor(1, "new", version: 2));
+            await trunk.FlushAsync();
+
+            Assert.Equal("new", trunk.Crack("user1")!.Payload.Name);
+            Assert.Equal("legacy", trunk.Crack("user2")!.Payload.Name);
+        }
+    }
+}
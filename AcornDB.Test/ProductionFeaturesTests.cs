@@ -400,6 +400,70 @@ namespace AcornDB.Test
             Assert.Contains("instance=\"test-instance\"", prometheus);
         }
 
+        [Fact]
+        public void LatencyHistogram_Percentiles_StayWithinBucketResolution()
+        {
+            // Arrange
+            var histogram = new LatencyHistogram();
+
+            // Act
+            for (int i = 0; i < 10; i++)
+            {
+                histogram.Record(0.3);
+                histogram.Record(3.0);
+                histogram.Record(30.0);
+            }
+
+            // Assert
+            Assert.Equal(30, histogram.Count);
+            Assert.InRange(histogram.GetPercentile(0.5), 2.9, 3.1);
+            Assert.InRange(histogram.GetPercentile(0.99), 29.0, 31.0);
+            Assert.Equal(30.0, histogram.MaxMilliseconds);
+            Assert.Equal(new long[] { 10, 20, 30 }, histogram.CumulativeCounts(new[] { 1.0, 10.0, 100.0 }, out var total));
+            Assert.Equal(30, total);
+        }
+
+        [Fact]
+        public void MetricsCollector_ExportPrometheus_EmitsLatencyHistograms()
+        {
+            // Arrange
+            var collector = MetricsCollector.Instance;
+            collector.Reset();
+
+            // Act
+            collector.RecordStash("HistTree", 0.3);
+            collector.RecordLatency(LatencyOperations.Flush, 2.0, trunk: "TestTrunk");
+            var prometheus = collector.ExportPrometheus();
+
+            // Assert
+            Assert.Contains("# TYPE acorndb_operation_duration_ms histogram", prometheus);
+            Assert.Contains("acorndb_operation_duration_ms_bucket{op=\"flush\",trunk=\"TestTrunk\",", prometheus);
+            Assert.Contains("le=\"+Inf\"} 1", prometheus);
+            Assert.Contains("acorndb_operation_duration_ms_count{op=\"stash\",tree=\"HistTree\"", prometheus);
+            Assert.Contains("acorndb_stash_total{", prometheus);
+        }
+
+        [Fact]
+        public void Tree_Operations_RecordLatencyPerTreeAndTrunk()
+        {
+            // Arrange
+            var collector = MetricsCollector.Instance;
+            collector.Reset();
+            var tree = new Tree<TestUser>(new MemoryTrunk<TestUser>());
+
+            // Act
+            tree.Stash("u1", new TestUser { Name = "Alice" });
+            tree.Crack("u1");
+            tree.Crack("u1");
+            tree.Toss("u1");
+
+            // Assert
+            Assert.Equal(1, collector.GetLatencyHistogram(LatencyOperations.Stash, tree.TreeId, "MemoryTrunk").Count);
+            Assert.Equal(2, collector.GetLatencyHistogram(LatencyOperations.Crack, tree.TreeId, "MemoryTrunk").Count);
+            Assert.Equal(1, collector.GetLatencyHistogram(LatencyOperations.Toss, tree.TreeId, "MemoryTrunk").Count);
+            Assert.Contains($"tree=\"{tree.TreeId}\",trunk=\"MemoryTrunk\"", collector.ExportPrometheus());
+        }
+
         // ===== MetricsServer Tests =====
 
         [Fact]
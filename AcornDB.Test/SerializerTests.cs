@@ -0,0 +1,225 @@
+using System.Text.Json.Serialization;
+using AcornDB.Models;
+using AcornDB.Storage;
+using AcornDB.Storage.Serialization;
+using Newtonsoft.Json;
+
+namespace AcornDB.Test
+{
+    public class SerializerTests : IDisposable
+    {
+        public enum Tier { Free, Pro, Enterprise }
+
+        public class Address
+        {
+            public string City { get; set; } = string.Empty;
+            public int Zip { get; set; }
+        }
+
+        public class Customer
+        {
+            public string Id { get; set; } = string.Empty;
+            public string Name { get; set; } = string.Empty;
+            public int Age { get; set; }
+            public double Balance { get; set; }
+            public Tier Tier { get; set; }
+            public DateTime SignedUp { get; set; }
+            public DateTime? LastSeen { get; set; }
+            public Guid Token { get; set; }
+            public Address? Address { get; set; }
+            public List<string> Tags { get; set; } = new();
+            public Dictionary<string, int> Scores { get; set; } = new();
+            public int[] Lucky { get; set; } = Array.Empty<int>();
+        }
+
+        public class Item
+        {
+            public string Name { get; set; } = string.Empty;
+            public int Age { get; set; }
+        }
+
+        private readonly string _dir = Path.Combine(Path.GetTempPath(), $"acorn_serializer_{Guid.NewGuid():N}");
+
+        public void Dispose()
+        {
+            try { Directory.Delete(_dir, recursive: true); } catch { }
+        }
+
+        private static Nut<Customer> SampleNut(string id = "c1") => new Nut<Customer>
+        {
+            Id = id,
+            Timestamp = new DateTime(2024, 3, 1, 12, 30, 15, DateTimeKind.Utc).AddTicks(1234),
+            ExpiresAt = new DateTime(2025, 1, 1, 0, 0, 0, DateTimeKind.Utc),
+            Version = 7,
+            Payload = new Customer
+            {
+                Id = id,
+                Name = "Ada Lovelace",
+                Age = 36,
+                Balance = 1234.5,
+                Tier = Tier.Enterprise,
+                SignedUp = new DateTime(2020, 5, 17, 8, 0, 0, DateTimeKind.Utc),
+                LastSeen = null,
+                Token = Guid.Parse("0f8fad5b-d9cb-469f-a165-70867728950e"),
+                Address = new Address { City = "London", Zip = 12345 },
+                Tags = new List<string> { "math", "engines" },
+                Scores = new Dictionary<string, int> { ["notes"] = 10, ["poetry"] = -3 },
+                Lucky = new[] { 1, 300, 70000 }
+            }
+        };
+
+        private static void AssertSame(Nut<Customer> expected, Nut<Customer>? actual)
+        {
+            Assert.NotNull(actual);
+            Assert.Equal(expected.Id, actual!.Id);
+            Assert.Equal(expected.Timestamp, actual.Timestamp);
+            Assert.Equal(expected.ExpiresAt, actual.ExpiresAt);
+            Assert.Equal(expected.Version, actual.Version);
+
+            var e = expected.Payload;
+            var a = actual.Payload;
+            Assert.Equal(e.Name, a.Name);
+            Assert.Equal(e.Age, a.Age);
+            Assert.Equal(e.Balance, a.Balance);
+            Assert.Equal(e.Tier, a.Tier);
+            Assert.Equal(e.SignedUp, a.SignedUp);
+            Assert.Null(a.LastSeen);
+            Assert.Equal(e.Token, a.Token);
+            Assert.Equal(e.Address!.City, a.Address!.City);
+            Assert.Equal(e.Address.Zip, a.Address.Zip);
+            Assert.Equal(e.Tags, a.Tags);
+            Assert.Equal(e.Scores, a.Scores);
+            Assert.Equal(e.Lucky, a.Lucky);
+        }
+
+        [Fact]
+        public void MsgPack_RoundTripsNutWithNestedMembers()
+        {
+            var serializer = new MsgPackSerializer();
+            var nut = SampleNut();
+
+            var bytes = serializer.SerializeToBytes(nut);
+            var restored = serializer.Deserialize<Nut<Customer>>(bytes.AsSpan());
+
+            AssertSame(nut, restored);
+            Assert.Equal(DateTimeKind.Utc, restored.Timestamp.Kind);
+        }
+
+        [Fact]
+        public void MsgPack_IsMuchSmallerThanIndentedJson()
+        {
+            var nut = SampleNut();
+            var json = JsonConvert.SerializeObject(nut, Formatting.Indented);
+            var bytes = new MsgPackSerializer().SerializeToBytes(nut);
+
+            // Guids and member names are stored verbatim, so the saving is mostly whitespace,
+            // quoting and number/date text
+            Assert.True(bytes.Length * 5 < System.Text.Encoding.UTF8.GetByteCount(json) * 3,
+                $"msgpack {bytes.Length} bytes vs json {json.Length} chars");
+        }
+
+        [Fact]
+        public void MsgPack_StringOverloadsRoundTripAndReadJson()
+        {
+            var serializer = new MsgPackSerializer();
+            var nut = SampleNut();
+
+            AssertSame(nut, serializer.Deserialize<Nut<Customer>>(serializer.Serialize(nut)));
+            AssertSame(nut, serializer.Deserialize<Nut<Customer>>(new NewtonsoftJsonSerializer().Serialize(nut)));
+        }
+
+        [Fact]
+        public void MsgPack_RejectsTruncatedPayloads()
+        {
+            var serializer = new MsgPackSerializer();
+            var bytes = serializer.SerializeToBytes(SampleNut());
+
+            Assert.Throws<InvalidDataException>(() => serializer.Deserialize<Nut<Customer>>(bytes.AsSpan(0, bytes.Length - 3)));
+        }
+
+        [Fact]
+        public void MsgPack_MatchesGoldenVectorSharedWithRustCodec()
+        {
+            // The same bytes are decoded by msgpack::tests in acorn-core
+            var nut = new Nut<Item>
+            {
+                Id = "u1",
+                ChangeId = Guid.Parse("78ea6e3e-4b76-4b32-ae05-8dea29a631c3"),
+                Payload = new Item { Name = "Ada", Age = 36 },
+                Timestamp = new DateTime(2024, 3, 1, 0, 0, 0, DateTimeKind.Utc),
+                ExpiresAt = null,
+                Version = 1
+            };
+
+            var hex = Convert.ToHexString(new MsgPackSerializer().SerializeToBytes(nut)).ToLowerInvariant();
+
+            Assert.Equal(GoldenNut, hex);
+        }
+
+        private const string GoldenNut =
+            "88a84368616e67654964d92437386561366533652d346237362d346233322d616530352d386465613239613633316333ac4f726967696e4e6f64654964c0a8486f70436f756e7400a24964a27531a75061796c6f616482a44e616d65a3416461a341676524a954696d657374616d70d6ff65e11a80a9457870697265734174c0a756657273696f6e01";
+
+        [Fact]
+        public void FileTrunk_ReadsJsonDocumentsAfterSwitchingToMsgPack()
+        {
+            var nut = SampleNut();
+            new FileTrunk<Customer>(_dir).Stash("c1", nut);
+
+            var binary = new FileTrunk<Customer>(_dir, new MsgPackSerializer());
+            AssertSame(nut, binary.Crack("c1"));
+
+            binary.Stash("c2", SampleNut("c2"));
+            AssertSame(SampleNut("c2"), binary.Crack("c2"));
+            Assert.Equal(2, binary.CrackAll().Count());
+        }
+
+        [Fact]
+        public void BTreeTrunk_RoundTripsWithMsgPack()
+        {
+            using (var trunk = new BTreeTrunk<Customer>(_dir, new MsgPackSerializer()))
+            {
+                for (int i = 0; i < 50; i++)
+                    trunk.Stash($"c{i}", SampleNut($"c{i}"));
+            }
+
+            using var reopened = new BTreeTrunk<Customer>(_dir, new MsgPackSerializer());
+            Assert.Equal(50, reopened.CrackAll().Count());
+            AssertSame(SampleNut("c17"), reopened.Crack("c17"));
+        }
+
+        [Fact]
+        public void Acorn_WithBinarySerialization_UsesMsgPackForMemoryAndFileTrunks()
+        {
+            var memory = new Acorn<Customer>().WithBinarySerialization().InMemory().Sprout();
+            memory.Stash("c1", SampleNut().Payload);
+            Assert.Equal("Ada Lovelace", memory.Crack("c1")!.Name);
+
+            var file = new Acorn<Customer>().WithBinarySerialization().WithStoragePath(_dir).Sprout();
+            file.Stash("c1", SampleNut().Payload);
+            Assert.Equal(12345, file.Crack("c1")!.Address!.Zip);
+
+            var stored = Directory.GetFiles(_dir, "*", SearchOption.AllDirectories).Single();
+            Assert.NotEqual((byte)'{', File.ReadAllBytes(stored)[0]);
+        }
+
+        [Fact]
+        public void SystemTextJson_SourceGeneratedContextReadsNewtonsoftDocuments()
+        {
+            var nut = SampleNut();
+            var json = new NewtonsoftJsonSerializer().Serialize(nut);
+            var serializer = new SystemTextJsonSerializer(CustomerJsonContext.Default);
+
+            var restored = serializer.Deserialize<Nut<Customer>>(json);
+            AssertSame(nut, restored);
+
+            var trunk = new MemoryTrunk<Customer>(serializer);
+            trunk.Stash("c1", nut);
+            AssertSame(nut, trunk.Crack("c1"));
+        }
+    }
+
+    [JsonSerializable(typeof(Nut<SerializerTests.Customer>))]
+    internal partial class CustomerJsonContext : JsonSerializerContext
+    {
+    }
+}
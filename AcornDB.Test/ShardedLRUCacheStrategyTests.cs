@@ -0,0 +1,169 @@
+using AcornDB.Cache;
+using AcornDB.Storage;
+
+namespace AcornDB.Test
+{
+    public class ShardedLRUCacheStrategyTests
+    {
+        public class User
+        {
+            public string Id { get; set; } = string.Empty;
+            public string Name { get; set; } = string.Empty;
+        }
+
+        private static Nut<User> NutFor(string id) =>
+            new Nut<User> { Id = id, Payload = new User { Id = id, Name = id } };
+
+        [Fact]
+        public void ShardedLRU_InvalidArguments_Throw()
+        {
+            Assert.Throws<ArgumentException>(() => new ShardedLRUCacheStrategy<User>(maxSize: 0));
+            Assert.Throws<ArgumentException>(() => new ShardedLRUCacheStrategy<User>(maxSize: 10, shardCount: -1));
+        }
+
+        [Fact]
+        public void ShardedLRU_ShardCount_RoundsUpToPowerOfTwo()
+        {
+            Assert.Equal(8, new ShardedLRUCacheStrategy<User>(maxSize: 10, shardCount: 5).ShardCount);
+            Assert.Equal(1, new ShardedLRUCacheStrategy<User>(maxSize: 10, shardCount: 1).ShardCount);
+        }
+
+        [Fact]
+        public void ShardedLRU_EvictsLeastRecentlyUsed_AcrossShards()
+        {
+            var lru = new ShardedLRUCacheStrategy<User>(maxSize: 5, shardCount: 4);
+            var cache = new Dictionary<string, Nut<User>>();
+
+            for (int i = 0; i < 8; i++)
+            {
+                var id = $"user{i}";
+                cache[id] = NutFor(id);
+                lru.OnStash(id, cache[id]);
+            }
+
+            // Touch the two oldest so they become the most recently used
+            lru.OnCrack("user0");
+            lru.OnCrack("user1");
+
+            // 8 cached, target 80% of 5 = 4, so the 4 coldest go
+            var candidates = lru.GetEvictionCandidates(cache).ToList();
+            Assert.Equal(new List<string> { "user2", "user3", "user4", "user5" }, candidates);
+        }
+
+        [Fact]
+        public void ShardedLRU_SkipsTrackedIdsMissingFromCache()
+        {
+            var lru = new ShardedLRUCacheStrategy<User>(maxSize: 2, shardCount: 2);
+            var cache = new Dictionary<string, Nut<User>>();
+
+            lru.OnStash("ghost", NutFor("ghost"));
+            for (int i = 0; i < 4; i++)
+            {
+                var id = $"user{i}";
+                cache[id] = NutFor(id);
+                lru.OnStash(id, cache[id]);
+            }
+
+            var candidates = lru.GetEvictionCandidates(cache).ToList();
+            Assert.DoesNotContain("ghost", candidates);
+            Assert.Equal(3, candidates.Count);
+        }
+
+        [Fact]
+        public void ShardedLRU_Toss_And_Reset_StopTracking()
+        {
+            var lru = new ShardedLRUCacheStrategy<User>(maxSize: 10);
+            var tree = new Tree<User>(new MemoryTrunk<User>(), lru);
+
+            for (int i = 0; i < 5; i++)
+            {
+                tree.Stash(new User { Id = $"user{i}", Name = $"User {i}" });
+            }
+            Assert.Equal(5, lru.TrackedItemCount);
+
+            tree.Toss("user0");
+            Assert.Equal(4, lru.TrackedItemCount);
+            Assert.Null(lru.GetLastAccessTime("user0"));
+
+            lru.Reset();
+            Assert.Equal(0, lru.TrackedItemCount);
+            Assert.Empty(lru.GetEvictionCandidates(new Dictionary<string, Nut<User>>
+            {
+                ["a"] = NutFor("a")
+            }));
+        }
+
+        [Fact]
+        public void ShardedLRU_GetStats_ReturnsCorrectInfo()
+        {
+            var lru = new ShardedLRUCacheStrategy<User>(maxSize: 100);
+            var tree = new Tree<User>(new MemoryTrunk<User>(), lru);
+
+            for (int i = 0; i < 50; i++)
+            {
+                tree.Stash(new User { Id = $"user{i}", Name = $"User {i}" });
+            }
+
+            var stats = lru.GetStats();
+            Assert.Equal(50, stats.TrackedItems);
+            Assert.Equal(100, stats.MaxSize);
+            Assert.Equal(50.0, stats.UtilizationPercentage);
+            Assert.NotNull(stats.OldestAccessTime);
+            Assert.True(stats.NewestAccessTime >= stats.OldestAccessTime);
+        }
+
+        [Fact]
+        public void ShardedLRU_TreeKeepsCacheBounded_AndReloadsFromTrunk()
+        {
+            var lru = new ShardedLRUCacheStrategy<User>(maxSize: 50);
+            var tree = new Tree<User>(new MemoryTrunk<User>(), lru);
+
+            for (int i = 0; i < 200; i++)
+            {
+                tree.Stash(new User { Id = $"user{i}", Name = $"User {i}" });
+            }
+
+            Assert.True(tree.NutCount <= 50);
+            Assert.Equal(tree.NutCount, lru.TrackedItemCount);
+
+            var user = tree.Crack("user0");
+            Assert.NotNull(user);
+            Assert.Equal("User 0", user!.Name);
+        }
+
+        [Fact]
+        public void ShardedLRU_ConcurrentTracking_StaysConsistent()
+        {
+            var lru = new ShardedLRUCacheStrategy<User>(maxSize: 1_000, shardCount: 8);
+
+            Parallel.For(0, 8, worker =>
+            {
+                for (int i = 0; i < 2_000; i++)
+                {
+                    var id = $"w{worker}-{i % 500}";
+                    lru.OnStash(id, NutFor(id));
+                    lru.OnCrack(id);
+                    if (i % 7 == 0)
+                        lru.OnToss(id);
+                }
+            });
+
+            var tracked = lru.TrackedItemCount;
+            Assert.InRange(tracked, 1, 8 * 500);
+            Assert.Equal(tracked, lru.GetStats().TrackedItems);
+        }
+
+        [Fact]
+        public void Acorn_WithShardedLRUCache_UsesShardedStrategy()
+        {
+            var tree = new AcornDB.Models.Acorn<User>()
+                .InMemory()
+                .WithShardedLRUCache(maxSize: 25, shardCount: 2)
+                .Sprout();
+
+            var strategy = Assert.IsType<ShardedLRUCacheStrategy<User>>(tree.CacheStrategy);
+            Assert.Equal(25, strategy.MaxSize);
+            Assert.Equal(2, strategy.ShardCount);
+        }
+    }
+}
@@ -0,0 +1,98 @@
+using System;
+using System.IO;
+using System.Linq;
+using Xunit;
+using AcornDB.Persistence.RDBMS;
+using AcornDB.Query;
+
+namespace AcornDB.Test
+{
+    public class SqliteNativeQueryTests : IDisposable
+    {
+        private readonly string _testDbPath;
+
+        public class User
+        {
+            public string Id { get; set; } = string.Empty;
+            public string Name { get; set; } = string.Empty;
+            public int Age { get; set; }
+            public bool Active { get; set; }
+        }
+
+        public SqliteNativeQueryTests()
+        {
+            _testDbPath = Path.Combine(Path.GetTempPath(), $"acorn_test_{Guid.NewGuid()}.db");
+        }
+
+        public void Dispose()
+        {
+            try
+            {
+                if (File.Exists(_testDbPath))
+                {
+                    File.Delete(_testDbPath);
+                }
+            }
+            catch
+            {
+                // Ignore cleanup errors
+            }
+        }
+
+        private static void Seed(SqliteTrunk<User> trunk)
+        {
+            for (int i = 0; i < 10; i++)
+            {
+                trunk.Save($"u{i}", new Nut<User>
+                {
+                    Id = $"u{i}",
+                    Payload = new User { Id = $"u{i}", Name = $"User {i}", Age = 20 + i, Active = i % 2 == 0 },
+                    Timestamp = new DateTime(2026, 1, 1, 0, i, 0, DateTimeKind.Utc)
+                });
+            }
+        }
+
+        [Fact]
+        public void SqliteTrunk_SupportsNativeQueries()
+        {
+            using var trunk = new SqliteTrunk<User>(_testDbPath);
+
+            Assert.True(trunk.Capabilities.SupportsNativeQueries);
+            Assert.True(new Tree<User>(trunk).SupportsNativeQueries);
+        }
+
+        [Fact]
+        public void Query_RunsWhereOrderAndPagingInSql()
+        {
+            using var trunk = new SqliteTrunk<User>(_testDbPath);
+            Seed(trunk);
+            var tree = new Tree<User>(trunk);
+
+            var query = tree.Query()
+                .Where(u => u.Active && u.Age >= 22)
+                .OrderByDescending(u => u.Age)
+                .Skip(1)
+                .Take(2);
+
+            Assert.Equal(QueryStrategy.NativeQuery, query.Explain().Strategy);
+            Assert.Equal(new[] { 26, 24 }, query.ToList().Select(u => u.Age));
+            Assert.Equal(4, tree.Query().Where(u => u.Active && u.Age >= 22).Count());
+        }
+
+        [Fact]
+        public void Query_NewestAndTimestampRangesMatchTheInMemoryResult()
+        {
+            using var trunk = new SqliteTrunk<User>(_testDbPath);
+            Seed(trunk);
+            var tree = new Tree<User>(trunk);
+
+            var newest = tree.Query().Newest().Take(3).ToList().Select(u => u.Id);
+            var window = tree.Query()
+                .Between(new DateTime(2026, 1, 1, 0, 3, 0, DateTimeKind.Utc), new DateTime(2026, 1, 1, 0, 6, 0, DateTimeKind.Utc))
+                .Count();
+
+            Assert.Equal(new[] { "u9", "u8", "u7" }, newest);
+            Assert.Equal(4, window);
+        }
+    }
+}
@@ -1,3 +1,4 @@
+using AcornDB.Cache;
 using AcornDB.Models;
 using AcornDB.Storage;
 
@@ -232,5 +233,137 @@ namespace AcornDB.Test
             var statsAfter = tree.GetNutStats();
             Assert.Equal(stashedBefore, statsAfter.TotalStashed);
         }
+
+        [Fact]
+        public void TTL_SetExpiration_PurgeRemovesOnlyDueNuts()
+        {
+            var tree = new Tree<User>(new MemoryTrunk<User>());
+            tree.Stash(new User { Id = "due", Name = "Due" });
+            tree.Stash(new User { Id = "later", Name = "Later" });
+            tree.Stash(new User { Id = "never", Name = "Never" });
+
+            var later = DateTime.UtcNow.AddHours(1);
+            Assert.True(tree.SetExpiration("due", DateTime.UtcNow.AddMinutes(-1)));
+            Assert.True(tree.SetExpiration("later", later));
+            Assert.False(tree.SetExpiration("missing", later));
+            Assert.Equal(1, tree.GetExpiringNutsCount(TimeSpan.Zero));
+
+            Assert.Equal(1, tree.CleanupExpiredNuts());
+            Assert.Null(tree.Crack("due"));
+            Assert.NotNull(tree.Crack("later"));
+            Assert.NotNull(tree.Crack("never"));
+
+            var stats = tree.GetNutStats();
+            Assert.Equal(1, stats.TtlTrackedCount);
+            Assert.Equal(1, stats.TtlExpiredCount);
+            Assert.Equal(1, stats.TtlPurgeRuns);
+            Assert.True(stats.MaxTtlLag >= TimeSpan.FromMinutes(1));
+            Assert.Equal(later, stats.NextTtlDeadline);
+        }
+
+        [Fact]
+        public void TTL_ExpiredNutsLoadedFromTrunk_ArePurged()
+        {
+            var trunk = new MemoryTrunk<User>();
+            trunk.Stash("old", new Nut<User>
+            {
+                Id = "old",
+                Payload = new User { Id = "old" },
+                Timestamp = DateTime.UtcNow.AddHours(-2),
+                ExpiresAt = DateTime.UtcNow.AddHours(-1)
+            });
+
+            var tree = new Tree<User>(trunk);
+            Assert.Equal(new[] { "old" }, tree.GetExpiringNuts(TimeSpan.Zero));
+
+            Assert.Equal(1, tree.CleanupExpiredNuts());
+            Assert.Null(trunk.Crack("old"));
+            Assert.Equal(0, tree.GetNutStats().TtlTrackedCount);
+        }
+
+        [Fact]
+        public void TTL_EvictedNutsStillExpire()
+        {
+            var trunk = new MemoryTrunk<User>();
+            var tree = new Tree<User>(trunk, new LRUCacheStrategy<User>(maxSize: 1));
+            tree.Stash(new User { Id = "a" });
+            tree.SetExpiration("a", DateTime.UtcNow.AddMinutes(-1));
+            tree.Stash(new User { Id = "b" }); // Evicts "a" from the cache, not the trunk
+
+            Assert.Equal(1, tree.CleanupExpiredNuts());
+            Assert.Null(trunk.Crack("a"));
+            Assert.NotNull(trunk.Crack("b"));
+        }
+
+        [Fact]
+        public void TTL_DeadlineMovedLaterInPlace_IsRescheduled()
+        {
+            var tree = new Tree<User>(new MemoryTrunk<User>());
+            tree.Stash(new User { Id = "a" });
+            tree.SetExpiration("a", DateTime.UtcNow.AddMinutes(-1));
+            tree.NutShells().Single().ExpiresAt = DateTime.UtcNow.AddHours(1);
+
+            Assert.Equal(0, tree.CleanupExpiredNuts());
+            Assert.NotNull(tree.Crack("a"));
+            Assert.Empty(tree.GetExpiringNuts(TimeSpan.Zero));
+            Assert.Single(tree.GetExpiringNuts(TimeSpan.FromHours(2)));
+        }
+
+        [Fact]
+        public void TTL_StashRacingThePurge_IsNeverDeleted()
+        {
+            var tree = new Tree<User>(new MemoryTrunk<User>());
+            for (int round = 0; round < 200; round++)
+            {
+                for (int i = 0; i < 20; i++)
+                {
+                    tree.Stash(new User { Id = $"u{i}" });
+                    tree.SetExpiration($"u{i}", DateTime.UtcNow.AddMinutes(-1));
+                }
+
+                // Whichever runs first, the re-stashed nut has no deadline and must survive
+                var purge = Task.Run(() => tree.CleanupExpiredNuts());
+                for (int i = 0; i < 20; i++)
+                    tree.Stash(new User { Id = $"u{i}", Name = "Fresh" });
+                purge.Wait();
+
+                for (int i = 0; i < 20; i++)
+                    Assert.Equal("Fresh", tree.Crack($"u{i}")?.Name);
+            }
+        }
+
+        [Fact]
+        public void TTL_RestashWithoutExpiry_StopsTracking()
+        {
+            var tree = new Tree<User>(new MemoryTrunk<User>());
+            tree.Stash(new User { Id = "a" });
+            tree.SetExpiration("a", DateTime.UtcNow.AddMinutes(-1));
+            tree.Stash(new User { Id = "a", Name = "Fresh" });
+
+            Assert.Equal(0, tree.CleanupExpiredNuts());
+            Assert.Equal("Fresh", tree.Crack("a")!.Name);
+        }
+
+        [Fact]
+        public void CachedTrunk_PurgeExpired_DropsOnlyDueEntries()
+        {
+            var backing = new MemoryTrunk<User>();
+            var cached = new CachedTrunk<User>(backing, new CacheOptions
+            {
+                TimeToLive = TimeSpan.FromMilliseconds(100),
+                MaxCacheSize = null // With a size limit every write purges what is due
+            });
+            cached.Stash("old", new Nut<User> { Id = "old", Payload = new User { Id = "old" } });
+            Thread.Sleep(150);
+            cached.Stash("new", new Nut<User> { Id = "new", Payload = new User { Id = "new" } });
+
+            var before = cached.GetCacheStats();
+            Assert.Equal(2, before.CachedItemCount);
+            Assert.Equal(1, before.ExpiredItemCount);
+
+            Assert.Equal(1, cached.PurgeExpired());
+            Assert.Equal(1, cached.GetCacheStats().CachedItemCount);
+            Assert.NotNull(backing.Crack("old")); // Expiry drops the cached copy only
+        }
     }
 }
@@ -0,0 +1,198 @@
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using Xunit;
+using AcornDB.Indexing;
+using AcornDB.Models;
+using AcornDB.Query;
+
+namespace AcornDB.Test
+{
+    public class TextIndexTests
+    {
+        public class Note
+        {
+            public string Id { get; set; } = string.Empty;
+            public string Title { get; set; } = string.Empty;
+            public string Body { get; set; } = string.Empty;
+        }
+
+        private static ManagedTextIndex<Note> CreateIndex(params string[] bodies)
+        {
+            var index = new ManagedTextIndex<Note>(n => n.Body);
+            index.Build(bodies.Select((body, i) => (object)new Nut<Note>
+            {
+                Id = $"n{i}",
+                Payload = new Note { Id = $"n{i}", Body = body }
+            }));
+            return index;
+        }
+
+        [Fact]
+        public void TextIndex_TokenizesLowercasesAndStemsPlurals()
+        {
+            var index = CreateIndex("The Meetings are on Mondays", "Budget meeting: 3 stories");
+
+            var tokens = index.GetAllTokens().ToList();
+
+            Assert.Equal("IX_Note_Body_Text", index.Name);
+            Assert.Equal(IndexType.Text, index.IndexType);
+            Assert.Contains("meeting", tokens);
+            Assert.Contains("monday", tokens);
+            Assert.Contains("story", tokens);
+            Assert.Contains("3", tokens);
+            Assert.DoesNotContain("the", tokens);
+            Assert.DoesNotContain("are", tokens);
+            Assert.Equal(2, index.Search("MEETING").Count());
+        }
+
+        [Fact]
+        public void TextIndex_RanksByBm25()
+        {
+            var index = CreateIndex(
+                "quarterly budget review with the finance team and several other long topics to discuss",
+                "budget budget budget",
+                "team offsite planning",
+                "budget notes");
+
+            var results = index.Search("budget").ToList();
+
+            Assert.Equal(3, results.Count);
+            Assert.Equal("n1", results[0].DocumentId);    // highest term frequency
+            Assert.Equal("n3", results[1].DocumentId);    // short document
+            Assert.Equal("n0", results[2].DocumentId);    // long document
+            Assert.True(results[0].Score > results[1].Score && results[1].Score > results[2].Score);
+            Assert.Equal(new[] { "budget" }, results[0].MatchedTerms);
+
+            // A rarer term outweighs a common one in documents of similar length
+            var both = index.Search("budget team").ToList();
+            var ranked = both.Select(r => r.DocumentId).ToList();
+            Assert.Equal(4, both.Count);
+            Assert.True(ranked.IndexOf("n2") < ranked.IndexOf("n3"));
+            Assert.Equal(2, both.Single(r => r.DocumentId == "n0").MatchedTerms.Count);
+        }
+
+        [Fact]
+        public void TextIndex_TopKMatchesExhaustiveSearch()
+        {
+            var random = new Random(42);
+            var vocabulary = Enumerable.Range(0, 300).Select(i => $"w{i}").ToArray();
+            var bodies = Enumerable.Range(0, 3000).Select(_ =>
+            {
+                var length = random.Next(5, 40);
+                // Skewed word choice, so a few terms are common and most are rare
+                return string.Join(" ", Enumerable.Range(0, length)
+                    .Select(_ => vocabulary[(int)(vocabulary.Length * Math.Pow(random.NextDouble(), 3))]));
+            }).ToArray();
+            var index = CreateIndex(bodies);
+
+            foreach (var query in new[] { "w0 w1 w2", "w0 w150", "w3 w40 w299 w7", "w10", "+w0 w5 w60", "w2 -w0 w9" })
+            {
+                var exhaustive = index.Search(query).Take(10).ToList();
+                var topK = index.Search(query, 10).ToList();
+
+                Assert.Equal(exhaustive.Count, topK.Count);
+                for (int i = 0; i < topK.Count; i++)
+                {
+                    Assert.Equal(exhaustive[i].Score, topK[i].Score, 9);
+                }
+            }
+        }
+
+        [Fact]
+        public void TextIndex_SupportsPhrasesRequiredExcludedAndOr()
+        {
+            var index = CreateIndex(
+                "gaming laptop with a fast screen",
+                "laptop for gaming",
+                "office laptop",
+                "gaming tablet");
+
+            Assert.Equal(new[] { "n0" }, index.Search("\"gaming laptop\"").Select(r => r.DocumentId));
+            Assert.Equal(new[] { "n0", "n1" }, index.Search("gaming AND laptop").Select(r => r.DocumentId).OrderBy(id => id));
+            Assert.Equal(new[] { "n0", "n1" }, index.Search("+gaming +laptop").Select(r => r.DocumentId).OrderBy(id => id));
+            Assert.Equal(new[] { "n2" }, index.Search("laptop -gaming").Select(r => r.DocumentId));
+            Assert.Equal(4, index.Search("laptop OR tablet").Count());
+            Assert.Empty(index.Search("laptop AND phone"));
+            Assert.Empty(index.Search("\"laptop gaming tablet\""));
+
+            // Stop words keep their place in phrases
+            var withGap = CreateIndex("state of the art design", "art of the state");
+            Assert.Equal(new[] { "n0" }, withGap.Search("\"state of the art\"").Select(r => r.DocumentId));
+        }
+
+        [Fact]
+        public void TextIndex_PrefixSearchAndWildcards()
+        {
+            var index = CreateIndex("meeting notes", "meetup tonight", "memo", "team meet");
+
+            Assert.Equal(new[] { "n0", "n1", "n3" }, index.PrefixSearch("Meet").OrderBy(id => id));
+            Assert.Equal(new[] { "n0", "n1", "n2", "n3" }, index.PrefixSearch("me").OrderBy(id => id));
+            Assert.Empty(index.PrefixSearch("zz"));
+            Assert.Equal(new[] { "n0", "n1", "n3" }, index.Search("meet*").Select(r => r.DocumentId).OrderBy(id => id));
+        }
+
+        [Fact]
+        public void TextIndex_UpdatesAndRemovesIncrementally()
+        {
+            var index = CreateIndex("alpha beta", "beta gamma");
+
+            index.Add("n0", new Note { Id = "n0", Body = "gamma delta" });
+            index.Remove("n1");
+            index.Add("n2", new Note { Id = "n2", Body = "beta" });
+
+            Assert.Equal(new[] { "n2" }, index.Search("beta").Select(r => r.DocumentId));
+            Assert.Equal(new[] { "n0" }, index.Search("gamma").Select(r => r.DocumentId));
+            Assert.Empty(index.Search("alpha"));
+            Assert.DoesNotContain("alpha", index.GetAllTokens());
+            Assert.Equal(2, index.GetStatistics().EntryCount);
+
+            // Enough rewrites to renumber every document ordinal
+            for (int round = 0; round < 1500; round++)
+            {
+                index.Add("n0", new Note { Id = "n0", Body = $"gamma delta r{round}" });
+            }
+
+            Assert.Equal(new[] { "n0" }, index.Search("gamma").Select(r => r.DocumentId));
+            Assert.Equal(new[] { "n0" }, index.Search("r1499").Select(r => r.DocumentId));
+            Assert.Empty(index.Search("r1498"));
+            Assert.Equal(new[] { "n0", "n2" }, index.Search("delta beta").Select(r => r.DocumentId).OrderBy(id => id));
+        }
+
+        [Fact]
+        public void Query_SearchUsesTextIndex()
+        {
+            var tree = new Acorn<Note>().InMemory().WithTextIndex(n => n.Body).Sprout();
+            tree.Stash(new Note { Id = "1", Title = "Standup", Body = "daily standup meeting notes" });
+            tree.Stash(new Note { Id = "2", Title = "Budget", Body = "budget meeting with finance" });
+            tree.Stash(new Note { Id = "3", Title = "Groceries", Body = "milk eggs bread" });
+            tree.Stash(new Note { Id = "4", Title = "Retro", Body = "retro meeting meeting meeting" });
+
+            var query = tree.Query().Search("meeting").Take(2);
+            var plan = query.Explain();
+
+            Assert.Equal(QueryStrategy.TextSearch, plan.Strategy);
+            Assert.Equal("IX_Note_Body_Text", plan.SelectedIndex?.Name);
+            Assert.Contains(plan.Operations, op => op.Contains("top 2"));
+            Assert.Equal(new[] { "4", "2" }, query.ToList().Select(n => n.Id));
+
+            Assert.Equal(3, tree.Query().Search("meeting").Count());
+            Assert.Equal(new[] { "2" }, tree.Query().Search("meeting").Where(n => n.Title == "Budget").ToList().Select(n => n.Id));
+            Assert.Equal(new[] { "1", "2", "4" }, tree.Query().Search("meeting").OrderBy(n => n.Id).ToList().Select(n => n.Id));
+
+            // Index follows stash and toss
+            tree.Toss("4");
+            tree.Stash(new Note { Id = "3", Title = "Groceries", Body = "meeting at the market" });
+            Assert.Equal(new[] { "1", "2", "3" }, tree.Query().Search("meeting").ToList().Select(n => n.Id).OrderBy(id => id));
+        }
+
+        [Fact]
+        public void Query_SearchWithoutTextIndexThrows()
+        {
+            var tree = new Acorn<Note>().InMemory().Sprout();
+            tree.Stash(new Note { Id = "1", Body = "meeting" });
+
+            Assert.Throws<InvalidOperationException>(() => tree.Query().Search("meeting").ToList());
+        }
+    }
+}
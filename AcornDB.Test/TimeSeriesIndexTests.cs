@@ -0,0 +1,188 @@
+using System;
+using System.Linq;
+using System.Threading;
+using Xunit;
+using AcornDB.Indexing;
+using AcornDB.Models;
+using AcornDB.Query;
+
+namespace AcornDB.Test
+{
+    public class TimeSeriesIndexTests
+    {
+        public class Reading
+        {
+            public string Id { get; set; } = string.Empty;
+            public DateTime Timestamp { get; set; }
+            public double Value { get; set; }
+            public double Latency { get; set; }
+        }
+
+        private static readonly DateTime Day = new DateTime(2025, 3, 1, 0, 0, 0, DateTimeKind.Utc);
+
+        private static ManagedTimeSeriesIndex<Reading> CreateIndex()
+        {
+            return new ManagedTimeSeriesIndex<Reading>(
+                r => r.Timestamp,
+                new IndexConfiguration().BucketHours(1),
+                r => r.Value,
+                r => r.Latency);
+        }
+
+        private static void Add(ManagedTimeSeriesIndex<Reading> index, string id, DateTime timestamp, double value, double latency = 0)
+        {
+            index.Add(id, new Reading { Id = id, Timestamp = timestamp, Value = value, Latency = latency });
+        }
+
+        [Fact]
+        public void TimeSeriesIndex_KeepsRunningAggregatesPerBucket()
+        {
+            var index = CreateIndex();
+            Add(index, "a", Day.AddMinutes(10), 4, 100);
+            Add(index, "b", Day.AddMinutes(50), 8, 300);
+            Add(index, "c", Day.AddHours(2).AddMinutes(5), 1, 50);
+
+            var summaries = index.Summarize(Day, Day.AddDays(1)).ToList();
+
+            Assert.Equal("IX_Reading_Timestamp_TimeSeries", index.Name);
+            Assert.Equal(IndexType.TimeSeries, index.IndexType);
+            Assert.Equal(2, summaries.Count);
+            Assert.Equal(Day, summaries[0].BucketStart);
+            Assert.Equal(Day.AddHours(1), summaries[0].BucketEnd);
+            Assert.Equal(2, summaries[0].Count);
+            Assert.Equal(6, summaries[0].Values["Value"].Average);
+            Assert.Equal(4, summaries[0].Values["Value"].Min);
+            Assert.Equal(8, summaries[0].Values["Value"].Max);
+            Assert.Equal(400, summaries[0].Values["Latency"].Sum);
+            Assert.Equal(Day.AddHours(2), summaries[1].BucketStart);
+            Assert.Equal(1, summaries[1].Count);
+        }
+
+        [Fact]
+        public void TimeSeriesIndex_HandlesOutOfOrderInsertsUpdatesAndDeletes()
+        {
+            var index = CreateIndex();
+            Add(index, "late", Day.AddMinutes(45), 5);
+            Add(index, "early", Day.AddMinutes(5), 2);
+            Add(index, "max", Day.AddMinutes(30), 9);
+            Add(index, "min", Day.AddMinutes(20), 1);
+
+            Assert.Equal(new[] { "early", "min", "max", "late" }, index.Range(Day, Day.AddHours(1)));
+
+            // Removing the extremes recomputes min and max from the remaining documents
+            index.Remove("max");
+            index.Remove("min");
+            var bucket = index.SummarizeRange(Day, Day.AddHours(1));
+            Assert.Equal(2, bucket.Count);
+            Assert.Equal(2, bucket.Values["Value"].Min);
+            Assert.Equal(5, bucket.Values["Value"].Max);
+            Assert.Equal(3.5, bucket.Values["Value"].Average);
+
+            // Updating a document moves it between buckets
+            Add(index, "late", Day.AddHours(3), 7);
+            Assert.Equal(new[] { "early" }, index.Range(Day, Day.AddHours(1)));
+            Assert.Equal(7, index.SummarizeRange(Day.AddHours(3), Day.AddHours(4)).Values["Value"].Max);
+            Assert.Equal(2, index.GetStatistics().EntryCount);
+
+            index.Remove("early");
+            Assert.Empty(index.Summarize(Day, Day.AddHours(1)));
+        }
+
+        [Fact]
+        public void TimeSeriesIndex_RollsUpIntervalsAndTrimsPartialBuckets()
+        {
+            var index = CreateIndex();
+            for (int minute = 0; minute < 48 * 60; minute += 15)
+            {
+                Add(index, $"r{minute}", Day.AddMinutes(minute), minute % 60);
+            }
+
+            var daily = index.Summarize(Day, Day.AddDays(2), TimeSpan.FromDays(1)).ToList();
+            Assert.Equal(2, daily.Count);
+            Assert.Equal(96, daily[0].Count);
+            Assert.Equal(Day.AddDays(1), daily[1].BucketStart);
+            Assert.Equal(22.5, daily[1].Values["Value"].Average);
+
+            // 00:30 to 02:15 cuts the first and last hour
+            var range = index.SummarizeRange(Day.AddMinutes(30), Day.AddHours(2).AddMinutes(15));
+            Assert.Equal(8, range.Count);
+            Assert.Equal(0, range.Values["Value"].Min);
+            Assert.Equal(45, range.Values["Value"].Max);
+
+            Assert.Equal(8, index.Count(new IndexRange { Lower = Day.AddMinutes(30), Upper = Day.AddHours(2).AddMinutes(15) }));
+            Assert.Equal(new[] { "r135", "r120" }, index.Seek(new IndexRange { Lower = Day.AddHours(2), Upper = Day.AddMinutes(135) }, descending: true));
+            Assert.Equal(new[] { "r2865" }, index.After(Day.AddMinutes(2850)));
+            Assert.Equal(new[] { "r0" }, index.Before(Day.AddMinutes(15)));
+
+            Assert.Throws<ArgumentException>(() => index.Summarize(Day, Day.AddDays(1), TimeSpan.FromMinutes(90)));
+        }
+
+        [Fact]
+        public void Query_WhereOnTimestampSeeksTimeSeriesIndex()
+        {
+            var tree = new Acorn<Reading>()
+                .InMemory()
+                .WithTimeSeries(r => r.Timestamp, cfg => cfg.BucketHours(1), r => r.Value)
+                .Sprout();
+            for (int i = 0; i < 200; i++)
+            {
+                tree.Stash(new Reading { Id = $"r{i:D3}", Timestamp = Day.AddMinutes(i * 30), Value = i });
+            }
+
+            var from = Day.AddHours(1);
+            var to = Day.AddHours(3);
+            var query = tree.Query().Where(r => r.Timestamp >= from && r.Timestamp < to);
+            var plan = query.Explain();
+
+            Assert.NotEqual(QueryStrategy.FullScan, plan.Strategy);
+            Assert.Equal("IX_Reading_Timestamp_TimeSeries", plan.SelectedIndex?.Name);
+            Assert.Equal(new[] { "r002", "r003", "r004", "r005" }, query.ToList().Select(r => r.Id).OrderBy(id => id));
+            Assert.Equal(4, query.Count());
+
+            tree.Toss("r003");
+            var index = tree.GetIndex("IX_Reading_Timestamp_TimeSeries") as ManagedTimeSeriesIndex<Reading>;
+            Assert.NotNull(index);
+            Assert.Equal(1, index!.SummarizeRange(Day.AddHours(1), Day.AddHours(2).AddTicks(-1)).Count);
+        }
+
+        [Fact]
+        public void Query_BetweenAfterBeforeUseStashTimeIndex()
+        {
+            var tree = new Acorn<Reading>()
+                .InMemory()
+                .WithStashTimeSeries(cfg => cfg.BucketMinutes(1), r => r.Latency)
+                .Sprout();
+
+            var start = DateTime.UtcNow.AddTicks(-1);
+            for (int i = 0; i < 100; i++)
+            {
+                tree.Stash(new Reading { Id = $"old{i}", Latency = 10 });
+            }
+            Thread.Sleep(20);
+            var middle = DateTime.UtcNow;
+            Thread.Sleep(20);
+            tree.Stash(new Reading { Id = "new", Latency = 30 });
+            var end = DateTime.UtcNow.AddTicks(1);
+
+            var after = tree.Query().After(middle);
+            var plan = after.Explain();
+            Assert.NotEqual(QueryStrategy.FullScan, plan.Strategy);
+            Assert.Equal("IX_Reading_StashTime_TimeSeries", plan.SelectedIndex?.Name);
+            Assert.Equal(new[] { "new" }, after.ToList().Select(r => r.Id));
+
+            Assert.Equal(100, tree.Query().Before(middle).Count());
+            Assert.Equal(101, tree.Query().Between(start, end).Count());
+            Assert.Empty(tree.Query().Between(end, end.AddHours(1)).ToList());
+
+            var index = (ManagedTimeSeriesIndex<Reading>)tree.GetIndex("IX_Reading_StashTime_TimeSeries")!;
+            Assert.True(index.IndexesStashTime);
+            var summary = index.SummarizeRange(start, end);
+            Assert.Equal(101, summary.Count);
+            Assert.Equal(30, summary.Values["Latency"].Max);
+
+            // A later Where narrows the time range instead of replacing it
+            Assert.Equal(0, tree.Query().After(middle).Where(r => r.Latency < 20).Count());
+            Assert.Equal(new[] { "new" }, tree.Query().Where(r => r.Latency > 20).After(middle).ToList().Select(r => r.Id));
+        }
+    }
+}
@@ -0,0 +1,232 @@
+using AcornDB.Cache;
+using AcornDB.Indexing;
+using AcornDB.Models;
+using AcornDB.Query;
+using AcornDB.Storage;
+
+namespace AcornDB.Test
+{
+    public class TreeConcurrencyTests
+    {
+        public class Doc
+        {
+            public string Id { get; set; } = string.Empty;
+            public string Owner { get; set; } = string.Empty;
+            public int Value { get; set; }
+        }
+
+        private static Tree<Doc> NewTree(ICacheStrategy<Doc>? strategy = null)
+        {
+            return NewTreeOver(new MemoryTrunk<Doc>(), strategy);
+        }
+
+        private static Tree<Doc> NewTreeOver(ITrunk<Doc> trunk, ICacheStrategy<Doc>? strategy = null)
+        {
+            var tree = new Tree<Doc>(trunk, strategy ?? new NoEvictionStrategy<Doc>());
+            tree.TtlEnforcementEnabled = false;
+            return tree;
+        }
+
+        /// <summary>
+        /// Run body(thread) on dedicated threads released together
+        /// </summary>
+        private static void RunConcurrently(int threadCount, Action<int> body)
+        {
+            using var start = new ManualResetEventSlim(false);
+            var errors = new List<Exception>();
+            var threads = Enumerable.Range(0, threadCount).Select(t => new Thread(() =>
+            {
+                start.Wait();
+                try
+                {
+                    body(t);
+                }
+                catch (Exception ex)
+                {
+                    lock (errors) errors.Add(ex);
+                }
+            })).ToList();
+
+            threads.ForEach(thread => thread.Start());
+            start.Set();
+            threads.ForEach(thread => thread.Join());
+
+            if (errors.Count > 0)
+                throw new AggregateException(errors);
+        }
+
+        [Fact]
+        public void ConcurrentStashes_OfDistinctIds_AreAllCachedAndCounted()
+        {
+            var tree = NewTree(new NoEvictionStrategy<Doc>());
+
+            RunConcurrently(16, t =>
+            {
+                for (int i = 0; i < 500; i++)
+                    tree.Stash(new Doc { Id = $"d{t}-{i}", Value = i });
+            });
+
+            Assert.Equal(8000, tree.NutCount);
+            Assert.Equal(8000, tree.Nuts.Count());
+            Assert.Equal(8000, tree.GetNutStats().TotalStashed);
+            Assert.Equal(8000, tree.GetCacheStats().CachedItemCount);
+        }
+
+        [Fact]
+        public void Nuts_CanBeEnumeratedWhileOtherThreadsWrite()
+        {
+            var tree = NewTree(new NoEvictionStrategy<Doc>());
+            for (int i = 0; i < 1000; i++)
+                tree.Stash(new Doc { Id = $"d{i}", Value = i });
+
+            RunConcurrently(8, t =>
+            {
+                for (int i = 0; i < 200; i++)
+                {
+                    if (t % 2 == 0)
+                    {
+                        tree.Stash(new Doc { Id = $"d{t}-{i}", Value = i });
+                        tree.Toss($"d{(t * 200 + i) % 1000}");
+                    }
+                    else
+                    {
+                        Assert.True(tree.Nuts.Count() > 0);
+                        Assert.NotNull(tree.NutShells().ToList());
+                        tree.Query().Where(d => d.Value > 500).ToList();
+                    }
+                }
+            });
+
+            Assert.Equal(tree.NutCount, tree.Nuts.Count());
+        }
+
+        [Fact]
+        public void ConcurrentStashAndToss_OfTheSameId_LeaveCacheTrunkAndIndexAgreeing()
+        {
+            var trunk = new MemoryTrunk<Doc>();
+            var tree = NewTreeOver(trunk);
+            var index = new ManagedScalarIndex<Doc, string>(d => d.Owner);
+            tree.AddIndex(index);
+
+            RunConcurrently(8, t =>
+            {
+                for (int i = 0; i < 300; i++)
+                {
+                    var id = $"k{i % 10}";
+                    if ((t + i) % 3 == 0)
+                        tree.Toss(id);
+                    else
+                        tree.Stash(new Doc { Id = id, Owner = $"owner-{t}", Value = i });
+                }
+            });
+
+            for (int k = 0; k < 10; k++)
+            {
+                var id = $"k{k}";
+                var cached = tree.Crack(id);
+                var stored = trunk.Crack(id);
+                Assert.Equal(stored?.Payload.Value, cached?.Value);
+
+                var indexedUnder = Enumerable.Range(0, 8)
+                    .Where(t => index.Lookup($"owner-{t}").Contains(id))
+                    .ToList();
+                if (cached == null)
+                    Assert.Empty(indexedUnder);
+                else
+                    Assert.Equal(new[] { int.Parse(cached.Owner["owner-".Length..]) }, indexedUnder);
+            }
+        }
+
+        [Fact]
+        public void StashRacingExpiryPurgeAndToss_LeavesCacheTrunkIndexAndExpiryAgreeing()
+        {
+            var trunk = new MemoryTrunk<Doc>();
+            var tree = NewTreeOver(trunk);
+            tree.TtlEnforcementEnabled = true;
+            var index = new ManagedScalarIndex<Doc, string>(d => d.Owner);
+            tree.AddIndex(index);
+
+            RunConcurrently(8, t =>
+            {
+                for (int i = 0; i < 300; i++)
+                {
+                    var id = $"k{i % 10}";
+                    switch ((t + i) % 4)
+                    {
+                        case 0:
+                            tree.Toss(id);
+                            break;
+                        case 1:
+                            tree.SetExpiration(id, DateTime.UtcNow.AddMinutes(-1));
+                            tree.CleanupExpiredNuts();
+                            break;
+                        default:
+                            tree.Stash(new Doc { Id = id, Owner = $"owner-{t}", Value = i });
+                            break;
+                    }
+                }
+            });
+
+            // Every deadline set above has passed: whatever still carries one must be purged now
+            tree.CleanupExpiredNuts();
+            Assert.DoesNotContain(tree.NutShells(), nut => nut.ExpiresAt.HasValue);
+            Assert.Empty(tree.GetExpiringNuts(TimeSpan.FromDays(1)));
+
+            for (int k = 0; k < 10; k++)
+            {
+                var id = $"k{k}";
+                var cached = tree.Crack(id);
+                var stored = trunk.Crack(id);
+                Assert.Equal(stored?.Payload.Value, cached?.Value);
+
+                var indexedUnder = Enumerable.Range(0, 8)
+                    .Where(t => index.Lookup($"owner-{t}").Contains(id))
+                    .ToList();
+                if (cached == null)
+                    Assert.Empty(indexedUnder);
+                else
+                    Assert.Equal(new[] { int.Parse(cached.Owner["owner-".Length..]) }, indexedUnder);
+            }
+        }
+
+        [Fact]
+        public void ConcurrentCracks_OfUncachedIds_FillTheCacheOnce()
+        {
+            var trunk = new MemoryTrunk<Doc>();
+            var lazy = NewTreeOver(trunk);
+
+            // Written behind the tree's back, so every first Crack misses
+            for (int i = 0; i < 100; i++)
+                trunk.Stash($"d{i}", new Nut<Doc> { Id = $"d{i}", Payload = new Doc { Id = $"d{i}", Value = i } });
+
+            RunConcurrently(8, _ =>
+            {
+                for (int i = 0; i < 100; i++)
+                    Assert.Equal(i, lazy.Crack($"d{i}")!.Value);
+            });
+
+            Assert.Equal(100, lazy.NutCount);
+            Assert.Equal(100, lazy.GetCacheStats().CachedItemCount);
+        }
+
+        [Fact]
+        public void Eviction_UnderConcurrentWrites_KeepsCacheWithinLimitAndStrategyInSync()
+        {
+            var strategy = new ShardedLRUCacheStrategy<Doc>(maxSize: 500);
+            var tree = NewTree(strategy);
+
+            RunConcurrently(8, t =>
+            {
+                for (int i = 0; i < 1000; i++)
+                {
+                    tree.Stash(new Doc { Id = $"d{t}-{i}", Value = i });
+                    tree.Crack($"d{t}-{i / 2}");
+                }
+            });
+
+            Assert.True(tree.NutCount <= 500, $"cache grew to {tree.NutCount}");
+            Assert.Equal(tree.NutCount, tree.Nuts.Count());
+            Assert.Equal(tree.NutCount, strategy.GetStats().TrackedItems);
+        }
+    }
+}
@@ -0,0 +1,148 @@
+using AcornDB.Query;
+using AcornDB.Storage;
+
+namespace AcornDB.Test
+{
+    public class TrunkScanPushdownTests
+    {
+        public class Reading
+        {
+            public string Id { get; set; } = string.Empty;
+            public double Value { get; set; }
+        }
+
+        /// <summary>
+        /// Prunes on timestamps only and records each filter, to show what the query pushed down
+        /// and that the query itself still decides the matches
+        /// </summary>
+        private class RecordingScanTrunk : MemoryTrunk<Reading>, IScanTrunk<Reading>
+        {
+            public List<TrunkScanFilter<Reading>> Filters { get; } = new();
+
+            public IEnumerable<Nut<Reading>> CrackWhere(TrunkScanFilter<Reading> filter)
+            {
+                Filters.Add(filter);
+                return CrackAll().Where(nut => filter.MatchesTimestamp(nut.Timestamp)).ToList();
+            }
+        }
+
+        private static readonly DateTime Start = new(2026, 1, 1, 0, 0, 0, DateTimeKind.Utc);
+
+        private static (Tree<Reading> tree, RecordingScanTrunk trunk) NewTree()
+        {
+            var trunk = new RecordingScanTrunk();
+            for (int i = 0; i < 10; i++)
+            {
+                trunk.Stash($"r{i}", new Nut<Reading>
+                {
+                    Id = $"r{i}",
+                    Payload = new Reading { Id = $"r{i}", Value = i },
+                    Timestamp = Start.AddHours(i)
+                });
+            }
+
+            var tree = new Tree<Reading>(trunk);
+            tree.TtlEnforcementEnabled = false;
+            return (tree, trunk);
+        }
+
+        [Fact]
+        public void TimeRange_IsPushedDownToScanTrunk()
+        {
+            var (tree, trunk) = NewTree();
+            Assert.True(tree.SupportsScanPushdown);
+
+            var ids = tree.Query().Between(Start.AddHours(2), Start.AddHours(5)).ToList().Select(r => r.Id).OrderBy(id => id);
+
+            Assert.Equal(new[] { "r2", "r3", "r4", "r5" }, ids);
+            var filter = Assert.Single(trunk.Filters);
+            Assert.Equal(Start.AddHours(2), filter.TimestampFrom);
+            Assert.Equal(Start.AddHours(5), filter.TimestampTo);
+        }
+
+        [Fact]
+        public void WhereAndKeyRange_AreReappliedOverTrunkResults()
+        {
+            var (tree, trunk) = NewTree();
+
+            // The trunk ignores both conditions, so everything it returns is re-filtered
+            var values = tree.Query().Where(r => r.Value >= 5).ToList().Select(r => r.Value).OrderBy(v => v);
+            var ids = tree.Query().KeyRange("r3", "r6").ToList().Select(r => r.Id);
+
+            Assert.Equal(new double[] { 5, 6, 7, 8, 9 }, values);
+            Assert.Equal(new[] { "r3", "r4", "r5" }, ids);
+            Assert.NotNull(trunk.Filters[0].Where);
+            Assert.Equal("r3", trunk.Filters[1].KeyFrom);
+        }
+
+        [Fact]
+        public void ChainedFilters_AreAllApplied()
+        {
+            var (tree, trunk) = NewTree();
+
+            var whereThenAfter = tree.Query().Where(r => r.Value % 2 == 0).After(Start.AddHours(3))
+                .ToList().Select(r => r.Id).OrderBy(id => id);
+            var afterThenWhere = tree.Query().After(Start.AddHours(3)).Where(r => r.Value % 2 == 0)
+                .ToList().Select(r => r.Id).OrderBy(id => id);
+            var nutThenBefore = tree.Query().WhereNut(nut => nut.Id != "r1").Before(Start.AddHours(3))
+                .ToList().Select(r => r.Id).OrderBy(id => id);
+
+            Assert.Equal(new[] { "r4", "r6", "r8" }, whereThenAfter);
+            Assert.Equal(new[] { "r4", "r6", "r8" }, afterThenWhere);
+            Assert.Equal(new[] { "r0", "r2" }, nutThenBefore);
+
+            // Both halves reach the trunk
+            Assert.NotNull(trunk.Filters[0].Where);
+            Assert.Equal(Start.AddHours(3), trunk.Filters[0].TimestampFrom);
+        }
+
+        [Fact]
+        public void RepeatedWhereCalls_AreAndedLikeLinq()
+        {
+            var (tree, _) = NewTree();
+
+            var values = tree.Query().Where(r => r.Value >= 3).Where(r => r.Value % 2 == 0)
+                .ToList().Select(r => r.Value).OrderBy(v => v);
+            var ids = tree.Query().WhereNut(nut => nut.Id != "r2").WhereNut(nut => nut.Timestamp < Start.AddHours(4))
+                .ToList().Select(r => r.Id).OrderBy(id => id);
+
+            Assert.Equal(new double[] { 4, 6, 8 }, values);
+            Assert.Equal(new[] { "r0", "r1", "r3" }, ids);
+            Assert.Equal(3, tree.Query().Where(r => r.Value >= 3).Where(r => r.Value % 2 == 0).Count());
+        }
+
+        [Fact]
+        public void UnfilteredQueries_DoNotScanTheTrunk()
+        {
+            var (tree, trunk) = NewTree();
+
+            Assert.Equal(10, tree.Query().Count());
+            Assert.Empty(trunk.Filters);
+            Assert.False(new Tree<Reading>(new MemoryTrunk<Reading>()).SupportsScanPushdown);
+        }
+
+        [Fact]
+        public void ScanFilter_RulesOutNonOverlappingStatistics()
+        {
+            var filter = new TrunkScanFilter<Reading>
+            {
+                TimestampFrom = Start,
+                TimestampFromInclusive = false,
+                TimestampTo = Start.AddDays(1),
+                KeyPrefix = "order-"
+            };
+
+            Assert.False(filter.OverlapsTimestamps(Start.AddDays(-1), Start));
+            Assert.True(filter.OverlapsTimestamps(Start.AddDays(-1), Start.AddTicks(1)));
+            Assert.True(filter.OverlapsTimestamps(Start.AddDays(1), Start.AddDays(2)));
+            Assert.False(filter.OverlapsTimestamps(Start.AddDays(1).AddTicks(1), Start.AddDays(2)));
+
+            Assert.True(filter.OverlapsKeys("invoice-1", "order-5"));
+            Assert.True(filter.OverlapsKeys("order-2", "zebra"));
+            Assert.False(filter.OverlapsKeys("a", "order"));
+            Assert.False(filter.OverlapsKeys("order.", "zebra"));
+            Assert.True(filter.MatchesKey("order-9"));
+            Assert.False(filter.MatchesKey("orders"));
+        }
+    }
+}
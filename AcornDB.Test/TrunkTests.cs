@@ -171,9 +171,9 @@ namespace AcornDB.Test
             }
 
             [Fact]
-            public void DocumentStoreTrunk_Uses_Compact_JSON_Format()
+            public void DocumentStoreTrunk_Uses_Binary_Log_Format()
             {
-                var path = GetUniquePath("compact-json");
+                var path = GetUniquePath("binary-log");
 
                 var trunk = new DocumentStoreTrunk<string>(path);
                 trunk.Save("test1", new Nut<string> { Id = "test1", Payload = "data1" });
@@ -181,23 +181,15 @@ namespace AcornDB.Test
                 trunk.Save("test3", new Nut<string> { Id = "test3", Payload = "data3" });
                 trunk.Dispose();
 
-                // Read log file and verify it's compact JSON (one line per entry)
-                var logPath = System.IO.Path.Combine(path, "changes.log");
-                var lines = System.IO.File.ReadAllLines(logPath);
+                // Records go to the binary log; no JSON-lines log is written
+                Assert.True(System.IO.File.Exists(System.IO.Path.Combine(path, "changes.bin")));
+                Assert.False(System.IO.File.Exists(System.IO.Path.Combine(path, "changes.log")));
 
-                // Should have 3 lines (one per save)
-                Assert.Equal(3, lines.Length);
-
-                // Each line should be valid JSON (no internal newlines)
-                foreach (var line in lines)
-                {
-                    Assert.DoesNotContain('\n', line);
-                    Assert.DoesNotContain('\r', line);
-
-                    // Should be parseable as JSON
-                    var parsed = Newtonsoft.Json.JsonConvert.DeserializeObject(line);
-                    Assert.NotNull(parsed);
-                }
+                // Should replay 3 records (one per save)
+                var reopened = new DocumentStoreTrunk<string>(path);
+                Assert.Equal(3, reopened.CrackAll().Count());
+                Assert.Equal(3, reopened.RecordsReplayedOnLoad);
+                reopened.Dispose();
             }
 
             [Fact]
@@ -0,0 +1,278 @@
+using AcornDB.Cache;
+using AcornDB.Storage;
+
+namespace AcornDB.Test
+{
+    public class WTinyLFUCacheStrategyTests
+    {
+        public class User
+        {
+            public string Id { get; set; } = string.Empty;
+            public string Name { get; set; } = string.Empty;
+        }
+
+        private static Nut<User> NutFor(string id) =>
+            new Nut<User> { Id = id, Payload = new User { Id = id, Name = id } };
+
+        [Fact]
+        public void WTinyLFU_InvalidArguments_Throw()
+        {
+            Assert.Throws<ArgumentException>(() => new WTinyLFUCacheStrategy<User>(maxSize: 0));
+            Assert.Throws<ArgumentException>(() => new WTinyLFUCacheStrategy<User>(maxSize: 10, windowPercentage: 0));
+            Assert.Throws<ArgumentException>(() => new WTinyLFUCacheStrategy<User>(maxSize: 10, windowPercentage: 1));
+        }
+
+        [Fact]
+        public void WTinyLFU_EstimateFrequency_CountsAccesses()
+        {
+            var strategy = new WTinyLFUCacheStrategy<User>(maxSize: 100);
+            strategy.OnStash("hot", NutFor("hot"));
+            for (int i = 0; i < 5; i++)
+            {
+                strategy.OnCrack("hot");
+            }
+            strategy.OnStash("cold", NutFor("cold"));
+
+            Assert.Equal(6, strategy.EstimateFrequency("hot"));
+            Assert.Equal(1, strategy.EstimateFrequency("cold"));
+            Assert.Equal(0, strategy.EstimateFrequency("never-seen"));
+        }
+
+        [Fact]
+        public void WTinyLFU_EvictsDownToMaxSize_AndStopsTrackingVictims()
+        {
+            var strategy = new WTinyLFUCacheStrategy<User>(maxSize: 10);
+            var cache = new Dictionary<string, Nut<User>>();
+
+            for (int i = 0; i < 15; i++)
+            {
+                var id = $"user{i}";
+                cache[id] = NutFor(id);
+                strategy.OnStash(id, cache[id]);
+            }
+
+            var candidates = strategy.GetEvictionCandidates(cache).ToList();
+            Assert.Equal(5, candidates.Count);
+            Assert.Equal(10, strategy.TrackedItemCount);
+
+            // Victims are already untracked, so the tree's OnToss calls are harmless
+            foreach (var id in candidates)
+            {
+                strategy.OnToss(id);
+            }
+            Assert.Equal(10, strategy.TrackedItemCount);
+        }
+
+        [Fact]
+        public void WTinyLFU_RejectsNewcomers_ColderThanResidents()
+        {
+            var strategy = new WTinyLFUCacheStrategy<User>(maxSize: 10);
+            var cache = new Dictionary<string, Nut<User>>();
+
+            // Nine hot items fill the main space once the first newcomer arrives
+            for (int i = 0; i < 9; i++)
+            {
+                var id = $"hot{i}";
+                cache[id] = NutFor(id);
+                strategy.OnStash(id, cache[id]);
+                strategy.OnCrack(id);
+                strategy.OnCrack(id);
+            }
+
+            for (int i = 0; i < 2; i++)
+            {
+                var id = $"scan{i}";
+                cache[id] = NutFor(id);
+                strategy.OnStash(id, cache[id]);
+            }
+
+            // scan0 leaves the window first and loses to every hot resident
+            var candidates = strategy.GetEvictionCandidates(cache).ToList();
+            Assert.Equal(new List<string> { "scan0" }, candidates);
+
+            var stats = strategy.GetStats();
+            Assert.Equal(1, stats.RejectedCount);
+            Assert.Equal(0, stats.AdmittedCount);
+        }
+
+        [Fact]
+        public void WTinyLFU_AdmitsNewcomers_HotterThanResidents()
+        {
+            var strategy = new WTinyLFUCacheStrategy<User>(maxSize: 10);
+            var cache = new Dictionary<string, Nut<User>>();
+
+            for (int i = 0; i < 9; i++)
+            {
+                var id = $"cold{i}";
+                cache[id] = NutFor(id);
+                strategy.OnStash(id, cache[id]);
+            }
+
+            // Seen often before it was ever cached (e.g. read through another tree)
+            for (int i = 0; i < 5; i++)
+            {
+                strategy.OnCrack("popular");
+            }
+            cache["popular"] = NutFor("popular");
+            strategy.OnStash("popular", cache["popular"]);
+            cache["next"] = NutFor("next");
+            strategy.OnStash("next", cache["next"]);
+
+            // popular leaves the window and displaces the oldest cold resident
+            var candidates = strategy.GetEvictionCandidates(cache).ToList();
+            Assert.Equal(new List<string> { "cold0" }, candidates);
+            Assert.Equal(1, strategy.GetStats().AdmittedCount);
+        }
+
+        [Fact]
+        public void WTinyLFU_TreeKeepsHotSet_ThroughSequentialScan()
+        {
+            var tree = new Tree<User>(new MemoryTrunk<User>(), new WTinyLFUCacheStrategy<User>(maxSize: 100));
+            tree.TtlEnforcementEnabled = false;
+            for (int i = 0; i < 2_000; i++)
+            {
+                tree.Stash($"user{i}", new User { Id = $"user{i}", Name = $"User {i}" });
+            }
+
+            // Build up frequency for a hot set that fits comfortably in the cache
+            for (int round = 0; round < 5; round++)
+            {
+                for (int i = 0; i < 50; i++)
+                {
+                    tree.Crack($"user{i}");
+                }
+            }
+
+            // One pass over everything else, like an export or a cold-branch sync, while the
+            // hot set keeps being read at a much lower rate
+            for (int i = 50; i < 2_000; i++)
+            {
+                tree.Crack($"user{i}");
+                if (i % 10 == 0)
+                    tree.Crack($"user{i / 10 % 50}");
+            }
+
+            Assert.True(tree.NutCount <= 100);
+
+            var before = tree.GetCacheStats();
+            for (int i = 0; i < 50; i++)
+            {
+                tree.Crack($"user{i}");
+            }
+            var after = tree.GetCacheStats();
+
+            Assert.Equal(50, after.HitCount - before.HitCount);
+            Assert.Equal(before.MissCount, after.MissCount);
+            Assert.True(after.RejectedCount > 0);
+        }
+
+        [Fact]
+        public void LRU_TreeLosesHotSet_ThroughSequentialScan()
+        {
+            var tree = new Tree<User>(new MemoryTrunk<User>(), new LRUCacheStrategy<User>(maxSize: 100));
+            tree.TtlEnforcementEnabled = false;
+            for (int i = 0; i < 2_000; i++)
+            {
+                tree.Stash($"user{i}", new User { Id = $"user{i}", Name = $"User {i}" });
+            }
+
+            for (int round = 0; round < 5; round++)
+            {
+                for (int i = 0; i < 50; i++)
+                {
+                    tree.Crack($"user{i}");
+                }
+            }
+            for (int i = 50; i < 2_000; i++)
+            {
+                tree.Crack($"user{i}");
+                if (i % 10 == 0)
+                    tree.Crack($"user{i / 10 % 50}");
+            }
+
+            var before = tree.GetCacheStats();
+            for (int i = 0; i < 50; i++)
+            {
+                tree.Crack($"user{i}");
+            }
+            var after = tree.GetCacheStats();
+
+            // Recency alone cannot tell the scan from the working set: only the few hot items
+            // read near the end of the scan are still cached
+            Assert.InRange(after.MissCount - before.MissCount, 40, 50);
+        }
+
+        [Fact]
+        public void WTinyLFU_Reset_ClearsTrackingAndCounters()
+        {
+            var strategy = new WTinyLFUCacheStrategy<User>(maxSize: 10);
+            for (int i = 0; i < 5; i++)
+            {
+                strategy.OnStash($"user{i}", NutFor($"user{i}"));
+                strategy.OnCrack($"user{i}");
+            }
+
+            strategy.Reset();
+
+            var stats = strategy.GetStats();
+            Assert.Equal(0, stats.TrackedItems);
+            Assert.Equal(0, stats.HitCount);
+            Assert.Equal(0, strategy.EstimateFrequency("user0"));
+        }
+
+        [Fact]
+        public void Acorn_WithWTinyLFUCache_UsesTinyLfuStrategy()
+        {
+            var tree = new AcornDB.Models.Acorn<User>()
+                .InMemory()
+                .WithWTinyLFUCache(maxSize: 25)
+                .Sprout();
+
+            var strategy = Assert.IsType<WTinyLFUCacheStrategy<User>>(tree.CacheStrategy);
+            Assert.Equal(25, strategy.MaxSize);
+        }
+
+        [Fact]
+        public void CachedTrunk_WTinyLFU_KeepsHotSet_AndReportsStats()
+        {
+            var backing = new MemoryTrunk<User>();
+            for (int i = 0; i < 1_000; i++)
+            {
+                backing.Stash($"user{i}", NutFor($"user{i}"));
+            }
+
+            var cached = new CachedTrunk<User>(backing, new CacheOptions
+            {
+                TimeToLive = null,
+                MaxCacheSize = 50,
+                EvictionPolicy = CacheEvictionPolicy.WTinyLFU
+            });
+
+            for (int round = 0; round < 5; round++)
+            {
+                for (int i = 0; i < 20; i++)
+                {
+                    cached.Crack($"user{i}");
+                }
+            }
+            for (int i = 20; i < 1_000; i++)
+            {
+                cached.Crack($"user{i}");
+                if (i % 10 == 0)
+                    cached.Crack($"user{i / 10 % 20}");
+            }
+
+            var before = cached.GetCacheStats();
+            for (int i = 0; i < 20; i++)
+            {
+                Assert.NotNull(cached.Crack($"user{i}"));
+            }
+            var after = cached.GetCacheStats();
+
+            Assert.True(after.CachedItemCount <= 50);
+            Assert.Equal(20, after.HitCount - before.HitCount);
+            Assert.True(after.RejectedCount > 0);
+            Assert.InRange(after.HitRate, 0.0, 1.0);
+        }
+    }
+}
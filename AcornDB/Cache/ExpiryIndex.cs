@@ -0,0 +1,154 @@
+using System;
+using System.Collections.Generic;
+using System.Threading;
+
+namespace AcornDB.Cache
+{
+    /// <summary>
+    /// Ids ordered by expiry deadline, so a TTL purge walks only the ids that are due instead of
+    /// every cached entry. Each id has at most one deadline; setting it again moves the id.
+    /// Thread-safe; every operation holds one short lock.
+    /// </summary>
+    internal sealed class ExpiryIndex
+    {
+        private readonly object _lock = new();
+        private readonly SortedSet<(long Ticks, string Id)> _byDeadline = new(DeadlineComparer.Instance);
+        private readonly Dictionary<string, long> _deadlines = new(StringComparer.Ordinal);
+        private int _count;
+
+        /// <summary>
+        /// Number of ids with a deadline (read without locking)
+        /// </summary>
+        public int Count => Volatile.Read(ref _count);
+
+        /// <summary>
+        /// Earliest deadline, or null when nothing is tracked
+        /// </summary>
+        public DateTime? NextDeadline
+        {
+            get
+            {
+                lock (_lock)
+                {
+                    return _byDeadline.Count > 0 ? new DateTime(_byDeadline.Min.Ticks, DateTimeKind.Utc) : null;
+                }
+            }
+        }
+
+        /// <summary>
+        /// Track id until expiresAt (UTC); null stops tracking it
+        /// </summary>
+        public void Set(string id, DateTime? expiresAt)
+        {
+            if (!expiresAt.HasValue)
+            {
+                Remove(id);
+                return;
+            }
+
+            var ticks = UtcTicks(expiresAt.Value);
+            lock (_lock)
+            {
+                if (_deadlines.TryGetValue(id, out var current))
+                {
+                    if (current == ticks)
+                        return;
+                    _byDeadline.Remove((current, id));
+                }
+                _deadlines[id] = ticks;
+                _byDeadline.Add((ticks, id));
+                Volatile.Write(ref _count, _deadlines.Count);
+            }
+        }
+
+        public bool Remove(string id)
+        {
+            // Most writes are to ids without a TTL; skip the lock while nothing is tracked
+            if (Count == 0)
+                return false;
+
+            lock (_lock)
+            {
+                if (!_deadlines.Remove(id, out var ticks))
+                    return false;
+                _byDeadline.Remove((ticks, id));
+                Volatile.Write(ref _count, _deadlines.Count);
+                return true;
+            }
+        }
+
+        /// <summary>
+        /// Remove and return the ids whose deadline is at or before now, earliest first
+        /// </summary>
+        public List<(string Id, DateTime Deadline)> TakeDue(DateTime now)
+        {
+            var due = new List<(string Id, DateTime Deadline)>();
+            if (Count == 0)
+                return due;
+
+            var nowTicks = UtcTicks(now);
+            lock (_lock)
+            {
+                while (_byDeadline.Count > 0 && _byDeadline.Min.Ticks <= nowTicks)
+                {
+                    var (ticks, id) = _byDeadline.Min;
+                    _byDeadline.Remove((ticks, id));
+                    _deadlines.Remove(id);
+                    due.Add((id, new DateTime(ticks, DateTimeKind.Utc)));
+                }
+                Volatile.Write(ref _count, _deadlines.Count);
+            }
+            return due;
+        }
+
+        /// <summary>
+        /// Ids whose deadline is at or before by, earliest first, without removing them
+        /// </summary>
+        public List<string> Due(DateTime by)
+        {
+            var due = new List<string>();
+            if (Count == 0)
+                return due;
+
+            var byTicks = UtcTicks(by);
+            lock (_lock)
+            {
+                // In-order enumeration stops at the first later deadline: O(log n + due)
+                foreach (var (ticks, id) in _byDeadline)
+                {
+                    if (ticks > byTicks)
+                        break;
+                    due.Add(id);
+                }
+            }
+            return due;
+        }
+
+        public void Clear()
+        {
+            lock (_lock)
+            {
+                _byDeadline.Clear();
+                _deadlines.Clear();
+                Volatile.Write(ref _count, 0);
+            }
+        }
+
+        // Unspecified times are taken as UTC, as the rest of the tree compares them with UtcNow
+        private static long UtcTicks(DateTime time)
+        {
+            return (time.Kind == DateTimeKind.Local ? time.ToUniversalTime() : time).Ticks;
+        }
+
+        private sealed class DeadlineComparer : IComparer<(long Ticks, string Id)>
+        {
+            public static readonly DeadlineComparer Instance = new();
+
+            public int Compare((long Ticks, string Id) x, (long Ticks, string Id) y)
+            {
+                var byTicks = x.Ticks.CompareTo(y.Ticks);
+                return byTicks != 0 ? byTicks : string.CompareOrdinal(x.Id, y.Id);
+            }
+        }
+    }
+}
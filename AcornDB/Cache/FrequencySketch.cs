@@ -0,0 +1,125 @@
+using System;
+
+namespace AcornDB.Cache
+{
+    /// <summary>
+    /// Count-min sketch used by W-TinyLFU to estimate how often a key has been seen.
+    /// Each key maps to four small saturating counters (capped at 15) that are updated
+    /// conservatively, and every counter is halved once the sample size is reached so that old
+    /// popularity fades.
+    /// Not thread-safe; callers hold their own lock.
+    /// </summary>
+    internal sealed class FrequencySketch
+    {
+        private const int Depth = 4;
+        private const byte MaxCount = 15;
+
+        private static readonly ulong[] Seeds =
+        {
+            0xc3a5c85c97cb3127UL,
+            0xb492b66fbe98f273UL,
+            0x9ae16a3b2f90404fUL,
+            0xcbf29ce484222325UL
+        };
+
+        private readonly byte[] _table;
+        private readonly int _mask;
+        private readonly int _sampleSize;
+        private int _additions;
+
+        /// <summary>
+        /// Number of times the counters have been halved
+        /// </summary>
+        public int ResetCount { get; private set; }
+
+        /// <param name="maximumSize">Cache capacity the sketch is sized for</param>
+        public FrequencySketch(int maximumSize)
+        {
+            // Sixteen counters per cached item keep collisions rare enough that a scan of cold
+            // keys does not inflate the estimates of the working set
+            var target = Math.Min((long)maximumSize * 16, 1 << 26);
+            var size = 256;
+            while (size < target)
+                size <<= 1;
+
+            _mask = size - 1;
+            _table = new byte[size];
+            _sampleSize = (int)Math.Min(int.MaxValue, 10L * Math.Max(maximumSize, 16));
+        }
+
+        /// <summary>
+        /// Estimated number of recent occurrences of the key (0-15)
+        /// </summary>
+        public int Frequency(string id)
+        {
+            var hash = Hash(id);
+            int min = MaxCount;
+            for (int row = 0; row < Depth; row++)
+            {
+                min = Math.Min(min, _table[IndexOf(hash, row)]);
+            }
+            return min;
+        }
+
+        /// <summary>
+        /// Record one occurrence of the key
+        /// </summary>
+        public void Increment(string id)
+        {
+            var hash = Hash(id);
+            Span<int> indexes = stackalloc int[Depth];
+            int min = MaxCount;
+            for (int row = 0; row < Depth; row++)
+            {
+                indexes[row] = IndexOf(hash, row);
+                min = Math.Min(min, _table[indexes[row]]);
+            }
+
+            if (min == MaxCount)
+                return;
+
+            // Conservative update: only the counters holding the current minimum grow, which
+            // keeps collisions from inflating keys that share some of their cells.
+            for (int row = 0; row < Depth; row++)
+            {
+                if (_table[indexes[row]] == min)
+                    _table[indexes[row]]++;
+            }
+
+            if (++_additions >= _sampleSize)
+                Halve();
+        }
+
+        /// <summary>
+        /// Forget all recorded occurrences
+        /// </summary>
+        public void Clear()
+        {
+            Array.Clear(_table);
+            _additions = 0;
+            ResetCount = 0;
+        }
+
+        private void Halve()
+        {
+            for (int i = 0; i < _table.Length; i++)
+            {
+                _table[i] >>= 1;
+            }
+            _additions /= 2;
+            ResetCount++;
+        }
+
+        private static uint Hash(string id)
+        {
+            return (uint)StringComparer.Ordinal.GetHashCode(id);
+        }
+
+        private int IndexOf(uint hash, int row)
+        {
+            var h = (hash + 1UL) * Seeds[row];
+            h ^= h >> 32;
+            return (int)(h & (uint)_mask);
+        }
+    }
+}
@@ -0,0 +1,305 @@
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Threading;
+
+namespace AcornDB.Cache
+{
+    /// <summary>
+    /// Sharded LRU cache eviction strategy for large caches.
+    /// Each shard keeps its entries in an intrusive doubly-linked list ordered by recency, so
+    /// stash, crack and toss are O(1) and an eviction pass costs O(k * shards) for k candidates
+    /// instead of sorting every tracked entry. Reads only touch their own shard, and a read that
+    /// finds its shard busy skips the recency update rather than waiting for the lock.
+    /// Recency across shards is compared by a strategy-wide access tick rather than by clock
+    /// time, which can tie or step backwards.
+    /// </summary>
+    public class ShardedLRUCacheStrategy<T> : ICacheStrategy<T>
+    {
+        private sealed class Node
+        {
+            public readonly string Id;
+            public DateTime LastAccess;
+            public long AccessTick;
+            public Node? Prev;
+            public Node? Next;
+
+            public Node(string id, DateTime lastAccess, long accessTick)
+            {
+                Id = id;
+                LastAccess = lastAccess;
+                AccessTick = accessTick;
+            }
+        }
+
+        private sealed class Shard
+        {
+            public readonly object Lock = new();
+            public readonly Dictionary<string, Node> Nodes = new();
+            public Node? Head; // most recently used
+            public Node? Tail; // least recently used
+
+            public void AddFirst(Node node)
+            {
+                node.Prev = null;
+                node.Next = Head;
+                if (Head != null)
+                    Head.Prev = node;
+                Head = node;
+                Tail ??= node;
+            }
+
+            public void Unlink(Node node)
+            {
+                if (node.Prev != null)
+                    node.Prev.Next = node.Next;
+                else
+                    Head = node.Next;
+
+                if (node.Next != null)
+                    node.Next.Prev = node.Prev;
+                else
+                    Tail = node.Prev;
+
+                node.Prev = null;
+                node.Next = null;
+            }
+
+            public void MoveToFront(Node node, DateTime now, long tick)
+            {
+                node.LastAccess = now;
+                node.AccessTick = tick;
+                if (Head == node)
+                    return;
+                Unlink(node);
+                AddFirst(node);
+            }
+
+            public void Remove(Node node)
+            {
+                Unlink(node);
+                Nodes.Remove(node.Id);
+            }
+        }
+
+        private readonly int _maxSize;
+        private readonly Shard[] _shards;
+        private readonly int _shardMask;
+
+        // Ticks are taken under the shard lock, so each shard's list stays in tick order
+        private long _accessClock;
+
+        /// <summary>
+        /// Gets the maximum cache size before eviction occurs
+        /// </summary>
+        public int MaxSize => _maxSize;
+
+        /// <summary>
+        /// Gets the number of shards the tracked entries are spread across
+        /// </summary>
+        public int ShardCount => _shards.Length;
+
+        /// <summary>
+        /// Gets the number of tracked items
+        /// </summary>
+        public int TrackedItemCount
+        {
+            get
+            {
+                int count = 0;
+                foreach (var shard in _shards)
+                {
+                    lock (shard.Lock)
+                    {
+                        count += shard.Nodes.Count;
+                    }
+                }
+                return count;
+            }
+        }
+
+        /// <summary>
+        /// Create a new sharded LRU cache strategy
+        /// </summary>
+        /// <param name="maxSize">Maximum number of items to keep in cache (default: 10,000)</param>
+        /// <param name="shardCount">Number of shards, rounded up to a power of two (default: one per processor, up to 64)</param>
+        public ShardedLRUCacheStrategy(int maxSize = 10_000, int shardCount = 0)
+        {
+            if (maxSize <= 0)
+                throw new ArgumentException("Max size must be greater than 0", nameof(maxSize));
+            if (shardCount < 0)
+                throw new ArgumentException("Shard count cannot be negative", nameof(shardCount));
+
+            _maxSize = maxSize;
+
+            var requested = shardCount == 0 ? Math.Min(Environment.ProcessorCount, 64) : shardCount;
+            var shards = 1;
+            while (shards < requested)
+                shards <<= 1;
+
+            _shards = new Shard[shards];
+            for (int i = 0; i < shards; i++)
+                _shards[i] = new Shard();
+            _shardMask = shards - 1;
+        }
+
+        private Shard ShardFor(string id)
+        {
+            return _shards[StringComparer.Ordinal.GetHashCode(id) & _shardMask];
+        }
+
+        public void OnStash(string id, Nut<T> nut)
+        {
+            var shard = ShardFor(id);
+            var now = DateTime.UtcNow;
+            lock (shard.Lock)
+            {
+                var tick = Interlocked.Increment(ref _accessClock);
+                if (shard.Nodes.TryGetValue(id, out var node))
+                {
+                    shard.MoveToFront(node, now, tick);
+                    return;
+                }
+
+                node = new Node(id, now, tick);
+                shard.Nodes[id] = node;
+                shard.AddFirst(node);
+            }
+        }
+
+        public void OnCrack(string id)
+        {
+            var shard = ShardFor(id);
+            if (!Monitor.TryEnter(shard.Lock))
+                return; // contended: losing one recency update is cheaper than queueing the read
+
+            try
+            {
+                if (shard.Nodes.TryGetValue(id, out var node))
+                    shard.MoveToFront(node, DateTime.UtcNow, Interlocked.Increment(ref _accessClock));
+            }
+            finally
+            {
+                Monitor.Exit(shard.Lock);
+            }
+        }
+
+        public void OnToss(string id)
+        {
+            var shard = ShardFor(id);
+            lock (shard.Lock)
+            {
+                if (shard.Nodes.TryGetValue(id, out var node))
+                    shard.Remove(node);
+            }
+        }
+
+        public IEnumerable<string> GetEvictionCandidates(IDictionary<string, Nut<T>> currentCache)
+        {
+            // If we're under the limit, no eviction needed
+            if (currentCache.Count <= _maxSize)
+                return Enumerable.Empty<string>();
+
+            // Calculate how many items to evict (20% buffer to reduce eviction frequency)
+            int targetSize = (int)(_maxSize * 0.8);
+            int itemsToEvict = currentCache.Count - targetSize;
+            var candidates = new List<string>(itemsToEvict);
+
+            // Merge the shard tails: repeatedly take the older of the shard cursors, walking
+            // each list from its least recently used end. Lists are not modified here; the
+            // tree calls OnToss for every evicted id.
+            var cursors = new Node?[_shards.Length];
+            for (int i = 0; i < _shards.Length; i++)
+                Monitor.Enter(_shards[i].Lock);
+            try
+            {
+                for (int i = 0; i < _shards.Length; i++)
+                    cursors[i] = _shards[i].Tail;
+
+                while (candidates.Count < itemsToEvict)
+                {
+                    int oldest = -1;
+                    for (int i = 0; i < cursors.Length; i++)
+                    {
+                        var cursor = cursors[i];
+                        if (cursor != null && (oldest < 0 || cursor.AccessTick < cursors[oldest]!.AccessTick))
+                            oldest = i;
+                    }
+
+                    if (oldest < 0)
+                        break;
+
+                    var node = cursors[oldest]!;
+                    cursors[oldest] = node.Prev;
+
+                    // Only evict items that are actually in the cache
+                    if (currentCache.ContainsKey(node.Id))
+                        candidates.Add(node.Id);
+                }
+            }
+            finally
+            {
+                for (int i = _shards.Length - 1; i >= 0; i--)
+                    Monitor.Exit(_shards[i].Lock);
+            }
+
+            return candidates;
+        }
+
+        public void Reset()
+        {
+            foreach (var shard in _shards)
+            {
+                lock (shard.Lock)
+                {
+                    shard.Nodes.Clear();
+                    shard.Head = null;
+                    shard.Tail = null;
+                }
+            }
+        }
+
+        /// <summary>
+        /// Get the last access time for a specific item
+        /// </summary>
+        public DateTime? GetLastAccessTime(string id)
+        {
+            var shard = ShardFor(id);
+            lock (shard.Lock)
+            {
+                return shard.Nodes.TryGetValue(id, out var node) ? node.LastAccess : null;
+            }
+        }
+
+        /// <summary>
+        /// Get statistics about the LRU cache
+        /// </summary>
+        public LRUCacheStats GetStats()
+        {
+            int tracked = 0;
+            DateTime? oldest = null;
+            DateTime? newest = null;
+
+            foreach (var shard in _shards)
+            {
+                lock (shard.Lock)
+                {
+                    tracked += shard.Nodes.Count;
+                    if (shard.Tail != null && (oldest == null || shard.Tail.LastAccess < oldest))
+                        oldest = shard.Tail.LastAccess;
+                    if (shard.Head != null && (newest == null || shard.Head.LastAccess > newest))
+                        newest = shard.Head.LastAccess;
+                }
+            }
+
+            return new LRUCacheStats
+            {
+                TrackedItems = tracked,
+                MaxSize = _maxSize,
+                OldestAccessTime = oldest,
+                NewestAccessTime = newest,
+                UtilizationPercentage = (tracked * 100.0) / _maxSize
+            };
+        }
+    }
+}
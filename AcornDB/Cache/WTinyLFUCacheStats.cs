@@ -0,0 +1,22 @@
+using System;
+
+namespace AcornDB.Cache
+{
+    /// <summary>
+    /// Statistics for W-TinyLFU cache strategy
+    /// </summary>
+    public class WTinyLFUCacheStats
+    {
+        public int TrackedItems { get; set; }
+        public int MaxSize { get; set; }
+        public int WindowItems { get; set; }
+        public int ProbationItems { get; set; }
+        public int ProtectedItems { get; set; }
+        public long HitCount { get; set; }
+        public long AdmittedCount { get; set; }
+        public long RejectedCount { get; set; }
+        public long EvictedCount { get; set; }
+        public int SketchResets { get; set; }
+        public double UtilizationPercentage { get; set; }
+    }
+}
@@ -0,0 +1,373 @@
+using System;
+using System.Collections.Generic;
+
+namespace AcornDB.Cache
+{
+    /// <summary>
+    /// W-TinyLFU (Window Tiny Least Frequently Used) cache eviction strategy.
+    /// New items enter a small LRU window; the rest of the cache is a segmented LRU split into
+    /// probation and protected space. When the cache must shrink, the window's oldest item has to
+    /// beat the main space's next victim on estimated access frequency (a count-min sketch) to be
+    /// admitted, so a one-off scan or export cannot push a frequently read working set out.
+    /// </summary>
+    public class WTinyLFUCacheStrategy<T> : ICacheStrategy<T>
+    {
+        private enum Segment : byte
+        {
+            Window,
+            Probation,
+            Protected
+        }
+
+        private sealed class Node
+        {
+            public readonly string Id;
+            public Segment Segment;
+            public Node? Prev;
+            public Node? Next;
+
+            public Node(string id, Segment segment)
+            {
+                Id = id;
+                Segment = segment;
+            }
+        }
+
+        private sealed class NodeList
+        {
+            public Node? Head; // most recently used
+            public Node? Tail; // least recently used
+            public int Count;
+
+            public void AddFirst(Node node)
+            {
+                node.Prev = null;
+                node.Next = Head;
+                if (Head != null)
+                    Head.Prev = node;
+                Head = node;
+                Tail ??= node;
+                Count++;
+            }
+
+            public void Remove(Node node)
+            {
+                if (node.Prev != null)
+                    node.Prev.Next = node.Next;
+                else
+                    Head = node.Next;
+
+                if (node.Next != null)
+                    node.Next.Prev = node.Prev;
+                else
+                    Tail = node.Prev;
+
+                node.Prev = null;
+                node.Next = null;
+                Count--;
+            }
+
+            public void MoveToFront(Node node)
+            {
+                if (Head == node)
+                    return;
+                Remove(node);
+                AddFirst(node);
+            }
+
+            public void Clear()
+            {
+                Head = null;
+                Tail = null;
+                Count = 0;
+            }
+        }
+
+        private readonly int _maxSize;
+        private readonly int _windowCapacity;
+        private readonly int _mainCapacity;
+        private readonly int _protectedCapacity;
+        private readonly Dictionary<string, Node> _nodes = new();
+        private readonly NodeList _window = new();
+        private readonly NodeList _probation = new();
+        private readonly NodeList _protected = new();
+        private readonly FrequencySketch _sketch;
+        private readonly object _lock = new();
+
+        private long _hits;
+        private long _admitted;
+        private long _rejected;
+        private long _evicted;
+
+        /// <summary>
+        /// Gets the maximum cache size before eviction occurs
+        /// </summary>
+        public int MaxSize => _maxSize;
+
+        /// <summary>
+        /// Gets the number of items the admission window holds before its oldest entry has to
+        /// compete for main space
+        /// </summary>
+        public int WindowCapacity => _windowCapacity;
+
+        /// <summary>
+        /// Gets the number of tracked items
+        /// </summary>
+        public int TrackedItemCount
+        {
+            get
+            {
+                lock (_lock)
+                {
+                    return _nodes.Count;
+                }
+            }
+        }
+
+        /// <summary>
+        /// Create a new W-TinyLFU cache strategy
+        /// </summary>
+        /// <param name="maxSize">Maximum number of items to keep in cache (default: 10,000)</param>
+        /// <param name="windowPercentage">Share of the cache used as the admission window (default: 1%)</param>
+        public WTinyLFUCacheStrategy(int maxSize = 10_000, double windowPercentage = 0.01)
+        {
+            if (maxSize <= 0)
+                throw new ArgumentException("Max size must be greater than 0", nameof(maxSize));
+            if (windowPercentage <= 0 || windowPercentage >= 1)
+                throw new ArgumentException("Window percentage must be between 0 and 1", nameof(windowPercentage));
+
+            _maxSize = maxSize;
+            _windowCapacity = Math.Max(1, (int)(maxSize * windowPercentage));
+            _mainCapacity = Math.Max(0, maxSize - _windowCapacity);
+            _protectedCapacity = (int)(_mainCapacity * 0.8);
+            _sketch = new FrequencySketch(maxSize);
+        }
+
+        private int MainCount => _probation.Count + _protected.Count;
+
+        public void OnStash(string id, Nut<T> nut)
+        {
+            lock (_lock)
+            {
+                _sketch.Increment(id);
+
+                if (_nodes.TryGetValue(id, out var node))
+                {
+                    OnAccess(node);
+                    return;
+                }
+
+                node = new Node(id, Segment.Window);
+                _nodes[id] = node;
+                _window.AddFirst(node);
+
+                // While main space has room the window simply spills into probation; once it is
+                // full, overflow waits at the window tail and competes when the cache shrinks.
+                while (_window.Count > _windowCapacity && MainCount < _mainCapacity)
+                {
+                    var spill = _window.Tail!;
+                    _window.Remove(spill);
+                    spill.Segment = Segment.Probation;
+                    _probation.AddFirst(spill);
+                }
+            }
+        }
+
+        public void OnCrack(string id)
+        {
+            lock (_lock)
+            {
+                _sketch.Increment(id);
+
+                if (_nodes.TryGetValue(id, out var node))
+                {
+                    _hits++;
+                    OnAccess(node);
+                }
+            }
+        }
+
+        public void OnToss(string id)
+        {
+            lock (_lock)
+            {
+                if (_nodes.Remove(id, out var node))
+                    ListFor(node.Segment).Remove(node);
+            }
+        }
+
+        public IEnumerable<string> GetEvictionCandidates(IDictionary<string, Nut<T>> currentCache)
+        {
+            return SelectVictims(currentCache.Count, currentCache.ContainsKey);
+        }
+
+        /// <summary>
+        /// Choose the items to drop so that <paramref name="residentCount"/> fits in
+        /// <see cref="MaxSize"/>. Victims stop being tracked immediately; tracked ids for which
+        /// <paramref name="isResident"/> is false are dropped without counting toward the total.
+        /// </summary>
+        /// <param name="residentCount">Number of items currently held by the cache</param>
+        /// <param name="isResident">Whether an id is still held by the cache</param>
+        /// <returns>IDs to remove from the cache</returns>
+        public IReadOnlyList<string> SelectVictims(int residentCount, Func<string, bool> isResident)
+        {
+            if (residentCount <= _maxSize)
+                return Array.Empty<string>();
+
+            var victims = new List<string>(residentCount - _maxSize);
+            lock (_lock)
+            {
+                while (residentCount - victims.Count > _maxSize)
+                {
+                    var victim = NextVictim();
+                    if (victim == null)
+                        break;
+
+                    if (isResident(victim.Id))
+                    {
+                        victims.Add(victim.Id);
+                        _evicted++;
+                    }
+                }
+            }
+
+            return victims;
+        }
+
+        public void Reset()
+        {
+            lock (_lock)
+            {
+                _nodes.Clear();
+                _window.Clear();
+                _probation.Clear();
+                _protected.Clear();
+                _sketch.Clear();
+                _hits = 0;
+                _admitted = 0;
+                _rejected = 0;
+                _evicted = 0;
+            }
+        }
+
+        /// <summary>
+        /// Get the estimated recent access frequency of an item (0-15)
+        /// </summary>
+        public int EstimateFrequency(string id)
+        {
+            lock (_lock)
+            {
+                return _sketch.Frequency(id);
+            }
+        }
+
+        /// <summary>
+        /// Get statistics about the W-TinyLFU cache
+        /// </summary>
+        public WTinyLFUCacheStats GetStats()
+        {
+            lock (_lock)
+            {
+                return new WTinyLFUCacheStats
+                {
+                    TrackedItems = _nodes.Count,
+                    MaxSize = _maxSize,
+                    WindowItems = _window.Count,
+                    ProbationItems = _probation.Count,
+                    ProtectedItems = _protected.Count,
+                    HitCount = _hits,
+                    AdmittedCount = _admitted,
+                    RejectedCount = _rejected,
+                    EvictedCount = _evicted,
+                    SketchResets = _sketch.ResetCount,
+                    UtilizationPercentage = (_nodes.Count * 100.0) / _maxSize
+                };
+            }
+        }
+
+        private NodeList ListFor(Segment segment) => segment switch
+        {
+            Segment.Window => _window,
+            Segment.Probation => _probation,
+            _ => _protected
+        };
+
+        private void OnAccess(Node node)
+        {
+            switch (node.Segment)
+            {
+                case Segment.Window:
+                    _window.MoveToFront(node);
+                    break;
+
+                case Segment.Probation:
+                    // A second hit in main space promotes to protected; protected overflow is
+                    // demoted back to probation rather than evicted outright.
+                    _probation.Remove(node);
+                    node.Segment = Segment.Protected;
+                    _protected.AddFirst(node);
+                    if (_protected.Count > _protectedCapacity)
+                    {
+                        var demoted = _protected.Tail!;
+                        _protected.Remove(demoted);
+                        demoted.Segment = Segment.Probation;
+                        _probation.AddFirst(demoted);
+                    }
+                    break;
+
+                case Segment.Protected:
+                    _protected.MoveToFront(node);
+                    break;
+            }
+        }
+
+        private Node? NextVictim()
+        {
+            while (true)
+            {
+                var candidate = _window.Tail;
+                if (candidate != null && (_window.Count > _windowCapacity || MainCount == 0))
+                {
+                    _window.Remove(candidate);
+
+                    if (MainCount < _mainCapacity)
+                    {
+                        // Main space has room (items were tossed): admit without a contest
+                        candidate.Segment = Segment.Probation;
+                        _probation.AddFirst(candidate);
+                        continue;
+                    }
+
+                    var victim = _probation.Tail ?? _protected.Tail;
+                    if (victim == null)
+                    {
+                        _nodes.Remove(candidate.Id);
+                        return candidate;
+                    }
+
+                    if (_sketch.Frequency(candidate.Id) > _sketch.Frequency(victim.Id))
+                    {
+                        candidate.Segment = Segment.Probation;
+                        _probation.AddFirst(candidate);
+                        ListFor(victim.Segment).Remove(victim);
+                        _nodes.Remove(victim.Id);
+                        _admitted++;
+                        return victim;
+                    }
+
+                    _nodes.Remove(candidate.Id);
+                    _rejected++;
+                    return candidate;
+                }
+
+                var tail = _probation.Tail ?? _protected.Tail ?? _window.Tail;
+                if (tail == null)
+                    return null;
+
+                ListFor(tail.Segment).Remove(tail);
+                _nodes.Remove(tail.Id);
+                return tail;
+            }
+        }
+    }
+}
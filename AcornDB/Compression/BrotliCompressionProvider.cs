@@ -1,3 +1,5 @@
+using System;
+using System.Buffers;
 using System.IO;
 using System.IO.Compression;
 
@@ -9,6 +11,8 @@ namespace AcornDB.Compression
     /// </summary>
     public class BrotliCompressionProvider : ICompressionProvider
     {
+        private const int WINDOW_BITS = 22;
+
         private readonly CompressionLevel _compressionLevel;
 
         public bool IsEnabled => true;
@@ -54,5 +58,47 @@ namespace AcornDB.Compression
             brotliStream.CopyTo(outputStream);
             return outputStream.ToArray();
         }
+
+        public void Compress(ReadOnlySpan<byte> data, IBufferWriter<byte> output)
+        {
+            if (data.IsEmpty)
+                return;
+
+            // One-shot encode straight into the output; the bound covers incompressible input
+            var destination = output.GetSpan(BrotliEncoder.GetMaxCompressedLength(data.Length));
+            if (!BrotliEncoder.TryCompress(data, destination, out int written, Quality, WINDOW_BITS))
+                throw new InvalidOperationException("Brotli compression did not fit its maximum compressed length");
+            output.Advance(written);
+        }
+
+        public void Decompress(ReadOnlySpan<byte> compressedData, IBufferWriter<byte> output)
+        {
+            if (compressedData.IsEmpty)
+                return;
+
+            using var decoder = new BrotliDecoder();
+            var source = compressedData;
+            while (true)
+            {
+                var status = decoder.Decompress(source, output.GetSpan(Math.Max(4096, source.Length * 4)),
+                    out int consumed, out int written);
+                output.Advance(written);
+                source = source.Slice(consumed);
+
+                if (status == OperationStatus.Done)
+                    return;
+                if (status != OperationStatus.DestinationTooSmall)
+                    throw new InvalidDataException($"Brotli stream is truncated or invalid ({status})");
+            }
+        }
+
+        // Matches what BrotliStream uses for each CompressionLevel
+        private int Quality => _compressionLevel switch
+        {
+            CompressionLevel.NoCompression => 0,
+            CompressionLevel.Fastest => 1,
+            CompressionLevel.SmallestSize => 11,
+            _ => 4
+        };
     }
 }
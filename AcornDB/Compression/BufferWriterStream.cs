@@ -0,0 +1,48 @@
+using System;
+using System.Buffers;
+using System.IO;
+
+namespace AcornDB.Compression
+{
+    /// <summary>
+    /// Write-only stream that forwards to an IBufferWriter&lt;byte&gt;, so stream-based
+    /// encoders (GZipStream) can write straight into a pooled buffer.
+    /// </summary>
+    internal sealed class BufferWriterStream : Stream
+    {
+        private readonly IBufferWriter<byte> _output;
+
+        public BufferWriterStream(IBufferWriter<byte> output)
+        {
+            _output = output;
+        }
+
+        public override bool CanRead => false;
+        public override bool CanSeek => false;
+        public override bool CanWrite => true;
+        public override long Length => throw new NotSupportedException();
+        public override long Position
+        {
+            get => throw new NotSupportedException();
+            set => throw new NotSupportedException();
+        }
+
+        public override void Write(byte[] buffer, int offset, int count) => Write(buffer.AsSpan(offset, count));
+
+        public override void Write(ReadOnlySpan<byte> buffer) => _output.Write(buffer);
+
+        public override void WriteByte(byte value)
+        {
+            _output.GetSpan(1)[0] = value;
+            _output.Advance(1);
+        }
+
+        public override void Flush()
+        {
+        }
+
+        public override int Read(byte[] buffer, int offset, int count) => throw new NotSupportedException();
+        public override long Seek(long offset, SeekOrigin origin) => throw new NotSupportedException();
+        public override void SetLength(long value) => throw new NotSupportedException();
+    }
+}
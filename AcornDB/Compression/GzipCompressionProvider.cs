@@ -1,4 +1,5 @@
 using System;
+using System.Buffers;
 using System.IO;
 using System.IO.Compression;
 
@@ -55,5 +56,41 @@ namespace AcornDB.Compression
             gzipStream.CopyTo(outputStream);
             return outputStream.ToArray();
         }
+
+        public void Compress(ReadOnlySpan<byte> data, IBufferWriter<byte> output)
+        {
+            if (data.IsEmpty)
+                return;
+
+            using var gzipStream = new GZipStream(new BufferWriterStream(output), _compressionLevel);
+            gzipStream.Write(data);
+        }
+
+        public void Decompress(ReadOnlySpan<byte> compressedData, IBufferWriter<byte> output)
+        {
+            if (compressedData.IsEmpty)
+                return;
+
+            // GZipStream only reads from streams; a pooled copy stands in for the span
+            var rented = ArrayPool<byte>.Shared.Rent(compressedData.Length);
+            try
+            {
+                compressedData.CopyTo(rented);
+                using var inputStream = new MemoryStream(rented, 0, compressedData.Length, writable: false);
+                using var gzipStream = new GZipStream(inputStream, CompressionMode.Decompress);
+
+                int read;
+                do
+                {
+                    read = gzipStream.Read(output.GetSpan(Math.Max(4096, compressedData.Length)));
+                    output.Advance(read);
+                }
+                while (read > 0);
+            }
+            finally
+            {
+                ArrayPool<byte>.Shared.Return(rented);
+            }
+        }
     }
 }
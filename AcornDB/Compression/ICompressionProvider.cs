@@ -1,4 +1,5 @@
 using System;
+using System.Buffers;
 
 namespace AcornDB.Compression
 {
@@ -17,6 +18,24 @@ namespace AcornDB.Compression
         /// </summary>
         byte[] Decompress(byte[] compressedData);
 
+        /// <summary>
+        /// Compress data into <paramref name="output"/> without an intermediate array.
+        /// Default: adapts to <see cref="Compress(byte[])"/>.
+        /// </summary>
+        void Compress(ReadOnlySpan<byte> data, IBufferWriter<byte> output)
+        {
+            output.Write(Compress(data.ToArray()));
+        }
+
+        /// <summary>
+        /// Decompress data into <paramref name="output"/> without an intermediate array.
+        /// Default: adapts to <see cref="Decompress(byte[])"/>.
+        /// </summary>
+        void Decompress(ReadOnlySpan<byte> compressedData, IBufferWriter<byte> output)
+        {
+            output.Write(Decompress(compressedData.ToArray()));
+        }
+
         /// <summary>
         /// Check if this provider is enabled
         /// </summary>
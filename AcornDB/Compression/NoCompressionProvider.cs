@@ -1,3 +1,6 @@
+using System;
+using System.Buffers;
+
 namespace AcornDB.Compression
 {
     /// <summary>
@@ -10,5 +13,7 @@ namespace AcornDB.Compression
 
         public byte[] Compress(byte[] data) => data;
         public byte[] Decompress(byte[] compressedData) => compressedData;
+        public void Compress(ReadOnlySpan<byte> data, IBufferWriter<byte> output) => output.Write(data);
+        public void Decompress(ReadOnlySpan<byte> compressedData, IBufferWriter<byte> output) => output.Write(compressedData);
     }
 }
@@ -7,9 +7,10 @@ namespace AcornDB
 {
     /// <summary>
     /// Extension methods for adding indexes to Acorn builder and Trees.
-    /// Note: Advanced index methods (composite, computed, text, time-series, TTL) are experimental
+    /// Note: Advanced index methods (composite, computed, TTL) are experimental
     /// and not yet implemented. They will throw NotImplementedException until v0.6.0+.
-    /// Only WithIndex (scalar indexes) is production-ready.
+    /// WithIndex (scalar), WithTextIndex (full-text) and WithTimeSeries / WithStashTimeSeries
+    /// (time-series) indexes are production-ready.
     /// </summary>
     [Experimental("Advanced index types are planned for v0.6.0+. Only scalar indexes (WithIndex) are currently implemented.", "v0.6.0")]
     public static class IndexExtensions
@@ -93,7 +94,6 @@ namespace AcornDB
         /// <param name="textSelector">Expression selecting the text property to index</param>
         /// <param name="configure">Optional configuration for the index</param>
         /// <returns>Acorn builder for chaining</returns>
-        /// <exception cref="NotImplementedException">This feature is not yet implemented. Planned for v0.6.0 (Phase 4.3-4.4)</exception>
         public static Acorn<T> WithTextIndex<T>(
             this Acorn<T> acorn,
             Expression<Func<T, string>> textSelector,
@@ -102,30 +102,58 @@ namespace AcornDB
             var config = new IndexConfiguration();
             configure?.Invoke(config);
 
-            // Text index implementation will come in 0.6
-            throw new NotImplementedException("Text indexes will be implemented in 0.6");
+            var index = new ManagedTextIndex<T>(textSelector, config);
+            acorn.AddIndex(index);
+
+            return acorn;
         }
 
         /// <summary>
         /// Add a time-series index with bucketing.
-        /// Example: tree.WithTimeSeries(e => e.Timestamp, cfg => cfg.BucketHours(1))
+        /// Example: tree.WithTimeSeries(e => e.Timestamp, cfg => cfg.BucketHours(1), e => e.Value)
         /// </summary>
         /// <typeparam name="T">Document type</typeparam>
         /// <param name="acorn">Acorn builder</param>
         /// <param name="timestampSelector">Expression selecting the timestamp property</param>
         /// <param name="configure">Configuration for bucket size and aggregation</param>
+        /// <param name="valueSelectors">Numeric fields to keep running count/sum/min/max for per bucket</param>
         /// <returns>Acorn builder for chaining</returns>
-        /// <exception cref="NotImplementedException">This feature is not yet implemented. Planned for v0.6.0 (Phase 4.5)</exception>
         public static Acorn<T> WithTimeSeries<T>(
             this Acorn<T> acorn,
             Expression<Func<T, DateTime>> timestampSelector,
-            Action<IndexConfiguration> configure) where T : class
+            Action<IndexConfiguration> configure,
+            params Expression<Func<T, double>>[] valueSelectors) where T : class
+        {
+            var config = new IndexConfiguration();
+            configure(config);
+
+            var index = new ManagedTimeSeriesIndex<T>(timestampSelector, config, valueSelectors);
+            acorn.AddIndex(index);
+
+            return acorn;
+        }
+
+        /// <summary>
+        /// Add a time-series index on when nuts were stashed, so TreeQuery.Between/After/Before
+        /// are answered from buckets.
+        /// Example: tree.WithStashTimeSeries(cfg => cfg.BucketMinutes(5), e => e.LatencyMs)
+        /// </summary>
+        /// <typeparam name="T">Document type</typeparam>
+        /// <param name="acorn">Acorn builder</param>
+        /// <param name="configure">Configuration for bucket size</param>
+        /// <param name="valueSelectors">Numeric fields to keep running count/sum/min/max for per bucket</param>
+        /// <returns>Acorn builder for chaining</returns>
+        public static Acorn<T> WithStashTimeSeries<T>(
+            this Acorn<T> acorn,
+            Action<IndexConfiguration> configure,
+            params Expression<Func<T, double>>[] valueSelectors) where T : class
         {
             var config = new IndexConfiguration();
             configure(config);
 
-            // Time-series index implementation will come in 0.6
-            throw new NotImplementedException("Time-series indexes will be implemented in 0.6");
+            acorn.AddIndex(ManagedTimeSeriesIndex<T>.ForStashTime(config, valueSelectors));
+
+            return acorn;
         }
 
         /// <summary>
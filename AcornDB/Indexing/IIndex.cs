@@ -45,6 +45,12 @@ namespace AcornDB.Indexing
         /// <param name="document">Document to index</param>
         void Add(string id, object document);
 
+        /// <summary>
+        /// Whether Add expects the whole Nut (payload plus metadata such as the stash
+        /// timestamp) instead of the payload alone
+        /// </summary>
+        bool IndexesNutMetadata => false;
+
         /// <summary>
         /// Remove a document from the index.
         /// Called during Toss operations.
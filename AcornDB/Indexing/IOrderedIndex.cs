@@ -0,0 +1,49 @@
+using System.Collections.Generic;
+
+namespace AcornDB.Indexing
+{
+    /// <summary>
+    /// Key-ordered access to an index without knowing its key type, used by the query planner
+    /// to run range seeks, ordered scans and counts. ManagedScalarIndex and ManagedCompositeIndex
+    /// implement it directly; other IScalarIndex implementations are driven through their
+    /// Lookup/Range/GetAllSorted methods instead.
+    /// </summary>
+    public interface IOrderedIndex
+    {
+        /// <summary>
+        /// Properties that make up the key, in key order
+        /// </summary>
+        IReadOnlyList<string> KeyPropertyNames { get; }
+
+        /// <summary>
+        /// Whether seeks return exactly the documents whose key satisfies the bounds under C#
+        /// comparison semantics, and IndexRange.All returns every indexed document. When false
+        /// (e.g. case-insensitive keys) results are candidates to re-check, and the planner will
+        /// not answer Count() or ORDER BY from the index alone.
+        /// </summary>
+        bool IsExact { get; }
+
+        /// <summary>
+        /// Convert a query constant to the key type of the given key part.
+        /// Returns false if the value cannot be used to seek that part.
+        /// </summary>
+        bool TryNormalizeKey(int keyPart, object? value, out object? key);
+
+        /// <summary>
+        /// Document IDs whose keys fall in the range, in key order (reversed when descending).
+        /// Results are produced lazily, so stopping early avoids reading the rest of the range.
+        /// </summary>
+        IEnumerable<string> Seek(IndexRange range, bool descending = false);
+
+        /// <summary>
+        /// Number of documents whose keys fall in the range, without listing their IDs
+        /// </summary>
+        long Count(IndexRange range);
+
+        /// <summary>
+        /// Whether Count is cheap enough (e.g. answered from per-bucket totals) for the planner
+        /// to use as an exact row estimate instead of interpolating between MinKey and MaxKey
+        /// </summary>
+        bool HasCheapCount => false;
+    }
+}
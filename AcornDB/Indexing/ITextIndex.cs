@@ -1,5 +1,6 @@
 using System;
 using System.Collections.Generic;
+using System.Linq;
 using System.Linq.Expressions;
 
 namespace AcornDB.Indexing
@@ -30,6 +31,12 @@ namespace AcornDB.Indexing
         /// <returns>Document IDs ranked by relevance</returns>
         IEnumerable<TextSearchResult> Search(string searchQuery);
 
+        /// <summary>
+        /// The topK most relevant matches. Implementations can stop scoring once the remaining
+        /// documents cannot make the cut.
+        /// </summary>
+        IEnumerable<TextSearchResult> Search(string searchQuery, int topK) => Search(searchQuery).Take(topK);
+
         /// <summary>
         /// Prefix search: find documents containing words starting with the prefix.
         /// Useful for autocomplete/typeahead.
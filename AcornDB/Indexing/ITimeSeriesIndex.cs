@@ -1,5 +1,6 @@
 using System;
 using System.Collections.Generic;
+using System.Linq;
 using System.Linq.Expressions;
 
 namespace AcornDB.Indexing
@@ -50,6 +51,24 @@ namespace AcornDB.Indexing
             DateTime end,
             Func<IEnumerable<T>, TAggregate> aggregateFunc);
 
+        /// <summary>
+        /// Count (and, where the index keeps them, value aggregates) per time bucket, without
+        /// reading documents. Implementations that keep running totals answer this in
+        /// O(buckets).
+        /// </summary>
+        /// <param name="start">Start time (inclusive)</param>
+        /// <param name="end">End time (inclusive)</param>
+        /// <param name="interval">Roll consecutive buckets up to this width (a multiple of BucketSize)</param>
+        IEnumerable<TimeBucketSummary> Summarize(DateTime start, DateTime end, TimeSpan? interval = null)
+        {
+            return GetBuckets(start, end).Select(bucket => new TimeBucketSummary
+            {
+                BucketStart = bucket.BucketStart,
+                BucketEnd = bucket.BucketEnd,
+                Count = bucket.Count
+            });
+        }
+
         /// <summary>
         /// Get documents after a specific timestamp (for incremental queries)
         /// </summary>
@@ -0,0 +1,74 @@
+using System;
+using System.Collections.Generic;
+using System.Linq;
+
+namespace AcornDB.Indexing
+{
+    /// <summary>
+    /// Bounds for a seek on an ordered index: exact values for the leading key parts, then an
+    /// optional range on the next part. A scalar index has one key part, so an equality seek
+    /// is a one-value prefix and a range seek has an empty prefix.
+    ///
+    /// Examples for an index on (Department, Age):
+    ///   - Department = "Sales"                  → Prefix ["Sales"]
+    ///   - Department = "Sales" AND Age >= 30    → Prefix ["Sales"], Lower 30
+    /// </summary>
+    public class IndexRange
+    {
+        /// <summary>
+        /// Every entry in the index, in key order
+        /// </summary>
+        public static IndexRange All => new IndexRange();
+
+        /// <summary>
+        /// Exact values for the first Prefix.Count key parts
+        /// </summary>
+        public IReadOnlyList<object?> Prefix { get; set; } = Array.Empty<object?>();
+
+        /// <summary>
+        /// Lower bound on the key part after the prefix (null = open)
+        /// </summary>
+        public object? Lower { get; set; }
+
+        public bool LowerInclusive { get; set; } = true;
+
+        /// <summary>
+        /// Upper bound on the key part after the prefix (null = open)
+        /// </summary>
+        public object? Upper { get; set; }
+
+        public bool UpperInclusive { get; set; } = true;
+
+        /// <summary>
+        /// Whether the key part after the prefix is bounded
+        /// </summary>
+        public bool HasRange => Lower != null || Upper != null;
+
+        /// <summary>
+        /// Seek on a single exact key
+        /// </summary>
+        public static IndexRange Equal(params object?[] keyValues) => new IndexRange { Prefix = keyValues };
+
+        public override string ToString()
+        {
+            var parts = Prefix.Select(FormatValue).ToList();
+            if (HasRange)
+            {
+                var lower = Lower == null ? "(-∞" : (LowerInclusive ? "[" : "(") + FormatValue(Lower);
+                var upper = Upper == null ? "+∞)" : FormatValue(Upper) + (UpperInclusive ? "]" : ")");
+                parts.Add($"{lower}, {upper}");
+            }
+            return parts.Count == 0 ? "all" : string.Join(", ", parts);
+        }
+
+        private static string FormatValue(object? value)
+        {
+            return value switch
+            {
+                null => "null",
+                string s => $"'{s}'",
+                _ => value.ToString() ?? string.Empty
+            };
+        }
+    }
+}
@@ -7,6 +7,10 @@ namespace AcornDB.Indexing
     /// </summary>
     public class IndexStatistics
     {
+        // Textbook defaults when values cannot be interpolated between MinKey and MaxKey
+        private const double OPEN_RANGE_FRACTION = 1.0 / 3.0;
+        private const double CLOSED_RANGE_FRACTION = 1.0 / 4.0;
+
         /// <summary>
         /// Total number of entries in the index
         /// </summary>
@@ -31,5 +35,103 @@ namespace AcornDB.Indexing
         /// Last time the index was updated
         /// </summary>
         public DateTime LastUpdated { get; set; } = DateTime.UtcNow;
+
+        /// <summary>
+        /// Number of properties in the key (1 for scalar indexes)
+        /// </summary>
+        public int KeyPartCount { get; set; } = 1;
+
+        /// <summary>
+        /// Smallest value of the first key part, if known
+        /// </summary>
+        public object? MinKey { get; set; }
+
+        /// <summary>
+        /// Largest value of the first key part, if known
+        /// </summary>
+        public object? MaxKey { get; set; }
+
+        /// <summary>
+        /// Estimate how many entries a seek returns. Values are assumed evenly spread: each
+        /// exact key part keeps 1/UniqueValueCount^(1/KeyPartCount) of the entries, and a range
+        /// on the first key part is interpolated between MinKey and MaxKey when both are numeric
+        /// or dates.
+        /// </summary>
+        public double EstimateRows(IndexRange range)
+        {
+            if (EntryCount <= 0)
+                return 0;
+
+            var parts = Math.Max(KeyPartCount, 1);
+            double rows = EntryCount;
+
+            if (range.Prefix.Count > 0)
+            {
+                var exactParts = Math.Min(range.Prefix.Count, parts);
+                rows *= Math.Pow(1.0 / Math.Max(UniqueValueCount, 1), (double)exactParts / parts);
+            }
+
+            if (range.HasRange)
+            {
+                rows *= range.Prefix.Count == 0 ? EstimateRangeFraction(range) : DefaultRangeFraction(range);
+            }
+
+            return rows;
+        }
+
+        private double EstimateRangeFraction(IndexRange range)
+        {
+            if (!TryGetOrdinal(MinKey, out var min) || !TryGetOrdinal(MaxKey, out var max))
+                return DefaultRangeFraction(range);
+
+            var lower = min;
+            var upper = max;
+            if (range.Lower != null)
+            {
+                if (!TryGetOrdinal(range.Lower, out var value)) return DefaultRangeFraction(range);
+                lower = Math.Max(lower, value);
+            }
+            if (range.Upper != null)
+            {
+                if (!TryGetOrdinal(range.Upper, out var value)) return DefaultRangeFraction(range);
+                upper = Math.Min(upper, value);
+            }
+
+            if (upper < lower)
+                return 0;
+            if (max <= min)
+                return 1;
+
+            // A point range still matches the entries at that value
+            var pointFraction = 1.0 / Math.Max(UniqueValueCount, 1);
+            return Math.Clamp((upper - lower) / (max - min), pointFraction, 1.0);
+        }
+
+        private static double DefaultRangeFraction(IndexRange range)
+        {
+            return range.Lower != null && range.Upper != null ? CLOSED_RANGE_FRACTION : OPEN_RANGE_FRACTION;
+        }
+
+        private static bool TryGetOrdinal(object? value, out double ordinal)
+        {
+            switch (value)
+            {
+                case byte v: ordinal = v; return true;
+                case sbyte v: ordinal = v; return true;
+                case short v: ordinal = v; return true;
+                case ushort v: ordinal = v; return true;
+                case int v: ordinal = v; return true;
+                case uint v: ordinal = v; return true;
+                case long v: ordinal = v; return true;
+                case ulong v: ordinal = v; return true;
+                case float v: ordinal = v; return !float.IsNaN(v);
+                case double v: ordinal = v; return !double.IsNaN(v);
+                case decimal v: ordinal = (double)v; return true;
+                case DateTime v: ordinal = v.Ticks; return true;
+                case DateTimeOffset v: ordinal = v.UtcTicks; return true;
+                case TimeSpan v: ordinal = v.Ticks; return true;
+                default: ordinal = 0; return false;
+            }
+        }
     }
 }
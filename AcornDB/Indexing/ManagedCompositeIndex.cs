@@ -14,11 +14,18 @@ namespace AcornDB.Indexing
     ///   - WHERE Department = "Engineering" AND Age = 30
     ///   - WHERE Department = "Engineering" AND Age BETWEEN 25 AND 35
     /// </summary>
-    public class ManagedCompositeIndex<T> : ICompositeIndex<T> where T : class
+    public class ManagedCompositeIndex<T> : ICompositeIndex<T>, IOrderedIndex where T : class
     {
+        // Keys read per lock acquisition when streaming a seek
+        private const int SEEK_CHUNK_KEYS = 64;
+
+        private readonly object _lock = new object();
         private readonly SortedDictionary<CompositeKey, HashSet<string>> _index;
-        private readonly List<Func<T, object>> _propertyExtractors;
+        private readonly SortedSet<CompositeKey> _keys;
+        private readonly Dictionary<string, CompositeKey> _keyById = new Dictionary<string, CompositeKey>();
+        private readonly Func<T, object?[]> _keyExtractor;
         private readonly List<string> _propertyNames;
+        private readonly List<Type> _propertyTypes;
         private IndexState _state;
 
         public string Name { get; }
@@ -27,6 +34,13 @@ namespace AcornDB.Indexing
         public IndexState State => _state;
         public LambdaExpression KeySelector { get; }
         public IReadOnlyList<string> PropertyNames => _propertyNames.AsReadOnly();
+        public IReadOnlyList<string> KeyPropertyNames => _propertyNames;
+
+        /// <summary>
+        /// Key parts compare with Equals, which matches == for the primitive and string
+        /// properties composite keys are built from
+        /// </summary>
+        public bool IsExact => true;
 
         /// <summary>
         /// Create a composite index from individual property selectors
@@ -40,10 +54,11 @@ namespace AcornDB.Indexing
             IsUnique = config?.IsUnique ?? false;
             _state = IndexState.Building;
 
-            _propertyExtractors = new List<Func<T, object>>();
             _propertyNames = new List<string>();
+            _propertyTypes = new List<Type>();
 
-            foreach (var selector in propertySelectors)
+            var selectors = propertySelectors.ToList();
+            foreach (var selector in selectors)
             {
                 // Extract property name
                 var propertyName = ExtractPropertyName(selector);
@@ -52,19 +67,20 @@ namespace AcornDB.Indexing
                     throw new ArgumentException("Could not extract property name from selector", nameof(propertySelectors));
                 }
                 _propertyNames.Add(propertyName);
-
-                // Compile extractor that returns object
-                var parameter = selector.Parameters[0];
-                var body = Expression.Convert(selector.Body, typeof(object));
-                var objectSelector = Expression.Lambda<Func<T, object>>(body, parameter);
-                _propertyExtractors.Add(objectSelector.Compile());
+                _propertyTypes.Add(selector.Body is UnaryExpression { NodeType: ExpressionType.Convert } convert
+                    ? convert.Operand.Type
+                    : selector.Body.Type);
             }
 
+            // All parts are read by one compiled delegate
+            _keyExtractor = PropertyAccessors.ForKeyParts<T>(selectors);
+
             // Store a combined key selector for reference
-            // This is a simplified representation - actual extraction uses _propertyExtractors
-            KeySelector = propertySelectors.First();
+            // This is a simplified representation - actual extraction uses _keyExtractor
+            KeySelector = selectors.First();
 
             _index = new SortedDictionary<CompositeKey, HashSet<string>>();
+            _keys = new SortedSet<CompositeKey>();
         }
 
         private string? ExtractPropertyName(LambdaExpression expression)
@@ -82,18 +98,21 @@ namespace AcornDB.Indexing
 
         public void Build(IEnumerable<object> documents)
         {
-            _state = IndexState.Building;
-            _index.Clear();
-
-            foreach (var doc in documents)
+            lock (_lock)
             {
-                if (doc is Nut<T> nut)
+                _state = IndexState.Building;
+                ClearInternal();
+
+                foreach (var doc in documents)
                 {
-                    Add(nut.Id, nut.Payload);
+                    if (doc is Nut<T> nut)
+                    {
+                        Add(nut.Id, nut.Payload);
+                    }
                 }
-            }
 
-            _state = IndexState.Ready;
+                _state = IndexState.Ready;
+            }
         }
 
         public void Add(string id, object document)
@@ -101,64 +120,83 @@ namespace AcornDB.Indexing
             if (document is not T typedDoc)
                 return;
 
-            var keyValues = _propertyExtractors.Select(extractor => extractor(typedDoc)).ToArray();
-            var key = new CompositeKey(keyValues);
+            var key = new CompositeKey(_keyExtractor(typedDoc)!);
 
-            if (!_index.TryGetValue(key, out var ids))
+            lock (_lock)
             {
-                ids = new HashSet<string>();
-                _index[key] = ids;
-            }
+                var hadKey = _keyById.TryGetValue(id, out var previous);
+                if (hadKey && previous!.Equals(key))
+                    return; // Re-stash with the same key
 
-            if (IsUnique && ids.Count > 0)
-            {
-                throw new InvalidOperationException($"Duplicate key in unique composite index '{Name}'");
-            }
+                if (!_index.TryGetValue(key, out var ids))
+                {
+                    ids = new HashSet<string>();
+                    _index[key] = ids;
+                    _keys.Add(key);
+                }
+                else if (IsUnique && ids.Count > 0)
+                {
+                    throw new InvalidOperationException($"Duplicate key in unique composite index '{Name}'");
+                }
 
-            ids.Add(id);
+                if (hadKey) RemoveInternal(id, previous!);
+                ids.Add(id);
+                _keyById[id] = key;
+            }
         }
 
         public void Remove(string id)
         {
-            // Need to scan to find which key(s) contain this ID
-            var keysToRemove = new List<CompositeKey>();
-
-            foreach (var kvp in _index)
+            lock (_lock)
             {
-                if (kvp.Value.Remove(id))
+                if (_keyById.Remove(id, out var key))
                 {
-                    if (kvp.Value.Count == 0)
-                    {
-                        keysToRemove.Add(kvp.Key);
-                    }
+                    RemoveInternal(id, key);
                 }
             }
+        }
 
-            foreach (var key in keysToRemove)
+        private void RemoveInternal(string id, CompositeKey key)
+        {
+            if (_index.TryGetValue(key, out var ids) && ids.Remove(id) && ids.Count == 0)
             {
                 _index.Remove(key);
+                _keys.Remove(key);
             }
         }
 
         public void Clear()
+        {
+            lock (_lock)
+            {
+                ClearInternal();
+                _state = IndexState.Building;
+            }
+        }
+
+        private void ClearInternal()
         {
             _index.Clear();
-            _state = IndexState.Building;
+            _keys.Clear();
+            _keyById.Clear();
         }
 
         public IEnumerable<string> Lookup(params object[] keyValues)
         {
-            if (keyValues.Length != _propertyExtractors.Count)
+            if (keyValues.Length != _propertyNames.Count)
             {
                 throw new ArgumentException(
-                    $"Expected {_propertyExtractors.Count} key values, got {keyValues.Length}",
+                    $"Expected {_propertyNames.Count} key values, got {keyValues.Length}",
                     nameof(keyValues));
             }
 
             var key = new CompositeKey(keyValues);
-            if (_index.TryGetValue(key, out var ids))
+            lock (_lock)
             {
-                return ids.ToList();
+                if (_index.TryGetValue(key, out var ids))
+                {
+                    return ids.ToList();
+                }
             }
 
             return Enumerable.Empty<string>();
@@ -166,96 +204,167 @@ namespace AcornDB.Indexing
 
         public IEnumerable<string> PrefixLookup(params object[] prefixValues)
         {
-            if (prefixValues.Length == 0 || prefixValues.Length > _propertyExtractors.Count)
+            if (prefixValues.Length == 0 || prefixValues.Length > _propertyNames.Count)
             {
                 throw new ArgumentException("Invalid prefix length", nameof(prefixValues));
             }
 
             // If we have all values, just do a regular lookup
-            if (prefixValues.Length == _propertyExtractors.Count)
+            if (prefixValues.Length == _propertyNames.Count)
             {
                 return Lookup(prefixValues);
             }
 
-            // Scan for matching prefixes
-            var results = new HashSet<string>();
-
-            foreach (var kvp in _index)
-            {
-                if (kvp.Key.MatchesPrefix(prefixValues))
-                {
-                    results.UnionWith(kvp.Value);
-                }
-            }
-
-            return results;
+            return Seek(new IndexRange { Prefix = prefixValues }).ToList();
         }
 
         public IEnumerable<string> RangeOnLastProperty(object[] exactPrefixValues, object min, object max)
         {
-            if (exactPrefixValues.Length >= _propertyExtractors.Count)
+            if (exactPrefixValues.Length >= _propertyNames.Count)
             {
                 throw new ArgumentException("Prefix values should leave room for range property", nameof(exactPrefixValues));
             }
 
-            var results = new HashSet<string>();
+            return Seek(new IndexRange { Prefix = exactPrefixValues, Lower = min, Upper = max }).ToList();
+        }
+
+        public IEnumerable<string> GetAllSorted(bool ascending = true)
+        {
+            return Seek(IndexRange.All, descending: !ascending);
+        }
+
+        public bool TryNormalizeKey(int keyPart, object? value, out object? key)
+        {
+            key = value;
+            if (keyPart < 0 || keyPart >= _propertyTypes.Count)
+                return false;
+
+            // Parts compare through IComparable on the boxed values, which needs identical types
+            var partType = _propertyTypes[keyPart];
+            if (value == null)
+                return !partType.IsValueType || Nullable.GetUnderlyingType(partType) != null;
+
+            return value.GetType() == (Nullable.GetUnderlyingType(partType) ?? partType);
+        }
+
+        /// <summary>
+        /// Stream ids in composite key order. The sorted key set is sliced with GetViewBetween:
+        /// a prefix sorts before every longer key that extends it, and the MaxValue sentinel
+        /// after all of them, so [prefix + lower, prefix + upper + Max] covers the range.
+        /// </summary>
+        public IEnumerable<string> Seek(IndexRange range, bool descending = false)
+        {
+            var prefix = range.Prefix.ToArray();
+            if (prefix.Length > _propertyNames.Count || (range.HasRange && prefix.Length == _propertyNames.Count))
+                throw new ArgumentException("Range does not fit the index key", nameof(range));
+
+            var from = new CompositeKey(range.Lower != null ? Append(prefix, range.Lower) : prefix);
+            var to = new CompositeKey(range.Upper != null
+                ? Append(Append(prefix, range.Upper), CompositeKey.MaxValue)
+                : Append(prefix, CompositeKey.MaxValue));
+
+            var chunk = new List<string>();
+            CompositeKey? cursor = null;
 
-            foreach (var kvp in _index)
+            while (true)
             {
-                // Check if prefix matches exactly
-                if (!kvp.Key.MatchesPrefix(exactPrefixValues))
-                    continue;
+                chunk.Clear();
+                var exhausted = true;
+
+                lock (_lock)
+                {
+                    var lower = !descending && cursor != null ? cursor : from;
+                    var upper = descending && cursor != null ? cursor : to;
+                    var view = _keys.Count > 0 && lower.CompareTo(upper) <= 0 ? _keys.GetViewBetween(lower, upper) : null;
+
+                    var keys = 0;
+                    foreach (var key in view == null ? Enumerable.Empty<CompositeKey>() : descending ? view.Reverse() : view)
+                    {
+                        if (ReferenceEquals(key, cursor) || !Matches(key, prefix, range))
+                            continue;
+
+                        chunk.AddRange(_index[key]);
+                        cursor = key;
 
-                // Get the value at the range position
-                var rangeValue = kvp.Key.Values[exactPrefixValues.Length];
+                        if (++keys == SEEK_CHUNK_KEYS)
+                        {
+                            exhausted = false;
+                            break;
+                        }
+                    }
+                }
 
-                // Check if it's in range
-                if (IsInRange(rangeValue, min, max))
+                foreach (var id in chunk)
                 {
-                    results.UnionWith(kvp.Value);
+                    yield return id;
                 }
-            }
 
-            return results;
+                if (exhausted)
+                    yield break;
+            }
         }
 
-        private bool IsInRange(object value, object min, object max)
+        public long Count(IndexRange range)
         {
-            if (value is IComparable comparable)
+            if (range.Prefix.Count == 0 && !range.HasRange)
             {
-                var compareMin = comparable.CompareTo(min);
-                var compareMax = comparable.CompareTo(max);
-                return compareMin >= 0 && compareMax <= 0;
+                lock (_lock)
+                {
+                    return _keyById.Count;
+                }
             }
 
-            return false;
+            return Seek(range).LongCount();
         }
 
-        public IEnumerable<string> GetAllSorted(bool ascending = true)
+        private static object[] Append(object?[] values, object value)
         {
-            var keys = ascending ? _index.Keys : _index.Keys.Reverse();
+            var result = new object[values.Length + 1];
+            values.CopyTo(result, 0);
+            result[values.Length] = value;
+            return result;
+        }
 
-            foreach (var key in keys)
+        /// <summary>
+        /// Exact check behind the view: prefix parts by Equals, exclusive bounds on the range part
+        /// </summary>
+        private static bool Matches(CompositeKey key, object?[] prefix, IndexRange range)
+        {
+            if (!key.MatchesPrefix(prefix!))
+                return false;
+
+            if (!range.HasRange)
+                return true;
+
+            var value = key.Values[prefix.Length];
+            if (range.Lower != null)
             {
-                foreach (var id in _index[key])
-                {
-                    yield return id;
-                }
+                var c = CompositeKey.CompareValues(value, range.Lower);
+                if (c < 0 || (c == 0 && !range.LowerInclusive)) return false;
             }
+            if (range.Upper != null)
+            {
+                var c = CompositeKey.CompareValues(value, range.Upper);
+                if (c > 0 || (c == 0 && !range.UpperInclusive)) return false;
+            }
+            return true;
         }
 
         public IndexStatistics GetStatistics()
         {
-            var totalEntries = _index.Values.Sum(ids => ids.Count);
-            var uniqueKeys = _index.Count;
-
-            return new IndexStatistics
+            lock (_lock)
             {
-                EntryCount = totalEntries,
-                UniqueValueCount = uniqueKeys,
-                MemoryUsageBytes = EstimateMemoryUsage(),
-                LastUpdated = DateTime.UtcNow
-            };
+                return new IndexStatistics
+                {
+                    EntryCount = _keyById.Count,
+                    UniqueValueCount = _index.Count,
+                    MemoryUsageBytes = EstimateMemoryUsage(),
+                    LastUpdated = DateTime.UtcNow,
+                    KeyPartCount = _propertyNames.Count,
+                    MinKey = _keys.Count > 0 ? _keys.Min!.Values[0] : null,
+                    MaxKey = _keys.Count > 0 ? _keys.Max!.Values[0] : null
+                };
+            }
         }
 
         private long EstimateMemoryUsage()
@@ -265,9 +374,9 @@ namespace AcornDB.Indexing
             // - Each HashSet: ~100 bytes + entries
             // - Each string ID: ~40 bytes
             var keyCount = _index.Count;
-            var entryCount = _index.Values.Sum(ids => ids.Count);
+            var entryCount = _keyById.Count;
 
-            return (keyCount * (_propertyExtractors.Count * 8 + 100)) + (entryCount * 40);
+            return (keyCount * (_propertyNames.Count * 8 + 100)) + (entryCount * 40);
         }
 
         /// <summary>
@@ -275,6 +384,11 @@ namespace AcornDB.Indexing
         /// </summary>
         private class CompositeKey : IComparable<CompositeKey>
         {
+            /// <summary>
+            /// Sentinel that sorts after every value, used as an open upper bound in seeks
+            /// </summary>
+            public static readonly object MaxValue = new object();
+
             public object[] Values { get; }
 
             public CompositeKey(object[] values)
@@ -305,27 +419,7 @@ namespace AcornDB.Indexing
 
                 for (int i = 0; i < minLength; i++)
                 {
-                    var val1 = Values[i];
-                    var val2 = other.Values[i];
-
-                    int comparison;
-                    if (val1 is IComparable comparable)
-                    {
-                        comparison = comparable.CompareTo(val2);
-                    }
-                    else if (val1 != null && val2 != null)
-                    {
-                        comparison = string.Compare(val1.ToString(), val2.ToString(), StringComparison.Ordinal);
-                    }
-                    else if (val1 == null && val2 == null)
-                    {
-                        comparison = 0;
-                    }
-                    else
-                    {
-                        comparison = val1 == null ? -1 : 1;
-                    }
-
+                    var comparison = CompareValues(Values[i], other.Values[i]);
                     if (comparison != 0)
                         return comparison;
                 }
@@ -333,6 +427,30 @@ namespace AcornDB.Indexing
                 return Values.Length.CompareTo(other.Values.Length);
             }
 
+            public static int CompareValues(object? val1, object? val2)
+            {
+                if (ReferenceEquals(val1, val2))
+                    return 0;
+                if (ReferenceEquals(val1, MaxValue))
+                    return 1;
+                if (ReferenceEquals(val2, MaxValue))
+                    return -1;
+
+                if (val1 is IComparable comparable)
+                {
+                    return comparable.CompareTo(val2);
+                }
+                if (val1 != null && val2 != null)
+                {
+                    return string.Compare(val1.ToString(), val2.ToString(), StringComparison.Ordinal);
+                }
+                if (val1 == null && val2 == null)
+                {
+                    return 0;
+                }
+                return val1 == null ? -1 : 1;
+            }
+
             public override bool Equals(object? obj)
             {
                 if (obj is not CompositeKey other)
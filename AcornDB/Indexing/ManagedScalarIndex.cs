@@ -7,16 +7,23 @@ namespace AcornDB.Indexing
 {
     /// <summary>
     /// In-memory managed implementation of a scalar index.
-    /// Uses a sorted dictionary for O(log n) lookups and range queries.
-    /// Thread-safe for concurrent reads and writes.
+    /// Uses a sorted dictionary for O(log n) lookups and a sorted key set for O(log n + k)
+    /// range seeks. Thread-safe for concurrent reads and writes.
     /// </summary>
-    public class ManagedScalarIndex<T, TProperty> : IScalarIndex<T, TProperty> where T : class
+    public class ManagedScalarIndex<T, TProperty> : IScalarIndex<T, TProperty>, IOrderedIndex where T : class
     {
+        // Keys read per lock acquisition when streaming a seek
+        private const int SEEK_CHUNK_KEYS = 64;
+
         private readonly object _lock = new object();
         private readonly SortedDictionary<TProperty, HashSet<string>> _index;
+        private readonly SortedSet<TProperty> _keys;
+        private readonly Dictionary<string, TProperty> _valueById = new Dictionary<string, TProperty>();
+        private readonly HashSet<string> _nullIds = new HashSet<string>();
         private readonly IComparer<TProperty> _comparer;
         private readonly Func<T, TProperty> _propertyExtractor;
         private readonly IndexConfiguration _config;
+        private readonly string[] _keyPropertyNames;
 
         private IndexState _state = IndexState.Building;
         private IndexStatistics _statistics = new IndexStatistics();
@@ -26,18 +33,29 @@ namespace AcornDB.Indexing
         public bool IsUnique { get; }
         public IndexState State => _state;
         public Expression<Func<T, TProperty>> PropertySelector { get; }
+        public IReadOnlyList<string> KeyPropertyNames => _keyPropertyNames;
+
+        /// <summary>
+        /// Case-insensitive keys match more than == would, so results must be re-checked
+        /// </summary>
+        public bool IsExact => !ReferenceEquals(_comparer, StringComparer.OrdinalIgnoreCase);
 
         public ManagedScalarIndex(
             Expression<Func<T, TProperty>> propertySelector,
             IndexConfiguration? config = null)
         {
             PropertySelector = propertySelector ?? throw new ArgumentNullException(nameof(propertySelector));
-            _propertyExtractor = propertySelector.Compile();
+            _propertyExtractor = PropertyAccessors.ForSelector(propertySelector);
             _config = config ?? new IndexConfiguration();
 
             Name = _config.Name ?? $"IX_{typeof(T).Name}_{GetPropertyName(propertySelector)}";
             IsUnique = _config.IsUnique;
 
+            // Only direct properties can be matched against query predicates
+            _keyPropertyNames = propertySelector.Body is MemberExpression { Expression: ParameterExpression } member
+                ? new[] { member.Member.Name }
+                : new[] { propertySelector.Body.ToString() };
+
             // Use custom comparer if provided, otherwise default
             if (_config.CaseInsensitive && typeof(TProperty) == typeof(string))
             {
@@ -49,6 +67,7 @@ namespace AcornDB.Indexing
             }
 
             _index = new SortedDictionary<TProperty, HashSet<string>>(_comparer);
+            _keys = new SortedSet<TProperty>(_comparer);
         }
 
         public void Build(IEnumerable<object> documents)
@@ -56,7 +75,7 @@ namespace AcornDB.Indexing
             lock (_lock)
             {
                 _state = IndexState.Building;
-                _index.Clear();
+                ClearInternal();
 
                 foreach (var obj in documents)
                 {
@@ -86,11 +105,26 @@ namespace AcornDB.Indexing
         private void AddInternal(string id, T document)
         {
             var value = _propertyExtractor(document);
+            var hadValue = _valueById.TryGetValue(id, out var previous);
+
+            if (value == null)
+            {
+                if (hadValue) RemoveInternal(id, previous);
+                _nullIds.Add(id);
+                _valueById[id] = value;
+                return;
+            }
+
+            if (hadValue && previous != null && _comparer.Compare(previous, value) == 0)
+            {
+                return; // Re-stash with the same key
+            }
 
             if (!_index.TryGetValue(value, out var ids))
             {
                 ids = new HashSet<string>();
                 _index[value] = ids;
+                _keys.Add(value);
             }
             else if (IsUnique && ids.Count > 0)
             {
@@ -98,121 +132,242 @@ namespace AcornDB.Indexing
                     $"Unique index violation: value '{value}' already exists in index '{Name}'");
             }
 
+            if (hadValue) RemoveInternal(id, previous);
             ids.Add(id);
+            _valueById[id] = value;
         }
 
         public void Remove(string id)
         {
             lock (_lock)
             {
-                // Find and remove the ID from all value buckets
-                // This is O(n) for removal without knowing the value, but acceptable for managed indexes
-                var emptyKeys = new List<TProperty>();
-
-                foreach (var kvp in _index)
+                if (_valueById.TryGetValue(id, out var value))
                 {
-                    if (kvp.Value.Remove(id))
-                    {
-                        if (kvp.Value.Count == 0)
-                        {
-                            emptyKeys.Add(kvp.Key);
-                        }
-                        break; // Found and removed, stop searching
-                    }
-                }
-
-                // Clean up empty buckets
-                foreach (var key in emptyKeys)
-                {
-                    _index.Remove(key);
+                    RemoveInternal(id, value);
+                    _valueById.Remove(id);
                 }
 
                 UpdateStatistics();
             }
         }
 
+        private void RemoveInternal(string id, TProperty value)
+        {
+            if (value == null)
+            {
+                _nullIds.Remove(id);
+                return;
+            }
+
+            if (_index.TryGetValue(value, out var ids) && ids.Remove(id) && ids.Count == 0)
+            {
+                _index.Remove(value);
+                _keys.Remove(value);
+            }
+        }
+
         public void Clear()
         {
             lock (_lock)
             {
-                _index.Clear();
+                ClearInternal();
                 UpdateStatistics();
             }
         }
 
+        private void ClearInternal()
+        {
+            _index.Clear();
+            _keys.Clear();
+            _valueById.Clear();
+            _nullIds.Clear();
+        }
+
         public IEnumerable<string> Lookup(TProperty value)
         {
             lock (_lock)
             {
-                if (_index.TryGetValue(value, out var ids))
-                {
-                    return ids.ToList(); // Return copy to avoid lock issues
-                }
-                return Enumerable.Empty<string>();
+                var ids = value == null ? _nullIds : _index.GetValueOrDefault(value);
+                return ids != null ? ids.ToList() : Enumerable.Empty<string>(); // Return copy to avoid lock issues
             }
         }
 
         public IEnumerable<string> Range(TProperty min, TProperty max)
+        {
+            return SeekRange(true, min, true, true, max, true, descending: false).ToList();
+        }
+
+        public IEnumerable<string> GetAllSorted(bool ascending = true)
+        {
+            return Seek(IndexRange.All, descending: !ascending).ToList();
+        }
+
+        public TProperty? GetMin()
         {
             lock (_lock)
             {
-                var results = new List<string>();
+                return _keys.Count > 0 ? _keys.Min : default;
+            }
+        }
 
-                foreach (var kvp in _index)
+        public TProperty? GetMax()
+        {
+            lock (_lock)
+            {
+                return _keys.Count > 0 ? _keys.Max : default;
+            }
+        }
+
+        public bool TryNormalizeKey(int keyPart, object? value, out object? key)
+        {
+            key = value;
+            return keyPart == 0 && (value == null ? default(TProperty) == null : value is TProperty);
+        }
+
+        public IEnumerable<string> Seek(IndexRange range, bool descending = false)
+        {
+            if (range.Prefix.Count > 1)
+                throw new ArgumentException("A scalar index has a single key part", nameof(range));
+
+            if (range.Prefix.Count == 1)
+                return Lookup(AsKey(range.Prefix[0]));
+
+            var all = !range.HasRange;
+            var ids = SeekRange(
+                range.Lower != null, AsKey(range.Lower), range.LowerInclusive,
+                range.Upper != null, AsKey(range.Upper), range.UpperInclusive,
+                descending);
+
+            if (!all)
+                return ids;
+
+            // Null keys sort first, as they do for OrderBy; no bounded range matches them
+            var nulls = NullIdsSnapshot();
+            return descending ? ids.Concat(nulls) : nulls.Concat(ids);
+        }
+
+        public long Count(IndexRange range)
+        {
+            lock (_lock)
+            {
+                if (range.Prefix.Count == 1)
                 {
-                    if (_comparer.Compare(kvp.Key, min) >= 0 && _comparer.Compare(kvp.Key, max) <= 0)
-                    {
-                        results.AddRange(kvp.Value);
-                    }
-                    else if (_comparer.Compare(kvp.Key, max) > 0)
-                    {
-                        break; // Sorted, so we can stop early
-                    }
+                    var value = AsKey(range.Prefix[0]);
+                    return value == null ? _nullIds.Count : _index.GetValueOrDefault(value)?.Count ?? 0;
                 }
 
-                return results;
+                if (!range.HasRange)
+                    return _valueById.Count;
+
+                long count = 0;
+                var view = View(range.Lower != null, AsKey(range.Lower), range.Upper != null, AsKey(range.Upper));
+                foreach (var key in view ?? Enumerable.Empty<TProperty>())
+                {
+                    if (!InBounds(key, range.Lower != null, AsKey(range.Lower), range.LowerInclusive,
+                            range.Upper != null, AsKey(range.Upper), range.UpperInclusive))
+                        continue;
+                    count += _index[key].Count;
+                }
+                return count;
             }
         }
 
-        public IEnumerable<string> GetAllSorted(bool ascending = true)
+        private List<string> NullIdsSnapshot()
         {
             lock (_lock)
             {
-                var results = new List<string>();
+                return _nullIds.ToList();
+            }
+        }
+
+        /// <summary>
+        /// Stream ids in key order, a chunk of keys per lock acquisition, so a Take over an
+        /// ordered scan stops after the chunks it needs and writers are never blocked by a reader
+        /// </summary>
+        private IEnumerable<string> SeekRange(
+            bool hasLower, TProperty lower, bool lowerInclusive,
+            bool hasUpper, TProperty upper, bool upperInclusive,
+            bool descending)
+        {
+            var chunk = new List<string>();
+            var hasCursor = false;
+            TProperty cursor = default!;
 
-                if (ascending)
+            while (true)
+            {
+                chunk.Clear();
+                var exhausted = true;
+
+                lock (_lock)
                 {
-                    foreach (var kvp in _index)
+                    // The cursor (last key returned) narrows the view to what is left
+                    var view = descending
+                        ? View(hasLower, lower, hasCursor || hasUpper, hasCursor ? cursor : upper)
+                        : View(hasCursor || hasLower, hasCursor ? cursor : lower, hasUpper, upper);
+
+                    var keys = 0;
+                    foreach (var key in view == null ? Enumerable.Empty<TProperty>() : descending ? view.Reverse() : view)
                     {
-                        results.AddRange(kvp.Value);
+                        if (hasCursor && _comparer.Compare(key, cursor) == 0)
+                            continue;
+                        if (!InBounds(key, hasLower, lower, lowerInclusive, hasUpper, upper, upperInclusive))
+                            continue;
+
+                        chunk.AddRange(_index[key]);
+                        cursor = key;
+                        hasCursor = true;
+
+                        if (++keys == SEEK_CHUNK_KEYS)
+                        {
+                            exhausted = false;
+                            break;
+                        }
                     }
                 }
-                else
+
+                foreach (var id in chunk)
                 {
-                    foreach (var kvp in _index.Reverse())
-                    {
-                        results.AddRange(kvp.Value);
-                    }
+                    yield return id;
                 }
 
-                return results;
+                if (exhausted)
+                    yield break;
             }
         }
 
-        public TProperty? GetMin()
+        private static TProperty AsKey(object? value) => value == null ? default! : (TProperty)value;
+
+        /// <summary>
+        /// Keys between the bounds (inclusive), or null if there are none
+        /// </summary>
+        private SortedSet<TProperty>? View(bool hasLower, TProperty lower, bool hasUpper, TProperty upper)
         {
-            lock (_lock)
-            {
-                return _index.Any() ? _index.First().Key : default;
-            }
+            if (_keys.Count == 0)
+                return null;
+            if (!hasLower && !hasUpper)
+                return _keys;
+
+            var from = hasLower ? lower : _keys.Min!;
+            var to = hasUpper ? upper : _keys.Max!;
+            return _comparer.Compare(from, to) > 0 ? null : _keys.GetViewBetween(from, to);
         }
 
-        public TProperty? GetMax()
+        private bool InBounds(
+            TProperty key,
+            bool hasLower, TProperty lower, bool lowerInclusive,
+            bool hasUpper, TProperty upper, bool upperInclusive)
         {
-            lock (_lock)
+            if (hasLower)
+            {
+                var c = _comparer.Compare(key, lower);
+                if (c < 0 || (c == 0 && !lowerInclusive)) return false;
+            }
+            if (hasUpper)
             {
-                return _index.Any() ? _index.Last().Key : default;
+                var c = _comparer.Compare(key, upper);
+                if (c > 0 || (c == 0 && !upperInclusive)) return false;
             }
+            return true;
         }
 
         public IndexStatistics GetStatistics()
@@ -224,7 +379,10 @@ namespace AcornDB.Indexing
                     EntryCount = _statistics.EntryCount,
                     UniqueValueCount = _statistics.UniqueValueCount,
                     MemoryUsageBytes = _statistics.MemoryUsageBytes,
-                    LastUpdated = _statistics.LastUpdated
+                    LastUpdated = _statistics.LastUpdated,
+                    KeyPartCount = 1,
+                    MinKey = _keys.Count > 0 ? _keys.Min : null,
+                    MaxKey = _keys.Count > 0 ? _keys.Max : null
                 };
             }
         }
@@ -232,7 +390,7 @@ namespace AcornDB.Indexing
         private void UpdateStatistics()
         {
             _statistics.UniqueValueCount = _index.Count;
-            _statistics.EntryCount = _index.Sum(kvp => kvp.Value.Count);
+            _statistics.EntryCount = _valueById.Count;
             _statistics.LastUpdated = DateTime.UtcNow;
 
             // Rough memory estimate: (key size + HashSet overhead) per unique value
@@ -0,0 +1,733 @@
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Linq.Expressions;
+
+namespace AcornDB.Indexing
+{
+    /// <summary>
+    /// In-memory full-text index: an inverted index from terms to compressed posting lists
+    /// (see PostingList), ranked with BM25.
+    ///
+    /// Each document gets an integer ordinal. A re-stashed document gets a fresh, higher ordinal,
+    /// so stash and toss only append to posting lists or mark an ordinal removed. A list is
+    /// rewritten once most of its postings belong to removed documents, and all ordinals are
+    /// renumbered once most of them are dead.
+    ///
+    /// Search(query, topK) keeps the k best documents in a min-heap. It skips terms whose
+    /// BM25 upper bounds cannot lift a document past the current k-th score (MaxScore), so short
+    /// queries over common words do not score every posting.
+    ///
+    /// Query syntax: words are OR-ed and ranked, "quoted phrases" must match in order, AND
+    /// (or a leading +) makes words required, a leading - excludes a word and a trailing *
+    /// matches word prefixes.
+    ///
+    /// Thread-safe for concurrent reads and writes.
+    /// </summary>
+    public class ManagedTextIndex<T> : ITextIndex<T> where T : class
+    {
+        // BM25 parameters (Robertson and Zaragoza's usual defaults)
+        private const double K1 = 1.2;
+        private const double B = 0.75;
+
+        // Prefix terms (word*) expanded per query, most frequent first
+        private const int MAX_PREFIX_EXPANSIONS = 64;
+
+        // Renumber all ordinals once this many are dead and they outnumber live documents
+        private const int MIN_DEAD_ORDINALS_TO_COMPACT = 1024;
+
+        private readonly object _lock = new object();
+        private readonly Func<T, string> _textExtractor;
+        private readonly TextTokenizer _tokenizer;
+        private readonly Dictionary<string, PostingList> _postings = new Dictionary<string, PostingList>(StringComparer.Ordinal);
+        private readonly SortedSet<string> _terms = new SortedSet<string>(StringComparer.Ordinal);
+        private readonly Dictionary<string, int> _ordinalById = new Dictionary<string, int>();
+        private readonly IndexConfiguration _config;
+
+        // Indexed by ordinal; null once the document is removed or re-stashed
+        private List<DocumentEntry?> _documents = new List<DocumentEntry?>();
+        private long _totalLength;
+
+        private IndexState _state = IndexState.Building;
+        private IndexStatistics _statistics = new IndexStatistics();
+
+        public string Name { get; }
+        public IndexType IndexType => IndexType.Text;
+        public bool IsUnique => false;
+        public IndexState State => _state;
+        public Expression<Func<T, string>> TextSelector { get; }
+        public string Language => _tokenizer.Language;
+
+        public ManagedTextIndex(
+            Expression<Func<T, string>> textSelector,
+            IndexConfiguration? config = null)
+        {
+            TextSelector = textSelector ?? throw new ArgumentNullException(nameof(textSelector));
+            _textExtractor = PropertyAccessors.ForSelector(textSelector);
+            _config = config ?? new IndexConfiguration();
+            _tokenizer = new TextTokenizer(_config.Language);
+
+            Name = _config.Name ?? $"IX_{typeof(T).Name}_{GetPropertyName(textSelector)}_Text";
+        }
+
+        public void Build(IEnumerable<object> documents)
+        {
+            lock (_lock)
+            {
+                _state = IndexState.Building;
+                ClearInternal();
+
+                foreach (var obj in documents)
+                {
+                    if (obj is Nut<T> nut)
+                    {
+                        AddInternal(nut.Id, nut.Payload);
+                    }
+                }
+
+                _state = IndexState.Ready;
+                UpdateStatistics();
+            }
+        }
+
+        public void Add(string id, object document)
+        {
+            var doc = document as T;
+            if (doc == null) return;
+
+            lock (_lock)
+            {
+                AddInternal(id, doc);
+                UpdateStatistics();
+            }
+        }
+
+        private void AddInternal(string id, T document)
+        {
+            if (_ordinalById.ContainsKey(id))
+            {
+                RemoveInternal(id);
+            }
+
+            var tokens = _tokenizer.Tokenize(_textExtractor(document));
+            var positionsByTerm = new Dictionary<string, List<int>>(StringComparer.Ordinal);
+            foreach (var (term, position) in tokens)
+            {
+                if (!positionsByTerm.TryGetValue(term, out var positions))
+                {
+                    positions = new List<int>();
+                    positionsByTerm[term] = positions;
+                }
+                positions.Add(position);
+            }
+
+            var ordinal = _documents.Count;
+            _documents.Add(new DocumentEntry(id, tokens.Count, positionsByTerm.Keys.ToArray()));
+            _ordinalById[id] = ordinal;
+            _totalLength += tokens.Count;
+
+            foreach (var (term, positions) in positionsByTerm)
+            {
+                if (!_postings.TryGetValue(term, out var list))
+                {
+                    list = new PostingList();
+                    _postings[term] = list;
+                    _terms.Add(term);
+                }
+                list.Append(ordinal, positions);
+            }
+        }
+
+        public void Remove(string id)
+        {
+            lock (_lock)
+            {
+                if (RemoveInternal(id))
+                {
+                    UpdateStatistics();
+                }
+            }
+        }
+
+        private bool RemoveInternal(string id)
+        {
+            if (!_ordinalById.Remove(id, out var ordinal))
+                return false;
+
+            var entry = _documents[ordinal]!;
+            _documents[ordinal] = null;
+            _totalLength -= entry.Length;
+
+            foreach (var term in entry.Terms)
+            {
+                var list = _postings[term];
+                list.Live--;
+
+                if (list.Live == 0)
+                {
+                    _postings.Remove(term);
+                    _terms.Remove(term);
+                }
+                else if (list.Count - list.Live > list.Live)
+                {
+                    _postings[term] = Rewrite(list, null);
+                }
+            }
+
+            var dead = _documents.Count - _ordinalById.Count;
+            if (dead >= MIN_DEAD_ORDINALS_TO_COMPACT && dead > _ordinalById.Count)
+            {
+                RenumberOrdinals();
+            }
+
+            return true;
+        }
+
+        /// <summary>
+        /// Copy the live postings of a list, optionally mapping ordinals (the mapping must keep
+        /// their order)
+        /// </summary>
+        private PostingList Rewrite(PostingList list, int[]? newOrdinals)
+        {
+            var rewritten = new PostingList();
+            var cursor = new PostingCursor(list);
+            while (cursor.MoveNext())
+            {
+                if (_documents[cursor.Ordinal] == null)
+                    continue;
+
+                var ordinal = newOrdinals != null ? newOrdinals[cursor.Ordinal] : cursor.Ordinal;
+                rewritten.AppendEncoded(ordinal, cursor.Frequency, cursor.EncodedPositions);
+            }
+            return rewritten;
+        }
+
+        private void RenumberOrdinals()
+        {
+            var newOrdinals = new int[_documents.Count];
+            var documents = new List<DocumentEntry?>(_ordinalById.Count);
+            for (int i = 0; i < _documents.Count; i++)
+            {
+                var entry = _documents[i];
+                if (entry == null) continue;
+
+                newOrdinals[i] = documents.Count;
+                _ordinalById[entry.Id] = documents.Count;
+                documents.Add(entry);
+            }
+
+            foreach (var term in _postings.Keys.ToList())
+            {
+                _postings[term] = Rewrite(_postings[term], newOrdinals);
+            }
+
+            _documents = documents;
+        }
+
+        public void Clear()
+        {
+            lock (_lock)
+            {
+                ClearInternal();
+                UpdateStatistics();
+            }
+        }
+
+        private void ClearInternal()
+        {
+            _postings.Clear();
+            _terms.Clear();
+            _ordinalById.Clear();
+            _documents = new List<DocumentEntry?>();
+            _totalLength = 0;
+        }
+
+        public IEnumerable<TextSearchResult> Search(string searchQuery)
+        {
+            return Search(searchQuery, int.MaxValue);
+        }
+
+        /// <summary>
+        /// The topK best matches for the query, by descending BM25 score
+        /// </summary>
+        public IEnumerable<TextSearchResult> Search(string searchQuery, int topK)
+        {
+            if (searchQuery == null) throw new ArgumentNullException(nameof(searchQuery));
+            if (topK <= 0) throw new ArgumentException("topK must be positive", nameof(topK));
+
+            lock (_lock)
+            {
+                var query = ParseQuery(searchQuery);
+                if (query == null)
+                    return Array.Empty<TextSearchResult>();
+
+                return Execute(query, topK);
+            }
+        }
+
+        public IEnumerable<string> PrefixSearch(string prefix)
+        {
+            if (string.IsNullOrEmpty(prefix))
+                return Array.Empty<string>();
+
+            lock (_lock)
+            {
+                var ordinals = new SortedSet<int>();
+                foreach (var term in TermsWithPrefix(_tokenizer.NormalizePrefix(prefix)))
+                {
+                    var cursor = new PostingCursor(_postings[term]);
+                    while (cursor.MoveNext())
+                    {
+                        if (_documents[cursor.Ordinal] != null)
+                            ordinals.Add(cursor.Ordinal);
+                    }
+                }
+
+                return ordinals.Select(ordinal => _documents[ordinal]!.Id).ToList();
+            }
+        }
+
+        public IEnumerable<string> GetAllTokens()
+        {
+            lock (_lock)
+            {
+                return _terms.ToList();
+            }
+        }
+
+        private IEnumerable<string> TermsWithPrefix(string prefix)
+        {
+            if (_terms.Count == 0)
+                return Array.Empty<string>();
+
+            return _terms.GetViewBetween(prefix, prefix + char.MaxValue);
+        }
+
+        #region Query parsing
+
+        private sealed class QueryTerm
+        {
+            public QueryTerm(string term, PostingList list, double idf)
+            {
+                Term = term;
+                Cursor = new PostingCursor(list);
+                DocumentFrequency = list.Live;
+                Idf = idf;
+            }
+
+            public string Term { get; }
+            public PostingCursor Cursor { get; }
+            public int DocumentFrequency { get; }
+            public double Idf { get; }
+            public bool Required { get; set; }
+
+            // BM25 never exceeds idf * (k1 + 1): tf / (tf + K) < 1
+            public double UpperBound => Idf * (K1 + 1);
+        }
+
+        private sealed class ParsedQuery
+        {
+            public List<QueryTerm> Required { get; } = new List<QueryTerm>();
+            public List<QueryTerm> Optional { get; } = new List<QueryTerm>();
+            public List<PostingCursor> Excluded { get; } = new List<PostingCursor>();
+            public List<List<(QueryTerm Term, int Offset)>> Phrases { get; } = new List<List<(QueryTerm, int)>>();
+        }
+
+        /// <summary>
+        /// Resolve the query's words to posting cursors. Returns null when nothing can match
+        /// (no known terms, or a required word that is not in the index).
+        /// </summary>
+        private ParsedQuery? ParseQuery(string searchQuery)
+        {
+            var terms = new Dictionary<string, QueryTerm>(StringComparer.Ordinal);
+            var excluded = new HashSet<string>(StringComparer.Ordinal);
+            var phrases = new List<List<(QueryTerm, int)>>();
+            var missingRequired = false;
+
+            QueryTerm? Resolve(string term)
+            {
+                if (terms.TryGetValue(term, out var existing))
+                    return existing;
+                if (!_postings.TryGetValue(term, out var list))
+                    return null;
+
+                var idf = Math.Log(1 + (_ordinalById.Count - list.Live + 0.5) / (list.Live + 0.5));
+                var resolved = new QueryTerm(term, list, idf);
+                terms[term] = resolved;
+                return resolved;
+            }
+
+            void AddWords(string text, bool required)
+            {
+                foreach (var (term, _) in _tokenizer.Tokenize(text))
+                {
+                    var resolved = Resolve(term);
+                    if (resolved == null)
+                        missingRequired |= required;
+                    else if (required)
+                        resolved.Required = true;
+                }
+            }
+
+            var words = SplitQuery(searchQuery);
+            for (int i = 0; i < words.Count; i++)
+            {
+                var (word, quoted) = words[i];
+
+                if (quoted)
+                {
+                    var phrase = new List<(QueryTerm, int)>();
+                    foreach (var (term, position) in _tokenizer.Tokenize(word))
+                    {
+                        var resolved = Resolve(term);
+                        if (resolved == null)
+                        {
+                            missingRequired = true;
+                            break;
+                        }
+                        resolved.Required = true;
+                        phrase.Add((resolved, position));
+                    }
+                    if (phrase.Count > 1)
+                        phrases.Add(phrase);
+                    continue;
+                }
+
+                if (word == "OR" || word == "AND")
+                    continue;
+
+                var required = word.StartsWith('+')
+                    || (i > 0 && words[i - 1] == ("AND", false))
+                    || (i + 1 < words.Count && words[i + 1] == ("AND", false));
+
+                if (word.StartsWith('-') && word.Length > 1)
+                {
+                    foreach (var (term, _) in _tokenizer.Tokenize(word.Substring(1)))
+                        excluded.Add(term);
+                }
+                else if (word.EndsWith('*') && word.Length > 1)
+                {
+                    var prefix = _tokenizer.NormalizePrefix(word.TrimStart('+').TrimEnd('*'));
+                    var expansions = TermsWithPrefix(prefix)
+                        .OrderByDescending(term => _postings[term].Live)
+                        .Take(MAX_PREFIX_EXPANSIONS)
+                        .ToList();
+                    foreach (var term in expansions)
+                        Resolve(term);
+                }
+                else
+                {
+                    AddWords(word.TrimStart('+'), required);
+                }
+            }
+
+            if (missingRequired || terms.Count == 0)
+                return null;
+
+            var query = new ParsedQuery();
+            foreach (var term in terms.Values)
+            {
+                if (excluded.Contains(term.Term))
+                    continue;
+                (term.Required ? query.Required : query.Optional).Add(term);
+            }
+            foreach (var term in excluded)
+            {
+                if (_postings.TryGetValue(term, out var list))
+                    query.Excluded.Add(new PostingCursor(list));
+            }
+            query.Phrases.AddRange(phrases);
+
+            return query.Required.Count + query.Optional.Count > 0 ? query : null;
+        }
+
+        /// <summary>
+        /// Split on whitespace, keeping "quoted phrases" whole
+        /// </summary>
+        private static List<(string Word, bool Quoted)> SplitQuery(string searchQuery)
+        {
+            var words = new List<(string, bool)>();
+            var i = 0;
+            while (i < searchQuery.Length)
+            {
+                if (char.IsWhiteSpace(searchQuery[i]))
+                {
+                    i++;
+                    continue;
+                }
+
+                if (searchQuery[i] == '"')
+                {
+                    var end = searchQuery.IndexOf('"', i + 1);
+                    if (end < 0) end = searchQuery.Length;
+                    words.Add((searchQuery.Substring(i + 1, end - i - 1), true));
+                    i = end + 1;
+                    continue;
+                }
+
+                var start = i;
+                while (i < searchQuery.Length && !char.IsWhiteSpace(searchQuery[i]) && searchQuery[i] != '"')
+                    i++;
+                words.Add((searchQuery.Substring(start, i - start), false));
+            }
+            return words;
+        }
+
+        #endregion
+
+        #region Scoring
+
+        private readonly struct Hit
+        {
+            public Hit(int ordinal, double score, List<string> matchedTerms)
+            {
+                Ordinal = ordinal;
+                Score = score;
+                MatchedTerms = matchedTerms;
+            }
+
+            public int Ordinal { get; }
+            public double Score { get; }
+            public List<string> MatchedTerms { get; }
+        }
+
+        private List<TextSearchResult> Execute(ParsedQuery query, int topK)
+        {
+            var heap = new PriorityQueue<Hit, double>();
+            var matched = new List<string>();
+            var averageLength = _ordinalById.Count > 0 ? (double)_totalLength / _ordinalById.Count : 0;
+
+            // Optional terms by ascending upper bound; prefix[i] = sum of bounds of terms 0..i
+            var optional = query.Optional.OrderBy(t => t.UpperBound).ToList();
+            var bounds = new double[optional.Count];
+            for (int i = 0; i < optional.Count; i++)
+                bounds[i] = optional[i].UpperBound + (i > 0 ? bounds[i - 1] : 0);
+
+            double Threshold() => heap.Count >= topK ? heap.Peek().Score : double.NegativeInfinity;
+
+            double Score(QueryTerm term, DocumentEntry document)
+            {
+                var tf = term.Cursor.Frequency;
+                var norm = K1 * (1 - B + B * (averageLength > 0 ? document.Length / averageLength : 1));
+                matched.Add(term.Term);
+                return term.Idf * tf * (K1 + 1) / (tf + norm);
+            }
+
+            // Add optional terms [0, upTo) from the highest bound down, while they could still
+            // lift the document past the threshold
+            double ScoreOptional(int upTo, int ordinal, DocumentEntry document, double score)
+            {
+                for (int i = upTo - 1; i >= 0; i--)
+                {
+                    if (score + bounds[i] <= Threshold())
+                        break;
+
+                    var cursor = optional[i].Cursor;
+                    if (cursor.Advance(ordinal) && cursor.Ordinal == ordinal)
+                        score += Score(optional[i], document);
+                }
+                return score;
+            }
+
+            void Offer(int ordinal, double score)
+            {
+                if (matched.Count == 0 || IsExcluded(query, ordinal) || !MatchesPhrases(query, ordinal))
+                    return;
+
+                var hit = new Hit(ordinal, score, new List<string>(matched));
+                if (heap.Count < topK)
+                    heap.Enqueue(hit, score);
+                else if (score > heap.Peek().Score)
+                    heap.DequeueEnqueue(hit, score);
+            }
+
+            if (query.Required.Count > 0)
+            {
+                // Conjunctive: drive from the rarest required term, probe the others
+                var required = query.Required.OrderBy(t => t.DocumentFrequency).ToList();
+                var driver = required[0].Cursor;
+
+                while (driver.MoveNext())
+                {
+                    var ordinal = driver.Ordinal;
+                    var document = _documents[ordinal];
+                    if (document == null)
+                        continue;
+
+                    var allMatch = true;
+                    var exhausted = false;
+                    for (int i = 1; i < required.Count && allMatch; i++)
+                    {
+                        var cursor = required[i].Cursor;
+                        exhausted = !cursor.Advance(ordinal);
+                        allMatch = !exhausted && cursor.Ordinal == ordinal;
+                    }
+                    if (exhausted) break;
+                    if (!allMatch) continue;
+
+                    matched.Clear();
+                    var score = 0.0;
+                    foreach (var term in required)
+                        score += Score(term, document);
+
+                    score = ScoreOptional(optional.Count, ordinal, document, score);
+                    if (score > Threshold())
+                        Offer(ordinal, score);
+                }
+            }
+            else
+            {
+                // MaxScore: terms [0, firstEssential) are non-essential, since together they
+                // cannot reach the threshold. Only documents in an essential list are candidates.
+                var firstEssential = 0;
+                foreach (var term in optional)
+                    term.Cursor.MoveNext();
+
+                while (firstEssential < optional.Count)
+                {
+                    var ordinal = int.MaxValue;
+                    for (int i = firstEssential; i < optional.Count; i++)
+                        ordinal = Math.Min(ordinal, optional[i].Cursor.Ordinal);
+                    if (ordinal == int.MaxValue)
+                        break;
+
+                    var document = _documents[ordinal];
+                    matched.Clear();
+                    var score = 0.0;
+                    for (int i = firstEssential; i < optional.Count; i++)
+                    {
+                        var cursor = optional[i].Cursor;
+                        if (cursor.Ordinal != ordinal)
+                            continue;
+
+                        if (document != null)
+                            score += Score(optional[i], document);
+                        cursor.MoveNext();
+                    }
+                    if (document == null)
+                        continue;
+
+                    score = ScoreOptional(firstEssential, ordinal, document, score);
+                    if (score <= Threshold())
+                        continue;
+
+                    Offer(ordinal, score);
+
+                    var threshold = Threshold();
+                    while (firstEssential < optional.Count && bounds[firstEssential] <= threshold)
+                        firstEssential++;
+                }
+            }
+
+            var hits = new List<Hit>(heap.Count);
+            while (heap.Count > 0)
+                hits.Add(heap.Dequeue());
+
+            return hits
+                .OrderByDescending(h => h.Score)
+                .ThenBy(h => h.Ordinal)
+                .Select(h => new TextSearchResult
+                {
+                    DocumentId = _documents[h.Ordinal]!.Id,
+                    Score = h.Score,
+                    MatchedTerms = h.MatchedTerms
+                })
+                .ToList();
+        }
+
+        private static bool IsExcluded(ParsedQuery query, int ordinal)
+        {
+            foreach (var cursor in query.Excluded)
+            {
+                if (cursor.Advance(ordinal) && cursor.Ordinal == ordinal)
+                    return true;
+            }
+            return false;
+        }
+
+        /// <summary>
+        /// Phrase words are required, so their cursors are already on the document
+        /// </summary>
+        private static bool MatchesPhrases(ParsedQuery query, int ordinal)
+        {
+            foreach (var phrase in query.Phrases)
+            {
+                var positions = phrase.Select(p => p.Term.Cursor.ReadPositions()).ToList();
+                var anchor = phrase[0].Offset;
+                var found = false;
+
+                foreach (var start in positions[0])
+                {
+                    found = true;
+                    for (int i = 1; i < phrase.Count && found; i++)
+                    {
+                        found = Array.BinarySearch(positions[i], start + phrase[i].Offset - anchor) >= 0;
+                    }
+                    if (found) break;
+                }
+
+                if (!found)
+                    return false;
+            }
+            return true;
+        }
+
+        #endregion
+
+        public IndexStatistics GetStatistics()
+        {
+            lock (_lock)
+            {
+                return new IndexStatistics
+                {
+                    EntryCount = _statistics.EntryCount,
+                    UniqueValueCount = _statistics.UniqueValueCount,
+                    MemoryUsageBytes = EstimateMemoryUsage(),
+                    LastUpdated = _statistics.LastUpdated
+                };
+            }
+        }
+
+        private void UpdateStatistics()
+        {
+            _statistics.EntryCount = _ordinalById.Count;
+            _statistics.UniqueValueCount = _postings.Count;
+            _statistics.LastUpdated = DateTime.UtcNow;
+        }
+
+        /// <summary>
+        /// Posting buffers are exact; per-term and per-document overheads are estimates.
+        /// Computed on demand rather than on every write, since it walks every term.
+        /// </summary>
+        private long EstimateMemoryUsage()
+        {
+            long postingBytes = 0;
+            foreach (var list in _postings.Values)
+                postingBytes += list.SizeBytes;
+            return postingBytes + _postings.Count * 96L + _documents.Count * 48L;
+        }
+
+        private static string GetPropertyName(Expression<Func<T, string>> expression)
+        {
+            if (expression.Body is MemberExpression memberExpr)
+            {
+                return memberExpr.Member.Name;
+            }
+            return "Unknown";
+        }
+
+        private sealed class DocumentEntry
+        {
+            public DocumentEntry(string id, int length, string[] terms)
+            {
+                Id = id;
+                Length = length;
+                Terms = terms;
+            }
+
+            public string Id { get; }
+            public int Length { get; }
+            public string[] Terms { get; }
+        }
+    }
+}
@@ -0,0 +1,638 @@
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Linq.Expressions;
+
+namespace AcornDB.Indexing
+{
+    /// <summary>
+    /// In-memory time-series index. Documents fall into fixed-width buckets (aligned to
+    /// DateTime.MinValue, so hour buckets start on the hour). Each bucket keeps its documents
+    /// in timestamp order, plus a running count, sum, min and max for each value field.
+    ///
+    /// Inserts can arrive in any order, since each only touches its own bucket. A delete
+    /// subtracts from the count and sum. Min and max are recomputed from the bucket's
+    /// documents the next time they are read, and only when the removed value was an extreme.
+    /// Summaries over whole buckets therefore cost O(buckets), and only the partial buckets
+    /// at a range's edges read individual documents.
+    ///
+    /// Also an IOrderedIndex on the timestamp, so the query planner can seek it for WHERE
+    /// predicates on the timestamp property. ForStashTime indexes are keyed on Nut.Timestamp
+    /// instead, which is what TreeQuery.Between/After/Before filter on.
+    ///
+    /// Thread-safe for concurrent reads and writes.
+    /// </summary>
+    public class ManagedTimeSeriesIndex<T> : ITimeSeriesIndex<T>, IOrderedIndex where T : class
+    {
+        /// <summary>
+        /// Key property name of ForStashTime indexes (not a valid C# member name, so it cannot
+        /// clash with a payload property)
+        /// </summary>
+        internal const string StashTimeKey = "Nut.Timestamp";
+
+        private static readonly TimeSpan DefaultBucketSize = TimeSpan.FromHours(1);
+
+        private readonly object _lock = new object();
+        private readonly Func<T, DateTime>? _timestampExtractor;
+        private readonly string[] _valueNames;
+        private readonly Func<T, double>[] _valueExtractors;
+        private readonly long _bucketTicks;
+        private readonly Dictionary<long, Bucket> _buckets = new Dictionary<long, Bucket>();
+        private readonly SortedSet<long> _bucketKeys = new SortedSet<long>();
+        private readonly Dictionary<string, Entry> _entries = new Dictionary<string, Entry>();
+        private readonly string[] _keyPropertyNames;
+
+        private IndexState _state = IndexState.Building;
+        private DateTime _lastUpdated = DateTime.UtcNow;
+
+        public string Name { get; }
+        public IndexType IndexType => IndexType.TimeSeries;
+        public bool IsUnique => false;
+        public IndexState State => _state;
+
+        /// <summary>
+        /// Timestamp of each document. For ForStashTime indexes this is a placeholder:
+        /// timestamps come from Nut.Timestamp.
+        /// </summary>
+        public Expression<Func<T, DateTime>> TimestampSelector { get; }
+
+        public TimeSpan BucketSize { get; }
+
+        /// <summary>
+        /// Whether documents are keyed on when they were stashed (Nut.Timestamp)
+        /// </summary>
+        public bool IndexesStashTime => _timestampExtractor == null;
+
+        public bool IndexesNutMetadata => IndexesStashTime;
+
+        /// <summary>
+        /// Names of the value fields aggregated per bucket
+        /// </summary>
+        public IReadOnlyList<string> ValueNames => _valueNames;
+
+        public IReadOnlyList<string> KeyPropertyNames => _keyPropertyNames;
+
+        public bool IsExact => true;
+
+        /// <summary>
+        /// Count reads bucket totals, so the planner gets exact estimates even when
+        /// timestamps are clustered (as stash times usually are)
+        /// </summary>
+        public bool HasCheapCount => true;
+
+        /// <summary>
+        /// Index on a timestamp property of the payload
+        /// </summary>
+        /// <param name="timestampSelector">Timestamp property (e.g. r => r.Timestamp)</param>
+        /// <param name="config">Bucket size (default one hour) and name</param>
+        /// <param name="valueSelectors">Numeric fields to aggregate per bucket (e.g. r => r.Value)</param>
+        public ManagedTimeSeriesIndex(
+            Expression<Func<T, DateTime>> timestampSelector,
+            IndexConfiguration? config = null,
+            params Expression<Func<T, double>>[] valueSelectors)
+            : this(timestampSelector ?? throw new ArgumentNullException(nameof(timestampSelector)), false, config, valueSelectors)
+        {
+        }
+
+        private ManagedTimeSeriesIndex(
+            Expression<Func<T, DateTime>> timestampSelector,
+            bool stashTime,
+            IndexConfiguration? config,
+            Expression<Func<T, double>>[] valueSelectors)
+        {
+            config ??= new IndexConfiguration();
+            BucketSize = config.TimeBucketSize ?? DefaultBucketSize;
+            if (BucketSize <= TimeSpan.Zero)
+                throw new ArgumentException("Bucket size must be positive", nameof(config));
+
+            TimestampSelector = timestampSelector;
+            _timestampExtractor = stashTime ? null : PropertyAccessors.ForSelector(timestampSelector);
+            _bucketTicks = BucketSize.Ticks;
+            _valueNames = valueSelectors.Select(GetPropertyName).ToArray();
+            _valueExtractors = valueSelectors.Select(selector => PropertyAccessors.ForSelector(selector)).ToArray();
+
+            if (_valueNames.Distinct().Count() != _valueNames.Length)
+                throw new ArgumentException("Value fields must have distinct names", nameof(valueSelectors));
+
+            var keyName = stashTime ? StashTimeKey : GetPropertyName(timestampSelector);
+            _keyPropertyNames = new[] { keyName };
+            Name = config.Name ?? (stashTime
+                ? $"IX_{typeof(T).Name}_StashTime_TimeSeries"
+                : $"IX_{typeof(T).Name}_{keyName}_TimeSeries");
+        }
+
+        /// <summary>
+        /// Index on when documents were stashed (Nut.Timestamp), letting the query planner
+        /// answer TreeQuery.Between/After/Before from buckets
+        /// </summary>
+        public static ManagedTimeSeriesIndex<T> ForStashTime(
+            IndexConfiguration? config = null,
+            params Expression<Func<T, double>>[] valueSelectors)
+        {
+            return new ManagedTimeSeriesIndex<T>(_ => default, true, config, valueSelectors);
+        }
+
+        #region Maintenance
+
+        public void Build(IEnumerable<object> documents)
+        {
+            lock (_lock)
+            {
+                _state = IndexState.Building;
+                ClearInternal();
+
+                foreach (var obj in documents)
+                {
+                    if (obj is Nut<T> nut)
+                    {
+                        AddInternal(nut.Id, nut.Payload, nut.Timestamp);
+                    }
+                }
+
+                _state = IndexState.Ready;
+                _lastUpdated = DateTime.UtcNow;
+            }
+        }
+
+        /// <summary>
+        /// Add or update a document. Accepts the payload, or the Nut (required for
+        /// ForStashTime indexes, which read its timestamp).
+        /// </summary>
+        public void Add(string id, object document)
+        {
+            T? payload;
+            DateTime stashed = default;
+            if (document is Nut<T> nut)
+            {
+                payload = nut.Payload;
+                stashed = nut.Timestamp;
+            }
+            else
+            {
+                payload = document as T;
+                if (IndexesStashTime) return;
+            }
+
+            if (payload == null) return;
+
+            lock (_lock)
+            {
+                AddInternal(id, payload, stashed);
+                _lastUpdated = DateTime.UtcNow;
+            }
+        }
+
+        private void AddInternal(string id, T document, DateTime stashed)
+        {
+            if (_entries.ContainsKey(id))
+            {
+                RemoveInternal(id);
+            }
+
+            var timestamp = _timestampExtractor != null ? _timestampExtractor(document) : stashed;
+            var values = new double[_valueExtractors.Length];
+            for (int i = 0; i < values.Length; i++)
+                values[i] = _valueExtractors[i](document);
+
+            var entry = new Entry(id, timestamp.Ticks, values, document);
+            var key = BucketKey(entry.Ticks);
+            if (!_buckets.TryGetValue(key, out var bucket))
+            {
+                bucket = new Bucket(_valueNames.Length);
+                _buckets[key] = bucket;
+                _bucketKeys.Add(key);
+            }
+
+            bucket.Entries.Add(entry);
+            for (int i = 0; i < values.Length; i++)
+                bucket.Aggregates[i].Include(values[i]);
+
+            _entries[id] = entry;
+        }
+
+        public void Remove(string id)
+        {
+            lock (_lock)
+            {
+                if (RemoveInternal(id))
+                    _lastUpdated = DateTime.UtcNow;
+            }
+        }
+
+        private bool RemoveInternal(string id)
+        {
+            if (!_entries.Remove(id, out var entry))
+                return false;
+
+            var key = BucketKey(entry.Ticks);
+            var bucket = _buckets[key];
+            bucket.Entries.Remove(entry);
+
+            if (bucket.Entries.Count == 0)
+            {
+                _buckets.Remove(key);
+                _bucketKeys.Remove(key);
+                return true;
+            }
+
+            for (int i = 0; i < entry.Values.Length; i++)
+            {
+                var value = entry.Values[i];
+                if (double.IsNaN(value)) continue;
+
+                var aggregate = bucket.Aggregates[i];
+                aggregate.Count--;
+                aggregate.Sum -= value;
+
+                // Only the bucket's documents know the next smallest or largest value
+                if (value <= aggregate.Min || value >= aggregate.Max)
+                    bucket.Stale[i] = true;
+            }
+            return true;
+        }
+
+        public void Clear()
+        {
+            lock (_lock)
+            {
+                ClearInternal();
+                _lastUpdated = DateTime.UtcNow;
+            }
+        }
+
+        private void ClearInternal()
+        {
+            _buckets.Clear();
+            _bucketKeys.Clear();
+            _entries.Clear();
+        }
+
+        #endregion
+
+        #region ITimeSeriesIndex
+
+        public IEnumerable<string> Range(DateTime start, DateTime end)
+        {
+            return Seek(new IndexRange { Lower = start, Upper = end });
+        }
+
+        public IEnumerable<string> After(DateTime after)
+        {
+            return Seek(new IndexRange { Lower = after, LowerInclusive = false });
+        }
+
+        public IEnumerable<string> Before(DateTime before)
+        {
+            return Seek(new IndexRange { Upper = before, UpperInclusive = false });
+        }
+
+        public IEnumerable<TimeBucket> GetBuckets(DateTime start, DateTime end)
+        {
+            lock (_lock)
+            {
+                return BucketsInRange(start.Ticks, end.Ticks)
+                    .Select(slice => new TimeBucket
+                    {
+                        BucketStart = new DateTime(slice.Key * _bucketTicks),
+                        BucketEnd = BucketEnd(slice.Key),
+                        DocumentIds = slice.Entries.Select(e => e.Id).ToList()
+                    })
+                    .ToList();
+            }
+        }
+
+        public IEnumerable<TimeBucket<TAggregate>> Aggregate<TAggregate>(
+            DateTime start,
+            DateTime end,
+            Func<IEnumerable<T>, TAggregate> aggregateFunc)
+        {
+            if (aggregateFunc == null) throw new ArgumentNullException(nameof(aggregateFunc));
+
+            List<(long Key, List<Entry> Entries)> slices;
+            lock (_lock)
+            {
+                slices = BucketsInRange(start.Ticks, end.Ticks)
+                    .Select(slice => (slice.Key, slice.Entries.ToList()))
+                    .ToList();
+            }
+
+            // User code runs outside the lock
+            return slices.Select(slice => new TimeBucket<TAggregate>
+            {
+                BucketStart = new DateTime(slice.Key * _bucketTicks),
+                BucketEnd = BucketEnd(slice.Key),
+                DocumentIds = slice.Entries.Select(e => e.Id).ToList(),
+                AggregateValue = aggregateFunc(slice.Entries.Select(e => e.Document))
+            }).ToList();
+        }
+
+        /// <summary>
+        /// Count and value aggregates per bucket between start and end (inclusive), from the
+        /// running totals. Buckets cut by start or end are totalled from their documents in the
+        /// range. With an interval (a multiple of BucketSize), consecutive buckets are rolled up,
+        /// e.g. hourly buckets reported per day. Empty buckets are omitted.
+        /// </summary>
+        public IEnumerable<TimeBucketSummary> Summarize(DateTime start, DateTime end, TimeSpan? interval = null)
+        {
+            var groupTicks = interval?.Ticks ?? _bucketTicks;
+            if (groupTicks <= 0 || groupTicks % _bucketTicks != 0)
+                throw new ArgumentException($"Interval must be a positive multiple of the bucket size ({BucketSize})", nameof(interval));
+
+            var summaries = new List<TimeBucketSummary>();
+            lock (_lock)
+            {
+                TimeBucketSummary? current = null;
+                foreach (var slice in BucketsInRange(start.Ticks, end.Ticks))
+                {
+                    var groupStart = slice.Key * _bucketTicks / groupTicks * groupTicks;
+                    if (current == null || current.BucketStart.Ticks != groupStart)
+                    {
+                        current = NewSummary(new DateTime(groupStart), new DateTime(Math.Min(groupStart + groupTicks, DateTime.MaxValue.Ticks)));
+                        summaries.Add(current);
+                    }
+
+                    AddToSummary(current, slice);
+                }
+            }
+            return summaries;
+        }
+
+        /// <summary>
+        /// One summary over everything between start and end (inclusive), e.g. the count and
+        /// average of the last 24 hours
+        /// </summary>
+        public TimeBucketSummary SummarizeRange(DateTime start, DateTime end)
+        {
+            var summary = NewSummary(start, end);
+            lock (_lock)
+            {
+                foreach (var slice in BucketsInRange(start.Ticks, end.Ticks))
+                {
+                    AddToSummary(summary, slice);
+                }
+            }
+            return summary;
+        }
+
+        private TimeBucketSummary NewSummary(DateTime start, DateTime end)
+        {
+            var summary = new TimeBucketSummary { BucketStart = start, BucketEnd = end };
+            foreach (var name in _valueNames)
+                summary.Values[name] = new TimeSeriesAggregate();
+            return summary;
+        }
+
+        private void AddToSummary(TimeBucketSummary summary, BucketSlice slice)
+        {
+            if (slice.IsWhole)
+            {
+                summary.Count += slice.Bucket.Entries.Count;
+                for (int i = 0; i < _valueNames.Length; i++)
+                    summary.Values[_valueNames[i]].Merge(slice.Bucket.GetAggregate(i));
+                return;
+            }
+
+            foreach (var entry in slice.Entries)
+            {
+                summary.Count++;
+                for (int i = 0; i < _valueNames.Length; i++)
+                    summary.Values[_valueNames[i]].Include(entry.Values[i]);
+            }
+        }
+
+        #endregion
+
+        #region IOrderedIndex
+
+        public bool TryNormalizeKey(int keyPart, object? value, out object? key)
+        {
+            key = value;
+            return keyPart == 0 && value is DateTime;
+        }
+
+        public IEnumerable<string> Seek(IndexRange range, bool descending = false)
+        {
+            var (low, high) = ToTicks(range);
+            if (low > high)
+                yield break;
+
+            List<long> keys;
+            lock (_lock)
+            {
+                keys = KeysInRange(low, high).ToList();
+            }
+            if (descending)
+                keys.Reverse();
+
+            // One bucket per lock acquisition, so writers are not held up by long scans
+            foreach (var key in keys)
+            {
+                List<string> ids;
+                lock (_lock)
+                {
+                    if (!_buckets.TryGetValue(key, out var bucket))
+                        continue;
+
+                    var entries = Slice(key, bucket, low, high).Entries;
+                    ids = (descending ? entries.Reverse() : entries).Select(e => e.Id).ToList();
+                }
+
+                foreach (var id in ids)
+                    yield return id;
+            }
+        }
+
+        public long Count(IndexRange range)
+        {
+            var (low, high) = ToTicks(range);
+            if (low > high)
+                return 0;
+
+            lock (_lock)
+            {
+                long count = 0;
+                foreach (var slice in BucketsInRange(low, high))
+                    count += slice.IsWhole ? slice.Bucket.Entries.Count : slice.Entries.Count;
+                return count;
+            }
+        }
+
+        private static (long Low, long High) ToTicks(IndexRange range)
+        {
+            if (range.Prefix.Count > 0)
+            {
+                var ticks = ((DateTime)range.Prefix[0]!).Ticks;
+                return (ticks, ticks);
+            }
+
+            var low = range.Lower is DateTime lower ? lower.Ticks + (range.LowerInclusive ? 0 : 1) : DateTime.MinValue.Ticks;
+            var high = range.Upper is DateTime upper ? upper.Ticks - (range.UpperInclusive ? 0 : 1) : DateTime.MaxValue.Ticks;
+            return (low, high);
+        }
+
+        #endregion
+
+        #region Buckets
+
+        private long BucketKey(long ticks) => ticks / _bucketTicks;
+
+        private DateTime BucketEnd(long key) => new DateTime(Math.Min((key + 1) * _bucketTicks, DateTime.MaxValue.Ticks));
+
+        private IEnumerable<long> KeysInRange(long low, long high)
+        {
+            if (_bucketKeys.Count == 0 || low > high)
+                return Array.Empty<long>();
+
+            return _bucketKeys.GetViewBetween(BucketKey(low), BucketKey(high));
+        }
+
+        /// <summary>
+        /// Non-empty buckets overlapping [low, high], each with the entries inside the range
+        /// </summary>
+        private IEnumerable<BucketSlice> BucketsInRange(long low, long high)
+        {
+            foreach (var key in KeysInRange(low, high))
+            {
+                var slice = Slice(key, _buckets[key], low, high);
+                if (slice.IsWhole || slice.Entries.Count > 0)
+                    yield return slice;
+            }
+        }
+
+        private BucketSlice Slice(long key, Bucket bucket, long low, long high)
+        {
+            var bucketStart = key * _bucketTicks;
+            var bucketLast = bucketStart + _bucketTicks - 1;
+            if (low <= bucketStart && high >= bucketLast)
+                return new BucketSlice(key, bucket, bucket.Entries, isWhole: true);
+
+            var view = bucket.Entries.GetViewBetween(
+                new Entry(string.Empty, Math.Max(low, bucketStart)),
+                new Entry(null, Math.Min(high, bucketLast)));
+            return new BucketSlice(key, bucket, view, isWhole: false);
+        }
+
+        private readonly struct BucketSlice
+        {
+            public BucketSlice(long key, Bucket bucket, SortedSet<Entry> entries, bool isWhole)
+            {
+                Key = key;
+                Bucket = bucket;
+                Entries = entries;
+                IsWhole = isWhole;
+            }
+
+            public long Key { get; }
+            public Bucket Bucket { get; }
+            public SortedSet<Entry> Entries { get; }
+            public bool IsWhole { get; }
+        }
+
+        private sealed class Bucket
+        {
+            public Bucket(int valueCount)
+            {
+                Aggregates = Enumerable.Range(0, valueCount).Select(_ => new TimeSeriesAggregate()).ToArray();
+                Stale = new bool[valueCount];
+            }
+
+            public SortedSet<Entry> Entries { get; } = new SortedSet<Entry>(EntryComparer.Instance);
+            public TimeSeriesAggregate[] Aggregates { get; }
+
+            // Min/max no longer known after a delete removed an extreme value
+            public bool[] Stale { get; }
+
+            public TimeSeriesAggregate GetAggregate(int field)
+            {
+                if (Stale[field])
+                {
+                    var aggregate = new TimeSeriesAggregate();
+                    foreach (var entry in Entries)
+                        aggregate.Include(entry.Values[field]);
+                    Aggregates[field] = aggregate;
+                    Stale[field] = false;
+                }
+                return Aggregates[field];
+            }
+        }
+
+        private sealed class Entry
+        {
+            public Entry(string id, long ticks, double[] values, T document)
+            {
+                Id = id;
+                Ticks = ticks;
+                Values = values;
+                Document = document;
+            }
+
+            /// <summary>
+            /// Seek bound: an empty id sorts before every document at that tick, a null id after
+            /// </summary>
+            public Entry(string? id, long ticks)
+            {
+                Id = id!;
+                Ticks = ticks;
+                Values = Array.Empty<double>();
+                Document = null!;
+            }
+
+            public string Id { get; }
+            public long Ticks { get; }
+            public double[] Values { get; }
+            public T Document { get; }
+        }
+
+        private sealed class EntryComparer : IComparer<Entry>
+        {
+            public static readonly EntryComparer Instance = new EntryComparer();
+
+            public int Compare(Entry? x, Entry? y)
+            {
+                var byTime = x!.Ticks.CompareTo(y!.Ticks);
+                if (byTime != 0) return byTime;
+                if (x.Id == null) return y.Id == null ? 0 : 1;
+                if (y.Id == null) return -1;
+                return string.CompareOrdinal(x.Id, y.Id);
+            }
+        }
+
+        #endregion
+
+        public IndexStatistics GetStatistics()
+        {
+            lock (_lock)
+            {
+                var statistics = new IndexStatistics
+                {
+                    EntryCount = _entries.Count,
+                    UniqueValueCount = _entries.Count,
+                    LastUpdated = _lastUpdated,
+                    KeyPartCount = 1,
+
+                    // Entries plus per-bucket sets and aggregates (rough)
+                    MemoryUsageBytes = _entries.Count * (96L + _valueNames.Length * 8) + _buckets.Count * (64L + _valueNames.Length * 40)
+                };
+
+                if (_bucketKeys.Count > 0)
+                {
+                    statistics.MinKey = new DateTime(_buckets[_bucketKeys.Min].Entries.Min!.Ticks);
+                    statistics.MaxKey = new DateTime(_buckets[_bucketKeys.Max].Entries.Max!.Ticks);
+                }
+                return statistics;
+            }
+        }
+
+        private static string GetPropertyName<TValue>(Expression<Func<T, TValue>> expression)
+        {
+            var body = expression.Body is UnaryExpression { NodeType: ExpressionType.Convert } convert
+                ? convert.Operand
+                : expression.Body;
+            if (body is MemberExpression memberExpr)
+            {
+                return memberExpr.Member.Name;
+            }
+            return "Unknown";
+        }
+    }
+}
@@ -0,0 +1,268 @@
+using System;
+using System.Collections.Generic;
+
+namespace AcornDB.Indexing
+{
+    /// <summary>
+    /// Compressed posting list of a text index term: for each document (by ordinal, ascending)
+    /// the term frequency and word positions, all as LEB128 varints. Ordinals and positions are
+    /// delta-encoded, so a posting is usually 3-4 bytes. Every SKIP_INTERVAL postings a skip
+    /// point is recorded, letting cursors jump ahead without decoding the postings in between.
+    ///
+    /// Layout per posting: ordinal delta, frequency, byte length of positions, position deltas.
+    /// Not thread-safe; ManagedTextIndex guards it with its lock.
+    /// </summary>
+    internal sealed class PostingList
+    {
+        private const int SKIP_INTERVAL = 64;
+
+        private byte[] _buffer = new byte[16];
+        private int _length;
+        private int _lastOrdinal = -1;
+        private readonly List<SkipPoint> _skips = new List<SkipPoint>();
+
+        /// <summary>
+        /// Postings stored, including those of documents removed since
+        /// </summary>
+        public int Count { get; private set; }
+
+        /// <summary>
+        /// Postings of live documents: the term's document frequency
+        /// </summary>
+        public int Live { get; set; }
+
+        public int SizeBytes => _buffer.Length;
+
+        internal byte[] Buffer => _buffer;
+        internal int Length => _length;
+        internal List<SkipPoint> Skips => _skips;
+
+        /// <summary>
+        /// Append a posting. Ordinals must increase, which holds because ManagedTextIndex
+        /// gives every added or updated document a new, higher ordinal.
+        /// </summary>
+        public void Append(int ordinal, List<int> positions)
+        {
+            var positionBytes = 0;
+            var previous = 0;
+            foreach (var position in positions)
+            {
+                positionBytes += VarintSize(position - previous);
+                previous = position;
+            }
+
+            BeginPosting(ordinal, positions.Count, positionBytes);
+
+            previous = 0;
+            foreach (var position in positions)
+            {
+                WriteVarint(position - previous);
+                previous = position;
+            }
+        }
+
+        /// <summary>
+        /// Append a posting whose positions are already encoded (copied from another list)
+        /// </summary>
+        public void AppendEncoded(int ordinal, int frequency, ReadOnlySpan<byte> positions)
+        {
+            BeginPosting(ordinal, frequency, positions.Length);
+            positions.CopyTo(_buffer.AsSpan(_length));
+            _length += positions.Length;
+        }
+
+        private void BeginPosting(int ordinal, int frequency, int positionBytes)
+        {
+            if (ordinal <= _lastOrdinal)
+                throw new ArgumentException($"Ordinal {ordinal} is not greater than {_lastOrdinal}", nameof(ordinal));
+
+            if (Count % SKIP_INTERVAL == 0)
+                _skips.Add(new SkipPoint(_lastOrdinal, _length, Count));
+
+            EnsureCapacity(15 + positionBytes);
+            WriteVarint(ordinal - _lastOrdinal);
+            WriteVarint(frequency);
+            WriteVarint(positionBytes);
+
+            _lastOrdinal = ordinal;
+            Count++;
+            Live++;
+        }
+
+        private void EnsureCapacity(int extra)
+        {
+            if (_length + extra <= _buffer.Length)
+                return;
+
+            Array.Resize(ref _buffer, Math.Max(_buffer.Length * 2, _length + extra));
+        }
+
+        private void WriteVarint(int value)
+        {
+            var v = (uint)value;
+            while (v >= 0x80)
+            {
+                _buffer[_length++] = (byte)(v | 0x80);
+                v >>= 7;
+            }
+            _buffer[_length++] = (byte)v;
+        }
+
+        private static int VarintSize(int value)
+        {
+            var v = (uint)value;
+            var size = 1;
+            while (v >= 0x80)
+            {
+                v >>= 7;
+                size++;
+            }
+            return size;
+        }
+
+        internal static int ReadVarint(byte[] buffer, ref int offset)
+        {
+            uint result = 0;
+            var shift = 0;
+            byte b;
+            do
+            {
+                b = buffer[offset++];
+                result |= (uint)(b & 0x7F) << shift;
+                shift += 7;
+            }
+            while ((b & 0x80) != 0);
+            return (int)result;
+        }
+
+        /// <summary>
+        /// Start of a block of postings: the ordinal before it, its byte offset and how many
+        /// postings precede it
+        /// </summary>
+        internal readonly struct SkipPoint
+        {
+            public SkipPoint(int previousOrdinal, int offset, int index)
+            {
+                PreviousOrdinal = previousOrdinal;
+                Offset = offset;
+                Index = index;
+            }
+
+            public int PreviousOrdinal { get; }
+            public int Offset { get; }
+            public int Index { get; }
+        }
+    }
+
+    /// <summary>
+    /// Forward-only reader over a PostingList. Call MoveNext (or Advance) before reading.
+    /// </summary>
+    internal sealed class PostingCursor
+    {
+        private readonly PostingList _list;
+        private int _offset;
+        private int _index;
+
+        public PostingCursor(PostingList list)
+        {
+            _list = list;
+        }
+
+        /// <summary>
+        /// Ordinal of the current posting; int.MaxValue once exhausted
+        /// </summary>
+        public int Ordinal { get; private set; } = -1;
+
+        public int Frequency { get; private set; }
+
+        public bool Done { get; private set; }
+
+        private int _positionsOffset;
+        private int _positionsLength;
+
+        public bool MoveNext()
+        {
+            if (Done)
+                return false;
+
+            var buffer = _list.Buffer;
+            if (_offset >= _list.Length)
+            {
+                Done = true;
+                Ordinal = int.MaxValue;
+                return false;
+            }
+
+            Ordinal += PostingList.ReadVarint(buffer, ref _offset);
+            Frequency = PostingList.ReadVarint(buffer, ref _offset);
+            _positionsLength = PostingList.ReadVarint(buffer, ref _offset);
+            _positionsOffset = _offset;
+            _offset += _positionsLength;
+            _index++;
+            return true;
+        }
+
+        /// <summary>
+        /// Move to the first posting with ordinal >= target. Returns false when there is none.
+        /// </summary>
+        public bool Advance(int target)
+        {
+            if (Done)
+                return false;
+            if (_index > 0 && Ordinal >= target)
+                return true;
+
+            // Jump to the last block that starts before target, if it is ahead of the cursor
+            var skips = _list.Skips;
+            int lo = 0, hi = skips.Count - 1, found = -1;
+            while (lo <= hi)
+            {
+                var mid = (lo + hi) >> 1;
+                if (skips[mid].PreviousOrdinal < target)
+                {
+                    found = mid;
+                    lo = mid + 1;
+                }
+                else
+                {
+                    hi = mid - 1;
+                }
+            }
+
+            if (found >= 0 && skips[found].Index > _index)
+            {
+                _offset = skips[found].Offset;
+                _index = skips[found].Index;
+                Ordinal = skips[found].PreviousOrdinal;
+            }
+
+            while (MoveNext())
+            {
+                if (Ordinal >= target)
+                    return true;
+            }
+            return false;
+        }
+
+        /// <summary>
+        /// Word positions of the term in the current document, ascending
+        /// </summary>
+        public int[] ReadPositions()
+        {
+            var positions = new int[Frequency];
+            var offset = _positionsOffset;
+            var position = 0;
+            for (int i = 0; i < positions.Length; i++)
+            {
+                position += PostingList.ReadVarint(_list.Buffer, ref offset);
+                positions[i] = position;
+            }
+            return positions;
+        }
+
+        /// <summary>
+        /// Encoded positions of the current posting (for copying into another list)
+        /// </summary>
+        public ReadOnlySpan<byte> EncodedPositions => _list.Buffer.AsSpan(_positionsOffset, _positionsLength);
+    }
+}
@@ -0,0 +1,140 @@
+using System;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.Linq;
+using System.Linq.Expressions;
+using System.Reflection;
+
+namespace AcornDB.Indexing
+{
+    /// <summary>
+    /// Compiled property accessors, generated once per type and member and shared by indexes,
+    /// the query analyzer, ID detection and the MessagePack serializer. Every read after the first is a plain delegate call:
+    /// no reflection, and no boxing when the result type is a value type.
+    /// </summary>
+    internal static class PropertyAccessors
+    {
+        public delegate void RefSetter<T, TValue>(ref T instance, TValue value);
+
+        private static readonly ConcurrentDictionary<MemberInfo, Func<object?, object?>> BoxedGetters = new();
+
+        /// <summary>
+        /// Delegate for a key selector. Direct member selectors (x => x.Age) share one compiled
+        /// getter per member across every index and tree over T.
+        /// </summary>
+        public static Func<T, TProperty> ForSelector<T, TProperty>(Expression<Func<T, TProperty>> selector)
+        {
+            if (selector.Body is MemberExpression { Expression: ParameterExpression } member)
+            {
+                return SelectorCache<T, TProperty>.Getters.GetOrAdd(member.Member, _ => selector.Compile());
+            }
+
+            return selector.Compile();
+        }
+
+        /// <summary>
+        /// One delegate that evaluates every key part selector into a new array, instead of an
+        /// invocation (and a LINQ pass) per part
+        /// </summary>
+        public static Func<T, object?[]> ForKeyParts<T>(IReadOnlyList<LambdaExpression> selectors)
+        {
+            var parameter = Expression.Parameter(typeof(T), "document");
+            var parts = selectors.Select(selector =>
+            {
+                var body = new ParameterRebinder(selector.Parameters[0], parameter).Visit(selector.Body);
+                return body.Type == typeof(object) ? body : Expression.Convert(body, typeof(object));
+            });
+
+            return Expression.Lambda<Func<T, object?[]>>(Expression.NewArrayInit(typeof(object), parts), parameter).Compile();
+        }
+
+        /// <summary>
+        /// Delegate reading a property as a string: the property itself when it is a string,
+        /// otherwise its ToString() without boxing (null for null references)
+        /// </summary>
+        public static Func<T, string?> ForString<T>(PropertyInfo property)
+        {
+            var parameter = Expression.Parameter(typeof(T), "item");
+            Expression value = Expression.Property(parameter, property);
+
+            if (value.Type != typeof(string))
+            {
+                var toString = Expression.Call(value, value.Type.GetMethod(nameof(ToString), Type.EmptyTypes)!);
+                value = value.Type.IsValueType
+                    ? toString
+                    : Expression.Condition(
+                        Expression.Equal(value, Expression.Constant(null, value.Type)),
+                        Expression.Constant(null, typeof(string)),
+                        toString);
+            }
+
+            return Expression.Lambda<Func<T, string?>>(value, parameter).Compile();
+        }
+
+        /// <summary>
+        /// Cached getter for a field or property on an arbitrary instance (null for static
+        /// members), e.g. a variable captured by a query's closure
+        /// </summary>
+        public static Func<object?, object?> ForMember(MemberInfo member)
+        {
+            return BoxedGetters.GetOrAdd(member, static member =>
+            {
+                var instance = Expression.Parameter(typeof(object), "instance");
+                var isStatic = member switch
+                {
+                    FieldInfo field => field.IsStatic,
+                    PropertyInfo property => property.GetMethod?.IsStatic ?? false,
+                    _ => throw new ArgumentException($"Member '{member.Name}' is not a field or property", nameof(member))
+                };
+
+                var target = isStatic ? null : Expression.Convert(instance, member.DeclaringType!);
+                var access = Expression.MakeMemberAccess(target, member);
+                var boxed = Expression.Convert(access, typeof(object));
+                return Expression.Lambda<Func<object?, object?>>(boxed, instance).Compile();
+            });
+        }
+
+        /// <summary>
+        /// Typed getter for a field or property of T
+        /// </summary>
+        public static Func<T, TValue> ForGetter<T, TValue>(MemberInfo member)
+        {
+            var instance = Expression.Parameter(typeof(T), "instance");
+            return Expression.Lambda<Func<T, TValue>>(Expression.MakeMemberAccess(instance, member), instance).Compile();
+        }
+
+        /// <summary>
+        /// Typed setter for a field or property of T. The instance is passed by reference so
+        /// the same delegate shape assigns members of structs in place.
+        /// </summary>
+        public static RefSetter<T, TValue> ForSetter<T, TValue>(MemberInfo member)
+        {
+            var instance = Expression.Parameter(typeof(T).MakeByRefType(), "instance");
+            var value = Expression.Parameter(typeof(TValue), "value");
+            var assign = Expression.Assign(Expression.MakeMemberAccess(instance, member), value);
+            return Expression.Lambda<RefSetter<T, TValue>>(assign, instance, value).Compile();
+        }
+
+        private static class SelectorCache<T, TProperty>
+        {
+            public static readonly ConcurrentDictionary<MemberInfo, Func<T, TProperty>> Getters = new();
+        }
+
+        internal sealed class ParameterRebinder : ExpressionVisitor
+        {
+            private readonly ParameterExpression _from;
+            private readonly ParameterExpression _to;
+
+            public ParameterRebinder(ParameterExpression from, ParameterExpression to)
+            {
+                _from = from;
+                _to = to;
+            }
+
+            protected override Expression VisitParameter(ParameterExpression node)
+            {
+                return node == _from ? _to : base.VisitParameter(node);
+            }
+        }
+    }
+}
@@ -0,0 +1,102 @@
+using System;
+using System.Collections.Generic;
+using System.Globalization;
+
+namespace AcornDB.Indexing
+{
+    /// <summary>
+    /// Splits text into lowercase word tokens with their positions, for text indexes and the
+    /// queries against them. For "english" it drops stop words and strips plural endings, so
+    /// "Meetings" and "meeting" index the same term. Positions count every word, including
+    /// dropped stop words, so phrase queries keep their gaps.
+    /// </summary>
+    internal sealed class TextTokenizer
+    {
+        private static readonly HashSet<string> EnglishStopWords = new HashSet<string>(StringComparer.Ordinal)
+        {
+            "a", "an", "and", "are", "as", "at", "be", "but", "by", "for", "if", "in", "into", "is",
+            "it", "no", "not", "of", "on", "or", "such", "that", "the", "their", "then", "there",
+            "these", "they", "this", "to", "was", "will", "with"
+        };
+
+        private readonly bool _english;
+
+        public TextTokenizer(string language)
+        {
+            Language = language ?? throw new ArgumentNullException(nameof(language));
+            _english = string.Equals(language, "english", StringComparison.OrdinalIgnoreCase);
+        }
+
+        public string Language { get; }
+
+        /// <summary>
+        /// Index terms of the text and the word position of each
+        /// </summary>
+        public List<(string Term, int Position)> Tokenize(string? text)
+        {
+            var tokens = new List<(string Term, int Position)>();
+            if (string.IsNullOrEmpty(text))
+                return tokens;
+
+            var position = 0;
+            var start = -1;
+            for (int i = 0; i <= text.Length; i++)
+            {
+                var isWordChar = i < text.Length && char.IsLetterOrDigit(text[i]);
+                if (isWordChar)
+                {
+                    if (start < 0) start = i;
+                    continue;
+                }
+
+                if (start < 0)
+                    continue;
+
+                var term = Normalize(text.AsSpan(start, i - start));
+                if (term != null)
+                    tokens.Add((term, position));
+
+                position++;
+                start = -1;
+            }
+
+            return tokens;
+        }
+
+        /// <summary>
+        /// Lowercase form used to match a prefix against index terms (not stemmed: a prefix is
+        /// usually a partial word)
+        /// </summary>
+        public string NormalizePrefix(string prefix)
+        {
+            return prefix.ToLowerInvariant();
+        }
+
+        private string? Normalize(ReadOnlySpan<char> word)
+        {
+            var term = word.ToString().ToLower(CultureInfo.InvariantCulture);
+            if (!_english)
+                return term;
+
+            if (EnglishStopWords.Contains(term))
+                return null;
+
+            return Stem(term);
+        }
+
+        /// <summary>
+        /// Plural stripping only (the first step of Porter's algorithm): cheap, and it never
+        /// merges words with different meanings the way full stemmers sometimes do
+        /// </summary>
+        private static string Stem(string term)
+        {
+            if (term.Length > 4 && term.EndsWith("ies", StringComparison.Ordinal))
+                return term.Substring(0, term.Length - 3) + "y";
+            if (term.Length > 4 && term.EndsWith("sses", StringComparison.Ordinal))
+                return term.Substring(0, term.Length - 2);
+            if (term.Length > 3 && term[^1] == 's' && term[^2] != 's' && term[^2] != 'u' && term[^2] != 'i')
+                return term.Substring(0, term.Length - 1);
+            return term;
+        }
+    }
+}
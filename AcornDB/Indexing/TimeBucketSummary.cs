@@ -0,0 +1,65 @@
+using System;
+using System.Collections.Generic;
+
+namespace AcornDB.Indexing
+{
+    /// <summary>
+    /// Pre-aggregated statistics for one time bucket (or a roll-up of several)
+    /// </summary>
+    public class TimeBucketSummary
+    {
+        /// <summary>
+        /// Start of the bucket (for SummarizeRange, of the range)
+        /// </summary>
+        public DateTime BucketStart { get; set; }
+
+        /// <summary>
+        /// End of the bucket, exclusive (for SummarizeRange, the range's inclusive end)
+        /// </summary>
+        public DateTime BucketEnd { get; set; }
+
+        /// <summary>
+        /// Number of documents in the bucket
+        /// </summary>
+        public long Count { get; set; }
+
+        /// <summary>
+        /// Running aggregates per value field, by field name
+        /// </summary>
+        public Dictionary<string, TimeSeriesAggregate> Values { get; set; } = new Dictionary<string, TimeSeriesAggregate>();
+    }
+
+    /// <summary>
+    /// Count, sum, min and max of one numeric field over a time bucket
+    /// </summary>
+    public class TimeSeriesAggregate
+    {
+        public long Count { get; set; }
+        public double Sum { get; set; }
+        public double Min { get; set; } = double.NaN;
+        public double Max { get; set; } = double.NaN;
+        public double Average => Count > 0 ? Sum / Count : double.NaN;
+
+        internal void Include(double value)
+        {
+            if (double.IsNaN(value))
+                return;
+
+            Min = Count == 0 || value < Min ? value : Min;
+            Max = Count == 0 || value > Max ? value : Max;
+            Sum += value;
+            Count++;
+        }
+
+        internal void Merge(TimeSeriesAggregate other)
+        {
+            if (other.Count == 0)
+                return;
+
+            Min = Count == 0 || other.Min < Min ? other.Min : Min;
+            Max = Count == 0 || other.Max > Max ? other.Max : Max;
+            Sum += other.Sum;
+            Count += other.Count;
+        }
+    }
+}
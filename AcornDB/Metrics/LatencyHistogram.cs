@@ -0,0 +1,224 @@
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Threading;
+
+namespace AcornDB.Metrics
+{
+    /// <summary>
+    /// HDR-style latency histogram with fixed log-linear buckets: values are kept in microseconds,
+    /// exactly below 32µs and with 32 linear sub-buckets per power of two above, so every
+    /// recorded value is known to within ~3% up to several hours.
+    ///
+    /// Each power of two gets its own small array, allocated the first time a value lands in it,
+    /// so a histogram only pays for the latency range it actually sees.
+    ///
+    /// Recording is lock-free and allocation-free once warm (one bucket increment plus a running
+    /// sum), so
+    /// hot paths can hold on to a histogram from <see cref="MetricsCollector.GetLatencyHistogram"/>
+    /// and record every call. Readers see a slightly stale but consistent-enough snapshot.
+    /// </summary>
+    public sealed class LatencyHistogram
+    {
+        private const int SubBucketBits = 5;
+        private const int SubBuckets = 1 << SubBucketBits;
+
+        // Highest power of two tracked; larger values land in the last bucket (~19 hours)
+        private const int MaxExponent = 36;
+        private const int OctaveCount = MaxExponent - SubBucketBits + 2;
+        private const int BucketCount = OctaveCount * SubBuckets;
+
+        private readonly long[]?[] _octaves = new long[OctaveCount][];
+        private long _sumMicros;
+        private long _maxMicros;
+
+        public string Operation { get; }
+        public string Tree { get; }
+        public string Trunk { get; }
+
+        public LatencyHistogram(string operation = "", string tree = "", string trunk = "")
+        {
+            Operation = operation;
+            Tree = tree;
+            Trunk = trunk;
+        }
+
+        public void Record(double milliseconds)
+        {
+            RecordMicros(milliseconds <= 0 ? 0 : (long)(milliseconds * 1000));
+        }
+
+        public void Record(TimeSpan elapsed)
+        {
+            RecordMicros(elapsed.Ticks / (TimeSpan.TicksPerMillisecond / 1000));
+        }
+
+        /// <summary>
+        /// Record the time since a <see cref="Stopwatch.GetTimestamp"/> reading
+        /// </summary>
+        public void RecordSince(long startTimestamp)
+        {
+            RecordMicros((Stopwatch.GetTimestamp() - startTimestamp) * 1_000_000 / Stopwatch.Frequency);
+        }
+
+        private void RecordMicros(long micros)
+        {
+            if (micros < 0)
+                micros = 0;
+
+            var index = BucketIndex(micros);
+            Interlocked.Increment(ref OctaveFor(index)[index & (SubBuckets - 1)]);
+            Interlocked.Add(ref _sumMicros, micros);
+
+            long current;
+            while (micros > (current = Volatile.Read(ref _maxMicros)))
+            {
+                if (Interlocked.CompareExchange(ref _maxMicros, micros, current) == current)
+                    break;
+            }
+        }
+
+        public long Count
+        {
+            get
+            {
+                Snapshot(out var total);
+                return total;
+            }
+        }
+
+        public double SumMilliseconds => Volatile.Read(ref _sumMicros) / 1000.0;
+        public double MaxMilliseconds => Volatile.Read(ref _maxMicros) / 1000.0;
+
+        /// <summary>
+        /// Value at the given quantile (0-1) in milliseconds, reported as the upper edge of its
+        /// bucket and never above the largest recorded value
+        /// </summary>
+        public double GetPercentile(double percentile)
+        {
+            var counts = Snapshot(out var total);
+            if (total == 0)
+                return 0;
+
+            var rank = Math.Max(1, (long)Math.Ceiling(Math.Clamp(percentile, 0, 1) * total));
+            long seen = 0;
+            for (int i = 0; i < counts.Length; i++)
+            {
+                seen += counts[i];
+                if (seen >= rank)
+                    return Math.Min(UpperBoundMicros(i), Volatile.Read(ref _maxMicros)) / 1000.0;
+            }
+            return MaxMilliseconds;
+        }
+
+        /// <summary>
+        /// Cumulative counts of recorded values at or below each bound (ascending, in
+        /// milliseconds), as Prometheus buckets want them, plus the total. All taken from one
+        /// snapshot so they stay monotonic while other threads record. Exact to the bucket
+        /// resolution.
+        /// </summary>
+        public long[] CumulativeCounts(IReadOnlyList<double> boundsMilliseconds, out long total)
+        {
+            var counts = Snapshot(out total);
+            var cumulative = new long[boundsMilliseconds.Count];
+            long seen = 0;
+            int bucket = 0;
+            for (int b = 0; b < cumulative.Length; b++)
+            {
+                var boundMicros = (long)(boundsMilliseconds[b] * 1000);
+                for (; bucket < counts.Length && UpperBoundMicros(bucket) <= boundMicros; bucket++)
+                    seen += counts[bucket];
+                cumulative[b] = seen;
+            }
+            return cumulative;
+        }
+
+        /// <summary>
+        /// Add another histogram's values to this one (used to aggregate label sets)
+        /// </summary>
+        public void Add(LatencyHistogram other)
+        {
+            var counts = other.Snapshot(out _);
+            for (int i = 0; i < counts.Length; i++)
+            {
+                if (counts[i] != 0)
+                    Interlocked.Add(ref OctaveFor(i)[i & (SubBuckets - 1)], counts[i]);
+            }
+            Interlocked.Add(ref _sumMicros, Volatile.Read(ref other._sumMicros));
+
+            var otherMax = Volatile.Read(ref other._maxMicros);
+            long current;
+            while (otherMax > (current = Volatile.Read(ref _maxMicros)))
+            {
+                if (Interlocked.CompareExchange(ref _maxMicros, otherMax, current) == current)
+                    break;
+            }
+        }
+
+        /// <summary>
+        /// Zero the histogram in place, so callers holding a reference keep recording into it
+        /// </summary>
+        public void Reset()
+        {
+            foreach (var octave in _octaves)
+            {
+                if (octave == null) continue;
+                for (int i = 0; i < octave.Length; i++)
+                    Volatile.Write(ref octave[i], 0);
+            }
+            Volatile.Write(ref _sumMicros, 0);
+            Volatile.Write(ref _maxMicros, 0);
+        }
+
+        private long[] OctaveFor(int index)
+        {
+            ref var slot = ref _octaves[index >> SubBucketBits];
+            return Volatile.Read(ref slot)
+                ?? Interlocked.CompareExchange(ref slot, new long[SubBuckets], null)
+                ?? slot!;
+        }
+
+        private long[] Snapshot(out long total)
+        {
+            var counts = new long[BucketCount];
+            total = 0;
+            for (int o = 0; o < _octaves.Length; o++)
+            {
+                var octave = Volatile.Read(ref _octaves[o]);
+                if (octave == null) continue;
+                for (int i = 0; i < octave.Length; i++)
+                {
+                    var count = Volatile.Read(ref octave[i]);
+                    counts[(o << SubBucketBits) + i] = count;
+                    total += count;
+                }
+            }
+            return counts;
+        }
+
+        internal static int BucketIndex(long micros)
+        {
+            if (micros < SubBuckets)
+                return (int)micros;
+
+            var exponent = 63 - System.Numerics.BitOperations.LeadingZeroCount((ulong)micros);
+            if (exponent > MaxExponent)
+                return BucketCount - 1;
+
+            // Top SubBucketBits bits below the leading one select the sub-bucket
+            var shift = exponent - SubBucketBits;
+            var subBucket = (int)(micros >> shift) - SubBuckets;
+            return SubBuckets + shift * SubBuckets + subBucket;
+        }
+
+        internal static long UpperBoundMicros(int index)
+        {
+            if (index < SubBuckets)
+                return index;
+
+            var shift = (index - SubBuckets) / SubBuckets;
+            var subBucket = (index - SubBuckets) % SubBuckets;
+            return ((long)(SubBuckets + subBucket + 1) << shift) - 1;
+        }
+    }
+}
@@ -1,6 +1,7 @@
 using System;
 using System.Collections.Concurrent;
 using System.Collections.Generic;
+using System.Globalization;
 using System.Linq;
 using System.Text;
 using AcornDB;
@@ -13,7 +14,7 @@ namespace AcornDB.Metrics
     ///
     /// Tracked Metrics:
     /// - Operation counts (stash, crack, toss, squabble)
-    /// - Operation latencies (P50, P95, P99)
+    /// - Operation latencies as HDR-style histograms per operation, tree and trunk
     /// - Sync statistics (pushes, pulls, conflicts)
     /// - Cache performance (hit rate, evictions)
     /// - Trunk health (errors, retries, fallbacks)
@@ -48,10 +49,26 @@ namespace AcornDB.Metrics
         private long _totalFallbacks = 0;
         private long _circuitBreakerTrips = 0;
 
-        // Latency tracking (simplified histogram)
-        private readonly ConcurrentBag<double> _stashLatencies = new();
-        private readonly ConcurrentBag<double> _crackLatencies = new();
-        private readonly ConcurrentBag<double> _tossLatencies = new();
+        // Storage metrics
+        private long _compactions = 0;
+        private long _compactionBytesReclaimed = 0;
+        private double _compactionMaxPauseMs = 0;
+
+        // TTL metrics
+        private long _ttlPurges = 0;
+        private long _ttlExpired = 0;
+        private double _ttlPurgeMaxMs = 0;
+        private double _ttlLagMaxMs = 0;
+
+        // Latency histograms by (operation, tree, trunk); entries are never removed, so hot
+        // paths can cache the instance they record into
+        private readonly ConcurrentDictionary<(string Operation, string Tree, string Trunk), LatencyHistogram> _latencies = new();
+
+        // Prometheus bucket bounds (le) in milliseconds
+        private static readonly double[] LatencyBucketsMs =
+        {
+            0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10, 25, 50, 100, 250, 500, 1000, 2500, 5000, 10000
+        };
 
         // Tree/Grove tracking
         private readonly ConcurrentDictionary<string, TreeMetrics> _treeMetrics = new();
@@ -81,14 +98,14 @@ namespace AcornDB.Metrics
         public void RecordStash(string treeId, double durationMs)
         {
             System.Threading.Interlocked.Increment(ref _totalStashes);
-            _stashLatencies.Add(durationMs);
+            GetLatencyHistogram(LatencyOperations.Stash, tree: treeId).Record(durationMs);
             GetOrCreateTreeMetrics(treeId).RecordStash();
         }
 
         public void RecordCrack(string treeId, double durationMs, bool cacheHit)
         {
             System.Threading.Interlocked.Increment(ref _totalCracks);
-            _crackLatencies.Add(durationMs);
+            GetLatencyHistogram(LatencyOperations.Crack, tree: treeId).Record(durationMs);
 
             if (cacheHit)
                 System.Threading.Interlocked.Increment(ref _cacheHits);
@@ -101,7 +118,7 @@ namespace AcornDB.Metrics
         public void RecordToss(string treeId, double durationMs)
         {
             System.Threading.Interlocked.Increment(ref _totalTosses);
-            _tossLatencies.Add(durationMs);
+            GetLatencyHistogram(LatencyOperations.Toss, tree: treeId).Record(durationMs);
             GetOrCreateTreeMetrics(treeId).RecordToss();
         }
 
@@ -116,6 +133,38 @@ namespace AcornDB.Metrics
             System.Threading.Interlocked.Increment(ref _totalShakes);
         }
 
+        // ===== Latency Histograms =====
+
+        /// <summary>
+        /// Histogram for one operation and label set. The same instance is returned for the same
+        /// labels for the collector's lifetime (Reset zeroes it in place), so hot paths look it up
+        /// once and record into it directly.
+        /// </summary>
+        public LatencyHistogram GetLatencyHistogram(string operation, string? tree = null, string? trunk = null)
+        {
+            return _latencies.GetOrAdd((operation, tree ?? "", trunk ?? ""),
+                key => new LatencyHistogram(key.Operation, key.Tree, key.Trunk));
+        }
+
+        public void RecordLatency(string operation, double durationMs, string? tree = null, string? trunk = null)
+        {
+            GetLatencyHistogram(operation, tree, trunk).Record(durationMs);
+        }
+
+        /// <summary>
+        /// All values recorded for an operation, across trees and trunks
+        /// </summary>
+        public LatencyHistogram GetAggregateLatency(string operation)
+        {
+            var aggregate = new LatencyHistogram(operation);
+            foreach (var histogram in _latencies.Values)
+            {
+                if (histogram.Operation == operation)
+                    aggregate.Add(histogram);
+            }
+            return aggregate;
+        }
+
         // ===== Sync Metrics =====
 
         public void RecordPush(string branchId, int count = 1)
@@ -163,6 +212,41 @@ namespace AcornDB.Metrics
             System.Threading.Interlocked.Increment(ref _circuitBreakerTrips);
         }
 
+        // ===== Storage Metrics =====
+
+        public void RecordCompaction(string trunkId, long bytesReclaimed, double pauseMs)
+        {
+            System.Threading.Interlocked.Increment(ref _compactions);
+            System.Threading.Interlocked.Add(ref _compactionBytesReclaimed, bytesReclaimed);
+
+            double current;
+            while (pauseMs > (current = System.Threading.Volatile.Read(ref _compactionMaxPauseMs)))
+            {
+                if (System.Threading.Interlocked.CompareExchange(ref _compactionMaxPauseMs, pauseMs, current) == current)
+                    break;
+            }
+        }
+
+        // ===== TTL Metrics =====
+
+        public void RecordTtlPurge(string treeId, int expired, double durationMs, double maxLagMs)
+        {
+            System.Threading.Interlocked.Increment(ref _ttlPurges);
+            System.Threading.Interlocked.Add(ref _ttlExpired, expired);
+            RaiseMax(ref _ttlPurgeMaxMs, durationMs);
+            RaiseMax(ref _ttlLagMaxMs, maxLagMs);
+        }
+
+        private static void RaiseMax(ref double target, double value)
+        {
+            double current;
+            while (value > (current = System.Threading.Volatile.Read(ref target)))
+            {
+                if (System.Threading.Interlocked.CompareExchange(ref target, value, current) == current)
+                    break;
+            }
+        }
+
         // ===== Tree/Grove Tracking =====
 
         public void RegisterTree(string treeId, string treeType)
@@ -272,6 +356,36 @@ namespace AcornDB.Metrics
             sb.AppendLine($"# TYPE acorndb_circuit_breaker_trip_total counter");
             sb.AppendLine($"acorndb_circuit_breaker_trip_total{labels} {_circuitBreakerTrips}");
 
+            // Storage metrics
+            sb.AppendLine($"# HELP acorndb_compaction_total Total log compactions");
+            sb.AppendLine($"# TYPE acorndb_compaction_total counter");
+            sb.AppendLine($"acorndb_compaction_total{labels} {_compactions}");
+
+            sb.AppendLine($"# HELP acorndb_compaction_reclaimed_bytes_total Total bytes reclaimed by compaction");
+            sb.AppendLine($"# TYPE acorndb_compaction_reclaimed_bytes_total counter");
+            sb.AppendLine($"acorndb_compaction_reclaimed_bytes_total{labels} {_compactionBytesReclaimed}");
+
+            sb.AppendLine($"# HELP acorndb_compaction_pause_max_ms Longest writer pause caused by compaction");
+            sb.AppendLine($"# TYPE acorndb_compaction_pause_max_ms gauge");
+            sb.AppendLine($"acorndb_compaction_pause_max_ms{labels} {_compactionMaxPauseMs:F2}");
+
+            // TTL metrics
+            sb.AppendLine($"# HELP acorndb_ttl_purge_total Total TTL purge runs");
+            sb.AppendLine($"# TYPE acorndb_ttl_purge_total counter");
+            sb.AppendLine($"acorndb_ttl_purge_total{labels} {_ttlPurges}");
+
+            sb.AppendLine($"# HELP acorndb_ttl_expired_total Total nuts removed by TTL purges");
+            sb.AppendLine($"# TYPE acorndb_ttl_expired_total counter");
+            sb.AppendLine($"acorndb_ttl_expired_total{labels} {_ttlExpired}");
+
+            sb.AppendLine($"# HELP acorndb_ttl_purge_max_ms Longest TTL purge run");
+            sb.AppendLine($"# TYPE acorndb_ttl_purge_max_ms gauge");
+            sb.AppendLine($"acorndb_ttl_purge_max_ms{labels} {_ttlPurgeMaxMs:F2}");
+
+            sb.AppendLine($"# HELP acorndb_ttl_lag_max_ms Longest time an expired nut outlived its deadline");
+            sb.AppendLine($"# TYPE acorndb_ttl_lag_max_ms gauge");
+            sb.AppendLine($"acorndb_ttl_lag_max_ms{labels} {_ttlLagMaxMs:F2}");
+
             // Tree/Grove metrics
             sb.AppendLine($"# HELP acorndb_tree_count Number of active trees");
             sb.AppendLine($"# TYPE acorndb_tree_count gauge");
@@ -285,18 +399,24 @@ namespace AcornDB.Metrics
             sb.AppendLine($"# TYPE acorndb_tangle_count gauge");
             sb.AppendLine($"acorndb_tangle_count{labels} {_activeTangles}");
 
-            // Latency histograms (simplified)
-            if (_stashLatencies.Any())
+            // Stash quantiles across all trees, kept for existing dashboards
+            var stashLatency = GetAggregateLatency(LatencyOperations.Stash);
+            var stashCount = stashLatency.Count;
+            if (stashCount > 0)
             {
-                var stashLatencies = _stashLatencies.OrderBy(x => x).ToList();
                 sb.AppendLine($"# HELP acorndb_stash_duration_ms Stash operation latency in milliseconds");
                 sb.AppendLine($"# TYPE acorndb_stash_duration_ms summary");
-                sb.AppendLine($"acorndb_stash_duration_ms{{quantile=\"0.5\",{labels.TrimStart(',')}}} {GetPercentile(stashLatencies, 0.5):F2}");
-                sb.AppendLine($"acorndb_stash_duration_ms{{quantile=\"0.95\",{labels.TrimStart(',')}}} {GetPercentile(stashLatencies, 0.95):F2}");
-                sb.AppendLine($"acorndb_stash_duration_ms{{quantile=\"0.99\",{labels.TrimStart(',')}}} {GetPercentile(stashLatencies, 0.99):F2}");
-                sb.AppendLine($"acorndb_stash_duration_ms_count{labels} {stashLatencies.Count}");
+                foreach (var quantile in new[] { "0.5", "0.95", "0.99" })
+                {
+                    var value = stashLatency.GetPercentile(double.Parse(quantile, CultureInfo.InvariantCulture));
+                    sb.AppendLine(FormattableString.Invariant(
+                        $"acorndb_stash_duration_ms{FormatLabels(("quantile", quantile))} {value:F2}"));
+                }
+                sb.AppendLine($"acorndb_stash_duration_ms_count{labels} {stashCount}");
             }
 
+            AppendLatencyHistograms(sb);
+
             return sb.ToString();
         }
 
@@ -325,17 +445,40 @@ namespace AcornDB.Metrics
                     cache_eviction_total = _cacheEvictions,
                     retry_total = _totalRetries,
                     fallback_total = _totalFallbacks,
-                    circuit_breaker_trip_total = _circuitBreakerTrips
+                    circuit_breaker_trip_total = _circuitBreakerTrips,
+                    compaction_total = _compactions,
+                    compaction_reclaimed_bytes_total = _compactionBytesReclaimed,
+                    ttl_purge_total = _ttlPurges,
+                    ttl_expired_total = _ttlExpired
                 },
                 gauges = new
                 {
                     tree_count = _treeMetrics.Count,
                     grove_count = _activeGroves,
                     tangle_count = _activeTangles,
+                    compaction_pause_max_ms = _compactionMaxPauseMs,
+                    ttl_purge_max_ms = _ttlPurgeMaxMs,
+                    ttl_lag_max_ms = _ttlLagMaxMs,
                     cache_hit_rate = _cacheHits + _cacheMisses > 0
                         ? (double)_cacheHits / (_cacheHits + _cacheMisses)
                         : 0
                 },
+                latencies = _latencies.Values
+                    .Where(h => h.Count > 0)
+                    .OrderBy(h => h.Operation).ThenBy(h => h.Tree).ThenBy(h => h.Trunk)
+                    .Select(h => new
+                    {
+                        op = h.Operation,
+                        tree = h.Tree,
+                        trunk = h.Trunk,
+                        count = h.Count,
+                        sum_ms = h.SumMilliseconds,
+                        p50_ms = h.GetPercentile(0.5),
+                        p95_ms = h.GetPercentile(0.95),
+                        p99_ms = h.GetPercentile(0.99),
+                        p999_ms = h.GetPercentile(0.999),
+                        max_ms = h.MaxMilliseconds
+                    }),
                 trees = _treeMetrics.Values.Select(t => new
                 {
                     tree_id = t.TreeId,
@@ -377,35 +520,92 @@ namespace AcornDB.Metrics
             _totalRetries = 0;
             _totalFallbacks = 0;
             _circuitBreakerTrips = 0;
-            _stashLatencies.Clear();
-            _crackLatencies.Clear();
-            _tossLatencies.Clear();
+            _compactions = 0;
+            _compactionBytesReclaimed = 0;
+            _compactionMaxPauseMs = 0;
+            _ttlPurges = 0;
+            _ttlExpired = 0;
+            _ttlPurgeMaxMs = 0;
+            _ttlLagMaxMs = 0;
+            foreach (var histogram in _latencies.Values)
+                histogram.Reset();
             _treeMetrics.Clear();
             _activeGroves = 0;
             _activeTangles = 0;
         }
 
-        private string FormatLabels()
+        /// <summary>
+        /// One Prometheus histogram family for every operation, labelled by op, tree and trunk.
+        /// The HDR buckets are folded into fixed le bounds, so all series share one bucket layout.
+        /// </summary>
+        private void AppendLatencyHistograms(StringBuilder sb)
         {
-            if (!_labels.Any()) return "";
+            var histograms = _latencies.Values
+                .OrderBy(h => h.Operation).ThenBy(h => h.Tree).ThenBy(h => h.Trunk)
+                .ToList();
+            if (histograms.Count == 0) return;
+
+            sb.AppendLine("# HELP acorndb_operation_duration_ms Operation latency in milliseconds");
+            sb.AppendLine("# TYPE acorndb_operation_duration_ms histogram");
+            foreach (var histogram in histograms)
+            {
+                var series = new List<(string, string)> { ("op", histogram.Operation) };
+                if (histogram.Tree.Length > 0) series.Add(("tree", histogram.Tree));
+                if (histogram.Trunk.Length > 0) series.Add(("trunk", histogram.Trunk));
+
+                // le goes last, after the collector-wide labels
+                var labels = FormatLabels(series.ToArray());
+                string Bucket(string le) => $"{labels.TrimEnd('}')},le=\"{le}\"}}";
+
+                var cumulative = histogram.CumulativeCounts(LatencyBucketsMs, out var total);
+                for (int i = 0; i < LatencyBucketsMs.Length; i++)
+                {
+                    var le = LatencyBucketsMs[i].ToString(CultureInfo.InvariantCulture);
+                    sb.AppendLine($"acorndb_operation_duration_ms_bucket{Bucket(le)} {cumulative[i]}");
+                }
+                sb.AppendLine($"acorndb_operation_duration_ms_bucket{Bucket("+Inf")} {total}");
 
-            var labelStr = string.Join(",", _labels.Select(kvp => $"{kvp.Key}=\"{kvp.Value}\""));
-            return $",{labelStr}";
+                sb.AppendLine(FormattableString.Invariant($"acorndb_operation_duration_ms_sum{labels} {histogram.SumMilliseconds:F3}"));
+                sb.AppendLine($"acorndb_operation_duration_ms_count{labels} {total}");
+            }
         }
 
-        private double GetPercentile(List<double> sorted, double percentile)
+        /// <summary>
+        /// Prometheus label block: the series' own labels, then the collector-wide ones
+        /// </summary>
+        private string FormatLabels(params (string Key, string Value)[] series)
         {
-            if (sorted.Count == 0) return 0;
+            var all = series.Concat(_labels.Select(kvp => (kvp.Key, kvp.Value))).ToList();
+            if (all.Count == 0) return "";
 
-            int index = (int)Math.Ceiling(percentile * sorted.Count) - 1;
-            index = Math.Max(0, Math.Min(sorted.Count - 1, index));
-            return sorted[index];
+            var labelStr = string.Join(",", all.Select(label => $"{label.Key}=\"{EscapeLabelValue(label.Value)}\""));
+            return $"{{{labelStr}}}";
+        }
+
+        private static string EscapeLabelValue(string value)
+        {
+            return value.Replace("\\", "\\\\").Replace("\"", "\\\"").Replace("\n", "\\n");
         }
     }
 
     /// <summary>
     /// Per-tree metrics tracking
     /// </summary>
+    /// <summary>
+    /// Operation names used for the latency histograms
+    /// </summary>
+    public static class LatencyOperations
+    {
+        public const string Stash = "stash";
+        public const string Crack = "crack";
+        public const string Toss = "toss";
+        public const string RootStash = "root_stash";
+        public const string RootCrack = "root_crack";
+        public const string Flush = "flush";
+        public const string SyncPush = "sync_push";
+        public const string SyncPull = "sync_pull";
+    }
+
     internal class TreeMetrics
     {
         public string TreeId { get; set; } = "";
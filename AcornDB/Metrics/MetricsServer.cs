@@ -24,7 +24,8 @@ namespace AcornDB.Metrics
     /// </code>
     ///
     /// Endpoints:
-    /// - GET /metrics - Prometheus text format (default)
+    /// - GET /metrics - Prometheus text format (default), including the
+    ///   acorndb_operation_duration_ms histogram labelled by op, tree and trunk
     /// - GET /metrics?format=json - JSON format (OpenTelemetry compatible)
     /// - GET /health - Health check endpoint
     /// </summary>
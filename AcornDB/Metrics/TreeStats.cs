@@ -1,3 +1,5 @@
+using System;
+
 namespace AcornDB.Metrics
 {
     public class TreeStats
@@ -7,5 +9,25 @@ namespace AcornDB.Metrics
         public int SquabblesResolved { get; set; }
         public int SmushesPerformed { get; set; }
         public int ActiveTangles { get; set; }
+
+        /// <summary>
+        /// Stored nuts with an expiry deadline
+        /// </summary>
+        public int TtlTrackedCount { get; set; }
+
+        /// <summary>
+        /// Nuts removed by TTL purges since the tree was created
+        /// </summary>
+        public long TtlExpiredCount { get; set; }
+
+        public long TtlPurgeRuns { get; set; }
+        public TimeSpan LastTtlPurgeDuration { get; set; }
+
+        /// <summary>
+        /// Longest time an expired nut stayed stored past its deadline before a purge removed it
+        /// </summary>
+        public TimeSpan MaxTtlLag { get; set; }
+
+        public DateTime? NextTtlDeadline { get; set; }
     }
 }
\ No newline at end of file
@@ -5,7 +5,9 @@ using AcornDB.Conflict;
 using AcornDB.Git;
 using AcornDB.Indexing;
 using AcornDB.Security;
+using System.Text.Json.Serialization;
 using AcornDB.Storage;
+using AcornDB.Storage.Serialization;
 
 namespace AcornDB.Models
 {
@@ -27,6 +29,8 @@ namespace AcornDB.Models
         private string? _encryptionPassword;
         private string? _encryptionSalt;
         private CompressionLevel _compressionLevel = CompressionLevel.Optimal;
+        private ISerializer? _serializer;
+        private bool _useInMemory;
 
         // Git-specific configuration
         private bool _useGitStorage;
@@ -94,9 +98,39 @@ namespace AcornDB.Models
         public Acorn<T> WithTrunk(ITrunk<T> trunk)
         {
             _trunk = trunk;
+            _useInMemory = false;
             return this;
         }
 
+        /// <summary>
+        /// Configure how documents are encoded by the trunk this builder creates
+        /// (file, in-memory or Git). A trunk passed to WithTrunk keeps its own serializer.
+        /// Default: NewtonsoftJsonSerializer
+        /// </summary>
+        public Acorn<T> WithSerializer(ISerializer serializer)
+        {
+            _serializer = serializer ?? throw new ArgumentNullException(nameof(serializer));
+            return this;
+        }
+
+        /// <summary>
+        /// Store documents as MessagePack: several times smaller than indented JSON and
+        /// readable from the Rust MsgPackCodec. Documents already stored as JSON still load.
+        /// </summary>
+        public Acorn<T> WithBinarySerialization()
+        {
+            return WithSerializer(new MsgPackSerializer());
+        }
+
+        /// <summary>
+        /// Store documents as compact System.Text.Json, using source-generated metadata from
+        /// <paramref name="context"/> for the types it covers
+        /// </summary>
+        public Acorn<T> WithSystemTextJson(JsonSerializerContext? context = null)
+        {
+            return WithSerializer(new SystemTextJsonSerializer(context));
+        }
+
         /// <summary>
         /// Configure cache strategy
         /// </summary>
@@ -116,6 +150,24 @@ namespace AcornDB.Models
             return this;
         }
 
+        /// <summary>
+        /// Configure a sharded LRU cache with O(1) access tracking, for large caches
+        /// </summary>
+        public Acorn<T> WithShardedLRUCache(int maxSize = 10_000, int shardCount = 0)
+        {
+            _cacheStrategy = new ShardedLRUCacheStrategy<T>(maxSize, shardCount);
+            return this;
+        }
+
+        /// <summary>
+        /// Configure a scan-resistant W-TinyLFU cache that admits new items by access frequency
+        /// </summary>
+        public Acorn<T> WithWTinyLFUCache(int maxSize = 10_000)
+        {
+            _cacheStrategy = new WTinyLFUCacheStrategy<T>(maxSize);
+            return this;
+        }
+
         /// <summary>
         /// Configure conflict resolution judge
         /// </summary>
@@ -130,7 +182,9 @@ namespace AcornDB.Models
         /// </summary>
         public Acorn<T> InMemory()
         {
-            _trunk = new MemoryTrunk<T>();
+            // Created in Sprout() so a serializer configured afterwards still applies
+            _trunk = null;
+            _useInMemory = true;
             return this;
         }
 
@@ -176,6 +230,7 @@ namespace AcornDB.Models
         {
             var config = configuration ?? new Dictionary<string, object>();
             _trunk = Nursery.Grow<T>(typeId, config);
+            _useInMemory = false;
             return this;
         }
 
@@ -230,6 +285,11 @@ namespace AcornDB.Models
 
         private ITrunk<T> BuildTrunk()
         {
+            if (_useInMemory)
+            {
+                return new MemoryTrunk<T>(_serializer);
+            }
+
             // Check for Git storage first (highest priority)
             if (_useGitStorage)
             {
@@ -261,8 +321,8 @@ namespace AcornDB.Models
         private ITrunk<TPayload> CreateFileTrunk<TPayload>(string? storagePath) where TPayload : class
         {
             return string.IsNullOrEmpty(storagePath)
-                ? new FileTrunk<TPayload>()
-                : new FileTrunk<TPayload>(storagePath);
+                ? new FileTrunk<TPayload>(serializer: _serializer)
+                : new FileTrunk<TPayload>(storagePath, _serializer);
         }
 
         private ITrunk<T> BuildEncryptedTrunk()
@@ -314,7 +374,7 @@ namespace AcornDB.Models
             var authorEmail = _gitAuthorEmail ?? "acorn@acorndb.dev";
             var autoPush = _gitAutoPush;
 
-            return new GitHubTrunk<T>(repoPath, authorName, authorEmail, autoPush);
+            return new GitHubTrunk<T>(repoPath, authorName, authorEmail, autoPush, serializer: _serializer);
         }
 
         private IEncryptionProvider CreateEncryptionProvider()
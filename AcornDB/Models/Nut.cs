@@ -15,6 +15,7 @@ namespace AcornDB
         public int Version { get; set; } = 1;
 
         [JsonIgnore]
+        [System.Text.Json.Serialization.JsonIgnore]
         // Alias properties for compatibility
         public T Value
         {
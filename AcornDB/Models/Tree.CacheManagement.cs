@@ -1,7 +1,12 @@
 using System;
+using System.Collections.Generic;
+using System.Diagnostics;
 using System.Linq;
+using System.Numerics;
 using System.Threading;
 using AcornDB.Cache;
+using AcornDB.Metrics;
+using AcornDB.Storage;
 
 namespace AcornDB
 {
@@ -16,6 +21,89 @@ namespace AcornDB
         private bool _ttlEnforcementEnabled = true;
         private ICacheStrategy<T> _cacheStrategy;
         private bool _cacheEvictionEnabled = true;
+        private long _cacheHits;
+        private long _cacheMisses;
+
+        // Deadlines of every stored nut with ExpiresAt set (cached or evicted), so a purge
+        // touches only the nuts that are due
+        private readonly ExpiryIndex _expiry = new();
+        private long _ttlExpired;
+        private long _ttlPurgeRuns;
+        private long _lastTtlPurgeTicks; // TimeSpan ticks
+        private long _maxTtlLagTicks;
+
+        // ConcurrentDictionary.Count takes every bucket lock, so the size is tracked here
+        private int _cachedCount;
+        private int _evicting;
+
+        // Striped writer locks: enough stripes that writers of different ids rarely share one
+        private readonly object[] _writeLocks = CreateWriteLocks();
+
+        private static object[] CreateWriteLocks()
+        {
+            var count = (int)BitOperations.RoundUpToPowerOf2((uint)Math.Clamp(Environment.ProcessorCount * 4, 16, 1024));
+            var locks = new object[count];
+            for (int i = 0; i < locks.Length; i++)
+                locks[i] = new object();
+            return locks;
+        }
+
+        /// <summary>
+        /// Lock held while an id's cache entry, trunk copy, cache strategy and index entries
+        /// are changed together. Readers never take it on a cache hit.
+        /// </summary>
+        private object WriteLockFor(string id)
+        {
+            return _writeLocks[id.GetHashCode() & (_writeLocks.Length - 1)];
+        }
+
+        /// <summary>
+        /// Insert or replace a cache entry, keeping the tracked count exact even when an
+        /// eviction removes the entry concurrently
+        /// </summary>
+        private void SetCached(string id, Nut<T> nut)
+        {
+            while (true)
+            {
+                if (_cache.TryAdd(id, nut))
+                {
+                    Interlocked.Increment(ref _cachedCount);
+                    break;
+                }
+                if (_cache.TryGetValue(id, out var current) && _cache.TryUpdate(id, nut, current))
+                    break;
+            }
+            TrackExpiry(id, nut);
+        }
+
+        /// <summary>
+        /// Keep the expiry index in step with the nut now stored under id
+        /// </summary>
+        private void TrackExpiry(string id, Nut<T> nut)
+        {
+            if (nut.ExpiresAt.HasValue)
+                _expiry.Set(id, nut.ExpiresAt);
+            else
+                _expiry.Remove(id);
+        }
+
+        private bool RemoveCached(string id)
+        {
+            if (!_cache.TryRemove(id, out _))
+                return false;
+            Interlocked.Decrement(ref _cachedCount);
+            return true;
+        }
+
+        /// <summary>
+        /// Cached nuts without locking or copying (ConcurrentDictionary.Values takes every
+        /// bucket lock and copies, which would stall writers)
+        /// </summary>
+        private IEnumerable<Nut<T>> CachedNuts()
+        {
+            foreach (var entry in _cache)
+                yield return entry.Value;
+        }
 
         /// <summary>
         /// Gets or sets the cache eviction strategy
@@ -101,33 +189,78 @@ namespace AcornDB
         }
 
         /// <summary>
-        /// Manually trigger cleanup of expired nuts
+        /// Set or clear (null) when a nut expires. The trunk copy is updated too, so the deadline
+        /// survives a reload. A deadline changed on the nut in place is not seen by the purge until it
+        /// is set through here.
+        /// </summary>
+        /// <returns>False when no nut is stored under id</returns>
+        public bool SetExpiration(string id, DateTime? expiresAt)
+        {
+            lock (WriteLockFor(id))
+            {
+                var nut = _cache.TryGetValue(id, out var cached) ? cached : _trunk.Crack(id);
+                if (nut == null)
+                    return false;
+
+                nut.ExpiresAt = expiresAt?.Kind == DateTimeKind.Local ? expiresAt.Value.ToUniversalTime() : expiresAt;
+                _trunk.Stash(id, nut);
+                TrackExpiry(id, nut);
+            }
+            return true;
+        }
+
+        /// <summary>
+        /// Manually trigger cleanup of expired nuts. Costs O(expired): only ids whose deadline
+        /// has passed are looked at, whether they are cached or were evicted.
         /// </summary>
         /// <returns>Number of expired nuts removed</returns>
         public int CleanupExpiredNuts()
         {
             if (!_ttlEnforcementEnabled) return 0;
 
+            var started = Stopwatch.GetTimestamp();
             var now = DateTime.UtcNow;
-            List<string> expired;
+            int removed = 0;
+            long maxLag = 0;
 
-            // Lock only the enumeration to get expired IDs
-            lock (_cacheLock)
+            foreach (var (id, deadline) in _expiry.TakeDue(now))
             {
-                expired = _cache
-                    .Where(x => x.Value.ExpiresAt.HasValue && x.Value.ExpiresAt.Value <= now)
-                    .Select(x => x.Key)
-                    .ToList();
+                if (!Toss(id, propagate: true, expiredBy: now))
+                    continue;
+
+                removed++;
+                maxLag = Math.Max(maxLag, (now - deadline).Ticks);
             }
 
-            // Delete outside the lock to avoid holding it too long
-            foreach (var id in expired)
+            var elapsed = Stopwatch.GetElapsedTime(started);
+            Interlocked.Add(ref _ttlExpired, removed);
+            Interlocked.Increment(ref _ttlPurgeRuns);
+            Interlocked.Exchange(ref _lastTtlPurgeTicks, elapsed.Ticks);
+            long current;
+            while (maxLag > (current = Interlocked.Read(ref _maxTtlLagTicks)))
             {
-                Toss(id);
-                // Removed console logging - use events/telemetry instead
+                if (Interlocked.CompareExchange(ref _maxTtlLagTicks, maxLag, current) == current)
+                    break;
             }
+            MetricsCollector.Instance.RecordTtlPurge(TreeId, removed, elapsed.TotalMilliseconds,
+                TimeSpan.FromTicks(maxLag).TotalMilliseconds);
+
+            return removed;
+        }
 
-            return expired.Count;
+        /// <summary>
+        /// Whether the nut stored under a due id still has a passed deadline; the caller holds
+        /// WriteLockFor(id). A deadline moved later in place is put back in the index instead.
+        /// </summary>
+        private bool IsExpiredLocked(string id, Nut<T>? nut, DateTime now)
+        {
+            if (nut?.ExpiresAt == null)
+                return false;
+            if (nut.ExpiresAt.Value <= now)
+                return true;
+
+            _expiry.Set(id, nut.ExpiresAt);
+            return false;
         }
 
         /// <summary>
@@ -135,13 +268,7 @@ namespace AcornDB
         /// </summary>
         public int GetExpiringNutsCount(TimeSpan within)
         {
-            var threshold = DateTime.UtcNow.Add(within);
-            lock (_cacheLock)
-            {
-                return _cache.Count(x =>
-                    x.Value.ExpiresAt.HasValue &&
-                    x.Value.ExpiresAt.Value <= threshold);
-            }
+            return _expiry.Due(DateTime.UtcNow.Add(within)).Count;
         }
 
         /// <summary>
@@ -149,44 +276,70 @@ namespace AcornDB
         /// </summary>
         public string[] GetExpiringNuts(TimeSpan within)
         {
-            var threshold = DateTime.UtcNow.Add(within);
-            lock (_cacheLock)
+            return _expiry.Due(DateTime.UtcNow.Add(within)).ToArray();
+        }
+
+        /// <summary>
+        /// Get cache statistics: item counts, hits and misses of Crack(), and admission
+        /// decisions when the strategy is W-TinyLFU
+        /// </summary>
+        public CacheStats GetCacheStats()
+        {
+            var now = DateTime.UtcNow;
+            int cached = Volatile.Read(ref _cachedCount);
+            int expired = _expiry.Due(now).Count(id => _cache.ContainsKey(id));
+
+            var admission = (_cacheStrategy as WTinyLFUCacheStrategy<T>)?.GetStats();
+            return new CacheStats
             {
-                return _cache
-                    .Where(x => x.Value.ExpiresAt.HasValue && x.Value.ExpiresAt.Value <= threshold)
-                    .Select(x => x.Key)
-                    .ToArray();
-            }
+                CachedItemCount = cached,
+                ExpiredItemCount = expired,
+                ActiveItemCount = cached - expired,
+                HitCount = Interlocked.Read(ref _cacheHits),
+                MissCount = Interlocked.Read(ref _cacheMisses),
+                AdmittedCount = admission?.AdmittedCount ?? 0,
+                RejectedCount = admission?.RejectedCount ?? 0
+            };
         }
 
         /// <summary>
         /// Trigger cache eviction based on the current strategy
         /// </summary>
-        /// <returns>Number of items evicted</returns>
+        /// <returns>Number of items actually removed from the cache; candidates another
+        /// writer already removed do not count</returns>
         public int EvictCacheItems()
         {
             if (!_cacheEvictionEnabled || _cacheStrategy == null)
                 return 0;
 
-            List<string> candidates;
+            // One evictor at a time; writers that find one running leave the work to it
+            if (Interlocked.CompareExchange(ref _evicting, 1, 0) != 0)
+                return 0;
 
-            lock (_cacheLock)
+            try
             {
-                candidates = _cacheStrategy.GetEvictionCandidates(_cache).ToList();
-            }
+                var candidates = _cacheStrategy.GetEvictionCandidates(_cache).ToList();
+                int removed = 0;
 
-            foreach (var id in candidates)
-            {
-                lock (_cacheLock)
+                foreach (var id in candidates)
                 {
-                    // Remove from cache but NOT from trunk (eviction != deletion)
-                    _cache.Remove(id);
+                    // Under the id's write lock, so a concurrent Stash of the same id leaves the
+                    // cache and the strategy agreeing on whether it is cached
+                    lock (WriteLockFor(id))
+                    {
+                        // Remove from cache but NOT from trunk (eviction != deletion)
+                        if (RemoveCached(id))
+                            removed++;
+                        _cacheStrategy.OnToss(id);
+                    }
                 }
-                _cacheStrategy.OnToss(id);
-                // Removed console logging - use events/telemetry instead
-            }
 
-            return candidates.Count;
+                return removed;
+            }
+            finally
+            {
+                Interlocked.Exchange(ref _evicting, 0);
+            }
         }
 
         /// <summary>
@@ -199,22 +352,28 @@ namespace AcornDB
                 return;
 
             // Quick check: if cache is under limit, no need to call GetEvictionCandidates
-            lock (_cacheLock)
-            {
-                if (_cacheStrategy is LRUCacheStrategy<T> lru && _cache.Count <= lru.MaxSize)
-                    return;
-            }
-
-            IEnumerable<string> candidates;
-            lock (_cacheLock)
+            var maxSize = _cacheStrategy switch
             {
-                candidates = _cacheStrategy.GetEvictionCandidates(_cache);
-            }
+                LRUCacheStrategy<T> lru => lru.MaxSize,
+                ShardedLRUCacheStrategy<T> sharded => sharded.MaxSize,
+                WTinyLFUCacheStrategy<T> tinyLfu => tinyLfu.MaxSize,
+                _ => (int?)null
+            };
+            if (maxSize.HasValue && Volatile.Read(ref _cachedCount) <= maxSize.Value)
+                return;
 
-            if (candidates.Any())
+            // EvictCacheItems asks the strategy for candidates once and is a no-op when
+            // there are none, so the candidate list is not built twice per stash.
+            // Writers that find an eviction running skip it; the evictor checks again once it
+            // is done, so entries they added meanwhile are not left over the limit.
+            // A pass that removes nothing ends the loop: another writer is evicting, or the
+            // strategy only offered ids that are no longer cached, and retrying would spin.
+            do
             {
-                EvictCacheItems();
+                if (EvictCacheItems() == 0)
+                    break;
             }
+            while (maxSize.HasValue && Volatile.Read(ref _cachedCount) > maxSize.Value);
         }
     }
 }
@@ -52,7 +52,7 @@ namespace AcornDB
                 _indexes[index.Name] = index;
 
                 // Build the index from existing cached data
-                var nuts = _cache.Values.Cast<object>();
+                var nuts = CachedNuts().Cast<object>();
                 index.Build(nuts);
             }
         }
@@ -125,7 +125,7 @@ namespace AcornDB
         /// Update all indexes when a document is stashed.
         /// Called internally by Stash operations.
         /// </summary>
-        private void UpdateIndexesOnStash(string id, T document)
+        private void UpdateIndexesOnStash(string id, Nut<T> nut)
         {
             lock (_indexLock)
             {
@@ -133,7 +133,7 @@ namespace AcornDB
                 {
                     try
                     {
-                        index.Add(id, document!);
+                        index.Add(id, index.IndexesNutMetadata ? nut : nut.Payload!);
                     }
                     catch (InvalidOperationException ex) when (ex.Message.Contains("Unique index violation"))
                     {
@@ -180,7 +180,7 @@ namespace AcornDB
         {
             lock (_indexLock)
             {
-                var nuts = _cache.Values.Cast<object>();
+                var nuts = CachedNuts().Cast<object>();
 
                 foreach (var index in _indexes.Values)
                 {
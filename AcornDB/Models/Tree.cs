@@ -4,9 +4,12 @@ using AcornDB.Conflict;
 using AcornDB.Logging;
 using Newtonsoft.Json;
 using System;
+using System.Collections.Concurrent;
 using System.Collections.Generic;
+using System.Diagnostics;
 using System.IO;
 using System.Linq;
+using System.Threading;
 using AcornDB.Metrics;
 using AcornDB.Reactive;
 
@@ -14,13 +17,13 @@ namespace AcornDB
 {
     public partial class Tree<T> where T : class
     {
-        private readonly Dictionary<string, Nut<T>> _cache = new();
+        // Reads are lock-free; writers of an id serialize on WriteLockFor(id)
+        private readonly ConcurrentDictionary<string, Nut<T>> _cache = new();
         private readonly List<IBranch> _branches = new(); // Stores Branch and IBranch implementations
         internal readonly List<Tangle<T>> _tangles = new();
         private readonly ITrunk<T> _trunk;
         private readonly EventManager<T> _eventManager = new();
         private readonly IConflictJudge<T> _conflictJudge;
-        private readonly object _cacheLock = new(); // Thread-safety for cache operations
 
         // Reactive change notifications
         internal event Action<string, T, Nut<T>>? OnStashEvent;
@@ -40,17 +43,32 @@ namespace AcornDB
         // Sync tracking for incremental/delta sync
         private DateTime _lastSyncTimestamp = DateTime.MinValue;
 
+        // Ids and versions of everything stored, for anti-entropy; kept under the write locks
+        private readonly MerkleTree _merkle = new();
+
+        // Latency histograms for this tree and trunk, looked up once (see MetricsCollector)
+        private readonly LatencyHistogram _stashLatency;
+        private readonly LatencyHistogram _crackLatency;
+        private readonly LatencyHistogram _tossLatency;
+
         // Public properties
-        public int NutCount => _cache.Count;
+        public int NutCount => Volatile.Read(ref _cachedCount);
         public DateTime LastSyncTimestamp => _lastSyncTimestamp;
 
+        /// <summary>
+        /// Hash tree over the ids and versions in this tree (including evicted ones), which
+        /// branches compare to sync only divergent ranges (see MerkleReconciler)
+        /// </summary>
+        public MerkleTree Merkle => _merkle;
+
         /// <summary>
         /// Get all nuts in the tree (payload + metadata)
-        /// Useful for queries and exports
+        /// Useful for queries and exports. Returns a copy, so it can be enumerated while
+        /// other threads write.
         /// </summary>
         public IEnumerable<Nut<T>> NutShells()
         {
-            return _cache.Values.ToList();
+            return CachedNuts().ToList();
         }
 
         /// <summary>
@@ -58,13 +76,79 @@ namespace AcornDB
         /// </summary>
         public IEnumerable<Nut<T>> GetAllNuts() => NutShells();
 
-        public IEnumerable<T> Nuts => _cache.Values.Select(nut => nut.Payload);
+        /// <summary>
+        /// Payloads of all cached nuts. A live view that takes no locks: safe to enumerate
+        /// alongside writers, and reflects writes made while it is being enumerated.
+        /// </summary>
+        public IEnumerable<T> Nuts => CachedNuts().Select(nut => nut.Payload);
+
+        /// <summary>
+        /// Whether key-range and key-prefix queries are answered by the trunk in key order
+        /// (see IOrderedTrunk&lt;T&gt;) rather than by filtering the cache
+        /// </summary>
+        public bool SupportsOrderedKeyScans => _trunk is IOrderedTrunk<T>;
+
+        /// <summary>
+        /// Nuts whose ids fall in [fromInclusive, toExclusive) and start with prefix (null = no
+        /// constraint), in key order. Pushed down to the trunk when it stores ids in order.
+        /// </summary>
+        internal IEnumerable<Nut<T>> ScanKeys(string? fromInclusive, string? toExclusive, string? prefix)
+        {
+            if (_trunk is IOrderedTrunk<T> ordered)
+            {
+                return prefix != null
+                    ? ordered.CrackPrefix(prefix).Where(nut => IsInKeyRange(nut.Id, fromInclusive, toExclusive, null))
+                    : ordered.CrackRange(fromInclusive, toExclusive);
+            }
+
+            return NutShells()
+                .Where(nut => IsInKeyRange(nut.Id, fromInclusive, toExclusive, prefix))
+                .OrderBy(nut => nut.Id, Utf8KeyComparer.Instance)
+                .ToList();
+        }
+
+        /// <summary>
+        /// Whether time-range, key-range and Where queries are filtered by the trunk (see
+        /// IScanTrunk&lt;T&gt;) rather than over every cached nut
+        /// </summary>
+        public bool SupportsScanPushdown => _trunk is IScanTrunk<T>;
+
+        /// <summary>
+        /// Current nuts the trunk cannot rule out for filter. May include non-matching nuts.
+        /// </summary>
+        internal IEnumerable<Nut<T>> ScanWhere(TrunkScanFilter<T> filter)
+        {
+            if (_trunk is IScanTrunk<T> scan)
+                return scan.CrackWhere(filter);
+
+            return NutShells();
+        }
+
+        /// <summary>
+        /// Whether whole queries (WHERE, ORDER BY, Skip/Take, Count) can run in the trunk (see
+        /// INativeQueryTrunk&lt;T&gt;) rather than over the cache
+        /// </summary>
+        public bool SupportsNativeQueries => NativeQueries != null;
+
+        internal INativeQueryTrunk<T>? NativeQueries =>
+            _trunk is INativeQueryTrunk<T> native && _trunk.Capabilities.SupportsNativeQueries ? native : null;
+
+        internal static bool IsInKeyRange(string id, string? fromInclusive, string? toExclusive, string? prefix)
+        {
+            return (fromInclusive == null || Utf8KeyComparer.Instance.Compare(id, fromInclusive) >= 0)
+                && (toExclusive == null || Utf8KeyComparer.Instance.Compare(id, toExclusive) < 0)
+                && (prefix == null || id.StartsWith(prefix, StringComparison.Ordinal));
+        }
 
         public Tree(ITrunk<T>? trunk = null, Cache.ICacheStrategy<T>? cacheStrategy = null, IConflictJudge<T>? conflictJudge = null)
         {
             _trunk = trunk ?? new FileTrunk<T>(); // defaults to FileTrunk
             _cacheStrategy = cacheStrategy ?? new Cache.LRUCacheStrategy<T>(maxSize: 10_000); // defaults to LRU with 10k limit
             _conflictJudge = conflictJudge ?? new TimestampJudge<T>(); // defaults to last-write-wins
+            var trunkName = _trunk.Capabilities?.TrunkType;
+            _stashLatency = MetricsCollector.Instance.GetLatencyHistogram(LatencyOperations.Stash, TreeId, trunkName);
+            _crackLatency = MetricsCollector.Instance.GetLatencyHistogram(LatencyOperations.Crack, TreeId, trunkName);
+            _tossLatency = MetricsCollector.Instance.GetLatencyHistogram(LatencyOperations.Toss, TreeId, trunkName);
             InitializeIdExtractor();
             InitializeIdentityIndex(); // Create implicit identity index
             LoadFromTrunk();
@@ -85,6 +169,7 @@ namespace AcornDB
         /// </summary>
         public void Stash(string id, T item)
         {
+            var started = Stopwatch.GetTimestamp();
             var nut = new Nut<T>
             {
                 Id = id,
@@ -92,12 +177,20 @@ namespace AcornDB
                 Timestamp = DateTime.UtcNow
             };
 
-            _cache[id] = nut;
-            _trunk.Stash(id, nut);
-            _totalStashed++;
+            // Cache, trunk, cache strategy and indexes see writes to one id in the same order
+            lock (WriteLockFor(id))
+            {
+                SetCached(id, nut);
+                _trunk.Stash(id, nut);
+                _merkle.Set(id, nut);
+
+                // Notify cache strategy
+                _cacheStrategy?.OnStash(id, nut);
 
-            // Notify cache strategy
-            _cacheStrategy?.OnStash(id, nut);
+                // Update indexes
+                UpdateIndexesOnStash(id, nut);
+            }
+            Interlocked.Increment(ref _totalStashed);
 
             // Notify subscribers
             _eventManager.RaiseChanged(item);
@@ -105,54 +198,99 @@ namespace AcornDB
             // Raise reactive event
             OnStashEvent?.Invoke(id, item, nut);
 
-            // Update indexes
-            UpdateIndexesOnStash(id, item);
-
             // Create and propagate leaf to branches (new leaf-based system)
             var leaf = CreateLeaf(Sync.LeafType.Stash, id, nut);
             PropagateLeaf(leaf);
 
             // Check if cache eviction is needed
             CheckAndEvictCache();
+            _stashLatency.RecordSince(started);
         }
 
         public T? Crack(string id)
+        {
+            var started = Stopwatch.GetTimestamp();
+            var shell = CrackNut(id);
+            _crackLatency.RecordSince(started);
+            return shell != null ? shell.Payload : default;
+        }
+
+        /// <summary>
+        /// Crack with metadata: the cached nut, or the trunk's copy (which is then cached)
+        /// </summary>
+        internal Nut<T>? CrackNut(string id)
         {
             if (_cache.TryGetValue(id, out var shell))
             {
+                Interlocked.Increment(ref _cacheHits);
                 // Notify cache strategy of access (for LRU tracking)
                 _cacheStrategy?.OnCrack(id);
-                return shell.Payload;
+                return shell;
             }
 
-            var fromTrunk = _trunk.Crack(id);
-            if (fromTrunk != null)
+            Interlocked.Increment(ref _cacheMisses);
+            Nut<T>? fromTrunk;
+            lock (WriteLockFor(id))
             {
-                _cache[id] = fromTrunk;
+                // A writer may have cached it while this thread waited; a Toss that ran
+                // meanwhile must not be undone by caching the copy read before it
+                if (_cache.TryGetValue(id, out shell))
+                    return shell;
+
+                fromTrunk = _trunk.Crack(id);
+                if (fromTrunk == null)
+                    return null;
+
+                SetCached(id, fromTrunk);
+                _merkle.Set(id, fromTrunk);
                 // Notify cache strategy of new item
                 _cacheStrategy?.OnStash(id, fromTrunk);
-                return fromTrunk.Payload;
             }
 
-            return default;
+            // Reads fill the cache too, so a read-only scan must not grow it past the limit
+            CheckAndEvictCache();
+            return fromTrunk;
         }
 
         public void Toss(string id, bool propagate = true)
         {
-            var item = Crack(id);
-            _cache.Remove(id);
-            _trunk.Toss(id);
-            _totalTossed++;
+            Toss(id, propagate, expiredBy: null);
+        }
 
-            // Notify cache strategy
-            _cacheStrategy?.OnToss(id);
+        /// <summary>
+        /// Remove id everywhere. With expiredBy set, only a nut whose deadline has passed by then
+        /// is removed: the check runs under the same lock as the removal, so a Stash that lands
+        /// while the purge runs is never deleted.
+        /// </summary>
+        /// <returns>False when expiredBy was set and the nut had not expired</returns>
+        private bool Toss(string id, bool propagate, DateTime? expiredBy)
+        {
+            var started = Stopwatch.GetTimestamp();
+            T? item;
+            lock (WriteLockFor(id))
+            {
+                // Looked up directly: Crack would cache the nut being removed and count a read
+                var nut = _cache.TryGetValue(id, out var cached) ? cached : _trunk.Crack(id);
+                if (expiredBy.HasValue && !IsExpiredLocked(id, nut, expiredBy.Value))
+                    return false;
+
+                item = nut?.Payload;
+                RemoveCached(id);
+                _expiry.Remove(id);
+                _trunk.Toss(id);
+                _merkle.Remove(id);
+
+                // Notify cache strategy
+                _cacheStrategy?.OnToss(id);
+
+                // Update indexes
+                UpdateIndexesOnToss(id);
+            }
+            Interlocked.Increment(ref _totalTossed);
 
             // Raise reactive event
             OnTossEvent?.Invoke(id);
 
-            // Update indexes
-            UpdateIndexesOnToss(id);
-
             // Notify subscribers if item existed
             if (item != null)
                 _eventManager.RaiseChanged(item);
@@ -167,6 +305,8 @@ namespace AcornDB
                 // Push to tangles (legacy support)
                 PushDeleteToAllTangles(id);
             }
+            _tossLatency.RecordSince(started);
+            return true;
         }
 
         public void Shake()
@@ -191,12 +331,30 @@ namespace AcornDB
         }
 
         public void Squabble(string id, Nut<T> incoming, Sync.ConflictDirection conflictDirection)
+        {
+            bool conflicted;
+            Nut<T> winner;
+            lock (WriteLockFor(id))
+            {
+                conflicted = SquabbleLocked(id, incoming, conflictDirection, out winner);
+            }
+
+            // Raised after the lock is released, as Stash does, so a handler can write this id
+            if (conflicted)
+                OnSquabbleEvent?.Invoke(id, winner);
+            else
+                OnStashEvent?.Invoke(id, incoming.Payload, incoming);
+        }
+
+        /// <summary>
+        /// Resolve incoming against the cached nut and store the winner. Returns false when
+        /// there was nothing to squabble with and incoming was simply stashed.
+        /// </summary>
+        private bool SquabbleLocked(string id, Nut<T> incoming, Sync.ConflictDirection conflictDirection, out Nut<T> winner)
         {
             if (_cache.TryGetValue(id, out var existing))
             {
                 // Determine winner based on conflict direction
-                Nut<T> winner;
-
                 switch (conflictDirection)
                 {
                     case Sync.ConflictDirection.PreferLocal:
@@ -214,24 +372,25 @@ namespace AcornDB
                         break;
                 }
 
-                _squabblesResolved++;
-                OnSquabbleEvent?.Invoke(id, winner);
+                Interlocked.Increment(ref _squabblesResolved);
 
-                // If the winner is the existing nut, keep it and return
+                // If the winner is the existing nut, keep it
                 if (ReferenceEquals(winner, existing))
-                    return;
+                    return true;
 
                 // Otherwise, save the incoming nut
-                _cache[id] = winner;
+                SetCached(id, winner);
                 _trunk.Stash(id, winner);
+                _merkle.Set(id, winner);
+                return true;
             }
-            else
-            {
-                // No conflict, just stash the incoming nut
-                _cache[id] = incoming;
-                _trunk.Stash(id, incoming);
-                OnStashEvent?.Invoke(id, incoming.Payload, incoming);
-            }
+
+            // No conflict, just stash the incoming nut
+            SetCached(id, incoming);
+            _trunk.Stash(id, incoming);
+            _merkle.Set(id, incoming);
+            winner = incoming;
+            return false;
         }
 
         public IReadOnlyList<Nut<T>> GetHistory(string id)
@@ -257,7 +416,7 @@ namespace AcornDB
         public IEnumerable<Nut<T>> ExportChangesSince(DateTime since)
         {
             // Filter nuts by timestamp - only return those modified after 'since'
-            return _cache.Values
+            return CachedNuts()
                 .Where(nut => nut.Timestamp > since)
                 .ToList();
         }
@@ -427,8 +586,12 @@ namespace AcornDB
                 }
 
                 var lastVersion = versions[^1];
-                _cache[id] = lastVersion;
-                _trunk.Stash(id, lastVersion);
+                lock (WriteLockFor(id))
+                {
+                    SetCached(id, lastVersion);
+                    _trunk.Stash(id, lastVersion);
+                    _merkle.Set(id, lastVersion);
+                }
 
                 // Squabble undone successfully
                 return true;
@@ -471,7 +634,10 @@ namespace AcornDB
             foreach (var shell in _trunk.CrackAll())
             {
                 if (!string.IsNullOrWhiteSpace(shell.Id))
-                    _cache[shell.Id] = shell;
+                {
+                    SetCached(shell.Id, shell);
+                    _merkle.Set(shell.Id, shell);
+                }
             }
         }
 
@@ -483,12 +649,19 @@ namespace AcornDB
                 TotalTossed = _totalTossed,
                 SquabblesResolved = _squabblesResolved,
                 SmushesPerformed = _smushesPerformed,
-                ActiveTangles = _tangles.Count
+                ActiveTangles = _tangles.Count,
+                TtlTrackedCount = _expiry.Count,
+                TtlExpiredCount = Interlocked.Read(ref _ttlExpired),
+                TtlPurgeRuns = Interlocked.Read(ref _ttlPurgeRuns),
+                LastTtlPurgeDuration = TimeSpan.FromTicks(Interlocked.Read(ref _lastTtlPurgeTicks)),
+                MaxTtlLag = TimeSpan.FromTicks(Interlocked.Read(ref _maxTtlLagTicks)),
+                NextTtlDeadline = _expiry.NextDeadline
             };
         }
 
         /// <summary>
-        /// Initialize ID extractor using reflection (cached for performance)
+        /// Initialize ID extractor: the ID property is found by reflection once, then read
+        /// through a compiled accessor
         /// </summary>
         private void InitializeIdExtractor()
         {
@@ -505,7 +678,8 @@ namespace AcornDB
                 var idProperty = type.GetProperty("Id");
                 if (idProperty != null)
                 {
-                    _idExtractor = (item) => idProperty.GetValue(item)?.ToString() ?? string.Empty;
+                    var getId = Indexing.PropertyAccessors.ForString<T>(idProperty);
+                    _idExtractor = (item) => getId(item) ?? string.Empty;
                     _idExtractorInitialized = true;
                     return;
                 }
@@ -518,7 +692,8 @@ namespace AcornDB
                 var property = type.GetProperty(name);
                 if (property != null && property.CanRead)
                 {
-                    _idExtractor = (item) => property.GetValue(item)?.ToString() ?? string.Empty;
+                    var getId = Indexing.PropertyAccessors.ForString<T>(property);
+                    _idExtractor = (item) => getId(item) ?? string.Empty;
                     _idExtractorInitialized = true;
                     return;
                 }
@@ -528,7 +703,7 @@ namespace AcornDB
         }
 
         /// <summary>
-        /// Extract ID from an object using cached reflection
+        /// Extract ID from an object using the cached accessor
         /// </summary>
         private string ExtractId(T item)
         {
@@ -3,24 +3,51 @@ using System.Collections.Generic;
 using System.Linq;
 using System.Linq.Expressions;
 using AcornDB.Indexing;
+using AcornDB.Storage;
 
 namespace AcornDB.Query
 {
     /// <summary>
     /// Default query planner implementation with cost-based optimization.
-    /// Selects the best index based on selectivity, cardinality, and query structure.
+    /// Turns the WHERE clause into index seeks (intersected for AND, unioned for OR), uses
+    /// ordered index scans for ORDER BY + Take, and compares every option against a cache scan
+    /// using row estimates from IndexStatistics. Trunks that can run the whole query themselves
+    /// (INativeQueryTrunk&lt;T&gt;, e.g. SQL) are handed it instead.
     /// </summary>
     public class DefaultQueryPlanner<T> : IQueryPlanner<T> where T : class
     {
+        // Cost units: checking one cached nut during a scan costs 0.1, fetching a nut by id
+        // (cache lookup, or trunk read on a miss) costs 1
+        private const double SCAN_ROW_COST = 0.1;
+        private const double FETCH_ROW_COST = 1.0;
+        private const double SCAN_SETUP_COST = 1.0;
+        private const double ID_ROW_COST = 0.05;        // producing or probing one id
+        private const double SEEK_LEVEL_COST = 0.25;    // per level of a balanced index
+        private const double SORT_COMPARE_COST = 0.05;
+        private const double NATIVE_INDEX_FACTOR = 0.5;
+
+        // Fraction of rows assumed to pass conditions no index answers
+        private const double RESIDUAL_SELECTIVITY = 1.0 / 3.0;
+
         private readonly Tree<T> _tree;
         private readonly List<IIndex> _indexes;
+        private readonly List<IndexEntry> _entries;
 
         public IReadOnlyList<IIndex> AvailableIndexes => _indexes.AsReadOnly();
 
+        private INativeQueryTrunk<T> NativeQueries => _tree.NativeQueries
+            ?? throw new InvalidOperationException("The tree's trunk no longer runs native queries");
+
         public DefaultQueryPlanner(Tree<T> tree)
         {
             _tree = tree ?? throw new ArgumentNullException(nameof(tree));
             _indexes = tree.GetAllIndexes().ToList();
+            _entries = _indexes
+                .Where(index => index.IndexType != IndexType.Identity)
+                .Select(index => (index, ordered: ScalarIndexSeeker.For<T>(index)))
+                .Where(pair => pair.ordered != null)
+                .Select(pair => new IndexEntry(pair.index, pair.ordered!))
+                .ToList();
         }
 
         public QueryPlan<T> CreatePlan(QueryContext<T> queryContext)
@@ -32,6 +59,15 @@ namespace AcornDB.Query
                 EstimatedCost = double.MaxValue
             };
 
+            var query = new QueryShape(queryContext, _tree.NutCount);
+
+            // Only a text index can answer a full-text search, so it always drives the plan
+            if (queryContext.TextQuery != null)
+            {
+                PlanTextSearch(plan, query);
+                return plan;
+            }
+
             // If index hint is provided, try to use it
             if (!string.IsNullOrEmpty(queryContext.IndexHint))
             {
@@ -42,529 +78,974 @@ namespace AcornDB.Query
                     plan.Strategy = QueryStrategy.IndexSeek;
                     plan.EstimatedCost = 1.0; // Assume hint is correct
                     plan.Explanation = $"Using hinted index: {queryContext.IndexHint}";
+
+                    // Follow the hint for as much of the query as that index can answer
+                    var hinted = BestOption(query, _entries.Where(entry => entry.Index == hintedIndex).ToList());
+                    if (hinted != null)
+                    {
+                        ApplyOption(plan, query, hinted);
+                        plan.Strategy = QueryStrategy.IndexSeek;
+                        plan.EstimatedCost = 1.0;
+                        plan.Explanation = $"Using hinted index: {queryContext.IndexHint}";
+                    }
+                    else
+                    {
+                        DescribeScan(plan, query);
+                    }
                     return plan;
                 }
             }
 
-            // Analyze all available indexes
-            var candidates = new List<IndexCandidate>();
-
-            foreach (var index in _indexes)
+            // A trunk that answers the whole query itself reads only the rows it returns
+            if (PlanNativeQuery(plan, query))
             {
-                var candidate = AnalyzeIndex(index, queryContext);
-                candidates.Add(candidate);
+                return plan;
+            }
 
-                // Update plan if this candidate is better
-                if (candidate.EstimatedCost < plan.EstimatedCost)
-                {
-                    plan.SelectedIndex = index;
-                    plan.Strategy = DetermineStrategy(candidate);
-                    plan.EstimatedCost = candidate.EstimatedCost;
-                    plan.Explanation = candidate.Reason;
-                }
+            // An ordered trunk can serve the id slice directly, far cheaper than any cache scan
+            if (queryContext.HasKeyRange && _tree.SupportsOrderedKeyScans)
+            {
+                plan.Strategy = QueryStrategy.KeyRangeScan;
+                plan.EstimatedCost = Math.Log(_tree.NutCount + 1, 2);
+                plan.EstimatedRowsReturned = queryContext.Take ?? _tree.NutCount;
+                plan.Explanation = "Key range pushed down to ordered trunk";
+                plan.Operations.Add("Scan trunk key range in id order, filter WHERE");
+                AddOrderAndLimitOperations(plan, needsSort: queryContext.OrderBySelector != null);
+                return plan;
             }
 
-            plan.Candidates = candidates;
+            plan.Candidates = _indexes.Select(index => AnalyzeIndex(index, query)).ToList();
+
+            var best = BestOption(query, _entries);
+            var scanCost = ScanCost(query, best);
 
-            // Fall back to full scan if no good index found
-            if (plan.SelectedIndex == null)
+            if (best != null && best.Cost < scanCost)
+            {
+                ApplyOption(plan, query, best);
+                return plan;
+            }
+
+            plan.EstimatedCost = scanCost;
+            if (best != null)
+            {
+                // Report the index that came closest, so Explain shows why it was not used
+                plan.SelectedIndex = best.Path.Index;
+                plan.Explanation = $"Full scan of {query.RowCount} nuts is cheaper than the best index plan " +
+                                   $"(cost {best.Cost:F2}): {best.Reason}";
+            }
+            else
             {
-                plan.Strategy = QueryStrategy.FullScan;
-                plan.EstimatedRowsExamined = _tree.NutCount;
-                plan.EstimatedRowsReturned = queryContext.Take ?? _tree.NutCount;
                 plan.Explanation = "No suitable index found, performing full cache scan";
             }
+            DescribeScan(plan, query);
 
             return plan;
         }
 
         public IEnumerable<Nut<T>> Execute(QueryPlan<T> plan)
         {
+            if (plan.Strategy == QueryStrategy.NativeQuery && plan.NativeFilter != null)
+            {
+                return NativeQueries.Query(plan.NativeFilter);
+            }
+
             IEnumerable<Nut<T>> results;
+            var ordered = false;
 
-            switch (plan.Strategy)
+            if (plan.AccessPath != null && IsIndexStrategy(plan.Strategy))
             {
-                case QueryStrategy.IndexSeek:
-                case QueryStrategy.IndexRangeScan:
-                case QueryStrategy.IndexScan:
-                    results = ExecuteIndexQuery(plan);
-                    break;
-
-                case QueryStrategy.FullScan:
-                default:
-                    results = ExecuteFullScan(plan);
-                    break;
+                results = ExecuteIndexQuery(plan);
+                ordered = plan.ProvidesOrder;
+            }
+            else
+            {
+                results = ExecuteFullScan(plan);
             }
 
             // Apply ordering if needed and not provided by index
-            if (plan.Context.OrderBySelector != null && plan.Strategy == QueryStrategy.FullScan)
+            if (plan.Context.OrderBySelector != null && !ordered)
             {
                 results = plan.Context.OrderDescending
                     ? results.OrderByDescending(plan.Context.OrderBySelector)
                     : results.OrderBy(plan.Context.OrderBySelector);
             }
 
-            // Apply skip/take
-            if (plan.Context.Skip.HasValue)
+            return ApplySkipTake(results, plan.Context);
+        }
+
+        public int Count(QueryPlan<T> plan)
+        {
+            if (plan.Strategy == QueryStrategy.NativeQuery && plan.NativeFilter != null)
             {
-                results = results.Skip(plan.Context.Skip.Value);
+                return NativeQueries.CountQuery(plan.NativeFilter);
             }
 
-            if (plan.Context.Take.HasValue)
+            // Covered plans count ids straight from the indexes, without fetching documents
+            if (plan.IsCovered && plan.AccessPath != null && IsIndexStrategy(plan.Strategy)
+                && !plan.Context.HasKeyRange)
             {
-                results = results.Take(plan.Context.Take.Value);
+                var count = plan.AccessPath.Count();
+                if (plan.Context.Skip.HasValue)
+                    count = Math.Max(0, count - plan.Context.Skip.Value);
+                if (plan.Context.Take.HasValue)
+                    count = Math.Min(count, plan.Context.Take.Value);
+                return (int)count;
             }
 
-            return results;
+            return Execute(plan).Count();
         }
 
-        private IndexCandidate AnalyzeIndex(IIndex index, QueryContext<T> queryContext)
+        private static bool IsIndexStrategy(QueryStrategy strategy)
         {
-            var candidate = new IndexCandidate
-            {
-                Index = index,
-                EstimatedCost = double.MaxValue,
-                Reason = "Not applicable"
-            };
+            return strategy == QueryStrategy.IndexSeek
+                || strategy == QueryStrategy.IndexRangeScan
+                || strategy == QueryStrategy.IndexScan
+                || strategy == QueryStrategy.IndexMerge
+                || strategy == QueryStrategy.TextSearch;
+        }
 
-            var stats = index.GetStatistics();
+        private IEnumerable<Nut<T>> ExecuteIndexQuery(QueryPlan<T> plan)
+        {
+            // Ids stream lazily, so a Take over an ordered path stops fetching once satisfied
+            var results = plan.AccessPath!.GetIds()
+                .Select(id => _tree.CrackNut(id))
+                .Where(nut => nut != null)
+                .Select(nut => nut!);
 
-            // Use expression analyzer to check if WHERE clause matches this index
-            string? wherePropertyName = null;
-            if (queryContext.WhereExpression != null)
+            // Always apply WHERE predicate to ensure correctness
+            // The index narrows down the search space, but the predicate ensures exact matching
+            if (plan.Context.WherePredicate != null)
             {
-                var analyzer = new ExpressionAnalyzer<T>();
-                var analysis = analyzer.Analyze(queryContext.WhereExpression);
-
-                if (analysis.IsIndexable && analysis.Conditions.Any())
-                {
-                    // For now, take the first condition
-                    wherePropertyName = analysis.Conditions[0].PropertyName;
-                }
+                results = results.Where(plan.Context.WherePredicate);
             }
 
-            // Use expression analyzer to check if ORDER BY matches this index
-            string? orderByPropertyName = null;
-            if (queryContext.OrderByExpression != null)
+            if (plan.Context.HasKeyRange)
             {
-                var analyzer = new ExpressionAnalyzer<T>();
+                var context = plan.Context;
+                results = results.Where(nut => Tree<T>.IsInKeyRange(nut.Id, context.KeyFrom, context.KeyTo, context.KeyPrefix));
+            }
 
-                // Try to extract property name from the ORDER BY expression
-                if (queryContext.OrderByExpression is Expression<Func<T, object>> objExpr)
-                {
-                    var orderInfo = analyzer.AnalyzeOrderBy(objExpr);
-                    orderByPropertyName = orderInfo?.PropertyName;
-                }
-                else
-                {
-                    // Handle generic OrderBy expressions using reflection
-                    var method = typeof(ExpressionAnalyzer<T>).GetMethod("AnalyzeOrderBy");
-                    if (method != null)
-                    {
-                        var genericMethod = method.MakeGenericMethod(queryContext.OrderByExpression.ReturnType);
-                        var result = genericMethod.Invoke(analyzer, new object[] { queryContext.OrderByExpression });
-                        if (result is PropertyAccessInfo propInfo)
-                        {
-                            orderByPropertyName = propInfo.PropertyName;
-                        }
-                    }
-                }
+            return results;
+        }
+
+        private IEnumerable<Nut<T>> ExecuteFullScan(QueryPlan<T> plan)
+        {
+            // Key ranges are served in key order: by the trunk when it can, else from the cache
+            IEnumerable<Nut<T>> results = plan.Context.HasKeyRange
+                ? _tree.ScanKeys(plan.Context.KeyFrom, plan.Context.KeyTo, plan.Context.KeyPrefix)
+                : _tree.GetAllNuts();
+
+            // Apply WHERE filter
+            if (plan.Context.WherePredicate != null)
+            {
+                results = results.Where(plan.Context.WherePredicate);
             }
 
-            // Check if this index matches the WHERE property
-            bool matchesWhere = false;
-            bool matchesOrderBy = false;
+            return results;
+        }
 
-            // Extract property name from scalar index using reflection (since we can't cast to specific generic type)
-            if (index.IndexType == IndexType.Scalar)
+        private static IEnumerable<Nut<T>> ApplySkipTake(IEnumerable<Nut<T>> results, QueryContext<T> context)
+        {
+            if (context.Skip.HasValue)
             {
-                var indexType = index.GetType();
-                var interfaces = indexType.GetInterfaces();
-                var scalarInterface = interfaces.FirstOrDefault(i =>
-                    i.IsGenericType && i.GetGenericTypeDefinition() == typeof(IScalarIndex<,>));
+                results = results.Skip(context.Skip.Value);
+            }
 
-                if (scalarInterface != null)
-                {
-                    var propertySelectorProperty = scalarInterface.GetProperty("PropertySelector");
-                    if (propertySelectorProperty != null)
-                    {
-                        var propertySelector = propertySelectorProperty.GetValue(index) as LambdaExpression;
-                        if (propertySelector != null)
-                        {
-                            var indexPropertyName = ExtractPropertyName(propertySelector);
-                            if (indexPropertyName != null)
-                            {
-                                matchesWhere = wherePropertyName == indexPropertyName;
-                                matchesOrderBy = orderByPropertyName == indexPropertyName;
-                            }
-                        }
-                    }
-                }
+            if (context.Take.HasValue)
+            {
+                results = results.Take(context.Take.Value);
             }
 
-            // Identity index is great for ID lookups
-            if (index.IndexType == IndexType.Identity)
+            return results;
+        }
+
+        #region Planning
+
+        /// <summary>
+        /// Cheapest way to answer the query from the given indexes, or null if none can help
+        /// </summary>
+        private AccessOption? BestOption(QueryShape query, List<IndexEntry> entries)
+        {
+            if (entries.Count == 0)
+                return null;
+
+            var options = new List<AccessOption>();
+
+            if (query.Predicate != null)
             {
-                bool matchesIdProperty = wherePropertyName == "Id" || wherePropertyName == "ID";
-                candidate.CanSatisfyWhere = matchesIdProperty;
+                var where = PlanPredicate(query.Predicate, entries, query);
+                if (where != null)
+                    options.Add(Evaluate(query, where.Path, where.Covered, isOrderedScan: false));
+            }
 
-                if (matchesIdProperty)
-                {
-                    candidate.EstimatedCost = 1.0; // O(1) lookup
-                    candidate.Reason = "Identity index: fast O(1) lookup by ID";
-                }
-                else
+            // Walking an index in key order makes ORDER BY + Take read only the first rows
+            if (query.OrderProperty != null)
+            {
+                foreach (var entry in entries)
                 {
-                    // Identity index doesn't help with this query
-                    candidate.EstimatedCost = stats.EntryCount; // Full scan cost
-                    candidate.Reason = "Identity index: does not match query property";
+                    if (!entry.Ordered.IsExact || entry.Ordered.KeyPropertyNames[0] != query.OrderProperty)
+                        continue;
+
+                    var path = CreateSeekPath(entry, IndexRange.All);
+                    path.OrderedBy = query.OrderProperty;
+                    path.SetDescending(query.Context.OrderDescending);
+                    options.Add(Evaluate(query, path, covered: query.Predicate == null && !query.HasOpaqueFilter, isOrderedScan: true));
                 }
             }
-            // Scalar indexes can help with equality and range queries
-            else if (index.IndexType == IndexType.Scalar && matchesWhere)
+
+            return options.OrderBy(option => option.Cost).FirstOrDefault();
+        }
+
+        /// <summary>
+        /// Hand the query to the trunk when it can answer all of it exactly
+        /// </summary>
+        private bool PlanNativeQuery(QueryPlan<T> plan, QueryShape query)
+        {
+            var native = _tree.NativeQueries;
+            var filter = native != null ? CreateNativeFilter(query.Context) : null;
+            if (filter == null || !native!.CanQuery(filter))
+                return false;
+
+            plan.Strategy = QueryStrategy.NativeQuery;
+            plan.NativeFilter = filter;
+            plan.IsCovered = true;
+            plan.EstimatedCost = SCAN_SETUP_COST + Math.Log(query.RowCount + 1, 2);
+            plan.EstimatedRowsReturned = (long)Math.Ceiling(LimitRows(query.RowCount, query.Context));
+            plan.Explanation = $"Query pushed down to {native.Capabilities.TrunkType}";
+            plan.Operations.Add(query.Context.CountOnly
+                ? "Count matching rows in trunk"
+                : "Run WHERE, ORDER BY and Skip/Take in trunk");
+            return true;
+        }
+
+        /// <summary>
+        /// The query as a trunk filter, or null when part of it only exists as a compiled
+        /// delegate (WhereNut, FromNode) that no trunk can translate
+        /// </summary>
+        private static TrunkScanFilter<T>? CreateNativeFilter(QueryContext<T> context)
+        {
+            if (context.HasNutFilter)
+                return null;
+            if (context.OrderBySelector != null && context.OrderByExpression == null && !context.OrderByTimestamp)
+                return null;
+
+            return new TrunkScanFilter<T>
             {
-                // This index matches the WHERE clause property
-                var selectivity = stats.Selectivity;
-                var estimatedRows = (long)(stats.EntryCount * (1.0 - selectivity));
+                TimestampFrom = context.TimestampFrom,
+                TimestampFromInclusive = context.TimestampFromInclusive,
+                TimestampTo = context.TimestampTo,
+                TimestampToInclusive = context.TimestampToInclusive,
+                KeyFrom = context.KeyFrom,
+                KeyTo = context.KeyTo,
+                KeyPrefix = context.KeyPrefix,
+                Where = context.WhereExpression,
+                OrderBy = context.OrderByTimestamp ? null : context.OrderByExpression,
+                OrderByTimestamp = context.OrderByTimestamp,
+                OrderDescending = context.OrderDescending,
+                Skip = context.Skip,
+                Take = context.Take
+            };
+        }
 
-                candidate.EstimatedCost = Math.Log(stats.EntryCount + 1, 2); // O(log n) lookup
-                candidate.CanSatisfyWhere = true;
-                candidate.Reason = $"Scalar index matches WHERE clause, selectivity {selectivity:P2}, estimated {estimatedRows} rows";
-            }
-            else if (index.IndexType == IndexType.Scalar)
+        /// <summary>
+        /// Search the text index, intersected with whatever the indexes can do for WHERE.
+        /// Without a filter or ORDER BY only the first Skip + Take matches are retrieved.
+        /// </summary>
+        private void PlanTextSearch(QueryPlan<T> plan, QueryShape query)
+        {
+            var context = query.Context;
+            var name = context.TextIndexName ?? context.IndexHint;
+            var index = _indexes.OfType<ITextIndex<T>>().FirstOrDefault(i => name == null || i.Name == name);
+            if (index == null)
             {
-                // Index doesn't match WHERE but might help with other things
-                candidate.EstimatedCost = stats.EntryCount; // Full scan cost
-                candidate.Reason = $"Scalar index does not match query predicates";
+                plan.Explanation = name == null
+                    ? "No text index found for full-text search"
+                    : $"Text index '{name}' not found";
+                return;
             }
 
-            // Check if index can help with ORDER BY
-            if (matchesOrderBy)
+            var unfiltered = query.Predicate == null && !query.HasOpaqueFilter && !context.HasKeyRange;
+            int? topK = unfiltered && context.OrderBySelector == null && context.Take.HasValue && !context.CountOnly
+                ? (context.Skip ?? 0) + context.Take.Value
+                : null;
+
+            // Searching reads postings rather than documents: rows are guessed like a residual
+            var statistics = index.GetStatistics();
+            var rows = statistics.EntryCount * RESIDUAL_SELECTIVITY;
+            IndexAccessPath path = new TextSearchPath<T>(index, context.TextQuery!, topK,
+                topK.HasValue ? Math.Min(rows, topK.Value) : rows,
+                SEEK_LEVEL_COST + rows * ID_ROW_COST);
+
+            var covered = unfiltered;
+            var where = query.Predicate != null ? PlanPredicate(query.Predicate, _entries, query) : null;
+            if (where != null)
             {
-                candidate.CanSatisfyOrderBy = true;
-                // Reduce cost significantly if ordering can be satisfied
-                candidate.EstimatedCost *= 0.3;
-                candidate.Reason += " + provides sorted results";
+                var matches = query.RowCount > 0 ? rows * Math.Min(1.0, where.Path.EstimatedRows / query.RowCount) : 0;
+                path = new IndexIntersectionPath(new List<IndexAccessPath> { path, where.Path }, matches, ID_ROW_COST);
+                covered = where.Covered && !context.HasKeyRange;
             }
 
-            // Prefer native indexes - they're maintained by the database engine
-            // Native indexes typically have better performance than managed indexes
-            if (IsNativeIndex(index))
+            var fetched = context.CountOnly && covered ? 0 : path.EstimatedRows;
+            var option = new AccessOption(path, covered, providesOrder: false, isOrderedScan: false)
             {
-                candidate.EstimatedCost *= 0.5; // Reduce cost by 50% to prefer native
-                candidate.Reason += " (native DB index)";
-            }
+                Cost = path.Cost + fetched * FETCH_ROW_COST
+                       + (context.OrderBySelector != null && !context.CountOnly ? SortCost(path.EstimatedRows) : 0),
+                RowsExamined = fetched,
+                RowsReturned = covered ? path.EstimatedRows : path.EstimatedRows * RESIDUAL_SELECTIVITY,
+                Reason = where != null
+                    ? "Text index answers search, intersected with index results for WHERE, ranked by relevance"
+                    : "Text index answers search, ranked by relevance"
+            };
 
-            return candidate;
+            ApplyOption(plan, query, option);
+            plan.Strategy = QueryStrategy.TextSearch;
+        }
+
+        private double ScanCost(QueryShape query, AccessOption? best)
+        {
+            var matches = query.RowCount * WhereSelectivity(query, best);
+            var cost = SCAN_SETUP_COST + query.RowCount * SCAN_ROW_COST;
+            if (query.Context.OrderBySelector != null && !query.Context.CountOnly)
+                cost += SortCost(matches);
+            return cost;
         }
 
-        private bool IsNativeIndex(IIndex index)
+        /// <summary>
+        /// Fraction of the tree the WHERE clause keeps, as far as the indexes can tell
+        /// </summary>
+        private double WhereSelectivity(QueryShape query, AccessOption? best)
         {
-            // Check if the index implements INativeIndex interface
-            var indexType = index.GetType();
-            var interfaces = indexType.GetInterfaces();
+            if (query.Predicate == null)
+                return query.HasOpaqueFilter ? RESIDUAL_SELECTIVITY : 1.0;
 
-            return interfaces.Any(i =>
-                i.IsGenericType &&
-                i.GetGenericTypeDefinition().Name.Contains("INativeIndex") ||
-                i.Name == "INativeIndex");
+            var where = best?.IsOrderedScan == false
+                ? best
+                : null;
+            if (where == null || query.RowCount == 0)
+                return RESIDUAL_SELECTIVITY;
+
+            var selectivity = Math.Min(1.0, where.Path.EstimatedRows / query.RowCount);
+            return where.Covered ? selectivity : selectivity * RESIDUAL_SELECTIVITY;
         }
 
-        private string? ExtractPropertyName(LambdaExpression expression)
+        private AccessOption Evaluate(QueryShape query, IndexAccessPath path, bool covered, bool isOrderedScan)
         {
-            if (expression.Body is MemberExpression member)
+            var context = query.Context;
+            var rows = path.EstimatedRows;
+
+            // Rows surviving the re-check: an ordered scan filters by the whole WHERE clause,
+            // other paths only by what their indexes did not answer
+            double residual;
+            if (isOrderedScan)
+                residual = query.Predicate == null && !query.HasOpaqueFilter
+                    ? 1.0
+                    : query.Predicate != null && query.RowCount > 0
+                        ? WhereSelectivity(query, BestOption(query.WithoutOrder(), _entries))
+                        : RESIDUAL_SELECTIVITY;
+            else
+                residual = covered ? 1.0 : RESIDUAL_SELECTIVITY;
+
+            var matches = rows * residual;
+            var providesOrder = query.OrderProperty != null
+                && path.OrderedBy == query.OrderProperty
+                && (path.IsExact || !isOrderedScan);
+
+            double cost;
+            double fetched;
+            if (context.CountOnly && covered && path.IsExact && !context.HasKeyRange)
             {
-                return member.Member.Name;
+                // Counted from the index without reading documents
+                fetched = 0;
+                cost = path.Cost;
             }
-            // Handle unary expressions (like conversions)
-            if (expression.Body is UnaryExpression unary && unary.Operand is MemberExpression unaryMember)
+            else
             {
-                return unaryMember.Member.Name;
+                fetched = rows;
+                if (providesOrder && context.Take.HasValue && !context.CountOnly)
+                {
+                    var wanted = (context.Skip ?? 0) + context.Take.Value;
+                    fetched = Math.Min(rows, wanted / Math.Max(residual, 1e-6));
+                }
+
+                cost = path.CostFor(fetched) + fetched * FETCH_ROW_COST;
+                if (context.OrderBySelector != null && !providesOrder && !context.CountOnly)
+                    cost += SortCost(matches);
             }
-            return null;
+
+            return new AccessOption(path, covered && path.IsExact, providesOrder, isOrderedScan)
+            {
+                Cost = cost,
+                RowsExamined = fetched,
+                RowsReturned = matches,
+                Reason = DescribeReason(path, providesOrder, isOrderedScan)
+            };
         }
 
-        private QueryStrategy DetermineStrategy(IndexCandidate candidate)
+        /// <summary>
+        /// Index access for a predicate node, or null if some part of it cannot use an index.
+        /// Covered means the ids are exactly the documents satisfying the node.
+        /// </summary>
+        private PathPlan? PlanPredicate(PredicateNode node, List<IndexEntry> entries, QueryShape query)
         {
-            if (candidate.Index.IndexType == IndexType.Identity)
+            switch (node.Kind)
             {
-                return QueryStrategy.IndexSeek;
+                case PredicateKind.Condition:
+                    return PlanConjunction(new List<PredicateNode> { node }, entries, query);
+
+                case PredicateKind.And:
+                    return PlanConjunction(node.Children, entries, query);
+
+                case PredicateKind.Or:
+                    // Every alternative needs an index, otherwise the union would miss rows
+                    var branches = new List<PathPlan>();
+                    foreach (var child in node.Children)
+                    {
+                        var branch = PlanPredicate(child, entries, query);
+                        if (branch == null)
+                            return null;
+                        branches.Add(branch);
+                    }
+
+                    var union = new IndexUnionPath(branches.Select(branch => branch.Path).ToList(), query.RowCount, ID_ROW_COST);
+                    return new PathPlan(union, branches.All(branch => branch.Covered));
+
+                default:
+                    return null;
             }
+        }
+
+        private PathPlan? PlanConjunction(List<PredicateNode> children, List<IndexEntry> entries, QueryShape query)
+        {
+            var conditions = children
+                .Where(child => child.Kind == PredicateKind.Condition)
+                .Select(child => child.Condition!)
+                .ToList();
+
+            var options = new List<(IndexAccessPath Path, HashSet<IndexableCondition> Consumed, PredicateNode? Nested, bool Covered)>();
 
-            if (candidate.CanSatisfyWhere && candidate.CanSatisfyOrderBy)
+            foreach (var entry in entries)
             {
-                return QueryStrategy.IndexRangeScan;
+                var seek = TryCreateSeek(entry, conditions, query, out var consumed);
+                if (seek != null)
+                    options.Add((seek, consumed, null, seek.IsExact));
             }
 
-            if (candidate.CanSatisfyWhere)
+            foreach (var child in children.Where(child => child.Kind == PredicateKind.Or))
             {
-                return QueryStrategy.IndexSeek;
+                var nested = PlanPredicate(child, entries, query);
+                if (nested != null)
+                    options.Add((nested.Path, new HashSet<IndexableCondition>(), child, nested.Covered));
             }
 
-            if (candidate.CanSatisfyOrderBy)
+            if (options.Count == 0)
+                return null;
+
+            // Drive with the path that is cheapest to fetch, adding others while the fetches an
+            // intersection saves outweigh building its probe set
+            options.Sort((a, b) =>
+                (a.Path.Cost + a.Path.EstimatedRows * FETCH_ROW_COST).CompareTo(b.Path.Cost + b.Path.EstimatedRows * FETCH_ROW_COST));
+
+            // Among equally cheap drivers, prefer one that already yields ORDER BY order
+            var driverCost = options[0].Path.Cost + options[0].Path.EstimatedRows * FETCH_ROW_COST;
+            var orderedDriver = options.FindIndex(option =>
+                option.Path.OrderedBy == query.OrderProperty
+                && option.Path.Cost + option.Path.EstimatedRows * FETCH_ROW_COST <= driverCost);
+            if (query.OrderProperty != null && orderedDriver > 0)
             {
-                return QueryStrategy.IndexScan;
+                var driver = options[orderedDriver];
+                options.RemoveAt(orderedDriver);
+                options.Insert(0, driver);
             }
 
-            return QueryStrategy.FullScan;
-        }
+            var chosen = new List<int> { 0 };
+            var consumedAll = new HashSet<IndexableCondition>(options[0].Consumed);
+            var rows = options[0].Path.EstimatedRows;
+            var total = Math.Max(query.RowCount, 1);
 
-        private IEnumerable<Nut<T>> ExecuteIndexQuery(QueryPlan<T> plan)
-        {
-            if (plan.SelectedIndex == null)
+            for (int i = 1; i < options.Count; i++)
             {
-                return ExecuteFullScan(plan);
+                var option = options[i];
+
+                // Two indexes over the same conditions are not independent filters
+                if (option.Consumed.Overlaps(consumedAll))
+                    continue;
+
+                var combined = rows * option.Path.EstimatedRows / total;
+                var saved = (rows - combined) * FETCH_ROW_COST;
+                var extra = option.Path.Cost + rows * ID_ROW_COST;
+                if (saved <= extra)
+                    continue;
+
+                chosen.Add(i);
+                consumedAll.UnionWith(option.Consumed);
+                rows = combined;
             }
 
-            // Get document IDs from the index
-            IEnumerable<string> indexResults;
+            var path = chosen.Count == 1
+                ? options[0].Path
+                : new IndexIntersectionPath(chosen.Select(c => options[c].Path).ToList(), rows, ID_ROW_COST);
 
-            // Try to use index for different query strategies
-            switch (plan.Strategy)
-            {
-                case QueryStrategy.IndexSeek:
-                case QueryStrategy.IndexRangeScan:
-                    // Try to extract index-compatible predicates
-                    indexResults = TryUseIndexForFiltering(plan);
-                    break;
+            var covered = chosen.All(c => options[c].Covered) && children.All(child =>
+                child.Kind == PredicateKind.Condition
+                    ? consumedAll.Contains(child.Condition!)
+                    : child.Kind == PredicateKind.Or && chosen.Any(c => options[c].Nested == child));
+
+            return new PathPlan(path, covered);
+        }
 
-                case QueryStrategy.IndexScan:
-                    // Use index for ordering only
-                    indexResults = TryUseIndexForOrdering(plan);
+        /// <summary>
+        /// Seek on one index: equality conditions on a prefix of its key parts, then a range on
+        /// the next part
+        /// </summary>
+        private IndexSeekPath? TryCreateSeek(
+            IndexEntry entry,
+            List<IndexableCondition> conditions,
+            QueryShape query,
+            out HashSet<IndexableCondition> consumed)
+        {
+            var used = new HashSet<IndexableCondition>();
+            consumed = used;
+            var names = entry.Ordered.KeyPropertyNames;
+            var prefix = new List<object?>();
+
+            for (int part = 0; part < names.Count; part++)
+            {
+                object? key = null;
+                var match = conditions.FirstOrDefault(condition =>
+                    condition.PropertyName == names[part]
+                    && condition.Operator == ComparisonOperator.Equal
+                    && entry.Ordered.TryNormalizeKey(part, condition.Value, out key));
+                if (match == null)
                     break;
 
-                default:
-                    return ExecuteFullScan(plan);
+                prefix.Add(key);
+                consumed.Add(match);
             }
 
-            // If index methods didn't return any results (empty enumerable),
-            // it means we couldn't use the index, so fall back to full scan
-            var indexResultsList = indexResults.ToList();
-            if (!indexResultsList.Any())
+            var range = new IndexRange { Prefix = prefix };
+            if (prefix.Count < names.Count)
             {
-                // Fall back to full scan since we couldn't use the index effectively
-                return ExecuteFullScan(plan);
+                var part = prefix.Count;
+                foreach (var condition in conditions)
+                {
+                    if (condition.PropertyName != names[part]
+                        || !entry.Ordered.TryNormalizeKey(part, condition.Value, out var key)
+                        || key == null)
+                        continue;
+
+                    switch (condition.Operator)
+                    {
+                        case ComparisonOperator.GreaterThan:
+                        case ComparisonOperator.GreaterThanOrEqual:
+                            var inclusive = condition.Operator == ComparisonOperator.GreaterThanOrEqual;
+                            if (!TryTighten(range.Lower, range.LowerInclusive, key, inclusive, lower: true, out var tighter))
+                                continue;
+                            if (tighter)
+                            {
+                                range.Lower = key;
+                                range.LowerInclusive = inclusive;
+                            }
+                            consumed.Add(condition);
+                            break;
+
+                        case ComparisonOperator.LessThan:
+                        case ComparisonOperator.LessThanOrEqual:
+                            inclusive = condition.Operator == ComparisonOperator.LessThanOrEqual;
+                            if (!TryTighten(range.Upper, range.UpperInclusive, key, inclusive, lower: false, out tighter))
+                                continue;
+                            if (tighter)
+                            {
+                                range.Upper = key;
+                                range.UpperInclusive = inclusive;
+                            }
+                            consumed.Add(condition);
+                            break;
+                    }
+                }
             }
 
-            // Convert IDs to Nuts by looking them up in the tree
-            var results = indexResultsList
-                .Select(id => _tree.Crack(id))
-                .Where(payload => payload != null)
-                .Select(payload => new Nut<T>
-                {
-                    Id = ExtractIdFromPayload(payload!),
-                    Payload = payload!,
-                    Timestamp = DateTime.UtcNow // Note: We lose timestamp info here - could be improved
-                });
+            if (prefix.Count == 0 && !range.HasRange)
+                return null;
 
-            // Always apply WHERE predicate to ensure correctness
-            // The index narrows down the search space, but the predicate ensures exact matching
-            if (plan.Context.WherePredicate != null)
+            // Every equality on a consumed property is implied when its value matches the key
+            foreach (var condition in conditions.Where(c => c.Operator == ComparisonOperator.Equal && !used.Contains(c)))
             {
-                results = results.Where(plan.Context.WherePredicate);
+                var part = IndexOf(names, condition.PropertyName);
+                if (part >= 0 && part < prefix.Count
+                    && entry.Ordered.TryNormalizeKey(part, condition.Value, out var key)
+                    && Equals(key, prefix[part]))
+                    consumed.Add(condition);
             }
 
-            return results;
+            var path = CreateSeekPath(entry, range);
+            path.OrderedBy = prefix.Count < names.Count ? names[prefix.Count] : names.Count == 1 ? names[0] : null;
+            path.SetDescending(query.OrderProperty != null && path.OrderedBy == query.OrderProperty && query.Context.OrderDescending);
+            return path;
         }
 
-        private IEnumerable<string> TryUseIndexForFiltering(QueryPlan<T> plan)
+        private static int IndexOf(IReadOnlyList<string> names, string name)
         {
-            if (plan.SelectedIndex == null || plan.Context.WhereExpression == null)
+            for (int i = 0; i < names.Count; i++)
             {
-                return Enumerable.Empty<string>();
+                if (names[i] == name)
+                    return i;
             }
+            return -1;
+        }
 
-            // Analyze the WHERE expression to extract indexable conditions
-            var analyzer = new ExpressionAnalyzer<T>();
-            var analysis = analyzer.Analyze(plan.Context.WhereExpression);
+        /// <summary>
+        /// Whether candidate is a stricter bound than current; false if they cannot be compared
+        /// </summary>
+        private static bool TryTighten(object? current, bool currentInclusive, object candidate, bool candidateInclusive, bool lower, out bool tighter)
+        {
+            tighter = true;
+            if (current == null)
+                return true;
 
-            if (!analysis.IsIndexable || !analysis.Conditions.Any())
+            int c;
+            try
+            {
+                c = Comparer<object>.Default.Compare(candidate, current);
+            }
+            catch (ArgumentException)
             {
-                return Enumerable.Empty<string>();
+                return false;
             }
 
-            // Get the first condition (for now, we only handle single conditions)
-            var condition = analysis.Conditions[0];
+            tighter = c == 0 ? currentInclusive && !candidateInclusive : lower ? c > 0 : c < 0;
+            return true;
+        }
+
+        private IndexSeekPath CreateSeekPath(IndexEntry entry, IndexRange range)
+        {
+            var stats = entry.Statistics;
+            var factor = entry.IsNative ? NATIVE_INDEX_FACTOR : 1.0;
+            var seekCost = Math.Log(stats.EntryCount + 1, 2) * SEEK_LEVEL_COST * factor;
+
+            var rows = entry.Ordered.HasCheapCount ? entry.Ordered.Count(range) : stats.EstimateRows(range);
 
-            // Get the property name from the selected index
-            string? indexPropertyName = null;
-            if (plan.SelectedIndex.IndexType == IndexType.Scalar)
+            return new IndexSeekPath(entry.Index, entry.Ordered, range, rows, seekCost, ID_ROW_COST * factor);
+        }
+
+        private static double SortCost(double rows)
+        {
+            return rows > 1 ? rows * Math.Log(rows, 2) * SORT_COMPARE_COST : 0;
+        }
+
+        #endregion
+
+        #region Plan description
+
+        private void ApplyOption(QueryPlan<T> plan, QueryShape query, AccessOption option)
+        {
+            plan.SelectedIndex = option.Path.Index;
+            plan.AccessPath = option.Path;
+            plan.ProvidesOrder = option.ProvidesOrder;
+            plan.IsCovered = option.Covered && (query.Predicate != null || !query.HasOpaqueFilter);
+            plan.Strategy = StrategyFor(option.Path);
+            plan.EstimatedCost = option.Cost;
+            plan.EstimatedRowsExamined = (long)Math.Ceiling(option.RowsExamined);
+            plan.EstimatedRowsReturned = (long)Math.Ceiling(LimitRows(option.RowsReturned, query.Context));
+            plan.Explanation = option.Reason;
+
+            option.Path.Describe(plan.Operations, 0);
+            if (query.Context.CountOnly && plan.IsCovered && !query.Context.HasKeyRange)
             {
-                var indexType = plan.SelectedIndex.GetType();
-                var interfaces = indexType.GetInterfaces();
-                var scalarInterface = interfaces.FirstOrDefault(i =>
-                    i.IsGenericType && i.GetGenericTypeDefinition() == typeof(IScalarIndex<,>));
+                plan.Operations.Add("Count ids from index (no documents fetched)");
+                return;
+            }
 
-                if (scalarInterface != null)
-                {
-                    var propertySelectorProperty = scalarInterface.GetProperty("PropertySelector");
-                    if (propertySelectorProperty != null)
-                    {
-                        var propertySelector = propertySelectorProperty.GetValue(plan.SelectedIndex) as LambdaExpression;
-                        if (propertySelector != null)
-                        {
-                            indexPropertyName = ExtractPropertyName(propertySelector);
-                        }
-                    }
-                }
+            plan.Operations.Add(plan.IsCovered
+                ? "Fetch documents by id"
+                : "Fetch documents by id, re-check WHERE");
+            if (query.Context.HasKeyRange)
+                plan.Operations.Add("Filter key range");
+            AddOrderAndLimitOperations(plan, needsSort: query.Context.OrderBySelector != null && !option.ProvidesOrder);
+        }
+
+        private static void DescribeScan(QueryPlan<T> plan, QueryShape query)
+        {
+            plan.EstimatedRowsExamined = query.RowCount;
+            plan.EstimatedRowsReturned = query.Context.Take ?? query.RowCount;
+            plan.Operations.Add(query.Context.HasKeyRange
+                ? $"Scan cache ({query.RowCount} nuts) in id order within key range, filter WHERE"
+                : $"Scan cache ({query.RowCount} nuts), filter WHERE");
+            AddOrderAndLimitOperations(plan, needsSort: query.Context.OrderBySelector != null);
+        }
+
+        private static void AddOrderAndLimitOperations(QueryPlan<T> plan, bool needsSort)
+        {
+            var context = plan.Context;
+            if (needsSort)
+                plan.Operations.Add(context.OrderDescending ? "Sort descending in memory" : "Sort in memory");
+            if (context.Skip.HasValue || context.Take.HasValue)
+                plan.Operations.Add($"Skip {context.Skip ?? 0}, take {(context.Take.HasValue ? context.Take.Value.ToString() : "all")}");
+        }
+
+        private static double LimitRows(double rows, QueryContext<T> context)
+        {
+            rows = Math.Max(0, rows - (context.Skip ?? 0));
+            return context.Take.HasValue ? Math.Min(rows, context.Take.Value) : rows;
+        }
+
+        private static QueryStrategy StrategyFor(IndexAccessPath path)
+        {
+            switch (path)
+            {
+                case IndexSeekPath seek when seek.IsFullScan:
+                    return QueryStrategy.IndexScan;
+                case IndexSeekPath seek when seek.IsPointLookup || !seek.Range.HasRange:
+                    return QueryStrategy.IndexSeek;
+                case IndexSeekPath:
+                    return QueryStrategy.IndexRangeScan;
+                default:
+                    return QueryStrategy.IndexMerge;
             }
+        }
 
-            // Check if the condition matches the index property
-            if (indexPropertyName != condition.PropertyName)
+        private static string DescribeReason(IndexAccessPath path, bool providesOrder, bool isOrderedScan)
+        {
+            string reason;
+            if (path is IndexSeekPath seek)
+            {
+                reason = isOrderedScan
+                    ? $"{path.Index.IndexType} index provides sorted results for ORDER BY {path.OrderedBy}"
+                    : $"{path.Index.IndexType} index matches WHERE clause ({seek.DescribeRange()}), estimated {path.EstimatedRows:F0} rows";
+                if (providesOrder && !isOrderedScan)
+                    reason += " + provides sorted results";
+                if (path.Index is INativeIndex)
+                    reason += " (native DB index)";
+            }
+            else
             {
-                return Enumerable.Empty<string>();
+                var kind = path is IndexIntersectionPath ? "Intersection" : "Union";
+                reason = $"{kind} of index results matches WHERE clause, estimated {path.EstimatedRows:F0} rows";
+                if (providesOrder)
+                    reason += " + provides sorted results";
             }
+            return reason;
+        }
 
-            // Now we need to call the appropriate index method based on the operator
-            // This requires reflection since we don't know the property type at compile time
-            try
+        /// <summary>
+        /// Per-index view for Explain(): what this index alone could do for the query
+        /// </summary>
+        private IndexCandidate AnalyzeIndex(IIndex index, QueryShape query)
+        {
+            var candidate = new IndexCandidate
             {
-                var indexType = plan.SelectedIndex.GetType();
-                var interfaces = indexType.GetInterfaces();
-                var scalarInterface = interfaces.FirstOrDefault(i =>
-                    i.IsGenericType && i.GetGenericTypeDefinition() == typeof(IScalarIndex<,>));
+                Index = index,
+                EstimatedCost = ScanCost(query, null),
+                Reason = $"{index.IndexType} index does not match query predicates"
+            };
 
-                if (scalarInterface == null)
-                {
-                    return Enumerable.Empty<string>();
-                }
+            if (index.IndexType == IndexType.Identity)
+            {
+                candidate.Reason = "Identity index: keys are nut ids, not payload properties; use KeyRange/KeyPrefix for id queries";
+                return candidate;
+            }
 
-                // Handle equality operator
-                if (condition.Operator == ComparisonOperator.Equal && condition.IsConstantValue)
-                {
-                    // Call index.Lookup(value)
-                    var lookupMethod = scalarInterface.GetMethod("Lookup");
-                    if (lookupMethod != null)
-                    {
-                        var result = lookupMethod.Invoke(plan.SelectedIndex, new[] { condition.Value });
-                        if (result is IEnumerable<string> ids)
-                        {
-                            return ids;
-                        }
-                    }
-                }
-                // Handle range operators
-                else if (condition.IsConstantValue)
-                {
-                    // For range queries, we need to call index.Range(min, max)
-                    // But we only have one condition, so we'll use GetMin() or GetMax() to get bounds
-                    var rangeMethod = scalarInterface.GetMethod("Range");
-                    if (rangeMethod != null)
-                    {
-                        object? min = null;
-                        object? max = null;
-
-                        // Determine min/max based on operator
-                        switch (condition.Operator)
-                        {
-                            case ComparisonOperator.GreaterThan:
-                            case ComparisonOperator.GreaterThanOrEqual:
-                                min = condition.Value;
-                                // Get max from index
-                                var getMaxMethod = scalarInterface.GetMethod("GetMax");
-                                if (getMaxMethod != null)
-                                {
-                                    max = getMaxMethod.Invoke(plan.SelectedIndex, null);
-                                }
-                                break;
-
-                            case ComparisonOperator.LessThan:
-                            case ComparisonOperator.LessThanOrEqual:
-                                // Get min from index
-                                var getMinMethod = scalarInterface.GetMethod("GetMin");
-                                if (getMinMethod != null)
-                                {
-                                    min = getMinMethod.Invoke(plan.SelectedIndex, null);
-                                }
-                                max = condition.Value;
-                                break;
-                        }
-
-                        if (min != null && max != null)
-                        {
-                            var result = rangeMethod.Invoke(plan.SelectedIndex, new[] { min, max });
-                            if (result is IEnumerable<string> ids)
-                            {
-                                return ids;
-                            }
-                        }
-                    }
-                }
+            if (index is ITextIndex<T>)
+            {
+                candidate.Reason = "Text index: answers full-text searches (TreeQuery.Search), not WHERE predicates";
+                return candidate;
             }
-            catch
+
+            var entry = _entries.FirstOrDefault(e => e.Index == index);
+            if (entry == null)
             {
-                // If anything fails, fall back to empty (which triggers full scan)
-                return Enumerable.Empty<string>();
+                candidate.Reason = $"{index.IndexType} index cannot be seeked by the planner";
+                return candidate;
             }
 
-            return Enumerable.Empty<string>();
+            var option = BestOption(query, new List<IndexEntry> { entry });
+            if (option == null)
+                return candidate;
+
+            candidate.EstimatedCost = option.Cost;
+            candidate.Reason = option.Reason;
+            candidate.CanSatisfyWhere = !option.IsOrderedScan;
+            candidate.CanSatisfyOrderBy = option.ProvidesOrder;
+            return candidate;
         }
 
-        private IEnumerable<string> TryUseIndexForOrdering(QueryPlan<T> plan)
+        #endregion
+
+        /// <summary>
+        /// The parts of a query context the planner reasons about, analyzed once per plan
+        /// </summary>
+        private sealed class QueryShape
         {
-            if (plan.SelectedIndex == null || plan.SelectedIndex.IndexType != IndexType.Scalar)
+            public QueryShape(QueryContext<T> context, long rowCount)
             {
-                return Enumerable.Empty<string>();
+                Context = context;
+                RowCount = rowCount;
+                Predicate = Conjunction(context);
+
+                // A predicate with no expression behind it (WhereNut, FromNode, ...) is opaque
+                HasOpaqueFilter = context.WherePredicate != null && Predicate == null;
+                OrderProperty = DirectProperty(context.OrderByExpression);
             }
 
-            // Use index to get all IDs in sorted order
-            try
+            private QueryShape(QueryShape source)
             {
-                var indexType = plan.SelectedIndex.GetType();
-                var interfaces = indexType.GetInterfaces();
-                var scalarInterface = interfaces.FirstOrDefault(i =>
-                    i.IsGenericType && i.GetGenericTypeDefinition() == typeof(IScalarIndex<,>));
+                Context = new QueryContext<T>
+                {
+                    WherePredicate = source.Context.WherePredicate,
+                    WhereExpression = source.Context.WhereExpression
+                };
+                RowCount = source.RowCount;
+                Predicate = source.Predicate;
+                HasOpaqueFilter = source.HasOpaqueFilter;
+            }
 
-                if (scalarInterface == null)
+            public QueryContext<T> Context { get; }
+            public long RowCount { get; }
+            public PredicateNode? Predicate { get; }
+            public bool HasOpaqueFilter { get; }
+            public string? OrderProperty { get; }
+
+            /// <summary>
+            /// Same filter, no ordering or limits (for estimating WHERE selectivity)
+            /// </summary>
+            public QueryShape WithoutOrder() => new QueryShape(this);
+
+            /// <summary>
+            /// The WHERE expression ANDed with the time range, flattened so the planner sees every
+            /// condition. Alongside them a nut filter is an opaque conjunct, which keeps plans
+            /// from counting as covered.
+            /// </summary>
+            private static PredicateNode? Conjunction(QueryContext<T> context)
+            {
+                var conjuncts = new List<PredicateNode>();
+                foreach (var part in new[]
+                         {
+                             context.WhereExpression != null
+                                 ? new ExpressionAnalyzer<T>().AnalyzePredicate(context.WhereExpression)
+                                 : null,
+                             TimestampPredicate(context)
+                         })
                 {
-                    return Enumerable.Empty<string>();
+                    if (part == null)
+                        continue;
+                    if (part.Kind == PredicateKind.And)
+                        conjuncts.AddRange(part.Children);
+                    else
+                        conjuncts.Add(part);
                 }
 
-                // Call GetAllSorted(ascending)
-                var getAllSortedMethod = scalarInterface.GetMethod("GetAllSorted");
-                if (getAllSortedMethod != null)
+                if (conjuncts.Count > 0 && context.HasNutFilter)
+                    conjuncts.Add(PredicateNode.Opaque);
+
+                return conjuncts.Count switch
+                {
+                    0 => null,
+                    1 => conjuncts[0],
+                    _ => new PredicateNode { Kind = PredicateKind.And, Children = conjuncts }
+                };
+            }
+
+            /// <summary>
+            /// Between/After/Before as conditions on Nut.Timestamp, which stash-time indexes
+            /// are keyed on
+            /// </summary>
+            private static PredicateNode? TimestampPredicate(QueryContext<T> context)
+            {
+                var conditions = new List<PredicateNode>();
+                if (context.TimestampFrom.HasValue)
+                    conditions.Add(TimestampCondition(
+                        context.TimestampFromInclusive ? ComparisonOperator.GreaterThanOrEqual : ComparisonOperator.GreaterThan,
+                        context.TimestampFrom.Value));
+                if (context.TimestampTo.HasValue)
+                    conditions.Add(TimestampCondition(
+                        context.TimestampToInclusive ? ComparisonOperator.LessThanOrEqual : ComparisonOperator.LessThan,
+                        context.TimestampTo.Value));
+
+                return conditions.Count switch
+                {
+                    0 => null,
+                    1 => conditions[0],
+                    _ => new PredicateNode { Kind = PredicateKind.And, Children = conditions }
+                };
+            }
+
+            private static PredicateNode TimestampCondition(ComparisonOperator op, DateTime value)
+            {
+                return new PredicateNode
                 {
-                    // Pass ascending = !orderDescending
-                    bool ascending = !plan.Context.OrderDescending;
-                    var result = getAllSortedMethod.Invoke(plan.SelectedIndex, new object[] { ascending });
-                    if (result is IEnumerable<string> ids)
+                    Kind = PredicateKind.Condition,
+                    Condition = new IndexableCondition
                     {
-                        return ids;
+                        PropertyName = ManagedTimeSeriesIndex<T>.StashTimeKey,
+                        PropertyType = typeof(DateTime),
+                        Operator = op,
+                        Value = value,
+                        IsConstantValue = true
                     }
-                }
+                };
             }
-            catch
+
+            /// <summary>
+            /// Property name when the selector is exactly x => x.Property (index order matches)
+            /// </summary>
+            private static string? DirectProperty(LambdaExpression? selector)
             {
-                // Fall back to empty if anything fails
-                return Enumerable.Empty<string>();
-            }
+                var body = selector?.Body;
+                if (body is UnaryExpression { NodeType: ExpressionType.Convert } convert)
+                    body = convert.Operand;
 
-            return Enumerable.Empty<string>();
+                return body is MemberExpression { Expression: ParameterExpression } member
+                    ? member.Member.Name
+                    : null;
+            }
         }
 
-        private string ExtractIdFromPayload(T payload)
+        private sealed class IndexEntry
         {
-            // Try to extract ID from payload using common property names
-            var type = typeof(T);
-            var idProperty = type.GetProperty("Id") ?? type.GetProperty("ID") ?? type.GetProperty("Key");
-            if (idProperty != null)
+            private IndexStatistics? _statistics;
+
+            public IndexEntry(IIndex index, IOrderedIndex ordered)
             {
-                return idProperty.GetValue(payload)?.ToString() ?? Guid.NewGuid().ToString();
+                Index = index;
+                Ordered = ordered;
+                IsNative = index is INativeIndex;
             }
-            return Guid.NewGuid().ToString();
+
+            public IIndex Index { get; }
+            public IOrderedIndex Ordered { get; }
+            public bool IsNative { get; }
+            public IndexStatistics Statistics => _statistics ??= Index.GetStatistics();
         }
 
-        private IEnumerable<Nut<T>> ExecuteFullScan(QueryPlan<T> plan)
+        private sealed class PathPlan
         {
-            IEnumerable<Nut<T>> results = _tree.GetAllNuts();
+            public PathPlan(IndexAccessPath path, bool covered)
+            {
+                Path = path;
+                Covered = covered;
+            }
 
-            // Apply WHERE filter
-            if (plan.Context.WherePredicate != null)
+            public IndexAccessPath Path { get; }
+            public bool Covered { get; }
+        }
+
+        private sealed class AccessOption
+        {
+            public AccessOption(IndexAccessPath path, bool covered, bool providesOrder, bool isOrderedScan)
             {
-                results = results.Where(plan.Context.WherePredicate);
+                Path = path;
+                Covered = covered;
+                ProvidesOrder = providesOrder;
+                IsOrderedScan = isOrderedScan;
             }
 
-            return results;
+            public IndexAccessPath Path { get; }
+            public bool Covered { get; }
+            public bool ProvidesOrder { get; }
+            public bool IsOrderedScan { get; }
+            public double Cost { get; set; }
+            public double RowsExamined { get; set; }
+            public double RowsReturned { get; set; }
+            public string Reason { get; set; } = string.Empty;
         }
     }
 }
@@ -2,6 +2,7 @@ using System;
 using System.Collections.Generic;
 using System.Linq;
 using System.Linq.Expressions;
+using AcornDB.Indexing;
 
 namespace AcornDB.Query
 {
@@ -30,6 +31,86 @@ namespace AcornDB.Query
             return result;
         }
 
+        /// <summary>
+        /// Analyze the AND/OR structure of a WHERE predicate. Unlike Analyze, conditions nested
+        /// under OR, NOT or method calls are not reported as if they all had to hold.
+        /// </summary>
+        public PredicateNode AnalyzePredicate(Expression<Func<T, bool>> expression)
+        {
+            return BuildPredicate(expression.Body);
+        }
+
+        private static PredicateNode BuildPredicate(Expression expression)
+        {
+            switch (expression.NodeType)
+            {
+                case ExpressionType.AndAlso:
+                case ExpressionType.And when expression.Type == typeof(bool):
+                    return Combine(PredicateKind.And, (BinaryExpression)expression);
+
+                case ExpressionType.OrElse:
+                case ExpressionType.Or when expression.Type == typeof(bool):
+                    return Combine(PredicateKind.Or, (BinaryExpression)expression);
+
+                case ExpressionType.MemberAccess:
+                    // u => u.IsActive
+                    return BooleanMember(expression, true);
+
+                case ExpressionType.Not:
+                    // u => !u.IsActive
+                    return BooleanMember(((UnaryExpression)expression).Operand, false);
+            }
+
+            if (expression is BinaryExpression binary && IndexableExpressionVisitor<T>.IsComparisonOperator(binary.NodeType))
+            {
+                var condition = IndexableExpressionVisitor<T>.TryExtractCondition(binary);
+                if (condition != null
+                    && condition.IsConstantValue
+                    && condition.Operator != ComparisonOperator.NotEqual
+                    && (condition.Value != null || condition.Operator == ComparisonOperator.Equal))
+                {
+                    return new PredicateNode { Kind = PredicateKind.Condition, Condition = condition };
+                }
+            }
+
+            return PredicateNode.Opaque;
+        }
+
+        private static PredicateNode Combine(PredicateKind kind, BinaryExpression binary)
+        {
+            var node = new PredicateNode { Kind = kind };
+            foreach (var side in new[] { binary.Left, binary.Right })
+            {
+                var child = BuildPredicate(side);
+                if (child.Kind == kind)
+                    node.Children.AddRange(child.Children); // Flatten a && b && c
+                else
+                    node.Children.Add(child);
+            }
+            return node;
+        }
+
+        private static PredicateNode BooleanMember(Expression expression, bool value)
+        {
+            if (expression is MemberExpression { Expression: ParameterExpression } member && member.Type == typeof(bool))
+            {
+                return new PredicateNode
+                {
+                    Kind = PredicateKind.Condition,
+                    Condition = new IndexableCondition
+                    {
+                        PropertyName = member.Member.Name,
+                        PropertyType = typeof(bool),
+                        Operator = ComparisonOperator.Equal,
+                        Value = value,
+                        IsConstantValue = true
+                    }
+                };
+            }
+
+            return PredicateNode.Opaque;
+        }
+
         /// <summary>
         /// Analyze an ORDER BY expression to extract the property being sorted
         /// </summary>
@@ -67,7 +148,7 @@ namespace AcornDB.Query
             return base.VisitBinary(node);
         }
 
-        private bool IsComparisonOperator(ExpressionType nodeType)
+        internal static bool IsComparisonOperator(ExpressionType nodeType)
         {
             return nodeType == ExpressionType.Equal ||
                    nodeType == ExpressionType.NotEqual ||
@@ -77,7 +158,7 @@ namespace AcornDB.Query
                    nodeType == ExpressionType.LessThanOrEqual;
         }
 
-        private IndexableCondition? TryExtractCondition(BinaryExpression binary)
+        internal static IndexableCondition? TryExtractCondition(BinaryExpression binary)
         {
             // Try to extract: property [operator] value or value [operator] property
             string? propertyName = null;
@@ -131,7 +212,7 @@ namespace AcornDB.Query
             };
         }
 
-        private bool TryGetConstantValue(Expression expression, out object? value)
+        private static bool TryGetConstantValue(Expression expression, out object? value)
         {
             value = null;
 
@@ -142,27 +223,58 @@ namespace AcornDB.Query
                 return true;
             }
 
-            // Member access on a constant (e.g., captured variable)
+            // Member access on a constant (e.g., captured variable), possibly chained
+            // (filter.MinAge) or static (Limits.MaxAge); read through cached compiled getters
             if (expression is MemberExpression memberExpr &&
-                memberExpr.Expression is ConstantExpression closureConstant)
+                memberExpr.Member is System.Reflection.FieldInfo or System.Reflection.PropertyInfo)
             {
-                var member = memberExpr.Member;
-                if (member is System.Reflection.FieldInfo field)
-                {
-                    value = field.GetValue(closureConstant.Value);
-                    return true;
-                }
-                if (member is System.Reflection.PropertyInfo prop)
-                {
-                    value = prop.GetValue(closureConstant.Value);
-                    return true;
-                }
+                object? instance = null;
+                if (memberExpr.Expression != null && !TryGetConstantValue(memberExpr.Expression, out instance))
+                    return false;
+                if (memberExpr.Expression != null && instance == null)
+                    return false; // Would throw NullReferenceException when the query runs
+
+                value = PropertyAccessors.ForMember(memberExpr.Member)(instance);
+                return true;
+            }
+
+            // Conversions the compiler inserts around captured values (e.g. int to long)
+            if (expression is UnaryExpression { NodeType: ExpressionType.Convert, Method: null } convert &&
+                TryGetConstantValue(convert.Operand, out var operand))
+            {
+                value = ConvertConstant(operand, convert.Type);
+                return value != null || operand == null;
             }
 
             return false;
         }
 
-        private ComparisonOperator MapOperator(ExpressionType nodeType, bool swapped)
+        private static object? ConvertConstant(object? value, Type type)
+        {
+            if (value == null)
+                return null;
+
+            var target = Nullable.GetUnderlyingType(type) ?? type;
+            if (target.IsInstanceOfType(value))
+                return value;
+
+            try
+            {
+                return target.IsEnum
+                    ? Enum.ToObject(target, value)
+                    : value is IConvertible ? Convert.ChangeType(value, target, System.Globalization.CultureInfo.InvariantCulture) : null;
+            }
+            catch (InvalidCastException)
+            {
+                return null;
+            }
+            catch (OverflowException)
+            {
+                return null;
+            }
+        }
+
+        private static ComparisonOperator MapOperator(ExpressionType nodeType, bool swapped)
         {
             // If comparison is swapped (value < property instead of property > value),
             // we need to flip the operator
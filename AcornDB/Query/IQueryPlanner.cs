@@ -1,5 +1,6 @@
 using System;
 using System.Collections.Generic;
+using System.Linq;
 using System.Linq.Expressions;
 using AcornDB.Indexing;
 
@@ -25,6 +26,13 @@ namespace AcornDB.Query
         /// <returns>Query results</returns>
         IEnumerable<Nut<T>> Execute(QueryPlan<T> plan);
 
+        /// <summary>
+        /// Count the results of a query plan
+        /// </summary>
+        /// <param name="plan">Pre-analyzed execution plan</param>
+        /// <returns>Number of results Execute would return</returns>
+        int Count(QueryPlan<T> plan) => Execute(plan).Count();
+
         /// <summary>
         /// Get available indexes for planning
         /// </summary>
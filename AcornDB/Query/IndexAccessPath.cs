@@ -0,0 +1,259 @@
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using AcornDB.Indexing;
+
+namespace AcornDB.Query
+{
+    /// <summary>
+    /// A way of producing candidate document IDs from indexes, chosen by DefaultQueryPlanner.
+    /// Paths only produce IDs; fetching documents and re-checking the predicate happens after.
+    /// </summary>
+    internal abstract class IndexAccessPath
+    {
+        /// <summary>
+        /// Estimated number of IDs produced
+        /// </summary>
+        public double EstimatedRows { get; set; }
+
+        /// <summary>
+        /// Cost of producing all IDs, in the planner's units
+        /// </summary>
+        public double Cost { get; set; }
+
+        /// <summary>
+        /// Whether the IDs are exactly the documents matching the conditions the path consumed
+        /// </summary>
+        public bool IsExact { get; set; }
+
+        /// <summary>
+        /// Property the IDs come out ordered by (null = no useful order)
+        /// </summary>
+        public string? OrderedBy { get; set; }
+
+        /// <summary>
+        /// Index reported as the plan's SelectedIndex
+        /// </summary>
+        public abstract IIndex Index { get; }
+
+        public abstract IEnumerable<string> GetIds();
+
+        public virtual long Count() => GetIds().LongCount();
+
+        /// <summary>
+        /// Cost when only the first idsRead IDs are consumed (ordered scans under Take)
+        /// </summary>
+        public virtual double CostFor(double idsRead) => Cost;
+
+        /// <summary>
+        /// Produce IDs in descending OrderedBy order
+        /// </summary>
+        public abstract void SetDescending(bool descending);
+
+        public abstract void Describe(List<string> operations, int depth);
+
+        protected static string Indent(int depth) => new string(' ', depth * 2);
+    }
+
+    /// <summary>
+    /// Seek (or ordered scan, for IndexRange.All) on a single ordered index
+    /// </summary>
+    internal sealed class IndexSeekPath : IndexAccessPath
+    {
+        private readonly IIndex _index;
+        private readonly IOrderedIndex _ordered;
+        private readonly double _seekCost;
+        private readonly double _idCost;
+        private bool _descending;
+
+        public IndexSeekPath(IIndex index, IOrderedIndex ordered, IndexRange range, double estimatedRows, double seekCost, double idCost)
+        {
+            _index = index;
+            _ordered = ordered;
+            _seekCost = seekCost;
+            _idCost = idCost;
+            Range = range;
+            EstimatedRows = estimatedRows;
+            Cost = seekCost + estimatedRows * idCost;
+            IsExact = ordered.IsExact;
+        }
+
+        public IndexRange Range { get; }
+
+        public override IIndex Index => _index;
+
+        /// <summary>
+        /// Every key part is pinned to one value
+        /// </summary>
+        public bool IsPointLookup => Range.Prefix.Count == _ordered.KeyPropertyNames.Count;
+
+        public bool IsFullScan => Range.Prefix.Count == 0 && !Range.HasRange;
+
+        public override IEnumerable<string> GetIds() => _ordered.Seek(Range, _descending);
+
+        public override long Count() => _ordered.Count(Range);
+
+        public override double CostFor(double idsRead) => _seekCost + Math.Min(idsRead, EstimatedRows) * _idCost;
+
+        public override void SetDescending(bool descending) => _descending = descending;
+
+        /// <summary>
+        /// Conditions in property terms, e.g. "Department = 'Sales', Age in [30, +∞)"
+        /// </summary>
+        public string DescribeRange()
+        {
+            var names = _ordered.KeyPropertyNames;
+            var parts = new List<string>();
+            for (int i = 0; i < Range.Prefix.Count; i++)
+            {
+                parts.Add($"{names[i]} = {new IndexRange { Prefix = new[] { Range.Prefix[i] } }}");
+            }
+            if (Range.HasRange)
+            {
+                var bounds = new IndexRange
+                {
+                    Lower = Range.Lower,
+                    LowerInclusive = Range.LowerInclusive,
+                    Upper = Range.Upper,
+                    UpperInclusive = Range.UpperInclusive
+                };
+                parts.Add($"{names[Range.Prefix.Count]} in {bounds}");
+            }
+            return string.Join(", ", parts);
+        }
+
+        public override void Describe(List<string> operations, int depth)
+        {
+            var direction = _descending ? " descending" : string.Empty;
+            operations.Add(IsFullScan
+                ? $"{Indent(depth)}Ordered scan {_index.Name} by {OrderedBy}{direction} (~{EstimatedRows:F0} ids)"
+                : $"{Indent(depth)}Seek {_index.Name}: {DescribeRange()}{direction} (~{EstimatedRows:F0} ids)");
+        }
+    }
+
+    /// <summary>
+    /// AND of several paths: streams the first input and probes ID sets built from the rest,
+    /// so the first input's order is kept
+    /// </summary>
+    internal sealed class IndexIntersectionPath : IndexAccessPath
+    {
+        private readonly List<IndexAccessPath> _inputs;
+
+        public IndexIntersectionPath(List<IndexAccessPath> inputs, double estimatedRows, double probeCost)
+        {
+            _inputs = inputs;
+            EstimatedRows = estimatedRows;
+            Cost = inputs.Sum(input => input.Cost) + inputs[0].EstimatedRows * probeCost;
+            IsExact = inputs.All(input => input.IsExact);
+            OrderedBy = inputs[0].OrderedBy;
+        }
+
+        public override IIndex Index => _inputs[0].Index;
+
+        public override IEnumerable<string> GetIds()
+        {
+            var probes = _inputs.Skip(1).Select(input => new HashSet<string>(input.GetIds())).ToList();
+            foreach (var id in _inputs[0].GetIds())
+            {
+                if (probes.TrueForAll(probe => probe.Contains(id)))
+                    yield return id;
+            }
+        }
+
+        public override void SetDescending(bool descending) => _inputs[0].SetDescending(descending);
+
+        public override void Describe(List<string> operations, int depth)
+        {
+            operations.Add($"{Indent(depth)}Intersect {_inputs.Count} index results (~{EstimatedRows:F0} ids)");
+            foreach (var input in _inputs)
+            {
+                input.Describe(operations, depth + 1);
+            }
+        }
+    }
+
+    /// <summary>
+    /// OR of several paths, each ID returned once
+    /// </summary>
+    internal sealed class IndexUnionPath : IndexAccessPath
+    {
+        private readonly List<IndexAccessPath> _inputs;
+
+        public IndexUnionPath(List<IndexAccessPath> inputs, double rowCount, double idCost)
+        {
+            _inputs = inputs;
+            EstimatedRows = Math.Min(inputs.Sum(input => input.EstimatedRows), rowCount);
+            Cost = inputs.Sum(input => input.Cost) + EstimatedRows * idCost;
+            IsExact = inputs.All(input => input.IsExact);
+        }
+
+        public override IIndex Index => _inputs[0].Index;
+
+        public override IEnumerable<string> GetIds()
+        {
+            var seen = new HashSet<string>();
+            foreach (var input in _inputs)
+            {
+                foreach (var id in input.GetIds())
+                {
+                    if (seen.Add(id))
+                        yield return id;
+                }
+            }
+        }
+
+        public override void SetDescending(bool descending)
+        {
+        }
+
+        public override void Describe(List<string> operations, int depth)
+        {
+            operations.Add($"{Indent(depth)}Union {_inputs.Count} index results (~{EstimatedRows:F0} ids)");
+            foreach (var input in _inputs)
+            {
+                input.Describe(operations, depth + 1);
+            }
+        }
+    }
+
+    /// <summary>
+    /// Full-text search on a text index; IDs come out by descending relevance. With a TopK
+    /// only that many are retrieved, letting the index stop early.
+    /// </summary>
+    internal sealed class TextSearchPath<T> : IndexAccessPath where T : class
+    {
+        private readonly ITextIndex<T> _index;
+
+        public TextSearchPath(ITextIndex<T> index, string searchQuery, int? topK, double estimatedRows, double cost)
+        {
+            _index = index;
+            SearchQuery = searchQuery;
+            TopK = topK;
+            EstimatedRows = estimatedRows;
+            Cost = cost;
+            IsExact = true;
+        }
+
+        public string SearchQuery { get; }
+
+        public int? TopK { get; }
+
+        public override IIndex Index => _index;
+
+        public override IEnumerable<string> GetIds()
+        {
+            var results = TopK.HasValue ? _index.Search(SearchQuery, TopK.Value) : _index.Search(SearchQuery);
+            return results.Select(result => result.DocumentId);
+        }
+
+        public override void SetDescending(bool descending)
+        {
+        }
+
+        public override void Describe(List<string> operations, int depth)
+        {
+            var limit = TopK.HasValue ? $", top {TopK.Value}" : string.Empty;
+            operations.Add($"{Indent(depth)}Search {_index.Name}: '{SearchQuery}' by relevance{limit} (~{EstimatedRows:F0} ids)");
+        }
+    }
+}
@@ -0,0 +1,42 @@
+using System.Collections.Generic;
+
+namespace AcornDB.Query
+{
+    public enum PredicateKind
+    {
+        /// <summary>
+        /// All children must hold
+        /// </summary>
+        And,
+
+        /// <summary>
+        /// At least one child must hold
+        /// </summary>
+        Or,
+
+        /// <summary>
+        /// Property compared with a constant; an index can answer it
+        /// </summary>
+        Condition,
+
+        /// <summary>
+        /// Anything else (method calls, property-to-property comparisons, !=); only the
+        /// compiled predicate can answer it
+        /// </summary>
+        Opaque
+    }
+
+    /// <summary>
+    /// Boolean structure of a WHERE expression, so the planner knows which conditions must all
+    /// hold (intersect index results) and which are alternatives (union them). Trunks that
+    /// compile queries (see INativeQueryTrunk&lt;T&gt;) translate the same tree.
+    /// </summary>
+    public sealed class PredicateNode
+    {
+        public PredicateKind Kind { get; set; }
+        public List<PredicateNode> Children { get; set; } = new List<PredicateNode>();
+        public IndexableCondition? Condition { get; set; }
+
+        public static PredicateNode Opaque { get; } = new PredicateNode { Kind = PredicateKind.Opaque };
+    }
+}
@@ -18,6 +18,12 @@ namespace AcornDB.Query
         /// </summary>
         public Expression<Func<T, bool>>? WhereExpression { get; set; }
 
+        /// <summary>
+        /// WherePredicate also holds filters no expression describes (WhereNut, FromNode), so
+        /// WhereExpression and the time range alone do not decide a match
+        /// </summary>
+        public bool HasNutFilter { get; set; }
+
         /// <summary>
         /// ORDER BY key selector
         /// </summary>
@@ -33,6 +39,11 @@ namespace AcornDB.Query
         /// </summary>
         public bool OrderDescending { get; set; }
 
+        /// <summary>
+        /// ORDER BY is Nut.Timestamp (Newest/Oldest), which has no payload expression
+        /// </summary>
+        public bool OrderByTimestamp { get; set; }
+
         /// <summary>
         /// Take count (LIMIT)
         /// </summary>
@@ -43,11 +54,60 @@ namespace AcornDB.Query
         /// </summary>
         public int? Skip { get; set; }
 
+        /// <summary>
+        /// Lowest id to return, inclusive (key order is UTF-8 byte order)
+        /// </summary>
+        public string? KeyFrom { get; set; }
+
+        /// <summary>
+        /// Id to stop before, exclusive
+        /// </summary>
+        public string? KeyTo { get; set; }
+
+        /// <summary>
+        /// Prefix every returned id must start with
+        /// </summary>
+        public string? KeyPrefix { get; set; }
+
+        /// <summary>
+        /// Whether the query is restricted to a slice of the id space
+        /// </summary>
+        public bool HasKeyRange => KeyFrom != null || KeyTo != null || KeyPrefix != null;
+
+        /// <summary>
+        /// Lower bound on Nut.Timestamp set by Between/After (the same filter is in WherePredicate)
+        /// </summary>
+        public DateTime? TimestampFrom { get; set; }
+
+        public bool TimestampFromInclusive { get; set; } = true;
+
+        /// <summary>
+        /// Upper bound on Nut.Timestamp set by Between/Before
+        /// </summary>
+        public DateTime? TimestampTo { get; set; }
+
+        public bool TimestampToInclusive { get; set; } = true;
+
+        /// <summary>
+        /// Full-text search query, answered by a text index (see ITextIndex&lt;T&gt;.Search)
+        /// </summary>
+        public string? TextQuery { get; set; }
+
+        /// <summary>
+        /// Text index to search (null = the tree's first text index)
+        /// </summary>
+        public string? TextIndexName { get; set; }
+
         /// <summary>
         /// Hint: specific index to use (overrides planner)
         /// </summary>
         public string? IndexHint { get; set; }
 
+        /// <summary>
+        /// Only the number of results is needed (plans may skip fetching documents)
+        /// </summary>
+        public bool CountOnly { get; set; }
+
         /// <summary>
         /// Capture timestamp for query tracking
         /// </summary>
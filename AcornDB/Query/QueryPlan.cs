@@ -1,5 +1,6 @@
 using System.Collections.Generic;
 using AcornDB.Indexing;
+using AcornDB.Storage;
 
 namespace AcornDB.Query
 {
@@ -9,7 +10,8 @@ namespace AcornDB.Query
     public class QueryPlan<T>
     {
         /// <summary>
-        /// Selected index to use (null = full scan)
+        /// Index the plan reads; for a FullScan, the cheapest index plan that lost to the scan
+        /// (null = no usable index)
         /// </summary>
         public IIndex? SelectedIndex { get; set; }
 
@@ -47,5 +49,31 @@ namespace AcornDB.Query
         /// All candidate indexes that were considered
         /// </summary>
         public List<IndexCandidate> Candidates { get; set; } = new List<IndexCandidate>();
+
+        /// <summary>
+        /// Steps the plan executes, in order (index seeks, merges, fetch, sort, limit)
+        /// </summary>
+        public List<string> Operations { get; set; } = new List<string>();
+
+        /// <summary>
+        /// Whether the indexes alone decide which documents match, so Count() can be answered
+        /// without fetching them
+        /// </summary>
+        public bool IsCovered { get; set; }
+
+        /// <summary>
+        /// How the index strategies produce document IDs
+        /// </summary>
+        internal IndexAccessPath? AccessPath { get; set; }
+
+        /// <summary>
+        /// Whether AccessPath already yields documents in ORDER BY order
+        /// </summary>
+        internal bool ProvidesOrder { get; set; }
+
+        /// <summary>
+        /// Query handed to the trunk by a NativeQuery plan
+        /// </summary>
+        internal TrunkScanFilter<T>? NativeFilter { get; set; }
     }
 }
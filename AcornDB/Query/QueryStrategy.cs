@@ -28,6 +28,21 @@ namespace AcornDB.Query
         /// <summary>
         /// Multiple index merge
         /// </summary>
-        IndexMerge
+        IndexMerge,
+
+        /// <summary>
+        /// Key range or prefix scan pushed down to a trunk that stores ids in order
+        /// </summary>
+        KeyRangeScan,
+
+        /// <summary>
+        /// Full-text search on a text index, results in relevance order
+        /// </summary>
+        TextSearch,
+
+        /// <summary>
+        /// Whole query run by the trunk itself (see INativeQueryTrunk&lt;T&gt;), e.g. as SQL
+        /// </summary>
+        NativeQuery
     }
 }
@@ -0,0 +1,99 @@
+using System;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.Linq;
+using System.Linq.Expressions;
+using AcornDB.Indexing;
+
+namespace AcornDB.Query
+{
+    /// <summary>
+    /// Drives an IScalarIndex that does not implement IOrderedIndex (e.g. a native database
+    /// index) through Lookup/Range/GetAllSorted. Range only has inclusive bounds and the index
+    /// gives no completeness guarantee, so results are treated as candidates (IsExact = false).
+    /// </summary>
+    internal sealed class ScalarIndexSeeker<T, TProperty> : IOrderedIndex where T : class
+    {
+        private readonly IScalarIndex<T, TProperty> _index;
+
+        public ScalarIndexSeeker(IScalarIndex<T, TProperty> index)
+        {
+            _index = index;
+            KeyPropertyNames = new[]
+            {
+                index.PropertySelector.Body is MemberExpression { Expression: ParameterExpression } member
+                    ? member.Member.Name
+                    : index.PropertySelector.Body.ToString()
+            };
+        }
+
+        public IReadOnlyList<string> KeyPropertyNames { get; }
+
+        public bool IsExact => false;
+
+        public bool TryNormalizeKey(int keyPart, object? value, out object? key)
+        {
+            key = value;
+            return keyPart == 0 && value is TProperty;
+        }
+
+        public IEnumerable<string> Seek(IndexRange range, bool descending = false)
+        {
+            IEnumerable<string> ids;
+            if (range.Prefix.Count == 1)
+            {
+                ids = _index.Lookup((TProperty)range.Prefix[0]!);
+            }
+            else if (range.HasRange)
+            {
+                var min = range.Lower != null ? (TProperty)range.Lower : _index.GetMin();
+                var max = range.Upper != null ? (TProperty)range.Upper : _index.GetMax();
+                if (min == null || max == null)
+                    return Enumerable.Empty<string>();
+
+                ids = _index.Range(min, max);
+            }
+            else
+            {
+                return _index.GetAllSorted(!descending);
+            }
+
+            return descending ? ids.Reverse() : ids;
+        }
+
+        public long Count(IndexRange range) => Seek(range).LongCount();
+    }
+
+    internal static class ScalarIndexSeeker
+    {
+        private static readonly ConcurrentDictionary<(Type, Type), Func<IIndex, IOrderedIndex>?> Factories = new();
+
+        /// <summary>
+        /// Ordered access for an index: the index itself when it implements IOrderedIndex,
+        /// an adapter for other scalar indexes over T, otherwise null
+        /// </summary>
+        public static IOrderedIndex? For<T>(IIndex index) where T : class
+        {
+            if (index is IOrderedIndex ordered)
+                return ordered;
+
+            // A compiled constructor call per index type; planners are created per query
+            var factory = Factories.GetOrAdd((index.GetType(), typeof(T)), key =>
+            {
+                var scalar = key.Item1.GetInterfaces().FirstOrDefault(i =>
+                    i.IsGenericType
+                    && i.GetGenericTypeDefinition() == typeof(IScalarIndex<,>)
+                    && i.GetGenericArguments()[0] == key.Item2);
+                if (scalar == null)
+                    return null;
+
+                var seekerType = typeof(ScalarIndexSeeker<,>).MakeGenericType(scalar.GetGenericArguments());
+                var parameter = Expression.Parameter(typeof(IIndex), "index");
+                var create = Expression.New(seekerType.GetConstructor(new[] { scalar })!, Expression.Convert(parameter, scalar));
+                return Expression.Lambda<Func<IIndex, IOrderedIndex>>(create, parameter).Compile();
+            });
+
+            return factory?.Invoke(index);
+        }
+    }
+}
@@ -2,6 +2,8 @@ using System;
 using System.Collections.Generic;
 using System.Linq;
 using System.Linq.Expressions;
+using AcornDB.Indexing;
+using AcornDB.Storage;
 
 namespace AcornDB.Query
 {
@@ -13,14 +15,26 @@ namespace AcornDB.Query
     {
         private readonly Tree<T> _tree;
         private IEnumerable<Nut<T>> _source;
-        private Func<Nut<T>, bool>? _whereClause;
+        private Func<Nut<T>, bool>? _wherePayload;
         private Expression<Func<T, bool>>? _whereExpression;
+        private Func<Nut<T>, bool>? _whereNut;
+        private string? _originNodeId;
         private Func<Nut<T>, object>? _orderByClause;
         private LambdaExpression? _orderByExpression;
         private bool _orderDescending = false;
+        private bool _orderByTimestamp;
         private int? _takeCount;
         private int? _skipCount;
         private string? _indexHint;
+        private string? _keyFrom;
+        private string? _keyTo;
+        private string? _keyPrefix;
+        private string? _textQuery;
+        private DateTime? _timestampFrom;
+        private DateTime? _timestampTo;
+        private bool _timestampFromInclusive = true;
+        private bool _timestampToInclusive = true;
+        private string? _textIndexName;
 
         internal TreeQuery(Tree<T> tree)
         {
@@ -29,25 +43,36 @@ namespace AcornDB.Query
         }
 
         /// <summary>
-        /// Filter nuts by predicate on the payload
+        /// Filter nuts by predicate on the payload. Repeated calls are ANDed, as in LINQ
         /// </summary>
         public TreeQuery<T> Where(Expression<Func<T, bool>> predicate)
         {
-            _whereExpression = predicate;
-            var compiled = predicate.Compile();
-            _whereClause = nut => compiled(nut.Payload);
+            _whereExpression = _whereExpression == null ? predicate : AndAlso(_whereExpression, predicate);
+            var compiled = _whereExpression.Compile();
+            _wherePayload = nut => compiled(nut.Payload);
             return this;
         }
 
         /// <summary>
-        /// Filter nuts by predicate on the entire nut (payload + metadata)
+        /// Filter nuts by predicate on the entire nut (payload + metadata). Repeated calls are ANDed
         /// </summary>
         public TreeQuery<T> WhereNut(Func<Nut<T>, bool> predicate)
         {
-            _whereClause = predicate;
+            var previous = _whereNut;
+            _whereNut = previous == null ? predicate : nut => previous(nut) && predicate(nut);
             return this;
         }
 
+        /// <summary>
+        /// One lambda over left's parameter, so the planner still sees a single conjunction
+        /// </summary>
+        private static Expression<Func<T, bool>> AndAlso(Expression<Func<T, bool>> left, Expression<Func<T, bool>> right)
+        {
+            var parameter = left.Parameters[0];
+            var rightBody = new PropertyAccessors.ParameterRebinder(right.Parameters[0], parameter).Visit(right.Body);
+            return Expression.Lambda<Func<T, bool>>(Expression.AndAlso(left.Body, rightBody), parameter);
+        }
+
         /// <summary>
         /// Order results by a key selector
         /// </summary>
@@ -56,6 +81,7 @@ namespace AcornDB.Query
             _orderByExpression = keySelector;
             var compiled = keySelector.Compile();
             _orderByClause = nut => compiled(nut.Payload)!;
+            _orderByTimestamp = false;
             _orderDescending = false;
             return this;
         }
@@ -68,6 +94,7 @@ namespace AcornDB.Query
             _orderByExpression = keySelector;
             var compiled = keySelector.Compile();
             _orderByClause = nut => compiled(nut.Payload)!;
+            _orderByTimestamp = false;
             _orderDescending = true;
             return this;
         }
@@ -77,7 +104,9 @@ namespace AcornDB.Query
         /// </summary>
         public TreeQuery<T> Newest()
         {
+            _orderByExpression = null;
             _orderByClause = nut => nut.Timestamp;
+            _orderByTimestamp = true;
             _orderDescending = true;
             return this;
         }
@@ -87,7 +116,9 @@ namespace AcornDB.Query
         /// </summary>
         public TreeQuery<T> Oldest()
         {
+            _orderByExpression = null;
             _orderByClause = nut => nut.Timestamp;
+            _orderByTimestamp = true;
             _orderDescending = false;
             return this;
         }
@@ -115,7 +146,7 @@ namespace AcornDB.Query
         /// </summary>
         public TreeQuery<T> Between(DateTime start, DateTime end)
         {
-            _whereClause = nut => nut.Timestamp >= start && nut.Timestamp <= end;
+            SetTimestampRange(start, true, end, true);
             return this;
         }
 
@@ -124,7 +155,7 @@ namespace AcornDB.Query
         /// </summary>
         public TreeQuery<T> After(DateTime date)
         {
-            _whereClause = nut => nut.Timestamp > date;
+            SetTimestampRange(date, false, null, true);
             return this;
         }
 
@@ -133,7 +164,7 @@ namespace AcornDB.Query
         /// </summary>
         public TreeQuery<T> Before(DateTime date)
         {
-            _whereClause = nut => nut.Timestamp < date;
+            SetTimestampRange(null, true, date, false);
             return this;
         }
 
@@ -142,7 +173,88 @@ namespace AcornDB.Query
         /// </summary>
         public TreeQuery<T> FromNode(string nodeId)
         {
-            _whereClause = nut => nut.OriginNodeId == nodeId;
+            _originNodeId = nodeId;
+            return this;
+        }
+
+        /// <summary>
+        /// A time filter replaces the previous one and is ANDed with the other filters; the
+        /// bounds let a stash-time index (ManagedTimeSeriesIndex.ForStashTime) answer it from buckets
+        /// </summary>
+        private void SetTimestampRange(DateTime? from, bool fromInclusive, DateTime? to, bool toInclusive)
+        {
+            _timestampFrom = from;
+            _timestampFromInclusive = fromInclusive;
+            _timestampTo = to;
+            _timestampToInclusive = toInclusive;
+        }
+
+        /// <summary>
+        /// Every filter set on the query ANDed together, or null if there is none. Where and
+        /// WhereNut predicates accumulate; FromNode and the time range replace their own previous value.
+        /// </summary>
+        private Func<Nut<T>, bool>? BuildWhereClause()
+        {
+            var filters = new List<Func<Nut<T>, bool>>();
+            if (_wherePayload != null)
+                filters.Add(_wherePayload);
+            if (_whereNut != null)
+                filters.Add(_whereNut);
+            if (_originNodeId != null)
+            {
+                var nodeId = _originNodeId;
+                filters.Add(nut => nut.OriginNodeId == nodeId);
+            }
+            if (_timestampFrom.HasValue || _timestampTo.HasValue)
+            {
+                var from = _timestampFrom;
+                var fromInclusive = _timestampFromInclusive;
+                var to = _timestampTo;
+                var toInclusive = _timestampToInclusive;
+                filters.Add(nut =>
+                    (!from.HasValue || (fromInclusive ? nut.Timestamp >= from.Value : nut.Timestamp > from.Value))
+                    && (!to.HasValue || (toInclusive ? nut.Timestamp <= to.Value : nut.Timestamp < to.Value)));
+            }
+
+            return filters.Count switch
+            {
+                0 => null,
+                1 => filters[0],
+                _ => nut => filters.All(filter => filter(nut))
+            };
+        }
+
+        /// <summary>
+        /// Filter by id range [fromInclusive, toExclusive) in key order (UTF-8 byte order).
+        /// A null bound leaves that side open. Pushed down to the trunk when it stores ids in
+        /// order (see IOrderedTrunk&lt;T&gt;).
+        /// </summary>
+        public TreeQuery<T> KeyRange(string? fromInclusive, string? toExclusive)
+        {
+            _keyFrom = fromInclusive;
+            _keyTo = toExclusive;
+            return this;
+        }
+
+        /// <summary>
+        /// Filter by id prefix. Pushed down to the trunk when it stores ids in order.
+        /// </summary>
+        public TreeQuery<T> KeyPrefix(string prefix)
+        {
+            _keyPrefix = prefix ?? throw new ArgumentNullException(nameof(prefix));
+            return this;
+        }
+
+        /// <summary>
+        /// Full-text search through a text index (see WithTextIndex). Results come back by
+        /// relevance unless ordered otherwise; Where and Take still apply.
+        /// Query syntax: words are ranked by BM25, "quoted phrases" must match in order,
+        /// AND or +word makes a word required, -word excludes it and word* matches prefixes.
+        /// </summary>
+        public TreeQuery<T> Search(string searchQuery, string? textIndexName = null)
+        {
+            _textQuery = searchQuery ?? throw new ArgumentNullException(nameof(searchQuery));
+            _textIndexName = textIndexName;
             return this;
         }
 
@@ -191,7 +303,14 @@ namespace AcornDB.Query
         /// </summary>
         public int Count()
         {
-            return ExecuteQuery().Count();
+            // Covered index plans count ids without fetching any documents
+            var indexed = TryCreateIndexPlan(countOnly: true);
+            if (indexed != null)
+            {
+                return indexed.Value.Planner.Count(indexed.Value.Plan);
+            }
+
+            return ExecuteFallback().Count();
         }
 
         /// <summary>
@@ -239,17 +358,29 @@ namespace AcornDB.Query
             return FormatQueryPlan(plan);
         }
 
-        private QueryContext<T> CreateQueryContext()
+        private QueryContext<T> CreateQueryContext(bool countOnly = false)
         {
             return new QueryContext<T>
             {
-                WherePredicate = _whereClause,
+                CountOnly = countOnly,
+                WherePredicate = BuildWhereClause(),
                 WhereExpression = _whereExpression,
+                HasNutFilter = _whereNut != null || _originNodeId != null,
                 OrderBySelector = _orderByClause,
                 OrderByExpression = _orderByExpression,
                 OrderDescending = _orderDescending,
+                OrderByTimestamp = _orderByTimestamp,
                 Take = _takeCount,
                 Skip = _skipCount,
+                KeyFrom = _keyFrom,
+                KeyTo = _keyTo,
+                KeyPrefix = _keyPrefix,
+                TimestampFrom = _timestampFrom,
+                TimestampFromInclusive = _timestampFromInclusive,
+                TimestampTo = _timestampTo,
+                TimestampToInclusive = _timestampToInclusive,
+                TextQuery = _textQuery,
+                TextIndexName = _textIndexName,
                 IndexHint = _indexHint
             };
         }
@@ -259,11 +390,31 @@ namespace AcornDB.Query
             var sb = new System.Text.StringBuilder();
             sb.AppendLine("=== Query Execution Plan ===");
             sb.AppendLine($"Strategy: {plan.Strategy}");
-            sb.AppendLine($"Selected Index: {plan.SelectedIndex?.Name ?? "None (Full Scan)"}");
+            var noIndex = plan.Strategy switch
+            {
+                QueryStrategy.KeyRangeScan => "None (Key Range Scan)",
+                QueryStrategy.NativeQuery => "None (Native Query)",
+                _ => "None (Full Scan)"
+            };
+            sb.AppendLine($"Selected Index: {plan.SelectedIndex?.Name ?? noIndex}");
             sb.AppendLine($"Estimated Cost: {plan.EstimatedCost:F2}");
             sb.AppendLine($"Estimated Rows Examined: {plan.EstimatedRowsExamined}");
             sb.AppendLine($"Estimated Rows Returned: {plan.EstimatedRowsReturned}");
             sb.AppendLine($"Explanation: {plan.Explanation}");
+            if (plan.IsCovered)
+            {
+                sb.AppendLine("Covered: indexes decide every match");
+            }
+
+            if (plan.Operations.Any())
+            {
+                sb.AppendLine();
+                sb.AppendLine("Index Operations:");
+                foreach (var operation in plan.Operations)
+                {
+                    sb.AppendLine($"  {operation}");
+                }
+            }
 
             if (plan.Candidates.Any())
             {
@@ -284,36 +435,102 @@ namespace AcornDB.Query
 
         private IEnumerable<Nut<T>> ExecuteQuery()
         {
-            // Try to use query planner for index-aware execution
+            var indexed = TryCreateIndexPlan(countOnly: false);
+            return indexed != null
+                ? indexed.Value.Planner.Execute(indexed.Value.Plan)
+                : ExecuteFallback();
+        }
+
+        /// <summary>
+        /// Plan through the query planner when there are indexes to use; null if the plan is a
+        /// plain scan (LINQ over the cache is just as fast) or planning fails
+        /// </summary>
+        private (DefaultQueryPlanner<T> Planner, QueryPlan<T> Plan)? TryCreateIndexPlan(bool countOnly)
+        {
             // Only use planner if we have indexes to potentially use
-            var availableIndexes = _tree.GetAllIndexes().ToList();
-            if (availableIndexes.Any())
+            if (!_tree.GetAllIndexes().Any())
             {
-                try
+                return _textQuery == null ? null : throw MissingTextIndex();
+            }
+
+            try
+            {
+                var planner = new DefaultQueryPlanner<T>(_tree);
+                var plan = planner.CreatePlan(CreateQueryContext(countOnly));
+
+                // A search has no scan equivalent: without a text index it cannot run
+                if (_textQuery != null && plan.Strategy != QueryStrategy.TextSearch)
                 {
-                    var planner = new DefaultQueryPlanner<T>(_tree);
-                    var context = CreateQueryContext();
-                    var plan = planner.CreatePlan(context);
-
-                    // Use planner execution if it selected an index
-                    if (plan.SelectedIndex != null && plan.Strategy != QueryStrategy.FullScan)
-                    {
-                        return planner.Execute(plan);
-                    }
+                    throw MissingTextIndex();
                 }
-                catch
+
+                // Use planner execution if it selected an index or pushed the query down
+                if ((plan.SelectedIndex != null && plan.Strategy != QueryStrategy.FullScan)
+                    || plan.Strategy == QueryStrategy.KeyRangeScan
+                    || plan.Strategy == QueryStrategy.NativeQuery)
                 {
-                    // Fall back to manual execution if planner fails
+                    return (planner, plan);
                 }
             }
+            catch when (_textQuery == null)
+            {
+                // Fall back to manual execution if planner fails
+            }
+
+            return null;
+        }
+
+        private InvalidOperationException MissingTextIndex()
+        {
+            return new InvalidOperationException(_textIndexName == null
+                ? $"Search requires a text index on {typeof(T).Name}; add one with WithTextIndex()"
+                : $"Text index '{_textIndexName}' not found");
+        }
+
+        private TrunkScanFilter<T> CreateScanFilter()
+        {
+            return new TrunkScanFilter<T>
+            {
+                TimestampFrom = _timestampFrom,
+                TimestampFromInclusive = _timestampFromInclusive,
+                TimestampTo = _timestampTo,
+                TimestampToInclusive = _timestampToInclusive,
+                KeyFrom = _keyFrom,
+                KeyTo = _keyTo,
+                KeyPrefix = _keyPrefix,
+                Where = _whereExpression
+            };
+        }
 
+        private IEnumerable<Nut<T>> ExecuteFallback()
+        {
             // Fall back to manual LINQ-based execution
-            IEnumerable<Nut<T>> query = _source;
+            bool hasKeyRange = _keyFrom != null || _keyTo != null || _keyPrefix != null;
+            IEnumerable<Nut<T>> query;
+            if (_tree.SupportsScanPushdown && (hasKeyRange || _timestampFrom.HasValue || _timestampTo.HasValue || _whereExpression != null))
+            {
+                // The trunk skips what it can rule out; the clauses below still decide matches
+                var filter = CreateScanFilter();
+                query = _tree.ScanWhere(filter);
+                if (hasKeyRange)
+                {
+                    query = query
+                        .Where(nut => filter.MatchesKey(nut.Id))
+                        .OrderBy(nut => nut.Id, TrunkScanFilter<T>.KeyComparer);
+                }
+            }
+            else
+            {
+                query = hasKeyRange
+                    ? _tree.ScanKeys(_keyFrom, _keyTo, _keyPrefix)
+                    : _source;
+            }
 
             // Apply where clause
-            if (_whereClause != null)
+            var whereClause = BuildWhereClause();
+            if (whereClause != null)
             {
-                query = query.Where(_whereClause);
+                query = query.Where(whereClause);
             }
 
             // Apply ordering
@@ -1,4 +1,6 @@
 using System;
+using System.Buffers;
+using System.Buffers.Text;
 using System.IO;
 using System.Security.Cryptography;
 using System.Text;
@@ -90,6 +92,60 @@ namespace AcornDB.Security
             return reader.ReadToEnd();
         }
 
+        /// <summary>
+        /// Span version of <see cref="Encrypt(string)"/>: same ciphertext (Base64 of AES-CBC
+        /// with PKCS7 padding, as UTF-8), using one-shot AES instead of streams and strings
+        /// </summary>
+        public void Encrypt(ReadOnlySpan<byte> plaintext, IBufferWriter<byte> output)
+        {
+            if (plaintext.IsEmpty)
+                return;
+
+            using var aes = Aes.Create();
+            aes.Key = _key;
+
+            int cipherLength = aes.GetCiphertextLengthCbc(plaintext.Length);
+            var cipher = ArrayPool<byte>.Shared.Rent(cipherLength);
+            try
+            {
+                aes.EncryptCbc(plaintext, _iv, cipher.AsSpan(0, cipherLength), PaddingMode.PKCS7);
+
+                var destination = output.GetSpan(Base64.GetMaxEncodedToUtf8Length(cipherLength));
+                Base64.EncodeToUtf8(cipher.AsSpan(0, cipherLength), destination, out _, out int written);
+                output.Advance(written);
+            }
+            finally
+            {
+                ArrayPool<byte>.Shared.Return(cipher, clearArray: true);
+            }
+        }
+
+        /// <summary>
+        /// Span version of <see cref="Decrypt(string)"/>
+        /// </summary>
+        public void Decrypt(ReadOnlySpan<byte> ciphertext, IBufferWriter<byte> output)
+        {
+            if (ciphertext.IsEmpty)
+                return;
+
+            var cipher = ArrayPool<byte>.Shared.Rent(Base64.GetMaxDecodedFromUtf8Length(ciphertext.Length));
+            try
+            {
+                if (Base64.DecodeFromUtf8(ciphertext, cipher, out _, out int cipherLength) != OperationStatus.Done)
+                    throw new FormatException("Ciphertext is not valid Base64");
+
+                using var aes = Aes.Create();
+                aes.Key = _key;
+
+                int written = aes.DecryptCbc(cipher.AsSpan(0, cipherLength), _iv, output.GetSpan(cipherLength), PaddingMode.PKCS7);
+                output.Advance(written);
+            }
+            finally
+            {
+                ArrayPool<byte>.Shared.Return(cipher);
+            }
+        }
+
         /// <summary>
         /// Export key as base64 string (for backup/storage)
         /// </summary>
@@ -1,4 +1,6 @@
 using System;
+using System.Buffers;
+using System.Text;
 
 namespace AcornDB.Security
 {
@@ -17,6 +19,25 @@ namespace AcornDB.Security
         /// </summary>
         string Decrypt(string ciphertext);
 
+        /// <summary>
+        /// Encrypt UTF-8 plaintext into <paramref name="output"/>; produces the UTF-8 bytes of
+        /// what <see cref="Encrypt(string)"/> returns, without the intermediate strings.
+        /// Default: adapts to <see cref="Encrypt(string)"/>.
+        /// </summary>
+        void Encrypt(ReadOnlySpan<byte> plaintext, IBufferWriter<byte> output)
+        {
+            output.Write(Encoding.UTF8.GetBytes(Encrypt(Encoding.UTF8.GetString(plaintext))));
+        }
+
+        /// <summary>
+        /// Decrypt UTF-8 ciphertext (as produced by the span Encrypt) into <paramref name="output"/>.
+        /// Default: adapts to <see cref="Decrypt(string)"/>.
+        /// </summary>
+        void Decrypt(ReadOnlySpan<byte> ciphertext, IBufferWriter<byte> output)
+        {
+            output.Write(Encoding.UTF8.GetBytes(Decrypt(Encoding.UTF8.GetString(ciphertext))));
+        }
+
         /// <summary>
         /// Check if this provider is configured and ready
         /// </summary>
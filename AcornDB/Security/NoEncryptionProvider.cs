@@ -1,3 +1,6 @@
+using System;
+using System.Buffers;
+
 namespace AcornDB.Security
 {
     /// <summary>
@@ -10,5 +13,9 @@ namespace AcornDB.Security
         public string Encrypt(string plaintext) => plaintext;
 
         public string Decrypt(string ciphertext) => ciphertext;
+
+        public void Encrypt(ReadOnlySpan<byte> plaintext, IBufferWriter<byte> output) => output.Write(plaintext);
+
+        public void Decrypt(ReadOnlySpan<byte> ciphertext, IBufferWriter<byte> output) => output.Write(ciphertext);
     }
 }
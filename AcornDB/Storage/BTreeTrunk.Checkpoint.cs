@@ -0,0 +1,309 @@
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Text;
+using System.Threading;
+using AcornDB.Logging;
+
+namespace AcornDB.Storage
+{
+    /// <summary>
+    /// Index runs for BTreeTrunk&lt;T&gt;.
+    /// The index is split in two: an immutable sorted run on disk (btree_v2.idx, see
+    /// SortedIndexRun) that stays memory-mapped, and an in-memory delta of the ids written or
+    /// deleted since that run was built. A checkpoint merges the delta into a new run tied to a
+    /// watermark: every record before the watermark is reflected in it, so opening the trunk maps
+    /// the run and replays only the log tail past the watermark. Checkpoints also run whenever the
+    /// delta grows past <see cref="MaxInMemoryIndexEntries"/>, which keeps memory bounded no
+    /// matter how many ids the trunk holds.
+    /// </summary>
+    public partial class BTreeTrunk<T>
+    {
+        private const long DEFAULT_CHECKPOINT_INTERVAL = 64L * 1024 * 1024; // 64MB of log
+        private const int DEFAULT_MAX_IN_MEMORY_INDEX_ENTRIES = 1_000_000;
+
+        private readonly string _checkpointPath;
+        private readonly object _checkpointLock = new(); // One run is built at a time
+        private SortedIndexRun? _run;
+        private long _checkpointWatermark;
+
+        /// <summary>
+        /// Bytes of log to accumulate before a write batch also refreshes the index checkpoint.
+        /// 0 disables automatic checkpoints by log size (one is still written on Dispose and
+        /// Compact, and whenever the in-memory delta is full).
+        /// Default: 64MB
+        /// </summary>
+        public long CheckpointIntervalBytes { get; set; } = DEFAULT_CHECKPOINT_INTERVAL;
+
+        /// <summary>
+        /// Number of ids the in-memory part of the index may hold before it is merged into the
+        /// on-disk run. Default: 1,000,000
+        /// </summary>
+        public int MaxInMemoryIndexEntries { get; set; } = DEFAULT_MAX_IN_MEMORY_INDEX_ENTRIES;
+
+        /// <summary>
+        /// Ids (including deletes) written since the on-disk index run was built
+        /// </summary>
+        public int InMemoryIndexEntryCount => _index.Count;
+
+        /// <summary>
+        /// Log position covered by the most recent checkpoint written or loaded (0 = none)
+        /// </summary>
+        public long CheckpointWatermark => _checkpointWatermark;
+
+        /// <summary>
+        /// Number of log records replayed when the trunk was opened (the tail past the checkpoint)
+        /// </summary>
+        public int RecordsReplayedOnLoad { get; private set; }
+
+        /// <summary>
+        /// Write an index checkpoint now. Records written up to this point are flushed first, so
+        /// the run never refers to data that is not on disk.
+        /// </summary>
+        public void Checkpoint()
+        {
+            WriteRun(replayWatermark: null);
+        }
+
+        /// <summary>
+        /// Merge the in-memory delta into a new on-disk run and swap it in.
+        /// </summary>
+        /// <param name="replayWatermark">
+        /// Position reached by an in-progress log replay; null uses the current write position
+        /// </param>
+        private void WriteRun(long? replayWatermark)
+        {
+            lock (_checkpointLock)
+            {
+                long watermark;
+                KeyValuePair<string, IndexEntry>[] delta;
+
+                // No append can slip in between reading the watermark and copying the delta
+                lock (_appendLock)
+                {
+                    watermark = replayWatermark ?? _filePosition;
+                    delta = _index.ToArray();
+                    _accessor!.Flush();
+                    _fileStream!.Flush(flushToDisk: true);
+                }
+
+                Array.Sort(delta, (a, b) => Utf8KeyComparer.Instance.Compare(a.Key, b.Key));
+
+                var tempPath = _checkpointPath + ".tmp";
+                var previous = AcquireRun();
+                try
+                {
+                    SortedIndexRun.Write(tempPath, watermark, Merge(previous?.Scan(null, null), delta));
+                }
+                finally
+                {
+                    previous?.Release();
+                }
+
+                // Atomic replace: a crash mid-write leaves the previous run intact. Readers still
+                // holding the previous run keep their mapping until they release it.
+                File.Move(tempPath, _checkpointPath, overwrite: true);
+                var run = SortedIndexRun.TryOpen(_checkpointPath)
+                    ?? throw new InvalidDataException("BTreeTrunk index run failed validation after being written");
+                Interlocked.Exchange(ref _run, run)?.Release();
+
+                // The run now answers for the snapshot; ids rewritten since stay in the delta
+                foreach (var kvp in delta)
+                {
+                    _index.TryRemove(kvp);
+                }
+                _checkpointWatermark = watermark;
+            }
+        }
+
+        private void CheckpointIfDue()
+        {
+            bool logDue = CheckpointIntervalBytes > 0 && _filePosition - _checkpointWatermark >= CheckpointIntervalBytes;
+            if (!logDue && _index.Count < MaxInMemoryIndexEntries)
+                return;
+
+            try
+            {
+                Checkpoint();
+            }
+            catch (Exception ex)
+            {
+                // The log is still authoritative; the next open just replays more of it
+                AcornLog.Error($"⚠️ Failed to write BTreeTrunk index checkpoint: {ex.Message}");
+            }
+        }
+
+        /// <summary>
+        /// Map the index run, if there is a valid one for this data file. Any mismatch leaves
+        /// the trunk without a run so the caller falls back to replaying the whole log.
+        /// </summary>
+        private bool TryLoadCheckpoint(out long watermark)
+        {
+            watermark = 0;
+
+            SortedIndexRun? run = null;
+            try
+            {
+                run = SortedIndexRun.TryOpen(_checkpointPath);
+                if (run == null)
+                    return false;
+
+                // The boundary entries must still match the records they point at; otherwise
+                // the data file was replaced (or truncated) after this run was written
+                var mark = run.Watermark;
+                if (mark <= 0 || mark > _filePosition
+                    || !run.Boundaries().All(kvp => kvp.Value.Offset + kvp.Value.Length <= mark && RecordMatches(kvp.Key, kvp.Value)))
+                {
+                    run.Release();
+                    return false;
+                }
+
+                _run = run;
+                watermark = mark;
+                _checkpointWatermark = mark;
+                return true;
+            }
+            catch (Exception ex) when (ex is IOException || ex is UnauthorizedAccessException || ex is ArgumentException)
+            {
+                AcornLog.Info($"⚠️ Ignoring BTreeTrunk index checkpoint: {ex.Message}");
+                run?.Release();
+                return false;
+            }
+        }
+
+        private bool RecordMatches(string id, IndexEntry entry)
+        {
+            var idLen = Encoding.UTF8.GetByteCount(id);
+            var recordStart = entry.Offset - idLen - 1 - HEADER_SIZE;
+            if (recordStart < 0)
+                return false;
+
+            return _accessor!.ReadInt32(recordStart) == MAGIC_NUMBER
+                && _accessor.ReadInt32(recordStart + 16) == entry.Length
+                && _accessor.ReadByte(entry.Offset - 1) == 0;
+        }
+
+        #region Lookups
+
+        /// <summary>
+        /// Take a reference to the current run (null if there is none yet)
+        /// </summary>
+        private SortedIndexRun? AcquireRun()
+        {
+            while (true)
+            {
+                var run = Volatile.Read(ref _run);
+                if (run == null || run.TryAcquire())
+                    return run;
+                // Retired between the read and the acquire; the field already holds its successor
+            }
+        }
+
+        /// <summary>
+        /// Look an id up in the delta, then in the run
+        /// </summary>
+        private bool TryGetEntry(string id, out IndexEntry entry)
+        {
+            if (_index.TryGetValue(id, out entry))
+                return !entry.IsTombstone;
+
+            // Delta entries are only dropped after the run holding them is published, so a
+            // miss here is always answered by the current run
+            var run = AcquireRun();
+            if (run == null)
+                return false;
+
+            try
+            {
+                return run.TryGet(id, out entry);
+            }
+            finally
+            {
+                run.Release();
+            }
+        }
+
+        /// <summary>
+        /// Live entries in key order between <paramref name="fromInclusive"/> and
+        /// <paramref name="toExclusive"/> (null = unbounded), merged from the delta and the run.
+        /// </summary>
+        private IEnumerable<KeyValuePair<string, IndexEntry>> EnumerateIndex(string? fromInclusive, string? toExclusive)
+        {
+            var comparer = Utf8KeyComparer.Instance;
+            KeyValuePair<string, IndexEntry>[] delta;
+            SortedIndexRun? run;
+
+            // The delta and the run must be from the same generation: delta entries are removed
+            // once a newer run holds them, so retry if a run was published while copying
+            while (true)
+            {
+                run = AcquireRun();
+                delta = _index
+                    .Where(kvp => (fromInclusive == null || comparer.Compare(kvp.Key, fromInclusive) >= 0)
+                               && (toExclusive == null || comparer.Compare(kvp.Key, toExclusive) < 0))
+                    .ToArray();
+
+                if (ReferenceEquals(run, Volatile.Read(ref _run)))
+                    break;
+                run?.Release();
+            }
+            Array.Sort(delta, (a, b) => comparer.Compare(a.Key, b.Key));
+
+            try
+            {
+                foreach (var kvp in Merge(run?.Scan(fromInclusive, toExclusive), delta))
+                {
+                    yield return kvp;
+                }
+            }
+            finally
+            {
+                run?.Release();
+            }
+        }
+
+        /// <summary>
+        /// Merge two sorted entry sequences; the delta wins on equal ids and tombstones are dropped
+        /// </summary>
+        private static IEnumerable<KeyValuePair<string, IndexEntry>> Merge(
+            IEnumerable<KeyValuePair<string, IndexEntry>>? run,
+            KeyValuePair<string, IndexEntry>[] delta)
+        {
+            var comparer = Utf8KeyComparer.Instance;
+            int next = 0;
+
+            if (run != null)
+            {
+                foreach (var stored in run)
+                {
+                    int order = 1;
+                    while (next < delta.Length && (order = comparer.Compare(delta[next].Key, stored.Key)) < 0)
+                    {
+                        if (!delta[next].Value.IsTombstone)
+                            yield return delta[next];
+                        next++;
+                    }
+
+                    if (next < delta.Length && order == 0)
+                    {
+                        if (!delta[next].Value.IsTombstone)
+                            yield return delta[next];
+                        next++;
+                        continue;
+                    }
+
+                    yield return stored;
+                }
+            }
+
+            for (; next < delta.Length; next++)
+            {
+                if (!delta[next].Value.IsTombstone)
+                    yield return delta[next];
+            }
+        }
+
+        #endregion
+    }
+}
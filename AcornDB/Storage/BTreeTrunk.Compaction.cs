@@ -0,0 +1,422 @@
+using System;
+using System.Buffers;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.IO;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
+using AcornDB.Logging;
+using AcornDB.Metrics;
+
+namespace AcornDB.Storage
+{
+    /// <summary>
+    /// Online compaction for BTreeTrunk&lt;T&gt;.
+    /// Overwrites and deletes leave dead records in the log. Compaction copies the live records'
+    /// raw bytes (no deserialization, roots untouched) into a new file while writers keep
+    /// appending to the old one, then catches up on the appended tail in a few passes. Writers
+    /// are only paused for the last, small tail copy and the file swap.
+    ///
+    /// With <see cref="AutoCompactionEnabled"/>, a write batch starts a background compaction
+    /// once dead space passes both <see cref="CompactionDeadSpaceRatio"/> and
+    /// <see cref="CompactionMinDeadBytes"/>; that copy is throttled to
+    /// <see cref="CompactionBytesPerSecond"/>.
+    /// </summary>
+    public partial class BTreeTrunk<T>
+    {
+        private const double DEFAULT_COMPACTION_DEAD_SPACE_RATIO = 0.5;
+        private const long DEFAULT_COMPACTION_MIN_DEAD_BYTES = 64L * 1024 * 1024;
+        private const long DEFAULT_COMPACTION_BYTES_PER_SECOND = 32L * 1024 * 1024;
+        private const long CATCH_UP_PAUSE_BYTES = 1024 * 1024; // Tail small enough to copy while paused
+        private const int MAX_CATCH_UP_PASSES = 8;
+
+        private readonly SemaphoreSlim _compactionGate = new(1, 1); // One compaction at a time
+        private readonly CancellationTokenSource _compactionCts = new();
+        private Task? _backgroundCompaction;
+        private int _backgroundScheduled;
+        private long _liveBytes; // Bytes of records that are the latest version of a live id
+        private long _compactionCopied;
+        private long _compactionTotal;
+        private int _compacting;
+
+        private long _compactionCount;
+        private long _lastBytesReclaimed;
+        private long _totalBytesReclaimed;
+        private double _lastPauseMs;
+        private double _maxPauseMs;
+        private double _lastCompactionMs;
+        private DateTime? _lastCompactedAt;
+
+        /// <summary>
+        /// Start a background compaction when dead space crosses the thresholds. Default: true
+        /// </summary>
+        public bool AutoCompactionEnabled { get; set; } = true;
+
+        /// <summary>
+        /// Share of the log (0-1) that must be dead before an automatic compaction. Default: 0.5
+        /// </summary>
+        public double CompactionDeadSpaceRatio { get; set; } = DEFAULT_COMPACTION_DEAD_SPACE_RATIO;
+
+        /// <summary>
+        /// Dead bytes required before an automatic compaction, so small files are left alone.
+        /// Default: 64MB
+        /// </summary>
+        public long CompactionMinDeadBytes { get; set; } = DEFAULT_COMPACTION_MIN_DEAD_BYTES;
+
+        /// <summary>
+        /// Copy rate limit for background compaction (0 = unthrottled). Default: 32MB/s
+        /// </summary>
+        public long CompactionBytesPerSecond { get; set; } = DEFAULT_COMPACTION_BYTES_PER_SECOND;
+
+        /// <summary>
+        /// Compact the database file by removing overwritten and deleted records.
+        /// Runs unthrottled on the calling thread (after any background compaction finishes);
+        /// other threads can keep reading and writing except during the final swap.
+        /// </summary>
+        public void Compact()
+        {
+            RunCompaction(throttled: false, CancellationToken.None);
+        }
+
+        /// <summary>
+        /// Compact on a background thread, throttled to <see cref="CompactionBytesPerSecond"/>
+        /// </summary>
+        public Task CompactAsync(CancellationToken cancellationToken = default)
+        {
+            return Task.Run(() => RunCompaction(throttled: true, cancellationToken), cancellationToken);
+        }
+
+        /// <summary>
+        /// Get dead-space and compaction statistics
+        /// </summary>
+        public CompactionStats GetCompactionStats()
+        {
+            long fileBytes = Interlocked.Read(ref _filePosition);
+            long liveBytes = Math.Min(Interlocked.Read(ref _liveBytes), fileBytes);
+            long total = Interlocked.Read(ref _compactionTotal);
+
+            return new CompactionStats
+            {
+                IsCompacting = Volatile.Read(ref _compacting) == 1,
+                Progress = total > 0 ? Math.Min(1.0, (double)Interlocked.Read(ref _compactionCopied) / total) : 0,
+                FileBytes = fileBytes,
+                LiveBytes = liveBytes,
+                DeadBytes = fileBytes - liveBytes,
+                DeadSpaceRatio = fileBytes > 0 ? (double)(fileBytes - liveBytes) / fileBytes : 0,
+                CompactionCount = Interlocked.Read(ref _compactionCount),
+                LastBytesReclaimed = _lastBytesReclaimed,
+                TotalBytesReclaimed = Interlocked.Read(ref _totalBytesReclaimed),
+                LastPauseMs = _lastPauseMs,
+                MaxPauseMs = _maxPauseMs,
+                LastCompactionMs = _lastCompactionMs,
+                LastCompactedAt = _lastCompactedAt
+            };
+        }
+
+        private long RecordLength(string id, IndexEntry entry) =>
+            HEADER_SIZE + Encoding.UTF8.GetByteCount(id) + 1 + entry.Length;
+
+        /// <summary>
+        /// Sum the live records once the index has been loaded
+        /// </summary>
+        private void MeasureLiveBytes()
+        {
+            long live = 0;
+            foreach (var (id, entry) in EnumerateIndex(null, null))
+            {
+                live += RecordLength(id, entry);
+            }
+            _liveBytes = live;
+        }
+
+        /// <summary>
+        /// Account for an append (under _appendLock): the id's previous record, if any, is now dead
+        /// </summary>
+        private void TrackLiveBytes(string id, int recordLength, bool isTombstone)
+        {
+            if (TryGetEntry(id, out var previous))
+                _liveBytes -= RecordLength(id, previous);
+            if (!isTombstone)
+                _liveBytes += recordLength;
+        }
+
+        private void MaybeStartCompaction()
+        {
+            if (!AutoCompactionEnabled || _disposed || Volatile.Read(ref _compacting) == 1)
+                return;
+
+            long fileBytes = _filePosition;
+            long deadBytes = fileBytes - Interlocked.Read(ref _liveBytes);
+            if (fileBytes == 0 || deadBytes < CompactionMinDeadBytes || (double)deadBytes / fileBytes < CompactionDeadSpaceRatio)
+                return;
+
+            if (Interlocked.CompareExchange(ref _backgroundScheduled, 1, 0) != 0)
+                return;
+
+            var token = _compactionCts.Token;
+            _backgroundCompaction = Task.Run(() =>
+            {
+                try
+                {
+                    RunCompaction(throttled: true, token);
+                }
+                catch (OperationCanceledException)
+                {
+                }
+                catch (Exception ex)
+                {
+                    AcornLog.Error($"⚠️ BTreeTrunk background compaction failed: {ex.Message}");
+                }
+                finally
+                {
+                    Volatile.Write(ref _backgroundScheduled, 0);
+                }
+            });
+        }
+
+        private void StopCompaction()
+        {
+            _compactionCts.Cancel();
+            try
+            {
+                _backgroundCompaction?.Wait();
+            }
+            catch (AggregateException)
+            {
+                // Failures are logged by the background task itself
+            }
+        }
+
+        private void RunCompaction(bool throttled, CancellationToken cancellationToken)
+        {
+            _compactionGate.Wait(cancellationToken);
+            var compactPath = _filePath + ".compact";
+            var runPath = _checkpointPath + ".compact";
+
+            try
+            {
+                Volatile.Write(ref _compacting, 1);
+                var total = Stopwatch.StartNew();
+
+                // Buffered stashes would otherwise land in the tail and be copied twice
+                FlushBatchAsync().GetAwaiter().GetResult();
+
+                long cutoff;
+                lock (_appendLock)
+                {
+                    cutoff = _filePosition;
+                }
+                long sizeBefore = cutoff;
+                Interlocked.Exchange(ref _compactionCopied, 0);
+                Interlocked.Exchange(ref _compactionTotal, Math.Max(1, Interlocked.Read(ref _liveBytes)));
+
+                using var output = new FileStream(compactPath, FileMode.Create, FileAccess.ReadWrite, FileShare.None, 256 * 1024);
+                var throttle = Stopwatch.StartNew();
+                var buffer = ArrayPool<byte>.Shared.Rent(64 * 1024);
+
+                try
+                {
+                    // Phase 1: live records older than the cutoff, in key order. The new run is
+                    // written alongside, since the copy produces it already sorted.
+                    SortedIndexRun.Write(runPath, () => output.Position,
+                        CopyLiveRecords(output, cutoff, throttled, throttle, cancellationToken));
+
+                    // Phase 2: the tail appended since the cutoff is copied verbatim, while
+                    // writers continue, until what is left is small enough to copy paused. These
+                    // passes are not throttled, or a steady writer could outrun them.
+                    long phaseOneLength = output.Position;
+                    long copiedTo = cutoff;
+                    for (int pass = 0; pass < MAX_CATCH_UP_PASSES; pass++)
+                    {
+                        long end;
+                        lock (_appendLock)
+                        {
+                            end = _filePosition;
+                        }
+                        if (end - copiedTo <= CATCH_UP_PAUSE_BYTES)
+                            break;
+
+                        CopyRange(output, copiedTo, end, throttled: false, throttle, ref buffer, cancellationToken);
+                        copiedTo = end;
+                    }
+
+                    // Phase 3: pause writers, copy the rest of the tail and swap files
+                    lock (_checkpointLock)
+                    lock (_appendLock)
+                    {
+                        var pause = Stopwatch.StartNew();
+                        sizeBefore = _filePosition;
+                        CopyRange(output, copiedTo, _filePosition, throttled: false, throttle, ref buffer, CancellationToken.None);
+                        output.Flush(flushToDisk: true);
+                        output.Dispose();
+
+                        _mapLock.EnterWriteLock();
+                        try
+                        {
+                            SwapInCompactedFiles(compactPath, runPath, phaseOneLength);
+                        }
+                        finally
+                        {
+                            _mapLock.ExitWriteLock();
+                        }
+
+                        pause.Stop();
+                        RecordCompaction(sizeBefore, total.Elapsed.TotalMilliseconds, pause.Elapsed.TotalMilliseconds);
+                    }
+                }
+                finally
+                {
+                    ArrayPool<byte>.Shared.Return(buffer);
+                }
+            }
+            finally
+            {
+                Volatile.Write(ref _compacting, 0);
+                Interlocked.Exchange(ref _compactionTotal, 0);
+                TryDelete(compactPath);
+                TryDelete(runPath);
+                _compactionGate.Release();
+            }
+        }
+
+        /// <summary>
+        /// Copy each live record written before <paramref name="cutoff"/> and yield its entry in
+        /// the new file. Records rewritten after the cutoff are left for the tail copy.
+        /// </summary>
+        private IEnumerable<KeyValuePair<string, IndexEntry>> CopyLiveRecords(
+            FileStream output, long cutoff, bool throttled, Stopwatch throttle, CancellationToken cancellationToken)
+        {
+            var buffer = ArrayPool<byte>.Shared.Rent(4096);
+            try
+            {
+                foreach (var (id, entry) in EnumerateIndex(null, null))
+                {
+                    if (entry.Offset >= cutoff)
+                        continue;
+
+                    cancellationToken.ThrowIfCancellationRequested();
+
+                    int recordLength = (int)RecordLength(id, entry);
+                    long recordStart = entry.Offset + entry.Length - recordLength;
+                    if (recordLength > buffer.Length)
+                    {
+                        ArrayPool<byte>.Shared.Return(buffer);
+                        buffer = ArrayPool<byte>.Shared.Rent(recordLength);
+                    }
+
+                    _mapLock.EnterReadLock();
+                    try
+                    {
+                        _accessor!.ReadArray(recordStart, buffer, 0, recordLength);
+                    }
+                    finally
+                    {
+                        _mapLock.ExitReadLock();
+                    }
+
+                    long newStart = output.Position;
+                    output.Write(buffer, 0, recordLength);
+                    Throttle(Interlocked.Add(ref _compactionCopied, recordLength), throttled, throttle, cancellationToken);
+
+                    yield return new(id, entry with { Offset = newStart + recordLength - entry.Length });
+                }
+            }
+            finally
+            {
+                ArrayPool<byte>.Shared.Return(buffer);
+            }
+        }
+
+        private void CopyRange(FileStream output, long from, long to, bool throttled, Stopwatch throttle,
+            ref byte[] buffer, CancellationToken cancellationToken)
+        {
+            for (long position = from; position < to;)
+            {
+                cancellationToken.ThrowIfCancellationRequested();
+
+                int count = (int)Math.Min(buffer.Length, to - position);
+                _mapLock.EnterReadLock();
+                try
+                {
+                    _accessor!.ReadArray(position, buffer, 0, count);
+                }
+                finally
+                {
+                    _mapLock.ExitReadLock();
+                }
+
+                output.Write(buffer, 0, count);
+                position += count;
+                Throttle(Interlocked.Add(ref _compactionCopied, count), throttled, throttle, cancellationToken);
+            }
+        }
+
+        private void Throttle(long copied, bool throttled, Stopwatch throttle, CancellationToken cancellationToken)
+        {
+            var rate = CompactionBytesPerSecond;
+            if (!throttled || rate <= 0)
+                return;
+
+            var ahead = TimeSpan.FromSeconds((double)copied / rate) - throttle.Elapsed;
+            if (ahead > TimeSpan.FromMilliseconds(10))
+                cancellationToken.WaitHandle.WaitOne(ahead);
+        }
+
+        /// <summary>
+        /// Replace the data file and index run with their compacted versions and replay the
+        /// copied tail. Called with appends, checkpoints and readers all excluded.
+        /// </summary>
+        private void SwapInCompactedFiles(string compactPath, string runPath, long phaseOneLength)
+        {
+            _accessor?.Dispose();
+            _mmf?.Dispose();
+            _fileStream?.Dispose();
+
+            // A crash between these steps leaves the data file without a run: the next open
+            // replays it in full instead of trusting offsets from the old file
+            Interlocked.Exchange(ref _run, null)?.Release();
+            File.Delete(_checkpointPath);
+            File.Move(compactPath, _filePath, overwrite: true);
+            File.Move(runPath, _checkpointPath, overwrite: true);
+
+            _run = SortedIndexRun.TryOpen(_checkpointPath);
+            _index.Clear();
+            _filePosition = 0;
+            InitializeMemoryMappedFile();
+            _checkpointWatermark = _run != null ? phaseOneLength : 0;
+
+            // The tail holds writes made during compaction; they go back into the delta at
+            // their new offsets. Live bytes are unchanged: only dead records were dropped.
+            ReplayLog(_run != null ? phaseOneLength : 0);
+        }
+
+        private void RecordCompaction(long sizeBefore, double totalMs, double pauseMs)
+        {
+            long reclaimed = Math.Max(0, sizeBefore - _filePosition);
+
+            Interlocked.Increment(ref _compactionCount);
+            Interlocked.Add(ref _totalBytesReclaimed, reclaimed);
+            _lastBytesReclaimed = reclaimed;
+            _lastPauseMs = pauseMs;
+            _maxPauseMs = Math.Max(_maxPauseMs, pauseMs);
+            _lastCompactionMs = totalMs;
+            _lastCompactedAt = DateTime.UtcNow;
+
+            MetricsCollector.Instance.RecordCompaction(_filePath, reclaimed, pauseMs);
+            AcornLog.Info($"🧹 Compacted BTreeTrunk: reclaimed {reclaimed:N0} bytes in {totalMs:F0}ms (writers paused {pauseMs:F1}ms)");
+        }
+
+        private static void TryDelete(string path)
+        {
+            try
+            {
+                if (File.Exists(path))
+                    File.Delete(path);
+            }
+            catch (IOException)
+            {
+            }
+        }
+    }
+}
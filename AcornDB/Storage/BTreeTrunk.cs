@@ -10,9 +10,9 @@ using System.Runtime.InteropServices;
 using System.Text;
 using System.Threading;
 using System.Threading.Tasks;
+using AcornDB.Logging;
 using AcornDB.Policy;
 using AcornDB.Storage.Serialization;
-using Newtonsoft.Json;
 
 namespace AcornDB.Storage
 {
@@ -24,32 +24,30 @@ namespace AcornDB.Storage
     /// Storage Pipeline:
     /// Write: Nut<T> → Serialize to binary → Root Chain (ascending) → byte[] → Write to MMF
     /// Read: Read MMF → byte[] → Root Chain (descending) → Deserialize from binary → Nut<T>
+    ///
+    /// The data file is an append-only log of records; the index maps each id to its latest
+    /// payload. Most of the index lives in a memory-mapped sorted run on disk, with recent writes
+    /// in a bounded in-memory delta (see BTreeTrunk.Checkpoint.cs), so startup replays only the
+    /// log tail and ids can be scanned in key order (see IOrderedTrunk&lt;T&gt;).
     /// </summary>
-    public class BTreeTrunk<T> : TrunkBase<T>, IDisposable where T : class
+    public partial class BTreeTrunk<T> : TrunkBase<T>, IOrderedTrunk<T>, IDisposable where T : class
     {
         private readonly string _filePath;
-        private readonly ConcurrentDictionary<string, NutEntry> _index;
+        private readonly ConcurrentDictionary<string, IndexEntry> _index; // Delta over _run
         private MemoryMappedFile? _mmf;
         private MemoryMappedViewAccessor? _accessor;
         private long _filePosition;
-        private readonly SemaphoreSlim _mmfWriteLock = new(1, 1);  // For MMF expansion, not batching
+        private readonly ReaderWriterLockSlim _mapLock = new(); // Readers vs. remapping the data file
         private FileStream? _fileStream;
-        private bool _indexLoaded = false;
+        private readonly object _appendLock = new(); // Orders appends against index checkpoints
 
         private const int INITIAL_FILE_SIZE = 64 * 1024 * 1024; // 64MB initial
         private const int BUFFER_THRESHOLD = 256; // Flush after 256 writes
         private const int FLUSH_INTERVAL_MS = 100; // Flush every 100ms
         private const int MAGIC_NUMBER = 0x41434F52; // 'ACOR' in hex
+        private const int TOMBSTONE_LENGTH = IndexEntry.TombstoneLength; // PayloadLen of a record that deletes its id
 
-        private class NutEntry
-        {
-            public long Offset { get; set; }
-            public int Length { get; set; }
-            public DateTime Timestamp { get; set; }
-            public int Version { get; set; }
-        }
-
-        // Binary format header: [Magic:4][Version:4][Timestamp:8][PayloadLen:4][Id][Payload]
+        // Binary format header: [Magic:4][Version:4][Timestamp:8][PayloadLen:4][Id][0][Payload]
         private const int HEADER_SIZE = 20;
 
         public BTreeTrunk(string? customPath = null, ISerializer? serializer = null)
@@ -64,11 +62,16 @@ namespace AcornDB.Storage
             Directory.CreateDirectory(folderPath);
 
             _filePath = Path.Combine(folderPath, "btree_v2.db");
-            _index = new ConcurrentDictionary<string, NutEntry>();
+            _checkpointPath = Path.Combine(folderPath, "btree_v2.idx");
+            _index = new ConcurrentDictionary<string, IndexEntry>();
 
             InitializeMemoryMappedFile();
-            // Note: Do NOT load index in constructor if roots might be needed
-            // LoadIndex will be called automatically after adding roots or on first access
+
+            // Roots only transform payloads, so the index can be built before any are added.
+            // The write position is only known once the log has been read, so this must happen
+            // before the first append.
+            LoadIndex();
+            MeasureLiveBytes();
         }
 
         private void InitializeMemoryMappedFile()
@@ -108,17 +111,29 @@ namespace AcornDB.Storage
         {
             if (_filePosition == 0) return;
 
-            // Fast index loading using memory-mapped file
-            long position = 0;
-            var buffer = ArrayPool<byte>.Shared.Rent(8192);
+            long replayFrom = TryLoadCheckpoint(out var watermark) ? watermark : 0;
+
+            RecordsReplayedOnLoad = ReplayLog(replayFrom);
+
+            // A long tail means the last checkpoint is far behind; start the next open from here
+            if (CheckpointIntervalBytes > 0 && _filePosition - replayFrom >= CheckpointIntervalBytes)
+                Checkpoint();
+        }
+
+        /// <summary>
+        /// Apply the records from <paramref name="position"/> to the end of the log to the index
+        /// and leave the write position just past the last complete record.
+        /// </summary>
+        /// <returns>Number of records applied</returns>
+        private int ReplayLog(long position)
+        {
+            int replayed = 0;
+            var buffer = ArrayPool<byte>.Shared.Rent(512);
 
             try
             {
-                while (position < _filePosition)
+                while (position + HEADER_SIZE <= _filePosition)
                 {
-                    // Read header
-                    if (position + HEADER_SIZE > _filePosition) break;
-
                     int magic = _accessor!.ReadInt32(position);
                     if (magic != MAGIC_NUMBER) break; // Corrupted or end of valid data
 
@@ -126,34 +141,32 @@ namespace AcornDB.Storage
                     long timestampBinary = _accessor.ReadInt64(position + 8);
                     int payloadLen = _accessor.ReadInt32(position + 16);
 
-                    position += HEADER_SIZE;
+                    long idStart = position + HEADER_SIZE;
+                    int idLen = ReadIdLength(idStart, ref buffer);
+                    if (idLen <= 0) break;
 
-                    // Read ID (null-terminated string)
-                    int idLen = 0;
-                    while (position + idLen < _filePosition && _accessor.ReadByte(position + idLen) != 0)
+                    long payloadStart = idStart + idLen + 1; // +1 for null terminator
+                    var id = Encoding.UTF8.GetString(buffer, 0, idLen);
+
+                    if (payloadLen == TOMBSTONE_LENGTH)
                     {
-                        idLen++;
+                        _index[id] = IndexEntry.Tombstone(timestampBinary);
+                        position = payloadStart;
                     }
+                    else
+                    {
+                        if (payloadLen < 0 || payloadStart + payloadLen > _filePosition) break;
 
-                    if (idLen == 0 || position + idLen + 1 + payloadLen > _filePosition) break;
-
-                    // Extract ID
-                    var idBytes = new byte[idLen];
-                    _accessor.ReadArray(position, idBytes, 0, idLen);
-                    var id = Encoding.UTF8.GetString(idBytes);
+                        _index[id] = new IndexEntry(payloadStart, payloadLen, version, timestampBinary);
+                        position = payloadStart + payloadLen;
+                    }
 
-                    position += idLen + 1; // +1 for null terminator
+                    replayed++;
 
-                    // Store entry (payload position)
-                    _index[id] = new NutEntry
-                    {
-                        Offset = position,
-                        Length = payloadLen,
-                        Timestamp = DateTime.FromBinary(timestampBinary),
-                        Version = version
-                    };
-
-                    position += payloadLen;
+                    // Replaying a long log without a run would otherwise hold every id in memory.
+                    // ConcurrentDictionary.Count takes every lock, so it is only checked periodically.
+                    if (replayed % Math.Clamp(MaxInMemoryIndexEntries, 1, 1024) == 0 && _index.Count >= MaxInMemoryIndexEntries)
+                        WriteRun(replayWatermark: position);
                 }
 
                 _filePosition = position;
@@ -162,6 +175,37 @@ namespace AcornDB.Storage
             {
                 ArrayPool<byte>.Shared.Return(buffer);
             }
+
+            return replayed;
+        }
+
+        /// <summary>
+        /// Copy an id into <paramref name="buffer"/> a chunk at a time and find its terminator,
+        /// instead of reading the mapped file one byte per call.
+        /// </summary>
+        /// <returns>Id length in bytes, or -1 if the log ends before the terminator</returns>
+        private int ReadIdLength(long idStart, ref byte[] buffer)
+        {
+            int scanned = 0;
+            while (true)
+            {
+                if (scanned == buffer.Length)
+                {
+                    var larger = ArrayPool<byte>.Shared.Rent(buffer.Length * 2);
+                    Buffer.BlockCopy(buffer, 0, larger, 0, scanned);
+                    ArrayPool<byte>.Shared.Return(buffer);
+                    buffer = larger;
+                }
+
+                int chunk = (int)Math.Min(buffer.Length - scanned, _filePosition - idStart - scanned);
+                if (chunk <= 0) return -1;
+
+                _accessor!.ReadArray(idStart + scanned, buffer, scanned, chunk);
+                int terminator = buffer.AsSpan(scanned, chunk).IndexOf((byte)0);
+                if (terminator >= 0) return scanned + terminator;
+
+                scanned += chunk;
+            }
         }
 
         [MethodImpl(MethodImplOptions.AggressiveInlining)]
@@ -172,19 +216,24 @@ namespace AcornDB.Storage
             StashWithBatchingAsync(id, nut).GetAwaiter().GetResult();
         }
 
+        /// <summary>
+        /// Stash without blocking; completes once the write is committed under
+        /// <see cref="TrunkBase{T}.Durability"/> (with GroupCommit, when its group's fsync lands)
+        /// </summary>
+        public override Task StashAsync(string id, Nut<T> nut)
+        {
+            return StashWithBatchingAsync(id, nut);
+        }
+
         /// <summary>
         /// Write a single item to memory-mapped file (used by TrunkBase for immediate writes if needed)
         /// </summary>
         protected override async Task WriteToStorageAsync(string id, byte[] data, DateTime timestamp, int version)
         {
-            // BTreeTrunk uses binary serialization, so we need to re-wrap the processed data
-            var binaryData = WrapInBinaryFormat(id, data, timestamp, version);
-
-            await Task.Run(() => WriteToMappedFile(id, binaryData, timestamp, version));
+            await Task.Run(() => WriteToMappedFile(id, data, timestamp, version));
 
-            // Flush immediately for non-batched writes
-            _accessor!.Flush();
-            _fileStream!.Flush(flushToDisk: true);
+            CheckpointIfDue();
+            MaybeStartCompaction();
         }
 
         /// <summary>
@@ -197,82 +246,84 @@ namespace AcornDB.Storage
                 // Process batch items
                 foreach (var write in batch)
                 {
-                    // Note: write.ProcessedData is already through IRoot pipeline,
-                    // but we need to wrap it in BTree binary format
-                    var binaryData = WrapInBinaryFormat(write.Id, write.ProcessedData, write.Timestamp, write.Version);
-
-                    WriteToMappedFile(write.Id, binaryData, write.Timestamp, write.Version);
+                    // write.ProcessedData is already through IRoot pipeline; the record
+                    // header is written around it in place
+                    WriteToMappedFile(write.Id, write.ProcessedData, write.Timestamp, write.Version);
                 }
 
-                // Flush all writes to disk at once (batch optimization!)
-                _accessor!.Flush();
-                _fileStream!.Flush(flushToDisk: true);
+                // TrunkBase forces the batch to disk afterwards, once for the whole batch,
+                // according to the durability mode
+                CheckpointIfDue();
+                MaybeStartCompaction();
             });
         }
 
         /// <summary>
-        /// Wrap processed data in BTree binary format
+        /// Append a record to the memory-mapped file. The header and id are encoded into a
+        /// pooled buffer and the payload is copied straight from the caller's array, so the
+        /// record is never assembled in an array of its own. A tombstone record deletes the id
+        /// and ignores the payload.
         /// </summary>
-        private byte[] WrapInBinaryFormat(string id, byte[] processedData, DateTime timestamp, int version)
+        private void WriteToMappedFile(string id, byte[] payload, DateTime timestamp, int version, bool tombstone = false)
         {
-            var idBytes = Encoding.UTF8.GetBytes(id);
-            var buffer = new byte[HEADER_SIZE + idBytes.Length + processedData.Length];
-
-            int offset = 0;
-
-            // Magic number
-            BitConverter.GetBytes(MAGIC_NUMBER).CopyTo(buffer, offset);
-            offset += 4;
-
-            // Version
-            BitConverter.GetBytes(version).CopyTo(buffer, offset);
-            offset += 4;
-
-            // Timestamp
-            BitConverter.GetBytes(timestamp.ToBinary()).CopyTo(buffer, offset);
-            offset += 8;
-
-            // Payload length
-            BitConverter.GetBytes(processedData.Length).CopyTo(buffer, offset);
-            offset += 4;
+            var header = ArrayPool<byte>.Shared.Rent(HEADER_SIZE + Encoding.UTF8.GetMaxByteCount(id.Length) + 1);
+            try
+            {
+                int payloadLength = tombstone ? 0 : payload.Length;
 
-            // ID bytes
-            idBytes.CopyTo(buffer, offset);
-            offset += idBytes.Length;
+                // [Magic:4][Version:4][Timestamp:8][PayloadLen:4][Id][0]
+                var span = header.AsSpan();
+                BitConverter.TryWriteBytes(span, MAGIC_NUMBER);
+                BitConverter.TryWriteBytes(span.Slice(4), version);
+                BitConverter.TryWriteBytes(span.Slice(8), timestamp.ToBinary());
+                BitConverter.TryWriteBytes(span.Slice(16), tombstone ? TOMBSTONE_LENGTH : payloadLength);
+                int idLength = Encoding.UTF8.GetBytes(id, span.Slice(HEADER_SIZE));
+                header[HEADER_SIZE + idLength] = 0;
 
-            // Processed payload
-            processedData.CopyTo(buffer, offset);
+                int headerLength = HEADER_SIZE + idLength + 1;
+                int recordLength = headerLength + payloadLength;
 
-            return buffer;
+                lock (_appendLock)
+                {
+                    var offset = _filePosition;
+                    _filePosition += recordLength;
+
+                    // Ensure capacity
+                    EnsureCapacity(offset + recordLength);
+
+                    // Write data using memory-mapped file (fast!)
+                    _accessor!.WriteArray(offset, header, 0, headerLength);
+                    if (payloadLength > 0)
+                        _accessor.WriteArray(offset + headerLength, payload, 0, payloadLength);
+
+                    // Update index (reads stay lock-free with ConcurrentDictionary). Deletes are kept
+                    // as tombstones until a checkpoint drops the id from the run.
+                    TrackLiveBytes(id, recordLength, tombstone);
+                    _index[id] = tombstone
+                        ? IndexEntry.Tombstone(timestamp.ToBinary())
+                        : new IndexEntry(offset + headerLength, payloadLength, version, timestamp.ToBinary());
+                }
+            }
+            finally
+            {
+                ArrayPool<byte>.Shared.Return(header);
+            }
         }
 
-        [MethodImpl(MethodImplOptions.AggressiveInlining)]
-        private void WriteToMappedFile(string id, byte[] binaryData, DateTime timestamp, int version)
+        /// <summary>
+        /// Write the mapped pages back and fsync the data file
+        /// </summary>
+        protected override void FlushToDisk()
         {
-            var offset = Interlocked.Add(ref _filePosition, binaryData.Length) - binaryData.Length;
-
-            // Ensure capacity
-            EnsureCapacity(offset + binaryData.Length);
-
-            // Write data using memory-mapped file (fast!)
-            _accessor!.WriteArray(offset, binaryData, 0, binaryData.Length);
-
-            // Update index (lock-free with ConcurrentDictionary)
-            // Store the entire processed data (including header, id, and transformed payload)
-            _index[id] = new NutEntry
-            {
-                Offset = offset,
-                Length = binaryData.Length,
-                Timestamp = timestamp,
-                Version = version
-            };
+            _accessor!.Flush();
+            _fileStream!.Flush(flushToDisk: true);
         }
 
         private void EnsureCapacity(long required)
         {
             if (_accessor!.Capacity >= required) return;
 
-            _mmfWriteLock.Wait();
+            _mapLock.EnterWriteLock();
             try
             {
                 // Double check after acquiring lock
@@ -301,125 +352,148 @@ namespace AcornDB.Storage
             }
             finally
             {
-                _mmfWriteLock.Release();
+                _mapLock.ExitWriteLock();
             }
         }
 
         [MethodImpl(MethodImplOptions.AggressiveInlining)]
         public override Nut<T>? Crack(string id)
         {
-            // Ensure index is loaded (only matters if no roots were added)
-            if (!_indexLoaded)
+            // Steps 1-2: Find the entry and read the stored payload from the memory-mapped file.
+            // The read lock only excludes remapping, so the index and the mapping agree.
+            byte[] storedBytes;
+            int length;
+            _mapLock.EnterReadLock();
+            try
             {
-                lock (_rootsLock)
-                {
-                    if (!_indexLoaded)
-                    {
-                        LoadIndex();
-                        _indexLoaded = true;
-                    }
-                }
+                if (!TryGetEntry(id, out var entry))
+                    return null;
+                storedBytes = ReadPayload(entry);
+                length = entry.Length;
+            }
+            finally
+            {
+                _mapLock.ExitReadLock();
             }
 
-            // Step 1: Lock-free read from index
-            if (!_index.TryGetValue(id, out var entry))
-                return null;
-
-            // Step 2: Read entire stored byte array from memory-mapped file (includes header+id+payload)
-            var buffer = ArrayPool<byte>.Shared.Rent(entry.Length);
-            byte[] storedBytes;
             try
             {
-                // Fast read from memory-mapped file
-                _accessor!.ReadArray(entry.Offset, buffer, 0, entry.Length);
-                storedBytes = buffer.AsSpan(0, entry.Length).ToArray();
+                return DecodeNut(id, storedBytes.AsSpan(0, length));
             }
             finally
             {
-                ArrayPool<byte>.Shared.Return(buffer);
+                ArrayPool<byte>.Shared.Return(storedBytes);
             }
+        }
 
-            // Step 3: Process through root chain in descending sequence order (reverse)
-            var processedBytes = ProcessThroughRootsDescending(storedBytes, id);
+        /// <summary>
+        /// Copy a payload into a pooled array (return it to ArrayPool&lt;byte&gt;.Shared)
+        /// </summary>
+        private byte[] ReadPayload(IndexEntry entry)
+        {
+            var storedBytes = ArrayPool<byte>.Shared.Rent(entry.Length);
+            _accessor!.ReadArray(entry.Offset, storedBytes, 0, entry.Length);
+            return storedBytes;
+        }
 
-            // Step 4: Parse header and extract payload from processed bytes
-            // Header format: [Magic:4][Version:4][Timestamp:8][PayloadLen:4][Id][Payload]
-            int pos = HEADER_SIZE;
+        private Nut<T>? DecodeNut(string id, ReadOnlySpan<byte> storedBytes)
+        {
+            // Step 3: Process through root chain in descending sequence order (reverse).
+            // Without roots the stored bytes are deserialized in place.
+            using var restored = _roots.Count > 0 ? ProcessThroughRootsDescending(storedBytes, id) : null;
 
-            // Skip ID (null-terminated)
-            while (pos < processedBytes.Length && processedBytes[pos] != 0)
+            // Step 4: Deserialize bytes back to Nut<T>
+            try
             {
-                pos++;
+                return _serializer.Deserialize<Nut<T>>(restored != null ? restored.WrittenSpan : storedBytes);
+            }
+            catch (Exception ex)
+            {
+                AcornLog.Info($"⚠️ Failed to deserialize nut '{id}': {ex.Message}");
+                return null;
             }
-            pos++; // Skip null terminator
-
-            // Extract payload
-            var payloadBytes = processedBytes.AsSpan(pos);
-
-            // Step 5: Deserialize from binary format
-            return DeserializeBinary(payloadBytes, id, entry);
         }
 
-        // Custom binary serialization - much faster than JSON for metadata
-        private byte[] SerializeBinary(string id, Nut<T> nut)
+        public override void Toss(string id)
         {
-            // Serialize payload to JSON (still fast enough)
-            var json = JsonConvert.SerializeObject(nut.Payload);
-            var jsonBytes = Encoding.UTF8.GetBytes(json);
-            var idBytes = Encoding.UTF8.GetBytes(id);
-
-            var totalSize = HEADER_SIZE + idBytes.Length + 1 + jsonBytes.Length;
-            var buffer = new byte[totalSize];
-
-            int pos = 0;
-
-            // Write header
-            BitConverter.TryWriteBytes(buffer.AsSpan(pos), MAGIC_NUMBER); pos += 4;
-            BitConverter.TryWriteBytes(buffer.AsSpan(pos), nut.Version); pos += 4;
-            BitConverter.TryWriteBytes(buffer.AsSpan(pos), nut.Timestamp.ToBinary()); pos += 8;
-            BitConverter.TryWriteBytes(buffer.AsSpan(pos), jsonBytes.Length); pos += 4;
+            // Pending writes go first so a buffered stash cannot land after the tombstone
+            FlushBatchAsync().GetAwaiter().GetResult();
 
-            // Write ID (null-terminated)
-            Array.Copy(idBytes, 0, buffer, pos, idBytes.Length); pos += idBytes.Length;
-            buffer[pos++] = 0; // Null terminator
+            if (!TryGetEntry(id, out _))
+                return;
 
-            // Write payload
-            Array.Copy(jsonBytes, 0, buffer, pos, jsonBytes.Length);
+            // Append a tombstone so the delete survives a reopen
+            WriteToMappedFile(id, Array.Empty<byte>(), DateTime.UtcNow, 0, tombstone: true);
 
-            return buffer;
+            if (Durability != DurabilityMode.None)
+                FlushToDisk();
         }
 
-        [MethodImpl(MethodImplOptions.AggressiveInlining)]
-        private Nut<T>? DeserializeBinary(Span<byte> data, string id, NutEntry entry)
+        public override IEnumerable<Nut<T>> CrackAll()
         {
-            // Deserialize payload from JSON
-            var json = Encoding.UTF8.GetString(data);
-            var payload = JsonConvert.DeserializeObject<T>(json);
+            return ReadRange(null, null, null);
+        }
 
-            return new Nut<T>
-            {
-                Id = id,
-                Timestamp = entry.Timestamp,
-                Version = entry.Version,
-                Payload = payload
-            };
+        /// <summary>
+        /// Load nuts whose ids fall in [fromInclusive, toExclusive), in key order (UTF-8 byte
+        /// order, i.e. ordinal by code point). Null bounds are open.
+        /// </summary>
+        public IEnumerable<Nut<T>> CrackRange(string? fromInclusive, string? toExclusive)
+        {
+            // Buffered stashes are not in the index yet
+            FlushBatchAsync().GetAwaiter().GetResult();
+            return ReadRange(fromInclusive, toExclusive, null);
         }
 
-        public override void Toss(string id)
+        /// <summary>
+        /// Load nuts whose ids start with <paramref name="prefix"/>, in key order
+        /// </summary>
+        public IEnumerable<Nut<T>> CrackPrefix(string prefix)
         {
-            // Logical delete - just remove from index
-            _index.TryRemove(id, out _);
+            if (prefix == null)
+                throw new ArgumentNullException(nameof(prefix));
+
+            FlushBatchAsync().GetAwaiter().GetResult();
+            return ReadRange(prefix.Length == 0 ? null : prefix, null, prefix);
         }
 
-        public override IEnumerable<Nut<T>> CrackAll()
+        private List<Nut<T>> ReadRange(string? fromInclusive, string? toExclusive, string? prefix)
         {
-            var results = new List<Nut<T>>(_index.Count);
+            var stored = new List<(string Id, byte[] Bytes, int Length)>();
 
-            foreach (var kvp in _index)
+            _mapLock.EnterReadLock();
+            try
+            {
+                foreach (var (id, entry) in EnumerateIndex(fromInclusive, toExclusive))
+                {
+                    // Everything sharing a prefix is contiguous, so the first id without it ends the scan
+                    if (prefix != null && !id.StartsWith(prefix, StringComparison.Ordinal))
+                        break;
+
+                    stored.Add((id, ReadPayload(entry), entry.Length));
+                }
+            }
+            finally
+            {
+                _mapLock.ExitReadLock();
+            }
+
+            var results = new List<Nut<T>>(stored.Count);
+            try
             {
-                var nut = Crack(kvp.Key);
-                if (nut != null)
-                    results.Add(nut);
+                foreach (var (id, bytes, length) in stored)
+                {
+                    var nut = DecodeNut(id, bytes.AsSpan(0, length));
+                    if (nut != null)
+                        results.Add(nut);
+                }
+            }
+            finally
+            {
+                foreach (var (_, bytes, _) in stored)
+                {
+                    ArrayPool<byte>.Shared.Return(bytes);
+                }
             }
 
             return results;
@@ -446,70 +520,36 @@ namespace AcornDB.Storage
             FlushBatchAsync().GetAwaiter().GetResult();
         }
 
-        /// <summary>
-        /// Compact the database file by removing deleted entries
-        /// </summary>
-        public void Compact()
-        {
-            // Flush any pending batched writes before compacting
-            FlushBatchAsync().GetAwaiter().GetResult();
-
-            _mmfWriteLock.Wait();
-            try
-            {
-                var tempPath = _filePath + ".tmp";
-
-                // Create new compacted file
-                using (var tempFs = new FileStream(tempPath, FileMode.Create, FileAccess.Write, FileShare.None))
-                {
-                    // Copy all active entries
-                    foreach (var kvp in _index)
-                    {
-                        var nut = Crack(kvp.Key);
-                        if (nut != null)
-                        {
-                            var data = SerializeBinary(kvp.Key, nut);
-                            tempFs.Write(data, 0, data.Length);
-                        }
-                    }
-
-                    tempFs.Flush(flushToDisk: true);
-                }
-
-                // Dispose current resources
-                _accessor?.Dispose();
-                _mmf?.Dispose();
-                _fileStream?.Dispose();
-
-                // Replace old file
-                File.Delete(_filePath);
-                File.Move(tempPath, _filePath);
-
-                // Reinitialize
-                _index.Clear();
-                _filePosition = 0;
-                InitializeMemoryMappedFile();
-                LoadIndex();
-            }
-            finally
-            {
-                _mmfWriteLock.Release();
-            }
-        }
-
         public override void Dispose()
         {
             if (_disposed) return;
 
+            // A background compaction must not swap files under the disposal below
+            StopCompaction();
+
             // Base class handles timer disposal and flush
             // This ensures proper batching cleanup
             base.Dispose();
 
+            // Save the index so the next open only replays what was written after this point
+            try
+            {
+                if (_filePosition > _checkpointWatermark)
+                    Checkpoint();
+            }
+            catch (Exception ex)
+            {
+                AcornLog.Error($"⚠️ Failed to write BTreeTrunk index checkpoint: {ex.Message}");
+            }
+
             // Dispose BTreeTrunk-specific resources
+            Interlocked.Exchange(ref _run, null)?.Release();
             _accessor?.Dispose();
             _mmf?.Dispose();
             _fileStream?.Dispose();
-            _mmfWriteLock?.Dispose();
+            _mapLock.Dispose();
+            _compactionGate.Dispose();
+            _compactionCts.Dispose();
         }
 
         public override ITrunkCapabilities Capabilities { get; } = new TrunkCapabilities
@@ -518,8 +558,8 @@ namespace AcornDB.Storage
             SupportsSync = true,
             IsDurable = true,
             SupportsAsync = false,
-            TrunkType = "BTreeTrunk",
-            
+            SupportsOrderedScans = true,
+            TrunkType = "BTreeTrunk"
         };
     }
 }
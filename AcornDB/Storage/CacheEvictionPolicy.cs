@@ -0,0 +1,19 @@
+namespace AcornDB.Storage
+{
+    /// <summary>
+    /// How a cache picks items to drop once it reaches its maximum size
+    /// </summary>
+    public enum CacheEvictionPolicy
+    {
+        /// <summary>
+        /// Drop the items with the oldest nut timestamps
+        /// </summary>
+        OldestTimestamp,
+
+        /// <summary>
+        /// Admission-controlled W-TinyLFU: new items only displace residents that are read less
+        /// often, so one-off scans do not flush the working set
+        /// </summary>
+        WTinyLFU
+    }
+}
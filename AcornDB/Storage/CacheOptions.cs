@@ -19,6 +19,12 @@ namespace AcornDB.Storage
         /// </summary>
         public int? MaxCacheSize { get; set; } = 10_000;
 
+        /// <summary>
+        /// Which items to drop when the cache is full. Ignored when MaxCacheSize is null.
+        /// Default: OldestTimestamp
+        /// </summary>
+        public CacheEvictionPolicy EvictionPolicy { get; set; } = CacheEvictionPolicy.OldestTimestamp;
+
         /// <summary>
         /// Warm cache on LoadAll() operations
         /// Default: false (LoadAll doesn't populate cache)
@@ -31,6 +37,26 @@ namespace AcornDB.Storage
         /// </summary>
         public bool InvalidateCacheOnImport { get; set; } = true;
 
+        /// <summary>
+        /// Let one backing-store read serve every concurrent miss on the same key
+        /// Default: true
+        /// </summary>
+        public bool CoalesceMisses { get; set; } = true;
+
+        /// <summary>
+        /// How eagerly hot entries are reloaded in the background before their TTL runs out
+        /// (XFetch beta: 1 refreshes about one backing-store read time ahead, larger is earlier,
+        /// 0 disables). Ignored when TimeToLive is null.
+        /// Default: 1
+        /// </summary>
+        public double RefreshAheadBeta { get; set; } = 1.0;
+
+        /// <summary>
+        /// Maximum backing-store reads CrackMany/CrackManyAsync run at once for the misses of a batch
+        /// Default: 16
+        /// </summary>
+        public int MaxParallelFetches { get; set; } = 16;
+
         /// <summary>
         /// Default cache options (5min TTL, 10K items)
         /// </summary>
@@ -54,6 +80,14 @@ namespace AcornDB.Storage
             MaxCacheSize = 100_000
         };
 
+        /// <summary>
+        /// Scan-resistant cache for a hot working set mixed with bulk reads (5min TTL, 10K items, W-TinyLFU)
+        /// </summary>
+        public static CacheOptions ScanResistant => new CacheOptions
+        {
+            EvictionPolicy = CacheEvictionPolicy.WTinyLFU
+        };
+
         /// <summary>
         /// Aggressive caching (infinite TTL, unlimited size)
         /// Use only for read-only or append-only data
@@ -8,5 +8,41 @@ namespace AcornDB.Storage
         public int CachedItemCount { get; set; }
         public int ExpiredItemCount { get; set; }
         public int ActiveItemCount { get; set; }
+
+        /// <summary>
+        /// Reads served from the cache
+        /// </summary>
+        public long HitCount { get; set; }
+
+        /// <summary>
+        /// Reads that had to go to the backing store
+        /// </summary>
+        public long MissCount { get; set; }
+
+        /// <summary>
+        /// Misses that waited for a backing-store read already in flight for the same key
+        /// instead of issuing their own (not included in MissCount)
+        /// </summary>
+        public long CoalescedCount { get; set; }
+
+        /// <summary>
+        /// Background reloads started for hot entries close to their TTL
+        /// </summary>
+        public long RefreshAheadCount { get; set; }
+
+        /// <summary>
+        /// Fraction of reads served from the cache (0-1)
+        /// </summary>
+        public double HitRate => HitCount + MissCount == 0 ? 0 : (double)HitCount / (HitCount + MissCount);
+
+        /// <summary>
+        /// New items admitted by out-competing a resident item (W-TinyLFU only)
+        /// </summary>
+        public long AdmittedCount { get; set; }
+
+        /// <summary>
+        /// New items turned away because residents were accessed more often (W-TinyLFU only)
+        /// </summary>
+        public long RejectedCount { get; set; }
     }
 }
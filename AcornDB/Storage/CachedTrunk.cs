@@ -1,9 +1,13 @@
 using System;
 using AcornDB.Logging;
+using System.Collections.Concurrent;
 using System.Collections.Generic;
 using System.Linq;
 using System.Runtime.CompilerServices;
+using System.Threading;
+using System.Threading.Tasks;
 using AcornDB;
+using AcornDB.Cache;
 using AcornDB.Storage;
 
 namespace AcornDB.Storage
@@ -16,6 +20,10 @@ namespace AcornDB.Storage
     /// - Reads: Check cache first, fallback to backing store, populate cache
     /// - Writes: Write to backing store first (write-through), then update cache
     /// - Deletes: Delete from backing store, invalidate cache
+    /// - Concurrent misses on one key share a single backing-store read (single-flight)
+    /// - Hot entries close to their TTL are reloaded in the background (refresh-ahead)
+    /// - TTL counts from when an entry was cached; expired entries are found through a deadline
+    ///   index, so purging them costs O(expired) rather than a scan of the cache
     ///
     /// Use Cases:
     /// - Read-heavy workloads
@@ -27,6 +35,13 @@ namespace AcornDB.Storage
         private readonly ITrunk<T> _backingStore;
         private readonly MemoryTrunk<T> _cache;
         private readonly CacheOptions _options;
+        private readonly WTinyLFUCacheStrategy<T>? _admission;
+        private readonly ConcurrentDictionary<string, long> _cachedAt = new(StringComparer.Ordinal); // UTC ticks
+        private readonly ExpiryIndex _expiry = new();
+        private readonly SingleFlight<Nut<T>?> _loads = new();
+        private long _hits;
+        private long _misses;
+        private long _refreshes;
         private bool _disposed;
 
         /// <summary>
@@ -40,11 +55,17 @@ namespace AcornDB.Storage
             _cache = new MemoryTrunk<T>();
             _options = options ?? CacheOptions.Default;
 
+            if (_options.MaxCacheSize.HasValue && _options.EvictionPolicy == CacheEvictionPolicy.WTinyLFU)
+            {
+                _admission = new WTinyLFUCacheStrategy<T>(_options.MaxCacheSize.Value);
+            }
+
             var backingCaps = _backingStore.Capabilities;
             AcornLog.Info($"💾 CachedTrunk initialized:");
             AcornLog.Info($"   Backing Store: {backingCaps.TrunkType}");
             AcornLog.Info($"   Cache TTL: {(_options.TimeToLive?.TotalSeconds.ToString("F0") + "s" ?? "Infinite")}");
             AcornLog.Info($"   Max Cache Size: {(_options.MaxCacheSize?.ToString() ?? "Unlimited")}");
+            AcornLog.Info($"   Eviction Policy: {_options.EvictionPolicy}");
         }
 
         [MethodImpl(MethodImplOptions.AggressiveInlining)]
@@ -52,12 +73,12 @@ namespace AcornDB.Storage
         {
             // Write-through: backing store first, then cache
             _backingStore.Stash(id, nut);
+            _loads.Forget(id);
 
             // Update cache
             if (ShouldCache(nut))
             {
-                _cache.Stash(id, nut);
-                EvictIfNeeded();
+                Cache(id, nut);
             }
         }
 
@@ -67,34 +88,133 @@ namespace AcornDB.Storage
         [MethodImpl(MethodImplOptions.AggressiveInlining)]
         public Nut<T>? Crack(string id)
         {
-            // Try cache first
-            var nut = _cache.Crack(id);
+            // Try cache first, then load from backing store
+            return CrackCached(id) ?? LoadMiss(id);
+        }
+
+        /// <summary>
+        /// Crack without blocking the caller on a backing-store read
+        /// </summary>
+        public Task<Nut<T>?> CrackAsync(string id)
+        {
+            var nut = CrackCached(id);
+            return nut != null ? Task.FromResult<Nut<T>?>(nut) : LoadMissAsync(id);
+        }
 
-            if (nut != null)
+        /// <summary>
+        /// Crack a batch of ids. Cache misses are read from the backing store in parallel, up to
+        /// CacheOptions.MaxParallelFetches at a time. Ids that don't exist are left out.
+        /// </summary>
+        public IReadOnlyDictionary<string, Nut<T>> CrackMany(IEnumerable<string> ids)
+        {
+            return CrackManyAsync(ids).GetAwaiter().GetResult();
+        }
+
+        /// <summary>
+        /// Async CrackMany
+        /// </summary>
+        public async Task<IReadOnlyDictionary<string, Nut<T>>> CrackManyAsync(
+            IEnumerable<string> ids,
+            CancellationToken cancellationToken = default)
+        {
+            var found = new ConcurrentDictionary<string, Nut<T>>(StringComparer.Ordinal);
+            var misses = new List<string>();
+            foreach (var id in ids.Distinct(StringComparer.Ordinal))
             {
-                // Check TTL
-                if (IsExpired(nut))
-                {
-                    _cache.Toss(id);
-                    nut = null;
-                }
+                var nut = CrackCached(id);
+                if (nut != null)
+                    found[id] = nut;
                 else
+                    misses.Add(id);
+            }
+
+            if (misses.Count > 0)
+            {
+                var options = new ParallelOptions
                 {
-                    return nut; // Cache hit
-                }
+                    MaxDegreeOfParallelism = Math.Max(1, _options.MaxParallelFetches),
+                    CancellationToken = cancellationToken
+                };
+                await Parallel.ForEachAsync(misses, options, async (id, _) =>
+                {
+                    var nut = await LoadMissAsync(id).ConfigureAwait(false);
+                    if (nut != null)
+                        found[id] = nut;
+                }).ConfigureAwait(false);
+            }
+
+            return found;
+        }
+
+        private Nut<T>? CrackCached(string id)
+        {
+            var nut = _cache.Crack(id);
+            if (nut == null)
+                return null;
+
+            // Check TTL
+            var remaining = TimeToLiveLeft(id);
+            if (remaining <= TimeSpan.Zero)
+            {
+                Uncache(id);
+                return null;
             }
 
-            // Cache miss - load from backing store
-            nut = _backingStore.Crack(id);
+            Interlocked.Increment(ref _hits);
+            _admission?.OnCrack(id);
+            RefreshAheadIfDue(id, remaining);
+            return nut; // Cache hit
+        }
+
+        private Nut<T>? LoadMiss(string id)
+        {
+            if (!_options.CoalesceMisses)
+            {
+                var nut = LoadFromBackingStore(id);
+                Populate(id, nut);
+                return nut;
+            }
+
+            return _loads.Run(id, () => LoadFromBackingStore(id), nut => Populate(id, nut));
+        }
+
+        private Task<Nut<T>?> LoadMissAsync(string id)
+        {
+            if (!_options.CoalesceMisses)
+                return Task.Run(() => LoadMiss(id));
 
-            // Populate cache
+            return _loads.RunAsync(id, () => LoadFromBackingStore(id), nut => Populate(id, nut));
+        }
+
+        private Nut<T>? LoadFromBackingStore(string id)
+        {
+            Interlocked.Increment(ref _misses);
+            return _backingStore.Crack(id);
+        }
+
+        private void Populate(string id, Nut<T>? nut)
+        {
             if (nut != null && ShouldCache(nut))
             {
-                _cache.Stash(id, nut);
-                EvictIfNeeded();
+                Cache(id, nut);
             }
+        }
+
+        private void RefreshAheadIfDue(string id, TimeSpan remaining)
+        {
+            if (_disposed || !_options.TimeToLive.HasValue || !_loads.ShouldRefreshEarly(remaining, _options.RefreshAheadBeta))
+                return;
 
-            return nut;
+            var started = _loads.TryRefresh(id, () => _backingStore.Crack(id), nut =>
+            {
+                if (nut != null && ShouldCache(nut))
+                    Cache(id, nut);
+                else
+                    Uncache(id); // Deleted or expired in the backing store meanwhile
+            });
+
+            if (started)
+                Interlocked.Increment(ref _refreshes);
         }
 
         [Obsolete("Use Crack() instead. This method will be removed in a future version.")]
@@ -105,9 +225,10 @@ namespace AcornDB.Storage
         {
             // Delete from backing store
             _backingStore.Toss(id);
+            _loads.Forget(id);
 
             // Invalidate cache
-            _cache.Toss(id);
+            Uncache(id);
         }
 
         [Obsolete("Use Toss() instead. This method will be removed in a future version.")]
@@ -125,7 +246,7 @@ namespace AcornDB.Storage
                 {
                     if (ShouldCache(nut))
                     {
-                        _cache.Stash(nut.Id, nut);
+                        Remember(nut.Id, nut);
                     }
                 }
                 EvictIfNeeded();
@@ -157,6 +278,7 @@ namespace AcornDB.Storage
             // Invalidate cache (simplest strategy)
             if (_options.InvalidateCacheOnImport)
             {
+                _loads.ForgetAll();
                 ClearCache();
             }
         }
@@ -169,26 +291,83 @@ namespace AcornDB.Storage
             var allIds = _cache.CrackAll().Select(n => n.Id).ToList();
             foreach (var id in allIds)
             {
-                _cache.Toss(id);
+                // Frequencies survive a clear so the first reads afterwards still favour the hot set
+                Uncache(id);
             }
         }
 
+        /// <summary>
+        /// Drop every cached entry whose TTL has run out (they are also dropped when read)
+        /// </summary>
+        /// <returns>Number of entries dropped</returns>
+        public int PurgeExpired()
+        {
+            int dropped = 0;
+            foreach (var (id, _) in _expiry.TakeDue(DateTime.UtcNow))
+            {
+                // Re-cached since the deadline was taken: keep it
+                if (TimeToLiveLeft(id) > TimeSpan.Zero)
+                    continue;
+
+                Uncache(id);
+                dropped++;
+            }
+            return dropped;
+        }
+
         /// <summary>
         /// Get cache statistics
         /// </summary>
         public CacheStats GetCacheStats()
         {
-            var cached = _cache.CrackAll().ToList();
-            var expired = cached.Count(IsExpired);
+            var cachedCount = _cache.Count;
+            var expired = Math.Min(_expiry.Due(DateTime.UtcNow).Count, cachedCount);
+            var admission = _admission?.GetStats();
 
             return new CacheStats
             {
-                CachedItemCount = cached.Count,
+                CachedItemCount = cachedCount,
                 ExpiredItemCount = expired,
-                ActiveItemCount = cached.Count - expired
+                ActiveItemCount = cachedCount - expired,
+                HitCount = Interlocked.Read(ref _hits),
+                MissCount = Interlocked.Read(ref _misses),
+                AdmittedCount = admission?.AdmittedCount ?? 0,
+                RejectedCount = admission?.RejectedCount ?? 0,
+                CoalescedCount = _loads.CoalescedCount,
+                RefreshAheadCount = Interlocked.Read(ref _refreshes)
             };
         }
 
+        private void Cache(string id, Nut<T> nut)
+        {
+            Remember(id, nut);
+            EvictIfNeeded();
+        }
+
+        private void Remember(string id, Nut<T> nut)
+        {
+            var now = DateTime.UtcNow;
+            _cache.Stash(id, nut);
+            _cachedAt[id] = now.Ticks;
+            if (_options.TimeToLive.HasValue)
+                _expiry.Set(id, now + _options.TimeToLive.Value);
+            _admission?.OnStash(id, nut);
+        }
+
+        private void Uncache(string id)
+        {
+            Drop(id);
+            _admission?.OnToss(id);
+        }
+
+        // Eviction already updated the admission strategy
+        private void Drop(string id)
+        {
+            _cache.Toss(id);
+            _cachedAt.TryRemove(id, out _);
+            _expiry.Remove(id);
+        }
+
         private bool ShouldCache(Nut<T> nut)
         {
             // Check if nut has its own expiration that conflicts with cache
@@ -200,13 +379,13 @@ namespace AcornDB.Storage
             return true;
         }
 
-        private bool IsExpired(Nut<T> nut)
+        private TimeSpan TimeToLiveLeft(string id)
         {
-            if (!_options.TimeToLive.HasValue)
-                return false; // No TTL
+            if (!_options.TimeToLive.HasValue || !_cachedAt.TryGetValue(id, out var cachedAt))
+                return TimeSpan.MaxValue; // No TTL
 
-            var age = DateTime.UtcNow - nut.Timestamp;
-            return age > _options.TimeToLive.Value;
+            var age = TimeSpan.FromTicks(DateTime.UtcNow.Ticks - cachedAt);
+            return _options.TimeToLive.Value - age;
         }
 
         private void EvictIfNeeded()
@@ -214,20 +393,25 @@ namespace AcornDB.Storage
             if (!_options.MaxCacheSize.HasValue)
                 return;
 
-            var cached = _cache.CrackAll().ToList();
+            // Expired entries go first, found without scanning the cache
+            PurgeExpired();
 
-            // Remove expired first
-            var expired = cached.Where(IsExpired).ToList();
-            foreach (var nut in expired)
+            if (_admission != null)
             {
-                _cache.Toss(nut.Id);
+                // The strategy tracks residency itself, so there is no need to load and sort the
+                // whole cache
+                foreach (var id in _admission.SelectVictims(_cache.Count, _cache.Contains))
+                {
+                    Drop(id);
+                }
+                return;
             }
 
-            // Check size again
-            cached = _cache.CrackAll().ToList();
-            if (cached.Count <= _options.MaxCacheSize.Value)
+            if (_cache.Count <= _options.MaxCacheSize.Value)
                 return;
 
+            var cached = _cache.CrackAll().ToList();
+
             // Evict oldest items (LRU approximation using timestamp)
             var toEvict = cached
                 .OrderBy(n => n.Timestamp)
@@ -235,7 +419,7 @@ namespace AcornDB.Storage
 
             foreach (var nut in toEvict)
             {
-                _cache.Toss(nut.Id);
+                Drop(nut.Id);
             }
         }
 
@@ -0,0 +1,24 @@
+using System;
+
+namespace AcornDB.Storage
+{
+    /// <summary>
+    /// Dead space and compaction statistics for a log-structured trunk
+    /// </summary>
+    public class CompactionStats
+    {
+        public bool IsCompacting { get; set; }
+        public double Progress { get; set; }
+        public long FileBytes { get; set; }
+        public long LiveBytes { get; set; }
+        public long DeadBytes { get; set; }
+        public double DeadSpaceRatio { get; set; }
+        public long CompactionCount { get; set; }
+        public long LastBytesReclaimed { get; set; }
+        public long TotalBytesReclaimed { get; set; }
+        public double LastPauseMs { get; set; }
+        public double MaxPauseMs { get; set; }
+        public double LastCompactionMs { get; set; }
+        public DateTime? LastCompactedAt { get; set; }
+    }
+}
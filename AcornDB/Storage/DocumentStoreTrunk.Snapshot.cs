@@ -0,0 +1,318 @@
+using System;
+using System.Buffers.Binary;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Threading;
+using AcornDB.Logging;
+
+namespace AcornDB.Storage
+{
+    /// <summary>
+    /// Snapshots and history retention for DocumentStoreTrunk&lt;T&gt;.
+    /// A snapshot (snapshot.bin) holds one record per live document plus the retained earlier
+    /// versions, copied from wherever their records were. The snapshot and the log each carry a
+    /// generation: writing a snapshot bumps it and starts an empty log of the new generation, so
+    /// a log left over from a crash between the two steps is recognised as already folded in.
+    /// Writers wait while a snapshot is written; its cost is proportional to the live data and
+    /// retained history, not to how many writes the log had accumulated.
+    /// </summary>
+    public partial class DocumentStoreTrunk<T>
+    {
+        private const long DEFAULT_SNAPSHOT_INTERVAL = 64L * 1024 * 1024; // 64MB of log
+
+        // Snapshot file: [Magic:4][FormatVersion:4][Generation:8][RecordCount:8], then records
+        private const int SNAPSHOT_MAGIC = 0x53534441; // 'ADSS'
+        private const int SNAPSHOT_HEADER_SIZE = 24;
+
+        private readonly string _snapshotPath;
+        private readonly ReaderWriterLockSlim _fileLock = new(); // History reads vs snapshot file swaps
+        private long _generation;
+        private int _maxHistoryVersions;
+
+        /// <summary>
+        /// Bytes of log to accumulate before a snapshot is written and the log truncated.
+        /// 0 disables automatic snapshots (<see cref="Snapshot"/> can still be called).
+        /// Default: 64MB
+        /// </summary>
+        public long SnapshotIntervalBytes { get; set; } = DEFAULT_SNAPSHOT_INTERVAL;
+
+        /// <summary>
+        /// Earlier versions to keep per document; older ones are dropped. 0 keeps every version.
+        /// Default: 0
+        /// </summary>
+        public int MaxHistoryVersions
+        {
+            get => _maxHistoryVersions;
+            set
+            {
+                if (value < 0)
+                    throw new ArgumentException("MaxHistoryVersions cannot be negative", nameof(value));
+                _maxHistoryVersions = value;
+            }
+        }
+
+        /// <summary>
+        /// Earlier versions written longer ago than this are dropped. Null keeps them regardless of age.
+        /// Default: null
+        /// </summary>
+        public TimeSpan? MaxHistoryAge { get; set; }
+
+        /// <summary>
+        /// Generation of the most recent snapshot written or loaded (0 = none)
+        /// </summary>
+        public long SnapshotGeneration
+        {
+            get
+            {
+                EnsureLoaded();
+                return Interlocked.Read(ref _generation);
+            }
+        }
+
+        /// <summary>
+        /// Earlier versions currently retained across all documents
+        /// </summary>
+        public long RetainedHistoryVersions
+        {
+            get
+            {
+                EnsureLoaded();
+                long count = 0;
+                foreach (var versions in _history.Values)
+                {
+                    lock (versions)
+                    {
+                        count += versions.Count;
+                    }
+                }
+                return count;
+            }
+        }
+
+        /// <summary>
+        /// Write a snapshot of the live documents and retained history, then truncate the log.
+        /// Pending writes are flushed first.
+        /// </summary>
+        public void Snapshot()
+        {
+            EnsureLoaded();
+
+            // Lock order: file swap, then flush, then append - the same as every other path
+            _fileLock.EnterWriteLock();
+            try
+            {
+                lock (_flushLock)
+                {
+                    lock (_appendLock)
+                    {
+                        Flush();
+                        WriteSnapshot();
+                    }
+                }
+            }
+            finally
+            {
+                _fileLock.ExitWriteLock();
+            }
+        }
+
+        private void SnapshotIfDue()
+        {
+            if (!_logLoaded || SnapshotIntervalBytes <= 0
+                || Interlocked.Read(ref _logPosition) - LOG_HEADER_SIZE < SnapshotIntervalBytes)
+                return;
+
+            try
+            {
+                Snapshot();
+            }
+            catch (Exception ex)
+            {
+                // The log is still authoritative; the next open just replays more of it
+                AcornLog.Error($"⚠️ Failed to write DocumentStoreTrunk snapshot: {ex.Message}");
+            }
+        }
+
+        /// <summary>
+        /// Copy every retained record into a new snapshot, swap it in and reset the log.
+        /// Caller holds the file, flush and append locks.
+        /// </summary>
+        private void WriteSnapshot()
+        {
+            var now = DateTime.UtcNow;
+            var generation = _generation + 1;
+            var tempPath = _snapshotPath + ".tmp";
+            var current = new Dictionary<string, RecordLocation>();
+            var history = new Dictionary<string, List<RecordLocation>>();
+
+            try
+            {
+                using (var log = OpenForRead(_logPath))
+                using (var previous = File.Exists(_snapshotPath) ? OpenForRead(_snapshotPath) : null)
+                using (var output = new FileStream(tempPath, FileMode.Create, FileAccess.ReadWrite, FileShare.None, 64 * 1024))
+                {
+                    Span<byte> header = stackalloc byte[SNAPSHOT_HEADER_SIZE];
+                    output.Write(header);
+
+                    long records = 0;
+                    foreach (var id in _history.Keys.Union(_locations.Keys).ToList())
+                    {
+                        if (_history.TryGetValue(id, out var versions))
+                        {
+                            RecordLocation[] kept;
+                            lock (versions)
+                            {
+                                TrimHistory(versions, now);
+                                kept = versions.ToArray();
+                            }
+
+                            if (kept.Length > 0)
+                            {
+                                var moved = new List<RecordLocation>(kept.Length);
+                                foreach (var location in kept)
+                                {
+                                    moved.Add(CopyRecord(location.InSnapshot ? previous! : log, location, ACTION_HISTORY, output));
+                                    records++;
+                                }
+                                history[id] = moved;
+                            }
+                        }
+
+                        if (_locations.TryGetValue(id, out var live))
+                        {
+                            current[id] = CopyRecord(live.InSnapshot ? previous! : log, live, ACTION_STASH, output);
+                            records++;
+                        }
+                    }
+
+                    BinaryPrimitives.WriteInt32LittleEndian(header, SNAPSHOT_MAGIC);
+                    BinaryPrimitives.WriteInt32LittleEndian(header.Slice(4), FORMAT_VERSION);
+                    BinaryPrimitives.WriteInt64LittleEndian(header.Slice(8), generation);
+                    BinaryPrimitives.WriteInt64LittleEndian(header.Slice(16), records);
+                    output.Position = 0;
+                    output.Write(header);
+                    output.Flush(flushToDisk: true);
+                }
+
+                // Atomic replace: a crash mid-write leaves the previous snapshot and log intact
+                File.Move(tempPath, _snapshotPath, overwrite: true);
+            }
+            catch
+            {
+                try { File.Delete(tempPath); } catch { }
+                throw;
+            }
+
+            // Everything logged so far is in the snapshot; the next generation starts empty
+            StartLog(generation);
+
+            foreach (var kvp in current)
+            {
+                _locations[kvp.Key] = kvp.Value;
+            }
+            foreach (var kvp in _history)
+            {
+                lock (kvp.Value)
+                {
+                    kvp.Value.Clear();
+                    if (history.TryGetValue(kvp.Key, out var moved))
+                        kvp.Value.AddRange(moved);
+                }
+                if (kvp.Value.Count == 0)
+                    _history.TryRemove(kvp);
+            }
+        }
+
+        /// <summary>
+        /// Copy a verified record to the snapshot being written, as the given action
+        /// </summary>
+        private static RecordLocation CopyRecord(FileStream source, RecordLocation location, byte action, FileStream output)
+        {
+            source.Position = location.Offset;
+            if (!TryReadRecord(source, location.Offset + location.Length, out var record))
+                throw new InvalidDataException($"DocumentStoreTrunk record at offset {location.Offset} is damaged");
+
+            var bytes = record.Bytes;
+            if (bytes[RECORD_HEADER_SIZE] != action)
+            {
+                bytes[RECORD_HEADER_SIZE] = action;
+                SealRecord(bytes);
+            }
+
+            var copied = new RecordLocation(true, output.Position, bytes.Length, location.TimestampTicks);
+            output.Write(bytes, 0, bytes.Length);
+            return copied;
+        }
+
+        /// <summary>
+        /// Load the snapshot, if there is one. Returns its generation (0 without a snapshot).
+        /// </summary>
+        private long LoadSnapshot()
+        {
+            if (!File.Exists(_snapshotPath))
+                return 0;
+
+            using var stream = OpenForRead(_snapshotPath);
+            Span<byte> header = stackalloc byte[SNAPSHOT_HEADER_SIZE];
+            if (stream.Length < SNAPSHOT_HEADER_SIZE)
+                throw new InvalidDataException($"{_snapshotPath} is truncated");
+
+            stream.ReadExactly(header);
+            if (BinaryPrimitives.ReadInt32LittleEndian(header) != SNAPSHOT_MAGIC
+                || BinaryPrimitives.ReadInt32LittleEndian(header.Slice(4)) != FORMAT_VERSION)
+                throw new InvalidDataException($"{_snapshotPath} is not a DocumentStoreTrunk snapshot");
+
+            var generation = BinaryPrimitives.ReadInt64LittleEndian(header.Slice(8));
+            var records = BinaryPrimitives.ReadInt64LittleEndian(header.Slice(16));
+            var end = stream.Length;
+
+            // The log was truncated when this snapshot was written, so it cannot be skipped
+            for (long i = 0; i < records; i++)
+            {
+                var position = stream.Position;
+                if (!TryReadRecord(stream, end, out var record))
+                    throw new InvalidDataException($"{_snapshotPath} is damaged at offset {position}");
+
+                ApplyRecord(record, new RecordLocation(true, position, record.Bytes.Length, record.Timestamp.Ticks));
+            }
+
+            return generation;
+        }
+
+        /// <summary>
+        /// Record an earlier version of a document and apply the retention limits
+        /// </summary>
+        private void AddHistory(string id, RecordLocation location)
+        {
+            var versions = _history.GetOrAdd(id, _ => new List<RecordLocation>());
+            lock (versions)
+            {
+                versions.Add(location);
+                TrimHistory(versions, DateTime.UtcNow);
+            }
+        }
+
+        /// <summary>
+        /// Drop the versions beyond MaxHistoryVersions or older than MaxHistoryAge (oldest
+        /// first). Caller holds the list's lock.
+        /// </summary>
+        private void TrimHistory(List<RecordLocation> versions, DateTime now)
+        {
+            var drop = 0;
+            var max = _maxHistoryVersions;
+            if (max > 0 && versions.Count > max)
+                drop = versions.Count - max;
+
+            if (MaxHistoryAge is TimeSpan maxAge)
+            {
+                var cutoff = now.Ticks - maxAge.Ticks;
+                while (drop < versions.Count && versions[drop].TimestampTicks < cutoff)
+                    drop++;
+            }
+
+            if (drop > 0)
+                versions.RemoveRange(0, drop);
+        }
+    }
+}
@@ -1,4 +1,4 @@
-using System.Buffers;
+using System.Buffers.Binary;
 using AcornDB.Logging;
 using System.Collections.Concurrent;
 using System.Runtime.CompilerServices;
@@ -15,23 +15,51 @@ namespace AcornDB.Storage
     /// Supports extensible IRoot processors for compression, encryption, policy enforcement, etc.
     ///
     /// Storage Pipeline:
-    /// Write: Nut<T> → Store in memory → Serialize log entry → Root Chain (ascending) → byte[] → Write to log
+    /// Write: Nut&lt;T&gt; → Store in memory → Binary log record → Write to log
     /// Read: In-memory retrieval (roots not involved, only for log replay on startup)
+    ///
+    /// On disk the trunk keeps an append-only log (changes.bin) of checksummed binary records
+    /// and, once the log grows past <see cref="SnapshotIntervalBytes"/>, a snapshot
+    /// (snapshot.bin) of the live documents and retained history that replaces it. Opening the
+    /// trunk loads the snapshot and replays only the log written since. Only current documents
+    /// are held in memory; earlier versions are kept as positions of their records and read
+    /// back from disk when <see cref="GetHistory"/> asks for them.
     /// </summary>
-    public class DocumentStoreTrunk<T> : TrunkBase<T>, IDisposable where T : class
+    public partial class DocumentStoreTrunk<T> : TrunkBase<T>, IDisposable where T : class
     {
         private readonly string _folderPath;
         private readonly string _logPath;
+        private readonly string _legacyLogPath;
         private readonly ConcurrentDictionary<string, Nut<T>> _current = new();
-        private readonly ConcurrentDictionary<string, List<Nut<T>>> _history = new();
+        private readonly ConcurrentDictionary<string, RecordLocation> _locations = new();
+        private readonly ConcurrentDictionary<string, List<RecordLocation>> _history = new();
         private readonly List<byte[]> _logBuffer = new();
-        private readonly SemaphoreSlim _writeLock = new(1, 1);
+        private readonly object _appendLock = new(); // Log positions are handed out in the order state changes
+        private readonly object _flushLock = new();  // Batches reach the file in the order they were queued
         private readonly Timer _flushTimer;
         private FileStream? _logStream;
-        private bool _logLoaded = false;
+        private long _logPosition;     // End of the log, including buffered records
+        private long _flushedPosition; // End of the log as written to the file
+        private volatile bool _logLoaded = false;
+        private int _recordsReplayed;
 
         private const int BUFFER_THRESHOLD = 100; // Flush after 100 log entries
         private const int FLUSH_INTERVAL_MS = 200; // Flush every 200ms
+        private const int INITIAL_PAYLOAD_CAPACITY = 1024;
+
+        // Log file: [Magic:4][FormatVersion:4][Generation:8], then records
+        private const int LOG_MAGIC = 0x4C534441; // 'ADSL'
+        private const int FORMAT_VERSION = 1;
+        private const int LOG_HEADER_SIZE = 16;
+
+        // Record: [Magic:4][BodyLength:4][Checksum:8] [Action:1][Timestamp:8][IdLength:4][Id][Payload]
+        private const int RECORD_MAGIC = 0x52534441; // 'ADSR'
+        private const int RECORD_HEADER_SIZE = 16;
+        private const int BODY_FIXED_SIZE = 13;
+
+        private const byte ACTION_STASH = 1;
+        private const byte ACTION_TOSS = 2;
+        private const byte ACTION_HISTORY = 3; // Snapshot only: a retained earlier version
 
         public override ITrunkCapabilities Capabilities { get; } = new TrunkCapabilities
         {
@@ -42,25 +70,52 @@ namespace AcornDB.Storage
             TrunkType = "DocumentStoreTrunk"
         };
 
+        /// <summary>
+        /// Number of log records replayed when the trunk was loaded (the writes since the snapshot)
+        /// </summary>
+        public int RecordsReplayedOnLoad
+        {
+            get
+            {
+                EnsureLoaded();
+                return _recordsReplayed;
+            }
+        }
+
+        /// <summary>
+        /// Current size of the replay log in bytes, including records not yet flushed
+        /// </summary>
+        public long LogSizeBytes
+        {
+            get
+            {
+                EnsureLoaded();
+                return Interlocked.Read(ref _logPosition);
+            }
+        }
+
         public DocumentStoreTrunk(string? customPath = null, ISerializer? serializer = null)
             : base(serializer)
         {
             var typeName = typeof(T).Name;
             _folderPath = customPath ?? Path.Combine(Directory.GetCurrentDirectory(), "data", "docstore", typeName);
-            _logPath = Path.Combine(_folderPath, "changes.log");
+            _logPath = Path.Combine(_folderPath, "changes.bin");
+            _legacyLogPath = Path.Combine(_folderPath, "changes.log");
+            _snapshotPath = Path.Combine(_folderPath, "snapshot.bin");
             Directory.CreateDirectory(_folderPath);
 
             // Note: Do NOT load log in constructor if roots might be needed
-            // LoadFromLog will be called automatically on first access or explicitly after adding roots
-
-            // Open log file for appending with buffering
-            _logStream = new FileStream(_logPath, FileMode.Append, FileAccess.Write, FileShare.Read,
-                8192, FileOptions.Asynchronous);
+            // The log is loaded automatically on first access
 
             // Auto-flush timer for write batching
             _flushTimer = new Timer(_ =>
             {
-                try { FlushAsync().Wait(); }
+                if (_disposed) return;
+                try
+                {
+                    Flush();
+                    SnapshotIfDue();
+                }
                 catch { /* Swallow timer exceptions */ }
             }, null, FLUSH_INTERVAL_MS, FLUSH_INTERVAL_MS);
         }
@@ -68,48 +123,14 @@ namespace AcornDB.Storage
         [MethodImpl(MethodImplOptions.AggressiveInlining)]
         public override void Stash(string id, Nut<T> shell)
         {
-            // Store previous version in history
-            if (_current.TryGetValue(id, out var previous))
-            {
-                // GetOrAdd for lock-free operation
-                var historyList = _history.GetOrAdd(id, _ => new List<Nut<T>>());
-                lock (historyList) // Lock only the specific list, not the entire dictionary
-                {
-                    historyList.Add(previous);
-                }
-            }
-
-            // Update current state (lock-free with ConcurrentDictionary)
-            _current[id] = shell;
-
-            // Create log entry
-            var logEntry = new ChangeLogEntry<T>
-            {
-                Action = "Stash",
-                Id = id,
-                Shell = shell,
-                Timestamp = DateTime.UtcNow
-            };
-
-            // Add to buffer (batched writes)
-            QueueLogEntry(logEntry);
+            EnsureLoaded();
+            StashInternal(id, shell, DateTime.UtcNow);
         }
 
         [MethodImpl(MethodImplOptions.AggressiveInlining)]
         public override Nut<T>? Crack(string id)
         {
-            // Ensure log is loaded (only matters if no roots were added)
-            if (!_logLoaded)
-            {
-                lock (_rootsLock)
-                {
-                    if (!_logLoaded)
-                    {
-                        LoadFromLog();
-                        _logLoaded = true;
-                    }
-                }
-            }
+            EnsureLoaded();
 
             // Lock-free read from ConcurrentDictionary
             return _current.TryGetValue(id, out var shell) ? shell : null;
@@ -118,55 +139,60 @@ namespace AcornDB.Storage
         [MethodImpl(MethodImplOptions.AggressiveInlining)]
         public override void Toss(string id)
         {
-            if (_current.TryRemove(id, out var shell))
-            {
-                // Store in history before deleting
-                var historyList = _history.GetOrAdd(id, _ => new List<Nut<T>>());
-                lock (historyList)
-                {
-                    historyList.Add(shell);
-                }
-
-                // Log deletion
-                var logEntry = new ChangeLogEntry<T>
-                {
-                    Action = "Toss",
-                    Id = id,
-                    Shell = null,
-                    Timestamp = DateTime.UtcNow
-                };
-                QueueLogEntry(logEntry);
-            }
+            EnsureLoaded();
+            TossInternal(id, DateTime.UtcNow);
         }
 
         public override IEnumerable<Nut<T>> CrackAll()
         {
-            // Ensure log is loaded (only matters if no roots were added)
-            if (!_logLoaded)
-            {
-                lock (_rootsLock)
-                {
-                    if (!_logLoaded)
-                    {
-                        LoadFromLog();
-                        _logLoaded = true;
-                    }
-                }
-            }
+            EnsureLoaded();
 
             // Return values directly - ConcurrentDictionary.Values is thread-safe
             return _current.Values;
         }
 
+        /// <summary>
+        /// Earlier versions of a document, oldest first, read from the log or snapshot.
+        /// Only versions within <see cref="MaxHistoryVersions"/> and <see cref="MaxHistoryAge"/>
+        /// are returned.
+        /// </summary>
         public override IReadOnlyList<Nut<T>> GetHistory(string id)
         {
-            return _history.TryGetValue(id, out var versions)
-                ? versions.AsReadOnly()
-                : new List<Nut<T>>().AsReadOnly();
+            EnsureLoaded();
+            if (!_history.TryGetValue(id, out var versions))
+                return Array.Empty<Nut<T>>();
+
+            while (true)
+            {
+                // Versions may still be waiting in the write buffer
+                Flush();
+
+                _fileLock.EnterReadLock();
+                try
+                {
+                    RecordLocation[] locations;
+                    lock (versions)
+                    {
+                        TrimHistory(versions, DateTime.UtcNow);
+                        locations = versions.ToArray();
+                    }
+
+                    var flushed = Interlocked.Read(ref _flushedPosition);
+                    if (locations.Any(l => !l.InSnapshot && l.Offset + l.Length > flushed))
+                        continue; // Written after the flush above; flush again
+
+                    return ReadVersions(id, locations);
+                }
+                finally
+                {
+                    _fileLock.ExitReadLock();
+                }
+            }
         }
 
         public override IEnumerable<Nut<T>> ExportChanges()
         {
+            EnsureLoaded();
             return _current.Values.ToList();
         }
 
@@ -178,106 +204,416 @@ namespace AcornDB.Storage
             }
         }
 
-        [MethodImpl(MethodImplOptions.AggressiveInlining)]
-        private void QueueLogEntry(ChangeLogEntry<T> entry)
+        private void StashInternal(string id, Nut<T> shell, DateTime timestamp)
         {
-            // Serialize log entry to JSON (compact format for newline-delimited log)
-            // Note: We do NOT apply roots to the log entries themselves - the log is an internal format
-            // Roots are only applied by individual trunk implementations (BTreeTrunk, FileTrunk) for their storage
-            var json = JsonConvert.SerializeObject(entry, Formatting.None);
-            var jsonByteCount = Encoding.UTF8.GetByteCount(json);
-
-            // Rent array from pool for better performance
-            var buffer = ArrayPool<byte>.Shared.Rent(jsonByteCount + 1);
-            byte[] bytes;
-            try
+            var record = EncodeRecord(ACTION_STASH, id, shell, timestamp);
+
+            bool flush;
+            lock (_appendLock)
             {
-                Encoding.UTF8.GetBytes(json, 0, json.Length, buffer, 0);
-                buffer[jsonByteCount] = (byte)'\n';
+                var location = Append(record, timestamp);
+
+                // The version being replaced becomes history
+                if (_locations.TryGetValue(id, out var previous))
+                    AddHistory(id, previous);
 
-                // Copy to exact-sized array (will be stored in buffer)
-                bytes = new byte[jsonByteCount + 1];
-                Array.Copy(buffer, bytes, jsonByteCount + 1);
+                _current[id] = shell;
+                _locations[id] = location;
+                flush = _logBuffer.Count >= BUFFER_THRESHOLD;
             }
-            finally
+
+            if (flush)
             {
-                ArrayPool<byte>.Shared.Return(buffer);
+                Flush();
+                SnapshotIfDue();
             }
+        }
 
-            // Add to buffer
-            lock (_logBuffer)
+        private void TossInternal(string id, DateTime timestamp)
+        {
+            if (!_current.ContainsKey(id))
+                return;
+
+            var record = EncodeRecord(ACTION_TOSS, id, null, timestamp);
+
+            bool flush;
+            lock (_appendLock)
             {
-                _logBuffer.Add(bytes);
+                if (!_current.TryRemove(id, out _))
+                    return;
+
+                Append(record, timestamp);
+
+                // Store in history before deleting
+                if (_locations.TryRemove(id, out var removed))
+                    AddHistory(id, removed);
+
+                flush = _logBuffer.Count >= BUFFER_THRESHOLD;
+            }
+
+            if (flush)
+            {
+                Flush();
+                SnapshotIfDue();
+            }
+        }
 
-                // Flush if buffer is full
-                if (_logBuffer.Count >= BUFFER_THRESHOLD)
+        /// <summary>
+        /// Queue a record for the log and return where it will be. Caller holds _appendLock.
+        /// </summary>
+        private RecordLocation Append(byte[] record, DateTime timestamp)
+        {
+            var location = new RecordLocation(false, _logPosition, record.Length, timestamp.Ticks);
+            Interlocked.Add(ref _logPosition, record.Length);
+            _logBuffer.Add(record);
+            return location;
+        }
+
+        private void Flush()
+        {
+            lock (_flushLock)
+            {
+                byte[][] batch;
+                lock (_appendLock)
                 {
-                    FlushAsync().Wait();
+                    if (_logBuffer.Count == 0) return;
+                    batch = _logBuffer.ToArray();
+                    _logBuffer.Clear();
                 }
+
+                foreach (var bytes in batch)
+                {
+                    _logStream!.Write(bytes, 0, bytes.Length);
+                }
+
+                _logStream!.Flush();
+                Interlocked.Exchange(ref _flushedPosition, _logStream.Position);
             }
         }
 
-        private byte[] AppendNewline(byte[] data)
+        #region Records
+
+        /// <summary>
+        /// Encode a log record. Tombstones (Toss) carry no payload. Log records are NOT processed
+        /// through roots - the log is an internal format.
+        /// </summary>
+        private byte[] EncodeRecord(byte action, string id, Nut<T>? shell, DateTime timestamp)
         {
-            // Optimize: Use ArrayPool to avoid allocations and use Span for better performance
-            var result = ArrayPool<byte>.Shared.Rent(data.Length + 1);
+            PooledBufferWriter? payload = null;
             try
             {
-                data.AsSpan().CopyTo(result);
-                result[data.Length] = (byte)'\n';
+                if (shell != null)
+                {
+                    payload = new PooledBufferWriter(INITIAL_PAYLOAD_CAPACITY);
+                    _serializer.Serialize(shell, payload);
+                }
+
+                var payloadLength = payload?.WrittenCount ?? 0;
+                var idLength = Encoding.UTF8.GetByteCount(id);
+                var record = new byte[RECORD_HEADER_SIZE + BODY_FIXED_SIZE + idLength + payloadLength];
 
-                // Return only the exact size needed
-                var final = new byte[data.Length + 1];
-                Array.Copy(result, final, data.Length + 1);
-                return final;
+                var body = record.AsSpan(RECORD_HEADER_SIZE);
+                body[0] = action;
+                BinaryPrimitives.WriteInt64LittleEndian(body.Slice(1), timestamp.ToBinary());
+                BinaryPrimitives.WriteInt32LittleEndian(body.Slice(9), idLength);
+                Encoding.UTF8.GetBytes(id, body.Slice(BODY_FIXED_SIZE));
+                payload?.WrittenSpan.CopyTo(body.Slice(BODY_FIXED_SIZE + idLength));
+
+                SealRecord(record);
+                return record;
             }
             finally
             {
-                ArrayPool<byte>.Shared.Return(result);
+                payload?.Dispose();
             }
         }
 
-        private async Task FlushAsync()
+        /// <summary>
+        /// Write the record header (magic, body length, checksum of the body)
+        /// </summary>
+        private static void SealRecord(Span<byte> record)
+        {
+            BinaryPrimitives.WriteInt32LittleEndian(record, RECORD_MAGIC);
+            BinaryPrimitives.WriteInt32LittleEndian(record.Slice(4), record.Length - RECORD_HEADER_SIZE);
+            BinaryPrimitives.WriteUInt64LittleEndian(record.Slice(8), Fnv(record.Slice(RECORD_HEADER_SIZE)));
+        }
+
+        /// <summary>
+        /// Read and verify the record at the stream's position, leaving the stream after it.
+        /// Returns false at the end of the data or at a torn or corrupt record.
+        /// </summary>
+        private static bool TryReadRecord(Stream stream, long end, out DecodedRecord record)
+        {
+            record = default;
+            var start = stream.Position;
+            if (end - start < RECORD_HEADER_SIZE)
+                return false;
+
+            Span<byte> header = stackalloc byte[RECORD_HEADER_SIZE];
+            stream.ReadExactly(header);
+            var bodyLength = BinaryPrimitives.ReadInt32LittleEndian(header.Slice(4));
+            if (BinaryPrimitives.ReadInt32LittleEndian(header) != RECORD_MAGIC
+                || bodyLength < BODY_FIXED_SIZE
+                || bodyLength > end - start - RECORD_HEADER_SIZE)
+                return false;
+
+            var bytes = new byte[RECORD_HEADER_SIZE + bodyLength];
+            header.CopyTo(bytes);
+            stream.ReadExactly(bytes, RECORD_HEADER_SIZE, bodyLength);
+
+            var body = bytes.AsSpan(RECORD_HEADER_SIZE);
+            var idLength = BinaryPrimitives.ReadInt32LittleEndian(body.Slice(9));
+            if (Fnv(body) != BinaryPrimitives.ReadUInt64LittleEndian(header.Slice(8))
+                || idLength < 0 || idLength > bodyLength - BODY_FIXED_SIZE)
+                return false;
+
+            record = new DecodedRecord(bytes, idLength);
+            return true;
+        }
+
+        private Nut<T> ReadPayload(in DecodedRecord record)
+        {
+            return _serializer.Deserialize<Nut<T>>(record.Payload);
+        }
+
+        private IReadOnlyList<Nut<T>> ReadVersions(string id, RecordLocation[] locations)
         {
-            List<byte[]> toWrite;
+            var versions = new List<Nut<T>>(locations.Length);
+            FileStream? log = null;
+            FileStream? snapshot = null;
+            try
+            {
+                foreach (var location in locations)
+                {
+                    var stream = location.InSnapshot
+                        ? snapshot ??= OpenForRead(_snapshotPath)
+                        : log ??= OpenForRead(_logPath);
+
+                    stream.Position = location.Offset;
+                    if (!TryReadRecord(stream, location.Offset + location.Length, out var record) || record.Id != id)
+                        throw new InvalidDataException($"DocumentStoreTrunk history record for '{id}' at offset {location.Offset} is damaged");
 
-            lock (_logBuffer)
+                    versions.Add(ReadPayload(record));
+                }
+            }
+            finally
             {
-                if (_logBuffer.Count == 0) return;
-                toWrite = new List<byte[]>(_logBuffer);
-                _logBuffer.Clear();
+                log?.Dispose();
+                snapshot?.Dispose();
             }
+            return versions.AsReadOnly();
+        }
 
-            await _writeLock.WaitAsync();
-            try
+        private static FileStream OpenForRead(string path) =>
+            new FileStream(path, FileMode.Open, FileAccess.Read, FileShare.ReadWrite, 64 * 1024);
+
+        /// <summary>
+        /// A verified record. Payload is empty for tombstones.
+        /// </summary>
+        private readonly struct DecodedRecord
+        {
+            private readonly byte[] _bytes;
+            private readonly int _idLength;
+
+            public DecodedRecord(byte[] bytes, int idLength)
+            {
+                _bytes = bytes;
+                _idLength = idLength;
+                Id = Encoding.UTF8.GetString(bytes, RECORD_HEADER_SIZE + BODY_FIXED_SIZE, idLength);
+            }
+
+            public byte[] Bytes => _bytes;
+            public byte Action => _bytes[RECORD_HEADER_SIZE];
+            public DateTime Timestamp => DateTime.FromBinary(BinaryPrimitives.ReadInt64LittleEndian(_bytes.AsSpan(RECORD_HEADER_SIZE + 1)));
+            public string Id { get; }
+            public ReadOnlySpan<byte> Payload => _bytes.AsSpan(RECORD_HEADER_SIZE + BODY_FIXED_SIZE + _idLength);
+        }
+
+        /// <summary>
+        /// Where a version's record is: in the snapshot or the log, at which offset
+        /// </summary>
+        private readonly struct RecordLocation
+        {
+            public RecordLocation(bool inSnapshot, long offset, int length, long timestampTicks)
+            {
+                InSnapshot = inSnapshot;
+                Offset = offset;
+                Length = length;
+                TimestampTicks = timestampTicks;
+            }
+
+            public bool InSnapshot { get; }
+            public long Offset { get; }
+            public int Length { get; }
+            public long TimestampTicks { get; }
+        }
+
+        private const ulong FnvOffsetBasis = 14695981039346656037UL;
+        private const ulong FnvPrime = 1099511628211UL;
+
+        private static ulong Fnv(ReadOnlySpan<byte> bytes)
+        {
+            var hash = FnvOffsetBasis;
+            foreach (var b in bytes)
+            {
+                hash ^= b;
+                hash *= FnvPrime;
+            }
+            return hash;
+        }
+
+        #endregion
+
+        #region Loading
+
+        private void EnsureLoaded()
+        {
+            if (_logLoaded) return;
+
+            lock (_rootsLock)
             {
-                // Write all buffered entries
-                foreach (var bytes in toWrite)
+                if (!_logLoaded)
                 {
-                    await _logStream!.WriteAsync(bytes, 0, bytes.Length);
+                    Load();
+                    _logLoaded = true;
                 }
+            }
+        }
 
-                // Flush to disk
-                await _logStream!.FlushAsync();
+        /// <summary>
+        /// Load the snapshot, replay the log written since and open the log for appending.
+        /// A torn record at the end of the log (a crash mid-write) is cut off.
+        /// </summary>
+        private void Load()
+        {
+            var snapshotGeneration = LoadSnapshot();
+            var logExisted = File.Exists(_logPath);
+
+            var validEnd = logExisted ? ReplayLog(snapshotGeneration) : -1;
+            if (validEnd < 0)
+            {
+                StartLog(snapshotGeneration);
             }
-            finally
+            else
             {
-                _writeLock.Release();
+                var stream = new FileStream(_logPath, FileMode.Open, FileAccess.Write, FileShare.Read, 8192);
+                if (stream.Length > validEnd)
+                {
+                    AcornLog.Info($"⚠️ Truncating {stream.Length - validEnd} bytes of incomplete DocumentStoreTrunk log records");
+                    stream.SetLength(validEnd);
+                }
+                stream.Position = validEnd;
+                _logStream = stream;
+                _generation = snapshotGeneration;
+                _logPosition = _flushedPosition = validEnd;
             }
+
+            if (!logExisted && File.Exists(_legacyLogPath))
+                MigrateLegacyLog();
         }
 
-        private void LoadFromLog()
+        /// <summary>
+        /// Replay the log records. Returns the end of the valid records, or -1 when the log
+        /// should be started afresh (empty, or already folded into the snapshot).
+        /// </summary>
+        private long ReplayLog(long snapshotGeneration)
         {
-            if (!File.Exists(_logPath))
-                return;
+            using var stream = OpenForRead(_logPath);
+            if (stream.Length < LOG_HEADER_SIZE)
+                return -1;
+
+            Span<byte> header = stackalloc byte[LOG_HEADER_SIZE];
+            stream.ReadExactly(header);
+            if (BinaryPrimitives.ReadInt32LittleEndian(header) != LOG_MAGIC
+                || BinaryPrimitives.ReadInt32LittleEndian(header.Slice(4)) != FORMAT_VERSION)
+                throw new InvalidDataException($"{_logPath} is not a DocumentStoreTrunk log");
+
+            var generation = BinaryPrimitives.ReadInt64LittleEndian(header.Slice(8));
+            if (generation < snapshotGeneration)
+                return -1; // Crashed after the snapshot was saved but before the log was reset
+            if (generation > snapshotGeneration)
+                throw new InvalidDataException($"{_logPath} follows a snapshot (generation {generation}) that is missing");
+
+            var replayed = 0;
+            var end = stream.Length;
+            var position = stream.Position;
+            while (TryReadRecord(stream, end, out var record))
+            {
+                ApplyRecord(record, new RecordLocation(false, position, record.Bytes.Length, record.Timestamp.Ticks));
+                position = stream.Position;
+                replayed++;
+            }
 
-            // Read entire log file and split into lines
-            // Note: Log entries are NOT processed through roots - they are stored in plain JSON format
-            var allBytes = File.ReadAllBytes(_logPath);
-            var allText = Encoding.UTF8.GetString(allBytes);
-            var lines = allText.Split('\n', StringSplitOptions.RemoveEmptyEntries);
+            _recordsReplayed = replayed;
+            return position;
+        }
 
-            foreach (var line in lines)
+        /// <summary>
+        /// Apply a record read from the snapshot or log to the in-memory state
+        /// </summary>
+        private void ApplyRecord(in DecodedRecord record, RecordLocation location)
+        {
+            switch (record.Action)
+            {
+                case ACTION_STASH:
+                    Nut<T> shell;
+                    try
+                    {
+                        shell = ReadPayload(record);
+                    }
+                    catch (Exception ex)
+                    {
+                        AcornLog.Info($"⚠️ Failed to deserialize log entry: {ex.Message}");
+                        return;
+                    }
+
+                    if (_locations.TryGetValue(record.Id, out var previous))
+                        AddHistory(record.Id, previous);
+                    _current[record.Id] = shell;
+                    _locations[record.Id] = location;
+                    break;
+
+                case ACTION_TOSS:
+                    _current.TryRemove(record.Id, out _);
+                    if (_locations.TryRemove(record.Id, out var removed))
+                        AddHistory(record.Id, removed);
+                    break;
+
+                case ACTION_HISTORY:
+                    AddHistory(record.Id, location);
+                    break;
+            }
+        }
+
+        /// <summary>
+        /// Start an empty log for the given snapshot generation, replacing any previous one
+        /// </summary>
+        private void StartLog(long generation)
+        {
+            _logStream?.Dispose();
+
+            var stream = new FileStream(_logPath, FileMode.Create, FileAccess.Write, FileShare.Read, 8192);
+            Span<byte> header = stackalloc byte[LOG_HEADER_SIZE];
+            BinaryPrimitives.WriteInt32LittleEndian(header, LOG_MAGIC);
+            BinaryPrimitives.WriteInt32LittleEndian(header.Slice(4), FORMAT_VERSION);
+            BinaryPrimitives.WriteInt64LittleEndian(header.Slice(8), generation);
+            stream.Write(header);
+            stream.Flush(flushToDisk: true);
+
+            _logStream = stream;
+            _generation = generation;
+            Interlocked.Exchange(ref _logPosition, LOG_HEADER_SIZE);
+            Interlocked.Exchange(ref _flushedPosition, LOG_HEADER_SIZE);
+        }
+
+        /// <summary>
+        /// Rewrite a JSON-lines changes.log from earlier versions as binary records, keeping
+        /// its history, then set it aside as changes.log.migrated
+        /// </summary>
+        private void MigrateLegacyLog()
+        {
+            var migrated = 0;
+            foreach (var line in File.ReadLines(_legacyLogPath))
             {
                 if (string.IsNullOrWhiteSpace(line))
                     continue;
@@ -288,39 +624,30 @@ namespace AcornDB.Storage
                     if (entry == null)
                         continue;
 
-                    // Support both old and new action names during migration
+                    // Support both old and new action names
                     if ((entry.Action == "Stash" || entry.Action == "Save") && entry.Shell != null)
-                    {
-                        // Store previous in history
-                        if (_current.TryGetValue(entry.Id, out var previous))
-                        {
-                            var historyList = _history.GetOrAdd(entry.Id, _ => new List<Nut<T>>());
-                            lock (historyList)
-                            {
-                                historyList.Add(previous);
-                            }
-                        }
-                        _current[entry.Id] = entry.Shell;
-                    }
+                        StashInternal(entry.Id, entry.Shell, entry.Timestamp);
                     else if (entry.Action == "Toss" || entry.Action == "Delete")
-                    {
-                        if (_current.TryRemove(entry.Id, out var shell))
-                        {
-                            var historyList = _history.GetOrAdd(entry.Id, _ => new List<Nut<T>>());
-                            lock (historyList)
-                            {
-                                historyList.Add(shell);
-                            }
-                        }
-                    }
+                        TossInternal(entry.Id, entry.Timestamp);
+                    else
+                        continue;
+
+                    migrated++;
                 }
                 catch (Exception ex)
                 {
                     AcornLog.Info($"⚠️ Failed to deserialize log entry: {ex.Message}");
                 }
             }
+
+            Flush();
+            _logStream!.Flush(flushToDisk: true);
+            File.Move(_legacyLogPath, _legacyLogPath + ".migrated", overwrite: true);
+            AcornLog.Info($"📦 Migrated {migrated} DocumentStoreTrunk JSON log entries to {_logPath}");
         }
 
+        #endregion
+
         public override void Dispose()
         {
             if (_disposed) return;
@@ -330,7 +657,8 @@ namespace AcornDB.Storage
             // Flush any pending writes
             try
             {
-                FlushAsync().Wait();
+                Flush();
+                SnapshotIfDue();
             }
             catch (Exception ex)
             {
@@ -338,8 +666,12 @@ namespace AcornDB.Storage
                 // Don't rethrow - disposal must succeed to release resources
             }
 
-            _logStream?.Dispose();
-            _writeLock?.Dispose();
+            lock (_flushLock)
+            {
+                _logStream?.Dispose();
+                _logStream = null;
+            }
+            _fileLock.Dispose();
 
             base.Dispose();
         }
@@ -0,0 +1,36 @@
+namespace AcornDB.Storage
+{
+    /// <summary>
+    /// When a stash counts as committed, for trunks that batch writes (see TrunkBase)
+    /// </summary>
+    public enum DurabilityMode
+    {
+        /// <summary>
+        /// Stash returns once the write is buffered. Batches are written on the batch threshold
+        /// or flush timer and never forced to disk (the OS writes them back on its own).
+        /// Best for: Caches and data that can be rebuilt
+        /// </summary>
+        None,
+
+        /// <summary>
+        /// Stash returns once the write is buffered. Each batch is forced to disk when it is
+        /// written, so at most one flush interval of writes can be lost.
+        /// Best for: Most workloads (default)
+        /// </summary>
+        Buffered,
+
+        /// <summary>
+        /// Stash returns once a disk flush covering the write has completed. Concurrent writers
+        /// share that flush; the group size adapts to the observed flush latency.
+        /// Best for: Durable writes from many concurrent callers
+        /// </summary>
+        GroupCommit,
+
+        /// <summary>
+        /// Stash writes and forces its batch to disk immediately, without waiting for others
+        /// to join. Lowest commit latency for a single writer, lowest throughput.
+        /// Best for: Rare writes that must never be lost
+        /// </summary>
+        Sync
+    }
+}
@@ -0,0 +1,17 @@
+namespace AcornDB.Storage
+{
+    /// <summary>
+    /// Commit statistics for a batching trunk
+    /// </summary>
+    public class DurabilityStats
+    {
+        public DurabilityMode Mode { get; set; }
+        public long Commits { get; set; }
+        public long DiskFlushes { get; set; }
+        public long WritesCommitted { get; set; }
+        public double AverageGroupSize { get; set; }
+        public int LastGroupSize { get; set; }
+        public int GroupTarget { get; set; }
+        public double DiskFlushLatencyMs { get; set; }
+    }
+}
@@ -56,18 +56,14 @@ namespace AcornDB.Storage
 
         public override void Stash(string id, Nut<T> nut)
         {
-            // Step 1: Serialize Nut<T> to JSON then bytes
-            var json = _serializer.Serialize(nut);
-            var bytes = Encoding.UTF8.GetBytes(json);
-
-            // Step 2: Process through root chain in ascending sequence order
-            var processedBytes = ProcessThroughRootsAscending(bytes, id);
+            // Step 1-2: Serialize and process through root chain in ascending sequence order
+            using var processed = SerializeThroughRoots(nut, id);
 
             // Step 3: Write final byte array to file
             var file = GetFilePath(id);
             using (var stream = new FileStream(file, FileMode.Create, FileAccess.Write, FileShare.None, 4096, FileOptions.SequentialScan))
             {
-                stream.Write(processedBytes, 0, processedBytes.Length);
+                stream.Write(processed.WrittenSpan);
                 stream.Flush(flushToDisk: true);
             }
         }
@@ -87,14 +83,12 @@ namespace AcornDB.Storage
             }
 
             // Step 2: Process through root chain in descending sequence order (reverse)
-            var processedBytes = ProcessThroughRootsDescending(storedBytes, id);
+            using var restored = _roots.Count > 0 ? ProcessThroughRootsDescending(storedBytes.AsSpan(), id) : null;
 
             // Step 3: Deserialize bytes back to Nut<T>
             try
             {
-                var json = Encoding.UTF8.GetString(processedBytes);
-                var nut = _serializer.Deserialize<Nut<T>>(json);
-                return nut;
+                return _serializer.Deserialize<Nut<T>>(restored != null ? restored.WrittenSpan : storedBytes);
             }
             catch (Exception ex)
             {
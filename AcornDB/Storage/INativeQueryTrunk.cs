@@ -0,0 +1,25 @@
+namespace AcornDB.Storage;
+
+/// <summary>
+/// A scan trunk that can run a whole query where the nuts are stored (WHERE, ORDER BY,
+/// Skip/Take and COUNT), e.g. by compiling it to SQL. DefaultQueryPlanner hands a query over
+/// only when CanQuery says the trunk returns exactly what TreeQuery would compute itself.
+/// </summary>
+public interface INativeQueryTrunk<T> : IScanTrunk<T>
+{
+    /// <summary>
+    /// Whether Query and CountQuery answer <paramref name="filter"/> exactly: every condition,
+    /// the order and the paging run in the trunk with the same semantics as LINQ
+    /// </summary>
+    bool CanQuery(TrunkScanFilter<T> filter);
+
+    /// <summary>
+    /// Nuts matching <paramref name="filter"/>, ordered and paged (see TrunkScanFilter&lt;T&gt;.Apply)
+    /// </summary>
+    IEnumerable<Nut<T>> Query(TrunkScanFilter<T> filter);
+
+    /// <summary>
+    /// Number of nuts Query would return
+    /// </summary>
+    int CountQuery(TrunkScanFilter<T> filter);
+}
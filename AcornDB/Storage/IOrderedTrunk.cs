@@ -0,0 +1,20 @@
+namespace AcornDB.Storage;
+
+/// <summary>
+/// A trunk that keeps its ids sorted and can return a slice of them without loading everything.
+/// Keys are ordered by their UTF-8 bytes (ordinal by Unicode code point), and every method
+/// returns nuts in that order.
+/// </summary>
+public interface IOrderedTrunk<T> : ITrunk<T>
+{
+    /// <summary>
+    /// Nuts whose ids fall in [<paramref name="fromInclusive"/>, <paramref name="toExclusive"/>).
+    /// A null bound leaves that side open.
+    /// </summary>
+    IEnumerable<Nut<T>> CrackRange(string? fromInclusive, string? toExclusive);
+
+    /// <summary>
+    /// Nuts whose ids start with <paramref name="prefix"/>
+    /// </summary>
+    IEnumerable<Nut<T>> CrackPrefix(string prefix);
+}
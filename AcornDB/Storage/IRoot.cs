@@ -1,3 +1,4 @@
+using System.Buffers;
 using AcornDB.Policy;
 
 namespace AcornDB.Storage;
@@ -20,6 +21,12 @@ namespace AcornDB.Storage;
 /// - Encryption (sequence 200): Encrypt/decrypt byte streams
 /// - Checksumming (sequence 300): Add/validate checksums
 /// - Signing (sequence 350): Add/verify digital signatures
+///
+/// Buffer Pipeline:
+/// Trunks drive roots through the span overloads of OnStash/OnCrack, writing each stage
+/// into a pooled IBufferWriter instead of allocating a byte[] per stage. Their default
+/// implementations adapt to the byte[] overloads, so existing roots keep working unchanged;
+/// roots on the hot path (CompressionRoot, EncryptionRoot) implement them directly.
 /// </summary>
 public interface IRoot
 {
@@ -68,4 +75,28 @@ public interface IRoot
     /// <param name="context">Processing context for policy enforcement and metadata</param>
     /// <returns>Restored bytes to pass to next root or deserializer</returns>
     byte[] OnCrack(byte[] data, RootProcessingContext context);
+
+    /// <summary>
+    /// Transform bytes before storage, writing the result to <paramref name="output"/>.
+    /// Default: adapts to <see cref="OnStash(byte[], RootProcessingContext)"/>.
+    /// </summary>
+    /// <param name="data">Serialized data to transform (only valid for the duration of the call)</param>
+    /// <param name="output">Receives the transformed bytes</param>
+    /// <param name="context">Processing context for policy enforcement and metadata</param>
+    void OnStash(ReadOnlySpan<byte> data, IBufferWriter<byte> output, RootProcessingContext context)
+    {
+        output.Write(OnStash(data.ToArray(), context));
+    }
+
+    /// <summary>
+    /// Restore bytes after retrieval, writing the result to <paramref name="output"/>.
+    /// Default: adapts to <see cref="OnCrack(byte[], RootProcessingContext)"/>.
+    /// </summary>
+    /// <param name="data">Data retrieved from storage or previous root (only valid for the duration of the call)</param>
+    /// <param name="output">Receives the restored bytes</param>
+    /// <param name="context">Processing context for policy enforcement and metadata</param>
+    void OnCrack(ReadOnlySpan<byte> data, IBufferWriter<byte> output, RootProcessingContext context)
+    {
+        output.Write(OnCrack(data.ToArray(), context));
+    }
 }
@@ -0,0 +1,15 @@
+namespace AcornDB.Storage;
+
+/// <summary>
+/// A trunk that can filter nuts where they are stored, skipping data that cannot match rather
+/// than handing every nut to the caller. TreeQuery pushes time ranges, key ranges and Where
+/// expressions down to it.
+/// </summary>
+public interface IScanTrunk<T> : ITrunk<T>
+{
+    /// <summary>
+    /// Current nuts that may match <paramref name="filter"/>. Every matching nut is returned;
+    /// nuts that don't match may be too, so callers still apply their own predicate.
+    /// </summary>
+    IEnumerable<Nut<T>> CrackWhere(TrunkScanFilter<T> filter);
+}
@@ -47,6 +47,27 @@ namespace AcornDB.Storage
         /// </summary>
         bool SupportsComputedIndexes { get; }
 
+        /// <summary>
+        /// Whether this trunk can scan ids in key order (see IOrderedTrunk&lt;T&gt;).
+        /// When true, key-range and key-prefix queries are pushed down to the trunk instead of
+        /// filtering every loaded nut.
+        /// </summary>
+        bool SupportsOrderedScans => false;
+
+        /// <summary>
+        /// Whether this trunk can filter nuts where they are stored (see IScanTrunk&lt;T&gt;).
+        /// When true, time-range, key-range and Where queries read only the data the trunk
+        /// cannot rule out.
+        /// </summary>
+        bool SupportsScanPushdown => false;
+
+        /// <summary>
+        /// Whether this trunk can run whole queries itself (see INativeQueryTrunk&lt;T&gt;).
+        /// When true, the query planner sends WHERE, ORDER BY, Skip/Take and Count to the trunk
+        /// instead of scanning the cache.
+        /// </summary>
+        bool SupportsNativeQueries => false;
+
         /// <summary>
         /// Human-readable name of the trunk type
         /// </summary>
@@ -39,15 +39,11 @@ namespace AcornDB.Storage
         [MethodImpl(MethodImplOptions.AggressiveInlining)]
         public override void Stash(string id, Nut<T> nut)
         {
-            // Step 1: Serialize Nut<T> to JSON then bytes
-            var json = _serializer.Serialize(nut);
-            var bytes = Encoding.UTF8.GetBytes(json);
-
-            // Step 2: Process through root chain in ascending sequence order
-            var processedBytes = ProcessThroughRootsAscending(bytes, id);
+            // Step 1-2: Serialize and process through root chain in ascending sequence order
+            using var processed = SerializeThroughRoots(nut, id);
 
             // Step 3: Store final byte array
-            _storage[id] = processedBytes;
+            _storage[id] = processed.WrittenSpan.ToArray();
         }
 
         [MethodImpl(MethodImplOptions.AggressiveInlining)]
@@ -58,14 +54,12 @@ namespace AcornDB.Storage
                 return null;
 
             // Step 2: Process through root chain in descending sequence order (reverse)
-            var processedBytes = ProcessThroughRootsDescending(storedBytes, id);
+            using var restored = _roots.Count > 0 ? ProcessThroughRootsDescending(storedBytes.AsSpan(), id) : null;
 
             // Step 3: Deserialize bytes back to Nut<T>
             try
             {
-                var json = Encoding.UTF8.GetString(processedBytes);
-                var nut = _serializer.Deserialize<Nut<T>>(json);
-                return nut;
+                return _serializer.Deserialize<Nut<T>>(restored != null ? restored.WrittenSpan : storedBytes);
             }
             catch (Exception ex)
             {
@@ -116,6 +110,11 @@ namespace AcornDB.Storage
         /// </summary>
         public int Count => _storage.Count;
 
+        /// <summary>
+        /// Check whether an item is stored without deserializing it (lock-free)
+        /// </summary>
+        public bool Contains(string id) => _storage.ContainsKey(id);
+
         /// <summary>
         /// Clear all stored items (lock-free)
         /// </summary>
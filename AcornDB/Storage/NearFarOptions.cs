@@ -31,6 +31,34 @@ namespace AcornDB.Storage
         /// </summary>
         public bool PopulateNearOnBackingHit { get; set; } = true;
 
+        /// <summary>
+        /// How long an entry stays in the near cache before it is re-read from the far cache or
+        /// backing store. Null = until invalidated.
+        /// Default: null
+        /// </summary>
+        public TimeSpan? NearCacheTimeToLive { get; set; }
+
+        /// <summary>
+        /// Let one far-cache/backing-store read serve every concurrent near-cache miss on the same key
+        /// Default: true
+        /// </summary>
+        public bool CoalesceMisses { get; set; } = true;
+
+        /// <summary>
+        /// How eagerly hot near-cache entries are reloaded in the background before
+        /// NearCacheTimeToLive runs out (XFetch beta: 1 refreshes about one read time ahead,
+        /// larger is earlier, 0 disables). Ignored when NearCacheTimeToLive is null.
+        /// Default: 1
+        /// </summary>
+        public double RefreshAheadBeta { get; set; } = 1.0;
+
+        /// <summary>
+        /// Maximum far-cache/backing-store reads CrackMany/CrackManyAsync run at once for the
+        /// near-cache misses of a batch
+        /// Default: 16
+        /// </summary>
+        public int MaxParallelFetches { get; set; } = 16;
+
         /// <summary>
         /// Default options (invalidate on write, populate all caches on read)
         /// </summary>
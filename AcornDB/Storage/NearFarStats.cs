@@ -8,5 +8,21 @@ namespace AcornDB.Storage
         public int NearCacheCount { get; set; }
         public int FarCacheCount { get; set; }
         public int BackingStoreCount { get; set; }
+
+        /// <summary>
+        /// Reads that missed both caches and went to the backing store
+        /// </summary>
+        public long BackingStoreLoadCount { get; set; }
+
+        /// <summary>
+        /// Near-cache misses that waited for a read already in flight for the same key
+        /// instead of issuing their own
+        /// </summary>
+        public long CoalescedCount { get; set; }
+
+        /// <summary>
+        /// Background reloads started for hot near-cache entries close to NearCacheTimeToLive
+        /// </summary>
+        public long RefreshAheadCount { get; set; }
     }
 }
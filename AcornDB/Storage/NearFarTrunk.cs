@@ -1,8 +1,11 @@
 using System;
 using AcornDB.Logging;
+using System.Collections.Concurrent;
 using System.Collections.Generic;
 using System.Linq;
 using System.Runtime.CompilerServices;
+using System.Threading;
+using System.Threading.Tasks;
 using AcornDB;
 using AcornDB.Storage;
 
@@ -18,6 +21,9 @@ namespace AcornDB.Storage
     /// - Reads: Near → Far → Backing store → Populate caches
     /// - Writes: Backing store first (write-through) → Invalidate caches
     /// - Deletes: Backing store → Invalidate caches
+    /// - Concurrent near misses on one key share a single far/backing read (single-flight)
+    /// - With NearCacheTimeToLive, hot near entries are reloaded in the background before
+    ///   they expire (refresh-ahead)
     ///
     /// Benefits:
     /// - Ultra-low latency for frequently accessed data (near cache)
@@ -37,8 +43,17 @@ namespace AcornDB.Storage
         private readonly ITrunk<T> _farCache;
         private readonly ITrunk<T> _backingStore;
         private readonly NearFarOptions _options;
+        private readonly ConcurrentDictionary<string, long> _nearCachedAt = new(StringComparer.Ordinal); // UTC ticks
+        private readonly SingleFlight<Fetched> _loads = new();
+        private long _backingLoads;
+        private long _refreshes;
         private bool _disposed;
 
+        /// <summary>
+        /// Result of a near-cache miss and the tier that answered it
+        /// </summary>
+        private readonly record struct Fetched(Nut<T>? Nut, bool FromBackingStore);
+
         /// <summary>
         /// Create near/far trunk with distributed caching
         /// </summary>
@@ -69,17 +84,18 @@ namespace AcornDB.Storage
         {
             // Write to backing store first (write-through)
             _backingStore.Stash(id, nut);
+            _loads.Forget(id);
 
             if (_options.WriteStrategy == CacheWriteStrategy.WriteThrough)
             {
                 // Update caches immediately
                 _farCache.Stash(id, nut);
-                _nearCache.Stash(id, nut);
+                StashNear(id, nut);
             }
             else if (_options.WriteStrategy == CacheWriteStrategy.Invalidate)
             {
                 // Invalidate caches (safest for consistency)
-                try { _nearCache.Toss(id); } catch { /* Ignore */ }
+                try { TossNear(id); } catch { /* Ignore */ }
                 try { _farCache.Toss(id); } catch { /* Ignore */ }
             }
             // WriteAround: Don't touch caches
@@ -91,43 +107,182 @@ namespace AcornDB.Storage
         [MethodImpl(MethodImplOptions.AggressiveInlining)]
         public Nut<T>? Crack(string id)
         {
-            Nut<T>? nut = null;
+            // 1. Try near cache (fastest), then far cache and backing store
+            return CrackNear(id) ?? LoadMiss(id);
+        }
 
-            // 1. Try near cache (fastest)
-            nut = _nearCache.Crack(id);
-            if (nut != null)
+        /// <summary>
+        /// Crack without blocking the caller on the far cache or backing store
+        /// </summary>
+        public async Task<Nut<T>?> CrackAsync(string id)
+        {
+            return CrackNear(id) ?? await LoadMissAsync(id).ConfigureAwait(false);
+        }
+
+        /// <summary>
+        /// Crack a batch of ids. Near-cache misses are read from the far cache and backing store
+        /// in parallel, up to NearFarOptions.MaxParallelFetches at a time. Ids that don't exist
+        /// are left out.
+        /// </summary>
+        public IReadOnlyDictionary<string, Nut<T>> CrackMany(IEnumerable<string> ids)
+        {
+            return CrackManyAsync(ids).GetAwaiter().GetResult();
+        }
+
+        /// <summary>
+        /// Async CrackMany
+        /// </summary>
+        public async Task<IReadOnlyDictionary<string, Nut<T>>> CrackManyAsync(
+            IEnumerable<string> ids,
+            CancellationToken cancellationToken = default)
+        {
+            var found = new ConcurrentDictionary<string, Nut<T>>(StringComparer.Ordinal);
+            var misses = new List<string>();
+            foreach (var id in ids.Distinct(StringComparer.Ordinal))
+            {
+                var nut = CrackNear(id);
+                if (nut != null)
+                    found[id] = nut;
+                else
+                    misses.Add(id);
+            }
+
+            if (misses.Count > 0)
+            {
+                var options = new ParallelOptions
+                {
+                    MaxDegreeOfParallelism = Math.Max(1, _options.MaxParallelFetches),
+                    CancellationToken = cancellationToken
+                };
+                await Parallel.ForEachAsync(misses, options, async (id, _) =>
+                {
+                    var nut = await LoadMissAsync(id).ConfigureAwait(false);
+                    if (nut != null)
+                        found[id] = nut;
+                }).ConfigureAwait(false);
+            }
+
+            return found;
+        }
+
+        private Nut<T>? CrackNear(string id)
+        {
+            var nut = _nearCache.Crack(id);
+            if (nut == null || !_options.NearCacheTimeToLive.HasValue)
+                return nut; // Near cache hit or miss
+
+            var remaining = NearTimeToLiveLeft(id);
+            if (remaining <= TimeSpan.Zero)
+            {
+                try { TossNear(id); } catch { /* Ignore */ }
+                return null;
+            }
+
+            RefreshAheadIfDue(id, remaining);
+            return nut;
+        }
+
+        private Nut<T>? LoadMiss(string id)
+        {
+            if (!_options.CoalesceMisses)
             {
-                return nut; // Near cache hit
+                var fetched = Fetch(id);
+                Publish(id, fetched);
+                return fetched.Nut;
             }
 
+            return _loads.Run(id, () => Fetch(id), result => Publish(id, result)).Nut;
+        }
+
+        private async Task<Nut<T>?> LoadMissAsync(string id)
+        {
+            if (!_options.CoalesceMisses)
+                return await Task.Run(() => LoadMiss(id)).ConfigureAwait(false);
+
+            var fetched = await _loads.RunAsync(id, () => Fetch(id), result => Publish(id, result)).ConfigureAwait(false);
+            return fetched.Nut;
+        }
+
+        private Fetched Fetch(string id)
+        {
             // 2. Try far cache (shared, faster than backing store)
-            nut = _farCache.Crack(id);
+            var nut = _farCache.Crack(id);
             if (nut != null)
+            {
+                return new Fetched(nut, FromBackingStore: false); // Far cache hit
+            }
+
+            // 3. Load from backing store (slowest)
+            Interlocked.Increment(ref _backingLoads);
+            return new Fetched(_backingStore.Crack(id), FromBackingStore: true);
+        }
+
+        private void Publish(string id, Fetched fetched)
+        {
+            var nut = fetched.Nut;
+            if (nut == null)
+                return;
+
+            if (!fetched.FromBackingStore)
             {
                 // Populate near cache
                 if (_options.PopulateNearOnFarHit)
                 {
-                    _nearCache.Stash(id, nut);
+                    StashNear(id, nut);
                 }
-                return nut; // Far cache hit
+                return;
             }
 
-            // 3. Load from backing store (slowest)
-            nut = _backingStore.Crack(id);
-            if (nut != null)
+            // Populate caches
+            if (_options.PopulateFarOnBackingHit)
             {
-                // Populate caches
-                if (_options.PopulateFarOnBackingHit)
-                {
-                    _farCache.Stash(id, nut);
-                }
-                if (_options.PopulateNearOnBackingHit)
-                {
-                    _nearCache.Stash(id, nut);
-                }
+                _farCache.Stash(id, nut);
             }
+            if (_options.PopulateNearOnBackingHit)
+            {
+                StashNear(id, nut);
+            }
+        }
 
-            return nut;
+        private void RefreshAheadIfDue(string id, TimeSpan remaining)
+        {
+            if (_disposed || !_loads.ShouldRefreshEarly(remaining, _options.RefreshAheadBeta))
+                return;
+
+            var started = _loads.TryRefresh(id, () => Fetch(id), fetched =>
+            {
+                if (fetched.Nut != null)
+                    Publish(id, fetched);
+                else
+                    TossNear(id); // Deleted meanwhile
+            });
+
+            if (started)
+                Interlocked.Increment(ref _refreshes);
+        }
+
+        private void StashNear(string id, Nut<T> nut)
+        {
+            _nearCache.Stash(id, nut);
+            if (_options.NearCacheTimeToLive.HasValue)
+            {
+                _nearCachedAt[id] = DateTime.UtcNow.Ticks;
+            }
+        }
+
+        private void TossNear(string id)
+        {
+            _nearCachedAt.TryRemove(id, out _);
+            _nearCache.Toss(id);
+        }
+
+        private TimeSpan NearTimeToLiveLeft(string id)
+        {
+            if (!_options.NearCacheTimeToLive.HasValue || !_nearCachedAt.TryGetValue(id, out var cachedAt))
+                return TimeSpan.MaxValue;
+
+            var age = TimeSpan.FromTicks(DateTime.UtcNow.Ticks - cachedAt);
+            return _options.NearCacheTimeToLive.Value - age;
         }
 
         [Obsolete("Use Crack() instead. This method will be removed in a future version.")]
@@ -138,9 +293,10 @@ namespace AcornDB.Storage
         {
             // Delete from backing store
             _backingStore.Toss(id);
+            _loads.Forget(id);
 
             // Invalidate caches
-            try { _nearCache.Toss(id); } catch { /* Ignore */ }
+            try { TossNear(id); } catch { /* Ignore */ }
             try { _farCache.Toss(id); } catch { /* Ignore */ }
         }
 
@@ -174,6 +330,7 @@ namespace AcornDB.Storage
             _backingStore.ImportChanges(incoming);
 
             // Invalidate caches (safest for consistency)
+            _loads.ForgetAll();
             ClearAllCaches();
         }
 
@@ -182,7 +339,7 @@ namespace AcornDB.Storage
         /// </summary>
         public void ClearAllCaches()
         {
-            ClearCache(_nearCache);
+            ClearNearCache();
             ClearCache(_farCache);
         }
 
@@ -192,6 +349,7 @@ namespace AcornDB.Storage
         public void ClearNearCache()
         {
             ClearCache(_nearCache);
+            _nearCachedAt.Clear();
         }
 
         /// <summary>
@@ -227,7 +385,10 @@ namespace AcornDB.Storage
             {
                 NearCacheCount = SafeCount(_nearCache),
                 FarCacheCount = SafeCount(_farCache),
-                BackingStoreCount = SafeCount(_backingStore)
+                BackingStoreCount = SafeCount(_backingStore),
+                BackingStoreLoadCount = Interlocked.Read(ref _backingLoads),
+                CoalescedCount = _loads.CoalescedCount,
+                RefreshAheadCount = Interlocked.Read(ref _refreshes)
             };
         }
 
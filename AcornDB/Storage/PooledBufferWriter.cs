@@ -0,0 +1,98 @@
+using System;
+using System.Buffers;
+
+namespace AcornDB.Storage
+{
+    /// <summary>
+    /// IBufferWriter&lt;byte&gt; over an array rented from ArrayPool&lt;byte&gt;.Shared.
+    /// Used by the root pipeline so each stage writes into a reused buffer instead of
+    /// allocating a new byte[] per stage. Dispose returns the array to the pool; spans taken
+    /// from <see cref="WrittenSpan"/> must not be used after that.
+    /// </summary>
+    public sealed class PooledBufferWriter : IBufferWriter<byte>, IDisposable
+    {
+        private const int DEFAULT_INITIAL_CAPACITY = 256;
+
+        private byte[] _buffer;
+        private int _written;
+
+        public PooledBufferWriter(int initialCapacity = DEFAULT_INITIAL_CAPACITY)
+        {
+            if (initialCapacity < 0)
+                throw new ArgumentException("Initial capacity cannot be negative", nameof(initialCapacity));
+
+            _buffer = ArrayPool<byte>.Shared.Rent(Math.Max(initialCapacity, 1));
+        }
+
+        /// <summary>
+        /// Bytes written so far
+        /// </summary>
+        public int WrittenCount => _written;
+
+        public ReadOnlySpan<byte> WrittenSpan => _buffer.AsSpan(0, _written);
+
+        public ReadOnlyMemory<byte> WrittenMemory => _buffer.AsMemory(0, _written);
+
+        /// <summary>
+        /// The rented array backing <see cref="WrittenSpan"/>, for APIs that only take arrays
+        /// (valid range: 0..<see cref="WrittenCount"/>)
+        /// </summary>
+        public byte[] GetBuffer() => _buffer;
+
+        /// <summary>
+        /// Copy the written bytes into a new array
+        /// </summary>
+        public byte[] ToArray() => WrittenSpan.ToArray();
+
+        /// <summary>
+        /// Forget the written bytes and keep the buffer for reuse
+        /// </summary>
+        public void Clear() => _written = 0;
+
+        public void Advance(int count)
+        {
+            if (count < 0 || _written + count > _buffer.Length)
+                throw new ArgumentOutOfRangeException(nameof(count));
+
+            _written += count;
+        }
+
+        public Memory<byte> GetMemory(int sizeHint = 0)
+        {
+            EnsureCapacity(sizeHint);
+            return _buffer.AsMemory(_written);
+        }
+
+        public Span<byte> GetSpan(int sizeHint = 0)
+        {
+            EnsureCapacity(sizeHint);
+            return _buffer.AsSpan(_written);
+        }
+
+        private void EnsureCapacity(int sizeHint)
+        {
+            if (_buffer.Length == 0)
+                throw new ObjectDisposedException(nameof(PooledBufferWriter));
+
+            sizeHint = Math.Max(sizeHint, 1);
+            if (_buffer.Length - _written >= sizeHint)
+                return;
+
+            var larger = ArrayPool<byte>.Shared.Rent(Math.Max(_buffer.Length * 2, _written + sizeHint));
+            _buffer.AsSpan(0, _written).CopyTo(larger);
+            ArrayPool<byte>.Shared.Return(_buffer);
+            _buffer = larger;
+        }
+
+        public void Dispose()
+        {
+            var buffer = _buffer;
+            if (buffer.Length == 0)
+                return;
+
+            _buffer = Array.Empty<byte>();
+            _written = 0;
+            ArrayPool<byte>.Shared.Return(buffer);
+        }
+    }
+}
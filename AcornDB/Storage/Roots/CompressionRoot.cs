@@ -1,4 +1,5 @@
 using System;
+using System.Buffers;
 using AcornDB.Logging;
 using AcornDB.Compression;
 
@@ -38,22 +39,33 @@ namespace AcornDB.Storage.Roots
         }
 
         public byte[] OnStash(byte[] data, RootProcessingContext context)
+        {
+            using var output = new PooledBufferWriter(data.Length);
+            OnStash(data, output, context);
+            return output.ToArray();
+        }
+
+        public byte[] OnCrack(byte[] data, RootProcessingContext context)
+        {
+            using var output = new PooledBufferWriter(data.Length * 2);
+            OnCrack(data, output, context);
+            return output.ToArray();
+        }
+
+        public void OnStash(ReadOnlySpan<byte> data, IBufferWriter<byte> output, RootProcessingContext context)
         {
             try
             {
                 var originalSize = data.Length;
 
-                // Compress the byte array
-                var compressed = _compression.Compress(data);
-                var compressedSize = compressed.Length;
+                // Compress straight into the next stage's buffer
+                var compressedSize = Transform(data, output, compress: true);
 
                 // Update metrics
                 _metrics.RecordCompression(originalSize, compressedSize);
 
                 // Add signature to transformation chain
                 context.TransformationSignatures.Add(GetSignature());
-
-                return compressed;
             }
             catch (Exception ex)
             {
@@ -63,20 +75,17 @@ namespace AcornDB.Storage.Roots
             }
         }
 
-        public byte[] OnCrack(byte[] data, RootProcessingContext context)
+        public void OnCrack(ReadOnlySpan<byte> data, IBufferWriter<byte> output, RootProcessingContext context)
         {
             try
             {
                 var compressedSize = data.Length;
 
-                // Decompress the byte array
-                var decompressed = _compression.Decompress(data);
-                var originalSize = decompressed.Length;
+                // Decompress straight into the next stage's buffer
+                var originalSize = Transform(data, output, compress: false);
 
                 // Update metrics
                 _metrics.RecordDecompression(compressedSize, originalSize);
-
-                return decompressed;
             }
             catch (Exception ex)
             {
@@ -85,5 +94,46 @@ namespace AcornDB.Storage.Roots
                 throw new InvalidOperationException($"Failed to decompress data", ex);
             }
         }
+
+        /// <summary>
+        /// Compress or decompress into <paramref name="output"/> and return the bytes written.
+        /// The root pipeline always hands in a PooledBufferWriter, which can be measured
+        /// without wrapping it.
+        /// </summary>
+        private int Transform(ReadOnlySpan<byte> data, IBufferWriter<byte> output, bool compress)
+        {
+            var pooled = output as PooledBufferWriter;
+            int before = pooled?.WrittenCount ?? 0;
+            var target = pooled ?? (IBufferWriter<byte>)new CountingBufferWriter(output);
+
+            if (compress)
+                _compression.Compress(data, target);
+            else
+                _compression.Decompress(data, target);
+
+            return pooled != null ? pooled.WrittenCount - before : ((CountingBufferWriter)target).Written;
+        }
+
+        private sealed class CountingBufferWriter : IBufferWriter<byte>
+        {
+            private readonly IBufferWriter<byte> _inner;
+
+            public CountingBufferWriter(IBufferWriter<byte> inner)
+            {
+                _inner = inner;
+            }
+
+            public int Written { get; private set; }
+
+            public void Advance(int count)
+            {
+                _inner.Advance(count);
+                Written += count;
+            }
+
+            public Memory<byte> GetMemory(int sizeHint = 0) => _inner.GetMemory(sizeHint);
+
+            public Span<byte> GetSpan(int sizeHint = 0) => _inner.GetSpan(sizeHint);
+        }
     }
 }
@@ -1,6 +1,7 @@
 using System;
+using System.Buffers;
+using System.Buffers.Text;
 using AcornDB.Logging;
-using System.Text;
 using AcornDB.Security;
 
 namespace AcornDB.Storage.Roots
@@ -43,25 +44,35 @@ namespace AcornDB.Storage.Roots
 
         public byte[] OnStash(byte[] data, RootProcessingContext context)
         {
+            using var output = new PooledBufferWriter(data.Length * 2);
+            OnStash(data, output, context);
+            return output.ToArray();
+        }
+
+        public byte[] OnCrack(byte[] data, RootProcessingContext context)
+        {
+            using var output = new PooledBufferWriter(data.Length);
+            OnCrack(data, output, context);
+            return output.ToArray();
+        }
+
+        public void OnStash(ReadOnlySpan<byte> data, IBufferWriter<byte> output, RootProcessingContext context)
+        {
+            var base64 = ArrayPool<byte>.Shared.Rent(Base64.GetMaxEncodedToUtf8Length(data.Length));
             try
             {
-                // Convert bytes to base64 string for encryption provider
-                // (Most encryption providers work with strings)
-                var base64Data = Convert.ToBase64String(data);
-
-                // Encrypt
-                var encrypted = _encryption.Encrypt(base64Data);
+                // Encryption providers take text, so the payload is Base64-encoded first
+                // (as UTF-8 bytes, the same as the string the providers would be given)
+                Base64.EncodeToUtf8(data, base64, out _, out int base64Length);
 
-                // Convert back to bytes
-                var encryptedBytes = Encoding.UTF8.GetBytes(encrypted);
+                // Encrypt into the next stage's buffer
+                _encryption.Encrypt(base64.AsSpan(0, base64Length), output);
 
                 // Update metrics
                 _metrics.RecordEncryption();
 
                 // Add signature to transformation chain
                 context.TransformationSignatures.Add(GetSignature());
-
-                return encryptedBytes;
             }
             catch (Exception ex)
             {
@@ -69,25 +80,28 @@ namespace AcornDB.Storage.Roots
                 AcornLog.Info($"⚠️ Encryption failed for document '{context.DocumentId}': {ex.Message}");
                 throw new InvalidOperationException($"Failed to encrypt data", ex);
             }
+            finally
+            {
+                ArrayPool<byte>.Shared.Return(base64, clearArray: true);
+            }
         }
 
-        public byte[] OnCrack(byte[] data, RootProcessingContext context)
+        public void OnCrack(ReadOnlySpan<byte> data, IBufferWriter<byte> output, RootProcessingContext context)
         {
+            using var base64 = new PooledBufferWriter(data.Length);
             try
             {
-                // Convert bytes to string
-                var encryptedString = Encoding.UTF8.GetString(data);
-
-                // Decrypt
-                var decrypted = _encryption.Decrypt(encryptedString);
+                // Decrypt back to the Base64 text
+                _encryption.Decrypt(data, base64);
 
                 // Convert from base64 back to original bytes
-                var decryptedBytes = Convert.FromBase64String(decrypted);
+                var destination = output.GetSpan(Base64.GetMaxDecodedFromUtf8Length(base64.WrittenCount));
+                if (Base64.DecodeFromUtf8(base64.WrittenSpan, destination, out _, out int written) != OperationStatus.Done)
+                    throw new FormatException("Decrypted payload is not valid Base64");
+                output.Advance(written);
 
                 // Update metrics
                 _metrics.RecordDecryption();
-
-                return decryptedBytes;
             }
             catch (Exception ex)
             {
@@ -95,6 +109,10 @@ namespace AcornDB.Storage.Roots
                 AcornLog.Info($"⚠️ Decryption failed for document '{context.DocumentId}': {ex.Message}");
                 throw new InvalidOperationException($"Failed to decrypt data", ex);
             }
+            finally
+            {
+                base64.GetBuffer().AsSpan(0, base64.WrittenCount).Clear();
+            }
         }
     }
 }
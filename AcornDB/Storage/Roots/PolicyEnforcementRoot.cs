@@ -54,8 +54,7 @@ namespace AcornDB.Storage.Roots
             try
             {
                 // Temporarily deserialize to validate policies
-                var json = Encoding.UTF8.GetString(data);
-                var nut = _serializer.Deserialize<dynamic>(json);
+                var nut = _serializer.Deserialize<dynamic>(data.AsSpan());
 
                 if (nut != null)
                 {
@@ -111,8 +110,7 @@ namespace AcornDB.Storage.Roots
             try
             {
                 // Temporarily deserialize to validate policies
-                var json = Encoding.UTF8.GetString(data);
-                var nut = _serializer.Deserialize<dynamic>(json);
+                var nut = _serializer.Deserialize<dynamic>(data.AsSpan());
 
                 if (nut != null)
                 {
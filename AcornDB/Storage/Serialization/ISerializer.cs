@@ -1,8 +1,39 @@
+using System;
+using System.Buffers;
+using System.Text;
+
 namespace AcornDB.Storage.Serialization
 {
     public interface ISerializer
     {
         string Serialize<T>(T obj);
         T Deserialize<T>(string data);
+
+        /// <summary>
+        /// True when the byte overloads produce binary rather than UTF-8 text. Trunks that
+        /// keep documents in text columns store such payloads as blobs or Base64.
+        /// Default: false
+        /// </summary>
+        bool IsBinary => false;
+
+        /// <summary>
+        /// Serialize straight to bytes in <paramref name="output"/> (UTF-8 for text formats).
+        /// Default: encodes the result of <see cref="Serialize{T}(T)"/>.
+        /// </summary>
+        void Serialize<T>(T obj, IBufferWriter<byte> output)
+        {
+            var text = Serialize(obj);
+            var span = output.GetSpan(Encoding.UTF8.GetMaxByteCount(text.Length));
+            output.Advance(Encoding.UTF8.GetBytes(text, span));
+        }
+
+        /// <summary>
+        /// Deserialize from bytes written by the overload above. Default: decodes to a string for
+        /// <see cref="Deserialize{T}(string)"/>.
+        /// </summary>
+        T Deserialize<T>(ReadOnlySpan<byte> utf8)
+        {
+            return Deserialize<T>(Encoding.UTF8.GetString(utf8));
+        }
     }
 }
@@ -0,0 +1,824 @@
+using System;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.Dynamic;
+using System.Globalization;
+using System.IO;
+using System.Linq;
+using System.Linq.Expressions;
+using System.Reflection;
+using System.Runtime.CompilerServices;
+using System.Text;
+using AcornDB.Indexing;
+
+namespace AcornDB.Storage.Serialization
+{
+    /// <summary>
+    /// Reads and writes one type as MessagePack. Created once per type on first use and cached.
+    /// </summary>
+    internal abstract class MsgPackConverter
+    {
+        /// <summary>
+        /// True for types written as a map or an array, whose MessagePack form can never
+        /// start like a JSON document does - so JSON written before the switch is still read
+        /// </summary>
+        public virtual bool HasContainerShape => false;
+
+        public abstract void WriteBoxed(ref MsgPackWriter writer, object? value);
+        public abstract object? ReadBoxed(ref MsgPackReader reader);
+    }
+
+    internal abstract class MsgPackConverter<T> : MsgPackConverter
+    {
+        public abstract void Write(ref MsgPackWriter writer, T value);
+        public abstract T Read(ref MsgPackReader reader);
+
+        public override void WriteBoxed(ref MsgPackWriter writer, object? value) => Write(ref writer, (T)value!);
+        public override object? ReadBoxed(ref MsgPackReader reader) => Read(ref reader);
+    }
+
+    /// <summary>
+    /// Converter lookup. Generic converters are cached in a static per type, so a lookup
+    /// after the first is a field read.
+    /// </summary>
+    internal static class MsgPackConverters
+    {
+        private static readonly ConcurrentDictionary<Type, MsgPackConverter> ByType = new();
+
+        public static MsgPackConverter<T> Get<T>() => Cache<T>.Instance;
+
+        public static MsgPackConverter Get(Type type)
+        {
+            return ByType.GetOrAdd(type, static type =>
+                (MsgPackConverter)typeof(Cache<>).MakeGenericType(type).GetField(nameof(Cache<object>.Instance))!.GetValue(null)!);
+        }
+
+        private static class Cache<T>
+        {
+            public static readonly MsgPackConverter<T> Instance = (MsgPackConverter<T>)Create(typeof(T));
+        }
+
+        private static MsgPackConverter Create(Type type)
+        {
+            if (type == typeof(string)) return new StringConverter();
+            if (type == typeof(bool)) return new BooleanConverter();
+            if (type == typeof(int)) return new Int32Converter();
+            if (type == typeof(long)) return new Int64Converter();
+            if (type == typeof(double)) return new DoubleConverter();
+            if (type == typeof(DateTime)) return new DateTimeConverter();
+            if (type == typeof(Guid)) return new GuidConverter();
+            if (type == typeof(byte)) return new IntegerConverter<byte>(v => v, v => checked((byte)v));
+            if (type == typeof(sbyte)) return new IntegerConverter<sbyte>(v => v, v => checked((sbyte)v));
+            if (type == typeof(short)) return new IntegerConverter<short>(v => v, v => checked((short)v));
+            if (type == typeof(ushort)) return new IntegerConverter<ushort>(v => v, v => checked((ushort)v));
+            if (type == typeof(uint)) return new IntegerConverter<uint>(v => v, v => checked((uint)v));
+            if (type == typeof(ulong)) return new UInt64Converter();
+            if (type == typeof(float)) return new SingleConverter();
+            if (type == typeof(decimal)) return new DecimalConverter();
+            if (type == typeof(char)) return new CharConverter();
+            if (type == typeof(DateTimeOffset)) return new DateTimeOffsetConverter();
+            if (type == typeof(TimeSpan)) return new TimeSpanConverter();
+            if (type == typeof(byte[])) return new ByteArrayConverter();
+            if (type == typeof(object)) return new DynamicConverter();
+
+            if (Nullable.GetUnderlyingType(type) is Type underlying)
+                return Instantiate(typeof(NullableConverter<>), underlying);
+
+            if (type.IsEnum)
+                return Instantiate(typeof(EnumConverter<>), type);
+
+            if (type.IsArray && type.GetArrayRank() == 1)
+                return Instantiate(typeof(ArrayConverter<>), type.GetElementType()!);
+
+            if ((FindGenericInterface(type, typeof(IDictionary<,>)) ?? FindGenericInterface(type, typeof(IReadOnlyDictionary<,>))) is Type dictionary)
+            {
+                var args = dictionary.GetGenericArguments();
+                return Instantiate(typeof(DictionaryConverter<,,>), type, args[0], args[1]);
+            }
+
+            if (type != typeof(string) && FindGenericInterface(type, typeof(IEnumerable<>)) is Type enumerable)
+                return Instantiate(typeof(CollectionConverter<,>), type, enumerable.GetGenericArguments()[0]);
+
+            if (type.IsInterface || type.IsAbstract)
+                throw new NotSupportedException($"MsgPackSerializer cannot create instances of {type.Name}; use a concrete type");
+
+            return Instantiate(typeof(ObjectConverter<>), type);
+        }
+
+        private static Type? FindGenericInterface(Type type, Type definition)
+        {
+            if (type.IsGenericType && type.GetGenericTypeDefinition() == definition)
+                return type;
+            return type.GetInterfaces().FirstOrDefault(i => i.IsGenericType && i.GetGenericTypeDefinition() == definition);
+        }
+
+        private static MsgPackConverter Instantiate(Type definition, params Type[] arguments)
+        {
+            return (MsgPackConverter)Activator.CreateInstance(definition.MakeGenericType(arguments))!;
+        }
+
+        #region Scalars
+
+        private sealed class StringConverter : MsgPackConverter<string>
+        {
+            public override void Write(ref MsgPackWriter writer, string value) => writer.WriteString(value);
+            public override string Read(ref MsgPackReader reader) => reader.ReadString()!;
+        }
+
+        private sealed class BooleanConverter : MsgPackConverter<bool>
+        {
+            public override void Write(ref MsgPackWriter writer, bool value) => writer.WriteBoolean(value);
+            public override bool Read(ref MsgPackReader reader) => reader.ReadBoolean();
+        }
+
+        private sealed class Int32Converter : MsgPackConverter<int>
+        {
+            public override void Write(ref MsgPackWriter writer, int value) => writer.WriteInt64(value);
+            public override int Read(ref MsgPackReader reader) => checked((int)reader.ReadInt64());
+        }
+
+        private sealed class Int64Converter : MsgPackConverter<long>
+        {
+            public override void Write(ref MsgPackWriter writer, long value) => writer.WriteInt64(value);
+            public override long Read(ref MsgPackReader reader) => reader.ReadInt64();
+        }
+
+        private sealed class UInt64Converter : MsgPackConverter<ulong>
+        {
+            public override void Write(ref MsgPackWriter writer, ulong value) => writer.WriteUInt64(value);
+            public override ulong Read(ref MsgPackReader reader) => reader.ReadUInt64();
+        }
+
+        private sealed class IntegerConverter<T> : MsgPackConverter<T>
+        {
+            private readonly Func<T, long> _toInt64;
+            private readonly Func<long, T> _fromInt64;
+
+            public IntegerConverter(Func<T, long> toInt64, Func<long, T> fromInt64)
+            {
+                _toInt64 = toInt64;
+                _fromInt64 = fromInt64;
+            }
+
+            public override void Write(ref MsgPackWriter writer, T value) => writer.WriteInt64(_toInt64(value));
+            public override T Read(ref MsgPackReader reader) => _fromInt64(reader.ReadInt64());
+        }
+
+        private sealed class DoubleConverter : MsgPackConverter<double>
+        {
+            // Whole values (quantities, prices in cents, counters kept as double) take the
+            // integer forms: one to five bytes instead of nine
+            public override void Write(ref MsgPackWriter writer, double value)
+            {
+                if (value >= long.MinValue && value < long.MaxValue && Math.Floor(value) == value
+                    && !(value == 0 && double.IsNegative(value)))
+                    writer.WriteInt64((long)value);
+                else
+                    writer.WriteDouble(value);
+            }
+
+            public override double Read(ref MsgPackReader reader) => reader.ReadDouble();
+        }
+
+        private sealed class SingleConverter : MsgPackConverter<float>
+        {
+            public override void Write(ref MsgPackWriter writer, float value) => writer.WriteSingle(value);
+            public override float Read(ref MsgPackReader reader) => (float)reader.ReadDouble();
+        }
+
+        /// <summary>
+        /// MessagePack has no decimal type; the invariant string keeps every digit
+        /// </summary>
+        private sealed class DecimalConverter : MsgPackConverter<decimal>
+        {
+            public override void Write(ref MsgPackWriter writer, decimal value) => writer.WriteString(value.ToString(CultureInfo.InvariantCulture));
+
+            public override decimal Read(ref MsgPackReader reader)
+            {
+                var code = reader.PeekCode();
+                if (IsString(code))
+                    return decimal.Parse(reader.ReadString()!, NumberStyles.Float, CultureInfo.InvariantCulture);
+                return code is MsgPackCode.Float32 or MsgPackCode.Float64 ? (decimal)reader.ReadDouble() : reader.ReadInt64();
+            }
+        }
+
+        private sealed class CharConverter : MsgPackConverter<char>
+        {
+            public override void Write(ref MsgPackWriter writer, char value) => writer.WriteString(value.ToString());
+
+            public override char Read(ref MsgPackReader reader)
+            {
+                if (IsString(reader.PeekCode()))
+                {
+                    var text = reader.ReadString()!;
+                    return text.Length > 0 ? text[0] : '\0';
+                }
+                return (char)checked((ushort)reader.ReadInt64());
+            }
+        }
+
+        private sealed class GuidConverter : MsgPackConverter<Guid>
+        {
+            // Canonical string form, as other languages' UUID types expect in named encodings
+            public override void Write(ref MsgPackWriter writer, Guid value)
+            {
+                Span<byte> text = stackalloc byte[36];
+                value.TryFormat(text, out _);
+                writer.WriteUtf8String(text);
+            }
+
+            public override Guid Read(ref MsgPackReader reader)
+            {
+                if (reader.PeekCode() is MsgPackCode.Bin8)
+                    return new Guid(reader.ReadBinary());
+                return Guid.Parse(Encoding.UTF8.GetString(reader.ReadStringBytes()));
+            }
+        }
+
+        /// <summary>
+        /// Timestamp extension, in UTC. Unspecified kinds are taken as UTC, as the rest of
+        /// AcornDB stamps with DateTime.UtcNow; ISO 8601 strings are accepted on read.
+        /// </summary>
+        private sealed class DateTimeConverter : MsgPackConverter<DateTime>
+        {
+            public override void Write(ref MsgPackWriter writer, DateTime value)
+            {
+                if (value.Kind == DateTimeKind.Local)
+                    value = value.ToUniversalTime();
+                WriteTimestamp(ref writer, value.Ticks);
+            }
+
+            public override DateTime Read(ref MsgPackReader reader)
+            {
+                if (IsString(reader.PeekCode()))
+                    return DateTime.Parse(reader.ReadString()!, CultureInfo.InvariantCulture, DateTimeStyles.AdjustToUniversal | DateTimeStyles.AssumeUniversal);
+                return new DateTime(ReadTimestampTicks(ref reader), DateTimeKind.Utc);
+            }
+        }
+
+        private sealed class DateTimeOffsetConverter : MsgPackConverter<DateTimeOffset>
+        {
+            public override void Write(ref MsgPackWriter writer, DateTimeOffset value) => WriteTimestamp(ref writer, value.UtcTicks);
+
+            public override DateTimeOffset Read(ref MsgPackReader reader)
+            {
+                if (IsString(reader.PeekCode()))
+                    return DateTimeOffset.Parse(reader.ReadString()!, CultureInfo.InvariantCulture);
+                return new DateTimeOffset(ReadTimestampTicks(ref reader), TimeSpan.Zero);
+            }
+        }
+
+        private sealed class TimeSpanConverter : MsgPackConverter<TimeSpan>
+        {
+            public override void Write(ref MsgPackWriter writer, TimeSpan value) => writer.WriteInt64(value.Ticks);
+            public override TimeSpan Read(ref MsgPackReader reader) => new TimeSpan(reader.ReadInt64());
+        }
+
+        private sealed class ByteArrayConverter : MsgPackConverter<byte[]>
+        {
+            public override void Write(ref MsgPackWriter writer, byte[] value)
+            {
+                if (value == null)
+                    writer.WriteNil();
+                else
+                    writer.WriteBinary(value);
+            }
+
+            public override byte[] Read(ref MsgPackReader reader)
+            {
+                if (reader.TryReadNil()) return null!;
+
+                // Encoders without a bin type (or JSON bridges) send an array of byte values
+                if (!IsArray(reader.PeekCode()))
+                    return reader.ReadBinary().ToArray();
+
+                var bytes = new byte[reader.ReadArrayHeader()];
+                for (int i = 0; i < bytes.Length; i++)
+                    bytes[i] = checked((byte)reader.ReadInt64());
+                return bytes;
+            }
+        }
+
+        private static void WriteTimestamp(ref MsgPackWriter writer, long ticks)
+        {
+            var sinceEpoch = ticks - DateTime.UnixEpoch.Ticks;
+            var seconds = Math.DivRem(sinceEpoch, TimeSpan.TicksPerSecond, out var remainder);
+            if (remainder < 0)
+            {
+                seconds--;
+                remainder += TimeSpan.TicksPerSecond;
+            }
+            writer.WriteTimestamp(seconds, (uint)(remainder * 100));
+        }
+
+        private static long ReadTimestampTicks(ref MsgPackReader reader)
+        {
+            var (seconds, nanoseconds) = reader.ReadTimestamp();
+            return TimestampTicks(seconds, nanoseconds);
+        }
+
+        private static long TimestampTicks(long seconds, uint nanoseconds)
+        {
+            return DateTime.UnixEpoch.Ticks + seconds * TimeSpan.TicksPerSecond + nanoseconds / 100;
+        }
+
+        private static bool IsString(byte code)
+        {
+            return code is >= MsgPackCode.MinFixStr and <= MsgPackCode.MaxFixStr or MsgPackCode.Str8 or MsgPackCode.Str16 or MsgPackCode.Str32;
+        }
+
+        private static bool IsArray(byte code)
+        {
+            return code is >= MsgPackCode.MinFixArray and <= MsgPackCode.MaxFixArray or MsgPackCode.Array16 or MsgPackCode.Array32;
+        }
+
+        #endregion
+
+        #region Wrappers
+
+        private sealed class NullableConverter<T> : MsgPackConverter<T?> where T : struct
+        {
+            private readonly MsgPackConverter<T> _inner = Get<T>();
+
+            public override void Write(ref MsgPackWriter writer, T? value)
+            {
+                if (value.HasValue)
+                    _inner.Write(ref writer, value.GetValueOrDefault());
+                else
+                    writer.WriteNil();
+            }
+
+            public override T? Read(ref MsgPackReader reader)
+            {
+                return reader.TryReadNil() ? null : _inner.Read(ref reader);
+            }
+        }
+
+        /// <summary>
+        /// Enums as their underlying integer, matching the JSON serializer's default
+        /// </summary>
+        private sealed class EnumConverter<TEnum> : MsgPackConverter<TEnum> where TEnum : struct, Enum
+        {
+            private static readonly Func<TEnum, long> ToInt64 = Convert<TEnum, long>();
+            private static readonly Func<long, TEnum> FromInt64 = Convert<long, TEnum>();
+
+            public override void Write(ref MsgPackWriter writer, TEnum value) => writer.WriteInt64(ToInt64(value));
+
+            public override TEnum Read(ref MsgPackReader reader)
+            {
+                if (IsString(reader.PeekCode()))
+                    return Enum.Parse<TEnum>(reader.ReadString()!, ignoreCase: true);
+                return FromInt64(reader.ReadInt64());
+            }
+
+            private static Func<TFrom, TTo> Convert<TFrom, TTo>()
+            {
+                var value = Expression.Parameter(typeof(TFrom), "value");
+                return Expression.Lambda<Func<TFrom, TTo>>(Expression.Convert(value, typeof(TTo)), value).Compile();
+            }
+        }
+
+        /// <summary>
+        /// Members typed as object: written by their runtime type, read back as the nearest
+        /// general shape (long, double, string, byte[], DateTime, List&lt;object?&gt;, and
+        /// ExpandoObject for maps so dynamic member access works as on parsed JSON)
+        /// </summary>
+        private sealed class DynamicConverter : MsgPackConverter<object>
+        {
+            public override void Write(ref MsgPackWriter writer, object value)
+            {
+                var type = value?.GetType();
+                if (type == null)
+                {
+                    writer.WriteNil();
+                }
+                else if (type == typeof(object))
+                {
+                    writer.WriteMapHeader(0);
+                }
+                else
+                {
+                    if (++writer.Depth > MsgPackSerializer.MaxDepth)
+                        throw new InvalidOperationException($"MsgPackSerializer: object graph nests deeper than {MsgPackSerializer.MaxDepth} levels (is there a reference cycle?)");
+                    Get(type).WriteBoxed(ref writer, value);
+                    writer.Depth--;
+                }
+            }
+
+            public override object Read(ref MsgPackReader reader)
+            {
+                var code = reader.PeekCode();
+                switch (code)
+                {
+                    case MsgPackCode.Nil:
+                        reader.TryReadNil();
+                        return null!;
+                    case MsgPackCode.True or MsgPackCode.False:
+                        return reader.ReadBoolean();
+                    case MsgPackCode.Float32 or MsgPackCode.Float64:
+                        return reader.ReadDouble();
+                    case MsgPackCode.UInt64:
+                        return reader.ReadUInt64();
+                    case <= MsgPackCode.MaxFixInt or >= MsgPackCode.MinNegativeFixInt
+                        or MsgPackCode.UInt8 or MsgPackCode.UInt16 or MsgPackCode.UInt32
+                        or MsgPackCode.Int8 or MsgPackCode.Int16 or MsgPackCode.Int32 or MsgPackCode.Int64:
+                        return reader.ReadInt64();
+                    case MsgPackCode.Bin8 or MsgPackCode.Bin16 or MsgPackCode.Bin32:
+                        return reader.ReadBinary().ToArray();
+                }
+
+                if (IsString(code))
+                    return reader.ReadString()!;
+
+                if (IsArray(code))
+                {
+                    reader.EnterNested();
+                    var count = reader.ReadArrayHeader();
+                    var list = new List<object?>(count);
+                    for (int i = 0; i < count; i++)
+                        list.Add(Read(ref reader));
+                    reader.Depth--;
+                    return list;
+                }
+
+                if (code is (>= MsgPackCode.MinFixMap and <= MsgPackCode.MaxFixMap) or MsgPackCode.Map16 or MsgPackCode.Map32)
+                {
+                    reader.EnterNested();
+                    var count = reader.ReadMapHeader();
+                    IDictionary<string, object?> map = new ExpandoObject();
+                    for (int i = 0; i < count; i++)
+                    {
+                        var key = Read(ref reader);
+                        map[Convert.ToString(key, CultureInfo.InvariantCulture) ?? string.Empty] = Read(ref reader);
+                    }
+                    reader.Depth--;
+                    return map;
+                }
+
+                // Extensions: timestamps are understood, anything else is dropped
+                var body = reader.ReadExtension(out var type);
+                if (type != MsgPackCode.TimestampType)
+                    return null!;
+
+                var (seconds, nanoseconds) = MsgPackReader.DecodeTimestamp(body);
+                return new DateTime(TimestampTicks(seconds, nanoseconds), DateTimeKind.Utc);
+            }
+        }
+
+        #endregion
+
+        #region Containers
+
+        private sealed class ArrayConverter<TElement> : MsgPackConverter<TElement[]>
+        {
+            private readonly MsgPackConverter<TElement> _element = Get<TElement>();
+
+            public override bool HasContainerShape => true;
+
+            public override void Write(ref MsgPackWriter writer, TElement[] value)
+            {
+                if (value == null)
+                {
+                    writer.WriteNil();
+                    return;
+                }
+
+                EnterWrite(ref writer);
+                writer.WriteArrayHeader(value.Length);
+                foreach (var item in value)
+                    _element.Write(ref writer, item);
+                writer.Depth--;
+            }
+
+            public override TElement[] Read(ref MsgPackReader reader)
+            {
+                if (reader.TryReadNil()) return null!;
+
+                reader.EnterNested();
+                var items = new TElement[reader.ReadArrayHeader()];
+                for (int i = 0; i < items.Length; i++)
+                    items[i] = _element.Read(ref reader);
+                reader.Depth--;
+                return items;
+            }
+        }
+
+        /// <summary>
+        /// Lists, sets and other enumerables. Read into a List&lt;T&gt; when the declared type
+        /// accepts one, otherwise into a new instance of the declared collection type.
+        /// </summary>
+        private sealed class CollectionConverter<TCollection, TElement> : MsgPackConverter<TCollection>
+            where TCollection : IEnumerable<TElement>
+        {
+            private readonly MsgPackConverter<TElement> _element = Get<TElement>();
+            private readonly Func<TCollection>? _create = typeof(TCollection).IsAssignableFrom(typeof(List<TElement>))
+                ? null
+                : Constructor<TCollection>();
+
+            public override bool HasContainerShape => true;
+
+            public override void Write(ref MsgPackWriter writer, TCollection value)
+            {
+                if (value == null)
+                {
+                    writer.WriteNil();
+                    return;
+                }
+
+                EnterWrite(ref writer);
+                if (value is List<TElement> list)
+                {
+                    writer.WriteArrayHeader(list.Count);
+                    foreach (var item in list)
+                        _element.Write(ref writer, item);
+                }
+                else
+                {
+                    var items = value as IReadOnlyCollection<TElement> ?? (IReadOnlyCollection<TElement>)value.ToList();
+                    writer.WriteArrayHeader(items.Count);
+                    foreach (var item in items)
+                        _element.Write(ref writer, item);
+                }
+                writer.Depth--;
+            }
+
+            public override TCollection Read(ref MsgPackReader reader)
+            {
+                if (reader.TryReadNil()) return default!;
+
+                reader.EnterNested();
+                var count = reader.ReadArrayHeader();
+                if (_create == null)
+                {
+                    var list = new List<TElement>(count);
+                    for (int i = 0; i < count; i++)
+                        list.Add(_element.Read(ref reader));
+                    reader.Depth--;
+                    return (TCollection)(object)list;
+                }
+
+                var collection = _create();
+                if (collection is not ICollection<TElement> target)
+                    throw new NotSupportedException($"MsgPackSerializer cannot populate {typeof(TCollection).Name}; use a List<{typeof(TElement).Name}> or a collection with Add");
+                for (int i = 0; i < count; i++)
+                    target.Add(_element.Read(ref reader));
+                reader.Depth--;
+                return collection;
+            }
+        }
+
+        private sealed class DictionaryConverter<TDictionary, TKey, TValue> : MsgPackConverter<TDictionary>
+            where TDictionary : IEnumerable<KeyValuePair<TKey, TValue>>
+            where TKey : notnull
+        {
+            private readonly MsgPackConverter<TKey> _key = Get<TKey>();
+            private readonly MsgPackConverter<TValue> _value = Get<TValue>();
+            private readonly Func<TDictionary>? _create = typeof(TDictionary).IsAssignableFrom(typeof(Dictionary<TKey, TValue>))
+                ? null
+                : Constructor<TDictionary>();
+
+            public override bool HasContainerShape => true;
+
+            public override void Write(ref MsgPackWriter writer, TDictionary value)
+            {
+                if (value == null)
+                {
+                    writer.WriteNil();
+                    return;
+                }
+
+                EnterWrite(ref writer);
+                var pairs = value as IReadOnlyCollection<KeyValuePair<TKey, TValue>>
+                    ?? (IReadOnlyCollection<KeyValuePair<TKey, TValue>>)value.ToList();
+                writer.WriteMapHeader(pairs.Count);
+                foreach (var pair in pairs)
+                {
+                    _key.Write(ref writer, pair.Key);
+                    _value.Write(ref writer, pair.Value);
+                }
+                writer.Depth--;
+            }
+
+            public override TDictionary Read(ref MsgPackReader reader)
+            {
+                if (reader.TryReadNil()) return default!;
+
+                reader.EnterNested();
+                var count = reader.ReadMapHeader();
+                IDictionary<TKey, TValue> target;
+                TDictionary result;
+                if (_create == null)
+                {
+                    var dictionary = new Dictionary<TKey, TValue>(count);
+                    target = dictionary;
+                    result = (TDictionary)(object)dictionary;
+                }
+                else
+                {
+                    result = _create();
+                    target = result as IDictionary<TKey, TValue>
+                        ?? throw new NotSupportedException($"MsgPackSerializer cannot populate {typeof(TDictionary).Name}; use a Dictionary<{typeof(TKey).Name}, {typeof(TValue).Name}>");
+                }
+
+                for (int i = 0; i < count; i++)
+                {
+                    var key = _key.Read(ref reader);
+                    target[key] = _value.Read(ref reader);
+                }
+                reader.Depth--;
+                return result;
+            }
+        }
+
+        private static void EnterWrite(ref MsgPackWriter writer)
+        {
+            if (++writer.Depth > MsgPackSerializer.MaxDepth)
+                throw new InvalidOperationException($"MsgPackSerializer: object graph nests deeper than {MsgPackSerializer.MaxDepth} levels (is there a reference cycle?)");
+        }
+
+        private static Func<T> Constructor<T>()
+        {
+            var type = typeof(T);
+            if (type.IsValueType || type.GetConstructor(Type.EmptyTypes) != null)
+                return Expression.Lambda<Func<T>>(Expression.New(type)).Compile();
+
+            // No parameterless constructor (records, immutable types): members are assigned
+            // afterwards, so an uninitialized instance is enough
+            return () => (T)RuntimeHelpers.GetUninitializedObject(type);
+        }
+
+        #endregion
+
+        #region Objects
+
+        /// <summary>
+        /// Classes and structs as a map of member name to value. Members are the public
+        /// read/write properties and fields, minus those marked [JsonIgnore]; a
+        /// [JsonPropertyName] or [JsonProperty] name is used when present. Unknown keys are
+        /// skipped on read and missing ones keep their initial value, so types can evolve.
+        /// </summary>
+        private sealed class ObjectConverter<T> : MsgPackConverter<T>
+        {
+            private readonly Func<T> _create = Constructor<T>();
+            private MemberSlot<T>[]? _members;
+
+            public override bool HasContainerShape => true;
+
+            public override void Write(ref MsgPackWriter writer, T value)
+            {
+                if (value == null)
+                {
+                    writer.WriteNil();
+                    return;
+                }
+
+                var members = _members ?? BuildMembers();
+                EnterWrite(ref writer);
+                writer.WriteMapHeader(members.Length);
+                foreach (var member in members)
+                {
+                    writer.WriteUtf8String(member.Utf8Name);
+                    member.Write(ref writer, value);
+                }
+                writer.Depth--;
+            }
+
+            public override T Read(ref MsgPackReader reader)
+            {
+                if (reader.TryReadNil()) return default!;
+
+                var members = _members ?? BuildMembers();
+                reader.EnterNested();
+                var count = reader.ReadMapHeader();
+                var instance = _create();
+                for (int i = 0; i < count; i++)
+                {
+                    if (!IsString(reader.PeekCode()))
+                    {
+                        reader.Skip();
+                        reader.Skip();
+                        continue;
+                    }
+
+                    var member = Find(members, reader.ReadStringBytes(), i);
+                    if (member != null)
+                        member.Read(ref reader, ref instance);
+                    else
+                        reader.Skip();
+                }
+                reader.Depth--;
+                return instance;
+            }
+
+            /// <summary>
+            /// Keys usually arrive in declaration order, so the expected slot is tried first
+            /// </summary>
+            private static MemberSlot<T>? Find(MemberSlot<T>[] members, ReadOnlySpan<byte> name, int position)
+            {
+                if (position < members.Length && name.SequenceEqual(members[position].Utf8Name))
+                    return members[position];
+
+                foreach (var member in members)
+                {
+                    if (name.SequenceEqual(member.Utf8Name))
+                        return member;
+                }
+
+                // Same rule as the JSON readers: fall back to a case-insensitive match
+                var text = Encoding.UTF8.GetString(name);
+                return members.FirstOrDefault(m => string.Equals(m.Name, text, StringComparison.OrdinalIgnoreCase));
+            }
+
+            private MemberSlot<T>[] BuildMembers()
+            {
+                var type = typeof(T);
+                var candidates = type.GetProperties(BindingFlags.Public | BindingFlags.Instance)
+                    .Where(p => p.GetIndexParameters().Length == 0 && p.GetMethod?.IsPublic == true && p.SetMethod?.IsPublic == true)
+                    .Select(p => (Member: (MemberInfo)p, Type: p.PropertyType))
+                    .Concat(type.GetFields(BindingFlags.Public | BindingFlags.Instance)
+                        .Where(f => !f.IsInitOnly)
+                        .Select(f => (Member: (MemberInfo)f, Type: f.FieldType)));
+
+                var members = new List<MemberSlot<T>>();
+                var names = new HashSet<string>();
+                foreach (var (member, memberType) in candidates)
+                {
+                    if (IsIgnored(member))
+                        continue;
+
+                    // Most derived first: a property hidden with 'new' is written once
+                    var name = SerializedName(member);
+                    if (!names.Add(name))
+                        continue;
+
+                    members.Add((MemberSlot<T>)Activator.CreateInstance(
+                        typeof(MemberSlot<,>).MakeGenericType(type, memberType), member, name)!);
+                }
+
+                var built = members.ToArray();
+                _members = built;
+                return built;
+            }
+
+            private static bool IsIgnored(MemberInfo member)
+            {
+                return member.GetCustomAttributes(inherit: true).Any(a => a.GetType().Name == "JsonIgnoreAttribute");
+            }
+
+            private static string SerializedName(MemberInfo member)
+            {
+                foreach (var attribute in member.GetCustomAttributes(inherit: true))
+                {
+                    var name = attribute.GetType().Name switch
+                    {
+                        "JsonPropertyNameAttribute" => attribute.GetType().GetProperty("Name")?.GetValue(attribute) as string,
+                        "JsonPropertyAttribute" => attribute.GetType().GetProperty("PropertyName")?.GetValue(attribute) as string,
+                        _ => null
+                    };
+                    if (!string.IsNullOrEmpty(name))
+                        return name;
+                }
+                return member.Name;
+            }
+        }
+
+        private abstract class MemberSlot<TOwner>
+        {
+            protected MemberSlot(string name)
+            {
+                Name = name;
+                Utf8Name = Encoding.UTF8.GetBytes(name);
+            }
+
+            public string Name { get; }
+            public byte[] Utf8Name { get; }
+
+            public abstract void Write(ref MsgPackWriter writer, TOwner owner);
+            public abstract void Read(ref MsgPackReader reader, ref TOwner owner);
+        }
+
+        private sealed class MemberSlot<TOwner, TValue> : MemberSlot<TOwner>
+        {
+            private readonly Func<TOwner, TValue> _get;
+            private readonly PropertyAccessors.RefSetter<TOwner, TValue> _set;
+            private MsgPackConverter<TValue>? _converter;
+
+            public MemberSlot(MemberInfo member, string name)
+                : base(name)
+            {
+                _get = PropertyAccessors.ForGetter<TOwner, TValue>(member);
+                _set = PropertyAccessors.ForSetter<TOwner, TValue>(member);
+            }
+
+            // Resolved on first use so self-referencing types do not recurse while the
+            // converter for the owner is still being created
+            private MsgPackConverter<TValue> Converter => _converter ??= Get<TValue>();
+
+            public override void Write(ref MsgPackWriter writer, TOwner owner) => Converter.Write(ref writer, _get(owner));
+
+            public override void Read(ref MsgPackReader reader, ref TOwner owner) => _set(ref owner, Converter.Read(ref reader));
+        }
+
+        #endregion
+    }
+}
@@ -0,0 +1,316 @@
+using System;
+using System.Buffers.Binary;
+using System.IO;
+using System.Text;
+
+namespace AcornDB.Storage.Serialization
+{
+    /// <summary>
+    /// Reads MessagePack values from a span. Integers of any width are accepted wherever a
+    /// number is expected, so payloads written by other MessagePack encoders read back too.
+    /// </summary>
+    internal ref struct MsgPackReader
+    {
+        private readonly ReadOnlySpan<byte> _data;
+        private int _position;
+
+        /// <summary>
+        /// Nesting depth of the value being read (guards against hostile payloads)
+        /// </summary>
+        public int Depth;
+
+        public MsgPackReader(ReadOnlySpan<byte> data)
+        {
+            _data = data;
+            _position = 0;
+            Depth = 0;
+        }
+
+        public bool End => _position >= _data.Length;
+
+        public byte PeekCode()
+        {
+            if (_position >= _data.Length)
+                throw Truncated();
+            return _data[_position];
+        }
+
+        /// <summary>
+        /// Consume a nil if one is next
+        /// </summary>
+        public bool TryReadNil()
+        {
+            if (PeekCode() != MsgPackCode.Nil)
+                return false;
+            _position++;
+            return true;
+        }
+
+        public bool ReadBoolean()
+        {
+            return ReadCode() switch
+            {
+                MsgPackCode.True => true,
+                MsgPackCode.False => false,
+                var code => throw Unexpected(code, "boolean")
+            };
+        }
+
+        public long ReadInt64()
+        {
+            var code = ReadCode();
+            if (code <= MsgPackCode.MaxFixInt) return code;
+            if (code >= MsgPackCode.MinNegativeFixInt) return unchecked((sbyte)code);
+
+            return code switch
+            {
+                MsgPackCode.UInt8 => Take(1)[0],
+                MsgPackCode.UInt16 => BinaryPrimitives.ReadUInt16BigEndian(Take(2)),
+                MsgPackCode.UInt32 => BinaryPrimitives.ReadUInt32BigEndian(Take(4)),
+                MsgPackCode.UInt64 => checked((long)BinaryPrimitives.ReadUInt64BigEndian(Take(8))),
+                MsgPackCode.Int8 => unchecked((sbyte)Take(1)[0]),
+                MsgPackCode.Int16 => BinaryPrimitives.ReadInt16BigEndian(Take(2)),
+                MsgPackCode.Int32 => BinaryPrimitives.ReadInt32BigEndian(Take(4)),
+                MsgPackCode.Int64 => BinaryPrimitives.ReadInt64BigEndian(Take(8)),
+                _ => throw Unexpected(code, "integer")
+            };
+        }
+
+        public ulong ReadUInt64()
+        {
+            if (PeekCode() == MsgPackCode.UInt64)
+            {
+                _position++;
+                return BinaryPrimitives.ReadUInt64BigEndian(Take(8));
+            }
+            return checked((ulong)ReadInt64());
+        }
+
+        public double ReadDouble()
+        {
+            switch (PeekCode())
+            {
+                case MsgPackCode.Float64:
+                    _position++;
+                    return BinaryPrimitives.ReadDoubleBigEndian(Take(8));
+                case MsgPackCode.Float32:
+                    _position++;
+                    return BinaryPrimitives.ReadSingleBigEndian(Take(4));
+                case MsgPackCode.UInt64:
+                    return ReadUInt64();
+                default:
+                    return ReadInt64();
+            }
+        }
+
+        public string? ReadString()
+        {
+            if (TryReadNil()) return null;
+            return Encoding.UTF8.GetString(ReadStringBytes());
+        }
+
+        /// <summary>
+        /// UTF-8 bytes of the next string, without decoding them
+        /// </summary>
+        public ReadOnlySpan<byte> ReadStringBytes()
+        {
+            var code = ReadCode();
+            int length = code switch
+            {
+                >= MsgPackCode.MinFixStr and <= MsgPackCode.MaxFixStr => code & 0x1f,
+                MsgPackCode.Str8 => Take(1)[0],
+                MsgPackCode.Str16 => BinaryPrimitives.ReadUInt16BigEndian(Take(2)),
+                MsgPackCode.Str32 => CheckedLength(BinaryPrimitives.ReadUInt32BigEndian(Take(4))),
+                _ => throw Unexpected(code, "string")
+            };
+            return Take(length);
+        }
+
+        public ReadOnlySpan<byte> ReadBinary()
+        {
+            var code = ReadCode();
+            int length = code switch
+            {
+                MsgPackCode.Bin8 => Take(1)[0],
+                MsgPackCode.Bin16 => BinaryPrimitives.ReadUInt16BigEndian(Take(2)),
+                MsgPackCode.Bin32 => CheckedLength(BinaryPrimitives.ReadUInt32BigEndian(Take(4))),
+                _ => throw Unexpected(code, "binary")
+            };
+            return Take(length);
+        }
+
+        public int ReadArrayHeader()
+        {
+            var code = ReadCode();
+            return code switch
+            {
+                >= MsgPackCode.MinFixArray and <= MsgPackCode.MaxFixArray => code & 0x0f,
+                MsgPackCode.Array16 => BinaryPrimitives.ReadUInt16BigEndian(Take(2)),
+                MsgPackCode.Array32 => CheckedLength(BinaryPrimitives.ReadUInt32BigEndian(Take(4))),
+                _ => throw Unexpected(code, "array")
+            };
+        }
+
+        public int ReadMapHeader()
+        {
+            var code = ReadCode();
+            return code switch
+            {
+                >= MsgPackCode.MinFixMap and <= MsgPackCode.MaxFixMap => code & 0x0f,
+                MsgPackCode.Map16 => BinaryPrimitives.ReadUInt16BigEndian(Take(2)),
+                MsgPackCode.Map32 => CheckedLength(BinaryPrimitives.ReadUInt32BigEndian(Take(4))),
+                _ => throw Unexpected(code, "map")
+            };
+        }
+
+        /// <summary>
+        /// Read a timestamp extension (any of the three widths)
+        /// </summary>
+        public (long Seconds, uint Nanoseconds) ReadTimestamp()
+        {
+            var body = ReadExtension(out var type);
+            if (type != MsgPackCode.TimestampType)
+                throw new InvalidDataException($"Expected a MessagePack timestamp, found extension type {type}");
+
+            return DecodeTimestamp(body);
+        }
+
+        /// <summary>
+        /// Decode the body of a timestamp extension
+        /// </summary>
+        public static (long Seconds, uint Nanoseconds) DecodeTimestamp(ReadOnlySpan<byte> body)
+        {
+            switch (body.Length)
+            {
+                case 4:
+                    return (BinaryPrimitives.ReadUInt32BigEndian(body), 0);
+                case 8:
+                    var packed = BinaryPrimitives.ReadUInt64BigEndian(body);
+                    return ((long)(packed & 0x3_ffff_ffffUL), (uint)(packed >> 34));
+                case 12:
+                    return (BinaryPrimitives.ReadInt64BigEndian(body.Slice(4)), BinaryPrimitives.ReadUInt32BigEndian(body));
+                default:
+                    throw new InvalidDataException($"Invalid MessagePack timestamp length {body.Length}");
+            }
+        }
+
+        public ReadOnlySpan<byte> ReadExtension(out sbyte type)
+        {
+            var code = ReadCode();
+            int length = code switch
+            {
+                MsgPackCode.FixExt1 => 1,
+                MsgPackCode.FixExt2 => 2,
+                MsgPackCode.FixExt4 => 4,
+                MsgPackCode.FixExt8 => 8,
+                MsgPackCode.FixExt16 => 16,
+                MsgPackCode.Ext8 => Take(1)[0],
+                MsgPackCode.Ext16 => BinaryPrimitives.ReadUInt16BigEndian(Take(2)),
+                MsgPackCode.Ext32 => CheckedLength(BinaryPrimitives.ReadUInt32BigEndian(Take(4))),
+                _ => throw Unexpected(code, "extension")
+            };
+            type = unchecked((sbyte)Take(1)[0]);
+            return Take(length);
+        }
+
+        /// <summary>
+        /// Skip the next value, including everything nested in it (unknown members)
+        /// </summary>
+        public void Skip()
+        {
+            var code = PeekCode();
+            switch (code)
+            {
+                case <= MsgPackCode.MaxFixInt:
+                case >= MsgPackCode.MinNegativeFixInt:
+                case MsgPackCode.Nil:
+                case MsgPackCode.True:
+                case MsgPackCode.False:
+                    _position++;
+                    return;
+                case MsgPackCode.UInt8 or MsgPackCode.Int8:
+                    _position += 2;
+                    break;
+                case MsgPackCode.UInt16 or MsgPackCode.Int16:
+                    _position += 3;
+                    break;
+                case MsgPackCode.UInt32 or MsgPackCode.Int32 or MsgPackCode.Float32:
+                    _position += 5;
+                    break;
+                case MsgPackCode.UInt64 or MsgPackCode.Int64 or MsgPackCode.Float64:
+                    _position += 9;
+                    break;
+                case (>= MsgPackCode.MinFixStr and <= MsgPackCode.MaxFixStr) or MsgPackCode.Str8 or MsgPackCode.Str16 or MsgPackCode.Str32:
+                    ReadStringBytes();
+                    return;
+                case MsgPackCode.Bin8 or MsgPackCode.Bin16 or MsgPackCode.Bin32:
+                    ReadBinary();
+                    return;
+                case (>= MsgPackCode.MinFixArray and <= MsgPackCode.MaxFixArray) or MsgPackCode.Array16 or MsgPackCode.Array32:
+                    EnterNested();
+                    for (int count = ReadArrayHeader(); count > 0; count--)
+                        Skip();
+                    Depth--;
+                    return;
+                case (>= MsgPackCode.MinFixMap and <= MsgPackCode.MaxFixMap) or MsgPackCode.Map16 or MsgPackCode.Map32:
+                    EnterNested();
+                    for (int count = ReadMapHeader(); count > 0; count--)
+                    {
+                        Skip();
+                        Skip();
+                    }
+                    Depth--;
+                    return;
+                default:
+                    ReadExtension(out _);
+                    return;
+            }
+
+            if (_position > _data.Length)
+                throw Truncated();
+        }
+
+        /// <summary>
+        /// Track one more level of nesting; throws once the payload nests deeper than any
+        /// document the serializer writes
+        /// </summary>
+        public void EnterNested()
+        {
+            if (++Depth > MsgPackSerializer.MaxDepth)
+                throw new InvalidDataException($"MessagePack payload nests deeper than {MsgPackSerializer.MaxDepth} levels");
+        }
+
+        private byte ReadCode()
+        {
+            if (_position >= _data.Length)
+                throw Truncated();
+            return _data[_position++];
+        }
+
+        private ReadOnlySpan<byte> Take(int count)
+        {
+            if (_data.Length - _position < count)
+                throw Truncated();
+            var slice = _data.Slice(_position, count);
+            _position += count;
+            return slice;
+        }
+
+        private static int CheckedLength(uint length)
+        {
+            if (length > int.MaxValue)
+                throw new InvalidDataException($"MessagePack length {length} is too large");
+            return (int)length;
+        }
+
+        private static InvalidDataException Truncated()
+        {
+            return new InvalidDataException("MessagePack payload is truncated");
+        }
+
+        private static InvalidDataException Unexpected(byte code, string expected)
+        {
+            return new InvalidDataException($"Expected a MessagePack {expected}, found format byte 0x{code:x2}");
+        }
+    }
+}
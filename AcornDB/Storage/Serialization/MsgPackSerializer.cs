@@ -0,0 +1,87 @@
+using System;
+using System.Buffers;
+
+namespace AcornDB.Storage.Serialization
+{
+    /// <summary>
+    /// Compact binary serializer writing MessagePack: objects become maps keyed by member
+    /// name, integers take the fewest bytes that hold them and DateTimes use the standard
+    /// timestamp extension. Any MessagePack reader (including the Rust MsgPackCodec) can decode
+    /// the output, and members can be added or removed without breaking stored documents.
+    ///
+    /// Documents written as JSON before a trunk switched to this serializer are still read:
+    /// a MessagePack map or array never starts with '{', '[' or whitespace, so such payloads
+    /// are handed to the JSON fallback.
+    ///
+    /// The string overloads carry the same bytes as Base64, for trunks that only store text.
+    /// </summary>
+    public class MsgPackSerializer : ISerializer
+    {
+        /// <summary>
+        /// Deepest nesting written or read; deeper graphs are assumed to be reference cycles
+        /// </summary>
+        public const int MaxDepth = 64;
+
+        private readonly ISerializer _jsonFallback;
+
+        /// <param name="jsonFallback">Reads documents stored as JSON. Default: NewtonsoftJsonSerializer</param>
+        public MsgPackSerializer(ISerializer? jsonFallback = null)
+        {
+            _jsonFallback = jsonFallback ?? new NewtonsoftJsonSerializer();
+        }
+
+        public bool IsBinary => true;
+
+        public void Serialize<T>(T obj, IBufferWriter<byte> output)
+        {
+            var writer = new MsgPackWriter(output);
+            MsgPackConverters.Get<T>().Write(ref writer, obj);
+            writer.Flush();
+        }
+
+        public T Deserialize<T>(ReadOnlySpan<byte> data)
+        {
+            var converter = MsgPackConverters.Get<T>();
+            if (converter.HasContainerShape && StartsLikeJson(data))
+                return _jsonFallback.Deserialize<T>(data);
+
+            var reader = new MsgPackReader(data);
+            return converter.Read(ref reader);
+        }
+
+        /// <summary>
+        /// Serialize to a new byte array
+        /// </summary>
+        public byte[] SerializeToBytes<T>(T obj)
+        {
+            var buffer = new ArrayBufferWriter<byte>(256);
+            Serialize(obj, buffer);
+            return buffer.WrittenSpan.ToArray();
+        }
+
+        public string Serialize<T>(T obj)
+        {
+            var buffer = new ArrayBufferWriter<byte>(256);
+            Serialize(obj, buffer);
+            return Convert.ToBase64String(buffer.WrittenSpan);
+        }
+
+        public T Deserialize<T>(string data)
+        {
+            var trimmed = data.AsSpan().TrimStart();
+            if (!trimmed.IsEmpty && (trimmed[0] == '{' || trimmed[0] == '[') && MsgPackConverters.Get<T>().HasContainerShape)
+                return _jsonFallback.Deserialize<T>(data);
+
+            return Deserialize<T>(Convert.FromBase64String(data).AsSpan());
+        }
+
+        private static bool StartsLikeJson(ReadOnlySpan<byte> data)
+        {
+            if (data.IsEmpty)
+                return false;
+
+            // UTF-8 byte order mark, object, array or leading whitespace
+            return data[0] is 0xEF or (byte)'{' or (byte)'[' or (byte)' ' or (byte)'\t' or (byte)'\r' or (byte)'\n';
+        }
+    }
+}
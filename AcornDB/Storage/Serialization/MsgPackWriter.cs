@@ -0,0 +1,328 @@
+using System;
+using System.Buffers;
+using System.Buffers.Binary;
+using System.Text;
+
+namespace AcornDB.Storage.Serialization
+{
+    /// <summary>
+    /// Writes MessagePack values into an IBufferWriter&lt;byte&gt;. Bytes are written into one
+    /// span fetched from the output and committed in a single Advance on <see cref="Flush"/>,
+    /// so small values cost no buffer round trip each.
+    /// </summary>
+    internal ref struct MsgPackWriter
+    {
+        private const int MIN_CHUNK = 4096;
+
+        private readonly IBufferWriter<byte> _output;
+        private Span<byte> _span;
+        private int _buffered;
+
+        /// <summary>
+        /// Nesting depth of the value being written (guards against reference cycles)
+        /// </summary>
+        public int Depth;
+
+        public MsgPackWriter(IBufferWriter<byte> output)
+        {
+            _output = output;
+            _span = default;
+            _buffered = 0;
+            Depth = 0;
+        }
+
+        public void WriteNil() => Reserve(1)[0] = MsgPackCode.Nil;
+
+        public void WriteBoolean(bool value) => Reserve(1)[0] = value ? MsgPackCode.True : MsgPackCode.False;
+
+        public void WriteInt64(long value)
+        {
+            if (value >= 0)
+            {
+                WriteUInt64((ulong)value);
+            }
+            else if (value >= -32)
+            {
+                Reserve(1)[0] = unchecked((byte)value);
+            }
+            else if (value >= sbyte.MinValue)
+            {
+                var span = Reserve(2);
+                span[0] = MsgPackCode.Int8;
+                span[1] = unchecked((byte)value);
+            }
+            else if (value >= short.MinValue)
+            {
+                var span = Reserve(3);
+                span[0] = MsgPackCode.Int16;
+                BinaryPrimitives.WriteInt16BigEndian(span.Slice(1), (short)value);
+            }
+            else if (value >= int.MinValue)
+            {
+                var span = Reserve(5);
+                span[0] = MsgPackCode.Int32;
+                BinaryPrimitives.WriteInt32BigEndian(span.Slice(1), (int)value);
+            }
+            else
+            {
+                var span = Reserve(9);
+                span[0] = MsgPackCode.Int64;
+                BinaryPrimitives.WriteInt64BigEndian(span.Slice(1), value);
+            }
+        }
+
+        public void WriteUInt64(ulong value)
+        {
+            if (value <= MsgPackCode.MaxFixInt)
+            {
+                Reserve(1)[0] = (byte)value;
+            }
+            else if (value <= byte.MaxValue)
+            {
+                var span = Reserve(2);
+                span[0] = MsgPackCode.UInt8;
+                span[1] = (byte)value;
+            }
+            else if (value <= ushort.MaxValue)
+            {
+                var span = Reserve(3);
+                span[0] = MsgPackCode.UInt16;
+                BinaryPrimitives.WriteUInt16BigEndian(span.Slice(1), (ushort)value);
+            }
+            else if (value <= uint.MaxValue)
+            {
+                var span = Reserve(5);
+                span[0] = MsgPackCode.UInt32;
+                BinaryPrimitives.WriteUInt32BigEndian(span.Slice(1), (uint)value);
+            }
+            else
+            {
+                var span = Reserve(9);
+                span[0] = MsgPackCode.UInt64;
+                BinaryPrimitives.WriteUInt64BigEndian(span.Slice(1), value);
+            }
+        }
+
+        public void WriteSingle(float value)
+        {
+            var span = Reserve(5);
+            span[0] = MsgPackCode.Float32;
+            BinaryPrimitives.WriteSingleBigEndian(span.Slice(1), value);
+        }
+
+        public void WriteDouble(double value)
+        {
+            var span = Reserve(9);
+            span[0] = MsgPackCode.Float64;
+            BinaryPrimitives.WriteDoubleBigEndian(span.Slice(1), value);
+        }
+
+        public void WriteString(string? value)
+        {
+            if (value == null)
+            {
+                WriteNil();
+                return;
+            }
+
+            var length = Encoding.UTF8.GetByteCount(value);
+            WriteStringHeader(length);
+            Encoding.UTF8.GetBytes(value, Reserve(length));
+        }
+
+        /// <summary>
+        /// Write a string already encoded as UTF-8 (property names are encoded once per type)
+        /// </summary>
+        public void WriteUtf8String(scoped ReadOnlySpan<byte> utf8)
+        {
+            WriteStringHeader(utf8.Length);
+            utf8.CopyTo(Reserve(utf8.Length));
+        }
+
+        public void WriteBinary(scoped ReadOnlySpan<byte> value)
+        {
+            if (value.Length <= byte.MaxValue)
+            {
+                var span = Reserve(2);
+                span[0] = MsgPackCode.Bin8;
+                span[1] = (byte)value.Length;
+            }
+            else if (value.Length <= ushort.MaxValue)
+            {
+                var span = Reserve(3);
+                span[0] = MsgPackCode.Bin16;
+                BinaryPrimitives.WriteUInt16BigEndian(span.Slice(1), (ushort)value.Length);
+            }
+            else
+            {
+                var span = Reserve(5);
+                span[0] = MsgPackCode.Bin32;
+                BinaryPrimitives.WriteUInt32BigEndian(span.Slice(1), (uint)value.Length);
+            }
+            value.CopyTo(Reserve(value.Length));
+        }
+
+        public void WriteArrayHeader(int count)
+        {
+            WriteHeader(count, MsgPackCode.MinFixArray, 15, MsgPackCode.Array16, MsgPackCode.Array32);
+        }
+
+        public void WriteMapHeader(int count)
+        {
+            WriteHeader(count, MsgPackCode.MinFixMap, 15, MsgPackCode.Map16, MsgPackCode.Map32);
+        }
+
+        /// <summary>
+        /// Timestamp extension (type -1): timestamp32 for whole seconds, timestamp64 while the
+        /// seconds fit in 34 bits, timestamp96 otherwise
+        /// </summary>
+        public void WriteTimestamp(long seconds, uint nanoseconds)
+        {
+            if ((seconds >> 34) == 0)
+            {
+                if (nanoseconds == 0 && seconds <= uint.MaxValue)
+                {
+                    var span = Reserve(6);
+                    span[0] = MsgPackCode.FixExt4;
+                    span[1] = unchecked((byte)MsgPackCode.TimestampType);
+                    BinaryPrimitives.WriteUInt32BigEndian(span.Slice(2), (uint)seconds);
+                }
+                else
+                {
+                    var span = Reserve(10);
+                    span[0] = MsgPackCode.FixExt8;
+                    span[1] = unchecked((byte)MsgPackCode.TimestampType);
+                    BinaryPrimitives.WriteUInt64BigEndian(span.Slice(2), ((ulong)nanoseconds << 34) | (ulong)seconds);
+                }
+            }
+            else
+            {
+                var span = Reserve(15);
+                span[0] = MsgPackCode.Ext8;
+                span[1] = 12;
+                span[2] = unchecked((byte)MsgPackCode.TimestampType);
+                BinaryPrimitives.WriteUInt32BigEndian(span.Slice(3), nanoseconds);
+                BinaryPrimitives.WriteInt64BigEndian(span.Slice(7), seconds);
+            }
+        }
+
+        /// <summary>
+        /// Commit everything written so far to the output
+        /// </summary>
+        public void Flush()
+        {
+            if (_buffered > 0)
+            {
+                _output.Advance(_buffered);
+                _buffered = 0;
+            }
+            _span = default;
+        }
+
+        private void WriteStringHeader(int length)
+        {
+            if (length <= 31)
+            {
+                Reserve(1)[0] = (byte)(MsgPackCode.MinFixStr | length);
+            }
+            else if (length <= byte.MaxValue)
+            {
+                var span = Reserve(2);
+                span[0] = MsgPackCode.Str8;
+                span[1] = (byte)length;
+            }
+            else if (length <= ushort.MaxValue)
+            {
+                var span = Reserve(3);
+                span[0] = MsgPackCode.Str16;
+                BinaryPrimitives.WriteUInt16BigEndian(span.Slice(1), (ushort)length);
+            }
+            else
+            {
+                var span = Reserve(5);
+                span[0] = MsgPackCode.Str32;
+                BinaryPrimitives.WriteUInt32BigEndian(span.Slice(1), (uint)length);
+            }
+        }
+
+        private void WriteHeader(int count, byte fixCode, int fixMax, byte code16, byte code32)
+        {
+            if (count <= fixMax)
+            {
+                Reserve(1)[0] = (byte)(fixCode | count);
+            }
+            else if (count <= ushort.MaxValue)
+            {
+                var span = Reserve(3);
+                span[0] = code16;
+                BinaryPrimitives.WriteUInt16BigEndian(span.Slice(1), (ushort)count);
+            }
+            else
+            {
+                var span = Reserve(5);
+                span[0] = code32;
+                BinaryPrimitives.WriteUInt32BigEndian(span.Slice(1), (uint)count);
+            }
+        }
+
+        private Span<byte> Reserve(int count)
+        {
+            if (_span.Length - _buffered < count)
+            {
+                Flush();
+                _span = _output.GetSpan(Math.Max(count, MIN_CHUNK));
+            }
+
+            var reserved = _span.Slice(_buffered, count);
+            _buffered += count;
+            return reserved;
+        }
+    }
+
+    /// <summary>
+    /// MessagePack format bytes
+    /// </summary>
+    internal static class MsgPackCode
+    {
+        public const byte MaxFixInt = 0x7f;
+        public const byte MinFixMap = 0x80;
+        public const byte MaxFixMap = 0x8f;
+        public const byte MinFixArray = 0x90;
+        public const byte MaxFixArray = 0x9f;
+        public const byte MinFixStr = 0xa0;
+        public const byte MaxFixStr = 0xbf;
+        public const byte Nil = 0xc0;
+        public const byte False = 0xc2;
+        public const byte True = 0xc3;
+        public const byte Bin8 = 0xc4;
+        public const byte Bin16 = 0xc5;
+        public const byte Bin32 = 0xc6;
+        public const byte Ext8 = 0xc7;
+        public const byte Ext16 = 0xc8;
+        public const byte Ext32 = 0xc9;
+        public const byte Float32 = 0xca;
+        public const byte Float64 = 0xcb;
+        public const byte UInt8 = 0xcc;
+        public const byte UInt16 = 0xcd;
+        public const byte UInt32 = 0xce;
+        public const byte UInt64 = 0xcf;
+        public const byte Int8 = 0xd0;
+        public const byte Int16 = 0xd1;
+        public const byte Int32 = 0xd2;
+        public const byte Int64 = 0xd3;
+        public const byte FixExt1 = 0xd4;
+        public const byte FixExt2 = 0xd5;
+        public const byte FixExt4 = 0xd6;
+        public const byte FixExt8 = 0xd7;
+        public const byte FixExt16 = 0xd8;
+        public const byte Str8 = 0xd9;
+        public const byte Str16 = 0xda;
+        public const byte Str32 = 0xdb;
+        public const byte Array16 = 0xdc;
+        public const byte Array32 = 0xdd;
+        public const byte Map16 = 0xde;
+        public const byte Map32 = 0xdf;
+        public const byte MinNegativeFixInt = 0xe0;
+        public const sbyte TimestampType = -1;
+    }
+}
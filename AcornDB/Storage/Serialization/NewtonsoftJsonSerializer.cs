@@ -1,3 +1,5 @@
+using System.Buffers;
+using System.Globalization;
 using Newtonsoft.Json;
 
 namespace AcornDB.Storage.Serialization
@@ -13,5 +15,19 @@ namespace AcornDB.Storage.Serialization
         {
             return JsonConvert.DeserializeObject<T>(data)!;
         }
+
+        /// <summary>
+        /// Same JSON as <see cref="Serialize{T}(T)"/>, encoded into <paramref name="output"/>
+        /// as it is written instead of being built up as a string first
+        /// </summary>
+        public void Serialize<T>(T obj, IBufferWriter<byte> output)
+        {
+            var serializer = JsonSerializer.CreateDefault();
+            serializer.Formatting = Formatting.Indented;
+
+            using var textWriter = new Utf8BufferTextWriter(output, CultureInfo.InvariantCulture);
+            using var jsonWriter = new JsonTextWriter(textWriter) { Formatting = serializer.Formatting };
+            serializer.Serialize(jsonWriter, obj);
+        }
     }
 }
@@ -0,0 +1,88 @@
+using System;
+using System.Buffers;
+using System.Text.Json;
+using System.Text.Json.Serialization;
+using System.Text.Json.Serialization.Metadata;
+
+namespace AcornDB.Storage.Serialization
+{
+    /// <summary>
+    /// Compact JSON through System.Text.Json. Given a source-generated JsonSerializerContext,
+    /// types it covers are written and read by generated code (no reflection, trimming and
+    /// AOT friendly); any other type falls back to reflection metadata.
+    ///
+    /// Property names are matched case-insensitively on read, so documents written by
+    /// NewtonsoftJsonSerializer stay readable.
+    /// </summary>
+    /// <example>
+    /// [JsonSerializable(typeof(Nut&lt;User&gt;))]
+    /// partial class UserJsonContext : JsonSerializerContext { }
+    ///
+    /// var tree = new Acorn&lt;User&gt;().WithSystemTextJson(UserJsonContext.Default).Sprout();
+    /// </example>
+    public class SystemTextJsonSerializer : ISerializer
+    {
+        private readonly JsonSerializerOptions _options;
+
+        /// <param name="context">Source-generated metadata. Default: reflection only</param>
+        public SystemTextJsonSerializer(JsonSerializerContext? context = null)
+            : this(CreateOptions(context))
+        {
+        }
+
+        /// <param name="options">Options to use as given; set TypeInfoResolver for source generation</param>
+        public SystemTextJsonSerializer(JsonSerializerOptions options)
+        {
+            if (options == null)
+                throw new ArgumentNullException(nameof(options));
+
+            if (!options.IsReadOnly)
+            {
+                options.TypeInfoResolver ??= new DefaultJsonTypeInfoResolver();
+                options.MakeReadOnly();
+            }
+            _options = options;
+        }
+
+        public string Serialize<T>(T obj)
+        {
+            return JsonSerializer.Serialize(obj, TypeInfo<T>());
+        }
+
+        public T Deserialize<T>(string data)
+        {
+            return JsonSerializer.Deserialize(data, TypeInfo<T>())!;
+        }
+
+        public void Serialize<T>(T obj, IBufferWriter<byte> output)
+        {
+            using var writer = new Utf8JsonWriter(output);
+            JsonSerializer.Serialize(writer, obj, TypeInfo<T>());
+        }
+
+        public T Deserialize<T>(ReadOnlySpan<byte> utf8)
+        {
+            return JsonSerializer.Deserialize(utf8, TypeInfo<T>())!;
+        }
+
+        private JsonTypeInfo<T> TypeInfo<T>()
+        {
+            // The options cache metadata per type once they are read-only
+            return (JsonTypeInfo<T>)_options.GetTypeInfo(typeof(T));
+        }
+
+        private static JsonSerializerOptions CreateOptions(JsonSerializerContext? context)
+        {
+            var options = new JsonSerializerOptions(JsonSerializerDefaults.General)
+            {
+                PropertyNameCaseInsensitive = true,
+                NumberHandling = JsonNumberHandling.AllowReadingFromString | JsonNumberHandling.AllowNamedFloatingPointLiterals
+            };
+
+            options.TypeInfoResolver = context != null
+                ? JsonTypeInfoResolver.Combine(context, new DefaultJsonTypeInfoResolver())
+                : new DefaultJsonTypeInfoResolver();
+            return options;
+        }
+    }
+}
@@ -0,0 +1,78 @@
+using System;
+using System.Buffers;
+using System.IO;
+using System.Text;
+
+namespace AcornDB.Storage.Serialization
+{
+    /// <summary>
+    /// TextWriter that encodes to UTF-8 straight into an IBufferWriter&lt;byte&gt;, so
+    /// text serializers can fill a pooled buffer without building a string first.
+    /// Surrogate pairs split across writes are carried by the encoder until Flush.
+    /// </summary>
+    internal sealed class Utf8BufferTextWriter : TextWriter
+    {
+        private static readonly UTF8Encoding Utf8NoBom = new(encoderShouldEmitUTF8Identifier: false);
+
+        private readonly IBufferWriter<byte> _output;
+        private readonly Encoder _encoder;
+
+        public Utf8BufferTextWriter(IBufferWriter<byte> output, IFormatProvider formatProvider)
+            : base(formatProvider)
+        {
+            _output = output;
+            _encoder = Utf8NoBom.GetEncoder();
+        }
+
+        public override Encoding Encoding => Utf8NoBom;
+
+        public override void Write(char value)
+        {
+            Write(new ReadOnlySpan<char>(in value));
+        }
+
+        public override void Write(char[] buffer, int index, int count)
+        {
+            Write(buffer.AsSpan(index, count));
+        }
+
+        public override void Write(string? value)
+        {
+            if (value != null)
+                Write(value.AsSpan());
+        }
+
+        public override void Write(ReadOnlySpan<char> buffer)
+        {
+            Encode(buffer, flush: false);
+        }
+
+        public override void Flush()
+        {
+            Encode(ReadOnlySpan<char>.Empty, flush: true);
+        }
+
+        protected override void Dispose(bool disposing)
+        {
+            if (disposing)
+                Flush();
+            base.Dispose(disposing);
+        }
+
+        private void Encode(ReadOnlySpan<char> chars, bool flush)
+        {
+            while (true)
+            {
+                // +4 leaves room for a surrogate pair completed by this call
+                var destination = _output.GetSpan(Utf8NoBom.GetMaxByteCount(Math.Min(chars.Length, 4096)) + 4);
+                _encoder.Convert(chars, destination, flush, out int charsUsed, out int bytesUsed, out bool completed);
+                _output.Advance(bytesUsed);
+                chars = chars.Slice(charsUsed);
+
+                // Without a flush, a trailing high surrogate may stay in the encoder
+                if (chars.IsEmpty && (completed || !flush))
+                    return;
+            }
+        }
+    }
+}
@@ -0,0 +1,190 @@
+using System;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace AcornDB.Storage
+{
+    /// <summary>
+    /// Per-key single-flight loading for the caching trunks. The first caller to miss on a key
+    /// becomes the leader and runs the load; callers that miss on the same key while it is in
+    /// flight wait for the leader's result instead of hitting the slower tier themselves.
+    ///
+    /// The leader publishes its result (populates the caches) before the flight is removed, so
+    /// later readers find it cached. Forget() cancels the publish of a flight that raced a write,
+    /// which keeps a value loaded before the write from being cached after it.
+    /// </summary>
+    internal sealed class SingleFlight<TValue>
+    {
+        private sealed class Flight
+        {
+            public readonly TaskCompletionSource<TValue> Completion = new(TaskCreationOptions.RunContinuationsAsynchronously);
+            public bool Forgotten; // Guarded by lock(this)
+        }
+
+        private readonly ConcurrentDictionary<string, Flight> _flights = new(StringComparer.Ordinal);
+        private long _coalesced;
+        private long _averageLoadTicks; // Moving average of leader load times (Stopwatch ticks)
+
+        /// <summary>
+        /// Callers that waited for another caller's load instead of running their own
+        /// </summary>
+        public long CoalescedCount => Interlocked.Read(ref _coalesced);
+
+        /// <summary>
+        /// Keys being loaded right now
+        /// </summary>
+        public int InFlightCount => _flights.Count;
+
+        /// <summary>
+        /// Moving average of how long a load takes, the recompute cost used by ShouldRefreshEarly
+        /// </summary>
+        public TimeSpan AverageLoadTime =>
+            TimeSpan.FromSeconds((double)Interlocked.Read(ref _averageLoadTicks) / Stopwatch.Frequency);
+
+        /// <summary>
+        /// Load <paramref name="key"/> on the calling thread, or wait for the load already in flight
+        /// </summary>
+        public TValue Run(string key, Func<TValue> load, Action<TValue> publish)
+        {
+            while (true)
+            {
+                if (_flights.TryGetValue(key, out var existing))
+                {
+                    Interlocked.Increment(ref _coalesced);
+                    return existing.Completion.Task.GetAwaiter().GetResult();
+                }
+
+                var flight = new Flight();
+                if (!_flights.TryAdd(key, flight))
+                    continue;
+
+                return Lead(key, flight, load, publish);
+            }
+        }
+
+        /// <summary>
+        /// Load <paramref name="key"/> on the thread pool, or wait for the load already in flight
+        /// </summary>
+        public Task<TValue> RunAsync(string key, Func<TValue> load, Action<TValue> publish)
+        {
+            while (true)
+            {
+                if (_flights.TryGetValue(key, out var existing))
+                {
+                    Interlocked.Increment(ref _coalesced);
+                    return existing.Completion.Task;
+                }
+
+                var flight = new Flight();
+                if (!_flights.TryAdd(key, flight))
+                    continue;
+
+                return Task.Run(() => Lead(key, flight, load, publish));
+            }
+        }
+
+        /// <summary>
+        /// Start a background load of <paramref name="key"/> unless one is already in flight.
+        /// Returns false when a load was already running, so refreshes of a hot key coalesce too.
+        /// </summary>
+        public bool TryRefresh(string key, Func<TValue> load, Action<TValue> publish)
+        {
+            var flight = new Flight();
+            if (!_flights.TryAdd(key, flight))
+                return false;
+
+            _ = Task.Run(() =>
+            {
+                try
+                {
+                    Lead(key, flight, load, publish);
+                }
+                catch
+                {
+                    // A failed refresh leaves the current entry in place; the next miss retries
+                }
+            });
+            return true;
+        }
+
+        /// <summary>
+        /// Stop the in-flight load of <paramref name="key"/> (if any) from publishing its result.
+        /// Call after the new value reaches the backing store and before the caches are updated.
+        /// Callers already waiting still receive the leader's value; new callers start a new load.
+        /// </summary>
+        public void Forget(string key)
+        {
+            if (_flights.TryRemove(key, out var flight))
+            {
+                lock (flight)
+                {
+                    flight.Forgotten = true;
+                }
+            }
+        }
+
+        /// <summary>
+        /// Forget every in-flight load, for bulk changes such as ImportChanges
+        /// </summary>
+        public void ForgetAll()
+        {
+            foreach (var key in _flights.Keys)
+            {
+                Forget(key);
+            }
+        }
+
+        /// <summary>
+        /// Probabilistic early expiration (XFetch): refresh with a probability that rises as the
+        /// entry nears expiry, scaled by how long a load takes. With beta = 1 a key read often is
+        /// refreshed about one load time before it expires, so readers never see the miss; keys
+        /// read rarely are left to expire. Larger beta refreshes earlier, 0 disables.
+        /// </summary>
+        public bool ShouldRefreshEarly(TimeSpan remaining, double beta)
+        {
+            if (beta <= 0)
+                return false;
+            if (remaining <= TimeSpan.Zero)
+                return true;
+
+            var gap = AverageLoadTime.TotalSeconds * beta * -Math.Log(1.0 - Random.Shared.NextDouble());
+            return gap >= remaining.TotalSeconds;
+        }
+
+        private TValue Lead(string key, Flight flight, Func<TValue> load, Action<TValue> publish)
+        {
+            TValue value;
+            try
+            {
+                var started = Stopwatch.GetTimestamp();
+                value = load();
+                RecordLoad(Stopwatch.GetTimestamp() - started);
+
+                lock (flight)
+                {
+                    if (!flight.Forgotten)
+                        publish(value);
+                }
+            }
+            catch (Exception ex)
+            {
+                _flights.TryRemove(new KeyValuePair<string, Flight>(key, flight));
+                flight.Completion.TrySetException(ex);
+                throw;
+            }
+
+            _flights.TryRemove(new KeyValuePair<string, Flight>(key, flight));
+            flight.Completion.TrySetResult(value);
+            return value;
+        }
+
+        private void RecordLoad(long ticks)
+        {
+            var average = Interlocked.Read(ref _averageLoadTicks);
+            Interlocked.Exchange(ref _averageLoadTicks, average == 0 ? ticks : average + (ticks - average) / 8);
+        }
+    }
+}
@@ -0,0 +1,526 @@
+using System;
+using System.Buffers;
+using System.Buffers.Binary;
+using System.Collections.Generic;
+using System.IO;
+using System.IO.MemoryMappedFiles;
+using System.Text;
+using System.Threading;
+
+namespace AcornDB.Storage
+{
+    /// <summary>
+    /// Location of a record's payload in a BTreeTrunk data file.
+    /// A Length of <see cref="TombstoneLength"/> marks an id deleted since the last index run.
+    /// </summary>
+    internal readonly record struct IndexEntry(long Offset, int Length, int Version, long TimestampBinary)
+    {
+        public const int TombstoneLength = -1;
+
+        public bool IsTombstone => Length == TombstoneLength;
+
+        public static IndexEntry Tombstone(long timestampBinary) => new(0, TombstoneLength, 0, timestampBinary);
+    }
+
+    /// <summary>
+    /// Orders ids by their UTF-8 bytes (i.e. by code point), the order a sorted index run is
+    /// written in. Ordinal UTF-16 comparison disagrees with it once surrogate pairs are involved.
+    /// </summary>
+    internal sealed class Utf8KeyComparer : IComparer<string>
+    {
+        public static readonly Utf8KeyComparer Instance = new();
+
+        public int Compare(string? x, string? y)
+        {
+            if (ReferenceEquals(x, y)) return 0;
+            if (x == null) return -1;
+            if (y == null) return 1;
+
+            int length = Math.Min(x.Length, y.Length);
+            for (int i = 0; i < length; i++)
+            {
+                char a = x[i], b = y[i];
+                if (a != b)
+                    return CodePointOrder(a) - CodePointOrder(b);
+            }
+            return x.Length - y.Length;
+        }
+
+        // Surrogates (D800-DFFF) encode code points above FFFF, so they sort after E000-FFFF
+        private static int CodePointOrder(char c) => c >= 0xE000 ? c - 0x800 : c >= 0xD800 ? c + 0x2000 : c;
+    }
+
+    /// <summary>
+    /// An immutable, memory-mapped run of index entries sorted by id, used by BTreeTrunk&lt;T&gt; as
+    /// the bulk of its index. Only a sparse fence table (every <see cref="FenceInterval"/>th entry)
+    /// is consulted to find a key, so resident memory is bounded by what the OS keeps paged in
+    /// rather than by the number of ids.
+    ///
+    /// File format (little-endian):
+    /// [Magic:4][FormatVersion:4][Watermark:8][Count:4]
+    /// Count x [IdLen:4][Id][Offset:8][Length:4][Version:4][Timestamp:8]   (sorted by UTF-8 bytes)
+    /// FenceCount x [EntryPosition:8]
+    /// [FenceTableOffset:8][FenceCount:4][Checksum:8]
+    ///
+    /// The checksum is FNV-1a over everything after the header up to the checksum itself, then the
+    /// header (which is only known once the entries have been streamed out).
+    ///
+    /// The run is reference counted so scans can keep using it after BTreeTrunk swaps in a newer
+    /// one; the mapping is released when the last reader is done.
+    /// </summary>
+    internal sealed class SortedIndexRun
+    {
+        public const int Magic = 0x58494341; // 'ACIX' in hex
+        public const int FormatVersion = 2;
+        public const int FenceInterval = 64;
+
+        private const int HeaderSize = 20;
+        private const int FooterSize = 20;
+        private const int EntryFieldsSize = 24; // Offset, Length, Version, Timestamp
+
+        private readonly MemoryMappedFile _mmf;
+        private readonly MemoryMappedViewAccessor _view;
+        private readonly long _fenceTableOffset;
+        private readonly int _fenceCount;
+        private int _references = 1;
+
+        /// <summary>
+        /// Log position covered by this run: every record before it is reflected here
+        /// </summary>
+        public long Watermark { get; }
+
+        /// <summary>
+        /// Number of live ids in the run
+        /// </summary>
+        public int Count { get; }
+
+        private SortedIndexRun(MemoryMappedFile mmf, MemoryMappedViewAccessor view, long watermark, int count,
+            long fenceTableOffset, int fenceCount)
+        {
+            _mmf = mmf;
+            _view = view;
+            Watermark = watermark;
+            Count = count;
+            _fenceTableOffset = fenceTableOffset;
+            _fenceCount = fenceCount;
+        }
+
+        #region Lifetime
+
+        /// <summary>
+        /// Take a reference for the duration of a read. Fails once the run has been retired.
+        /// </summary>
+        public bool TryAcquire()
+        {
+            while (true)
+            {
+                var current = Volatile.Read(ref _references);
+                if (current <= 0)
+                    return false;
+                if (Interlocked.CompareExchange(ref _references, current + 1, current) == current)
+                    return true;
+            }
+        }
+
+        /// <summary>
+        /// Drop a reference; the owner's Release retires the run
+        /// </summary>
+        public void Release()
+        {
+            if (Interlocked.Decrement(ref _references) == 0)
+            {
+                _view.Dispose();
+                _mmf.Dispose();
+            }
+        }
+
+        #endregion
+
+        #region Writing
+
+        /// <summary>
+        /// Write a run from entries already sorted with <see cref="Utf8KeyComparer"/>.
+        /// The file is written to <paramref name="path"/> and flushed to disk; callers write to a
+        /// temp path and rename it into place so readers never see a partial run.
+        /// </summary>
+        /// <returns>Number of entries written</returns>
+        public static int Write(string path, long watermark, IEnumerable<KeyValuePair<string, IndexEntry>> sortedEntries)
+        {
+            return Write(path, () => watermark, sortedEntries);
+        }
+
+        /// <summary>
+        /// Write a run whose watermark is only known once its entries have been produced
+        /// (e.g. a compaction writing the data file as it goes)
+        /// </summary>
+        public static int Write(string path, Func<long> watermark, IEnumerable<KeyValuePair<string, IndexEntry>> sortedEntries)
+        {
+            using var fs = new FileStream(path, FileMode.Create, FileAccess.ReadWrite, FileShare.None, 64 * 1024);
+            Span<byte> header = stackalloc byte[HeaderSize];
+            Span<byte> fields = stackalloc byte[EntryFieldsSize];
+
+            // The count is patched in once the entries have been streamed out
+            fs.Write(header);
+
+            var fences = new List<long>();
+            var idBuffer = ArrayPool<byte>.Shared.Rent(256);
+            long position = HeaderSize;
+            int count = 0;
+            ulong checksum = FnvOffsetBasis;
+
+            try
+            {
+                foreach (var (id, entry) in sortedEntries)
+                {
+                    if (count % FenceInterval == 0)
+                        fences.Add(position);
+
+                    var idLen = Encoding.UTF8.GetByteCount(id);
+                    if (idLen > idBuffer.Length)
+                    {
+                        ArrayPool<byte>.Shared.Return(idBuffer);
+                        idBuffer = ArrayPool<byte>.Shared.Rent(idLen);
+                    }
+                    Encoding.UTF8.GetBytes(id, 0, id.Length, idBuffer, 0);
+
+                    BinaryPrimitives.WriteInt32LittleEndian(fields, idLen);
+                    Write(fs, fields.Slice(0, 4), ref checksum);
+                    Write(fs, idBuffer.AsSpan(0, idLen), ref checksum);
+
+                    BinaryPrimitives.WriteInt64LittleEndian(fields, entry.Offset);
+                    BinaryPrimitives.WriteInt32LittleEndian(fields.Slice(8), entry.Length);
+                    BinaryPrimitives.WriteInt32LittleEndian(fields.Slice(12), entry.Version);
+                    BinaryPrimitives.WriteInt64LittleEndian(fields.Slice(16), entry.TimestampBinary);
+                    Write(fs, fields, ref checksum);
+
+                    position += 4 + idLen + EntryFieldsSize;
+                    count++;
+                }
+            }
+            finally
+            {
+                ArrayPool<byte>.Shared.Return(idBuffer);
+            }
+
+            var fenceTableOffset = position;
+            foreach (var fence in fences)
+            {
+                BinaryPrimitives.WriteInt64LittleEndian(fields, fence);
+                Write(fs, fields.Slice(0, 8), ref checksum);
+            }
+
+            BinaryPrimitives.WriteInt32LittleEndian(header, Magic);
+            BinaryPrimitives.WriteInt32LittleEndian(header.Slice(4), FormatVersion);
+            BinaryPrimitives.WriteInt64LittleEndian(header.Slice(8), watermark());
+            BinaryPrimitives.WriteInt32LittleEndian(header.Slice(16), count);
+
+            Span<byte> footer = stackalloc byte[FooterSize];
+            BinaryPrimitives.WriteInt64LittleEndian(footer, fenceTableOffset);
+            BinaryPrimitives.WriteInt32LittleEndian(footer.Slice(8), fences.Count);
+            checksum = Fnv(checksum, footer.Slice(0, 12));
+            checksum = Fnv(checksum, header);
+            BinaryPrimitives.WriteUInt64LittleEndian(footer.Slice(12), checksum);
+            fs.Write(footer);
+
+            fs.Position = 0;
+            fs.Write(header);
+            fs.Flush(flushToDisk: true);
+            return count;
+        }
+
+        #endregion
+
+        #region Opening
+
+        /// <summary>
+        /// Map a run file and validate its structure and checksum.
+        /// </summary>
+        /// <returns>The run, or null if the file is missing, from another format, or damaged</returns>
+        public static SortedIndexRun? TryOpen(string path)
+        {
+            if (!File.Exists(path))
+                return null;
+
+            // FileShare.Delete lets a newer run be renamed over this one while it is still mapped
+            var fs = new FileStream(path, FileMode.Open, FileAccess.Read, FileShare.Read | FileShare.Delete);
+            var length = fs.Length;
+            if (length < HeaderSize + FooterSize)
+            {
+                fs.Dispose();
+                return null;
+            }
+
+            var mmf = MemoryMappedFile.CreateFromFile(fs, null, 0, MemoryMappedFileAccess.Read,
+                HandleInheritability.None, leaveOpen: false);
+            var view = mmf.CreateViewAccessor(0, length, MemoryMappedFileAccess.Read);
+
+            try
+            {
+                if (view.ReadInt32(0) != Magic || view.ReadInt32(4) != FormatVersion)
+                    return Reject(mmf, view);
+
+                long watermark = view.ReadInt64(8);
+                int count = view.ReadInt32(16);
+                long fenceTableOffset = view.ReadInt64(length - FooterSize);
+                int fenceCount = view.ReadInt32(length - FooterSize + 8);
+
+                if (watermark < 0 || count < 0
+                    || fenceCount != (count + FenceInterval - 1) / FenceInterval
+                    || fenceTableOffset < HeaderSize
+                    || fenceTableOffset + (long)fenceCount * 8 != length - FooterSize)
+                    return Reject(mmf, view);
+
+                ulong checksum = Checksum(view, HeaderSize, length - HeaderSize - 8, FnvOffsetBasis);
+                checksum = Checksum(view, 0, HeaderSize, checksum);
+                if (checksum != view.ReadUInt64(length - 8))
+                    return Reject(mmf, view);
+
+                var run = new SortedIndexRun(mmf, view, watermark, count, fenceTableOffset, fenceCount);
+                for (int i = 0; i < fenceCount; i++)
+                {
+                    var fence = run.FencePosition(i);
+                    if (fence < HeaderSize || fence >= fenceTableOffset)
+                        return Reject(mmf, view);
+                }
+                return run;
+            }
+            catch
+            {
+                view.Dispose();
+                mmf.Dispose();
+                throw;
+            }
+        }
+
+        private static SortedIndexRun? Reject(MemoryMappedFile mmf, MemoryMappedViewAccessor view)
+        {
+            view.Dispose();
+            mmf.Dispose();
+            return null;
+        }
+
+        #endregion
+
+        #region Reading
+
+        /// <summary>
+        /// Find an id's entry: binary search over the fences, then a scan of at most one fence
+        /// interval of entries.
+        /// </summary>
+        public bool TryGet(string id, out IndexEntry entry)
+        {
+            entry = default;
+            if (Count == 0)
+                return false;
+
+            var target = Encode(id, out var rented);
+            var key = ArrayPool<byte>.Shared.Rent(Math.Max(256, target.Length));
+            try
+            {
+                long position = SeekFence(target, ref key);
+                if (position < 0)
+                    return false;
+
+                for (int i = 0; i < FenceInterval && position < _fenceTableOffset; i++)
+                {
+                    int idLen = ReadKey(position, ref key);
+                    int order = key.AsSpan(0, idLen).SequenceCompareTo(target);
+                    if (order == 0)
+                    {
+                        entry = ReadFields(position + 4 + idLen);
+                        return true;
+                    }
+                    if (order > 0)
+                        return false;
+
+                    position += 4 + idLen + EntryFieldsSize;
+                }
+                return false;
+            }
+            finally
+            {
+                ArrayPool<byte>.Shared.Return(key);
+                if (rented != null)
+                    ArrayPool<byte>.Shared.Return(rented);
+            }
+        }
+
+        /// <summary>
+        /// Entries in key order, starting at <paramref name="fromInclusive"/> (null = first) and
+        /// stopping before <paramref name="toExclusive"/> (null = last). The caller must hold a
+        /// reference (<see cref="TryAcquire"/>) until enumeration finishes.
+        /// </summary>
+        public IEnumerable<KeyValuePair<string, IndexEntry>> Scan(string? fromInclusive, string? toExclusive)
+        {
+            if (Count == 0)
+                yield break;
+
+            var key = ArrayPool<byte>.Shared.Rent(256);
+            byte[]? upper = toExclusive != null ? Encoding.UTF8.GetBytes(toExclusive) : null;
+
+            try
+            {
+                long position = HeaderSize;
+                byte[]? lower = fromInclusive != null ? Encoding.UTF8.GetBytes(fromInclusive) : null;
+                if (lower != null)
+                    position = Math.Max(HeaderSize, SeekFence(lower, ref key));
+
+                while (position < _fenceTableOffset)
+                {
+                    int idLen = ReadKey(position, ref key);
+
+                    if (lower != null && Order(key, idLen, lower) < 0)
+                    {
+                        position += 4 + idLen + EntryFieldsSize;
+                        continue;
+                    }
+                    if (upper != null && Order(key, idLen, upper) >= 0)
+                        yield break;
+
+                    var id = Encoding.UTF8.GetString(key, 0, idLen);
+                    var entry = ReadFields(position + 4 + idLen);
+                    position += 4 + idLen + EntryFieldsSize;
+
+                    yield return new KeyValuePair<string, IndexEntry>(id, entry);
+                }
+            }
+            finally
+            {
+                ArrayPool<byte>.Shared.Return(key);
+            }
+        }
+
+        /// <summary>
+        /// The first and last entries, used to check that the run still matches its data file
+        /// </summary>
+        public IEnumerable<KeyValuePair<string, IndexEntry>> Boundaries()
+        {
+            if (Count == 0)
+                yield break;
+
+            var key = ArrayPool<byte>.Shared.Rent(256);
+            try
+            {
+                long position = HeaderSize;
+                int idLen = ReadKey(position, ref key);
+                yield return new(Encoding.UTF8.GetString(key, 0, idLen), ReadFields(position + 4 + idLen));
+
+                // Walk the last fence interval to its end
+                position = FencePosition(_fenceCount - 1);
+                long last = position;
+                while (position < _fenceTableOffset)
+                {
+                    last = position;
+                    position += 4 + ReadKey(position, ref key) + EntryFieldsSize;
+                }
+
+                idLen = ReadKey(last, ref key);
+                yield return new(Encoding.UTF8.GetString(key, 0, idLen), ReadFields(last + 4 + idLen));
+            }
+            finally
+            {
+                ArrayPool<byte>.Shared.Return(key);
+            }
+        }
+
+        /// <summary>
+        /// Position of the last fenced entry whose key is &lt;= target, or -1 if target precedes them all
+        /// </summary>
+        private long SeekFence(ReadOnlySpan<byte> target, ref byte[] key)
+        {
+            int lo = 0, hi = _fenceCount - 1, found = -1;
+            while (lo <= hi)
+            {
+                int mid = lo + (hi - lo) / 2;
+                int idLen = ReadKey(FencePosition(mid), ref key);
+                if (key.AsSpan(0, idLen).SequenceCompareTo(target) <= 0)
+                {
+                    found = mid;
+                    lo = mid + 1;
+                }
+                else
+                {
+                    hi = mid - 1;
+                }
+            }
+            return found < 0 ? -1 : FencePosition(found);
+        }
+
+        private static int Order(byte[] key, int length, byte[] other) => key.AsSpan(0, length).SequenceCompareTo(other);
+
+        private long FencePosition(int fence) => _view.ReadInt64(_fenceTableOffset + (long)fence * 8);
+
+        private int ReadKey(long position, ref byte[] key)
+        {
+            int idLen = _view.ReadInt32(position);
+            if (idLen <= 0 || position + 4 + idLen + EntryFieldsSize > _fenceTableOffset)
+                throw new InvalidDataException($"Corrupt index run entry at {position}");
+
+            if (idLen > key.Length)
+            {
+                ArrayPool<byte>.Shared.Return(key);
+                key = ArrayPool<byte>.Shared.Rent(idLen);
+            }
+            _view.ReadArray(position + 4, key, 0, idLen);
+            return idLen;
+        }
+
+        private IndexEntry ReadFields(long position) => new(
+            _view.ReadInt64(position),
+            _view.ReadInt32(position + 8),
+            _view.ReadInt32(position + 12),
+            _view.ReadInt64(position + 16));
+
+        private static ReadOnlySpan<byte> Encode(string id, out byte[]? rented)
+        {
+            rented = ArrayPool<byte>.Shared.Rent(Encoding.UTF8.GetMaxByteCount(id.Length));
+            int length = Encoding.UTF8.GetBytes(id, 0, id.Length, rented, 0);
+            return rented.AsSpan(0, length);
+        }
+
+        #endregion
+
+        #region Checksum (FNV-1a 64)
+
+        private const ulong FnvOffsetBasis = 14695981039346656037UL;
+        private const ulong FnvPrime = 1099511628211UL;
+
+        private static void Write(Stream stream, ReadOnlySpan<byte> bytes, ref ulong checksum)
+        {
+            stream.Write(bytes);
+            checksum = Fnv(checksum, bytes);
+        }
+
+        private static ulong Fnv(ulong hash, ReadOnlySpan<byte> bytes)
+        {
+            foreach (var b in bytes)
+            {
+                hash ^= b;
+                hash *= FnvPrime;
+            }
+            return hash;
+        }
+
+        private static ulong Checksum(MemoryMappedViewAccessor view, long start, long length, ulong hash)
+        {
+            var chunk = ArrayPool<byte>.Shared.Rent(64 * 1024);
+            try
+            {
+                for (long done = 0; done < length;)
+                {
+                    int count = (int)Math.Min(chunk.Length, length - done);
+                    view.ReadArray(start + done, chunk, 0, count);
+                    hash = Fnv(hash, chunk.AsSpan(0, count));
+                    done += count;
+                }
+            }
+            finally
+            {
+                ArrayPool<byte>.Shared.Return(chunk);
+            }
+            return hash;
+        }
+
+        #endregion
+    }
+}
@@ -1,10 +1,13 @@
 using System;
+using System.Buffers;
 using AcornDB.Logging;
 using System.Collections.Generic;
+using System.Diagnostics;
 using System.Linq;
 using System.Text;
 using System.Threading;
 using System.Threading.Tasks;
+using AcornDB.Metrics;
 using AcornDB.Policy;
 using AcornDB.Storage.Serialization;
 
@@ -43,15 +46,25 @@ namespace AcornDB.Storage
         protected readonly object _rootsLock = new();
 
         /// <summary>
-        /// Serializer for JSON serialization/deserialization
+        /// Serializer for document encoding (JSON by default)
         /// </summary>
         protected readonly ISerializer _serializer;
 
+        /// <summary>
+        /// Serializer documents are encoded with before the IRoot chain sees them
+        /// </summary>
+        public ISerializer Serializer => _serializer;
+
         /// <summary>
         /// Disposal flag to prevent double-disposal
         /// </summary>
         protected bool _disposed;
 
+        // Latency histograms, resolved on first use: Capabilities is not ready during construction
+        private LatencyHistogram? _rootStashLatency;
+        private LatencyHistogram? _rootCrackLatency;
+        private LatencyHistogram? _flushLatency;
+
         // Optional write batching infrastructure (null if batching disabled)
         private readonly List<PendingWrite>? _writeBuffer;
         private readonly SemaphoreSlim? _writeLock;
@@ -59,6 +72,21 @@ namespace AcornDB.Storage
         private readonly int _batchThreshold;
         private readonly int _flushIntervalMs;
 
+        // Group commit state (guarded by the _writeBuffer lock unless noted)
+        private readonly SemaphoreSlim? _groupFilled; // Released when a held-open group is full
+        private TaskCompletionSource _pendingGroup = NewGroup(); // Completes when the buffered writes commit
+        private bool _committing;
+        private int _arrivedDuringCommit;
+        private int _groupTarget = 1;
+        private int _lastGroupSize;
+        private long _commits;
+        private long _writesCommitted;
+        private long _diskFlushes;
+        private double _diskFlushLatencyMs;
+
+        private const int INITIAL_PAYLOAD_CAPACITY = 1024; // Pooled serialization buffer; grows as needed
+        private const int DEFAULT_MAX_GROUP_COMMIT_DELAY_MS = 2;
+
         /// <summary>
         /// Represents a write operation pending in the batch buffer.
         /// Contains pre-processed data (already through IRoot pipeline).
@@ -96,6 +124,7 @@ namespace AcornDB.Storage
             {
                 _writeBuffer = new List<PendingWrite>(batchThreshold);
                 _writeLock = new SemaphoreSlim(1, 1);
+                _groupFilled = new SemaphoreSlim(0);
 
                 // Auto-flush timer for write batching
                 _flushTimer = new Timer(async _ =>
@@ -189,6 +218,7 @@ namespace AcornDB.Storage
                 DocumentId = documentId
             };
 
+            var started = Stopwatch.GetTimestamp();
             var processedBytes = data;
             lock (_rootsLock)
             {
@@ -198,6 +228,7 @@ namespace AcornDB.Storage
                 }
             }
 
+            Latency(ref _rootStashLatency, LatencyOperations.RootStash).RecordSince(started);
             return processedBytes;
         }
 
@@ -219,6 +250,7 @@ namespace AcornDB.Storage
                 DocumentId = documentId
             };
 
+            var started = Stopwatch.GetTimestamp();
             var processedBytes = data;
             lock (_rootsLock)
             {
@@ -229,9 +261,119 @@ namespace AcornDB.Storage
                 }
             }
 
+            Latency(ref _rootCrackLatency, LatencyOperations.RootCrack).RecordSince(started);
             return processedBytes;
         }
 
+        /// <summary>
+        /// Serialize a nut straight into a pooled buffer and run it through the IRoot
+        /// chain in ascending order. Each root writes into a reused buffer through the span
+        /// overload of OnStash, so no stage allocates a byte[] of its own.
+        /// </summary>
+        /// <param name="nut">Nut to serialize</param>
+        /// <param name="documentId">Document ID for context</param>
+        /// <returns>Processed bytes; the caller owns the buffer and must dispose it</returns>
+        protected PooledBufferWriter SerializeThroughRoots(Nut<T> nut, string documentId)
+        {
+            var current = new PooledBufferWriter(INITIAL_PAYLOAD_CAPACITY);
+            try
+            {
+                _serializer.Serialize(nut, current);
+            }
+            catch
+            {
+                current.Dispose();
+                throw;
+            }
+
+            if (_roots.Count == 0) return current;
+
+            var context = new RootProcessingContext
+            {
+                PolicyContext = new PolicyContext { Operation = "Write" },
+                DocumentId = documentId
+            };
+
+            // Two buffers are enough: each stage reads one and writes the other
+            var started = Stopwatch.GetTimestamp();
+            var spare = new PooledBufferWriter(current.WrittenCount);
+            try
+            {
+                lock (_rootsLock)
+                {
+                    foreach (var root in _roots)
+                    {
+                        spare.Clear();
+                        root.OnStash(current.WrittenSpan, spare, context);
+                        (current, spare) = (spare, current);
+                    }
+                }
+                Latency(ref _rootStashLatency, LatencyOperations.RootStash).RecordSince(started);
+            }
+            catch
+            {
+                current.Dispose();
+                throw;
+            }
+            finally
+            {
+                spare.Dispose();
+            }
+
+            return current;
+        }
+
+        /// <summary>
+        /// Span overload of <see cref="ProcessThroughRootsDescending(byte[], string)"/> that
+        /// writes the restored bytes into a pooled buffer
+        /// </summary>
+        /// <param name="data">Input bytes (from storage)</param>
+        /// <param name="documentId">Document ID for context</param>
+        /// <returns>Processed bytes; the caller owns the buffer and must dispose it</returns>
+        protected PooledBufferWriter ProcessThroughRootsDescending(ReadOnlySpan<byte> data, string documentId)
+        {
+            var current = new PooledBufferWriter(data.Length);
+            if (_roots.Count == 0)
+            {
+                current.Write(data);
+                return current;
+            }
+
+            var context = new RootProcessingContext
+            {
+                PolicyContext = new PolicyContext { Operation = "Read" },
+                DocumentId = documentId
+            };
+
+            var started = Stopwatch.GetTimestamp();
+            var spare = new PooledBufferWriter(data.Length);
+            try
+            {
+                lock (_rootsLock)
+                {
+                    // Reverse iteration for read path; the first stage reads the stored bytes as-is
+                    for (int i = _roots.Count - 1; i >= 0; i--)
+                    {
+                        spare.Clear();
+                        _roots[i].OnCrack(i == _roots.Count - 1 ? data : current.WrittenSpan, spare, context);
+                        (current, spare) = (spare, current);
+                    }
+                }
+                Latency(ref _rootCrackLatency, LatencyOperations.RootCrack).RecordSince(started);
+            }
+            catch
+            {
+                current.Dispose();
+                throw;
+            }
+            finally
+            {
+                spare.Dispose();
+            }
+
+            return current;
+        }
+
         /// <summary>
         /// Helper to detect if data needs Base64 decoding (backward compatibility).
         /// Tries to decode as Base64, falls back to treating as plain UTF8.
@@ -270,28 +412,86 @@ namespace AcornDB.Storage
 
         #region Write Batching Support (OPTIONAL - Available to Derived Classes)
 
+        /// <summary>
+        /// When a stash counts as committed (see <see cref="DurabilityMode"/>).
+        /// Applies to trunks that write through StashWithBatchingAsync. Default: Buffered
+        /// </summary>
+        public DurabilityMode Durability { get; set; } = DurabilityMode.Buffered;
+
+        /// <summary>
+        /// Longest a group commit waits for more writers to join before forcing its batch to
+        /// disk. The actual wait follows the observed flush latency and is skipped entirely
+        /// when writes arrive one at a time. Default: 2ms
+        /// </summary>
+        public TimeSpan MaxGroupCommitDelay { get; set; } = TimeSpan.FromMilliseconds(DEFAULT_MAX_GROUP_COMMIT_DELAY_MS);
+
+        /// <summary>
+        /// Stash a nut and complete once it is committed under the current
+        /// <see cref="Durability"/> mode. Trunks without batching stash synchronously.
+        /// </summary>
+        public virtual Task StashAsync(string id, Nut<T> nut)
+        {
+            Stash(id, nut);
+            return Task.CompletedTask;
+        }
+
+        /// <summary>
+        /// Get commit statistics (all zero for trunks without batching)
+        /// </summary>
+        public DurabilityStats GetDurabilityStats()
+        {
+            long commits = Interlocked.Read(ref _commits);
+            long writes = Interlocked.Read(ref _writesCommitted);
+
+            return new DurabilityStats
+            {
+                Mode = Durability,
+                Commits = commits,
+                DiskFlushes = Interlocked.Read(ref _diskFlushes),
+                WritesCommitted = writes,
+                AverageGroupSize = commits > 0 ? (double)writes / commits : 0,
+                LastGroupSize = Volatile.Read(ref _lastGroupSize),
+                GroupTarget = Volatile.Read(ref _groupTarget),
+                DiskFlushLatencyMs = Volatile.Read(ref _diskFlushLatencyMs)
+            };
+        }
+
         /// <summary>
         /// Helper for derived classes to stash with batching support.
         /// Processes through IRoot pipeline, then either batches or writes immediately.
+        /// The returned task completes when the write is committed under <see cref="Durability"/>.
         /// </summary>
         /// <param name="id">Document ID</param>
         /// <param name="nut">Nut to stash</param>
         protected async Task StashWithBatchingAsync(string id, Nut<T> nut)
         {
-            // Process through IRoot pipeline first
-            var json = _serializer.Serialize(nut);
-            var bytes = Encoding.UTF8.GetBytes(json);
-            var processedBytes = ProcessThroughRootsAscending(bytes, id);
+            // Process through IRoot pipeline first. The pooled stages are copied out once,
+            // since the batch buffer holds on to the bytes past this call.
+            byte[] processedBytes;
+            using (var processed = SerializeThroughRoots(nut, id))
+            {
+                processedBytes = processed.ToArray();
+            }
+
+            var mode = Durability;
 
             if (_writeBuffer == null)
             {
                 // No batching enabled - write immediately
                 await WriteToStorageAsync(id, processedBytes, nut.Timestamp, nut.Version);
+                if (mode >= DurabilityMode.GroupCommit)
+                {
+                    var started = Stopwatch.GetTimestamp();
+                    FlushToDisk();
+                    Latency(ref _flushLatency, LatencyOperations.Flush).RecordSince(started);
+                }
                 return;
             }
 
-            // Add to batch buffer
-            bool shouldFlush = false;
+            // Add to batch buffer. Every write joins the group that the next commit will take.
+            bool shouldFlush;
+            bool groupFilled;
+            Task committed;
             lock (_writeBuffer)
             {
                 _writeBuffer.Add(new PendingWrite
@@ -302,44 +502,101 @@ namespace AcornDB.Storage
                     Version = nut.Version
                 });
 
-                // Check if buffer reached threshold
-                if (_writeBuffer.Count >= _batchThreshold)
-                {
-                    shouldFlush = true;
-                }
+                if (_committing)
+                    _arrivedDuringCommit++;
+
+                committed = _pendingGroup.Task;
+                shouldFlush = _writeBuffer.Count >= _batchThreshold;
+                groupFilled = _writeBuffer.Count == _groupTarget;
             }
 
-            // Flush outside the lock to avoid contention
-            if (shouldFlush)
+            switch (mode)
             {
-                await FlushBatchAsync();
+                case DurabilityMode.None:
+                case DurabilityMode.Buffered:
+                    // Flush outside the lock to avoid contention
+                    if (shouldFlush)
+                        await FlushBatchAsync();
+                    return;
+
+                case DurabilityMode.GroupCommit:
+                    // Wake a committer that is holding the group open for more writers
+                    if (groupFilled || shouldFlush)
+                        _groupFilled!.Release();
+                    await CommitAsync(forceToDisk: true, waitForGroup: true);
+                    break;
+
+                default:
+                    await CommitAsync(forceToDisk: true, waitForGroup: false);
+                    break;
             }
+
+            // Another writer's commit may have taken this write; its outcome is ours
+            await committed;
         }
 
         /// <summary>
         /// Flush all pending writes to storage.
         /// Called automatically by timer or when batch threshold is reached.
         /// Can also be called explicitly by derived classes.
+        /// Forces the batch to disk unless <see cref="Durability"/> is None.
         /// </summary>
-        protected async Task FlushBatchAsync()
+        protected Task FlushBatchAsync()
         {
-            if (_writeBuffer == null || _writeLock == null) return;
-
-            List<PendingWrite> toWrite;
+            return CommitAsync(forceToDisk: Durability != DurabilityMode.None, waitForGroup: false);
+        }
 
-            // Copy buffer and clear under lock
-            lock (_writeBuffer)
-            {
-                if (_writeBuffer.Count == 0) return;
-                toWrite = new List<PendingWrite>(_writeBuffer);
-                _writeBuffer.Clear();
-            }
+        /// <summary>
+        /// Write the pending batch and, if asked, force it to disk, then complete the write
+        /// group it belongs to. The buffer is taken only once the write lock is held, so
+        /// writes arriving while the previous batch is flushing all go out together next.
+        /// </summary>
+        private async Task CommitAsync(bool forceToDisk, bool waitForGroup)
+        {
+            if (_writeBuffer == null || _writeLock == null) return;
 
-            // Write outside the lock
             await _writeLock.WaitAsync();
             try
             {
-                await WriteBatchToStorageAsync(toWrite);
+                if (waitForGroup)
+                    await WaitForGroupAsync();
+
+                List<PendingWrite> toWrite;
+                TaskCompletionSource group;
+
+                // Copy buffer and clear under lock
+                lock (_writeBuffer)
+                {
+                    if (_writeBuffer.Count == 0) return;
+                    toWrite = new List<PendingWrite>(_writeBuffer);
+                    _writeBuffer.Clear();
+
+                    group = _pendingGroup;
+                    _pendingGroup = NewGroup();
+                    _committing = true;
+                    _arrivedDuringCommit = 0;
+                }
+
+                try
+                {
+                    await WriteBatchToStorageAsync(toWrite);
+
+                    if (forceToDisk)
+                    {
+                        var started = Stopwatch.GetTimestamp();
+                        FlushToDisk();
+                        RecordDiskFlush(Stopwatch.GetElapsedTime(started).TotalMilliseconds);
+                    }
+                }
+                catch (Exception ex)
+                {
+                    EndCommit(toWrite.Count);
+                    group.TrySetException(ex);
+                    throw;
+                }
+
+                EndCommit(toWrite.Count);
+                group.TrySetResult();
             }
             finally
             {
@@ -347,6 +604,58 @@ namespace AcornDB.Storage
             }
         }
 
+        /// <summary>
+        /// Hold a group commit open until enough writers have joined: as many as arrived during
+        /// the previous flush, for at most that flush's latency (capped by MaxGroupCommitDelay).
+        /// Slow disks therefore get larger groups, and a lone writer never waits.
+        /// </summary>
+        private async Task WaitForGroupAsync()
+        {
+            int target;
+            lock (_writeBuffer!)
+            {
+                target = _groupTarget;
+                if (target <= 1 || _writeBuffer.Count >= target) return;
+            }
+
+            var delay = Math.Min(Volatile.Read(ref _diskFlushLatencyMs), MaxGroupCommitDelay.TotalMilliseconds);
+            if (delay > 0)
+                await _groupFilled!.WaitAsync(TimeSpan.FromMilliseconds(delay));
+
+            // Signals from writers that joined in the meantime belong to this group
+            while (_groupFilled!.CurrentCount > 0 && _groupFilled.Wait(0)) { }
+        }
+
+        private void EndCommit(int groupSize)
+        {
+            lock (_writeBuffer!)
+            {
+                _committing = false;
+                _groupTarget = Math.Clamp(_arrivedDuringCommit, 1, _batchThreshold);
+            }
+
+            Interlocked.Increment(ref _commits);
+            Interlocked.Add(ref _writesCommitted, groupSize);
+            Volatile.Write(ref _lastGroupSize, groupSize);
+        }
+
+        private void RecordDiskFlush(double latencyMs)
+        {
+            Interlocked.Increment(ref _diskFlushes);
+            Latency(ref _flushLatency, LatencyOperations.Flush).Record(latencyMs);
+
+            // Exponentially weighted, so one slow flush does not set the group size for long
+            var previous = Volatile.Read(ref _diskFlushLatencyMs);
+            Volatile.Write(ref _diskFlushLatencyMs, previous == 0 ? latencyMs : previous * 0.8 + latencyMs * 0.2);
+        }
+
+        private LatencyHistogram Latency(ref LatencyHistogram? slot, string operation)
+        {
+            return slot ??= MetricsCollector.Instance.GetLatencyHistogram(operation, trunk: Capabilities.TrunkType);
+        }
+
+        private static TaskCompletionSource NewGroup() => new(TaskCreationOptions.RunContinuationsAsynchronously);
+
         /// <summary>
         /// Check if write batching is enabled for this trunk
         /// </summary>
@@ -386,6 +695,15 @@ namespace AcornDB.Storage
                 "Override this method to support immediate writes.");
         }
 
+        /// <summary>
+        /// Force written data to stable storage. Called after a batch is written, according to
+        /// <see cref="Durability"/>; WriteToStorageAsync/WriteBatchToStorageAsync should not
+        /// flush on their own. Default: no-op (for stores whose writes are durable when they return).
+        /// </summary>
+        protected virtual void FlushToDisk()
+        {
+        }
+
         /// <summary>
         /// Write a batch of items to storage (used when batching is enabled).
         /// Override this if your trunk uses StashWithBatchingAsync.
@@ -506,6 +824,7 @@ namespace AcornDB.Storage
 
             // Dispose synchronization primitives
             _writeLock?.Dispose();
+            _groupFilled?.Dispose();
 
             // Derived classes should override and add their own cleanup
             // e.g., close connections, dispose file streams, etc.
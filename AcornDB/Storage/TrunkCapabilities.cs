@@ -12,6 +12,9 @@ namespace AcornDB.Storage
         public bool SupportsNativeIndexes { get; init; }
         public bool SupportsFullTextSearch { get; init; }
         public bool SupportsComputedIndexes { get; init; }
+        public bool SupportsOrderedScans { get; init; }
+        public bool SupportsScanPushdown { get; init; }
+        public bool SupportsNativeQueries { get; init; }
         public string TrunkType { get; init; } = "Unknown";
     }
 }
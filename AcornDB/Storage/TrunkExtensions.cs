@@ -63,7 +63,7 @@ namespace AcornDB.Storage
         /// <param name="policyEngine">Policy engine to use for validation</param>
         /// <param name="sequence">Processing sequence (default: 10, runs early)</param>
         /// <param name="options">Policy enforcement options</param>
-        /// <param name="serializer">Optional serializer for policy validation</param>
+        /// <param name="serializer">Serializer for policy validation (default: the trunk's own)</param>
         /// <returns>The trunk for method chaining</returns>
         public static ITrunk<T> WithPolicyEnforcement<T>(
             this ITrunk<T> trunk,
@@ -75,6 +75,8 @@ namespace AcornDB.Storage
             if (trunk == null) throw new ArgumentNullException(nameof(trunk));
             if (policyEngine == null) throw new ArgumentNullException(nameof(policyEngine));
 
+            // Documents reach the root in the trunk's own encoding
+            serializer ??= trunk.GetType().GetProperty(nameof(TrunkBase<object>.Serializer))?.GetValue(trunk) as ISerializer;
             trunk.AddRoot(new PolicyEnforcementRoot(policyEngine, serializer, sequence, options));
             return trunk;
         }
@@ -0,0 +1,136 @@
+using System.Linq.Expressions;
+
+namespace AcornDB.Storage;
+
+/// <summary>
+/// Conditions a query hands to an IScanTrunk&lt;T&gt;. Unset bounds leave that side open. The
+/// range checks are exposed so trunks can test their own statistics (file, row group or page
+/// min/max) against the filter before reading any nuts.
+/// </summary>
+public sealed class TrunkScanFilter<T>
+{
+    public DateTime? TimestampFrom { get; init; }
+    public bool TimestampFromInclusive { get; init; } = true;
+    public DateTime? TimestampTo { get; init; }
+    public bool TimestampToInclusive { get; init; } = true;
+
+    public string? KeyFrom { get; init; }
+    public string? KeyTo { get; init; }
+    public string? KeyPrefix { get; init; }
+
+    /// <summary>
+    /// Predicate on the payload, for trunks that can translate or evaluate it
+    /// </summary>
+    public Expression<Func<T, bool>>? Where { get; init; }
+
+    /// <summary>
+    /// ORDER BY key on the payload (x => x.Property). Order and paging only apply to
+    /// INativeQueryTrunk&lt;T&gt;.Query; CrackWhere ignores them.
+    /// </summary>
+    public LambdaExpression? OrderBy { get; init; }
+
+    /// <summary>
+    /// Order by Nut.Timestamp instead (Newest/Oldest) when OrderBy is null
+    /// </summary>
+    public bool OrderByTimestamp { get; init; }
+
+    public bool OrderDescending { get; init; }
+    public int? Skip { get; init; }
+    public int? Take { get; init; }
+
+    /// <summary>
+    /// Order key bounds are compared in: by UTF-8 bytes, as IOrderedTrunk&lt;T&gt; orders ids
+    /// </summary>
+    public static IComparer<string> KeyComparer => Utf8KeyComparer.Instance;
+
+    public bool HasTimestampRange => TimestampFrom.HasValue || TimestampTo.HasValue;
+
+    public bool HasKeyRange => KeyFrom != null || KeyTo != null || KeyPrefix != null;
+
+    public bool HasOrder => OrderBy != null || OrderByTimestamp;
+
+    public bool MatchesTimestamp(DateTime timestamp)
+    {
+        if (TimestampFrom.HasValue && (TimestampFromInclusive ? timestamp < TimestampFrom.Value : timestamp <= TimestampFrom.Value))
+            return false;
+        if (TimestampTo.HasValue && (TimestampToInclusive ? timestamp > TimestampTo.Value : timestamp >= TimestampTo.Value))
+            return false;
+        return true;
+    }
+
+    /// <summary>
+    /// Whether any timestamp in [min, max] can match
+    /// </summary>
+    public bool OverlapsTimestamps(DateTime min, DateTime max)
+    {
+        if (TimestampFrom.HasValue && (TimestampFromInclusive ? max < TimestampFrom.Value : max <= TimestampFrom.Value))
+            return false;
+        if (TimestampTo.HasValue && (TimestampToInclusive ? min > TimestampTo.Value : min >= TimestampTo.Value))
+            return false;
+        return true;
+    }
+
+    public bool MatchesKey(string id)
+    {
+        return (KeyFrom == null || Utf8KeyComparer.Instance.Compare(id, KeyFrom) >= 0)
+            && (KeyTo == null || Utf8KeyComparer.Instance.Compare(id, KeyTo) < 0)
+            && (KeyPrefix == null || id.StartsWith(KeyPrefix, StringComparison.Ordinal));
+    }
+
+    /// <summary>
+    /// Whether any id in [min, max] can match
+    /// </summary>
+    public bool OverlapsKeys(string min, string max)
+    {
+        var comparer = Utf8KeyComparer.Instance;
+        if (KeyFrom != null && comparer.Compare(max, KeyFrom) < 0)
+            return false;
+        if (KeyTo != null && comparer.Compare(min, KeyTo) >= 0)
+            return false;
+        if (KeyPrefix != null)
+        {
+            // Ids with the prefix sort between the prefix itself and the prefix's last prefixed id
+            if (comparer.Compare(max, KeyPrefix) < 0)
+                return false;
+            if (comparer.Compare(min, KeyPrefix) > 0 && !min.StartsWith(KeyPrefix, StringComparison.Ordinal))
+                return false;
+        }
+        return true;
+    }
+
+    /// <summary>
+    /// Evaluate the whole filter over nuts in memory, with the results TreeQuery would give:
+    /// matches only, in ORDER BY order (key order for key ranges without one), paged. Native
+    /// query trunks use it to finish off a superset they could not narrow exactly.
+    /// </summary>
+    public IEnumerable<Nut<T>> Apply(IEnumerable<Nut<T>> nuts)
+    {
+        var results = nuts.Where(nut => MatchesTimestamp(nut.Timestamp) && MatchesKey(nut.Id));
+        if (Where != null)
+        {
+            var predicate = Where.Compile();
+            results = results.Where(nut => predicate(nut.Payload));
+        }
+
+        if (OrderBy != null)
+        {
+            var parameter = OrderBy.Parameters[0];
+            var key = Expression.Lambda<Func<T, object>>(Expression.Convert(OrderBy.Body, typeof(object)), parameter).Compile();
+            results = OrderDescending ? results.OrderByDescending(nut => key(nut.Payload)) : results.OrderBy(nut => key(nut.Payload));
+        }
+        else if (OrderByTimestamp)
+        {
+            results = OrderDescending ? results.OrderByDescending(nut => nut.Timestamp) : results.OrderBy(nut => nut.Timestamp);
+        }
+        else if (HasKeyRange)
+        {
+            results = results.OrderBy(nut => nut.Id, Utf8KeyComparer.Instance);
+        }
+
+        if (Skip.HasValue)
+            results = results.Skip(Skip.Value);
+        if (Take.HasValue)
+            results = results.Take(Take.Value);
+        return results;
+    }
+}
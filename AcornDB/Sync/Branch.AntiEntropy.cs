@@ -0,0 +1,136 @@
+using System.Net.Http.Json;
+using System.Text.Json;
+using AcornDB.Logging;
+
+namespace AcornDB.Sync
+{
+    /// <summary>
+    /// Merkle anti-entropy for Branch: compares hash trees with the remote top-down and
+    /// transfers only the nuts in divergent ranges (see MerkleReconciler)
+    /// </summary>
+    public partial class Branch
+    {
+        private bool _useAntiEntropy = false;
+
+        private static readonly JsonSerializerOptions MerkleJsonOptions = new()
+        {
+            PropertyNameCaseInsensitive = true
+        };
+
+        /// <summary>
+        /// Make ShakeAsync reconcile Merkle trees with the remote first, falling back to the
+        /// export when the remote does not serve /bark/{tree}/merkle (fluent API)
+        /// </summary>
+        public Branch WithAntiEntropy(bool enabled = true)
+        {
+            _useAntiEntropy = enabled;
+            return this;
+        }
+
+        /// <summary>
+        /// Reconcile a tree with the remote in both directions the sync mode allows,
+        /// transferring only the ids whose versions differ.
+        /// Returns null if the remote could not be reconciled with.
+        /// </summary>
+        public Task<MerkleDiff?> ReconcileAsync<T>(Tree<T> localTree) where T : class
+        {
+            var pull = SyncMode != SyncMode.PushOnly && SyncMode != SyncMode.Disabled;
+            var push = SyncMode != SyncMode.PullOnly && SyncMode != SyncMode.Disabled;
+            return ReconcileAsync(localTree, pull, push);
+        }
+
+        private protected async Task<MerkleDiff?> ReconcileAsync<T>(Tree<T> localTree, bool pull, bool push) where T : class
+        {
+            ThrowIfDisposed();
+
+            if (!pull && !push)
+                return null;
+
+            try
+            {
+                var diff = await MerkleReconciler.SyncAsync(localTree, CreateMerklePeer<T>(), pull, push, ConflictDirection);
+
+                System.Threading.Interlocked.Add(ref _pullCount, diff.NutsPulled);
+                if (pull)
+                    System.Threading.Interlocked.Add(ref _conflictCount, diff.Divergent.Count);
+                lock (_trackingLock)
+                {
+                    _pushCount += diff.NutsPushed;
+                }
+                _lastSyncTimestamp = DateTime.UtcNow;
+
+                AcornLog.Info($"> 🌲 Reconciled with {RemoteUrl}: {diff.Divergent.Count + diff.RemoteOnly.Count + diff.LocalOnly.Count} divergent, " +
+                              $"{diff.NutsPulled} pulled, {diff.NutsPushed} pushed in {diff.RoundTrips} round trips");
+                return diff;
+            }
+            catch (Exception ex)
+            {
+                AcornLog.Info($"> Merkle reconcile with {RemoteUrl} failed: {ex.Message}");
+                return null;
+            }
+        }
+
+        /// <summary>
+        /// The remote side of a reconcile; HTTP against /bark/{tree}/merkle by default
+        /// </summary>
+        protected virtual IMerklePeer<T> CreateMerklePeer<T>() where T : class
+        {
+            return new HttpMerklePeer<T>(_httpClient, $"{RemoteUrl}/bark/{typeof(T).Name.ToLowerInvariant()}");
+        }
+
+        /// <summary>
+        /// Merkle peer over HTTP:
+        ///   GET  {tree}/merkle                 → MerkleSummary
+        ///   POST {tree}/merkle/hashes          {level, nodes} → ulong[]
+        ///   POST {tree}/merkle/entries         int[] leaves → { id: token }
+        ///   POST {tree}/fetch                  string[] ids → Nut[]
+        ///   POST {tree}/batch/stash            Nut[]
+        /// </summary>
+        private sealed class HttpMerklePeer<T> : IMerklePeer<T> where T : class
+        {
+            private readonly HttpClient _httpClient;
+            private readonly string _treeUrl;
+
+            public HttpMerklePeer(HttpClient httpClient, string treeUrl)
+            {
+                _httpClient = httpClient;
+                _treeUrl = treeUrl;
+            }
+
+            public async Task<MerkleSummary> GetSummaryAsync()
+            {
+                return await _httpClient.GetFromJsonAsync<MerkleSummary>($"{_treeUrl}/merkle", MerkleJsonOptions)
+                    ?? throw new InvalidDataException("Empty Merkle summary");
+            }
+
+            public async Task<IReadOnlyList<ulong>> GetChildHashesAsync(int level, IReadOnlyList<int> nodes)
+            {
+                return await PostAsync<ulong[]>($"{_treeUrl}/merkle/hashes", new { level, nodes });
+            }
+
+            public async Task<IReadOnlyDictionary<string, long>> GetLeafEntriesAsync(IReadOnlyList<int> leaves)
+            {
+                return await PostAsync<Dictionary<string, long>>($"{_treeUrl}/merkle/entries", leaves);
+            }
+
+            public async Task<IReadOnlyList<Nut<T>>> FetchAsync(IReadOnlyList<string> ids)
+            {
+                return await PostAsync<List<Nut<T>>>($"{_treeUrl}/fetch", ids);
+            }
+
+            public async Task StoreAsync(IReadOnlyList<Nut<T>> nuts)
+            {
+                var response = await _httpClient.PostAsJsonAsync($"{_treeUrl}/batch/stash", nuts);
+                response.EnsureSuccessStatusCode();
+            }
+
+            private async Task<TResponse> PostAsync<TResponse>(string endpoint, object body)
+            {
+                var response = await _httpClient.PostAsJsonAsync(endpoint, body);
+                response.EnsureSuccessStatusCode();
+                return await response.Content.ReadFromJsonAsync<TResponse>(MerkleJsonOptions)
+                    ?? throw new InvalidDataException($"Empty response from {endpoint}");
+            }
+        }
+    }
+}
@@ -1,8 +1,10 @@
 ﻿// Placeholder for Branch.cs
 
 
+using System.Diagnostics;
 using System.Text;
 using AcornDB.Logging;
+using AcornDB.Metrics;
 using System.Text.Json;
 
 namespace AcornDB.Sync
@@ -20,8 +22,13 @@ namespace AcornDB.Sync
         public BranchCapabilities Capabilities => BranchCapabilities.All;
 
         private readonly HttpClient _httpClient;
-        private readonly HashSet<string> _pushedNuts = new(); // Track pushed nuts to avoid re-pushing
-        private readonly HashSet<string> _deletedNuts = new(); // Track deleted nuts to avoid re-deleting
+        // Last pushed timestamp per id and ids last sent as deletes, to avoid re-sending.
+        // An id is in at most one of them, so both stay bounded by the number of live ids.
+        private readonly Dictionary<string, long> _pushedNuts = new();
+        private readonly HashSet<string> _deletedNuts = new();
+        private readonly object _trackingLock = new();
+        private int _pushCount = 0;
+        private int _deleteCount = 0;
         private long _pullCount = 0; // Track nuts pulled from remote
         private long _conflictCount = 0; // Track conflicts resolved
         private DateTime _lastSyncTimestamp = DateTime.MinValue; // Track last successful sync for delta sync
@@ -107,12 +114,16 @@ namespace AcornDB.Sync
             if (SyncMode == SyncMode.PullOnly || SyncMode == SyncMode.Disabled)
                 return;
 
-            // Check if we've already pushed this nut to avoid duplicates
-            var nutKey = $"{id}:{shell.Timestamp.Ticks}";
-            if (_pushedNuts.Contains(nutKey))
-                return;
+            // Check if we've already pushed this version of the nut to avoid duplicates
+            lock (_trackingLock)
+            {
+                if (_pushedNuts.TryGetValue(id, out var pushedTicks) && pushedTicks == shell.Timestamp.Ticks)
+                    return;
 
-            _pushedNuts.Add(nutKey);
+                _pushedNuts[id] = shell.Timestamp.Ticks;
+                _deletedNuts.Remove(id);
+                _pushCount++;
+            }
 
             // Use batching if enabled
             if (_batchingEnabled)
@@ -140,10 +151,14 @@ namespace AcornDB.Sync
                 return;
 
             // Check if we've already deleted this nut to avoid duplicates
-            if (_deletedNuts.Contains(id))
-                return;
+            lock (_trackingLock)
+            {
+                if (!_deletedNuts.Add(id))
+                    return;
 
-            _deletedNuts.Add(id);
+                _pushedNuts.Remove(id);
+                _deleteCount++;
+            }
 
             // Use batching if enabled
             if (_batchingEnabled)
@@ -195,7 +210,9 @@ namespace AcornDB.Sync
                 var treeName = typeof(T).Name.ToLowerInvariant(); // naive default mapping
                 var endpoint = $"{RemoteUrl}/bark/{treeName}/stash";
 
+                var started = Stopwatch.GetTimestamp();
                 var response = await _httpClient.PostAsync(endpoint, content);
+                MetricsCollector.Instance.GetLatencyHistogram(LatencyOperations.SyncPush, treeName).RecordSince(started);
 
                 if (!response.IsSuccessStatusCode)
                 {
@@ -220,6 +237,11 @@ namespace AcornDB.Sync
             if (SyncMode == SyncMode.PushOnly || SyncMode == SyncMode.Disabled)
                 return;
 
+            // Exchange only divergent ranges when the remote serves Merkle endpoints; the
+            // export below is the fallback
+            if (_useAntiEntropy && await ReconcileAsync(targetTree, pull: true, push: false) != null)
+                return;
+
             try
             {
                 var treeName = typeof(T).Name.ToLowerInvariant();
@@ -235,6 +257,7 @@ namespace AcornDB.Sync
                     endpoint += $"?since={_lastSyncTimestamp.Ticks}";
                 }
 
+                var started = Stopwatch.GetTimestamp();
                 var response = await _httpClient.GetAsync(endpoint);
                 if (!response.IsSuccessStatusCode)
                 {
@@ -259,6 +282,7 @@ namespace AcornDB.Sync
                 }
 
                 var json = await response.Content.ReadAsStringAsync();
+                MetricsCollector.Instance.GetLatencyHistogram(LatencyOperations.SyncPull, treeName).RecordSince(started);
                 var nuts = JsonSerializer.Deserialize<List<Nut<T>>>(json, new JsonSerializerOptions
                 {
                     PropertyNameCaseInsensitive = true
@@ -392,7 +416,9 @@ namespace AcornDB.Sync
                         var json = JsonSerializer.Serialize(nuts);
                         var content = new StringContent(json, Encoding.UTF8, "application/json");
 
+                        var started = Stopwatch.GetTimestamp();
                         var response = await _httpClient.PostAsync(endpoint, content);
+                        MetricsCollector.Instance.GetLatencyHistogram(LatencyOperations.SyncPush, treeName).RecordSince(started);
                         if (response.IsSuccessStatusCode)
                         {
                             AcornLog.Info($"> Batch push: {nuts.Count} nuts synced to {RemoteUrl}");
@@ -444,8 +470,11 @@ namespace AcornDB.Sync
         /// </summary>
         public void ClearPushHistory()
         {
-            _pushedNuts.Clear();
-            _deletedNuts.Clear();
+            lock (_trackingLock)
+            {
+                _pushedNuts.Clear();
+                _deletedNuts.Clear();
+            }
         }
 
         /// <summary>
@@ -458,8 +487,8 @@ namespace AcornDB.Sync
                 RemoteUrl = RemoteUrl,
                 SyncMode = SyncMode,
                 ConflictDirection = ConflictDirection,
-                TotalPushed = _pushedNuts.Count,
-                TotalDeleted = _deletedNuts.Count,
+                TotalPushed = _pushCount,
+                TotalDeleted = _deleteCount,
                 TotalPulled = _pullCount,
                 TotalConflicts = _conflictCount,
                 DeltaSyncEnabled = _useDeltaSync,
@@ -503,8 +532,7 @@ namespace AcornDB.Sync
             _httpClient?.Dispose();
 
             // Clear internal state
-            _pushedNuts.Clear();
-            _deletedNuts.Clear();
+            ClearPushHistory();
             lock (_batchLock)
             {
                 _batchQueue.Clear();
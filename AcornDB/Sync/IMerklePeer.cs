@@ -0,0 +1,37 @@
+using System.Collections.Generic;
+using System.Threading.Tasks;
+
+namespace AcornDB.Sync
+{
+    /// <summary>
+    /// The remote side of a Merkle anti-entropy exchange. Each call is one round trip, and
+    /// every call but the summary is batched over the divergent nodes of one level.
+    /// </summary>
+    public interface IMerklePeer<T> where T : class
+    {
+        /// <summary>
+        /// Depth, root hash and entry count of the peer's Merkle tree
+        /// </summary>
+        Task<MerkleSummary> GetSummaryAsync();
+
+        /// <summary>
+        /// The Fanout child hashes of each node at the given level, in node order
+        /// </summary>
+        Task<IReadOnlyList<ulong>> GetChildHashesAsync(int level, IReadOnlyList<int> nodes);
+
+        /// <summary>
+        /// The id → version token entries stored in the given leaves
+        /// </summary>
+        Task<IReadOnlyDictionary<string, long>> GetLeafEntriesAsync(IReadOnlyList<int> leaves);
+
+        /// <summary>
+        /// The peer's nuts for the given ids (ids it no longer has are left out)
+        /// </summary>
+        Task<IReadOnlyList<Nut<T>>> FetchAsync(IReadOnlyList<string> ids);
+
+        /// <summary>
+        /// Offer nuts to the peer, which resolves them against its own copies
+        /// </summary>
+        Task StoreAsync(IReadOnlyList<Nut<T>> nuts);
+    }
+}
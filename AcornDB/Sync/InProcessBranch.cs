@@ -145,6 +145,10 @@ namespace AcornDB.Sync
             }
         }
 
+        /// <summary>
+        /// Pull from the target tree, transferring only the nuts whose ids or versions
+        /// differ (Merkle reconcile) instead of every nut it holds
+        /// </summary>
         public override async Task ShakeAsync<TItem>(Tree<TItem> sourceTree)
         {
             if (typeof(TItem) != typeof(T))
@@ -153,21 +157,16 @@ namespace AcornDB.Sync
                 return;
             }
 
-            try
-            {
-                var changes = _targetTree.ExportChanges();
-                foreach (var nut in changes)
-                {
-                    var typedSourceTree = sourceTree as Tree<T>;
-                    typedSourceTree?.Squabble(nut.Id, nut);
-                }
-            }
-            catch (Exception ex)
-            {
-                AcornLog.Error($"> ⚠️ InProcessBranch shake failed: {ex.Message}");
-            }
+            await ReconcileAsync(sourceTree, pull: true, push: false);
+        }
+
+        protected override IMerklePeer<TItem> CreateMerklePeer<TItem>()
+        {
+            if (_targetTree is not Tree<TItem> target)
+                throw new InvalidOperationException(
+                    $"InProcessBranch: Type mismatch - expected {typeof(T).Name}, got {typeof(TItem).Name}");
 
-            await Task.CompletedTask;
+            return new TreeMerklePeer<TItem>(target);
         }
     }
 }
@@ -0,0 +1,36 @@
+using System.Collections.Generic;
+
+namespace AcornDB.Sync
+{
+    /// <summary>
+    /// Outcome of comparing two replicas' Merkle trees, and of the transfer that followed
+    /// </summary>
+    public class MerkleDiff
+    {
+        /// <summary>
+        /// Ids both sides have at different versions
+        /// </summary>
+        public List<string> Divergent { get; } = new();
+
+        /// <summary>
+        /// Ids only the remote side has
+        /// </summary>
+        public List<string> RemoteOnly { get; } = new();
+
+        /// <summary>
+        /// Ids only the local side has
+        /// </summary>
+        public List<string> LocalOnly { get; } = new();
+
+        // Remote versions of Divergent, so a push can skip ids the pull already settled
+        internal Dictionary<string, long> RemoteTokens { get; } = new();
+
+        public int RoundTrips { get; set; }
+        public int HashesCompared { get; set; }
+        public int EntriesCompared { get; set; }
+        public int NutsPulled { get; set; }
+        public int NutsPushed { get; set; }
+
+        public bool InSync => Divergent.Count == 0 && RemoteOnly.Count == 0 && LocalOnly.Count == 0;
+    }
+}
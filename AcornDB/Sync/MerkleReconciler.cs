@@ -0,0 +1,128 @@
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Threading.Tasks;
+
+namespace AcornDB.Sync
+{
+    /// <summary>
+    /// Merkle anti-entropy: walks the local and remote hash trees top-down, descending only
+    /// into nodes whose hashes differ, then exchanges the entries of the divergent leaves and
+    /// transfers just those nuts. Costs Depth + 2 round trips plus one per direction of
+    /// transfer, however large the trees are.
+    /// </summary>
+    public static class MerkleReconciler
+    {
+        /// <summary>
+        /// Find the ids whose versions differ between a local Merkle tree and a peer's
+        /// </summary>
+        /// <exception cref="InvalidOperationException">The trees have different depths</exception>
+        public static async Task<MerkleDiff> DiffAsync<T>(MerkleTree local, IMerklePeer<T> remote) where T : class
+        {
+            var diff = new MerkleDiff();
+
+            var summary = await remote.GetSummaryAsync();
+            diff.RoundTrips++;
+            if (summary.Depth != local.Depth)
+                throw new InvalidOperationException(
+                    $"Merkle depth mismatch: local {local.Depth}, remote {summary.Depth}");
+
+            diff.HashesCompared++;
+            if (summary.RootHash == local.RootHash)
+                return diff;
+
+            IReadOnlyList<int> divergent = new[] { 0 };
+            for (int level = 0; level < local.Depth && divergent.Count > 0; level++)
+            {
+                var remoteHashes = await remote.GetChildHashesAsync(level, divergent);
+                diff.RoundTrips++;
+                if (remoteHashes.Count != divergent.Count * MerkleTree.Fanout)
+                    throw new InvalidDataException(
+                        $"Peer returned {remoteHashes.Count} hashes for {divergent.Count} nodes");
+
+                var localHashes = local.ChildHashes(level, divergent);
+                var next = new List<int>();
+                for (int i = 0; i < localHashes.Length; i++)
+                {
+                    if (localHashes[i] != remoteHashes[i])
+                        next.Add(divergent[i / MerkleTree.Fanout] * MerkleTree.Fanout + i % MerkleTree.Fanout);
+                }
+                diff.HashesCompared += localHashes.Length;
+                divergent = next;
+            }
+
+            // Hashes can agree all the way down only if a write landed mid-walk
+            if (divergent.Count == 0)
+                return diff;
+
+            var remoteEntries = await remote.GetLeafEntriesAsync(divergent);
+            diff.RoundTrips++;
+            var localEntries = local.Entries(divergent);
+
+            foreach (var (id, token) in localEntries)
+            {
+                if (!remoteEntries.TryGetValue(id, out var remoteToken))
+                {
+                    diff.LocalOnly.Add(id);
+                }
+                else if (remoteToken != token)
+                {
+                    diff.Divergent.Add(id);
+                    diff.RemoteTokens[id] = remoteToken;
+                }
+            }
+            foreach (var id in remoteEntries.Keys)
+            {
+                if (!localEntries.ContainsKey(id))
+                    diff.RemoteOnly.Add(id);
+            }
+            diff.EntriesCompared = localEntries.Count + remoteEntries.Count;
+
+            return diff;
+        }
+
+        /// <summary>
+        /// Diff a tree against a peer, then pull the ids the peer has newer or only copies of
+        /// (resolved with conflictDirection) and/or push the ones the local tree does.
+        /// Ids missing on one side are copied to it: deletes travel as toss leaves, not here.
+        /// </summary>
+        public static async Task<MerkleDiff> SyncAsync<T>(
+            Tree<T> local,
+            IMerklePeer<T> remote,
+            bool pull = true,
+            bool push = true,
+            ConflictDirection conflictDirection = ConflictDirection.UseJudge) where T : class
+        {
+            var diff = await DiffAsync(local.Merkle, remote);
+
+            if (pull && (diff.Divergent.Count > 0 || diff.RemoteOnly.Count > 0))
+            {
+                var nuts = await remote.FetchAsync(diff.Divergent.Concat(diff.RemoteOnly).ToList());
+                diff.RoundTrips++;
+                foreach (var nut in nuts)
+                    local.Squabble(nut.Id, nut, conflictDirection);
+                diff.NutsPulled = nuts.Count;
+            }
+
+            if (push && (diff.Divergent.Count > 0 || diff.LocalOnly.Count > 0))
+            {
+                // Read after the pull: divergent ids whose remote copy won locally are in sync
+                var nuts = diff.Divergent.Concat(diff.LocalOnly)
+                    .Select(local.CrackNut)
+                    .Where(nut => nut != null
+                        && (!diff.RemoteTokens.TryGetValue(nut.Id, out var remoteToken) || MerkleTree.TokenOf(nut) != remoteToken))
+                    .Select(nut => nut!)
+                    .ToList();
+                if (nuts.Count > 0)
+                {
+                    await remote.StoreAsync(nuts);
+                    diff.RoundTrips++;
+                }
+                diff.NutsPushed = nuts.Count;
+            }
+
+            return diff;
+        }
+    }
+}
@@ -0,0 +1,12 @@
+namespace AcornDB.Sync
+{
+    /// <summary>
+    /// Top of a replica's Merkle tree, exchanged first: equal roots end the exchange
+    /// </summary>
+    public class MerkleSummary
+    {
+        public int Depth { get; set; }
+        public ulong RootHash { get; set; }
+        public int Count { get; set; }
+    }
+}
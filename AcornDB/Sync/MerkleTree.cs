@@ -0,0 +1,225 @@
+using System.Text;
+
+namespace AcornDB.Sync
+{
+    /// <summary>
+    /// Hash tree over a tree's ids and versions, compared top-down by anti-entropy so two
+    /// replicas only exchange the key ranges whose hashes differ.
+    ///
+    /// Ids are bucketed by the top bits of their hash into Fanout^Depth leaves. A leaf's hash
+    /// is the XOR of its entries' hashes and a node's hash the XOR of its children's, so a
+    /// write updates one path to the root without rehashing a bucket, and the hash depends on
+    /// the set of (id, version) pairs rather than the order they were written in.
+    /// Hashing and layout match acorn-sync's merkle module.
+    /// </summary>
+    public sealed class MerkleTree
+    {
+        public const int Fanout = 16;
+        public const int DefaultDepth = 3;
+        private const int BitsPerLevel = 4;
+
+        // _levels[level][node]; level 0 is the root, level Depth the leaves. Buckets are
+        // created on first use so an empty tree costs only the hash arrays
+        private readonly long[][] _levels;
+        private readonly Dictionary<string, long>?[] _buckets;
+        private int _count;
+
+        /// <summary>
+        /// Number of levels below the root; both sides of a comparison must agree on it
+        /// </summary>
+        public int Depth { get; }
+
+        public int LeafCount => _buckets.Length;
+
+        /// <summary>
+        /// Number of ids tracked
+        /// </summary>
+        public int Count => Volatile.Read(ref _count);
+
+        public ulong RootHash => NodeHash(0, 0);
+
+        public MerkleTree(int depth = DefaultDepth)
+        {
+            if (depth < 1 || depth > 6)
+                throw new ArgumentOutOfRangeException(nameof(depth), "Merkle depth must be between 1 and 6");
+
+            Depth = depth;
+            _levels = new long[depth + 1][];
+            for (int level = 0; level <= depth; level++)
+                _levels[level] = new long[1 << (BitsPerLevel * level)];
+
+            _buckets = new Dictionary<string, long>?[_levels[depth].Length];
+        }
+
+        /// <summary>
+        /// Version token of a nut: its timestamp and version, which replicas copy verbatim
+        /// when a nut is synced, so equal tokens mean the same write
+        /// </summary>
+        public static long TokenOf<T>(Nut<T> nut)
+        {
+            return unchecked(nut.Timestamp.Ticks * 31 + nut.Version);
+        }
+
+        /// <summary>
+        /// Record the current version of an id
+        /// </summary>
+        public void Set(string id, long token)
+        {
+            var leaf = LeafOf(id);
+            var bucket = BucketFor(leaf);
+            lock (bucket)
+            {
+                long delta;
+                if (bucket.TryGetValue(id, out var previous))
+                {
+                    if (previous == token)
+                        return;
+                    delta = (long)(EntryHash(id, previous) ^ EntryHash(id, token));
+                }
+                else
+                {
+                    delta = (long)EntryHash(id, token);
+                    Interlocked.Increment(ref _count);
+                }
+
+                bucket[id] = token;
+                Propagate(leaf, delta);
+            }
+        }
+
+        public void Set<T>(string id, Nut<T> nut) => Set(id, TokenOf(nut));
+
+        /// <summary>
+        /// Forget an id; its leaf hash returns to what it was before the id was set
+        /// </summary>
+        public void Remove(string id)
+        {
+            var leaf = LeafOf(id);
+            var bucket = Volatile.Read(ref _buckets[leaf]);
+            if (bucket == null)
+                return;
+
+            lock (bucket)
+            {
+                if (!bucket.Remove(id, out var previous))
+                    return;
+
+                Interlocked.Decrement(ref _count);
+                Propagate(leaf, (long)EntryHash(id, previous));
+            }
+        }
+
+        /// <summary>
+        /// Hash of a node; leaves are at level Depth
+        /// </summary>
+        public ulong NodeHash(int level, int node)
+        {
+            return (ulong)Volatile.Read(ref _levels[level][node]);
+        }
+
+        /// <summary>
+        /// The Fanout child hashes of each node, in node order
+        /// </summary>
+        public ulong[] ChildHashes(int level, IReadOnlyList<int> nodes)
+        {
+            if (level < 0 || level >= Depth)
+                throw new ArgumentOutOfRangeException(nameof(level), $"Level must be below the leaves (0..{Depth - 1})");
+
+            var hashes = new ulong[nodes.Count * Fanout];
+            for (int i = 0; i < nodes.Count; i++)
+            {
+                var first = nodes[i] * Fanout;
+                for (int c = 0; c < Fanout; c++)
+                    hashes[i * Fanout + c] = NodeHash(level + 1, first + c);
+            }
+            return hashes;
+        }
+
+        /// <summary>
+        /// Copy of the id → token entries in the given leaves
+        /// </summary>
+        public Dictionary<string, long> Entries(IEnumerable<int> leaves)
+        {
+            var entries = new Dictionary<string, long>();
+            foreach (var leaf in leaves)
+            {
+                var bucket = Volatile.Read(ref _buckets[leaf]);
+                if (bucket == null)
+                    continue;
+
+                lock (bucket)
+                {
+                    foreach (var entry in bucket)
+                        entries[entry.Key] = entry.Value;
+                }
+            }
+            return entries;
+        }
+
+        public int LeafOf(string id)
+        {
+            // FNV's high bits barely depend on the last bytes, so ids like "item-1",
+            // "item-2" would share a leaf without the mix
+            return (int)(Mix(Fnv1a(id)) >> (64 - BitsPerLevel * Depth));
+        }
+
+        private Dictionary<string, long> BucketFor(int leaf)
+        {
+            return Volatile.Read(ref _buckets[leaf])
+                ?? Interlocked.CompareExchange(ref _buckets[leaf], new Dictionary<string, long>(), null)
+                ?? _buckets[leaf]!;
+        }
+
+        private void Propagate(int leaf, long delta)
+        {
+            var node = leaf;
+            for (int level = Depth; level >= 0; level--)
+            {
+                ref var slot = ref _levels[level][node];
+                long current;
+                do
+                {
+                    current = Volatile.Read(ref slot);
+                } while (Interlocked.CompareExchange(ref slot, current ^ delta, current) != current);
+
+                node /= Fanout;
+            }
+        }
+
+        /// <summary>
+        /// Hash of one (id, token) entry
+        /// </summary>
+        public static ulong EntryHash(string id, long token)
+        {
+            return Mix(Fnv1a(id) ^ Mix((ulong)token));
+        }
+
+        /// <summary>
+        /// FNV-1a over the id's UTF-8 bytes
+        /// </summary>
+        internal static ulong Fnv1a(string id)
+        {
+            var max = Encoding.UTF8.GetMaxByteCount(id.Length);
+            Span<byte> bytes = max <= 512 ? stackalloc byte[max] : new byte[max];
+            bytes = bytes[..Encoding.UTF8.GetBytes(id, bytes)];
+
+            var hash = 0xcbf29ce484222325UL;
+            foreach (var b in bytes)
+            {
+                hash ^= b;
+                hash *= 0x100000001b3UL;
+            }
+            return hash;
+        }
+
+        /// <summary>
+        /// splitmix64 finalizer: every input bit affects every output bit
+        /// </summary>
+        private static ulong Mix(ulong z)
+        {
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9UL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebUL;
+            return z ^ (z >> 31);
+        }
+    }
+}
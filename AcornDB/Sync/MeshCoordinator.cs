@@ -1,5 +1,6 @@
 using System;
 using System.Collections.Generic;
+using System.Diagnostics;
 using System.Linq;
 using System.Threading;
 using System.Threading.Tasks;
@@ -10,6 +11,11 @@ namespace AcornDB.Sync
     /// <summary>
     /// Coordinates synchronization across a mesh network of Trees
     /// Handles topology management and prevents sync loops
+    ///
+    /// By default every link is a pair of tangles that push each change to the neighbour
+    /// straight away, which in a full mesh fans out O(n²). With EnableGossip, links only
+    /// restrict who talks to whom: each round every node reconciles its Merkle tree with a
+    /// few random peers, so a change reaches all n nodes in O(log n) rounds.
     /// </summary>
     public class MeshCoordinator<T> where T : class
     {
@@ -17,6 +23,49 @@ namespace AcornDB.Sync
         private readonly Dictionary<string, List<string>> _topology = new();
         private readonly object _topologyLock = new();
 
+        private readonly object _statsLock = new();
+        private readonly MeshGossipStats _gossipStats = new();
+        private Random? _random;
+        private int _fanout;
+        private int _maxParallelism = Environment.ProcessorCount;
+
+        /// <summary>
+        /// Whether EnableGossip has been called
+        /// </summary>
+        public bool GossipEnabled => _random != null;
+
+        /// <summary>
+        /// Switch the mesh to gossip propagation. Call before connecting nodes: links made
+        /// afterwards record topology without creating tangles.
+        /// </summary>
+        /// <param name="fanout">Peers each node reconciles with per round</param>
+        /// <param name="maxParallelism">Exchanges run at once; defaults to the processor count</param>
+        /// <param name="seed">Seed for peer selection, for reproducible rounds</param>
+        public MeshCoordinator<T> EnableGossip(int fanout = 3, int? maxParallelism = null, int? seed = null)
+        {
+            if (fanout < 1)
+                throw new ArgumentException("Fanout must be at least 1", nameof(fanout));
+            if (maxParallelism is < 1)
+                throw new ArgumentException("Max parallelism must be at least 1", nameof(maxParallelism));
+
+            lock (_topologyLock)
+            {
+                _random = seed.HasValue ? new Random(seed.Value) : new Random();
+                _fanout = fanout;
+                _maxParallelism = maxParallelism ?? Environment.ProcessorCount;
+            }
+
+            lock (_statsLock)
+            {
+                _gossipStats.Enabled = true;
+                _gossipStats.Fanout = fanout;
+                _gossipStats.MaxParallelism = _maxParallelism;
+            }
+
+            AcornLog.Info($"> 🗣️  Gossip enabled: fanout {fanout}, {_maxParallelism} parallel exchanges");
+            return this;
+        }
+
         /// <summary>
         /// Add a node to the mesh
         /// </summary>
@@ -50,6 +99,10 @@ namespace AcornDB.Sync
                 if (!_topology[nodeB].Contains(nodeA))
                     _topology[nodeB].Add(nodeA);
 
+                // Gossip rounds pick peers from the topology; no standing tangles needed
+                if (GossipEnabled)
+                    return;
+
                 // Create in-process tangles for bidirectional sync
                 var treeA = _nodes[nodeA];
                 var treeB = _nodes[nodeB];
@@ -128,19 +181,227 @@ namespace AcornDB.Sync
 
         /// <summary>
         /// Synchronize all nodes in the mesh
-        /// Triggers a shake on all tangles to pull changes
+        /// Triggers a shake on all tangles to pull changes; in gossip mode, then gossips
+        /// until every node holds the same nuts
         /// </summary>
         public void SynchronizeAll()
         {
+            // Shake outside the lock so a slow node doesn't block topology changes, and
+            // in parallel so it doesn't hold up the other nodes either
+            List<Tree<T>> trees;
+            int maxParallelism;
+            lock (_topologyLock)
+            {
+                trees = _nodes.Values.ToList();
+                maxParallelism = _maxParallelism;
+            }
+
+            Parallel.ForEach(trees, new ParallelOptions { MaxDegreeOfParallelism = maxParallelism }, tree => tree.Shake());
+
+            if (GossipEnabled)
+                GossipUntilConvergedAsync().GetAwaiter().GetResult();
+
+            AcornLog.Info($"> 🌊 Mesh synchronized: {trees.Count} nodes");
+        }
+
+        /// <summary>
+        /// Run one gossip round: every node reconciles with Fanout random peers (its
+        /// neighbours if it has links, any node otherwise). Exchanges run on at most
+        /// MaxParallelism workers; a failed exchange is logged and counted, not rethrown.
+        /// </summary>
+        /// <returns>Nuts transferred during the round</returns>
+        public async Task<int> GossipRoundAsync(CancellationToken cancellationToken = default)
+        {
+            List<(Tree<T> node, Tree<T> peer)> exchanges;
+            int maxParallelism;
+            lock (_topologyLock)
+            {
+                if (_random == null)
+                    throw new InvalidOperationException("Gossip is not enabled; call EnableGossip first");
+                exchanges = PlanRound(_random);
+                maxParallelism = _maxParallelism;
+            }
+
+            var roundTimer = Stopwatch.StartNew();
+            int transferred = 0, suppressed = 0, failed = 0;
+            long slowestTicks = 0;
+
+            var options = new ParallelOptions { MaxDegreeOfParallelism = maxParallelism, CancellationToken = cancellationToken };
+            await Parallel.ForEachAsync(exchanges, options, async (exchange, _) =>
+            {
+                var started = Stopwatch.GetTimestamp();
+                try
+                {
+                    var (moved, refused) = await ExchangeAsync(exchange.node, exchange.peer);
+                    Interlocked.Add(ref transferred, moved);
+                    Interlocked.Add(ref suppressed, refused);
+                }
+                catch (Exception ex)
+                {
+                    Interlocked.Increment(ref failed);
+                    AcornLog.Error($"> ⚠️ Gossip {exchange.node.NodeId} ↔ {exchange.peer.NodeId} failed: {ex.Message}");
+                }
+
+                var elapsed = Stopwatch.GetTimestamp() - started;
+                long slowest;
+                while (elapsed > (slowest = Interlocked.Read(ref slowestTicks))
+                       && Interlocked.CompareExchange(ref slowestTicks, elapsed, slowest) != slowest)
+                {
+                }
+            });
+
+            lock (_statsLock)
+            {
+                _gossipStats.Rounds++;
+                _gossipStats.Exchanges += exchanges.Count;
+                _gossipStats.FailedExchanges += failed;
+                _gossipStats.NutsTransferred += transferred;
+                _gossipStats.DuplicatesSuppressed += suppressed;
+                _gossipStats.LastRoundDuration = roundTimer.Elapsed;
+                _gossipStats.SlowestExchange = Stopwatch.GetElapsedTime(0, slowestTicks);
+            }
+
+            return transferred;
+        }
+
+        /// <summary>
+        /// Gossip until every node's Merkle root matches, or maxRounds have run. The rounds
+        /// and time taken are recorded in GetNetworkStats().Gossip.
+        /// </summary>
+        /// <returns>Whether the mesh converged</returns>
+        public async Task<bool> GossipUntilConvergedAsync(int maxRounds = 64, CancellationToken cancellationToken = default)
+        {
+            if (maxRounds < 1)
+                throw new ArgumentException("Max rounds must be at least 1", nameof(maxRounds));
+
+            var timer = Stopwatch.StartNew();
+            int rounds = 0;
+            bool converged = IsConverged();
+            while (!converged && rounds < maxRounds)
+            {
+                await GossipRoundAsync(cancellationToken);
+                rounds++;
+                converged = IsConverged();
+            }
+
+            lock (_statsLock)
+            {
+                _gossipStats.Converged = converged;
+                _gossipStats.LastConvergenceRounds = rounds;
+                _gossipStats.LastConvergenceTime = timer.Elapsed;
+            }
+
+            AcornLog.Info(converged
+                ? $"> 🗣️  Mesh converged in {rounds} gossip rounds ({timer.Elapsed.TotalMilliseconds:F0}ms)"
+                : $"> ⚠️ Mesh not converged after {rounds} gossip rounds");
+            return converged;
+        }
+
+        /// <summary>
+        /// Reconcile one node with one peer in both directions, outside any round
+        /// </summary>
+        /// <returns>Nuts transferred</returns>
+        public async Task<int> GossipWithAsync(string nodeId, string peerId)
+        {
+            Tree<T> node, peer;
             lock (_topologyLock)
             {
-                foreach (var tree in _nodes.Values)
+                if (!_nodes.TryGetValue(nodeId, out node!) || !_nodes.TryGetValue(peerId, out peer!))
+                    throw new InvalidOperationException("Both nodes must be added before gossiping");
+            }
+
+            var (transferred, suppressed) = await ExchangeAsync(node, peer);
+            lock (_statsLock)
+            {
+                _gossipStats.Exchanges++;
+                _gossipStats.NutsTransferred += transferred;
+                _gossipStats.DuplicatesSuppressed += suppressed;
+            }
+            return transferred;
+        }
+
+        /// <summary>
+        /// Whether every node holds the same ids and versions
+        /// </summary>
+        public bool IsConverged()
+        {
+            lock (_topologyLock)
+            {
+                var roots = _nodes.Values.Select(tree => tree.Merkle.RootHash);
+                return roots.Distinct().Count() <= 1;
+            }
+        }
+
+        /// <summary>
+        /// Pick each node's peers for a round. Called under _topologyLock.
+        /// </summary>
+        private List<(Tree<T> node, Tree<T> peer)> PlanRound(Random random)
+        {
+            var fanout = _fanout;
+            var nodeIds = _nodes.Keys.ToList();
+            var exchanges = new List<(Tree<T>, Tree<T>)>(nodeIds.Count * fanout);
+            var picked = new HashSet<string>();
+
+            foreach (var nodeId in nodeIds)
+            {
+                var neighbours = _topology[nodeId];
+                IReadOnlyList<string> candidates = neighbours.Count > 0 ? neighbours : nodeIds;
+                var available = neighbours.Count > 0 ? candidates.Count : candidates.Count - 1;
+
+                picked.Clear();
+                while (picked.Count < Math.Min(fanout, available))
                 {
-                    tree.Shake();
+                    var peerId = candidates[random.Next(candidates.Count)];
+                    if (peerId != nodeId && picked.Add(peerId))
+                        exchanges.Add((_nodes[nodeId], _nodes[peerId]));
                 }
             }
 
-            AcornLog.Info($"> 🌊 Mesh synchronized: {_nodes.Count} nodes");
+            return exchanges;
+        }
+
+        /// <summary>
+        /// Push-pull anti-entropy between two nodes: compare Merkle trees, then hand each side the
+        /// nuts it lacks or holds older. Every hand-off goes through the receiver's loop guard,
+        /// so a change it has already seen is dropped before the conflict judge runs.
+        /// Deletes are not gossiped; tossing travels through tangles and branches as before.
+        /// </summary>
+        private static async Task<(int transferred, int suppressed)> ExchangeAsync(Tree<T> node, Tree<T> peer)
+        {
+            var diff = await MerkleReconciler.DiffAsync(node.Merkle, new TreeMerklePeer<T>(peer));
+            if (diff.InSync)
+                return (0, 0);
+
+            int transferred = 0, suppressed = 0;
+
+            void Deliver(Nut<T>? nut, Tree<T> target)
+            {
+                if (nut == null)
+                    return;
+
+                if (!target.ShouldApplyChange(nut))
+                {
+                    suppressed++;
+                    return;
+                }
+
+                target.Squabble(nut.Id, nut);
+                transferred++;
+            }
+
+            foreach (var id in diff.Divergent.Concat(diff.RemoteOnly))
+                Deliver(peer.CrackNut(id), node);
+
+            foreach (var id in diff.Divergent.Concat(diff.LocalOnly))
+            {
+                // Read after the pull: where the peer's copy won, both sides already agree
+                var nut = node.CrackNut(id);
+                var theirs = peer.CrackNut(id);
+                if (nut != null && (theirs == null || MerkleTree.TokenOf(nut) != MerkleTree.TokenOf(theirs)))
+                    Deliver(nut, peer);
+            }
+
+            return (transferred, suppressed);
         }
 
         /// <summary>
@@ -159,6 +420,29 @@ namespace AcornDB.Sync
             }
         }
 
+        private MeshGossipStats GetGossipStats()
+        {
+            lock (_statsLock)
+            {
+                return new MeshGossipStats
+                {
+                    Enabled = _gossipStats.Enabled,
+                    Fanout = _gossipStats.Fanout,
+                    MaxParallelism = _gossipStats.MaxParallelism,
+                    Rounds = _gossipStats.Rounds,
+                    Exchanges = _gossipStats.Exchanges,
+                    FailedExchanges = _gossipStats.FailedExchanges,
+                    NutsTransferred = _gossipStats.NutsTransferred,
+                    DuplicatesSuppressed = _gossipStats.DuplicatesSuppressed,
+                    LastRoundDuration = _gossipStats.LastRoundDuration,
+                    SlowestExchange = _gossipStats.SlowestExchange,
+                    Converged = _gossipStats.Converged,
+                    LastConvergenceRounds = _gossipStats.LastConvergenceRounds,
+                    LastConvergenceTime = _gossipStats.LastConvergenceTime
+                };
+            }
+        }
+
         /// <summary>
         /// Get a node by ID
         /// </summary>
@@ -183,7 +467,8 @@ namespace AcornDB.Sync
                     NodeStats = _nodes.ToDictionary(
                         kvp => kvp.Key,
                         kvp => kvp.Value.GetMeshStats()
-                    )
+                    ),
+                    Gossip = GetGossipStats()
                 };
             }
         }
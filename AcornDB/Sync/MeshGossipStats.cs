@@ -0,0 +1,40 @@
+using System;
+
+namespace AcornDB.Sync
+{
+    /// <summary>
+    /// Gossip propagation statistics for a mesh: totals since the coordinator was created,
+    /// plus timings of the latest round and the latest convergence run
+    /// </summary>
+    public class MeshGossipStats
+    {
+        public bool Enabled { get; set; }
+        public int Fanout { get; set; }
+        public int MaxParallelism { get; set; }
+
+        public long Rounds { get; set; }
+        public long Exchanges { get; set; }
+        public long FailedExchanges { get; set; }
+        public long NutsTransferred { get; set; }
+
+        /// <summary>
+        /// Nuts a node refused because its loop guard had already seen that change
+        /// </summary>
+        public long DuplicatesSuppressed { get; set; }
+
+        public TimeSpan LastRoundDuration { get; set; }
+
+        /// <summary>
+        /// Longest single exchange in the latest round; a slow node shows up here without
+        /// holding up the other exchanges of the round
+        /// </summary>
+        public TimeSpan SlowestExchange { get; set; }
+
+        /// <summary>
+        /// Whether every node held the same nuts when the latest convergence run ended
+        /// </summary>
+        public bool Converged { get; set; }
+        public int LastConvergenceRounds { get; set; }
+        public TimeSpan LastConvergenceTime { get; set; }
+    }
+}
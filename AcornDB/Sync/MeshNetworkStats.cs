@@ -9,5 +9,6 @@ namespace AcornDB.Sync
     {
         public MeshTopology Topology { get; set; } = new();
         public Dictionary<string, MeshSyncStats> NodeStats { get; set; } = new();
+        public MeshGossipStats Gossip { get; set; } = new();
     }
 }
@@ -50,6 +50,18 @@ namespace AcornDB
             }
         }
 
+        /// <summary>
+        /// Reconcile with the remote by comparing Merkle trees, sending and receiving only the
+        /// nuts that differ instead of everything PushAll would
+        /// </summary>
+        public Task<MerkleDiff?> ReconcileAsync()
+        {
+            ThrowIfDisposed();
+
+            AcornLog.Info($"> 🌲 Tangle '{_id}' reconciling with remote...");
+            return _remoteBranch.ReconcileAsync(_local);
+        }
+
         /// <summary>
         /// Break the tangle connection (nutty alias for Dispose)
         /// Unregisters from tree and releases resources
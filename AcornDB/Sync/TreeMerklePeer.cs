@@ -0,0 +1,58 @@
+using System.Collections.Generic;
+using System.Linq;
+using System.Threading.Tasks;
+
+namespace AcornDB.Sync
+{
+    /// <summary>
+    /// Merkle peer backed by a tree in this process. Also what a server hands the
+    /// /merkle endpoints of a tree it hosts to.
+    /// </summary>
+    public class TreeMerklePeer<T> : IMerklePeer<T> where T : class
+    {
+        private readonly Tree<T> _tree;
+
+        public TreeMerklePeer(Tree<T> tree)
+        {
+            _tree = tree ?? throw new ArgumentNullException(nameof(tree));
+        }
+
+        public Task<MerkleSummary> GetSummaryAsync()
+        {
+            var merkle = _tree.Merkle;
+            return Task.FromResult(new MerkleSummary
+            {
+                Depth = merkle.Depth,
+                RootHash = merkle.RootHash,
+                Count = merkle.Count
+            });
+        }
+
+        public Task<IReadOnlyList<ulong>> GetChildHashesAsync(int level, IReadOnlyList<int> nodes)
+        {
+            return Task.FromResult<IReadOnlyList<ulong>>(_tree.Merkle.ChildHashes(level, nodes));
+        }
+
+        public Task<IReadOnlyDictionary<string, long>> GetLeafEntriesAsync(IReadOnlyList<int> leaves)
+        {
+            return Task.FromResult<IReadOnlyDictionary<string, long>>(_tree.Merkle.Entries(leaves));
+        }
+
+        public Task<IReadOnlyList<Nut<T>>> FetchAsync(IReadOnlyList<string> ids)
+        {
+            IReadOnlyList<Nut<T>> nuts = ids
+                .Select(_tree.CrackNut)
+                .Where(nut => nut != null)
+                .Select(nut => nut!)
+                .ToList();
+            return Task.FromResult(nuts);
+        }
+
+        public Task StoreAsync(IReadOnlyList<Nut<T>> nuts)
+        {
+            foreach (var nut in nuts)
+                _tree.Squabble(nut.Id, nut);
+            return Task.CompletedTask;
+        }
+    }
+}
@@ -0,0 +1,123 @@
+//! Sync apply and pull through [`LoopbackTransport`] in every wire format, at 1 to 64 clients:
+//! request and response encoding plus the sync store, without sockets or HTTP.
+//!
+//! Run with `cargo bench -p acorn-bench --bench sync_loopback`, then `bench-report` for a
+//! JSON summary.
+
+use std::hint::black_box;
+use std::sync::Arc;
+
+use acorn_bench::workload::{key, run_threads, value, THREADS};
+use acorn_bench::LoopbackTransport;
+use acorn_core::BranchId;
+use acorn_sync::{SyncApplyRequest, SyncBatch, SyncMutation, SyncTransport, WireFormat};
+use acorn_sync_server::{BackendTrunk, SyncStore};
+use acorn_trunk_mem::MemoryTrunk;
+use criterion::{criterion_group, criterion_main, BenchmarkId, Criterion, Throughput};
+
+const FORMATS: [(&str, WireFormat); 3] = [
+    ("json", WireFormat::Json),
+    ("binary", WireFormat::Binary),
+    ("binary_zstd", WireFormat::BinaryZstd),
+];
+const BATCHES_PER_CLIENT: usize = 4;
+const OPS_PER_BATCH: usize = 32;
+const PULL_KEYS: usize = 4096;
+const PULL_PAGE: usize = 512;
+
+fn transport(format: WireFormat) -> LoopbackTransport {
+    LoopbackTransport::new(Arc::new(SyncStore::new(BackendTrunk::Memory(MemoryTrunk::new()))))
+        .with_format(format)
+}
+
+/// Each client pushes to its own branch, so runs measure encoding and apply rather than
+/// waiting on one branch's ordering gate.
+fn client_requests(client: usize) -> Vec<SyncApplyRequest> {
+    let branch = BranchId::new(format!("client-{client}"));
+    (0..BATCHES_PER_CLIENT)
+        .map(|round| SyncApplyRequest {
+            batch: SyncBatch {
+                branch: branch.clone(),
+                operations: (0..OPS_PER_BATCH)
+                    .map(|op| SyncMutation::Put {
+                        key: key(client, round * OPS_PER_BATCH + op),
+                        value: value(client, op).value,
+                        version: None,
+                    })
+                    .collect(),
+            },
+        })
+        .collect()
+}
+
+fn apply(c: &mut Criterion) {
+    for (name, format) in FORMATS {
+        let transport = transport(format);
+        for clients in THREADS {
+            let requests: Vec<_> = (0..clients).map(client_requests).collect();
+            let mut group = c.benchmark_group(format!("sync_apply/{name}"));
+            group.sample_size(10);
+            group.throughput(Throughput::Elements(
+                (clients * BATCHES_PER_CLIENT * OPS_PER_BATCH) as u64,
+            ));
+            group.bench_function(BenchmarkId::from_parameter(clients), |b| {
+                b.iter(|| {
+                    run_threads(clients, |client| {
+                        for request in &requests[client] {
+                            black_box(transport.apply(request).unwrap());
+                        }
+                    })
+                });
+            });
+        }
+    }
+}
+
+/// Paged full pulls of one shared branch by concurrent clients.
+fn pull(c: &mut Criterion) {
+    let branch = BranchId::new("pull");
+    for (name, format) in FORMATS {
+        let transport = transport(format);
+        for chunk in (0..PULL_KEYS).collect::<Vec<_>>().chunks(OPS_PER_BATCH) {
+            let request = SyncApplyRequest {
+                batch: SyncBatch {
+                    branch: branch.clone(),
+                    operations: chunk
+                        .iter()
+                        .map(|&op| SyncMutation::Put {
+                            key: key(0, op),
+                            value: value(0, op).value,
+                            version: None,
+                        })
+                        .collect(),
+                },
+            };
+            transport.apply(&request).unwrap();
+        }
+
+        for clients in THREADS {
+            let mut group = c.benchmark_group(format!("sync_pull/{name}"));
+            group.sample_size(10);
+            group.throughput(Throughput::Elements((clients * PULL_KEYS) as u64));
+            group.bench_function(BenchmarkId::from_parameter(clients), |b| {
+                b.iter(|| {
+                    run_threads(clients, |_| {
+                        let mut cursor = None;
+                        loop {
+                            let page = transport
+                                .pull_since(&branch, cursor.as_ref(), Some(PULL_PAGE))
+                                .unwrap();
+                            cursor = page.cursor;
+                            if !page.has_more {
+                                break;
+                            }
+                        }
+                    })
+                });
+            });
+        }
+    }
+}
+
+criterion_group!(benches, apply, pull);
+criterion_main!(benches);
@@ -0,0 +1,192 @@
+//! Get, put, compare-and-set, history and TTL throughput of every trunk that runs without an
+//! external service, at 1 to 64 threads sharing one branch (each thread on its own keys).
+//!
+//! Run with `cargo bench -p acorn-bench --bench trunk_ops`, then `bench-report` for a JSON
+//! summary.
+
+use std::hint::black_box;
+use std::time::{Duration, SystemTime};
+
+use acorn_bench::workload::{key, run_threads, value, OPS_PER_THREAD, THREADS};
+use acorn_core::{BranchId, HistoryProvider, Trunk, TtlCleaner, TtlProvider};
+use acorn_trunk_cloud::{CloudOptions, CloudTrunk, InMemoryObjectStore};
+use acorn_trunk_file::{FileTrunk, SegmentTrunk};
+use acorn_trunk_mem::MemoryTrunk;
+use criterion::{
+    criterion_group, criterion_main, BatchSize, BenchmarkGroup, BenchmarkId, Criterion, Throughput,
+};
+use tempfile::TempDir;
+
+type Group<'a> = BenchmarkGroup<'a, criterion::measurement::WallTime>;
+
+fn branch() -> BranchId {
+    BranchId::new("bench")
+}
+
+fn fill<T: Trunk<Vec<u8>>>(trunk: &T, branch: &BranchId, threads: usize) {
+    run_threads(threads, |thread| {
+        for op in 0..OPS_PER_THREAD {
+            trunk.put(branch, &key(thread, op), value(thread, op)).unwrap();
+        }
+    });
+}
+
+fn group<'a>(c: &'a mut Criterion, name: &str, threads: usize) -> Group<'a> {
+    let mut group = c.benchmark_group(name);
+    group.sample_size(10);
+    group.throughput(Throughput::Elements((threads * OPS_PER_THREAD) as u64));
+    group
+}
+
+/// Get, put and compare-and-set, which every trunk supports.
+fn bench_basic<T: Trunk<Vec<u8>>>(c: &mut Criterion, name: &str, trunk: &T) {
+    let branch = branch();
+    for threads in THREADS {
+        group(c, "put", threads).bench_function(BenchmarkId::new(name, threads), |b| {
+            b.iter(|| fill(trunk, &branch, threads));
+        });
+
+        fill(trunk, &branch, threads);
+        group(c, "get", threads).bench_function(BenchmarkId::new(name, threads), |b| {
+            b.iter(|| {
+                run_threads(threads, |thread| {
+                    for op in 0..OPS_PER_THREAD {
+                        black_box(trunk.get(&branch, &key(thread, op)).unwrap());
+                    }
+                })
+            });
+        });
+
+        // Read the version then write against it, as a sync apply with versions would
+        group(c, "cas", threads).bench_function(BenchmarkId::new(name, threads), |b| {
+            b.iter(|| {
+                run_threads(threads, |thread| {
+                    for op in 0..OPS_PER_THREAD {
+                        let key = key(thread, op);
+                        let expected = trunk.version(&branch, &key);
+                        trunk
+                            .put_if_version(&branch, &key, expected, value(thread, op + 1))
+                            .unwrap();
+                    }
+                })
+            });
+        });
+    }
+}
+
+/// Full history replay by concurrent readers, over a branch every thread has written to.
+fn bench_history<T: HistoryProvider<Vec<u8>>>(c: &mut Criterion, name: &str, trunk: &T) {
+    let branch = BranchId::new("history");
+    fill(trunk, &branch, THREADS[THREADS.len() - 1]);
+    let events = trunk.history_since(&branch, 0).unwrap().count();
+    for threads in THREADS {
+        let mut group = c.benchmark_group("history");
+        group.sample_size(10);
+        group.throughput(Throughput::Elements((threads * events) as u64));
+        group.bench_function(BenchmarkId::new(name, threads), |b| {
+            b.iter(|| {
+                run_threads(threads, |_| {
+                    for event in trunk.history_since(&branch, 0).unwrap() {
+                        black_box(event.unwrap());
+                    }
+                })
+            });
+        });
+    }
+}
+
+/// Writes with a deadline, and purges of already expired entries with each thread purging
+/// its own branch.
+fn bench_ttl<T, F>(c: &mut Criterion, name: &str, make: F)
+where
+    T: TtlProvider<Vec<u8>> + TtlCleaner<Vec<u8>>,
+    F: Fn() -> (Option<TempDir>, T),
+{
+    let (_dir, trunk) = make();
+    let expires_at = SystemTime::now() + Duration::from_secs(3600);
+    for threads in THREADS {
+        group(c, "ttl_put", threads).bench_function(BenchmarkId::new(name, threads), |b| {
+            b.iter(|| {
+                run_threads(threads, |thread| {
+                    let branch = branch();
+                    for op in 0..OPS_PER_THREAD {
+                        trunk
+                            .put_with_ttl(&branch, &key(thread, op), value(thread, op), ttl(expires_at))
+                            .unwrap();
+                    }
+                })
+            });
+        });
+
+        group(c, "ttl_purge", threads).bench_function(BenchmarkId::new(name, threads), |b| {
+            b.iter_batched(
+                || {
+                    let (dir, trunk) = make();
+                    let expired = SystemTime::now() - Duration::from_secs(1);
+                    run_threads(threads, |thread| {
+                        let branch = BranchId::new(format!("ttl-{thread}"));
+                        for op in 0..OPS_PER_THREAD {
+                            trunk
+                                .put_with_ttl(&branch, &key(thread, op), value(thread, op), ttl(expired))
+                                .unwrap();
+                        }
+                    });
+                    (dir, trunk)
+                },
+                |(dir, trunk)| {
+                    run_threads(threads, |thread| {
+                        let purged = trunk.purge_expired(&BranchId::new(format!("ttl-{thread}")));
+                        assert_eq!(purged, OPS_PER_THREAD);
+                    });
+                    (dir, trunk)
+                },
+                BatchSize::PerIteration,
+            );
+        });
+    }
+}
+
+fn ttl(expires_at: SystemTime) -> acorn_core::Ttl {
+    acorn_core::Ttl { expires_at }
+}
+
+fn memory_trunks(c: &mut Criterion) {
+    let memory = MemoryTrunk::new();
+    bench_basic(c, "memory", &memory);
+    bench_history(c, "memory", &memory);
+    bench_ttl(c, "memory", || (None, MemoryTrunk::new()));
+
+    let sharded = MemoryTrunk::sharded_for_host();
+    bench_basic(c, "memory_sharded", &sharded);
+    bench_ttl(c, "memory_sharded", || (None, MemoryTrunk::sharded_for_host()));
+}
+
+fn file_trunks(c: &mut Criterion) {
+    let dir = tempfile::tempdir().unwrap();
+    let segment = SegmentTrunk::new(dir.path().join("segment"));
+    bench_basic(c, "segment", &segment);
+    bench_ttl(c, "segment", || {
+        let dir = tempfile::tempdir().unwrap();
+        let trunk = SegmentTrunk::new(dir.path());
+        (Some(dir), trunk)
+    });
+
+    let file = FileTrunk::with_history_and_ttl(dir.path().join("file"));
+    bench_basic(c, "file", &file);
+    bench_history(c, "file", &file);
+    bench_ttl(c, "file", || {
+        let dir = tempfile::tempdir().unwrap();
+        let trunk = FileTrunk::with_history_and_ttl(dir.path());
+        (Some(dir), trunk)
+    });
+}
+
+/// The cloud trunk over an in-memory object store: measures its buffering, packing and
+/// caching, not a provider's network.
+fn cloud_trunk(c: &mut Criterion) {
+    let cloud = CloudTrunk::new(InMemoryObjectStore::new(), CloudOptions::default()).unwrap();
+    bench_basic(c, "cloud_memory", &cloud);
+}
+
+criterion_group!(benches, memory_trunks, file_trunks, cloud_trunk);
+criterion_main!(benches);
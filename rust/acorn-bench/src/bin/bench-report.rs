@@ -0,0 +1,83 @@
+//! Summarise a criterion run as JSON and optionally check it against an earlier summary.
+//!
+//! ```text
+//! cargo bench -p acorn-bench
+//! cargo run -p acorn-bench --bin bench-report -- --label "$(git rev-parse --short HEAD)" --out bench.json
+//! cargo run -p acorn-bench --bin bench-report -- --baseline main.json --threshold 0.1
+//! ```
+//!
+//! Exits with status 1 when any benchmark regressed past the threshold.
+
+use std::fs;
+use std::path::PathBuf;
+use std::process::ExitCode;
+
+use acorn_bench::report::{self, Report};
+use clap::Parser;
+
+#[derive(Parser)]
+#[command(name = "bench-report", about = "Summarise criterion results as JSON")]
+struct Cli {
+    /// Criterion output directory (defaults to `$CARGO_TARGET_DIR/criterion` or `target/criterion`).
+    #[arg(long)]
+    criterion_dir: Option<PathBuf>,
+    /// Label stored in the summary, e.g. a commit hash.
+    #[arg(long, default_value = "")]
+    label: String,
+    /// Write the summary here instead of stdout.
+    #[arg(long)]
+    out: Option<PathBuf>,
+    /// Earlier summary to compare against.
+    #[arg(long)]
+    baseline: Option<PathBuf>,
+    /// Slowdown of the mean, as a fraction, that counts as a regression.
+    #[arg(long, default_value_t = 0.10)]
+    threshold: f64,
+}
+
+fn main() -> ExitCode {
+    let cli = Cli::parse();
+    match run(cli) {
+        Ok(regressed) if regressed => ExitCode::FAILURE,
+        Ok(_) => ExitCode::SUCCESS,
+        Err(e) => {
+            eprintln!("bench-report: {e}");
+            ExitCode::from(2)
+        }
+    }
+}
+
+fn run(cli: Cli) -> std::io::Result<bool> {
+    let criterion_dir = cli.criterion_dir.unwrap_or_else(|| {
+        std::env::var_os("CARGO_TARGET_DIR")
+            .map(PathBuf::from)
+            .unwrap_or_else(|| PathBuf::from("target"))
+            .join("criterion")
+    });
+    let current = Report {
+        label: cli.label,
+        benchmarks: report::collect(&criterion_dir)?,
+    };
+
+    let json = serde_json::to_string_pretty(&current)?;
+    match &cli.out {
+        Some(path) => fs::write(path, json)?,
+        None => println!("{json}"),
+    }
+
+    let Some(baseline) = cli.baseline else {
+        return Ok(false);
+    };
+    let baseline: Report = serde_json::from_slice(&fs::read(baseline)?)?;
+    let regressions = report::compare(&baseline, &current, cli.threshold);
+    for regression in &regressions {
+        eprintln!(
+            "regressed {}: {:.0}ns -> {:.0}ns ({:+.1}%)",
+            regression.id,
+            regression.baseline_ns,
+            regression.current_ns,
+            regression.change * 100.0
+        );
+    }
+    Ok(!regressions.is_empty())
+}
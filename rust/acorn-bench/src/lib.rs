@@ -1,7 +1,18 @@
-#![allow(dead_code)]
+//! Shared pieces of the AcornDB benchmark suite.
+//!
+//! The criterion benches live in `benches/`: `trunk_ops` covers get/put/CAS/history/TTL on every
+//! trunk usable offline at 1 to 64 threads, and `sync_loopback` covers sync apply/pull through
+//! [`LoopbackTransport`]. [`report`] turns criterion's output into one JSON file per run so
+//! results can be compared across commits (see the `bench-report` binary).
 
 use acorn_core::AcornResult;
 
+pub mod loopback;
+pub mod report;
+pub mod workload;
+
+pub use loopback::LoopbackTransport;
+
 pub fn smoke_check() -> AcornResult<()> {
     Ok(())
 }
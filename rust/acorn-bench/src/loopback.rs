@@ -0,0 +1,114 @@
+//! In-process sync transport for benchmarks: requests and responses go through the same wire
+//! encoding the HTTP transport uses, straight into a [`SyncStore`], so a bench measures codec
+//! and store costs without a socket or an HTTP stack in the way.
+
+use std::sync::Arc;
+
+use acorn_core::BranchId;
+use acorn_sync::{
+    pull_snapshot, SyncApplyRequest, SyncApplyResponse, SyncCursor, SyncError, SyncPullResponse,
+    SyncTransport, WireFormat, WireMessage,
+};
+use acorn_sync_server::{SyncStore, MAX_PULL_LIMIT};
+
+#[derive(Debug, Clone)]
+pub struct LoopbackTransport {
+    store: Arc<SyncStore>,
+    format: WireFormat,
+}
+
+impl LoopbackTransport {
+    pub fn new(store: Arc<SyncStore>) -> Self {
+        Self {
+            store,
+            format: WireFormat::Json,
+        }
+    }
+
+    pub fn with_format(mut self, format: WireFormat) -> Self {
+        self.format = format;
+        self
+    }
+
+    pub fn store(&self) -> &SyncStore {
+        &self.store
+    }
+
+    /// Encode on one side and decode on the other, as a request or response would cross the
+    /// wire.
+    fn round_trip<M: WireMessage>(&self, message: &M) -> Result<M, SyncError> {
+        let bytes = self.format.encode(message)?;
+        self.format.decode(&bytes)
+    }
+}
+
+impl SyncTransport for LoopbackTransport {
+    fn apply(&self, request: &SyncApplyRequest) -> Result<SyncApplyResponse, SyncError> {
+        let request = self.round_trip(request)?;
+        let applied = self
+            .store
+            .apply(&request.batch)
+            .map_err(|e| SyncError::Storage(e.to_string()))?;
+        self.round_trip(&applied.response)
+    }
+
+    fn pull(&self, branch: &BranchId) -> Result<SyncPullResponse, SyncError> {
+        pull_snapshot(self, branch)
+    }
+
+    fn pull_since(
+        &self,
+        branch: &BranchId,
+        since: Option<&SyncCursor>,
+        limit: Option<usize>,
+    ) -> Result<SyncPullResponse, SyncError> {
+        let limit = limit.map(|limit| limit.min(MAX_PULL_LIMIT));
+        let response = self.store.pull(
+            branch,
+            since.map(|cursor| cursor.seq),
+            since.map(|cursor| cursor.epoch),
+            limit,
+        );
+        self.round_trip(&response)
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use acorn_sync::{SyncBatch, SyncMutation};
+    use acorn_sync_server::BackendTrunk;
+    use acorn_trunk_mem::MemoryTrunk;
+
+    fn put(key: &str) -> SyncMutation {
+        SyncMutation::Put {
+            key: key.into(),
+            value: key.as_bytes().to_vec(),
+            version: None,
+        }
+    }
+
+    #[test]
+    fn apply_then_pull_round_trips_through_each_format() {
+        for format in [WireFormat::Json, WireFormat::Binary] {
+            let store = Arc::new(SyncStore::new(BackendTrunk::Memory(MemoryTrunk::new())));
+            let transport = LoopbackTransport::new(store).with_format(format);
+            let branch = BranchId::new("bench");
+            let request = SyncApplyRequest {
+                batch: SyncBatch {
+                    branch: branch.clone(),
+                    operations: vec![put("a"), put("b")],
+                },
+            };
+            assert_eq!(transport.apply(&request).unwrap().applied, 2);
+
+            let first = transport.pull_since(&branch, None, Some(1)).unwrap();
+            assert_eq!(first.batch.operations.len(), 1);
+            assert!(first.has_more);
+            let rest = transport
+                .pull_since(&branch, first.cursor.as_ref(), None)
+                .unwrap();
+            assert_eq!(rest.batch.operations.len(), 1);
+        }
+    }
+}
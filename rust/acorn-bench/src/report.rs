@@ -0,0 +1,230 @@
+//! Criterion results as one JSON document per run, so two runs (say, two commits) can be
+//! diffed without criterion's HTML report or its per-machine baselines.
+//!
+//! [`collect`] reads the `new/` estimates criterion leaves under `target/criterion`, and
+//! [`compare`] lists the benchmarks whose mean got slower than a baseline by more than a
+//! threshold.
+
+use std::fs;
+use std::io;
+use std::path::Path;
+
+use serde::de::IgnoredAny;
+use serde::{Deserialize, Serialize};
+
+#[derive(Debug, Clone, Default, PartialEq, Serialize, Deserialize)]
+pub struct Report {
+    /// Free-form run label, typically the commit the run was taken at.
+    pub label: String,
+    pub benchmarks: Vec<BenchResult>,
+}
+
+#[derive(Debug, Clone, PartialEq, Serialize, Deserialize)]
+pub struct BenchResult {
+    /// Criterion's full id, e.g. `put/memory/16`.
+    pub id: String,
+    pub mean_ns: f64,
+    pub median_ns: f64,
+    pub std_dev_ns: f64,
+    /// Elements per iteration when the bench declared a throughput.
+    #[serde(default, skip_serializing_if = "Option::is_none")]
+    pub elements: Option<u64>,
+    #[serde(default, skip_serializing_if = "Option::is_none")]
+    pub elements_per_sec: Option<f64>,
+}
+
+#[derive(Debug, Clone, PartialEq, Serialize)]
+pub struct Regression {
+    pub id: String,
+    pub baseline_ns: f64,
+    pub current_ns: f64,
+    /// Relative change of the mean; 0.25 is 25% slower.
+    pub change: f64,
+}
+
+#[derive(Deserialize)]
+struct Estimates {
+    mean: Estimate,
+    median: Estimate,
+    std_dev: Estimate,
+}
+
+#[derive(Deserialize)]
+struct Estimate {
+    point_estimate: f64,
+}
+
+#[derive(Deserialize)]
+struct BenchmarkInfo {
+    full_id: String,
+    #[serde(default)]
+    throughput: Option<Throughput>,
+}
+
+#[derive(Deserialize)]
+enum Throughput {
+    Elements(u64),
+    Bytes(IgnoredAny),
+    BytesDecimal(IgnoredAny),
+}
+
+/// Every benchmark with a `new/` estimate under `criterion_dir`, sorted by id.
+pub fn collect(criterion_dir: &Path) -> io::Result<Vec<BenchResult>> {
+    let mut results = Vec::new();
+    walk(criterion_dir, &mut results)?;
+    results.sort_by(|a, b| a.id.cmp(&b.id));
+    Ok(results)
+}
+
+fn walk(dir: &Path, results: &mut Vec<BenchResult>) -> io::Result<()> {
+    let new = dir.join("new");
+    if new.join("estimates.json").is_file() && new.join("benchmark.json").is_file() {
+        results.push(read_result(&new)?);
+        return Ok(());
+    }
+    for entry in fs::read_dir(dir)? {
+        let entry = entry?;
+        // `report/` holds criterion's HTML and never has estimates
+        if entry.file_type()?.is_dir() && entry.file_name() != "report" {
+            walk(&entry.path(), results)?;
+        }
+    }
+    Ok(())
+}
+
+fn read_result(new: &Path) -> io::Result<BenchResult> {
+    let estimates: Estimates = serde_json::from_slice(&fs::read(new.join("estimates.json"))?)?;
+    let info: BenchmarkInfo = serde_json::from_slice(&fs::read(new.join("benchmark.json"))?)?;
+    let elements = match info.throughput {
+        Some(Throughput::Elements(n)) => Some(n),
+        Some(Throughput::Bytes(_) | Throughput::BytesDecimal(_)) | None => None,
+    };
+    let mean_ns = estimates.mean.point_estimate;
+    Ok(BenchResult {
+        id: info.full_id,
+        mean_ns,
+        median_ns: estimates.median.point_estimate,
+        std_dev_ns: estimates.std_dev.point_estimate,
+        elements,
+        elements_per_sec: elements
+            .filter(|_| mean_ns > 0.0)
+            .map(|n| n as f64 * 1e9 / mean_ns),
+    })
+}
+
+/// Benchmarks present in both reports whose mean grew by more than `threshold` (a fraction),
+/// worst first.
+pub fn compare(baseline: &Report, current: &Report, threshold: f64) -> Vec<Regression> {
+    let mut regressions: Vec<Regression> = current
+        .benchmarks
+        .iter()
+        .filter_map(|now| {
+            let before = baseline.benchmarks.iter().find(|b| b.id == now.id)?;
+            if before.mean_ns <= 0.0 {
+                return None;
+            }
+            let change = now.mean_ns / before.mean_ns - 1.0;
+            (change > threshold).then(|| Regression {
+                id: now.id.clone(),
+                baseline_ns: before.mean_ns,
+                current_ns: now.mean_ns,
+                change,
+            })
+        })
+        .collect();
+    regressions.sort_by(|a, b| b.change.total_cmp(&a.change));
+    regressions
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn write_bench(root: &Path, dir: &str, full_id: &str, mean: f64, throughput: &str) {
+        let new = root.join(dir).join("new");
+        fs::create_dir_all(&new).unwrap();
+        let estimate = |v: f64| format!(r#"{{"point_estimate":{v},"standard_error":1.0}}"#);
+        fs::write(
+            new.join("estimates.json"),
+            format!(
+                r#"{{"mean":{},"median":{},"std_dev":{},"slope":null}}"#,
+                estimate(mean),
+                estimate(mean - 10.0),
+                estimate(5.0)
+            ),
+        )
+        .unwrap();
+        fs::write(
+            new.join("benchmark.json"),
+            format!(r#"{{"group_id":"g","full_id":"{full_id}","throughput":{throughput}}}"#),
+        )
+        .unwrap();
+    }
+
+    fn result(id: &str, mean_ns: f64) -> BenchResult {
+        BenchResult {
+            id: id.into(),
+            mean_ns,
+            median_ns: mean_ns,
+            std_dev_ns: 0.0,
+            elements: None,
+            elements_per_sec: None,
+        }
+    }
+
+    #[test]
+    fn collect_reads_new_estimates_and_skips_reports() {
+        let dir = tempfile::tempdir().unwrap();
+        write_bench(
+            dir.path(),
+            "put/memory/16",
+            "put/memory/16",
+            2_000.0,
+            r#"{"Elements":1000}"#,
+        );
+        write_bench(dir.path(), "get/file/1", "get/file/1", 500.0, "null");
+        fs::create_dir_all(dir.path().join("report")).unwrap();
+        fs::create_dir_all(dir.path().join("get/file/1/base")).unwrap();
+
+        let results = collect(dir.path()).unwrap();
+        assert_eq!(results.len(), 2);
+        assert_eq!(results[0].id, "get/file/1");
+        assert_eq!(results[0].elements, None);
+        assert_eq!(results[1].median_ns, 1_990.0);
+        assert_eq!(results[1].elements, Some(1000));
+        assert_eq!(results[1].elements_per_sec, Some(500_000_000.0));
+    }
+
+    #[test]
+    fn compare_flags_only_slowdowns_past_threshold() {
+        let baseline = Report {
+            label: "before".into(),
+            benchmarks: vec![result("a", 100.0), result("b", 100.0), result("c", 100.0)],
+        };
+        let current = Report {
+            label: "after".into(),
+            benchmarks: vec![
+                result("a", 105.0),
+                result("b", 150.0),
+                result("c", 80.0),
+                result("new", 1.0),
+            ],
+        };
+
+        let regressions = compare(&baseline, &current, 0.10);
+        assert_eq!(regressions.len(), 1);
+        assert_eq!(regressions[0].id, "b");
+        assert!((regressions[0].change - 0.5).abs() < 1e-9);
+    }
+
+    #[test]
+    fn report_round_trips_through_json() {
+        let report = Report {
+            label: "abc123".into(),
+            benchmarks: vec![result("a", 1.5)],
+        };
+        let json = serde_json::to_string(&report).unwrap();
+        assert!(!json.contains("elements"));
+        assert_eq!(serde_json::from_str::<Report>(&json).unwrap(), report);
+    }
+}
@@ -0,0 +1,60 @@
+//! Workload shapes shared by the benches, so every trunk sees the same keys, values and
+//! thread counts.
+
+use acorn_core::Nut;
+
+/// Concurrent client counts each bench runs at.
+pub const THREADS: [usize; 4] = [1, 4, 16, 64];
+pub const OPS_PER_THREAD: usize = 64;
+pub const VALUE_BYTES: usize = 128;
+
+pub fn key(thread: usize, op: usize) -> String {
+    format!("t{thread}-k{op}")
+}
+
+/// A value whose bytes differ per key, so compressing or deduplicating stores do not get
+/// an easy ride.
+pub fn value(thread: usize, op: usize) -> Nut<Vec<u8>> {
+    let seed = (thread * 31 + op) as u8;
+    Nut {
+        value: (0..VALUE_BYTES).map(|i| seed.wrapping_add(i as u8)).collect(),
+    }
+}
+
+/// Run `work(thread)` on `threads` scoped threads and wait for all of them.
+pub fn run_threads<F>(threads: usize, work: F)
+where
+    F: Fn(usize) + Sync,
+{
+    if threads == 1 {
+        work(0);
+        return;
+    }
+    std::thread::scope(|scope| {
+        for thread in 0..threads {
+            let work = &work;
+            scope.spawn(move || work(thread));
+        }
+    });
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::sync::atomic::{AtomicUsize, Ordering};
+
+    #[test]
+    fn run_threads_runs_each_thread_once() {
+        let ran = AtomicUsize::new(0);
+        run_threads(16, |thread| {
+            ran.fetch_add(thread + 1, Ordering::Relaxed);
+        });
+        assert_eq!(ran.load(Ordering::Relaxed), (1..=16).sum::<usize>());
+    }
+
+    #[test]
+    fn values_differ_per_key() {
+        assert_ne!(value(0, 1).value, value(1, 0).value);
+        assert_eq!(value(2, 3).value.len(), VALUE_BYTES);
+    }
+}
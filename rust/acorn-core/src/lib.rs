@@ -1,12 +1,18 @@
 #![allow(dead_code)]
 
-use std::collections::{HashMap, VecDeque};
+use std::collections::HashMap;
 use std::fmt::{self, Debug};
 use std::marker::PhantomData;
 use std::time::SystemTime;
 
 use serde::{de::DeserializeOwned, Serialize};
 
+pub mod msgpack;
+pub mod ttl;
+
+pub use msgpack::MsgPackCodec;
+pub use ttl::{ExpiryIndex, TtlCounters, TtlStats};
+
 pub type AcornResult<T> = Result<T, AcornError>;
 
 #[derive(Debug, thiserror::Error)]
@@ -110,6 +116,11 @@ pub trait TombstoneProvider<T>: Trunk<T> {
 pub trait TtlCleaner<T>: Trunk<T> {
     /// Purge expired entries for the given branch. Returns count removed.
     fn purge_expired(&self, branch: &BranchId) -> usize;
+
+    /// What purges have done so far, across branches.
+    fn ttl_stats(&self) -> TtlStats {
+        TtlStats::default()
+    }
 }
 
 /// Capability flags for trunks; extend as behaviors are implemented.
@@ -134,8 +145,35 @@ pub enum HistoryEvent<T> {
     Delete { key: String },
 }
 
+/// History event tagged with its position in the branch change sequence (starting at 1).
+#[derive(Debug, Clone, serde::Serialize, serde::Deserialize)]
+#[serde(bound(serialize = "T: Serialize", deserialize = "T: DeserializeOwned"))]
+pub struct SequencedEvent<T> {
+    pub seq: u64,
+    pub event: HistoryEvent<T>,
+}
+
+/// Streaming iterator over sequenced history events.
+pub type HistoryIter<'a, T> = Box<dyn Iterator<Item = AcornResult<SequencedEvent<T>>> + 'a>;
+
 pub trait HistoryProvider<T>: Trunk<T> {
     fn history(&self, branch: &BranchId) -> AcornResult<Vec<HistoryEvent<T>>>;
+
+    /// Stream events with a sequence number greater than `since`.
+    /// The default materializes `history()`; trunks with a persistent log should stream it.
+    fn history_since<'a>(&'a self, branch: &BranchId, since: u64) -> AcornResult<HistoryIter<'a, T>>
+    where
+        T: 'a,
+    {
+        let events = self.history(branch)?;
+        Ok(Box::new(
+            events
+                .into_iter()
+                .zip(1u64..)
+                .filter(move |(_, seq)| *seq > since)
+                .map(|(event, seq)| Ok(SequencedEvent { seq, event })),
+        ))
+    }
 }
 
 pub trait TtlProvider<T>: Trunk<T> {
@@ -224,6 +262,20 @@ where
     }
 }
 
+impl<T, S> Tree<T, S>
+where
+    T: Clone + Send + Sync + 'static,
+    S: Trunk<T> + TtlCleaner<T> + Clone,
+{
+    pub fn purge_expired(&self) -> usize {
+        self.trunk.purge_expired(&self.branch)
+    }
+
+    pub fn ttl_stats(&self) -> TtlStats {
+        self.trunk.ttl_stats()
+    }
+}
+
 /// Tree wrapper that encodes/decodes typed payloads to byte-oriented trunks.
 #[derive(Debug, Clone)]
 pub struct EncodedTree<T, S, C>
@@ -271,13 +323,26 @@ where
     }
 }
 
-/// Minimal LRU cache skeleton for helpers/tests.
+/// Small LRU cache for helpers/tests. Entries live in a slab linked by index, most recent
+/// first, so `get` and `put` are O(1): a touch relinks one entry instead of searching the
+/// recency order, and eviction reuses the least recent entry's slot.
 pub struct LruCache<K, V> {
     capacity: usize,
-    order: VecDeque<K>,
-    map: HashMap<K, V>,
+    map: HashMap<K, usize>,
+    entries: Vec<LruEntry<K, V>>,
+    head: usize,
+    tail: usize,
 }
 
+struct LruEntry<K, V> {
+    key: K,
+    value: V,
+    prev: usize,
+    next: usize,
+}
+
+const LRU_NIL: usize = usize::MAX;
+
 impl<K, V> LruCache<K, V>
 where
     K: Eq + std::hash::Hash + Clone,
@@ -285,47 +350,84 @@ where
     pub fn new(capacity: usize) -> Self {
         Self {
             capacity: capacity.max(1),
-            order: VecDeque::new(),
             map: HashMap::new(),
+            entries: Vec::new(),
+            head: LRU_NIL,
+            tail: LRU_NIL,
         }
     }
 
     pub fn put(&mut self, key: K, value: V) {
-        if self.map.contains_key(&key) {
-            self.map.insert(key.clone(), value);
-            self.touch(&key);
-        } else {
-            self.map.insert(key.clone(), value);
-            self.order.push_back(key);
-            self.evict_if_needed();
+        if let Some(&idx) = self.map.get(&key) {
+            self.entries[idx].value = value;
+            self.touch(idx);
+            return;
         }
+
+        let idx = if self.entries.len() < self.capacity {
+            self.entries.push(LruEntry {
+                key: key.clone(),
+                value,
+                prev: LRU_NIL,
+                next: LRU_NIL,
+            });
+            self.entries.len() - 1
+        } else {
+            // Full: the least recently used slot takes the new entry.
+            let idx = self.tail;
+            self.unlink(idx);
+            let entry = &mut self.entries[idx];
+            let old_key = std::mem::replace(&mut entry.key, key.clone());
+            entry.value = value;
+            self.map.remove(&old_key);
+            idx
+        };
+        self.map.insert(key, idx);
+        self.push_front(idx);
     }
 
     pub fn get(&mut self, key: &K) -> Option<&V> {
-        if self.map.contains_key(key) {
-            self.touch(key);
+        let idx = *self.map.get(key)?;
+        self.touch(idx);
+        Some(&self.entries[idx].value)
+    }
+
+    fn touch(&mut self, idx: usize) {
+        if self.head != idx {
+            self.unlink(idx);
+            self.push_front(idx);
         }
-        self.map.get(key)
     }
 
-    fn touch(&mut self, key: &K) {
-        if let Some(pos) = self.order.iter().position(|k| k == key) {
-            self.order.remove(pos);
-            self.order.push_back(key.clone());
+    fn unlink(&mut self, idx: usize) {
+        let (prev, next) = (self.entries[idx].prev, self.entries[idx].next);
+        match prev {
+            LRU_NIL => self.head = next,
+            p => self.entries[p].next = next,
+        }
+        match next {
+            LRU_NIL => self.tail = prev,
+            n => self.entries[n].prev = prev,
         }
     }
 
-    fn evict_if_needed(&mut self) {
-        while self.map.len() > self.capacity {
-            if let Some(old_key) = self.order.pop_front() {
-                self.map.remove(&old_key);
-            }
+    fn push_front(&mut self, idx: usize) {
+        self.entries[idx].prev = LRU_NIL;
+        self.entries[idx].next = self.head;
+        match self.head {
+            LRU_NIL => self.tail = idx,
+            h => self.entries[h].prev = idx,
         }
+        self.head = idx;
     }
 
     pub fn len(&self) -> usize {
         self.map.len()
     }
+
+    pub fn is_empty(&self) -> bool {
+        self.map.is_empty()
+    }
 }
 
 #[cfg(test)]
@@ -349,4 +451,47 @@ mod tests {
         let decoded: Demo = codec.decode(&bytes).unwrap();
         assert_eq!(decoded, original);
     }
+
+    #[test]
+    fn lru_cache_evicts_least_recently_used() {
+        let mut cache = LruCache::new(3);
+        cache.put("a", 1);
+        cache.put("b", 2);
+        cache.put("c", 3);
+        assert_eq!(cache.get(&"a"), Some(&1));
+
+        cache.put("d", 4);
+        assert_eq!(cache.get(&"b"), None);
+        assert_eq!(cache.len(), 3);
+
+        cache.put("c", 30);
+        cache.put("e", 5);
+        assert_eq!(cache.get(&"a"), None);
+        assert_eq!(cache.get(&"c"), Some(&30));
+        assert_eq!(cache.get(&"d"), Some(&4));
+        assert_eq!(cache.get(&"e"), Some(&5));
+    }
+
+    #[test]
+    fn lru_cache_single_slot_and_touch_order() {
+        let mut cache = LruCache::new(0);
+        assert!(cache.is_empty());
+        cache.put(1, "x");
+        cache.put(2, "y");
+        assert_eq!(cache.get(&1), None);
+        assert_eq!(cache.get(&2), Some(&"y"));
+
+        let mut cache = LruCache::new(1000);
+        for i in 0..1000 {
+            cache.put(i, i);
+        }
+        for i in (0..1000).step_by(2) {
+            cache.get(&i);
+        }
+        for i in 1000..1500 {
+            cache.put(i, i);
+        }
+        assert!((1..1000).step_by(2).all(|i| cache.get(&i).is_none()));
+        assert!((0..1000).step_by(2).all(|i| cache.get(&i) == Some(&i)));
+    }
 }
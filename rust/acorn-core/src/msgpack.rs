@@ -0,0 +1,507 @@
+//! MessagePack codec matching the C# `MsgPackSerializer`, so documents written by either
+//! side decode on the other.
+//!
+//! Structs are maps keyed by field name, integers use the narrowest encoding and floats are
+//! float64. Timestamp extensions (type -1, as the C# side writes `DateTime`) decode to
+//! RFC 3339 strings, which chrono and the C# reader both accept. Payloads that start like
+//! JSON are decoded as JSON, so stores written before switching codecs keep reading.
+
+use serde::{de::DeserializeOwned, Serialize};
+use serde_json::{Map, Number, Value};
+
+use crate::{AcornError, AcornResult, NutCodec};
+
+/// Deepest nesting accepted on decode; matches `MsgPackSerializer.MaxDepth`.
+pub const MAX_DEPTH: usize = 64;
+
+const TIMESTAMP_EXT: i8 = -1;
+
+/// Binary codec producing MessagePack; see the module docs for the mapping.
+#[derive(Debug, Clone, Copy, Default)]
+pub struct MsgPackCodec;
+
+impl<T> NutCodec<T> for MsgPackCodec
+where
+    T: Serialize + DeserializeOwned,
+{
+    fn encode(&self, value: &T) -> AcornResult<Vec<u8>> {
+        let value = serde_json::to_value(value).map_err(|e| AcornError::Serialization(e.to_string()))?;
+        let mut out = Vec::with_capacity(128);
+        write_value(&value, &mut out);
+        Ok(out)
+    }
+
+    fn decode(&self, bytes: &[u8]) -> AcornResult<T> {
+        if starts_like_json(bytes) {
+            if let Ok(value) = serde_json::from_slice(bytes) {
+                return Ok(value);
+            }
+        }
+
+        let mut reader = Reader { data: bytes, pos: 0 };
+        let value = reader.read_value(0)?;
+        serde_json::from_value(value).map_err(|e| AcornError::Serialization(e.to_string()))
+    }
+}
+
+/// A MessagePack map or array never starts with these bytes; a bare small integer can,
+/// which is why a failed JSON parse still falls through to MessagePack.
+fn starts_like_json(bytes: &[u8]) -> bool {
+    matches!(
+        bytes.first(),
+        Some(b'{' | b'[' | b' ' | b'\t' | b'\r' | b'\n' | 0xEF)
+    )
+}
+
+fn write_value(value: &Value, out: &mut Vec<u8>) {
+    match value {
+        Value::Null => out.push(0xc0),
+        Value::Bool(b) => out.push(if *b { 0xc3 } else { 0xc2 }),
+        Value::Number(n) => write_number(n, out),
+        Value::String(s) => write_str(s, out),
+        Value::Array(items) => {
+            write_header(items.len(), 0x90, 0xdc, 0xdd, out);
+            for item in items {
+                write_value(item, out);
+            }
+        }
+        Value::Object(map) => {
+            write_header(map.len(), 0x80, 0xde, 0xdf, out);
+            for (key, item) in map {
+                write_str(key, out);
+                write_value(item, out);
+            }
+        }
+    }
+}
+
+fn write_number(n: &Number, out: &mut Vec<u8>) {
+    if let Some(u) = n.as_u64() {
+        write_uint(u, out);
+    } else if let Some(i) = n.as_i64() {
+        write_int(i, out);
+    } else {
+        out.push(0xcb);
+        out.extend_from_slice(&n.as_f64().unwrap_or(f64::NAN).to_be_bytes());
+    }
+}
+
+fn write_uint(u: u64, out: &mut Vec<u8>) {
+    if u <= 0x7f {
+        out.push(u as u8);
+    } else if u <= u8::MAX as u64 {
+        out.extend_from_slice(&[0xcc, u as u8]);
+    } else if u <= u16::MAX as u64 {
+        out.push(0xcd);
+        out.extend_from_slice(&(u as u16).to_be_bytes());
+    } else if u <= u32::MAX as u64 {
+        out.push(0xce);
+        out.extend_from_slice(&(u as u32).to_be_bytes());
+    } else {
+        out.push(0xcf);
+        out.extend_from_slice(&u.to_be_bytes());
+    }
+}
+
+fn write_int(i: i64, out: &mut Vec<u8>) {
+    if i >= 0 {
+        write_uint(i as u64, out);
+    } else if i >= -32 {
+        out.push(i as i8 as u8);
+    } else if i >= i8::MIN as i64 {
+        out.extend_from_slice(&[0xd0, i as i8 as u8]);
+    } else if i >= i16::MIN as i64 {
+        out.push(0xd1);
+        out.extend_from_slice(&(i as i16).to_be_bytes());
+    } else if i >= i32::MIN as i64 {
+        out.push(0xd2);
+        out.extend_from_slice(&(i as i32).to_be_bytes());
+    } else {
+        out.push(0xd3);
+        out.extend_from_slice(&i.to_be_bytes());
+    }
+}
+
+fn write_str(s: &str, out: &mut Vec<u8>) {
+    let len = s.len();
+    if len <= 31 {
+        out.push(0xa0 | len as u8);
+    } else if len <= u8::MAX as usize {
+        out.extend_from_slice(&[0xd9, len as u8]);
+    } else if len <= u16::MAX as usize {
+        out.push(0xda);
+        out.extend_from_slice(&(len as u16).to_be_bytes());
+    } else {
+        out.push(0xdb);
+        out.extend_from_slice(&(len as u32).to_be_bytes());
+    }
+    out.extend_from_slice(s.as_bytes());
+}
+
+fn write_header(len: usize, fix: u8, code16: u8, code32: u8, out: &mut Vec<u8>) {
+    if len <= 15 {
+        out.push(fix | len as u8);
+    } else if len <= u16::MAX as usize {
+        out.push(code16);
+        out.extend_from_slice(&(len as u16).to_be_bytes());
+    } else {
+        out.push(code32);
+        out.extend_from_slice(&(len as u32).to_be_bytes());
+    }
+}
+
+struct Reader<'a> {
+    data: &'a [u8],
+    pos: usize,
+}
+
+impl<'a> Reader<'a> {
+    fn take(&mut self, n: usize) -> AcornResult<&'a [u8]> {
+        if self.data.len() - self.pos < n {
+            return Err(invalid("MessagePack payload is truncated"));
+        }
+        let slice = &self.data[self.pos..self.pos + n];
+        self.pos += n;
+        Ok(slice)
+    }
+
+    fn byte(&mut self) -> AcornResult<u8> {
+        Ok(self.take(1)?[0])
+    }
+
+    fn be<const N: usize>(&mut self) -> AcornResult<[u8; N]> {
+        let mut buf = [0u8; N];
+        buf.copy_from_slice(self.take(N)?);
+        Ok(buf)
+    }
+
+    fn len16(&mut self) -> AcornResult<usize> {
+        Ok(u16::from_be_bytes(self.be()?) as usize)
+    }
+
+    fn len32(&mut self) -> AcornResult<usize> {
+        Ok(u32::from_be_bytes(self.be()?) as usize)
+    }
+
+    fn read_value(&mut self, depth: usize) -> AcornResult<Value> {
+        if depth > MAX_DEPTH {
+            return Err(invalid(&format!(
+                "MessagePack payload nests deeper than {MAX_DEPTH} levels"
+            )));
+        }
+
+        let code = self.byte()?;
+        Ok(match code {
+            0x00..=0x7f => Value::from(code),
+            0x80..=0x8f => self.read_map((code & 0x0f) as usize, depth)?,
+            0x90..=0x9f => self.read_array((code & 0x0f) as usize, depth)?,
+            0xa0..=0xbf => self.read_str((code & 0x1f) as usize)?,
+            0xc0 => Value::Null,
+            0xc2 => Value::Bool(false),
+            0xc3 => Value::Bool(true),
+            0xc4 => {
+                let n = self.byte()? as usize;
+                self.read_bin(n)?
+            }
+            0xc5 => {
+                let n = self.len16()?;
+                self.read_bin(n)?
+            }
+            0xc6 => {
+                let n = self.len32()?;
+                self.read_bin(n)?
+            }
+            0xc7 => {
+                let n = self.byte()? as usize;
+                self.read_ext(n)?
+            }
+            0xc8 => {
+                let n = self.len16()?;
+                self.read_ext(n)?
+            }
+            0xc9 => {
+                let n = self.len32()?;
+                self.read_ext(n)?
+            }
+            0xca => float(f32::from_be_bytes(self.be()?) as f64),
+            0xcb => float(f64::from_be_bytes(self.be()?)),
+            0xcc => Value::from(self.byte()?),
+            0xcd => Value::from(u16::from_be_bytes(self.be()?)),
+            0xce => Value::from(u32::from_be_bytes(self.be()?)),
+            0xcf => Value::from(u64::from_be_bytes(self.be()?)),
+            0xd0 => Value::from(self.byte()? as i8),
+            0xd1 => Value::from(i16::from_be_bytes(self.be()?)),
+            0xd2 => Value::from(i32::from_be_bytes(self.be()?)),
+            0xd3 => Value::from(i64::from_be_bytes(self.be()?)),
+            0xd4 => self.read_ext(1)?,
+            0xd5 => self.read_ext(2)?,
+            0xd6 => self.read_ext(4)?,
+            0xd7 => self.read_ext(8)?,
+            0xd8 => self.read_ext(16)?,
+            0xd9 => {
+                let n = self.byte()? as usize;
+                self.read_str(n)?
+            }
+            0xda => {
+                let n = self.len16()?;
+                self.read_str(n)?
+            }
+            0xdb => {
+                let n = self.len32()?;
+                self.read_str(n)?
+            }
+            0xdc => {
+                let n = self.len16()?;
+                self.read_array(n, depth)?
+            }
+            0xdd => {
+                let n = self.len32()?;
+                self.read_array(n, depth)?
+            }
+            0xde => {
+                let n = self.len16()?;
+                self.read_map(n, depth)?
+            }
+            0xdf => {
+                let n = self.len32()?;
+                self.read_map(n, depth)?
+            }
+            0xe0..=0xff => Value::from(code as i8),
+            0xc1 => return Err(invalid("MessagePack format byte 0xc1 is reserved")),
+        })
+    }
+
+    fn read_str(&mut self, n: usize) -> AcornResult<Value> {
+        let bytes = self.take(n)?;
+        let s = std::str::from_utf8(bytes).map_err(|e| AcornError::Serialization(e.to_string()))?;
+        Ok(Value::String(s.to_owned()))
+    }
+
+    /// Bytes become an array of numbers, which is how serde reads `Vec<u8>`.
+    fn read_bin(&mut self, n: usize) -> AcornResult<Value> {
+        Ok(Value::Array(
+            self.take(n)?.iter().map(|b| Value::from(*b)).collect(),
+        ))
+    }
+
+    fn read_array(&mut self, n: usize, depth: usize) -> AcornResult<Value> {
+        let mut items = Vec::with_capacity(n.min(self.data.len() - self.pos));
+        for _ in 0..n {
+            items.push(self.read_value(depth + 1)?);
+        }
+        Ok(Value::Array(items))
+    }
+
+    fn read_map(&mut self, n: usize, depth: usize) -> AcornResult<Value> {
+        let mut map = Map::new();
+        for _ in 0..n {
+            let key = match self.read_value(depth + 1)? {
+                Value::String(s) => s,
+                other => other.to_string(),
+            };
+            map.insert(key, self.read_value(depth + 1)?);
+        }
+        Ok(Value::Object(map))
+    }
+
+    /// Timestamps become RFC 3339 strings; other extension types read as null.
+    fn read_ext(&mut self, n: usize) -> AcornResult<Value> {
+        let ext_type = self.byte()? as i8;
+        let body = self.take(n)?;
+        if ext_type != TIMESTAMP_EXT {
+            return Ok(Value::Null);
+        }
+
+        let (secs, nanos) = match body.len() {
+            4 => (u32::from_be_bytes(body.try_into().unwrap()) as i64, 0u32),
+            8 => {
+                let packed = u64::from_be_bytes(body.try_into().unwrap());
+                ((packed & 0x3_ffff_ffff) as i64, (packed >> 34) as u32)
+            }
+            12 => (
+                i64::from_be_bytes(body[4..].try_into().unwrap()),
+                u32::from_be_bytes(body[..4].try_into().unwrap()),
+            ),
+            len => return Err(invalid(&format!("invalid MessagePack timestamp length {len}"))),
+        };
+        Ok(Value::String(format_rfc3339(secs, nanos)))
+    }
+}
+
+fn float(f: f64) -> Value {
+    Number::from_f64(f).map(Value::Number).unwrap_or(Value::Null)
+}
+
+fn invalid(message: &str) -> AcornError {
+    AcornError::Serialization(message.to_owned())
+}
+
+/// UTC timestamp as `YYYY-MM-DDTHH:MM:SS[.fffffff]Z`, with the fraction trimmed to the
+/// precision it carries.
+fn format_rfc3339(secs: i64, nanos: u32) -> String {
+    let days = secs.div_euclid(86_400);
+    let rem = secs.rem_euclid(86_400);
+    let (year, month, day) = civil_from_days(days);
+    let mut out = format!(
+        "{year:04}-{month:02}-{day:02}T{:02}:{:02}:{:02}",
+        rem / 3600,
+        rem % 3600 / 60,
+        rem % 60
+    );
+    if nanos > 0 {
+        let fraction = format!("{nanos:09}");
+        out.push('.');
+        out.push_str(fraction.trim_end_matches('0'));
+    }
+    out.push('Z');
+    out
+}
+
+/// Proleptic Gregorian date for a day count since 1970-01-01 (Howard Hinnant's algorithm).
+fn civil_from_days(days: i64) -> (i64, u32, u32) {
+    let z = days + 719_468;
+    let era = z.div_euclid(146_097);
+    let doe = z.rem_euclid(146_097);
+    let yoe = (doe - doe / 1460 + doe / 36_524 - doe / 146_096) / 365;
+    let doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    let mp = (5 * doy + 2) / 153;
+    let day = (doy - (153 * mp + 2) / 5 + 1) as u32;
+    let month = if mp < 10 { mp + 3 } else { mp - 9 } as u32;
+    let year = yoe + era * 400 + i64::from(month <= 2);
+    (year, month, day)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use serde::Deserialize;
+
+    #[derive(Debug, Clone, PartialEq, Serialize, Deserialize)]
+    struct Order {
+        id: String,
+        quantity: u32,
+        price: f64,
+        tags: Vec<String>,
+        note: Option<String>,
+        delta: i64,
+    }
+
+    fn order() -> Order {
+        Order {
+            id: "order-1".into(),
+            quantity: 300,
+            price: 12.5,
+            tags: vec!["a".into(), "b".into()],
+            note: None,
+            delta: -40_000,
+        }
+    }
+
+    #[test]
+    fn round_trips_and_is_smaller_than_json() {
+        let codec = MsgPackCodec;
+        let bytes = NutCodec::<Order>::encode(&codec, &order()).unwrap();
+        let decoded: Order = codec.decode(&bytes).unwrap();
+        assert_eq!(decoded, order());
+
+        let json = serde_json::to_vec(&order()).unwrap();
+        assert!(bytes.len() < json.len(), "{} vs {}", bytes.len(), json.len());
+    }
+
+    #[test]
+    fn reads_json_written_before_switching_codecs() {
+        let json = serde_json::to_vec(&order()).unwrap();
+        let decoded: Order = MsgPackCodec.decode(&json).unwrap();
+        assert_eq!(decoded, order());
+
+        // A bare integer whose MessagePack byte happens to be '{' is still MessagePack
+        let n: u8 = MsgPackCodec.decode(&[b'{']).unwrap();
+        assert_eq!(n, 123);
+    }
+
+    #[test]
+    fn encodes_integers_in_the_narrowest_form() {
+        let codec = MsgPackCodec;
+        let cases: [(i64, &[u8]); 6] = [
+            (5, &[0x05]),
+            (-3, &[0xfd]),
+            (200, &[0xcc, 0xc8]),
+            (-100, &[0xd0, 0x9c]),
+            (70_000, &[0xce, 0x00, 0x01, 0x11, 0x70]),
+            (-40_000, &[0xd2, 0xff, 0xff, 0x63, 0xc0]),
+        ];
+        for (value, expected) in cases {
+            assert_eq!(NutCodec::<i64>::encode(&codec, &value).unwrap(), expected);
+            let decoded: i64 = codec.decode(expected).unwrap();
+            assert_eq!(decoded, value);
+        }
+    }
+
+    #[test]
+    fn timestamps_decode_to_rfc3339() {
+        assert_eq!(format_rfc3339(0, 0), "1970-01-01T00:00:00Z");
+        assert_eq!(
+            format_rfc3339(1_709_251_200, 500_000_000),
+            "2024-03-01T00:00:00.5Z"
+        );
+        assert_eq!(format_rfc3339(-1, 0), "1969-12-31T23:59:59Z");
+
+        // timestamp32 for 2024-03-01T00:00:00Z
+        let bytes = [0xd6, 0xff, 0x65, 0xe1, 0x1a, 0x80];
+        let decoded: String = MsgPackCodec.decode(&bytes).unwrap();
+        assert_eq!(decoded, "2024-03-01T00:00:00Z");
+    }
+
+    #[derive(Debug, Serialize, Deserialize)]
+    #[serde(rename_all = "PascalCase")]
+    struct CsItem {
+        name: String,
+        age: u32,
+    }
+
+    #[derive(Debug, Serialize, Deserialize)]
+    #[serde(rename_all = "PascalCase")]
+    struct CsNut {
+        id: String,
+        change_id: String,
+        payload: CsItem,
+        timestamp: String,
+        expires_at: Option<String>,
+        version: i32,
+    }
+
+    fn unhex(hex: &str) -> Vec<u8> {
+        (0..hex.len())
+            .step_by(2)
+            .map(|i| u8::from_str_radix(&hex[i..i + 2], 16).unwrap())
+            .collect()
+    }
+
+    #[test]
+    fn decodes_a_nut_written_by_the_dotnet_serializer() {
+        // Same vector as SerializerTests.MsgPack_MatchesGoldenVectorSharedWithRustCodec
+        let bytes = unhex(concat!(
+            "88a84368616e67654964d92437386561366533652d346237362d346233322d616530352d",
+            "386465613239613633316333ac4f726967696e4e6f64654964c0a8486f70436f756e7400",
+            "a24964a27531a75061796c6f616482a44e616d65a3416461a341676524a954696d657374",
+            "616d70d6ff65e11a80a9457870697265734174c0a756657273696f6e01"
+        ));
+        let nut: CsNut = MsgPackCodec.decode(&bytes).unwrap();
+        assert_eq!(nut.id, "u1");
+        assert_eq!(nut.change_id, "78ea6e3e-4b76-4b32-ae05-8dea29a631c3");
+        assert_eq!(nut.payload.name, "Ada");
+        assert_eq!(nut.payload.age, 36);
+        assert_eq!(nut.timestamp, "2024-03-01T00:00:00Z");
+        assert_eq!(nut.expires_at, None);
+        assert_eq!(nut.version, 1);
+    }
+
+    #[test]
+    fn rejects_truncated_and_overly_nested_payloads() {
+        assert!(NutCodec::<Order>::decode(&MsgPackCodec, &[0x81, 0xa2, b'i']).is_err());
+
+        let mut nested = vec![0x91; MAX_DEPTH + 2];
+        nested.push(0xc0);
+        assert!(NutCodec::<Value>::decode(&MsgPackCodec, &nested).is_err());
+    }
+}
@@ -0,0 +1,193 @@
+//! Deadline bookkeeping shared by trunks that implement [`TtlCleaner`](crate::TtlCleaner).
+//!
+//! An [`ExpiryIndex`] keeps keys ordered by expiry so a purge walks only the keys that are due,
+//! instead of every entry of a branch. [`TtlCounters`] records what purges did, reported as
+//! [`TtlStats`].
+
+use std::collections::{BTreeSet, HashMap};
+use std::hash::Hash;
+use std::sync::atomic::{AtomicU64, Ordering};
+use std::time::{Duration, Instant, SystemTime};
+
+/// Keys ordered by deadline. Each key has at most one deadline; setting it again moves it.
+/// Not synchronized: trunks keep it next to the entries it describes, under the same lock.
+#[derive(Debug, Clone)]
+pub struct ExpiryIndex<K> {
+    by_deadline: BTreeSet<(SystemTime, K)>,
+    deadlines: HashMap<K, SystemTime>,
+}
+
+impl<K> Default for ExpiryIndex<K> {
+    fn default() -> Self {
+        Self {
+            by_deadline: BTreeSet::new(),
+            deadlines: HashMap::new(),
+        }
+    }
+}
+
+impl<K: Ord + Hash + Clone> ExpiryIndex<K> {
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// Track `key` until `deadline`; `None` stops tracking it.
+    pub fn set(&mut self, key: &K, deadline: Option<SystemTime>) {
+        let Some(deadline) = deadline else {
+            self.remove(key);
+            return;
+        };
+        match self.deadlines.insert(key.clone(), deadline) {
+            Some(previous) if previous == deadline => return,
+            Some(previous) => {
+                self.by_deadline.remove(&(previous, key.clone()));
+            }
+            None => {}
+        }
+        self.by_deadline.insert((deadline, key.clone()));
+    }
+
+    pub fn remove(&mut self, key: &K) -> Option<SystemTime> {
+        let deadline = self.deadlines.remove(key)?;
+        self.by_deadline.remove(&(deadline, key.clone()));
+        Some(deadline)
+    }
+
+    pub fn deadline(&self, key: &K) -> Option<SystemTime> {
+        self.deadlines.get(key).copied()
+    }
+
+    pub fn next_deadline(&self) -> Option<SystemTime> {
+        self.by_deadline.first().map(|(deadline, _)| *deadline)
+    }
+
+    /// Whether anything is due at `now`, without taking it.
+    pub fn has_due(&self, now: SystemTime) -> bool {
+        self.next_deadline().is_some_and(|deadline| deadline <= now)
+    }
+
+    /// Remove and return the keys due at `now`, earliest first.
+    pub fn take_due(&mut self, now: SystemTime) -> Vec<(K, SystemTime)> {
+        let mut due = Vec::new();
+        while let Some((deadline, _)) = self.by_deadline.first() {
+            if *deadline > now {
+                break;
+            }
+            let (deadline, key) = self.by_deadline.pop_first().expect("first entry exists");
+            self.deadlines.remove(&key);
+            due.push((key, deadline));
+        }
+        due
+    }
+
+    pub fn len(&self) -> usize {
+        self.deadlines.len()
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.deadlines.is_empty()
+    }
+
+    pub fn clear(&mut self) {
+        self.by_deadline.clear();
+        self.deadlines.clear();
+    }
+}
+
+/// What TTL purges have done, as reported by [`TtlCleaner::ttl_stats`](crate::TtlCleaner::ttl_stats).
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct TtlStats {
+    /// Entries that currently carry a deadline.
+    pub tracked: usize,
+    /// Entries removed by purges so far.
+    pub purged: u64,
+    pub purges: u64,
+    pub last_purge: Duration,
+    /// Longest an expired entry outlived its deadline before a purge removed it.
+    pub max_lag: Duration,
+}
+
+/// Lock-free purge counters a trunk can share between clones.
+#[derive(Debug, Default)]
+pub struct TtlCounters {
+    purged: AtomicU64,
+    purges: AtomicU64,
+    last_purge_nanos: AtomicU64,
+    max_lag_nanos: AtomicU64,
+}
+
+impl TtlCounters {
+    /// Record a purge that started at `started` and removed entries whose deadlines were
+    /// `deadlines`, all judged against `now`.
+    pub fn record(&self, started: Instant, now: SystemTime, deadlines: impl IntoIterator<Item = SystemTime>) {
+        let mut purged = 0u64;
+        let mut max_lag = Duration::ZERO;
+        for deadline in deadlines {
+            purged += 1;
+            max_lag = max_lag.max(now.duration_since(deadline).unwrap_or_default());
+        }
+        self.purged.fetch_add(purged, Ordering::Relaxed);
+        self.purges.fetch_add(1, Ordering::Relaxed);
+        self.last_purge_nanos
+            .store(nanos(started.elapsed()), Ordering::Relaxed);
+        self.max_lag_nanos.fetch_max(nanos(max_lag), Ordering::Relaxed);
+    }
+
+    pub fn snapshot(&self, tracked: usize) -> TtlStats {
+        TtlStats {
+            tracked,
+            purged: self.purged.load(Ordering::Relaxed),
+            purges: self.purges.load(Ordering::Relaxed),
+            last_purge: Duration::from_nanos(self.last_purge_nanos.load(Ordering::Relaxed)),
+            max_lag: Duration::from_nanos(self.max_lag_nanos.load(Ordering::Relaxed)),
+        }
+    }
+}
+
+fn nanos(duration: Duration) -> u64 {
+    u64::try_from(duration.as_nanos()).unwrap_or(u64::MAX)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn take_due_returns_only_passed_deadlines_in_order() {
+        let now = SystemTime::now();
+        let mut index = ExpiryIndex::new();
+        index.set(&"late", Some(now + Duration::from_secs(60)));
+        index.set(&"second", Some(now - Duration::from_secs(1)));
+        index.set(&"first", Some(now - Duration::from_secs(2)));
+        index.set(&"none", None);
+
+        let due: Vec<_> = index.take_due(now).into_iter().map(|(key, _)| key).collect();
+        assert_eq!(due, vec!["first", "second"]);
+        assert_eq!(index.len(), 1);
+        assert!(!index.has_due(now));
+        assert_eq!(index.next_deadline(), Some(now + Duration::from_secs(60)));
+    }
+
+    #[test]
+    fn setting_again_moves_the_key() {
+        let now = SystemTime::now();
+        let mut index = ExpiryIndex::new();
+        index.set(&"k", Some(now - Duration::from_secs(1)));
+        index.set(&"k", Some(now + Duration::from_secs(1)));
+        assert!(index.take_due(now).is_empty());
+        assert_eq!(index.remove(&"k"), Some(now + Duration::from_secs(1)));
+        assert!(index.is_empty());
+    }
+
+    #[test]
+    fn counters_track_lag() {
+        let counters = TtlCounters::default();
+        let now = SystemTime::now();
+        counters.record(Instant::now(), now, [now - Duration::from_millis(5), now]);
+        let stats = counters.snapshot(3);
+        assert_eq!(stats.tracked, 3);
+        assert_eq!(stats.purged, 2);
+        assert_eq!(stats.purges, 1);
+        assert_eq!(stats.max_lag, Duration::from_millis(5));
+    }
+}
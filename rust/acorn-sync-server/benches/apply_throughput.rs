@@ -0,0 +1,91 @@
+//! Apply throughput of the sync store with 1, 8 and 64 concurrent clients, each pushing
+//! batches either to its own branch or to one shared branch.
+//!
+//! Run with `cargo bench -p acorn-sync-server --bench apply_throughput`.
+
+use std::sync::Arc;
+
+use acorn_core::BranchId;
+use acorn_sync::{SyncBatch, SyncMutation};
+use acorn_sync_server::{BackendTrunk, SyncStore};
+use acorn_trunk_file::{FileTrunk, SegmentTrunk};
+use acorn_trunk_mem::MemoryTrunk;
+use criterion::{criterion_group, criterion_main, BenchmarkId, Criterion, Throughput};
+
+const CLIENTS: [usize; 3] = [1, 8, 64];
+const BATCHES_PER_CLIENT: usize = 8;
+const OPS_PER_BATCH: usize = 32;
+const VALUE_BYTES: usize = 128;
+
+fn client_batches(client: usize, shared_branch: bool) -> Vec<SyncBatch> {
+    let branch = if shared_branch {
+        BranchId::new("shared")
+    } else {
+        BranchId::new(format!("client-{client}"))
+    };
+    (0..BATCHES_PER_CLIENT)
+        .map(|round| SyncBatch {
+            branch: branch.clone(),
+            operations: (0..OPS_PER_BATCH)
+                .map(|op| SyncMutation::Put {
+                    key: format!("c{client}-r{round}-k{op}"),
+                    value: vec![(op % 251) as u8; VALUE_BYTES],
+                    version: None,
+                })
+                .collect(),
+        })
+        .collect()
+}
+
+fn run_clients(store: &SyncStore, batches: &[Vec<SyncBatch>]) {
+    std::thread::scope(|s| {
+        for client in batches {
+            s.spawn(move || {
+                for batch in client {
+                    store.apply(batch).unwrap();
+                }
+            });
+        }
+    });
+}
+
+fn apply_throughput(c: &mut Criterion) {
+    type Factory = fn(&std::path::Path) -> BackendTrunk;
+    let backends: [(&str, Factory); 3] = [
+        (
+            "memory",
+            |_| BackendTrunk::Memory(MemoryTrunk::sharded_for_host()),
+        ),
+        ("segment", |dir| BackendTrunk::Segment(SegmentTrunk::new(dir))),
+        ("file", |dir| BackendTrunk::File(FileTrunk::with_history(dir))),
+    ];
+
+    for shared_branch in [false, true] {
+        let layout = if shared_branch {
+            "shared-branch"
+        } else {
+            "branch-per-client"
+        };
+        let mut group = c.benchmark_group(format!("sync_apply/{layout}"));
+        group.sample_size(10);
+        for clients in CLIENTS {
+            let batches: Vec<_> = (0..clients)
+                .map(|client| client_batches(client, shared_branch))
+                .collect();
+            group.throughput(Throughput::Elements(
+                (clients * BATCHES_PER_CLIENT * OPS_PER_BATCH) as u64,
+            ));
+            for (name, factory) in backends {
+                let dir = tempfile::tempdir().unwrap();
+                let store = Arc::new(SyncStore::new(factory(dir.path())));
+                group.bench_with_input(BenchmarkId::new(name, clients), &batches, |b, batches| {
+                    b.iter(|| run_clients(&store, batches))
+                });
+            }
+        }
+        group.finish();
+    }
+}
+
+criterion_group!(benches, apply_throughput);
+criterion_main!(benches);
@@ -0,0 +1,155 @@
+//! Per-branch change sequence backing incremental `/sync/pull`.
+//!
+//! Every applied mutation bumps the branch sequence and moves its key to the new position,
+//! so the feed holds one entry per key: a pull after cursor `n` walks only keys touched since
+//! `n` instead of the whole branch. Sequences live in memory and restart with the process;
+//! each process picks a fresh `epoch` so cursors from a previous run are recognised and
+//! answered with a full snapshot.
+
+use std::collections::{BTreeMap, HashMap};
+use std::sync::Arc;
+use std::time::{SystemTime, UNIX_EPOCH};
+
+use acorn_core::BranchId;
+use parking_lot::{Mutex, RwLock};
+
+#[derive(Debug)]
+pub struct ChangeFeed {
+    epoch: u64,
+    branches: RwLock<HashMap<BranchId, Arc<Mutex<BranchChanges>>>>,
+}
+
+#[derive(Debug, Default)]
+pub struct BranchChanges {
+    head: u64,
+    by_seq: BTreeMap<u64, String>,
+    by_key: HashMap<String, u64>,
+}
+
+/// Keys changed after a cursor, in sequence order.
+#[derive(Debug)]
+pub struct ChangePage {
+    pub changes: Vec<(u64, String)>,
+    pub has_more: bool,
+}
+
+impl ChangeFeed {
+    pub fn new() -> Self {
+        let epoch = SystemTime::now()
+            .duration_since(UNIX_EPOCH)
+            .map(|d| d.as_nanos() as u64)
+            .unwrap_or(1)
+            .max(1);
+        Self::with_epoch(epoch)
+    }
+
+    pub fn with_epoch(epoch: u64) -> Self {
+        ChangeFeed {
+            epoch,
+            branches: RwLock::new(HashMap::new()),
+        }
+    }
+
+    pub fn epoch(&self) -> u64 {
+        self.epoch
+    }
+
+    /// Changes for `branch`, seeding the feed from `existing` the first time the branch is
+    /// seen so data already in a persistent trunk is served to fresh cursors.
+    pub fn branch<F>(&self, branch: &BranchId, existing: F) -> Arc<Mutex<BranchChanges>>
+    where
+        F: FnOnce() -> Vec<String>,
+    {
+        if let Some(changes) = self.branches.read().get(branch) {
+            return changes.clone();
+        }
+        let mut branches = self.branches.write();
+        branches
+            .entry(branch.clone())
+            .or_insert_with(|| {
+                let mut changes = BranchChanges::default();
+                for key in existing() {
+                    changes.record(&key);
+                }
+                Arc::new(Mutex::new(changes))
+            })
+            .clone()
+    }
+}
+
+impl Default for ChangeFeed {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+impl BranchChanges {
+    /// Record a change to `key` and return its new sequence number.
+    pub fn record(&mut self, key: &str) -> u64 {
+        self.head += 1;
+        let seq = self.head;
+        match self.by_key.get_mut(key) {
+            Some(previous) => {
+                self.by_seq.remove(previous);
+                *previous = seq;
+            }
+            None => {
+                self.by_key.insert(key.to_string(), seq);
+            }
+        }
+        self.by_seq.insert(seq, key.to_string());
+        seq
+    }
+
+    pub fn head(&self) -> u64 {
+        self.head
+    }
+
+    /// Up to `limit` keys whose latest change is after `since`.
+    pub fn since(&self, since: u64, limit: usize) -> ChangePage {
+        let mut range = self.by_seq.range(since.saturating_add(1)..);
+        let changes: Vec<_> = range
+            .by_ref()
+            .take(limit)
+            .map(|(seq, key)| (*seq, key.clone()))
+            .collect();
+        ChangePage {
+            changes,
+            has_more: range.next().is_some(),
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn keeps_latest_change_per_key() {
+        let feed = ChangeFeed::with_epoch(1);
+        let branch = BranchId::new("main");
+        let changes = feed.branch(&branch, || vec!["a".into(), "b".into()]);
+        let mut changes = changes.lock();
+        assert_eq!(changes.record("a"), 3);
+        changes.record("c");
+
+        let page = changes.since(0, 10);
+        let keys: Vec<_> = page.changes.iter().map(|(_, k)| k.as_str()).collect();
+        assert_eq!(keys, vec!["b", "a", "c"]);
+        assert!(!page.has_more);
+
+        let page = changes.since(2, 1);
+        assert_eq!(page.changes, vec![(3, "a".to_string())]);
+        assert!(page.has_more);
+        assert!(changes.since(changes.head(), 10).changes.is_empty());
+    }
+
+    #[test]
+    fn seeds_each_branch_once() {
+        let feed = ChangeFeed::with_epoch(1);
+        let branch = BranchId::new("main");
+        feed.branch(&branch, || vec!["a".into()]);
+        let changes = feed.branch(&branch, || panic!("seeded twice"));
+        assert_eq!(changes.lock().head(), 1);
+    }
+}
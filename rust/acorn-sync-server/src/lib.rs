@@ -0,0 +1,7 @@
+//! Storage side of the sync server, kept free of HTTP types so it can be unit tested and
+//! benchmarked directly.
+
+pub mod changes;
+pub mod store;
+
+pub use store::{AppliedBatch, BackendTrunk, StreamOp, SyncStore, DEFAULT_PULL_LIMIT, MAX_PULL_LIMIT};
@@ -1,36 +1,31 @@
-use acorn_core::{BranchId, TombstoneProvider, Trunk};
+use acorn_core::BranchId;
 use acorn_sync::{
-    SyncApplyRequest, SyncApplyResponse, SyncConflict, SyncConflictKind, SyncErrorResponse, SyncMutation,
-    SyncPullResponse,
+    FetchRequest, MerkleEntriesRequest, MerkleHashesRequest, StreamFrame, SyncApplyRequest, SyncCursor,
+    SyncErrorResponse, WireFormat, WireMessage,
 };
-use acorn_trunk_file::FileTrunk;
-use acorn_trunk_mem::MemoryTrunk;
+use acorn_sync_server::SyncStore;
 use axum::{
-    extract::{ws::WebSocketUpgrade, Query, State},
-    http::StatusCode,
-    response::IntoResponse,
+    body::Bytes,
+    extract::{
+        ws::{Message, WebSocket, WebSocketUpgrade},
+        Query, State,
+    },
+    http::{header, HeaderMap, StatusCode},
+    response::{IntoResponse, Response},
     routing::{get, post},
     Json, Router,
 };
-use parking_lot::Mutex;
+use parking_lot::RwLock;
+use std::collections::HashMap;
 use std::net::SocketAddr;
 use std::sync::Arc;
-use tokio::{select, sync::broadcast};
+use std::time::Duration;
+use tokio::{select, sync::watch};
 use tracing_subscriber::{layer::SubscriberExt, util::SubscriberInitExt};
 
-#[derive(Debug, Clone, serde::Serialize)]
-struct StreamEvent {
-    branch: String,
-    applied: Vec<StreamOp>,
-    conflicts: Vec<SyncConflict>,
-}
-
-#[derive(Debug, Clone, serde::Serialize)]
-struct StreamOp {
-    key: String,
-    op: String,
-    version: Option<u64>,
-}
+const DEFAULT_STREAM_PAGE: usize = 256;
+const DEFAULT_INLINE_LIMIT: usize = 64 * 1024;
+const HEARTBEAT_INTERVAL: Duration = Duration::from_secs(15);
 
 #[tokio::main]
 async fn main() {
@@ -46,6 +41,10 @@ async fn main() {
         .route("/sync/apply", post(apply_batch))
         .route("/sync/pull", get(pull_batch))
         .route("/sync/stream", get(stream_updates))
+        .route("/sync/merkle", get(merkle_summary))
+        .route("/sync/merkle/hashes", post(merkle_hashes))
+        .route("/sync/merkle/entries", post(merkle_entries))
+        .route("/sync/fetch", post(fetch_keys))
         .with_state(state);
 
     let addr: SocketAddr = "0.0.0.0:8080".parse().unwrap();
@@ -60,246 +59,314 @@ async fn health() -> &'static str {
 
 #[derive(Clone)]
 struct AppState {
-    trunk: Arc<Mutex<BackendTrunk>>,
-    notifier: broadcast::Sender<StreamEvent>,
+    store: Arc<SyncStore>,
+    watchers: Arc<BranchWatchers>,
 }
 
 impl AppState {
     fn new() -> Self {
-        let (tx, _rx) = broadcast::channel(64);
         Self {
-            trunk: Arc::new(Mutex::new(BackendTrunk::from_env())),
-            notifier: tx,
+            store: Arc::new(SyncStore::from_env()),
+            watchers: Arc::new(BranchWatchers::default()),
         }
     }
 }
 
-#[derive(Debug)]
-enum BackendTrunk {
-    Memory(MemoryTrunk),
-    File(FileTrunk),
+/// Wakes `/sync/stream` connections when a branch changes. A `watch` channel keeps only the
+/// latest wake-up, so nothing queues up for a slow subscriber: it re-reads the change feed
+/// from its own cursor once it catches up, however many batches landed in between.
+#[derive(Default)]
+struct BranchWatchers {
+    senders: RwLock<HashMap<BranchId, watch::Sender<()>>>,
 }
 
-impl BackendTrunk {
-    fn from_env() -> Self {
-        if let Ok(path) = std::env::var("ACORN_TRUNK_FILE") {
-            BackendTrunk::File(FileTrunk::with_history_and_ttl(path))
-        } else {
-            BackendTrunk::Memory(MemoryTrunk::new())
+impl BranchWatchers {
+    fn subscribe(&self, branch: &BranchId) -> watch::Receiver<()> {
+        if let Some(sender) = self.senders.read().get(branch) {
+            return sender.subscribe();
         }
+        self.senders
+            .write()
+            .entry(branch.clone())
+            .or_insert_with(|| watch::channel(()).0)
+            .subscribe()
     }
 
-    fn put(&self, branch: &BranchId, key: &str, value: Vec<u8>) -> Result<(), acorn_core::AcornError> {
-        match self {
-            BackendTrunk::Memory(t) => t.put(branch, key, acorn_core::Nut { value }),
-            BackendTrunk::File(t) => t.put(branch, key, acorn_core::Nut { value }),
+    fn notify(&self, branch: &BranchId) {
+        if let Some(sender) = self.senders.read().get(branch) {
+            sender.send_replace(());
         }
     }
+}
 
-    fn delete(&self, branch: &BranchId, key: &str) -> Result<(), acorn_core::AcornError> {
-        match self {
-            BackendTrunk::Memory(t) => t.delete(branch, key),
-            BackendTrunk::File(t) => t.delete(branch, key),
-        }
-    }
+type HandlerError = (StatusCode, Json<SyncErrorResponse>);
 
-    fn get(&self, branch: &BranchId, key: &str) -> Option<Vec<u8>> {
-        match self {
-            BackendTrunk::Memory(t) => t.get(branch, key).ok().flatten().map(|n| n.value),
-            BackendTrunk::File(t) => t.get(branch, key).ok().flatten().map(|n| n.value),
-        }
-    }
+fn internal_error<E: std::fmt::Display>(e: E) -> HandlerError {
+    (
+        StatusCode::INTERNAL_SERVER_ERROR,
+        Json(SyncErrorResponse { error: e.to_string() }),
+    )
+}
 
-    fn keys(&self, branch: &BranchId) -> Vec<String> {
-        match self {
-            BackendTrunk::Memory(t) => t.keys(branch),
-            BackendTrunk::File(t) => t.keys(branch),
-        }
-    }
+fn bad_request<E: std::fmt::Display>(e: E) -> HandlerError {
+    (
+        StatusCode::BAD_REQUEST,
+        Json(SyncErrorResponse { error: e.to_string() }),
+    )
+}
 
-    fn version(&self, branch: &BranchId, key: &str) -> Option<u64> {
-        match self {
-            BackendTrunk::Memory(t) => t.current_version(branch, key),
-            BackendTrunk::File(t) => t.current_version(branch, key),
-        }
-    }
+fn header_str<'a>(headers: &'a HeaderMap, name: header::HeaderName) -> Option<&'a str> {
+    headers.get(name).and_then(|v| v.to_str().ok())
+}
 
-    fn tombstones(&self, branch: &BranchId) -> Vec<(String, Option<u64>)> {
-        match self {
-            BackendTrunk::Memory(t) => t.tombstones(branch),
-            BackendTrunk::File(t) => t.tombstones(branch),
-        }
-    }
+/// Encode a response in the format the client asked for.
+fn respond<M: WireMessage>(format: WireFormat, message: &M) -> Result<Response, HandlerError> {
+    let body = format
+        .encode(message)
+        .map_err(|e| internal_error(format!("{e:?}")))?;
+    Ok(([(header::CONTENT_TYPE, format.content_type())], body).into_response())
 }
 
+/// Bodies are JSON unless sent as `application/x-acorn-sync`; the response follows `Accept`,
+/// or the request's own format when no `Accept` is given.
+fn decode_body<M: WireMessage>(headers: &HeaderMap, body: &Bytes) -> Result<(M, WireFormat), HandlerError> {
+    let request_format = WireFormat::from_content_type(header_str(headers, header::CONTENT_TYPE));
+    let response_format = match header_str(headers, header::ACCEPT) {
+        Some(accept) => WireFormat::negotiate(Some(accept)),
+        None => request_format,
+    };
+    let payload = request_format
+        .decode(body)
+        .map_err(|e| bad_request(format!("{e:?}")))?;
+    Ok((payload, response_format))
+}
+
+/// Trunk calls may block on disk, so they run on the blocking pool rather than on the
+/// async workers that serve other branches.
 async fn apply_batch(
     State(state): State<AppState>,
-    Json(payload): Json<SyncApplyRequest>,
-) -> Result<Json<SyncApplyResponse>, (StatusCode, Json<SyncErrorResponse>)> {
-    let trunk = state.trunk.lock();
-    let mut applied_ops = Vec::new();
-    let mut conflicts = Vec::new();
-
-    for op in &payload.batch.operations {
-        match op {
-            SyncMutation::Put { key, value, version } => {
-                let current_version = trunk.version(&payload.batch.branch, key.as_str());
-                if let Some(expected) = *version {
-                    if let Some(existing) = current_version {
-                        if existing != expected {
-                            conflicts.push(SyncConflict {
-                                key: key.clone(),
-                                remote_value: trunk.get(&payload.batch.branch, key.as_str()),
-                                local_value: Some(value.clone()),
-                                remote_version: current_version,
-                                local_version: Some(expected),
-                                kind: SyncConflictKind::VersionMismatch,
-                            });
-                            continue;
-                        }
-                    }
-                }
-                if let Err(e) = trunk.put(&payload.batch.branch, key.as_str(), value.clone()) {
-                    return Err((
-                        StatusCode::INTERNAL_SERVER_ERROR,
-                        Json(SyncErrorResponse { error: e.to_string() }),
-                    ));
-                }
-                let next_version = trunk.version(&payload.batch.branch, key.as_str());
-                applied_ops.push(StreamOp {
-                    key: key.clone(),
-                    op: "put".into(),
-                    version: next_version,
-                });
-            }
-            SyncMutation::Delete { key, version } => {
-                let current_version = trunk.version(&payload.batch.branch, key.as_str());
-                if let Some(expected) = *version {
-                    if let Some(existing) = current_version {
-                        if existing != expected {
-                            conflicts.push(SyncConflict {
-                                key: key.clone(),
-                                remote_value: trunk.get(&payload.batch.branch, key.as_str()),
-                                local_value: None,
-                                remote_version: current_version,
-                                local_version: Some(expected),
-                                kind: SyncConflictKind::VersionMismatch,
-                            });
-                            continue;
-                        }
-                    }
-                }
-                if trunk.get(&payload.batch.branch, key.as_str()).is_none() {
-                    conflicts.push(SyncConflict {
-                        key: key.clone(),
-                        remote_value: None,
-                        local_value: None,
-                        remote_version: current_version,
-                        local_version: *version,
-                        kind: SyncConflictKind::MissingKey,
-                    });
-                    continue;
-                }
-                if let Err(e) = trunk.delete(&payload.batch.branch, key.as_str()) {
-                    return Err((
-                        StatusCode::INTERNAL_SERVER_ERROR,
-                        Json(SyncErrorResponse { error: e.to_string() }),
-                    ));
-                }
-                applied_ops.push(StreamOp {
-                    key: key.clone(),
-                    op: "delete".into(),
-                    version: None,
-                });
-            }
-        }
-    }
+    headers: HeaderMap,
+    body: Bytes,
+) -> Result<Response, HandlerError> {
+    let (payload, response_format): (SyncApplyRequest, _) = decode_body(&headers, &body)?;
+
+    let store = state.store.clone();
+    let (branch, applied) = tokio::task::spawn_blocking(move || {
+        let applied = store.apply(&payload.batch);
+        (payload.batch.branch, applied)
+    })
+    .await
+    .map_err(internal_error)?;
+    let applied = applied.map_err(internal_error)?;
 
-    let _ = state.notifier.send(StreamEvent {
-        branch: payload.batch.branch.as_str().to_string(),
-        applied: applied_ops.clone(),
-        conflicts: conflicts.clone(),
-    });
+    if applied.response.applied > 0 {
+        state.watchers.notify(&branch);
+    }
 
-    Ok(Json(SyncApplyResponse {
-        applied: applied_ops.len(),
-        conflicts,
-    }))
+    respond(response_format, &applied.response)
 }
 
+/// `since`/`epoch` form the cursor from a previous pull; `limit` caps the page size, which
+/// defaults to [`acorn_sync_server::DEFAULT_PULL_LIMIT`] keys. Every pull is paged, including
+/// one without a cursor: that starts from the branch's first key instead of returning the
+/// whole branch. While the response has `has_more` set, pull again with its `cursor`.
 #[derive(Debug, serde::Deserialize)]
 struct PullQuery {
     branch: Option<String>,
+    since: Option<u64>,
+    epoch: Option<u64>,
+    limit: Option<usize>,
 }
 
 async fn pull_batch(
     State(state): State<AppState>,
+    headers: HeaderMap,
     Query(query): Query<PullQuery>,
-) -> Result<Json<SyncPullResponse>, (StatusCode, Json<SyncErrorResponse>)> {
+) -> Result<Response, HandlerError> {
+    let format = WireFormat::negotiate(header_str(&headers, header::ACCEPT));
     let branch = BranchId::new(query.branch.unwrap_or_else(|| "default".into()));
-    let trunk = state.trunk.lock();
-    let mut ops = Vec::new();
-    let mut versions = Vec::new();
-    let mut deleted = Vec::new();
-    let mut deleted_versions = Vec::new();
-
-    for key in trunk.keys(&branch) {
-        if let Some(value) = trunk.get(&branch, &key) {
-            let version = trunk.version(&branch, &key);
-            ops.push(SyncMutation::Put {
-                key: key.clone(),
-                value,
-                version,
-            });
-            if let Some(v) = version {
-                versions.push((key, v));
-            }
-        }
-    }
+    let store = state.store.clone();
+    let response =
+        tokio::task::spawn_blocking(move || store.pull(&branch, query.since, query.epoch, query.limit))
+            .await
+            .map_err(internal_error)?;
+    respond(format, &response)
+}
 
-    for (k, v) in trunk.tombstones(&branch) {
-        deleted_versions.push((k.clone(), v));
-        deleted.push(k);
-    }
-    Ok(Json(SyncPullResponse {
-        batch: acorn_sync::SyncBatch {
-            branch,
-            operations: ops,
-        },
-        versions,
-        deleted,
-        deleted_versions,
-    }))
+#[derive(Debug, serde::Deserialize)]
+struct BranchQuery {
+    branch: Option<String>,
+}
+
+/// Root of the branch's Merkle tree. The first call for a branch builds the tree from the
+/// trunk; later applies keep it current.
+async fn merkle_summary(
+    State(state): State<AppState>,
+    headers: HeaderMap,
+    Query(query): Query<BranchQuery>,
+) -> Result<Response, HandlerError> {
+    let format = WireFormat::negotiate(header_str(&headers, header::ACCEPT));
+    let branch = BranchId::new(query.branch.unwrap_or_else(|| "default".into()));
+    let store = state.store.clone();
+    let summary = tokio::task::spawn_blocking(move || store.merkle_summary(&branch))
+        .await
+        .map_err(internal_error)?;
+    respond(format, &summary)
+}
+
+/// Child hashes of the requested nodes; out-of-range levels or nodes are a bad request.
+async fn merkle_hashes(
+    State(state): State<AppState>,
+    headers: HeaderMap,
+    body: Bytes,
+) -> Result<Response, HandlerError> {
+    let (request, format): (MerkleHashesRequest, _) = decode_body(&headers, &body)?;
+    let store = state.store.clone();
+    let hashes = tokio::task::spawn_blocking(move || store.merkle_hashes(&request))
+        .await
+        .map_err(internal_error)?
+        .map_err(|e| bad_request(format!("{e:?}")))?;
+    respond(format, &hashes)
 }
 
-async fn stream_updates(State(state): State<AppState>, ws: WebSocketUpgrade) -> impl IntoResponse {
-    let receiver = state.notifier.subscribe();
-    ws.on_upgrade(move |socket| handle_ws(socket, receiver))
+async fn merkle_entries(
+    State(state): State<AppState>,
+    headers: HeaderMap,
+    body: Bytes,
+) -> Result<Response, HandlerError> {
+    let (request, format): (MerkleEntriesRequest, _) = decode_body(&headers, &body)?;
+    let store = state.store.clone();
+    let entries = tokio::task::spawn_blocking(move || store.merkle_entries(&request))
+        .await
+        .map_err(internal_error)?
+        .map_err(|e| bad_request(format!("{e:?}")))?;
+    respond(format, &entries)
+}
+
+/// Values of the keys a reconcile found divergent, in the shape of a pull response.
+async fn fetch_keys(
+    State(state): State<AppState>,
+    headers: HeaderMap,
+    body: Bytes,
+) -> Result<Response, HandlerError> {
+    let (request, format): (FetchRequest, _) = decode_body(&headers, &body)?;
+    let store = state.store.clone();
+    let response = tokio::task::spawn_blocking(move || store.fetch(&request))
+        .await
+        .map_err(internal_error)?;
+    respond(format, &response)
+}
+
+/// `since`/`epoch` resume from a previous frame's cursor; without them the stream starts at
+/// the branch head. `format` is `json` (text messages, the default), `binary` or `zstd`.
+#[derive(Debug, serde::Deserialize)]
+struct StreamQuery {
+    branch: Option<String>,
+    since: Option<u64>,
+    epoch: Option<u64>,
+    limit: Option<usize>,
+    inline_limit: Option<usize>,
+    format: Option<String>,
 }
 
-async fn handle_ws(mut socket: axum::extract::ws::WebSocket, mut receiver: broadcast::Receiver<StreamEvent>) {
-    use axum::extract::ws::Message;
+async fn stream_updates(
+    State(state): State<AppState>,
+    Query(query): Query<StreamQuery>,
+    ws: WebSocketUpgrade,
+) -> impl IntoResponse {
+    ws.on_upgrade(move |socket| handle_ws(socket, state, query))
+}
+
+async fn handle_ws(mut socket: WebSocket, state: AppState, query: StreamQuery) {
+    let branch = BranchId::new(query.branch.unwrap_or_else(|| "default".into()));
+    let format = match query.format.as_deref() {
+        Some("binary") => WireFormat::Binary,
+        Some("zstd") => WireFormat::BinaryZstd,
+        _ => WireFormat::Json,
+    };
+    let limit = query.limit.unwrap_or(DEFAULT_STREAM_PAGE);
+    let inline_limit = query.inline_limit.unwrap_or(DEFAULT_INLINE_LIMIT);
+
+    // Subscribe before reading the feed so a batch landing in between still wakes us.
+    let mut changed = state.watchers.subscribe(&branch);
+    let mut cursor = match query.since {
+        Some(seq) => SyncCursor {
+            epoch: query.epoch.unwrap_or_else(|| state.store.epoch()),
+            seq,
+        },
+        None => {
+            let store = state.store.clone();
+            let branch = branch.clone();
+            match tokio::task::spawn_blocking(move || store.head(&branch)).await {
+                Ok(head) => head,
+                Err(_) => return,
+            }
+        }
+    };
+    let mut heartbeat = tokio::time::interval_at(
+        tokio::time::Instant::now() + HEARTBEAT_INTERVAL,
+        HEARTBEAT_INTERVAL,
+    );
+
     loop {
+        // Drain the feed past the cursor. The next page is read only after the previous
+        // frame has been written, so a slow socket slows this loop instead of queueing.
+        loop {
+            let store = state.store.clone();
+            let page_branch = branch.clone();
+            let since = cursor;
+            let frame = match tokio::task::spawn_blocking(move || {
+                store.stream_frame(&page_branch, &since, limit, inline_limit)
+            })
+            .await
+            {
+                Ok(frame) => frame,
+                Err(_) => return,
+            };
+            cursor = frame.cursor;
+            let has_more = frame.has_more;
+            if (!frame.changes.is_empty() || frame.reset)
+                && send_frame(&mut socket, format, &frame).await.is_err()
+            {
+                return;
+            }
+            if !has_more {
+                break;
+            }
+        }
+
         select! {
-            maybe_msg = receiver.recv() => {
-                match maybe_msg {
-                    Ok(evt) => {
-                        let payload = serde_json::to_string(&evt).unwrap_or_else(|_| "{}".into());
-                        if socket.send(Message::Text(payload.into())).await.is_err() {
-                            break;
-                        }
-                    }
-                    Err(broadcast::error::RecvError::Closed) => break,
-                    Err(broadcast::error::RecvError::Lagged(_)) => continue,
+            woke = changed.changed() => {
+                if woke.is_err() {
+                    return;
+                }
+            }
+            _ = heartbeat.tick() => {
+                let frame = StreamFrame {
+                    branch: branch.clone(),
+                    cursor,
+                    changes: Vec::new(),
+                    has_more: false,
+                    reset: false,
+                };
+                if send_frame(&mut socket, format, &frame).await.is_err() {
+                    return;
                 }
             }
             incoming = socket.recv() => {
                 match incoming {
-                    Some(Ok(Message::Close(_))) => break,
-                    Some(Ok(_)) => continue,
-                    _ => break,
+                    Some(Ok(Message::Close(_))) | Some(Err(_)) | None => return,
+                    Some(Ok(_)) => {}
                 }
             }
         }
     }
 }
+
+async fn send_frame(socket: &mut WebSocket, format: WireFormat, frame: &StreamFrame) -> Result<(), ()> {
+    let message = match format {
+        WireFormat::Json => Message::Text(serde_json::to_string(frame).map_err(drop)?.into()),
+        _ => Message::Binary(format.encode(frame).map_err(drop)?.into()),
+    };
+    socket.send(message).await.map_err(drop)
+}
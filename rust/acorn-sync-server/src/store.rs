@@ -0,0 +1,904 @@
+//! Backend state shared by the HTTP handlers: the trunk, its change feed and the per-branch
+//! gates used where a trunk cannot make compare-and-set atomic on its own.
+//!
+//! Nothing here holds a server-wide lock. Memory and segment trunks already serialize CAS per
+//! shard/branch internally, so batches for different branches (and, for the memory trunk,
+//! different keys) apply in parallel. The file trunk checks versions and writes in separate
+//! filesystem calls, so its batches are serialized per branch.
+//!
+//! Each branch also keeps a Merkle tree of its live keys for anti-entropy. It is built from
+//! the trunk the first time a client asks for it and then updated by `apply`, so reconciling
+//! a large branch costs a few hash pages instead of a full pull.
+
+use std::collections::HashMap;
+use std::sync::{Arc, OnceLock};
+
+use acorn_core::{AcornError, AcornResult, BranchId, Nut, TombstoneProvider, Trunk};
+use acorn_sync::merkle::value_token;
+use acorn_sync::{
+    FetchRequest, MerkleEntriesRequest, MerkleEntriesResponse, MerkleHashesRequest, MerkleHashesResponse,
+    MerkleSummary, MerkleTree, StreamChange, StreamFrame, SyncApplyResponse, SyncBatch, SyncConflict,
+    SyncConflictKind, SyncCursor, SyncError, SyncMutation, SyncPullResponse,
+};
+use acorn_trunk_file::{FileTrunk, SegmentTrunk};
+use acorn_trunk_mem::MemoryTrunk;
+use parking_lot::{Mutex, RwLock};
+
+use crate::changes::ChangeFeed;
+
+/// Upper bound on keys returned by one `/sync/pull` page.
+pub const MAX_PULL_LIMIT: usize = 10_000;
+
+/// Page size of a `/sync/pull` that names no `limit`. This applies to pulls without a cursor
+/// too, so a client must follow `has_more` and `cursor` to read a larger branch in full.
+pub const DEFAULT_PULL_LIMIT: usize = 1_000;
+
+#[derive(Debug, Clone, serde::Serialize)]
+pub struct StreamOp {
+    pub key: String,
+    pub op: String,
+    pub version: Option<u64>,
+}
+
+/// Outcome of one apply call: the response for the client plus the ops it applied.
+#[derive(Debug)]
+pub struct AppliedBatch {
+    pub response: SyncApplyResponse,
+    pub ops: Vec<StreamOp>,
+}
+
+#[derive(Debug)]
+pub enum BackendTrunk {
+    Memory(MemoryTrunk),
+    File(FileTrunk),
+    Segment(SegmentTrunk),
+}
+
+impl BackendTrunk {
+    pub fn from_env() -> Self {
+        if let Ok(path) = std::env::var("ACORN_TRUNK_SEGMENTS") {
+            BackendTrunk::Segment(SegmentTrunk::new(path))
+        } else if let Ok(path) = std::env::var("ACORN_TRUNK_FILE") {
+            BackendTrunk::File(FileTrunk::with_history_and_ttl(path))
+        } else {
+            BackendTrunk::Memory(MemoryTrunk::sharded_for_host())
+        }
+    }
+
+    /// Whether version checks and writes must be serialized per branch by the caller.
+    fn needs_branch_gate(&self) -> bool {
+        matches!(self, BackendTrunk::File(_))
+    }
+
+    /// Compare-and-set put returning the version it wrote. The file trunk checks and writes
+    /// in separate steps, so it relies on the caller's branch gate to keep them together.
+    fn put_if_version(
+        &self,
+        branch: &BranchId,
+        key: &str,
+        expected: Option<u64>,
+        value: Vec<u8>,
+    ) -> AcornResult<u64> {
+        match self {
+            BackendTrunk::Memory(t) => t.put_if_version_returning(branch, key, expected, Nut { value }),
+            BackendTrunk::File(t) => {
+                t.put_if_version(branch, key, expected, Nut { value })?;
+                t.current_version(branch, key)
+                    .ok_or_else(|| AcornError::MissingKey(key.to_string()))
+            }
+            BackendTrunk::Segment(t) => t.put_if_version_returning(branch, key, expected, Nut { value }),
+        }
+    }
+
+    /// Create `key` unless it is live or tombstoned; a conflict carries the live version.
+    fn create_if_unseen(&self, branch: &BranchId, key: &str, value: Vec<u8>) -> AcornResult<u64> {
+        match self {
+            BackendTrunk::Memory(t) => t.create_if_unseen(branch, key, Nut { value }),
+            BackendTrunk::File(t) => {
+                let current = t.current_version(branch, key);
+                if current.is_some() || t.tombstones(branch).iter().any(|(k, _)| k == key) {
+                    return Err(AcornError::VersionConflict {
+                        expected: None,
+                        actual: current,
+                    });
+                }
+                self.put_if_version(branch, key, None, value)
+            }
+            BackendTrunk::Segment(t) => t.create_if_unseen(branch, key, Nut { value }),
+        }
+    }
+
+    fn delete_if_version(&self, branch: &BranchId, key: &str, expected: Option<u64>) -> AcornResult<()> {
+        match self {
+            BackendTrunk::Memory(t) => t.delete_if_version(branch, key, expected),
+            BackendTrunk::File(t) => t.delete_if_version(branch, key, expected),
+            BackendTrunk::Segment(t) => t.delete_if_version(branch, key, expected),
+        }
+    }
+
+    fn get(&self, branch: &BranchId, key: &str) -> Option<Vec<u8>> {
+        match self {
+            BackendTrunk::Memory(t) => t.get(branch, key).ok().flatten().map(|n| n.value),
+            BackendTrunk::File(t) => t.get(branch, key).ok().flatten().map(|n| n.value),
+            BackendTrunk::Segment(t) => t.get(branch, key).ok().flatten().map(|n| n.value),
+        }
+    }
+
+    fn keys(&self, branch: &BranchId) -> Vec<String> {
+        match self {
+            BackendTrunk::Memory(t) => t.keys(branch),
+            BackendTrunk::File(t) => t.keys(branch),
+            BackendTrunk::Segment(t) => t.keys(branch),
+        }
+    }
+
+    fn version(&self, branch: &BranchId, key: &str) -> Option<u64> {
+        match self {
+            BackendTrunk::Memory(t) => t.current_version(branch, key),
+            BackendTrunk::File(t) => t.current_version(branch, key),
+            BackendTrunk::Segment(t) => t.current_version(branch, key),
+        }
+    }
+
+    fn tombstones(&self, branch: &BranchId) -> Vec<(String, Option<u64>)> {
+        match self {
+            BackendTrunk::Memory(t) => t.tombstones(branch),
+            BackendTrunk::File(t) => t.tombstones(branch),
+            BackendTrunk::Segment(t) => t.tombstones(branch),
+        }
+    }
+
+    /// Every key the branch knows about, live or tombstoned; seeds the change feed.
+    fn known_keys(&self, branch: &BranchId) -> Vec<String> {
+        let mut keys = self.keys(branch);
+        keys.extend(self.tombstones(branch).into_iter().map(|(key, _)| key));
+        keys
+    }
+}
+
+#[derive(Debug)]
+pub struct SyncStore {
+    trunk: BackendTrunk,
+    changes: ChangeFeed,
+    gates: RwLock<HashMap<BranchId, Arc<Mutex<()>>>>,
+    merkle: RwLock<HashMap<BranchId, Arc<MerkleSlot>>>,
+}
+
+/// A branch's Merkle tree, seeded from the trunk on first use without holding the map lock.
+/// Applies that land while the seed scans the trunk leave their keys in `dirty`; they are
+/// re-read into the tree once it is published, and `dirty` becomes `None` for good.
+#[derive(Debug)]
+struct MerkleSlot {
+    tree: OnceLock<Arc<Mutex<MerkleTree>>>,
+    dirty: Mutex<Option<Vec<String>>>,
+}
+
+impl Default for MerkleSlot {
+    fn default() -> Self {
+        MerkleSlot {
+            tree: OnceLock::new(),
+            dirty: Mutex::new(Some(Vec::new())),
+        }
+    }
+}
+
+impl SyncStore {
+    pub fn new(trunk: BackendTrunk) -> Self {
+        SyncStore {
+            trunk,
+            changes: ChangeFeed::new(),
+            gates: RwLock::new(HashMap::new()),
+            merkle: RwLock::new(HashMap::new()),
+        }
+    }
+
+    pub fn from_env() -> Self {
+        Self::new(BackendTrunk::from_env())
+    }
+
+    pub fn epoch(&self) -> u64 {
+        self.changes.epoch()
+    }
+
+    fn gate(&self, branch: &BranchId) -> Option<Arc<Mutex<()>>> {
+        if !self.trunk.needs_branch_gate() {
+            return None;
+        }
+        if let Some(gate) = self.gates.read().get(branch) {
+            return Some(gate.clone());
+        }
+        Some(self.gates.write().entry(branch.clone()).or_default().clone())
+    }
+
+    fn merkle_slot(&self, branch: &BranchId) -> Arc<MerkleSlot> {
+        if let Some(slot) = self.merkle.read().get(branch) {
+            return slot.clone();
+        }
+        self.merkle.write().entry(branch.clone()).or_default().clone()
+    }
+
+    /// The branch's Merkle tree, built from the trunk on first use. The slot is registered
+    /// before the scan, so an apply either finished writing before the scan read the trunk or
+    /// finds the slot and has its keys replayed.
+    fn merkle_tree(&self, branch: &BranchId) -> Arc<Mutex<MerkleTree>> {
+        let slot = self.merkle_slot(branch);
+        let tree = slot
+            .tree
+            .get_or_init(|| {
+                let mut tree = MerkleTree::default();
+                for key in self.trunk.keys(branch) {
+                    if let Some(value) = self.trunk.get(branch, &key) {
+                        tree.set(key, value_token(&value));
+                    }
+                }
+                Arc::new(Mutex::new(tree))
+            })
+            .clone();
+        let mut dirty = slot.dirty.lock();
+        if let Some(keys) = dirty.take() {
+            self.refresh_merkle(&mut tree.lock(), branch, keys.iter());
+        }
+        tree
+    }
+
+    /// Bring a branch's tree up to date with the applied ops, or queue their keys while it is
+    /// still being seeded.
+    fn update_merkle(&self, branch: &BranchId, ops: &[StreamOp]) {
+        let Some(slot) = self.merkle.read().get(branch).cloned() else {
+            return;
+        };
+        let mut dirty = slot.dirty.lock();
+        if let Some(keys) = dirty.as_mut() {
+            keys.extend(ops.iter().map(|op| op.key.clone()));
+            return;
+        }
+        drop(dirty);
+        // `dirty` is only cleared after the tree is published
+        let tree = slot.tree.get().expect("seeded Merkle tree");
+        self.refresh_merkle(&mut tree.lock(), branch, ops.iter().map(|op| &op.key));
+    }
+
+    /// Values are re-read under the tree's lock rather than taken from the batch, so
+    /// concurrent applies of the same key leave the tree matching whichever write the trunk
+    /// kept.
+    fn refresh_merkle<'k>(
+        &self,
+        tree: &mut MerkleTree,
+        branch: &BranchId,
+        keys: impl Iterator<Item = &'k String>,
+    ) {
+        for key in keys {
+            match self.trunk.get(branch, key) {
+                Some(value) => tree.set(key.clone(), value_token(&value)),
+                None => tree.remove(key),
+            }
+        }
+    }
+
+    /// Apply a batch. Each operation is an atomic compare-and-set against the trunk; stale
+    /// versions become conflicts and the rest of the batch still applies.
+    pub fn apply(&self, batch: &SyncBatch) -> AcornResult<AppliedBatch> {
+        let branch = &batch.branch;
+        let gate = self.gate(branch);
+        let _serialized = gate.as_ref().map(|gate| gate.lock());
+        let mut ops = Vec::new();
+        let mut conflicts = Vec::new();
+
+        for op in &batch.operations {
+            match op {
+                SyncMutation::Put { key, value, version } => {
+                    let mut result = self.trunk.put_if_version(branch, key, *version, value.clone());
+                    if let Err(AcornError::VersionConflict { actual: None, .. }) = result {
+                        // Keys the server never had are created whatever version the client
+                        // last saw, matching the pre-CAS behaviour push relies on. A key the
+                        // server deleted stays deleted and the put is a conflict.
+                        result = self.trunk.create_if_unseen(branch, key, value.clone());
+                    }
+                    match result {
+                        Ok(written) => ops.push(StreamOp {
+                            key: key.clone(),
+                            op: "put".into(),
+                            version: Some(written),
+                        }),
+                        Err(AcornError::VersionConflict { actual, .. }) => conflicts.push(SyncConflict {
+                            key: key.clone(),
+                            remote_value: self.trunk.get(branch, key),
+                            local_value: Some(value.clone()),
+                            remote_version: actual,
+                            local_version: *version,
+                            kind: SyncConflictKind::VersionMismatch,
+                        }),
+                        Err(e) => return Err(e),
+                    }
+                }
+                SyncMutation::Delete { key, version } => match self
+                    .trunk
+                    .delete_if_version(branch, key, *version)
+                {
+                    Ok(()) => ops.push(StreamOp {
+                        key: key.clone(),
+                        op: "delete".into(),
+                        version: None,
+                    }),
+                    Err(AcornError::MissingKey(_))
+                    | Err(AcornError::VersionConflict { actual: None, .. }) => conflicts.push(SyncConflict {
+                        key: key.clone(),
+                        remote_value: None,
+                        local_value: None,
+                        remote_version: None,
+                        local_version: *version,
+                        kind: SyncConflictKind::MissingKey,
+                    }),
+                    Err(AcornError::VersionConflict { actual, .. }) => conflicts.push(SyncConflict {
+                        key: key.clone(),
+                        remote_value: self.trunk.get(branch, key),
+                        local_value: None,
+                        remote_version: actual,
+                        local_version: *version,
+                        kind: SyncConflictKind::VersionMismatch,
+                    }),
+                    Err(e) => return Err(e),
+                },
+            }
+        }
+
+        // Recording after the writes keeps the feed safe without the trunk being locked: a
+        // pull that sees the new sequence always reads a value at least that new.
+        if !ops.is_empty() {
+            let changes = self.changes.branch(branch, || self.trunk.known_keys(branch));
+            let mut changes = changes.lock();
+            for op in &ops {
+                changes.record(&op.key);
+            }
+            drop(changes);
+            self.update_merkle(branch, &ops);
+        }
+
+        Ok(AppliedBatch {
+            response: SyncApplyResponse {
+                applied: ops.len(),
+                conflicts,
+            },
+            ops,
+        })
+    }
+
+    /// Changes after `since` (when its `epoch` is current), at most `limit` keys, or
+    /// [`DEFAULT_PULL_LIMIT`] when none is given. Without a cursor the branch is paged from
+    /// its first key rather than returned whole. The response always carries the cursor to
+    /// continue from, and `has_more` says whether there is more to read.
+    pub fn pull(
+        &self,
+        branch: &BranchId,
+        since: Option<u64>,
+        epoch: Option<u64>,
+        limit: Option<usize>,
+    ) -> SyncPullResponse {
+        let current_epoch = self.changes.epoch();
+        // A cursor minted by a previous server process restarts from a full snapshot.
+        let since = match (since, epoch) {
+            (Some(seq), None) => seq,
+            (Some(seq), Some(e)) if e == current_epoch => seq,
+            _ => 0,
+        };
+        let limit = limit
+            .map(|l| l.clamp(1, MAX_PULL_LIMIT))
+            .unwrap_or(DEFAULT_PULL_LIMIT);
+        let page = self
+            .changes
+            .branch(branch, || self.trunk.known_keys(branch))
+            .lock()
+            .since(since, limit);
+
+        let mut ops = Vec::new();
+        let mut versions = Vec::new();
+        let mut deleted = Vec::new();
+        let mut deleted_versions = Vec::new();
+        let mut tombstones: Option<HashMap<String, Option<u64>>> = None;
+        let cursor = SyncCursor {
+            epoch: current_epoch,
+            seq: page.changes.last().map(|(seq, _)| *seq).unwrap_or(since),
+        };
+
+        for (_, key) in page.changes {
+            if let Some(value) = self.trunk.get(branch, &key) {
+                let version = self.trunk.version(branch, &key);
+                ops.push(SyncMutation::Put {
+                    key: key.clone(),
+                    value,
+                    version,
+                });
+                if let Some(v) = version {
+                    versions.push((key, v));
+                }
+            } else {
+                let tombstones =
+                    tombstones.get_or_insert_with(|| self.trunk.tombstones(branch).into_iter().collect());
+                deleted_versions.push((key.clone(), tombstones.get(&key).copied().flatten()));
+                deleted.push(key);
+            }
+        }
+
+        SyncPullResponse {
+            batch: SyncBatch {
+                branch: branch.clone(),
+                operations: ops,
+            },
+            versions,
+            deleted,
+            deleted_versions,
+            cursor: Some(cursor),
+            has_more: page.has_more,
+        }
+    }
+
+    /// Root of the branch's Merkle tree; where a reconcile starts.
+    pub fn merkle_summary(&self, branch: &BranchId) -> MerkleSummary {
+        self.merkle_tree(branch).lock().summary()
+    }
+
+    pub fn merkle_hashes(&self, request: &MerkleHashesRequest) -> Result<MerkleHashesResponse, SyncError> {
+        let hashes = self
+            .merkle_tree(&request.branch)
+            .lock()
+            .child_hashes(request.level, &request.nodes)?;
+        Ok(MerkleHashesResponse { hashes })
+    }
+
+    pub fn merkle_entries(&self, request: &MerkleEntriesRequest) -> Result<MerkleEntriesResponse, SyncError> {
+        let entries = self
+            .merkle_tree(&request.branch)
+            .lock()
+            .entries(&request.leaves)?;
+        Ok(MerkleEntriesResponse { entries })
+    }
+
+    /// Current values of `keys`, shaped like a pull so clients apply them the same way.
+    /// Keys deleted since the client compared hashes come back in `deleted`.
+    pub fn fetch(&self, request: &FetchRequest) -> SyncPullResponse {
+        let branch = &request.branch;
+        let mut ops = Vec::with_capacity(request.keys.len());
+        let mut versions = Vec::with_capacity(request.keys.len());
+        let mut deleted = Vec::new();
+        let mut deleted_versions = Vec::new();
+        let mut tombstones: Option<HashMap<String, Option<u64>>> = None;
+
+        for key in &request.keys {
+            if let Some(value) = self.trunk.get(branch, key) {
+                let version = self.trunk.version(branch, key);
+                ops.push(SyncMutation::Put {
+                    key: key.clone(),
+                    value,
+                    version,
+                });
+                if let Some(v) = version {
+                    versions.push((key.clone(), v));
+                }
+            } else {
+                let tombstones =
+                    tombstones.get_or_insert_with(|| self.trunk.tombstones(branch).into_iter().collect());
+                deleted_versions.push((key.clone(), tombstones.get(key).copied().flatten()));
+                deleted.push(key.clone());
+            }
+        }
+
+        SyncPullResponse {
+            batch: SyncBatch {
+                branch: branch.clone(),
+                operations: ops,
+            },
+            versions,
+            deleted,
+            deleted_versions,
+            cursor: None,
+            has_more: false,
+        }
+    }
+
+    /// Cursor at the latest change of `branch`.
+    pub fn head(&self, branch: &BranchId) -> SyncCursor {
+        SyncCursor {
+            epoch: self.changes.epoch(),
+            seq: self
+                .changes
+                .branch(branch, || self.trunk.known_keys(branch))
+                .lock()
+                .head(),
+        }
+    }
+
+    /// Next `/sync/stream` frame after `since`: the same page a pull would return, with
+    /// values above `inline_limit` left out for the client to pull.
+    pub fn stream_frame(
+        &self,
+        branch: &BranchId,
+        since: &SyncCursor,
+        limit: usize,
+        inline_limit: usize,
+    ) -> StreamFrame {
+        let page = self.pull(branch, Some(since.seq), Some(since.epoch), Some(limit));
+        let mut changes = Vec::with_capacity(page.batch.operations.len() + page.deleted_versions.len());
+        for op in page.batch.operations {
+            if let SyncMutation::Put { key, value, version } = op {
+                changes.push(StreamChange {
+                    key,
+                    version,
+                    deleted: false,
+                    value: (value.len() <= inline_limit).then_some(value),
+                });
+            }
+        }
+        for (key, version) in page.deleted_versions {
+            changes.push(StreamChange {
+                key,
+                version,
+                deleted: true,
+                value: None,
+            });
+        }
+        StreamFrame {
+            branch: branch.clone(),
+            cursor: page.cursor.unwrap_or(*since),
+            changes,
+            has_more: page.has_more,
+            reset: since.epoch != self.changes.epoch(),
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn put(key: &str, value: &[u8], version: Option<u64>) -> SyncMutation {
+        SyncMutation::Put {
+            key: key.into(),
+            value: value.to_vec(),
+            version,
+        }
+    }
+
+    fn batch(branch: &str, operations: Vec<SyncMutation>) -> SyncBatch {
+        SyncBatch {
+            branch: BranchId::new(branch),
+            operations,
+        }
+    }
+
+    fn stores() -> Vec<(SyncStore, Option<tempfile::TempDir>)> {
+        let file_dir = tempfile::tempdir().unwrap();
+        let segment_dir = tempfile::tempdir().unwrap();
+        vec![
+            (
+                SyncStore::new(BackendTrunk::Memory(MemoryTrunk::sharded(4))),
+                None,
+            ),
+            (
+                SyncStore::new(BackendTrunk::File(FileTrunk::with_history(file_dir.path()))),
+                Some(file_dir),
+            ),
+            (
+                SyncStore::new(BackendTrunk::Segment(SegmentTrunk::new(segment_dir.path()))),
+                Some(segment_dir),
+            ),
+        ]
+    }
+
+    #[test]
+    fn stale_versions_conflict_and_missing_deletes_are_reported() {
+        for (store, _dir) in stores() {
+            let first = store.apply(&batch("main", vec![put("k", b"v1", None)])).unwrap();
+            assert_eq!(first.response.applied, 1);
+            let v1 = first.ops[0].version;
+
+            let result = store
+                .apply(&batch(
+                    "main",
+                    vec![
+                        put("k", b"stale", Some(v1.unwrap() + 7)),
+                        put("k", b"v2", v1),
+                        put("new", b"x", Some(3)),
+                        SyncMutation::Delete {
+                            key: "absent".into(),
+                            version: None,
+                        },
+                    ],
+                ))
+                .unwrap();
+            assert_eq!(result.response.applied, 2, "{store:?}");
+            let kinds: Vec<_> = result
+                .response
+                .conflicts
+                .iter()
+                .map(|c| (c.key.as_str(), &c.kind))
+                .collect();
+            assert!(matches!(
+                kinds.as_slice(),
+                [
+                    ("k", SyncConflictKind::VersionMismatch),
+                    ("absent", SyncConflictKind::MissingKey)
+                ]
+            ));
+            assert_eq!(
+                result.response.conflicts[0].remote_value.as_deref(),
+                Some(&b"v1"[..])
+            );
+        }
+    }
+
+    #[test]
+    fn puts_report_the_version_they_wrote_and_leave_deleted_keys_deleted() {
+        for (store, _dir) in stores() {
+            let created = store.apply(&batch("main", vec![put("k", b"v1", None)])).unwrap();
+            assert_eq!(created.ops[0].version, Some(1), "{store:?}");
+            let updated = store
+                .apply(&batch("main", vec![put("k", b"v2", Some(1))]))
+                .unwrap();
+            assert_eq!(updated.ops[0].version, Some(2), "{store:?}");
+            let deleted = store
+                .apply(&batch(
+                    "main",
+                    vec![SyncMutation::Delete {
+                        key: "k".into(),
+                        version: Some(2),
+                    }],
+                ))
+                .unwrap();
+            assert_eq!(deleted.response.applied, 1);
+
+            // A client that last saw version 2 does not bring the key back
+            let stale = store
+                .apply(&batch(
+                    "main",
+                    vec![put("k", b"edit", Some(2)), put("unseen", b"x", Some(5))],
+                ))
+                .unwrap();
+            assert_eq!(stale.response.applied, 1, "{store:?}");
+            assert_eq!(stale.ops[0].key, "unseen");
+            assert_eq!(stale.ops[0].version, Some(1));
+            let conflict = &stale.response.conflicts[0];
+            assert_eq!((conflict.key.as_str(), conflict.remote_version), ("k", None));
+            assert!(matches!(conflict.kind, SyncConflictKind::VersionMismatch));
+            assert_eq!(store.trunk.get(&BranchId::new("main"), "k"), None);
+        }
+    }
+
+    #[test]
+    fn concurrent_cas_clients_never_both_win() {
+        for (store, _dir) in stores() {
+            let store = Arc::new(store);
+            store
+                .apply(&batch("shared", vec![put("counter", b"0", None)]))
+                .unwrap();
+            let version = store.trunk.version(&BranchId::new("shared"), "counter");
+            let winners: usize = std::thread::scope(|s| {
+                let handles: Vec<_> = (0..8)
+                    .map(|i| {
+                        let store = store.clone();
+                        s.spawn(move || {
+                            let value = format!("{i}");
+                            store
+                                .apply(&batch("shared", vec![put("counter", value.as_bytes(), version)]))
+                                .unwrap()
+                                .response
+                                .applied
+                        })
+                    })
+                    .collect();
+                handles.into_iter().map(|h| h.join().unwrap()).sum()
+            });
+            assert_eq!(winners, 1, "{store:?}");
+        }
+    }
+
+    #[test]
+    fn merkle_tree_follows_applies_and_matches_a_rebuild() {
+        for (store, _dir) in stores() {
+            let branch = BranchId::new("main");
+            let ops = (0..300).map(|i| put(&format!("k{i}"), format!("v{i}").as_bytes(), None));
+            store.apply(&batch("main", ops.collect())).unwrap();
+            let seeded = store.merkle_summary(&branch);
+            assert_eq!(seeded.count, 300);
+
+            store
+                .apply(&batch(
+                    "main",
+                    vec![
+                        put("k1", b"changed", None),
+                        put("extra", b"x", None),
+                        SyncMutation::Delete {
+                            key: "k2".into(),
+                            version: None,
+                        },
+                    ],
+                ))
+                .unwrap();
+
+            let mut rebuilt = MerkleTree::default();
+            for key in store.trunk.keys(&branch) {
+                rebuilt.set(key.clone(), value_token(&store.trunk.get(&branch, &key).unwrap()));
+            }
+            let summary = store.merkle_summary(&branch);
+            assert_eq!(summary, rebuilt.summary(), "{store:?}");
+            assert_ne!(summary.root, seeded.root);
+
+            let leaf = rebuilt.leaf_of("extra");
+            let entries = store
+                .merkle_entries(&MerkleEntriesRequest {
+                    branch: branch.clone(),
+                    leaves: vec![leaf],
+                })
+                .unwrap();
+            assert!(entries.entries.iter().any(|(key, _)| key == "extra"));
+            assert!(store
+                .merkle_hashes(&MerkleHashesRequest {
+                    branch: branch.clone(),
+                    level: 0,
+                    nodes: vec![1],
+                })
+                .is_err());
+        }
+    }
+
+    #[test]
+    fn applies_that_land_while_the_merkle_tree_seeds_are_replayed() {
+        for (store, _dir) in stores() {
+            let branch = BranchId::new("main");
+            store.apply(&batch("main", vec![put("old", b"o", None)])).unwrap();
+
+            // The seed has registered its slot and scanned the trunk, but not yet published,
+            // when an apply writes a new key and deletes the scanned one
+            let slot = store.merkle_slot(&branch);
+            let mut scanned = MerkleTree::default();
+            scanned.set("old".to_string(), value_token(b"o"));
+            store
+                .apply(&batch(
+                    "main",
+                    vec![
+                        put("new", b"n", None),
+                        SyncMutation::Delete {
+                            key: "old".into(),
+                            version: None,
+                        },
+                    ],
+                ))
+                .unwrap();
+            slot.tree.set(Arc::new(Mutex::new(scanned))).unwrap();
+
+            let mut expected = MerkleTree::default();
+            expected.set("new".to_string(), value_token(b"n"));
+            assert_eq!(store.merkle_summary(&branch), expected.summary(), "{store:?}");
+
+            // Later applies go straight to the published tree
+            store
+                .apply(&batch("main", vec![put("later", b"l", None)]))
+                .unwrap();
+            expected.set("later".to_string(), value_token(b"l"));
+            assert_eq!(store.merkle_summary(&branch), expected.summary(), "{store:?}");
+        }
+    }
+
+    #[test]
+    fn fetch_returns_versions_and_reports_deleted_keys() {
+        for (store, _dir) in stores() {
+            let branch = BranchId::new("main");
+            store
+                .apply(&batch("main", vec![put("a", b"1", None), put("b", b"2", None)]))
+                .unwrap();
+            store
+                .apply(&batch(
+                    "main",
+                    vec![SyncMutation::Delete {
+                        key: "b".into(),
+                        version: None,
+                    }],
+                ))
+                .unwrap();
+
+            let fetched = store.fetch(&FetchRequest {
+                branch: branch.clone(),
+                keys: vec!["a".into(), "b".into()],
+            });
+            assert_eq!(fetched.batch.operations.len(), 1);
+            assert_eq!(fetched.versions.len(), 1, "{store:?}");
+            assert_eq!(fetched.deleted, vec!["b".to_string()]);
+        }
+    }
+
+    #[test]
+    fn pull_pages_follow_applies() {
+        let store = SyncStore::new(BackendTrunk::Memory(MemoryTrunk::new()));
+        let branch = BranchId::new("main");
+        store
+            .apply(&batch("main", vec![put("a", b"1", None), put("b", b"2", None)]))
+            .unwrap();
+        let first = store.pull(&branch, Some(0), Some(store.epoch()), Some(1));
+        assert!(first.has_more);
+        let cursor = first.cursor.unwrap();
+
+        store
+            .apply(&batch(
+                "main",
+                vec![SyncMutation::Delete {
+                    key: "a".into(),
+                    version: None,
+                }],
+            ))
+            .unwrap();
+        let rest = store.pull(&branch, Some(cursor.seq), Some(cursor.epoch), None);
+        assert!(!rest.has_more);
+        assert_eq!(rest.batch.operations.len(), 1);
+        assert_eq!(rest.deleted, vec!["a".to_string()]);
+
+        let stale = store.pull(&branch, Some(cursor.seq), Some(cursor.epoch + 1), None);
+        assert_eq!(stale.batch.operations.len() + stale.deleted.len(), 2);
+    }
+
+    #[test]
+    fn pull_without_a_limit_is_paged() {
+        let store = SyncStore::new(BackendTrunk::Memory(MemoryTrunk::new()));
+        let branch = BranchId::new("main");
+        let ops = (0..DEFAULT_PULL_LIMIT + 1)
+            .map(|i| put(&format!("k{i}"), b"v", None))
+            .collect();
+        store.apply(&batch("main", ops)).unwrap();
+
+        let first = store.pull(&branch, None, None, None);
+        assert_eq!(first.batch.operations.len(), DEFAULT_PULL_LIMIT);
+        assert!(first.has_more);
+        let cursor = first.cursor.unwrap();
+        let rest = store.pull(&branch, Some(cursor.seq), Some(cursor.epoch), None);
+        assert_eq!(rest.batch.operations.len(), 1);
+        assert!(!rest.has_more);
+    }
+
+    #[test]
+    fn stream_frames_inline_small_values_and_flag_resets() {
+        let store = SyncStore::new(BackendTrunk::Memory(MemoryTrunk::new()));
+        let branch = BranchId::new("main");
+        let start = store.head(&branch);
+        store
+            .apply(&batch(
+                "main",
+                vec![put("small", b"1", None), put("large", &[7; 64], None)],
+            ))
+            .unwrap();
+        store
+            .apply(&batch(
+                "main",
+                vec![SyncMutation::Delete {
+                    key: "small".into(),
+                    version: None,
+                }],
+            ))
+            .unwrap();
+        store
+            .apply(&batch("main", vec![put("tiny", b"2", None)]))
+            .unwrap();
+
+        let frame = store.stream_frame(&branch, &start, 2, 16);
+        assert!(frame.has_more && !frame.reset);
+        assert_eq!(frame.changes.len(), 2);
+        let large = frame.changes.iter().find(|c| c.key == "large").unwrap();
+        assert!(!large.deleted && large.value.is_none() && large.version.is_some());
+        let small = frame.changes.iter().find(|c| c.key == "small").unwrap();
+        assert!(small.deleted);
+
+        let rest = store.stream_frame(&branch, &frame.cursor, 2, 16);
+        assert!(!rest.has_more);
+        assert_eq!(rest.changes[0].value.as_deref(), Some(&b"2"[..]));
+        assert_eq!(rest.cursor, store.head(&branch));
+        assert!(store
+            .stream_frame(&branch, &rest.cursor, 2, 16)
+            .changes
+            .is_empty());
+
+        let stale = SyncCursor {
+            epoch: store.epoch() + 1,
+            seq: rest.cursor.seq,
+        };
+        let snapshot = store.stream_frame(&branch, &stale, 10, 16);
+        assert!(snapshot.reset);
+        assert_eq!(snapshot.changes.len(), 3);
+    }
+}
@@ -1,13 +1,31 @@
 #![allow(dead_code)]
 
-use acorn_core::{AcornError, AcornResult, BranchId, KeyedTrunk, Tree, Trunk};
+use acorn_core::{AcornError, AcornResult, BranchId, KeyedTrunk, Nut, Tree, Trunk};
+use futures::future::{self, BoxFuture};
+use futures::stream::StreamExt;
 use serde::{de::DeserializeOwned, Serialize};
+use std::collections::{HashMap, HashSet};
+use std::path::PathBuf;
+use std::sync::Mutex;
 #[cfg(feature = "http-client")]
-use serde_json;
+use std::sync::OnceLock;
 #[cfg(feature = "http-client")]
-use std::collections::{HashMap, HashSet};
+use std::time::Duration;
 use tracing::instrument;
 
+pub mod merkle;
+pub mod stream;
+pub mod wire;
+
+pub use merkle::{
+    FetchRequest, MerkleDiff, MerkleEntriesRequest, MerkleEntriesResponse, MerkleHashesRequest,
+    MerkleHashesResponse, MerkleSummary, MerkleTree,
+};
+#[cfg(feature = "websocket")]
+pub use stream::WebSocketSource;
+pub use stream::{StreamChange, StreamFrame, StreamOptions, StreamSource, Subscription};
+pub use wire::{WireFormat, WireMessage, BINARY_CONTENT_TYPE, JSON_CONTENT_TYPE};
+
 /// HTTP/WebSocket sync endpoint target.
 #[derive(Debug, Clone, serde::Serialize, serde::Deserialize)]
 pub struct SyncEndpoint {
@@ -30,82 +48,510 @@ pub enum SyncError {
 pub trait SyncTransport {
     fn apply(&self, request: &SyncApplyRequest) -> Result<SyncApplyResponse, SyncError>;
     fn pull(&self, branch: &BranchId) -> Result<SyncPullResponse, SyncError>;
+
+    /// Pull only the changes recorded after `since`, at most `limit` keys per page.
+    /// Transports without cursor support fall back to a full snapshot.
+    fn pull_since(
+        &self,
+        branch: &BranchId,
+        since: Option<&SyncCursor>,
+        limit: Option<usize>,
+    ) -> Result<SyncPullResponse, SyncError> {
+        let _ = (since, limit);
+        self.pull(branch)
+    }
+
+    /// Merkle anti-entropy calls (see [`merkle`]). Transports that do not speak it report a
+    /// protocol error, and [`SyncClient::reconcile_with_async_transport`] fails fast.
+    fn merkle_summary(&self, branch: &BranchId) -> Result<MerkleSummary, SyncError> {
+        let _ = branch;
+        Err(merkle_unsupported())
+    }
+
+    fn merkle_hashes(&self, request: &MerkleHashesRequest) -> Result<MerkleHashesResponse, SyncError> {
+        let _ = request;
+        Err(merkle_unsupported())
+    }
+
+    fn merkle_entries(&self, request: &MerkleEntriesRequest) -> Result<MerkleEntriesResponse, SyncError> {
+        let _ = request;
+        Err(merkle_unsupported())
+    }
+
+    fn fetch(&self, request: &FetchRequest) -> Result<SyncPullResponse, SyncError> {
+        let _ = request;
+        Err(merkle_unsupported())
+    }
+}
+
+fn merkle_unsupported() -> SyncError {
+    SyncError::Protocol("merkle anti-entropy is not supported by this transport".into())
 }
 
+/// Non-blocking transport. Calls only borrow the transport, so several requests can be in
+/// flight on one transport (and one connection pool) at the same time.
+pub trait AsyncSyncTransport: Send + Sync {
+    fn apply<'a>(
+        &'a self,
+        request: &'a SyncApplyRequest,
+    ) -> BoxFuture<'a, Result<SyncApplyResponse, SyncError>>;
+
+    fn pull_since<'a>(
+        &'a self,
+        branch: &'a BranchId,
+        since: Option<&'a SyncCursor>,
+        limit: Option<usize>,
+    ) -> BoxFuture<'a, Result<SyncPullResponse, SyncError>>;
+
+    /// Merkle anti-entropy calls; see [`SyncTransport::merkle_summary`].
+    fn merkle_summary<'a>(&'a self, branch: &'a BranchId) -> BoxFuture<'a, Result<MerkleSummary, SyncError>> {
+        let _ = branch;
+        Box::pin(future::ready(Err(merkle_unsupported())))
+    }
+
+    fn merkle_hashes<'a>(
+        &'a self,
+        request: &'a MerkleHashesRequest,
+    ) -> BoxFuture<'a, Result<MerkleHashesResponse, SyncError>> {
+        let _ = request;
+        Box::pin(future::ready(Err(merkle_unsupported())))
+    }
+
+    fn merkle_entries<'a>(
+        &'a self,
+        request: &'a MerkleEntriesRequest,
+    ) -> BoxFuture<'a, Result<MerkleEntriesResponse, SyncError>> {
+        let _ = request;
+        Box::pin(future::ready(Err(merkle_unsupported())))
+    }
+
+    fn fetch<'a>(&'a self, request: &'a FetchRequest) -> BoxFuture<'a, Result<SyncPullResponse, SyncError>> {
+        let _ = request;
+        Box::pin(future::ready(Err(merkle_unsupported())))
+    }
+}
+
+/// Adapts a blocking [`SyncTransport`] to [`AsyncSyncTransport`]; each call completes inline.
+#[derive(Debug, Clone, Default)]
+pub struct BlockingTransport<T>(pub T);
+
+impl<T: SyncTransport + Send + Sync> AsyncSyncTransport for BlockingTransport<T> {
+    fn apply<'a>(
+        &'a self,
+        request: &'a SyncApplyRequest,
+    ) -> BoxFuture<'a, Result<SyncApplyResponse, SyncError>> {
+        Box::pin(future::ready(self.0.apply(request)))
+    }
+
+    fn pull_since<'a>(
+        &'a self,
+        branch: &'a BranchId,
+        since: Option<&'a SyncCursor>,
+        limit: Option<usize>,
+    ) -> BoxFuture<'a, Result<SyncPullResponse, SyncError>> {
+        Box::pin(future::ready(self.0.pull_since(branch, since, limit)))
+    }
+
+    fn merkle_summary<'a>(&'a self, branch: &'a BranchId) -> BoxFuture<'a, Result<MerkleSummary, SyncError>> {
+        Box::pin(future::ready(self.0.merkle_summary(branch)))
+    }
+
+    fn merkle_hashes<'a>(
+        &'a self,
+        request: &'a MerkleHashesRequest,
+    ) -> BoxFuture<'a, Result<MerkleHashesResponse, SyncError>> {
+        Box::pin(future::ready(self.0.merkle_hashes(request)))
+    }
+
+    fn merkle_entries<'a>(
+        &'a self,
+        request: &'a MerkleEntriesRequest,
+    ) -> BoxFuture<'a, Result<MerkleEntriesResponse, SyncError>> {
+        Box::pin(future::ready(self.0.merkle_entries(request)))
+    }
+
+    fn fetch<'a>(&'a self, request: &'a FetchRequest) -> BoxFuture<'a, Result<SyncPullResponse, SyncError>> {
+        Box::pin(future::ready(self.0.fetch(request)))
+    }
+}
+
+/// How a push splits its mutations: at most `chunk_size` per request, with up to
+/// `max_in_flight` requests outstanding at once.
+#[derive(Debug, Clone, Copy)]
+pub struct PushOptions {
+    pub chunk_size: usize,
+    pub max_in_flight: usize,
+}
+
+impl Default for PushOptions {
+    fn default() -> Self {
+        PushOptions {
+            chunk_size: 512,
+            max_in_flight: 4,
+        }
+    }
+}
+
+/// HTTP transport. Every transport shares one process-wide `reqwest::Client`, so creating a
+/// transport per call is cheap and reuses pooled keep-alive connections.
+///
+/// Requests are driven on a dedicated I/O runtime. Pooled connections are tied to the runtime
+/// that opened them, so keeping them off the caller's runtime means they outlive short-lived
+/// runtimes, and the blocking [`SyncTransport`] impl can be called from inside async code
+/// without nesting runtimes.
 #[cfg(feature = "http-client")]
 #[derive(Clone)]
 pub struct HttpTransport {
     client: reqwest::Client,
     base_url: String,
+    format: WireFormat,
 }
 
 #[cfg(feature = "http-client")]
 impl HttpTransport {
     pub fn new<T: Into<String>>(base_url: T) -> Self {
+        Self::with_client(shared_client(), base_url)
+    }
+
+    /// Use a caller-configured client instead of the shared one.
+    pub fn with_client<T: Into<String>>(client: reqwest::Client, base_url: T) -> Self {
         HttpTransport {
-            client: reqwest::Client::new(),
+            client,
             base_url: base_url.into(),
+            format: WireFormat::default(),
         }
     }
 
-    fn block_on<F, T>(&self, fut: F) -> Result<T, SyncError>
-    where
-        F: std::future::Future<Output = Result<T, reqwest::Error>>,
-    {
-        if let Ok(handle) = tokio::runtime::Handle::try_current() {
-            handle
-                .block_on(fut)
-                .map_err(|e| SyncError::Network(e.to_string()))
-        } else {
-            tokio::runtime::Runtime::new()
-                .map_err(|e| SyncError::Network(e.to_string()))?
-                .block_on(fut)
-                .map_err(|e| SyncError::Network(e.to_string()))
+    /// Send requests and ask for responses in `format` (JSON by default). Servers that do
+    /// not understand the binary format keep answering with JSON, which is still decoded.
+    pub fn with_format(mut self, format: WireFormat) -> Self {
+        self.format = format;
+        self
+    }
+
+    async fn send_apply(self, body: Vec<u8>) -> Result<SyncApplyResponse, SyncError> {
+        let response = self
+            .client
+            .post(format!("{}/sync/apply", self.base_url))
+            .header(reqwest::header::CONTENT_TYPE, self.format.content_type())
+            .header(reqwest::header::ACCEPT, self.format.accept())
+            .body(body)
+            .send()
+            .await
+            .map_err(|e| SyncError::Network(e.to_string()))?;
+        Self::decode(response).await
+    }
+
+    async fn send_pull(self, query: Vec<(&'static str, String)>) -> Result<SyncPullResponse, SyncError> {
+        self.send_get("/sync/pull", query).await
+    }
+
+    async fn send_get<R: WireMessage>(
+        self,
+        path: &'static str,
+        query: Vec<(&'static str, String)>,
+    ) -> Result<R, SyncError> {
+        let response = self
+            .client
+            .get(format!("{}{path}", self.base_url))
+            .query(&query)
+            .header(reqwest::header::ACCEPT, self.format.accept())
+            .send()
+            .await
+            .map_err(|e| SyncError::Network(e.to_string()))?;
+        Self::decode(response).await
+    }
+
+    /// POST an already encoded request body.
+    async fn send_post<R: WireMessage>(self, path: &'static str, body: Vec<u8>) -> Result<R, SyncError> {
+        let response = self
+            .client
+            .post(format!("{}{path}", self.base_url))
+            .header(reqwest::header::CONTENT_TYPE, self.format.content_type())
+            .header(reqwest::header::ACCEPT, self.format.accept())
+            .body(body)
+            .send()
+            .await
+            .map_err(|e| SyncError::Network(e.to_string()))?;
+        Self::decode(response).await
+    }
+
+    fn pull_query(
+        branch: &BranchId,
+        since: Option<&SyncCursor>,
+        limit: Option<usize>,
+    ) -> Vec<(&'static str, String)> {
+        let mut query = vec![("branch", branch.as_str().to_string())];
+        if let Some(cursor) = since {
+            query.push(("since", cursor.seq.to_string()));
+            query.push(("epoch", cursor.epoch.to_string()));
+        }
+        if let Some(limit) = limit {
+            query.push(("limit", limit.to_string()));
+        }
+        query
+    }
+
+    /// Decode a response body according to its `Content-Type`.
+    async fn decode<M: WireMessage>(response: reqwest::Response) -> Result<M, SyncError> {
+        let response = response
+            .error_for_status()
+            .map_err(|e| SyncError::Protocol(e.to_string()))?;
+        let format = WireFormat::from_content_type(
+            response
+                .headers()
+                .get(reqwest::header::CONTENT_TYPE)
+                .and_then(|v| v.to_str().ok()),
+        );
+        let body = response
+            .bytes()
+            .await
+            .map_err(|e| SyncError::Network(e.to_string()))?;
+        format.decode(&body)
+    }
+}
+
+#[cfg(feature = "http-client")]
+fn shared_client() -> reqwest::Client {
+    static CLIENT: OnceLock<reqwest::Client> = OnceLock::new();
+    CLIENT
+        .get_or_init(|| {
+            reqwest::Client::builder()
+                .pool_idle_timeout(Duration::from_secs(90))
+                .pool_max_idle_per_host(32)
+                .tcp_nodelay(true)
+                .build()
+                .unwrap_or_else(|_| reqwest::Client::new())
+        })
+        .clone()
+}
+
+#[cfg(feature = "http-client")]
+fn io_runtime() -> Result<&'static tokio::runtime::Runtime, SyncError> {
+    static RUNTIME: OnceLock<Result<tokio::runtime::Runtime, String>> = OnceLock::new();
+    RUNTIME
+        .get_or_init(|| {
+            tokio::runtime::Builder::new_multi_thread()
+                .worker_threads(2)
+                .thread_name("acorn-sync-io")
+                .enable_all()
+                .build()
+                .map_err(|e| e.to_string())
+        })
+        .as_ref()
+        .map_err(|e| SyncError::Network(e.clone()))
+}
+
+/// Run `fut` on the I/O runtime and wait for it from any executor.
+#[cfg(feature = "http-client")]
+async fn run_io<F, T>(fut: F) -> Result<T, SyncError>
+where
+    F: std::future::Future<Output = Result<T, SyncError>> + Send + 'static,
+    T: Send + 'static,
+{
+    io_runtime()?
+        .spawn(fut)
+        .await
+        .map_err(|e| SyncError::Network(e.to_string()))?
+}
+
+/// Wait for `fut` on the I/O runtime from blocking code. A multi-threaded runtime's worker
+/// hands its other tasks off with `block_in_place` first. A current-thread runtime cannot,
+/// so its thread parks on a channel while the I/O runtime does the work.
+#[cfg(feature = "http-client")]
+fn block_on_io<F, T>(fut: F) -> Result<T, SyncError>
+where
+    F: std::future::Future<Output = Result<T, SyncError>> + Send + 'static,
+    T: Send + 'static,
+{
+    use tokio::runtime::{Handle, RuntimeFlavor};
+
+    let runtime = io_runtime()?;
+    match Handle::try_current() {
+        Err(_) => runtime.block_on(fut),
+        Ok(handle) if handle.runtime_flavor() == RuntimeFlavor::MultiThread => {
+            tokio::task::block_in_place(|| runtime.block_on(fut))
+        }
+        Ok(_) => {
+            let (tx, rx) = std::sync::mpsc::channel();
+            runtime.spawn(async move {
+                let _ = tx.send(fut.await);
+            });
+            rx.recv().map_err(|e| SyncError::Network(e.to_string()))?
         }
     }
 }
 
+#[cfg(feature = "http-client")]
+impl AsyncSyncTransport for HttpTransport {
+    fn apply<'a>(
+        &'a self,
+        request: &'a SyncApplyRequest,
+    ) -> BoxFuture<'a, Result<SyncApplyResponse, SyncError>> {
+        let body = self.format.encode(request);
+        let transport = self.clone();
+        Box::pin(async move { run_io(transport.send_apply(body?)).await })
+    }
+
+    fn pull_since<'a>(
+        &'a self,
+        branch: &'a BranchId,
+        since: Option<&'a SyncCursor>,
+        limit: Option<usize>,
+    ) -> BoxFuture<'a, Result<SyncPullResponse, SyncError>> {
+        let query = Self::pull_query(branch, since, limit);
+        Box::pin(run_io(self.clone().send_pull(query)))
+    }
+
+    fn merkle_summary<'a>(&'a self, branch: &'a BranchId) -> BoxFuture<'a, Result<MerkleSummary, SyncError>> {
+        let query = vec![("branch", branch.as_str().to_string())];
+        Box::pin(run_io(self.clone().send_get("/sync/merkle", query)))
+    }
+
+    fn merkle_hashes<'a>(
+        &'a self,
+        request: &'a MerkleHashesRequest,
+    ) -> BoxFuture<'a, Result<MerkleHashesResponse, SyncError>> {
+        let body = self.format.encode(request);
+        let transport = self.clone();
+        Box::pin(async move { run_io(transport.send_post("/sync/merkle/hashes", body?)).await })
+    }
+
+    fn merkle_entries<'a>(
+        &'a self,
+        request: &'a MerkleEntriesRequest,
+    ) -> BoxFuture<'a, Result<MerkleEntriesResponse, SyncError>> {
+        let body = self.format.encode(request);
+        let transport = self.clone();
+        Box::pin(async move { run_io(transport.send_post("/sync/merkle/entries", body?)).await })
+    }
+
+    fn fetch<'a>(&'a self, request: &'a FetchRequest) -> BoxFuture<'a, Result<SyncPullResponse, SyncError>> {
+        let body = self.format.encode(request);
+        let transport = self.clone();
+        Box::pin(async move { run_io(transport.send_post("/sync/fetch", body?)).await })
+    }
+}
+
+/// Blocking calls wait for the I/O runtime through [`block_on_io`], so they are safe from
+/// plain threads and from inside either runtime flavor.
 #[cfg(feature = "http-client")]
 impl SyncTransport for HttpTransport {
     fn apply(&self, request: &SyncApplyRequest) -> Result<SyncApplyResponse, SyncError> {
-        let url = format!("{}/sync/apply", self.base_url);
-        self.block_on(self.client.post(url).json(request).send())?
-            .error_for_status()
-            .map_err(|e| SyncError::Protocol(e.to_string()))?
-            .json::<SyncApplyResponse>()
-            .map_err(|e| SyncError::Protocol(e.to_string()))
+        let body = self.format.encode(request)?;
+        block_on_io(self.clone().send_apply(body))
     }
 
     fn pull(&self, branch: &BranchId) -> Result<SyncPullResponse, SyncError> {
-        let url = format!("{}/sync/pull", self.base_url);
-        self.block_on(self.client.get(url).query(&[("branch", branch.as_str())]).send())?
-            .error_for_status()
-            .map_err(|e| SyncError::Protocol(e.to_string()))?
-            .json::<SyncPullResponse>()
-            .map_err(|e| SyncError::Protocol(e.to_string()))
+        pull_snapshot(self, branch)
+    }
+
+    fn pull_since(
+        &self,
+        branch: &BranchId,
+        since: Option<&SyncCursor>,
+        limit: Option<usize>,
+    ) -> Result<SyncPullResponse, SyncError> {
+        let query = Self::pull_query(branch, since, limit);
+        block_on_io(self.clone().send_pull(query))
+    }
+
+    fn merkle_summary(&self, branch: &BranchId) -> Result<MerkleSummary, SyncError> {
+        let query = vec![("branch", branch.as_str().to_string())];
+        block_on_io(self.clone().send_get("/sync/merkle", query))
+    }
+
+    fn merkle_hashes(&self, request: &MerkleHashesRequest) -> Result<MerkleHashesResponse, SyncError> {
+        let body = self.format.encode(request)?;
+        block_on_io(self.clone().send_post("/sync/merkle/hashes", body))
+    }
+
+    fn merkle_entries(&self, request: &MerkleEntriesRequest) -> Result<MerkleEntriesResponse, SyncError> {
+        let body = self.format.encode(request)?;
+        block_on_io(self.clone().send_post("/sync/merkle/entries", body))
+    }
+
+    fn fetch(&self, request: &FetchRequest) -> Result<SyncPullResponse, SyncError> {
+        let body = self.format.encode(request)?;
+        block_on_io(self.clone().send_post("/sync/fetch", body))
     }
 }
 
-/// Stub sync client facade; will orchestrate pull/push/sync with retries.
+/// Client side of tree sync: pulls server changes into a [`Tree`], pushes local changes back
+/// in chunks and reconciles the two by Merkle diff. The `*_with_store` variants resume from a
+/// [`CursorStore`]; the `*_with_async_transport` variants run over any [`AsyncSyncTransport`],
+/// while the endpoint-based ones use HTTP and return [`AcornError::NotImplemented`] without
+/// the `http-client` feature. Failed calls are not retried; with a persistent store the next
+/// call resumes from the last saved cursor.
 #[derive(Debug, Default)]
 pub struct SyncClient;
 
 impl SyncClient {
-    #[instrument(skip(self, tree))]
+    /// Pull then push over one transport, so both directions share pooled connections. Nothing
+    /// is kept between calls: each one pulls a full snapshot. Use
+    /// [`SyncClient::synchronize_with_store`] to resume from a persisted cursor.
     pub async fn synchronize<T, S>(
         &self,
         tree: &Tree<T, S>,
         endpoint: &SyncEndpoint,
     ) -> AcornResult<SyncResult>
+    where
+        T: Clone + Send + Sync + 'static + std::fmt::Debug + Serialize + DeserializeOwned,
+        S: Trunk<T> + KeyedTrunk<T> + Clone + Send + Sync,
+    {
+        self.synchronize_with_store(tree, endpoint, &MemoryCursorStore::default())
+            .await
+    }
+
+    pub async fn pull<T, S>(&self, tree: &Tree<T, S>, endpoint: &SyncEndpoint) -> AcornResult<SyncResult>
+    where
+        T: Clone + Send + Sync + 'static + std::fmt::Debug + Serialize + DeserializeOwned,
+        S: Trunk<T> + Clone + Send + Sync,
+    {
+        self.pull_with_store(tree, endpoint, &MemoryCursorStore::default())
+            .await
+    }
+
+    pub async fn push<T, S>(&self, tree: &Tree<T, S>, endpoint: &SyncEndpoint) -> AcornResult<SyncResult>
     where
         T: Clone + Send + Sync + 'static + std::fmt::Debug + Serialize,
         S: Trunk<T> + KeyedTrunk<T> + Clone + Send + Sync,
+    {
+        self.push_with_store(tree, endpoint, &MemoryCursorStore::default())
+            .await
+    }
+
+    /// Pull then push over one transport. The pull resumes from the cursor in `store` and
+    /// the push sends only what changed locally since; see
+    /// [`SyncClient::pull_with_async_transport_and_store`] and
+    /// [`SyncClient::push_delta_with_async_transport_and_store`].
+    #[instrument(skip(self, tree, store))]
+    pub async fn synchronize_with_store<T, S, C>(
+        &self,
+        tree: &Tree<T, S>,
+        endpoint: &SyncEndpoint,
+        store: &C,
+    ) -> AcornResult<SyncResult>
+    where
+        T: Clone + Send + Sync + 'static + std::fmt::Debug + Serialize + DeserializeOwned,
+        S: Trunk<T> + KeyedTrunk<T> + Clone + Send + Sync,
+        C: CursorStore,
     {
         #[cfg(feature = "http-client")]
         {
             let transport = HttpTransport::new(endpoint.url.clone());
-            let pull = self.pull(tree, endpoint, &transport).await?;
-            let push = self.push(tree, endpoint, &transport).await?;
+            let pull = self
+                .pull_with_async_transport_and_store(&transport, tree, &endpoint.branch, store)
+                .await?;
+            let push = self
+                .push_delta_with_async_transport_and_store(
+                    &transport,
+                    tree,
+                    &endpoint.branch,
+                    store,
+                    PushOptions::default(),
+                )
+                .await?;
             Ok(SyncResult {
                 applied: pull.applied + push.applied,
                 conflicts: pull.conflicts + push.conflicts,
@@ -118,228 +564,874 @@ impl SyncClient {
         }
         #[cfg(not(feature = "http-client"))]
         {
-            let _ = (tree, endpoint);
+            let _ = (tree, endpoint, store);
             Err(AcornError::NotImplemented)
         }
     }
 
-    #[instrument(skip(self, tree))]
-    pub async fn pull<T, S>(&self, tree: &Tree<T, S>, endpoint: &SyncEndpoint) -> AcornResult<SyncResult>
+    #[instrument(skip(self, tree, store))]
+    pub async fn pull_with_store<T, S, C>(
+        &self,
+        tree: &Tree<T, S>,
+        endpoint: &SyncEndpoint,
+        store: &C,
+    ) -> AcornResult<SyncResult>
     where
         T: Clone + Send + Sync + 'static + std::fmt::Debug + Serialize + DeserializeOwned,
-        S: Trunk<T> + Send + Sync,
+        S: Trunk<T> + Clone + Send + Sync,
+        C: CursorStore,
     {
         #[cfg(feature = "http-client")]
         {
             let transport = HttpTransport::new(endpoint.url.clone());
-            self.pull_with_transport(&transport, &endpoint.branch)
-                .and_then(|resp| {
-                    for key in resp.deleted {
-                        let _ = tree.delete(&key)?;
-                    }
-
-                    let mut applied = 0usize;
-                    for op in resp.batch.operations {
-                        match op {
-                            SyncMutation::Put { key, value, .. } => {
-                                let decoded: T = serde_json::from_slice(&value)
-                                    .map_err(|e| AcornError::Serialization(e.to_string()))?;
-                                tree.put(&key, Nut { value: decoded })?;
-                                applied += 1;
-                            }
-                            SyncMutation::Delete { key, .. } => {
-                                let _ = tree.delete(&key)?;
-                            }
-                        }
-                    }
+            self.pull_with_async_transport_and_store(&transport, tree, &endpoint.branch, store)
+                .await
+        }
+        #[cfg(not(feature = "http-client"))]
+        {
+            let _ = (tree, endpoint, store);
+            Err(AcornError::NotImplemented)
+        }
+    }
 
-                    Ok(SyncResult {
-                        applied,
-                        conflicts: 0,
-                        conflict_keys: Vec::new(),
-                    })
-                })
+    #[instrument(skip(self, tree, store))]
+    pub async fn push_with_store<T, S, C>(
+        &self,
+        tree: &Tree<T, S>,
+        endpoint: &SyncEndpoint,
+        store: &C,
+    ) -> AcornResult<SyncResult>
+    where
+        T: Clone + Send + Sync + 'static + std::fmt::Debug + Serialize,
+        S: Trunk<T> + KeyedTrunk<T> + Clone + Send + Sync,
+        C: CursorStore,
+    {
+        #[cfg(feature = "http-client")]
+        {
+            let transport = HttpTransport::new(endpoint.url.clone());
+            self.push_delta_with_async_transport_and_store(
+                &transport,
+                tree,
+                &endpoint.branch,
+                store,
+                PushOptions::default(),
+            )
+            .await
         }
         #[cfg(not(feature = "http-client"))]
         {
-            let _ = (tree, endpoint);
+            let _ = (tree, endpoint, store);
             Err(AcornError::NotImplemented)
         }
     }
 
+    /// Merkle reconcile over HTTP; see [`SyncClient::reconcile_with_async_transport`].
     #[instrument(skip(self, tree))]
-    pub async fn push<T, S>(&self, tree: &Tree<T, S>, endpoint: &SyncEndpoint) -> AcornResult<SyncResult>
+    pub async fn reconcile<T, S>(
+        &self,
+        tree: &Tree<T, S>,
+        endpoint: &SyncEndpoint,
+    ) -> AcornResult<ReconcileResult>
     where
-        T: Clone + Send + Sync + 'static + std::fmt::Debug + Serialize,
+        T: Clone + Send + Sync + 'static + std::fmt::Debug + Serialize + DeserializeOwned,
         S: Trunk<T> + KeyedTrunk<T> + Clone + Send + Sync,
     {
         #[cfg(feature = "http-client")]
         {
             let transport = HttpTransport::new(endpoint.url.clone());
-            // Fetch remote snapshot for delta computation
-            let remote = self.pull_with_transport(&transport, &endpoint.branch)?;
-            let remote_versions: HashMap<_, _> = remote.versions.into_iter().collect();
-            let remote_keys: HashSet<_> = remote
-                .batch
-                .operations
-                .iter()
-                .map(|op| match op {
-                    SyncMutation::Put { key, .. } => key.clone(),
-                    SyncMutation::Delete { key, .. } => key.clone(),
-                })
-                .collect();
-            let remote_deleted: HashSet<_> = remote.deleted.into_iter().collect();
-            let remote_deleted_versions: HashMap<_, _> = remote.deleted_versions.into_iter().collect();
+            self.reconcile_with_async_transport(&transport, tree, &endpoint.branch, PushOptions::default())
+                .await
+        }
+        #[cfg(not(feature = "http-client"))]
+        {
+            let _ = (tree, endpoint);
+            Err(AcornError::NotImplemented)
+        }
+    }
 
-            let mut ops = Vec::new();
+    /// Pull a full snapshot of `branch` and apply it to `tree`.
+    pub async fn pull_with_async_transport<T, S, X>(
+        &self,
+        transport: &X,
+        tree: &Tree<T, S>,
+        branch: &BranchId,
+    ) -> AcornResult<SyncResult>
+    where
+        T: Clone + Send + Sync + 'static + DeserializeOwned,
+        S: Trunk<T> + Clone,
+        X: AsyncSyncTransport,
+    {
+        self.pull_with_async_transport_and_store(transport, tree, branch, &MemoryCursorStore::default())
+            .await
+    }
+
+    /// Pull the changes recorded after the cursor in `store` and apply them to `tree`, page
+    /// by page. Without a cursor, or with one from a previous server epoch, the first
+    /// page is a full snapshot. After each page the sync baseline and then the cursor are
+    /// saved, so an interrupted pull resumes after the last applied page. Keys changed
+    /// locally since the baseline keep their local value and are reported as conflicts.
+    pub async fn pull_with_async_transport_and_store<T, S, X, C>(
+        &self,
+        transport: &X,
+        tree: &Tree<T, S>,
+        branch: &BranchId,
+        store: &C,
+    ) -> AcornResult<SyncResult>
+    where
+        T: Clone + Send + Sync + 'static + DeserializeOwned,
+        S: Trunk<T> + Clone,
+        X: AsyncSyncTransport,
+        C: CursorStore,
+    {
+        let mut cursor = store.load(branch)?;
+        let mut baseline = match cursor {
+            Some(_) => store.load_baseline(branch)?.unwrap_or_default(),
+            None => SyncBaseline::default(),
+        };
+        let mut applied = 0usize;
+        let mut fresh = cursor.is_none();
+        let mut kept = Vec::new();
+        let mut first = true;
+        loop {
+            let page = transport
+                .pull_since(branch, cursor.as_ref(), None)
+                .await
+                .map_err(|e| AcornError::Trunk(format!("sync pull failed: {:?}", e)))?;
+            let next = page.cursor;
+            let has_more = page.has_more;
+            // A new epoch means the server answered with a snapshot; what was agreed with the
+            // previous process no longer holds.
+            if first && matches!((cursor, next), (Some(old), Some(new)) if old.epoch != new.epoch) {
+                baseline = SyncBaseline::default();
+                fresh = true;
+            }
+            first = false;
+
+            applied += apply_pulled(tree, branch, page, &mut baseline, fresh, &mut kept)?;
+            store.save_baseline(branch, &baseline)?;
+            if let Some(next) = next {
+                store.save(branch, &next)?;
+            }
+            // Stop when the server is drained, or when it cannot advance the cursor.
+            if !has_more || next.is_none() || next == cursor {
+                break;
+            }
+            cursor = next;
+        }
+
+        kept.sort();
+        kept.dedup();
+        Ok(SyncResult {
+            applied,
+            conflicts: kept.len(),
+            conflict_keys: kept,
+        })
+    }
+
+    /// Push the difference between `tree` and a remote snapshot, pipelined per `options`.
+    pub async fn push_delta_with_async_transport<T, S, X>(
+        &self,
+        transport: &X,
+        tree: &Tree<T, S>,
+        branch: &BranchId,
+        options: PushOptions,
+    ) -> AcornResult<SyncResult>
+    where
+        T: Clone + Send + Sync + 'static + Serialize,
+        S: Trunk<T> + KeyedTrunk<T> + Clone,
+        X: AsyncSyncTransport,
+    {
+        self.push_snapshot_delta(transport, tree, branch, options).await
+    }
 
-            // push local puts where version differs or missing remotely
-            for key in tree.trunk().keys(&endpoint.branch) {
-                let local_version = tree.trunk().version(&endpoint.branch, &key);
-                let remote_version = remote_versions.get(&key).copied();
-                if remote_version == local_version && !remote_deleted.contains(&key) {
+    /// Push the local changes made since the last sync, as recorded by the baseline in
+    /// `store`: keys whose local version moved away from the baseline are sent as puts
+    /// against the remote version they were synced at, and baseline keys gone locally as
+    /// deletes. Nothing is downloaded. Before any pull has left a baseline the delta is
+    /// computed against a remote snapshot instead. Accepted keys are written back to the
+    /// baseline; their new remote version is confirmed by the next pull.
+    pub async fn push_delta_with_async_transport_and_store<T, S, X, C>(
+        &self,
+        transport: &X,
+        tree: &Tree<T, S>,
+        branch: &BranchId,
+        store: &C,
+        options: PushOptions,
+    ) -> AcornResult<SyncResult>
+    where
+        T: Clone + Send + Sync + 'static + Serialize,
+        S: Trunk<T> + KeyedTrunk<T> + Clone,
+        X: AsyncSyncTransport,
+        C: CursorStore,
+    {
+        let Some(mut baseline) = store.load_baseline(branch)? else {
+            return self.push_snapshot_delta(transport, tree, branch, options).await;
+        };
+
+        let mut ops = Vec::new();
+        // Baseline entry each op leaves behind once the remote accepts it
+        let mut pushed = Vec::new();
+        let local_keys = tree.trunk().keys(branch);
+        for key in &local_keys {
+            let local_version = tree.trunk().version(branch, key);
+            let synced = baseline.keys.get(key).copied();
+            if synced.is_some_and(|synced| synced.local == local_version) {
+                continue;
+            }
+            if let Some(nut) = tree.get(key)? {
+                let bytes =
+                    serde_json::to_vec(&nut.value).map_err(|e| AcornError::Serialization(e.to_string()))?;
+                let remote = synced.and_then(|synced| synced.remote);
+                ops.push(SyncMutation::Put {
+                    key: key.clone(),
+                    value: bytes,
+                    version: remote,
+                });
+                // The remote bumps the version it accepted by one
+                let next = SyncedVersions {
+                    local: local_version,
+                    remote: remote.map(|v| v.saturating_add(1)),
+                };
+                pushed.push((key.clone(), Some(next)));
+            }
+        }
+        let local_keys: HashSet<_> = local_keys.into_iter().collect();
+        for (key, synced) in &baseline.keys {
+            if !local_keys.contains(key) {
+                ops.push(SyncMutation::Delete {
+                    key: key.clone(),
+                    version: synced.remote,
+                });
+                pushed.push((key.clone(), None));
+            }
+        }
+
+        let result = self.apply_pipelined(transport, branch, ops, options).await?;
+        let conflicted: HashSet<_> = result.conflict_keys.iter().collect();
+        for (key, next) in pushed {
+            if conflicted.contains(&key) {
+                continue;
+            }
+            match next {
+                Some(next) => baseline.keys.insert(key, next),
+                None => baseline.keys.remove(&key),
+            };
+        }
+        store.save_baseline(branch, &baseline)?;
+        Ok(result)
+    }
+
+    /// Delta push without a baseline: fetch the remote snapshot, diff versions and
+    /// tombstones against `tree`, then send the difference pipelined per `options`.
+    async fn push_snapshot_delta<T, S, X>(
+        &self,
+        transport: &X,
+        tree: &Tree<T, S>,
+        branch: &BranchId,
+        options: PushOptions,
+    ) -> AcornResult<SyncResult>
+    where
+        T: Clone + Send + Sync + 'static + Serialize,
+        S: Trunk<T> + KeyedTrunk<T> + Clone,
+        X: AsyncSyncTransport,
+    {
+        // Fetch remote snapshot for delta computation
+        let remote = pull_snapshot_async(transport, branch)
+            .await
+            .map_err(|e| AcornError::Trunk(format!("sync pull failed: {:?}", e)))?;
+        let remote_versions: HashMap<_, _> = remote.versions.into_iter().collect();
+        let remote_keys: HashSet<_> = remote
+            .batch
+            .operations
+            .iter()
+            .map(|op| match op {
+                SyncMutation::Put { key, .. } => key.clone(),
+                SyncMutation::Delete { key, .. } => key.clone(),
+            })
+            .collect();
+        let remote_deleted: HashSet<_> = remote.deleted.into_iter().collect();
+        let remote_deleted_versions: HashMap<_, _> = remote.deleted_versions.into_iter().collect();
+
+        let mut ops = Vec::new();
+
+        // push local puts where version differs or missing remotely
+        let local_keys = tree.trunk().keys(branch);
+        for key in &local_keys {
+            let local_version = tree.trunk().version(branch, key);
+            let remote_version = remote_versions.get(key).copied();
+            if remote_version == local_version && !remote_deleted.contains(key) {
+                continue;
+            }
+            if let Some(remote_tomb) = remote_deleted_versions.get(key) {
+                if *remote_tomb == local_version {
                     continue;
                 }
-                if let Some(remote_tomb) = remote_deleted_versions.get(&key) {
-                    if *remote_tomb == local_version {
-                        continue;
-                    }
-                }
-                if remote_deleted.contains(&key) && remote_version.is_none() && local_version.is_none() {
+            }
+            if remote_deleted.contains(key) && remote_version.is_none() && local_version.is_none() {
+                continue;
+            }
+            if let Some(nut) = tree.get(key)? {
+                let bytes =
+                    serde_json::to_vec(&nut.value).map_err(|e| AcornError::Serialization(e.to_string()))?;
+                ops.push(SyncMutation::Put {
+                    key: key.clone(),
+                    value: bytes,
+                    version: local_version,
+                });
+            }
+        }
+
+        // send deletes for remote keys missing locally
+        let local_keys: HashSet<_> = local_keys.into_iter().collect();
+        for key in remote_keys {
+            if !local_keys.contains(&key) {
+                let version = remote_versions
+                    .get(&key)
+                    .copied()
+                    .or_else(|| remote_deleted_versions.get(&key).copied().flatten());
+                ops.push(SyncMutation::Delete { key, version });
+            }
+        }
+
+        self.apply_pipelined(transport, branch, ops, options).await
+    }
+
+    /// Merkle anti-entropy: compare hash trees with the remote top-down and transfer only the
+    /// keys whose contents differ (see [`merkle`]). Keys only the remote has, and divergent
+    /// keys whose remote version is at least the local one, are pulled; keys only `tree` has,
+    /// and divergent keys it holds a newer version of, are pushed as compare-and-set against
+    /// the remote version. Missing keys are copied, not deleted: deletes travel as tombstones
+    /// through pull and push.
+    pub async fn reconcile_with_async_transport<T, S, X>(
+        &self,
+        transport: &X,
+        tree: &Tree<T, S>,
+        branch: &BranchId,
+        options: PushOptions,
+    ) -> AcornResult<ReconcileResult>
+    where
+        T: Clone + Send + Sync + 'static + Serialize + DeserializeOwned,
+        S: Trunk<T> + KeyedTrunk<T> + Clone,
+        X: AsyncSyncTransport,
+    {
+        let failed = |e: SyncError| AcornError::Trunk(format!("sync reconcile failed: {:?}", e));
+        let encode =
+            |value: &T| serde_json::to_vec(value).map_err(|e| AcornError::Serialization(e.to_string()));
+
+        let mut local = MerkleTree::default();
+        for key in tree.trunk().keys(branch) {
+            if let Some(nut) = tree.get(&key)? {
+                let token = merkle::value_token(&encode(&nut.value)?);
+                local.set(key, token);
+            }
+        }
+        let mut diff = merkle::diff(&local, transport, branch).await.map_err(failed)?;
+
+        let mut pulled = 0usize;
+        let mut to_push = diff.local_only.clone();
+        let mut remote_versions = HashMap::new();
+        if !diff.divergent.is_empty() || !diff.remote_only.is_empty() {
+            let request = FetchRequest {
+                branch: branch.clone(),
+                keys: diff.divergent.iter().chain(&diff.remote_only).cloned().collect(),
+            };
+            let response = transport.fetch(&request).await.map_err(failed)?;
+            diff.round_trips += 1;
+            remote_versions = response.versions.into_iter().collect::<HashMap<_, _>>();
+            for op in response.batch.operations {
+                let SyncMutation::Put { key, value, version } = op else {
+                    continue;
+                };
+                let local_version = tree.trunk().version(branch, &key);
+                if matches!((local_version, version), (Some(mine), Some(theirs)) if mine > theirs) {
+                    to_push.push(key);
                     continue;
                 }
-                if let Some(nut) = tree.get(&key)? {
-                    let bytes = serde_json::to_vec(&nut.value)
-                        .map_err(|e| AcornError::Serialization(e.to_string()))?;
-                    ops.push(SyncMutation::Put {
-                        key: key.clone(),
-                        value: bytes,
-                        version: local_version,
-                    });
-                }
+                let decoded: T =
+                    serde_json::from_slice(&value).map_err(|e| AcornError::Serialization(e.to_string()))?;
+                tree.put(&key, Nut { value: decoded })?;
+                pulled += 1;
             }
+        }
 
-            // send deletes for remote keys missing locally
-            let local_keys: HashSet<_> = tree.trunk().keys(&endpoint.branch).into_iter().collect();
-            for key in remote_keys {
-                if !local_keys.contains(&key) {
-                    let version = remote_versions
-                        .get(&key)
-                        .copied()
-                        .or_else(|| remote_deleted_versions.get(&key).copied().flatten());
-                    ops.push(SyncMutation::Delete { key, version });
-                }
+        let mut ops = Vec::with_capacity(to_push.len());
+        for key in to_push {
+            if let Some(nut) = tree.get(&key)? {
+                ops.push(SyncMutation::Put {
+                    version: remote_versions.get(&key).copied(),
+                    value: encode(&nut.value)?,
+                    key,
+                });
             }
+        }
+        diff.round_trips += ops.len().div_ceil(options.chunk_size.max(1));
+        let push = self.apply_pipelined(transport, branch, ops, options).await?;
 
-            let request = SyncApplyRequest {
+        Ok(ReconcileResult { diff, pulled, push })
+    }
+
+    /// Send `ops` in chunks of `options.chunk_size`, keeping up to `options.max_in_flight`
+    /// requests outstanding instead of waiting for each round trip. Each key appears once in
+    /// a push, so chunks are independent and may complete in any order. The first transport
+    /// error aborts the push; chunks already acknowledged stay applied.
+    pub async fn apply_pipelined<X: AsyncSyncTransport>(
+        &self,
+        transport: &X,
+        branch: &BranchId,
+        ops: Vec<SyncMutation>,
+        options: PushOptions,
+    ) -> AcornResult<SyncResult> {
+        let chunk_size = options.chunk_size.max(1);
+        let mut requests = Vec::with_capacity(ops.len().div_ceil(chunk_size));
+        let mut ops = ops.into_iter().peekable();
+        while ops.peek().is_some() {
+            requests.push(SyncApplyRequest {
                 batch: SyncBatch {
-                    branch: endpoint.branch.clone(),
-                    operations: ops,
+                    branch: branch.clone(),
+                    operations: ops.by_ref().take(chunk_size).collect(),
                 },
-            };
+            });
+        }
 
-            let result = self.apply_with_transport(&transport, &request)?;
-            Ok(SyncResult {
-                applied: result.applied,
-                conflicts: result.conflicts.len(),
-                conflict_keys: result.conflicts.iter().map(|c| c.key.clone()).collect(),
-            })
+        let mut responses = futures::stream::iter(&requests)
+            .map(|request| transport.apply(request))
+            .buffer_unordered(options.max_in_flight.max(1));
+        let mut result = SyncResult {
+            applied: 0,
+            conflicts: 0,
+            conflict_keys: Vec::new(),
+        };
+        while let Some(response) = responses.next().await {
+            let response = response.map_err(|e| AcornError::Trunk(format!("sync apply failed: {:?}", e)))?;
+            result.applied += response.applied;
+            result.conflicts += response.conflicts.len();
+            result
+                .conflict_keys
+                .extend(response.conflicts.into_iter().map(|c| c.key));
         }
-        #[cfg(not(feature = "http-client"))]
-        {
-            let _ = (tree, endpoint);
-            Err(AcornError::NotImplemented)
+        Ok(result)
+    }
+
+    /// Async counterpart of [`SyncClient::apply_with_transport`].
+    pub async fn apply_with_async_transport<X: AsyncSyncTransport>(
+        &self,
+        transport: &X,
+        request: &SyncApplyRequest,
+    ) -> AcornResult<SyncApplyResult> {
+        let response = transport
+            .apply(request)
+            .await
+            .map_err(|e| AcornError::Trunk(format!("sync apply failed: {:?}", e)))?;
+        Ok(SyncApplyResult {
+            applied: response.applied,
+            conflicts: response.conflicts,
+        })
+    }
+
+    /// Apply a batch using the provided transport, surfacing conflicts with kinds.
+    pub fn apply_with_transport<T: SyncTransport>(
+        &self,
+        transport: &T,
+        request: &SyncApplyRequest,
+    ) -> AcornResult<SyncApplyResult> {
+        let response = transport
+            .apply(request)
+            .map_err(|e| AcornError::Trunk(format!("sync apply failed: {:?}", e)))?;
+        Ok(SyncApplyResult {
+            applied: response.applied,
+            conflicts: response.conflicts,
+        })
+    }
+
+    /// Push local keys/values using a provided transport (useful for tests or alternate transports).
+    pub fn push_with_transport<T, S, X>(
+        &self,
+        transport: &X,
+        tree: &Tree<T, S>,
+        branch: &BranchId,
+    ) -> AcornResult<SyncResult>
+    where
+        T: Clone + Send + Sync + 'static + std::fmt::Debug + Serialize,
+        S: Trunk<T> + KeyedTrunk<T> + Clone,
+        X: SyncTransport,
+    {
+        let mut ops = Vec::new();
+        for key in tree.trunk().keys(branch) {
+            if let Some(nut) = tree.get(&key)? {
+                let bytes =
+                    serde_json::to_vec(&nut.value).map_err(|e| AcornError::Serialization(e.to_string()))?;
+                ops.push(SyncMutation::Put {
+                    key: key.clone(),
+                    value: bytes,
+                    version: tree.trunk().version(branch, &key),
+                });
+            }
         }
+        let request = SyncApplyRequest {
+            batch: SyncBatch {
+                branch: branch.clone(),
+                operations: ops,
+            },
+        };
+        let result = self.apply_with_transport(transport, &request)?;
+        Ok(SyncResult {
+            applied: result.applied,
+            conflicts: result.conflicts.len(),
+            conflict_keys: result.conflicts.iter().map(|c| c.key.clone()).collect(),
+        })
+    }
+
+    /// Pull mutations using the provided transport.
+    pub fn pull_with_transport<T: SyncTransport>(
+        &self,
+        transport: &T,
+        branch: &BranchId,
+    ) -> AcornResult<SyncPullResponse> {
+        self.pull_with_transport_and_store(transport, branch, &MemoryCursorStore::default())
+    }
+
+    /// Pull every change recorded after the cursor in `store` as one response, and save the
+    /// cursor it ends at. The cursor has moved on by the time the response is returned; use
+    /// [`SyncClient::pull_pages_with_transport`] to only move it past pages that were applied.
+    pub fn pull_with_transport_and_store<T: SyncTransport, C: CursorStore>(
+        &self,
+        transport: &T,
+        branch: &BranchId,
+        store: &C,
+    ) -> AcornResult<SyncPullResponse> {
+        let mut merged: Option<SyncPullResponse> = None;
+        self.pull_pages_with_transport(transport, branch, store, None, |page| {
+            match merged.as_mut() {
+                Some(merged) => merge_page(merged, page),
+                None => merged = Some(page),
+            }
+            Ok(())
+        })?;
+        Ok(merged.expect("a pull returns at least one page"))
+    }
+
+    /// Pull a single page of changes recorded after `since`.
+    pub fn pull_since_with_transport<T: SyncTransport>(
+        &self,
+        transport: &T,
+        branch: &BranchId,
+        since: Option<&SyncCursor>,
+        limit: Option<usize>,
+    ) -> AcornResult<SyncPullResponse> {
+        transport
+            .pull_since(branch, since, limit)
+            .map_err(|e| AcornError::Trunk(format!("sync pull failed: {:?}", e)))
+    }
+
+    /// Pull every page after the cursor held in `store`, handing each page to `apply`.
+    /// The cursor is persisted only after `apply` succeeds, so an interrupted pull resumes
+    /// from the last applied page. Returns the number of pages pulled.
+    pub fn pull_pages_with_transport<T, C, F>(
+        &self,
+        transport: &T,
+        branch: &BranchId,
+        store: &C,
+        limit: Option<usize>,
+        mut apply: F,
+    ) -> AcornResult<usize>
+    where
+        T: SyncTransport,
+        C: CursorStore,
+        F: FnMut(SyncPullResponse) -> AcornResult<()>,
+    {
+        let mut cursor = store.load(branch)?;
+        let mut pages = 0usize;
+        loop {
+            let page = self.pull_since_with_transport(transport, branch, cursor.as_ref(), limit)?;
+            let next = page.cursor;
+            let has_more = page.has_more;
+            apply(page)?;
+            pages += 1;
+            if let Some(next) = next {
+                store.save(branch, &next)?;
+            }
+            // Stop when the server is drained, or when it cannot advance the cursor.
+            if !has_more || next.is_none() || next == cursor {
+                return Ok(pages);
+            }
+            cursor = next;
+        }
+    }
+}
+
+/// Apply one pulled page to `tree` and record each key it touched in `baseline`. Deletes of
+/// keys `tree` never had are not errors: pages report every key deleted after the cursor.
+///
+/// Keys changed locally since the baseline was taken keep their local value and their
+/// baseline entry, so the next push still sends them and the remote reports the conflict.
+/// So do keys missing from the baseline but present locally, i.e. created since the last
+/// sync, unless the baseline is `fresh` (first pull, or a new server epoch) and knows
+/// nothing yet. Kept keys are collected in `kept`.
+fn apply_pulled<T, S>(
+    tree: &Tree<T, S>,
+    branch: &BranchId,
+    page: SyncPullResponse,
+    baseline: &mut SyncBaseline,
+    fresh: bool,
+    kept: &mut Vec<String>,
+) -> AcornResult<usize>
+where
+    T: Clone + Send + Sync + 'static + DeserializeOwned,
+    S: Trunk<T> + Clone,
+{
+    let diverged = |baseline: &SyncBaseline, key: &str| {
+        let local = tree.trunk().version(branch, key);
+        match baseline.keys.get(key) {
+            Some(synced) => synced.local != local,
+            None => !fresh && local.is_some(),
+        }
+    };
+    let delete = |key: &str| match tree.delete(key) {
+        Ok(()) | Err(AcornError::MissingKey(_)) => Ok(()),
+        Err(e) => Err(e),
+    };
+    let deleted = page
+        .deleted
+        .into_iter()
+        .chain(page.batch.operations.iter().filter_map(|op| match op {
+            SyncMutation::Delete { key, .. } => Some(key.clone()),
+            SyncMutation::Put { .. } => None,
+        }));
+    for key in deleted.collect::<Vec<_>>() {
+        if diverged(baseline, &key) {
+            kept.push(key);
+            continue;
+        }
+        delete(&key)?;
+        baseline.keys.remove(&key);
+    }
+
+    let remote_versions: HashMap<_, _> = page.versions.into_iter().collect();
+    let mut applied = 0usize;
+    for op in page.batch.operations {
+        let SyncMutation::Put { key, value, version } = op else {
+            continue;
+        };
+        if diverged(baseline, &key) {
+            kept.push(key);
+            continue;
+        }
+        let decoded: T =
+            serde_json::from_slice(&value).map_err(|e| AcornError::Serialization(e.to_string()))?;
+        tree.put(&key, Nut { value: decoded })?;
+        let synced = SyncedVersions {
+            local: tree.trunk().version(branch, &key),
+            remote: version.or_else(|| remote_versions.get(&key).copied()),
+        };
+        baseline.keys.insert(key, synced);
+        applied += 1;
+    }
+    Ok(applied)
+}
+
+/// Full snapshot of `branch`: pages from the start of the server's change sequence and
+/// merges them. Servers cap a pull without a cursor at one page, so a single
+/// `pull_since(branch, None, None)` is not the whole branch.
+pub fn pull_snapshot<X: SyncTransport + ?Sized>(
+    transport: &X,
+    branch: &BranchId,
+) -> Result<SyncPullResponse, SyncError> {
+    let mut snapshot = transport.pull_since(branch, None, None)?;
+    let mut cursor = None;
+    // Stop when the server is drained, or when it cannot advance the cursor.
+    while snapshot.has_more && snapshot.cursor.is_some() && snapshot.cursor != cursor {
+        cursor = snapshot.cursor;
+        let page = transport.pull_since(branch, cursor.as_ref(), None)?;
+        merge_page(&mut snapshot, page);
+    }
+    Ok(snapshot)
+}
+
+/// [`pull_snapshot`] over an [`AsyncSyncTransport`].
+pub async fn pull_snapshot_async<X: AsyncSyncTransport + ?Sized>(
+    transport: &X,
+    branch: &BranchId,
+) -> Result<SyncPullResponse, SyncError> {
+    let mut snapshot = transport.pull_since(branch, None, None).await?;
+    let mut cursor = None;
+    while snapshot.has_more && snapshot.cursor.is_some() && snapshot.cursor != cursor {
+        cursor = snapshot.cursor;
+        let page = transport.pull_since(branch, cursor.as_ref(), None).await?;
+        merge_page(&mut snapshot, page);
+    }
+    Ok(snapshot)
+}
+
+/// Fold a later page into `merged`: entries for keys the page mentions are replaced by the
+/// page's.
+fn merge_page(merged: &mut SyncPullResponse, page: SyncPullResponse) {
+    let keys: HashSet<String> = page
+        .batch
+        .operations
+        .iter()
+        .map(|op| match op {
+            SyncMutation::Put { key, .. } | SyncMutation::Delete { key, .. } => key.clone(),
+        })
+        .chain(page.deleted.iter().cloned())
+        .collect();
+    merged.batch.operations.retain(|op| match op {
+        SyncMutation::Put { key, .. } | SyncMutation::Delete { key, .. } => !keys.contains(key),
+    });
+    merged.versions.retain(|(key, _)| !keys.contains(key));
+    merged.deleted.retain(|key| !keys.contains(key));
+    merged.deleted_versions.retain(|(key, _)| !keys.contains(key));
+
+    merged.batch.operations.extend(page.batch.operations);
+    merged.versions.extend(page.versions);
+    merged.deleted.extend(page.deleted);
+    merged.deleted_versions.extend(page.deleted_versions);
+    merged.cursor = page.cursor.or(merged.cursor);
+    merged.has_more = page.has_more;
+}
+
+/// Position in a server's per-branch change sequence. `epoch` identifies the server's
+/// sequence space; a cursor from another epoch makes the server answer with a full snapshot.
+#[derive(Debug, Clone, Copy, PartialEq, Eq, serde::Serialize, serde::Deserialize)]
+pub struct SyncCursor {
+    pub epoch: u64,
+    pub seq: u64,
+}
+
+/// What the last sync left both sides agreeing on, per key. Pushes diff the local trunk
+/// against it instead of against a remote snapshot.
+#[derive(Debug, Clone, Default, PartialEq, Eq, serde::Serialize, serde::Deserialize)]
+pub struct SyncBaseline {
+    pub keys: HashMap<String, SyncedVersions>,
+}
+
+/// Local version of a key when it was last pulled or pushed, and the remote version it
+/// corresponds to (`None` when the remote has not reported it yet).
+#[derive(Debug, Clone, Copy, PartialEq, Eq, serde::Serialize, serde::Deserialize)]
+pub struct SyncedVersions {
+    pub local: Option<u64>,
+    pub remote: Option<u64>,
+}
+
+/// Persists pull cursors, and the sync baseline that goes with them, between sync runs.
+pub trait CursorStore {
+    fn load(&self, branch: &BranchId) -> AcornResult<Option<SyncCursor>>;
+    fn save(&self, branch: &BranchId, cursor: &SyncCursor) -> AcornResult<()>;
+
+    /// Stores that keep no baseline make every push diff against a remote snapshot.
+    fn load_baseline(&self, branch: &BranchId) -> AcornResult<Option<SyncBaseline>> {
+        let _ = branch;
+        Ok(None)
+    }
+
+    fn save_baseline(&self, branch: &BranchId, baseline: &SyncBaseline) -> AcornResult<()> {
+        let _ = (branch, baseline);
+        Ok(())
+    }
+}
+
+/// Process-local cursor store.
+#[derive(Debug, Default)]
+pub struct MemoryCursorStore {
+    cursors: Mutex<HashMap<BranchId, SyncCursor>>,
+    baselines: Mutex<HashMap<BranchId, SyncBaseline>>,
+}
+
+impl CursorStore for MemoryCursorStore {
+    fn load(&self, branch: &BranchId) -> AcornResult<Option<SyncCursor>> {
+        Ok(self.cursors.lock().unwrap().get(branch).copied())
+    }
+
+    fn save(&self, branch: &BranchId, cursor: &SyncCursor) -> AcornResult<()> {
+        self.cursors.lock().unwrap().insert(branch.clone(), *cursor);
+        Ok(())
+    }
+
+    fn load_baseline(&self, branch: &BranchId) -> AcornResult<Option<SyncBaseline>> {
+        Ok(self.baselines.lock().unwrap().get(branch).cloned())
+    }
+
+    fn save_baseline(&self, branch: &BranchId, baseline: &SyncBaseline) -> AcornResult<()> {
+        self.baselines
+            .lock()
+            .unwrap()
+            .insert(branch.clone(), baseline.clone());
+        Ok(())
+    }
+}
+
+/// Stores one `<branch>.cursor` and one `<branch>.baseline` JSON file per branch, each
+/// replaced atomically on save.
+#[derive(Debug, Clone)]
+pub struct FileCursorStore {
+    dir: PathBuf,
+}
+
+impl FileCursorStore {
+    pub fn new<P: Into<PathBuf>>(dir: P) -> Self {
+        FileCursorStore { dir: dir.into() }
     }
 
-    /// Apply a batch using the provided transport, surfacing conflicts with kinds.
-    pub fn apply_with_transport<T: SyncTransport>(
-        &self,
-        transport: &T,
-        request: &SyncApplyRequest,
-    ) -> AcornResult<SyncApplyResult> {
-        let response = transport
-            .apply(request)
-            .map_err(|e| AcornError::Trunk(format!("sync apply failed: {:?}", e)))?;
-        Ok(SyncApplyResult {
-            applied: response.applied,
-            conflicts: response.conflicts,
-        })
+    fn path(&self, branch: &BranchId, extension: &str) -> PathBuf {
+        self.dir.join(format!("{}.{extension}", branch.as_str()))
     }
 
-    /// Push local keys/values using a provided transport (useful for tests or alternate transports).
-    pub fn push_with_transport<T, S, X>(
-        &self,
-        transport: &X,
-        tree: &Tree<T, S>,
-        branch: &BranchId,
-    ) -> AcornResult<SyncResult>
-    where
-        T: Clone + Send + Sync + 'static + std::fmt::Debug + Serialize,
-        S: Trunk<T> + KeyedTrunk<T> + Clone,
-        X: SyncTransport,
-    {
-        let mut ops = Vec::new();
-        for key in tree.trunk().keys(branch) {
-            if let Some(nut) = tree.get(&key)? {
-                let bytes =
-                    serde_json::to_vec(&nut.value).map_err(|e| AcornError::Serialization(e.to_string()))?;
-                ops.push(SyncMutation::Put {
-                    key: key.clone(),
-                    value: bytes,
-                    version: tree.trunk().version(branch, &key),
-                });
-            }
+    fn read<V: DeserializeOwned>(&self, branch: &BranchId, extension: &str) -> AcornResult<Option<V>> {
+        match std::fs::read(self.path(branch, extension)) {
+            Ok(bytes) => serde_json::from_slice(&bytes)
+                .map(Some)
+                .map_err(|e| AcornError::Serialization(e.to_string())),
+            Err(e) if e.kind() == std::io::ErrorKind::NotFound => Ok(None),
+            Err(e) => Err(AcornError::Trunk(e.to_string())),
         }
-        let request = SyncApplyRequest {
-            batch: SyncBatch {
-                branch: branch.clone(),
-                operations: ops,
-            },
-        };
-        let result = self.apply_with_transport(transport, &request)?;
-        Ok(SyncResult {
-            applied: result.applied,
-            conflicts: result.conflicts.len(),
-            conflict_keys: result.conflicts.iter().map(|c| c.key.clone()).collect(),
-        })
     }
 
-    /// Pull mutations using the provided transport.
-    pub fn pull_with_transport<T: SyncTransport>(
-        &self,
-        transport: &T,
-        branch: &BranchId,
-    ) -> AcornResult<SyncPullResponse> {
-        transport
-            .pull(branch)
-            .map_err(|e| AcornError::Trunk(format!("sync pull failed: {:?}", e)))
+    fn write<V: Serialize>(&self, branch: &BranchId, extension: &str, value: &V) -> AcornResult<()> {
+        std::fs::create_dir_all(&self.dir).map_err(|e| AcornError::Trunk(e.to_string()))?;
+        let bytes = serde_json::to_vec(value).map_err(|e| AcornError::Serialization(e.to_string()))?;
+        let path = self.path(branch, extension);
+        let tmp = path.with_extension(format!("{extension}.tmp"));
+        std::fs::write(&tmp, bytes).map_err(|e| AcornError::Trunk(e.to_string()))?;
+        std::fs::rename(&tmp, &path).map_err(|e| AcornError::Trunk(e.to_string()))
     }
 }
 
-/// Subscription placeholder; will be backed by streaming updates.
-#[derive(Debug, Default)]
-pub struct Subscription;
+impl CursorStore for FileCursorStore {
+    fn load(&self, branch: &BranchId) -> AcornResult<Option<SyncCursor>> {
+        self.read(branch, "cursor")
+    }
 
-impl Subscription {
-    pub async fn subscribe<T, S>(_tree: &Tree<T, S>) -> AcornResult<Self>
-    where
-        T: Clone + Send + Sync + 'static,
-        S: Trunk<T> + Send + Sync,
-    {
-        Ok(Subscription)
+    fn save(&self, branch: &BranchId, cursor: &SyncCursor) -> AcornResult<()> {
+        self.write(branch, "cursor", cursor)
+    }
+
+    fn load_baseline(&self, branch: &BranchId) -> AcornResult<Option<SyncBaseline>> {
+        self.read(branch, "baseline")
     }
 
-    pub async fn next_event(&self) -> AcornResult<Option<SyncEvent>> {
-        Err(AcornError::NotImplemented)
+    fn save_baseline(&self, branch: &BranchId, baseline: &SyncBaseline) -> AcornResult<()> {
+        self.write(branch, "baseline", baseline)
     }
 }
 
-/// Streaming events emitted during sync.
+/// Events yielded by a [`Subscription`].
 #[derive(Debug, Clone)]
 pub enum SyncEvent {
-    Applied { key: String },
-    Conflict { key: String },
+    /// `value` is `None` when it exceeded the stream's inline limit; pull to fetch it.
+    Applied {
+        key: String,
+        version: Option<u64>,
+        value: Option<Vec<u8>>,
+    },
+    Deleted {
+        key: String,
+        version: Option<u64>,
+    },
+    Conflict {
+        key: String,
+    },
+    /// The server no longer knows the subscription's cursor (it restarted with a new epoch);
+    /// the events that follow are a full snapshot of the branch.
+    Resync,
     Heartbeat,
 }
 
@@ -378,12 +1470,18 @@ pub struct SyncApplyResponse {
 }
 
 /// Response payload for pull requests (ops plus version snapshot).
+/// `cursor` is where the next incremental pull should resume; `has_more` is set when the
+/// page limit cut the response short.
 #[derive(Debug, Clone, serde::Serialize, serde::Deserialize)]
 pub struct SyncPullResponse {
     pub batch: SyncBatch,
     pub versions: Vec<(String, u64)>,
     pub deleted: Vec<String>,
     pub deleted_versions: Vec<(String, Option<u64>)>,
+    #[serde(default)]
+    pub cursor: Option<SyncCursor>,
+    #[serde(default)]
+    pub has_more: bool,
 }
 
 /// Conflict surface returned by sync operations.
@@ -422,6 +1520,16 @@ pub struct SyncResult {
     pub conflict_keys: Vec<String>,
 }
 
+/// Outcome of a Merkle reconcile: what differed, how many keys were pulled, and the push
+/// of the keys the local side held newer or only copies of.
+#[derive(Debug, Clone)]
+pub struct ReconcileResult {
+    /// `round_trips` includes the fetch and push requests.
+    pub diff: MerkleDiff,
+    pub pulled: usize,
+    pub push: SyncResult,
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
@@ -604,6 +1712,8 @@ mod tests {
                     versions,
                     deleted,
                     deleted_versions: Vec::new(),
+                    cursor: None,
+                    has_more: false,
                 })
             }
         }
@@ -742,6 +1852,8 @@ mod tests {
                     versions: vec![],
                     deleted: Vec::new(),
                     deleted_versions: Vec::new(),
+                    cursor: None,
+                    has_more: false,
                 })
             }
         }
@@ -788,14 +1900,581 @@ mod tests {
         assert_eq!(result.conflict_keys, vec!["key".to_string()]);
     }
 
-    #[cfg(feature = "http-client")]
+    /// Serves pages from the trunk history, keeping only the latest change per key.
+    struct ChangeFeedTransport {
+        trunk: MemoryTrunk,
+    }
+
+    impl SyncTransport for ChangeFeedTransport {
+        fn apply(&self, request: &SyncApplyRequest) -> Result<SyncApplyResponse, SyncError> {
+            let branch = &request.batch.branch;
+            for op in &request.batch.operations {
+                match op {
+                    SyncMutation::Put { key, value, .. } => {
+                        self.trunk.put(branch, key, Nut { value: value.clone() }).unwrap()
+                    }
+                    SyncMutation::Delete { key, .. } => self.trunk.delete(branch, key).unwrap(),
+                }
+            }
+            Ok(SyncApplyResponse {
+                applied: request.batch.operations.len(),
+                conflicts: Vec::new(),
+            })
+        }
+
+        fn pull(&self, branch: &BranchId) -> Result<SyncPullResponse, SyncError> {
+            self.pull_since(branch, None, None)
+        }
+
+        fn pull_since(
+            &self,
+            branch: &BranchId,
+            since: Option<&SyncCursor>,
+            limit: Option<usize>,
+        ) -> Result<SyncPullResponse, SyncError> {
+            use acorn_core::{HistoryEvent, HistoryProvider};
+            let since = since.map(|c| c.seq).unwrap_or(0);
+            let mut latest: Vec<(u64, String)> = Vec::new();
+            for event in self.trunk.history_since(branch, since).unwrap() {
+                let event = event.unwrap();
+                let key = match event.event {
+                    HistoryEvent::Put { key, .. } | HistoryEvent::Delete { key } => key,
+                };
+                latest.retain(|(_, k)| *k != key);
+                latest.push((event.seq, key));
+            }
+            let limit = limit.unwrap_or(usize::MAX);
+            let has_more = latest.len() > limit;
+            latest.truncate(limit);
+
+            let mut response = SyncPullResponse {
+                batch: SyncBatch {
+                    branch: branch.clone(),
+                    operations: Vec::new(),
+                },
+                versions: Vec::new(),
+                deleted: Vec::new(),
+                deleted_versions: Vec::new(),
+                cursor: latest.last().map(|(seq, _)| SyncCursor { epoch: 1, seq: *seq }),
+                has_more,
+            };
+            for (_, key) in latest {
+                match self.trunk.get(branch, &key).unwrap() {
+                    Some(nut) => response.batch.operations.push(SyncMutation::Put {
+                        key,
+                        value: nut.value,
+                        version: None,
+                    }),
+                    None => response.deleted.push(key),
+                }
+            }
+            Ok(response)
+        }
+    }
+
+    /// Serves the merkle calls from a trunk, rebuilding the tree per call, and counts the
+    /// keys fetched and the JSON bytes it answers with.
+    #[derive(Default)]
+    struct MerkleTransport {
+        trunk: MemoryTrunk,
+        fetched: Mutex<Vec<String>>,
+        bytes: Mutex<usize>,
+    }
+
+    impl MerkleTransport {
+        fn tree(&self, branch: &BranchId) -> MerkleTree {
+            let values: Vec<(String, Vec<u8>)> = self
+                .trunk
+                .keys(branch)
+                .into_iter()
+                .filter_map(|key| self.trunk.get(branch, &key).unwrap().map(|nut| (key, nut.value)))
+                .collect();
+            MerkleTree::from_values(values.iter().map(|(key, value)| (key.clone(), value.as_slice())))
+        }
+
+        fn counted<M: WireMessage>(&self, message: M) -> Result<M, SyncError> {
+            *self.bytes.lock().unwrap() += WireFormat::Json.encode(&message)?.len();
+            Ok(message)
+        }
+    }
+
+    impl SyncTransport for MerkleTransport {
+        fn apply(&self, request: &SyncApplyRequest) -> Result<SyncApplyResponse, SyncError> {
+            let branch = &request.batch.branch;
+            let mut conflicts = Vec::new();
+            for op in &request.batch.operations {
+                if let SyncMutation::Put { key, value, version } = op {
+                    let current = self.trunk.version(branch, key);
+                    if version.is_some() && *version != current {
+                        conflicts.push(SyncConflict {
+                            key: key.clone(),
+                            remote_value: None,
+                            local_value: Some(value.clone()),
+                            remote_version: current,
+                            local_version: *version,
+                            kind: SyncConflictKind::VersionMismatch,
+                        });
+                        continue;
+                    }
+                    self.trunk.put(branch, key, Nut { value: value.clone() }).unwrap();
+                }
+            }
+            Ok(SyncApplyResponse {
+                applied: request.batch.operations.len() - conflicts.len(),
+                conflicts,
+            })
+        }
+
+        fn pull(&self, _branch: &BranchId) -> Result<SyncPullResponse, SyncError> {
+            Err(SyncError::Unknown(
+                "reconcile must not pull the whole branch".into(),
+            ))
+        }
+
+        fn merkle_summary(&self, branch: &BranchId) -> Result<MerkleSummary, SyncError> {
+            self.counted(self.tree(branch).summary())
+        }
+
+        fn merkle_hashes(&self, request: &MerkleHashesRequest) -> Result<MerkleHashesResponse, SyncError> {
+            let hashes = self
+                .tree(&request.branch)
+                .child_hashes(request.level, &request.nodes)?;
+            self.counted(MerkleHashesResponse { hashes })
+        }
+
+        fn merkle_entries(&self, request: &MerkleEntriesRequest) -> Result<MerkleEntriesResponse, SyncError> {
+            let entries = self.tree(&request.branch).entries(&request.leaves)?;
+            self.counted(MerkleEntriesResponse { entries })
+        }
+
+        fn fetch(&self, request: &FetchRequest) -> Result<SyncPullResponse, SyncError> {
+            self.fetched.lock().unwrap().extend(request.keys.iter().cloned());
+            let mut response = SyncPullResponse {
+                batch: SyncBatch {
+                    branch: request.branch.clone(),
+                    operations: Vec::new(),
+                },
+                versions: Vec::new(),
+                deleted: Vec::new(),
+                deleted_versions: Vec::new(),
+                cursor: None,
+                has_more: false,
+            };
+            for key in &request.keys {
+                if let Some(nut) = self.trunk.get(&request.branch, key).unwrap() {
+                    let version = self.trunk.version(&request.branch, key);
+                    response.batch.operations.push(SyncMutation::Put {
+                        key: key.clone(),
+                        value: nut.value,
+                        version,
+                    });
+                    response.versions.extend(version.map(|v| (key.clone(), v)));
+                }
+            }
+            self.counted(response)
+        }
+    }
+
+    #[tokio::test]
+    async fn reconcile_transfers_only_divergent_keys() {
+        // The client stores values as serde_json of T, so that is what the remote trunk holds
+        let json = |value: &[u8]| serde_json::to_vec(value).unwrap();
+        let branch = BranchId::new("main");
+        let transport = BlockingTransport(MerkleTransport::default());
+        let remote = &transport.0.trunk;
+        let tree = Tree::new(branch.clone(), MemoryTrunk::new());
+        for i in 0..2000 {
+            let value = format!("value-{i}").into_bytes();
+            remote
+                .put(&branch, &format!("k{i}"), Nut { value: json(&value) })
+                .unwrap();
+            tree.put(&format!("k{i}"), Nut { value }).unwrap();
+        }
+        // Remote moved on for k0..k9, the local side for k10, and each has a key of its own
+        for i in 0..10 {
+            remote
+                .put(
+                    &branch,
+                    &format!("k{i}"),
+                    Nut {
+                        value: json(b"remote"),
+                    },
+                )
+                .unwrap();
+        }
+        tree.put(
+            "k10",
+            Nut {
+                value: b"local".to_vec(),
+            },
+        )
+        .unwrap();
+        remote
+            .put(&branch, "remote-only", Nut { value: json(b"r") })
+            .unwrap();
+        tree.put("local-only", Nut { value: b"l".to_vec() }).unwrap();
+
+        let reconciled = SyncClient
+            .reconcile_with_async_transport(&transport, &tree, &branch, PushOptions::default())
+            .await
+            .unwrap();
+
+        assert_eq!(reconciled.diff.divergent.len(), 11);
+        assert_eq!(reconciled.diff.remote_only, vec!["remote-only".to_string()]);
+        assert_eq!(reconciled.diff.local_only, vec!["local-only".to_string()]);
+        assert_eq!(reconciled.pulled, 11);
+        assert_eq!(reconciled.push.applied, 2);
+        assert_eq!(reconciled.push.conflicts, 0);
+        assert_eq!(transport.0.fetched.lock().unwrap().len(), 12);
+        assert_eq!(tree.get("k3").unwrap().unwrap().value, b"remote".to_vec());
+        assert_eq!(remote.get(&branch, "k10").unwrap().unwrap().value, json(b"local"));
+
+        // A few KB of hashes and entries, not the 2000-key branch
+        assert!(*transport.0.bytes.lock().unwrap() < 16 * 1024);
+
+        let again = SyncClient
+            .reconcile_with_async_transport(&transport, &tree, &branch, PushOptions::default())
+            .await
+            .unwrap();
+        assert!(again.diff.in_sync());
+        assert_eq!(again.diff.round_trips, 1);
+    }
+
+    #[tokio::test]
+    async fn reconcile_fails_fast_on_transports_without_merkle() {
+        let branch = BranchId::new("main");
+        let transport = BlockingTransport(ChangeFeedTransport {
+            trunk: MemoryTrunk::new(),
+        });
+        let tree = Tree::new(branch.clone(), MemoryTrunk::new());
+        tree.put("k", Nut { value: b"v".to_vec() }).unwrap();
+        let result = SyncClient
+            .reconcile_with_async_transport(&transport, &tree, &branch, PushOptions::default())
+            .await;
+        assert!(matches!(result, Err(AcornError::Trunk(_))));
+    }
+
+    #[test]
+    fn pull_pages_resumes_from_persisted_cursor() {
+        let branch = BranchId::new("paged");
+        let trunk = MemoryTrunk::new();
+        for i in 0..5 {
+            trunk
+                .put(&branch, &format!("k{i}"), Nut { value: vec![i] })
+                .unwrap();
+        }
+        let transport = ChangeFeedTransport { trunk: trunk.clone() };
+        let store = MemoryCursorStore::default();
+        let client = SyncClient;
+
+        let mut seen = Vec::new();
+        let pages = client
+            .pull_pages_with_transport(&transport, &branch, &store, Some(2), |page| {
+                seen.extend(page.batch.operations.into_iter().map(|op| match op {
+                    SyncMutation::Put { key, .. } | SyncMutation::Delete { key, .. } => key,
+                }));
+                Ok(())
+            })
+            .unwrap();
+        assert_eq!(pages, 3);
+        assert_eq!(seen, vec!["k0", "k1", "k2", "k3", "k4"]);
+        assert_eq!(store.load(&branch).unwrap().map(|c| c.seq), Some(5));
+
+        // Only changes after the stored cursor come back.
+        trunk.put(&branch, "k1", Nut { value: vec![9] }).unwrap();
+        trunk.delete(&branch, "k3").unwrap();
+        let mut puts = Vec::new();
+        let mut deletes = Vec::new();
+        client
+            .pull_pages_with_transport(&transport, &branch, &store, Some(10), |page| {
+                puts.extend(page.batch.operations);
+                deletes.extend(page.deleted);
+                Ok(())
+            })
+            .unwrap();
+        assert_eq!(puts.len(), 1);
+        assert_eq!(deletes, vec!["k3".to_string()]);
+    }
+
+    #[test]
+    fn failed_apply_does_not_advance_cursor() {
+        let branch = BranchId::new("retry");
+        let trunk = MemoryTrunk::new();
+        trunk.put(&branch, "a", Nut { value: vec![1] }).unwrap();
+        let transport = ChangeFeedTransport { trunk };
+        let store = MemoryCursorStore::default();
+
+        let result = SyncClient.pull_pages_with_transport(&transport, &branch, &store, None, |_| {
+            Err(AcornError::Trunk("disk full".into()))
+        });
+        assert!(result.is_err());
+        assert_eq!(store.load(&branch).unwrap(), None);
+    }
+
+    #[test]
+    fn file_cursor_store_round_trips() {
+        let dir = std::env::temp_dir().join(format!("acorn-sync-cursor-{}", std::process::id()));
+        let store = FileCursorStore::new(&dir);
+        let branch = BranchId::new("main");
+        assert_eq!(store.load(&branch).unwrap(), None);
+        let cursor = SyncCursor { epoch: 7, seq: 42 };
+        store.save(&branch, &cursor).unwrap();
+        assert_eq!(FileCursorStore::new(&dir).load(&branch).unwrap(), Some(cursor));
+        let _ = std::fs::remove_dir_all(&dir);
+    }
+
+    /// Counts how many applies are outstanding at once; each apply yields before answering
+    /// so a pipelined push has to start several before the first completes.
+    #[derive(Default)]
+    struct InFlightTransport {
+        in_flight: std::sync::atomic::AtomicUsize,
+        peak: std::sync::atomic::AtomicUsize,
+        keys: Mutex<Vec<String>>,
+    }
+
+    impl AsyncSyncTransport for InFlightTransport {
+        fn apply<'a>(
+            &'a self,
+            request: &'a SyncApplyRequest,
+        ) -> BoxFuture<'a, Result<SyncApplyResponse, SyncError>> {
+            use std::sync::atomic::Ordering;
+            Box::pin(async move {
+                let now = self.in_flight.fetch_add(1, Ordering::SeqCst) + 1;
+                self.peak.fetch_max(now, Ordering::SeqCst);
+                tokio::task::yield_now().await;
+                self.in_flight.fetch_sub(1, Ordering::SeqCst);
+                let mut keys = self.keys.lock().unwrap();
+                let mut conflicts = Vec::new();
+                for op in &request.batch.operations {
+                    if let SyncMutation::Put { key, .. } = op {
+                        if key == "k7" {
+                            conflicts.push(SyncConflict {
+                                key: key.clone(),
+                                remote_value: None,
+                                local_value: None,
+                                remote_version: None,
+                                local_version: None,
+                                kind: SyncConflictKind::VersionMismatch,
+                            });
+                            continue;
+                        }
+                        keys.push(key.clone());
+                    }
+                }
+                Ok(SyncApplyResponse {
+                    applied: request.batch.operations.len() - conflicts.len(),
+                    conflicts,
+                })
+            })
+        }
+
+        fn pull_since<'a>(
+            &'a self,
+            branch: &'a BranchId,
+            _since: Option<&'a SyncCursor>,
+            _limit: Option<usize>,
+        ) -> BoxFuture<'a, Result<SyncPullResponse, SyncError>> {
+            Box::pin(future::ready(Ok(SyncPullResponse {
+                batch: SyncBatch {
+                    branch: branch.clone(),
+                    operations: Vec::new(),
+                },
+                versions: Vec::new(),
+                deleted: Vec::new(),
+                deleted_versions: Vec::new(),
+                cursor: None,
+                has_more: false,
+            })))
+        }
+    }
+
+    #[tokio::test]
+    async fn pipelined_push_bounds_requests_in_flight() {
+        let transport = InFlightTransport::default();
+        let client = SyncClient;
+        let branch = BranchId::new("main");
+        let ops: Vec<_> = (0..20)
+            .map(|i| SyncMutation::Put {
+                key: format!("k{i}"),
+                value: vec![i as u8],
+                version: None,
+            })
+            .collect();
+        let options = PushOptions {
+            chunk_size: 2,
+            max_in_flight: 3,
+        };
+
+        let result = client
+            .apply_pipelined(&transport, &branch, ops, options)
+            .await
+            .unwrap();
+        assert_eq!(result.applied, 19);
+        assert_eq!(result.conflict_keys, vec!["k7".to_string()]);
+        assert_eq!(transport.peak.load(std::sync::atomic::Ordering::SeqCst), 3);
+        let mut keys = transport.keys.lock().unwrap().clone();
+        keys.sort();
+        assert_eq!(keys.len(), 19);
+        assert!(!keys.contains(&"k7".to_string()));
+    }
+
+    #[tokio::test]
+    async fn async_push_sends_local_delta_through_blocking_adapter() {
+        let remote = MemoryTrunk::new();
+        let branch = BranchId::new("main");
+        remote
+            .put(&branch, "stale", Nut { value: b"1".to_vec() })
+            .unwrap();
+        let transport = BlockingTransport(ChangeFeedTransport {
+            trunk: remote.clone(),
+        });
+
+        let tree = Tree::new(branch.clone(), MemoryTrunk::new());
+        for i in 0..5 {
+            tree.put(&format!("k{i}"), Nut { value: vec![i] }).unwrap();
+        }
+        let client = SyncClient;
+        let result = client
+            .push_delta_with_async_transport(
+                &transport,
+                &tree,
+                &branch,
+                PushOptions {
+                    chunk_size: 2,
+                    max_in_flight: 2,
+                },
+            )
+            .await
+            .unwrap();
+
+        assert_eq!(result.applied, 6);
+        let mut keys = remote.keys(&branch);
+        keys.sort();
+        assert_eq!(keys, vec!["k0", "k1", "k2", "k3", "k4"]);
+    }
+
+    #[tokio::test]
+    async fn async_push_after_pull_sends_only_changes_since_baseline() {
+        let remote = MemoryTrunk::new();
+        let branch = BranchId::new("main");
+        for i in 0..4u8 {
+            let value = serde_json::to_vec(&vec![i]).unwrap();
+            remote.put(&branch, &format!("k{i}"), Nut { value }).unwrap();
+        }
+        let transport = BlockingTransport(ChangeFeedTransport {
+            trunk: remote.clone(),
+        });
+        let store = MemoryCursorStore::default();
+        let tree = Tree::new(branch.clone(), MemoryTrunk::new());
+        let client = SyncClient;
+
+        let pull = client
+            .pull_with_async_transport_and_store(&transport, &tree, &branch, &store)
+            .await
+            .unwrap();
+        assert_eq!(pull.applied, 4);
+        assert_eq!(store.load_baseline(&branch).unwrap().unwrap().keys.len(), 4);
+
+        tree.put("k1", Nut { value: vec![9] }).unwrap();
+        tree.delete("k2").unwrap();
+        let push = client
+            .push_delta_with_async_transport_and_store(
+                &transport,
+                &tree,
+                &branch,
+                &store,
+                PushOptions::default(),
+            )
+            .await
+            .unwrap();
+        assert_eq!(push.applied, 2);
+        let mut keys = remote.keys(&branch);
+        keys.sort();
+        assert_eq!(keys, vec!["k0", "k1", "k3"]);
+        assert_eq!(
+            remote.get(&branch, "k1").unwrap().unwrap().value,
+            serde_json::to_vec(&vec![9u8]).unwrap()
+        );
+
+        // The baseline now matches the local trunk, so a second push has nothing to send
+        let again = client
+            .push_delta_with_async_transport_and_store(
+                &transport,
+                &tree,
+                &branch,
+                &store,
+                PushOptions::default(),
+            )
+            .await
+            .unwrap();
+        assert_eq!(again.applied, 0);
+    }
+
     #[tokio::test]
+    async fn async_pull_keeps_unpushed_local_changes() {
+        let remote = MemoryTrunk::new();
+        let branch = BranchId::new("main");
+        let json = |v: u8| serde_json::to_vec(&vec![v]).unwrap();
+        for i in 0..3u8 {
+            remote
+                .put(&branch, &format!("k{i}"), Nut { value: json(i) })
+                .unwrap();
+        }
+        let transport = BlockingTransport(ChangeFeedTransport {
+            trunk: remote.clone(),
+        });
+        let store = MemoryCursorStore::default();
+        let tree = Tree::new(branch.clone(), MemoryTrunk::new());
+        let client = SyncClient;
+        client
+            .pull_with_async_transport_and_store(&transport, &tree, &branch, &store)
+            .await
+            .unwrap();
+
+        // Both sides move on before the local changes are pushed
+        tree.put("k1", Nut { value: vec![10] }).unwrap();
+        tree.delete("k2").unwrap();
+        tree.put("k3", Nut { value: vec![30] }).unwrap();
+        for (key, v) in [("k0", 100), ("k1", 101), ("k2", 102), ("k3", 103)] {
+            remote.put(&branch, key, Nut { value: json(v) }).unwrap();
+        }
+
+        let pull = client
+            .pull_with_async_transport_and_store(&transport, &tree, &branch, &store)
+            .await
+            .unwrap();
+        assert_eq!(pull.applied, 1);
+        assert_eq!(pull.conflict_keys, vec!["k1", "k2", "k3"]);
+        assert_eq!(tree.get("k0").unwrap().unwrap().value, vec![100]);
+        assert_eq!(tree.get("k1").unwrap().unwrap().value, vec![10]);
+        assert!(tree.get("k2").unwrap().is_none());
+        assert_eq!(tree.get("k3").unwrap().unwrap().value, vec![30]);
+
+        // The baseline still shows them as unsynced, so the push sends every one
+        let push = client
+            .push_delta_with_async_transport_and_store(
+                &transport,
+                &tree,
+                &branch,
+                &store,
+                PushOptions::default(),
+            )
+            .await
+            .unwrap();
+        assert_eq!(push.applied, 3);
+        assert_eq!(remote.get(&branch, "k1").unwrap().unwrap().value, json(10));
+        assert!(remote.get(&branch, "k2").unwrap().is_none());
+    }
+
+    #[cfg(feature = "http-client")]
+    #[tokio::test(flavor = "multi_thread", worker_threads = 2)]
     async fn http_transport_detects_version_conflict() {
         use axum::{
             extract::State,
             routing::{get, post},
             Json, Router,
         };
+        use std::net::SocketAddr;
         use tokio::net::TcpListener;
         use tokio::task::JoinHandle;
 
@@ -905,11 +2584,12 @@ mod tests {
                 versions,
                 deleted,
                 deleted_versions,
+                cursor: None,
+                has_more: false,
             })
         }
 
         async fn serve(state: HttpState) -> (SocketAddr, JoinHandle<()>) {
-            use std::net::SocketAddr;
             let app = Router::new()
                 .route("/sync/apply", post(apply_handler))
                 .route("/sync/pull", get(pull_handler))
@@ -953,7 +2633,10 @@ mod tests {
                 }],
             },
         };
-        let result = client.apply_with_transport(&transport, &apply).unwrap();
+        let result = client
+            .apply_with_async_transport(&transport, &apply)
+            .await
+            .unwrap();
         assert_eq!(result.applied, 0);
         assert_eq!(result.conflicts.len(), 1);
         assert!(matches!(
@@ -971,7 +2654,10 @@ mod tests {
                 }],
             },
         };
-        let delete_result = client.apply_with_transport(&transport, &delete_missing).unwrap();
+        let delete_result = client
+            .apply_with_async_transport(&transport, &delete_missing)
+            .await
+            .unwrap();
         assert_eq!(delete_result.applied, 0);
         assert_eq!(delete_result.conflicts.len(), 1);
         assert!(matches!(
@@ -980,6 +2666,12 @@ mod tests {
         ));
 
         // pull should return current value and version
+        let pull = AsyncSyncTransport::pull_since(&transport, &branch, None, None)
+            .await
+            .unwrap();
+        assert_eq!(pull.batch.operations.len(), 1);
+
+        // the blocking API can be called from async code without nesting runtimes
         let pull = client.pull_with_transport(&transport, &branch).unwrap();
         assert_eq!(pull.batch.operations.len(), 1);
 
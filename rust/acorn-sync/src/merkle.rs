@@ -0,0 +1,381 @@
+//! Merkle anti-entropy.
+//!
+//! Each replica keeps a hash tree over its keys: keys are bucketed by the top bits of their
+//! hash into `FANOUT^depth` leaves, a leaf's hash is the XOR of its entries' hashes and an
+//! interior node's hash the XOR of its children's. Replicas compare trees top-down, one
+//! round trip per level, descending only into nodes whose hashes differ, then exchange the
+//! entries of the divergent leaves. A reconcile therefore costs `depth + 2` round trips
+//! and moves bytes in proportion to the divergence rather than to the branch size.
+//!
+//! Entry hashes are FNV-1a over the key's UTF-8 bytes XORed with the token, finished with
+//! the splitmix64 mixer; the .NET `MerkleTree` uses the same functions and layout. Tokens
+//! here are hashes of the stored value bytes, so replicas agree whenever their contents do,
+//! whatever version counters each side has reached.
+
+use std::collections::HashMap;
+
+use acorn_core::BranchId;
+
+use crate::{AsyncSyncTransport, SyncError};
+
+pub const FANOUT: usize = 16;
+pub const DEFAULT_DEPTH: u32 = 3;
+const BITS_PER_LEVEL: u32 = 4;
+const MAX_DEPTH: u32 = 6;
+
+/// Top of a replica's tree; equal roots end a reconcile after one round trip.
+#[derive(Debug, Clone, Copy, PartialEq, Eq, serde::Serialize, serde::Deserialize)]
+pub struct MerkleSummary {
+    pub depth: u32,
+    pub root: u64,
+    pub count: u64,
+}
+
+/// Child hashes of `nodes` at `level`, `FANOUT` per node in node order.
+#[derive(Debug, Clone, serde::Serialize, serde::Deserialize)]
+pub struct MerkleHashesRequest {
+    pub branch: BranchId,
+    pub level: u32,
+    pub nodes: Vec<u32>,
+}
+
+#[derive(Debug, Clone, PartialEq, Eq, serde::Serialize, serde::Deserialize)]
+pub struct MerkleHashesResponse {
+    pub hashes: Vec<u64>,
+}
+
+/// Key/token entries stored in `leaves`.
+#[derive(Debug, Clone, serde::Serialize, serde::Deserialize)]
+pub struct MerkleEntriesRequest {
+    pub branch: BranchId,
+    pub leaves: Vec<u32>,
+}
+
+#[derive(Debug, Clone, PartialEq, Eq, serde::Serialize, serde::Deserialize)]
+pub struct MerkleEntriesResponse {
+    pub entries: Vec<(String, u64)>,
+}
+
+/// Current values of `keys`; answered with a [`crate::SyncPullResponse`] that leaves out
+/// keys the server no longer has.
+#[derive(Debug, Clone, serde::Serialize, serde::Deserialize)]
+pub struct FetchRequest {
+    pub branch: BranchId,
+    pub keys: Vec<String>,
+}
+
+/// Keys whose contents differ between two replicas, and what finding them cost.
+#[derive(Debug, Clone, Default, PartialEq, Eq)]
+pub struct MerkleDiff {
+    /// Keys both sides hold with different contents.
+    pub divergent: Vec<String>,
+    pub remote_only: Vec<String>,
+    pub local_only: Vec<String>,
+    pub round_trips: usize,
+    pub hashes_compared: usize,
+    pub entries_compared: usize,
+}
+
+impl MerkleDiff {
+    pub fn in_sync(&self) -> bool {
+        self.divergent.is_empty() && self.remote_only.is_empty() && self.local_only.is_empty()
+    }
+}
+
+/// Hash tree over one branch's keys.
+#[derive(Debug, Clone)]
+pub struct MerkleTree {
+    depth: u32,
+    /// `levels[level][node]`; level 0 is the root, level `depth` the leaves.
+    levels: Vec<Vec<u64>>,
+    buckets: Vec<HashMap<String, u64>>,
+    count: usize,
+}
+
+impl Default for MerkleTree {
+    fn default() -> Self {
+        Self::new(DEFAULT_DEPTH)
+    }
+}
+
+impl MerkleTree {
+    /// # Panics
+    /// If `depth` is not in `1..=6`.
+    pub fn new(depth: u32) -> Self {
+        assert!(
+            (1..=MAX_DEPTH).contains(&depth),
+            "merkle depth must be between 1 and {MAX_DEPTH}"
+        );
+        let levels: Vec<Vec<u64>> = (0..=depth)
+            .map(|level| vec![0u64; 1 << (BITS_PER_LEVEL * level)])
+            .collect();
+        let buckets = vec![HashMap::new(); levels[depth as usize].len()];
+        MerkleTree {
+            depth,
+            levels,
+            buckets,
+            count: 0,
+        }
+    }
+
+    /// Tree over `(key, value bytes)` pairs.
+    pub fn from_values<'a, I>(values: I) -> Self
+    where
+        I: IntoIterator<Item = (String, &'a [u8])>,
+    {
+        let mut tree = Self::default();
+        for (key, value) in values {
+            tree.set(key, value_token(value));
+        }
+        tree
+    }
+
+    pub fn depth(&self) -> u32 {
+        self.depth
+    }
+
+    pub fn len(&self) -> usize {
+        self.count
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.count == 0
+    }
+
+    pub fn root(&self) -> u64 {
+        self.levels[0][0]
+    }
+
+    pub fn summary(&self) -> MerkleSummary {
+        MerkleSummary {
+            depth: self.depth,
+            root: self.root(),
+            count: self.count as u64,
+        }
+    }
+
+    pub fn leaf_of(&self, key: &str) -> u32 {
+        // FNV's high bits barely depend on a key's last bytes, so "item-1" and "item-2"
+        // would share a leaf without the mix.
+        (mix(fnv1a(key.as_bytes())) >> (64 - BITS_PER_LEVEL * self.depth)) as u32
+    }
+
+    /// Record the current token of `key`.
+    pub fn set(&mut self, key: String, token: u64) {
+        let leaf = self.leaf_of(&key);
+        let delta = match self.buckets[leaf as usize].get(&key) {
+            Some(&previous) if previous == token => return,
+            Some(&previous) => entry_hash(&key, previous) ^ entry_hash(&key, token),
+            None => {
+                self.count += 1;
+                entry_hash(&key, token)
+            }
+        };
+        self.buckets[leaf as usize].insert(key, token);
+        self.propagate(leaf, delta);
+    }
+
+    /// Forget `key`; its leaf hash returns to what it was before the key was set.
+    pub fn remove(&mut self, key: &str) {
+        let leaf = self.leaf_of(key);
+        if let Some(previous) = self.buckets[leaf as usize].remove(key) {
+            self.count -= 1;
+            self.propagate(leaf, entry_hash(key, previous));
+        }
+    }
+
+    fn propagate(&mut self, leaf: u32, delta: u64) {
+        let mut node = leaf as usize;
+        for level in (0..=self.depth as usize).rev() {
+            self.levels[level][node] ^= delta;
+            node /= FANOUT;
+        }
+    }
+
+    /// The `FANOUT` child hashes of each of `nodes` at `level`.
+    pub fn child_hashes(&self, level: u32, nodes: &[u32]) -> Result<Vec<u64>, SyncError> {
+        if level >= self.depth {
+            return Err(SyncError::Protocol(format!(
+                "merkle level {level} is not above the leaves (depth {})",
+                self.depth
+            )));
+        }
+        let children = &self.levels[level as usize + 1];
+        let mut hashes = Vec::with_capacity(nodes.len() * FANOUT);
+        for &node in nodes {
+            let first = node as usize * FANOUT;
+            let row = children.get(first..first + FANOUT).ok_or_else(|| {
+                SyncError::Protocol(format!("merkle node {node} out of range at level {level}"))
+            })?;
+            hashes.extend_from_slice(row);
+        }
+        Ok(hashes)
+    }
+
+    /// Entries stored in `leaves`.
+    pub fn entries(&self, leaves: &[u32]) -> Result<Vec<(String, u64)>, SyncError> {
+        let mut entries = Vec::new();
+        for &leaf in leaves {
+            let bucket = self
+                .buckets
+                .get(leaf as usize)
+                .ok_or_else(|| SyncError::Protocol(format!("merkle leaf {leaf} out of range")))?;
+            entries.extend(bucket.iter().map(|(key, token)| (key.clone(), *token)));
+        }
+        Ok(entries)
+    }
+}
+
+/// Walk `local` against the branch's tree behind `transport`, top-down.
+pub async fn diff<X: AsyncSyncTransport + ?Sized>(
+    local: &MerkleTree,
+    transport: &X,
+    branch: &BranchId,
+) -> Result<MerkleDiff, SyncError> {
+    let mut diff = MerkleDiff::default();
+
+    let summary = transport.merkle_summary(branch).await?;
+    diff.round_trips += 1;
+    if summary.depth != local.depth {
+        return Err(SyncError::Protocol(format!(
+            "merkle depth mismatch: local {}, remote {}",
+            local.depth, summary.depth
+        )));
+    }
+    diff.hashes_compared += 1;
+    if summary.root == local.root() {
+        return Ok(diff);
+    }
+
+    let mut divergent = vec![0u32];
+    for level in 0..local.depth {
+        if divergent.is_empty() {
+            break;
+        }
+        let request = MerkleHashesRequest {
+            branch: branch.clone(),
+            level,
+            nodes: divergent,
+        };
+        let remote = transport.merkle_hashes(&request).await?.hashes;
+        diff.round_trips += 1;
+        let local_hashes = local.child_hashes(level, &request.nodes)?;
+        if remote.len() != local_hashes.len() {
+            return Err(SyncError::Protocol(format!(
+                "peer returned {} hashes for {} nodes",
+                remote.len(),
+                request.nodes.len()
+            )));
+        }
+        diff.hashes_compared += local_hashes.len();
+        divergent = local_hashes
+            .iter()
+            .zip(&remote)
+            .enumerate()
+            .filter(|(_, (local, remote))| local != remote)
+            .map(|(i, _)| request.nodes[i / FANOUT] * FANOUT as u32 + (i % FANOUT) as u32)
+            .collect();
+    }
+
+    // Hashes can agree all the way down only if a write landed mid-walk.
+    if divergent.is_empty() {
+        return Ok(diff);
+    }
+
+    let request = MerkleEntriesRequest {
+        branch: branch.clone(),
+        leaves: divergent,
+    };
+    let remote: HashMap<String, u64> = transport
+        .merkle_entries(&request)
+        .await?
+        .entries
+        .into_iter()
+        .collect();
+    diff.round_trips += 1;
+    let local_entries = local.entries(&request.leaves)?;
+    diff.entries_compared = local_entries.len() + remote.len();
+
+    let mut seen = std::collections::HashSet::with_capacity(local_entries.len());
+    for (key, token) in local_entries {
+        match remote.get(&key) {
+            None => diff.local_only.push(key.clone()),
+            Some(remote_token) if *remote_token != token => diff.divergent.push(key.clone()),
+            Some(_) => {}
+        }
+        seen.insert(key);
+    }
+    diff.remote_only
+        .extend(remote.into_keys().filter(|key| !seen.contains(key)));
+    Ok(diff)
+}
+
+/// Hash of one `(key, token)` entry.
+pub fn entry_hash(key: &str, token: u64) -> u64 {
+    mix(fnv1a(key.as_bytes()) ^ mix(token))
+}
+
+/// Token of a stored value: a hash of its bytes.
+pub fn value_token(value: &[u8]) -> u64 {
+    mix(fnv1a(value))
+}
+
+fn fnv1a(bytes: &[u8]) -> u64 {
+    bytes.iter().fold(0xcbf2_9ce4_8422_2325, |hash, &b| {
+        (hash ^ b as u64).wrapping_mul(0x0000_0100_0000_01b3)
+    })
+}
+
+/// splitmix64 finalizer: every input bit affects every output bit.
+fn mix(mut z: u64) -> u64 {
+    z = (z ^ (z >> 30)).wrapping_mul(0xbf58_476d_1ce4_e5b9);
+    z = (z ^ (z >> 27)).wrapping_mul(0x94d0_49bb_1331_11eb);
+    z ^ (z >> 31)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn hashes_match_vectors_shared_with_dotnet() {
+        // The same values are asserted by AntiEntropyTests in AcornDB.Test
+        assert_eq!(entry_hash("user-1", 42), 0xc7ea_af7e_73c5_935a);
+        let mut tree = MerkleTree::default();
+        tree.set("user-1".into(), 42);
+        tree.set("user-2".into(), 7);
+        assert_eq!(tree.root(), 0x173d_7c88_ab8a_345e);
+        assert_eq!(tree.leaf_of("user-1"), 3145);
+    }
+
+    #[test]
+    fn root_depends_on_contents_not_write_order() {
+        let mut forward = MerkleTree::default();
+        let mut backward = MerkleTree::default();
+        for i in 0..500u64 {
+            forward.set(format!("k{i}"), i);
+        }
+        for i in (0..500u64).rev() {
+            backward.set(format!("k{i}"), i);
+        }
+        assert_eq!(forward.root(), backward.root());
+        assert_eq!(forward.len(), 500);
+
+        let before = forward.root();
+        forward.set("extra".into(), 1);
+        forward.set("extra".into(), 2);
+        assert_ne!(forward.root(), before);
+        forward.remove("extra");
+        assert_eq!(forward.root(), before);
+        assert_eq!(forward.len(), 500);
+    }
+
+    #[test]
+    fn rejects_out_of_range_requests() {
+        let tree = MerkleTree::new(2);
+        assert_eq!(tree.child_hashes(1, &[15]).unwrap().len(), FANOUT);
+        assert!(tree.child_hashes(1, &[16]).is_err());
+        assert!(tree.child_hashes(2, &[0]).is_err());
+        assert!(tree.entries(&[256]).is_err());
+    }
+}
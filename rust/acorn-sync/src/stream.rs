@@ -0,0 +1,472 @@
+//! Resumable delta streaming over `/sync/stream`.
+//!
+//! The server walks the same per-branch change feed as cursor-based pulls and pushes one
+//! [`StreamFrame`] per page. Values travel inline up to `inline_limit` bytes; larger values
+//! are announced with `value: None` and fetched with a pull. Every frame carries the cursor
+//! after its changes, so a client that disconnects reconnects with `since=<cursor>` and
+//! misses nothing. Slow clients are never dropped: the server only reads the next page once
+//! the previous frame has been written to the socket, and changes made in the meantime are
+//! coalesced into that page.
+//!
+//! Query parameters:
+//!
+//! ```text
+//! /sync/stream?branch=<id>[&since=<seq>&epoch=<epoch>][&inline_limit=<bytes>][&limit=<keys>][&format=json|binary|zstd]
+//! ```
+//!
+//! Without `since` the stream starts at the current head and only carries new changes.
+
+use std::collections::VecDeque;
+use std::time::Duration;
+
+use acorn_core::{AcornError, AcornResult, BranchId};
+use futures::future::BoxFuture;
+
+use crate::{SyncCursor, SyncError, SyncEvent, WireFormat};
+
+/// One page of changes pushed by the server. A frame with no changes is a heartbeat.
+#[derive(Debug, Clone, PartialEq, Eq, serde::Serialize, serde::Deserialize)]
+pub struct StreamFrame {
+    pub branch: BranchId,
+    /// Cursor after the last change in this frame.
+    pub cursor: SyncCursor,
+    pub changes: Vec<StreamChange>,
+    /// More changes are already queued behind this frame.
+    pub has_more: bool,
+    /// The requested cursor belonged to another server epoch; this frame starts a full
+    /// snapshot of the branch.
+    #[serde(default)]
+    pub reset: bool,
+}
+
+/// Latest state of one key. `value` is `None` for deletes and for values above the inline
+/// limit.
+#[derive(Debug, Clone, PartialEq, Eq, serde::Serialize, serde::Deserialize)]
+pub struct StreamChange {
+    pub key: String,
+    pub version: Option<u64>,
+    pub deleted: bool,
+    pub value: Option<Vec<u8>>,
+}
+
+#[derive(Debug, Clone)]
+pub struct StreamOptions {
+    /// Largest value sent inline.
+    pub inline_limit: usize,
+    /// Most keys per frame.
+    pub page_limit: usize,
+    /// Consecutive failed connection attempts before `next_event` gives up.
+    pub max_reconnects: usize,
+    /// Delay before each reconnect attempt, multiplied by the attempt number.
+    pub reconnect_backoff: Duration,
+    pub format: WireFormat,
+}
+
+impl Default for StreamOptions {
+    fn default() -> Self {
+        StreamOptions {
+            inline_limit: 64 * 1024,
+            page_limit: 256,
+            max_reconnects: 5,
+            reconnect_backoff: Duration::from_millis(200),
+            format: WireFormat::Binary,
+        }
+    }
+}
+
+/// Connection that yields stream frames; `connect` may be called again after a failure.
+pub trait StreamSource: Send {
+    fn connect<'a>(
+        &'a mut self,
+        branch: &'a BranchId,
+        since: Option<&'a SyncCursor>,
+        options: &'a StreamOptions,
+    ) -> BoxFuture<'a, Result<(), SyncError>>;
+
+    /// Next frame, or `None` once the server has closed the connection.
+    fn next_frame(&mut self) -> BoxFuture<'_, Result<Option<StreamFrame>, SyncError>>;
+}
+
+/// Client side of a delta stream. Tracks the cursor of every frame it has handed out and
+/// resumes from it when the connection drops.
+pub struct Subscription<S> {
+    source: S,
+    branch: BranchId,
+    options: StreamOptions,
+    cursor: Option<SyncCursor>,
+    frame_cursor: Option<SyncCursor>,
+    pending: VecDeque<SyncEvent>,
+    connected: bool,
+    closed: bool,
+}
+
+impl<S: StreamSource> Subscription<S> {
+    /// Stream `branch` from `since`, or from the server's current head when `None`.
+    pub fn new(source: S, branch: BranchId, since: Option<SyncCursor>, options: StreamOptions) -> Self {
+        Subscription {
+            source,
+            branch,
+            options,
+            cursor: since,
+            frame_cursor: None,
+            pending: VecDeque::new(),
+            connected: false,
+            closed: false,
+        }
+    }
+
+    /// Cursor covering every event returned so far; persist it to resume in a new process.
+    pub fn cursor(&self) -> Option<SyncCursor> {
+        self.cursor
+    }
+
+    /// Stop the subscription; later calls to `next_event` return `None`.
+    pub fn close(&mut self) {
+        self.closed = true;
+        self.pending.clear();
+    }
+
+    pub async fn next_event(&mut self) -> AcornResult<Option<SyncEvent>> {
+        loop {
+            if self.closed {
+                return Ok(None);
+            }
+            if let Some(event) = self.pending.pop_front() {
+                if self.pending.is_empty() {
+                    if let Some(cursor) = self.frame_cursor.take() {
+                        self.cursor = Some(cursor);
+                    }
+                }
+                return Ok(Some(event));
+            }
+            if !self.connected {
+                self.reconnect().await?;
+            }
+            match self.source.next_frame().await {
+                Ok(Some(frame)) => self.accept(frame),
+                // The server went away; resume from the cursor on the next pass.
+                Ok(None) | Err(_) => self.connected = false,
+            }
+        }
+    }
+
+    async fn reconnect(&mut self) -> AcornResult<()> {
+        let mut last_error = None;
+        for attempt in 0..=self.options.max_reconnects {
+            if attempt > 0 {
+                #[cfg(feature = "std")]
+                tokio::time::sleep(self.options.reconnect_backoff * attempt as u32).await;
+            }
+            match self
+                .source
+                .connect(&self.branch, self.cursor.as_ref(), &self.options)
+                .await
+            {
+                Ok(()) => {
+                    self.connected = true;
+                    return Ok(());
+                }
+                Err(e) => last_error = Some(e),
+            }
+        }
+        Err(AcornError::Trunk(format!("sync stream failed: {:?}", last_error)))
+    }
+
+    fn accept(&mut self, frame: StreamFrame) {
+        if frame.reset {
+            self.pending.push_back(SyncEvent::Resync);
+        }
+        if frame.changes.is_empty() && !frame.reset {
+            self.pending.push_back(SyncEvent::Heartbeat);
+        }
+        for change in frame.changes {
+            self.pending.push_back(if change.deleted {
+                SyncEvent::Deleted {
+                    key: change.key,
+                    version: change.version,
+                }
+            } else {
+                SyncEvent::Applied {
+                    key: change.key,
+                    version: change.version,
+                    value: change.value,
+                }
+            });
+        }
+        self.frame_cursor = Some(frame.cursor);
+    }
+}
+
+#[cfg(feature = "websocket")]
+pub use ws::WebSocketSource;
+
+#[cfg(feature = "websocket")]
+mod ws {
+    use futures::{SinkExt, StreamExt};
+    use tokio_tungstenite::tungstenite::Message;
+    use tokio_tungstenite::{connect_async, MaybeTlsStream, WebSocketStream};
+
+    use super::*;
+    use crate::SyncEndpoint;
+
+    type Socket = WebSocketStream<MaybeTlsStream<tokio::net::TcpStream>>;
+
+    /// WebSocket connection to an acorn sync server. `base_url` may use `http(s)://` or
+    /// `ws(s)://`.
+    pub struct WebSocketSource {
+        base_url: String,
+        socket: Option<Socket>,
+    }
+
+    impl WebSocketSource {
+        pub fn new<T: Into<String>>(base_url: T) -> Self {
+            let base_url = base_url.into();
+            let base_url = if let Some(rest) = base_url.strip_prefix("http://") {
+                format!("ws://{rest}")
+            } else if let Some(rest) = base_url.strip_prefix("https://") {
+                format!("wss://{rest}")
+            } else {
+                base_url
+            };
+            WebSocketSource {
+                base_url,
+                socket: None,
+            }
+        }
+
+        fn url(&self, branch: &BranchId, since: Option<&SyncCursor>, options: &StreamOptions) -> String {
+            let format = match options.format {
+                WireFormat::Json => "json",
+                WireFormat::Binary => "binary",
+                WireFormat::BinaryZstd => "zstd",
+            };
+            let mut url = format!(
+                "{}/sync/stream?branch={}&inline_limit={}&limit={}&format={}",
+                self.base_url,
+                encode_component(branch.as_str()),
+                options.inline_limit,
+                options.page_limit,
+                format
+            );
+            if let Some(cursor) = since {
+                url.push_str(&format!("&since={}&epoch={}", cursor.seq, cursor.epoch));
+            }
+            url
+        }
+    }
+
+    impl Subscription<WebSocketSource> {
+        /// Subscribe to `endpoint.branch`; the connection opens on the first `next_event`.
+        pub fn subscribe(endpoint: &SyncEndpoint, since: Option<SyncCursor>, options: StreamOptions) -> Self {
+            Subscription::new(
+                WebSocketSource::new(endpoint.url.clone()),
+                endpoint.branch.clone(),
+                since,
+                options,
+            )
+        }
+    }
+
+    impl StreamSource for WebSocketSource {
+        fn connect<'a>(
+            &'a mut self,
+            branch: &'a BranchId,
+            since: Option<&'a SyncCursor>,
+            options: &'a StreamOptions,
+        ) -> BoxFuture<'a, Result<(), SyncError>> {
+            Box::pin(async move {
+                if let Some(mut old) = self.socket.take() {
+                    let _ = old.close(None).await;
+                }
+                let (socket, _) = connect_async(self.url(branch, since, options))
+                    .await
+                    .map_err(|e| SyncError::Network(e.to_string()))?;
+                self.socket = Some(socket);
+                Ok(())
+            })
+        }
+
+        fn next_frame(&mut self) -> BoxFuture<'_, Result<Option<StreamFrame>, SyncError>> {
+            Box::pin(async move {
+                let socket = match self.socket.as_mut() {
+                    Some(socket) => socket,
+                    None => return Ok(None),
+                };
+                loop {
+                    match socket.next().await {
+                        Some(Ok(Message::Binary(bytes))) => {
+                            return WireFormat::Binary.decode(&bytes).map(Some)
+                        }
+                        Some(Ok(Message::Text(text))) => {
+                            return WireFormat::Json.decode(text.as_str().as_bytes()).map(Some)
+                        }
+                        Some(Ok(Message::Close(_))) | None => {
+                            self.socket = None;
+                            return Ok(None);
+                        }
+                        Some(Ok(_)) => continue,
+                        Some(Err(e)) => {
+                            self.socket = None;
+                            return Err(SyncError::Network(e.to_string()));
+                        }
+                    }
+                }
+            })
+        }
+    }
+
+    fn encode_component(value: &str) -> String {
+        let mut out = String::with_capacity(value.len());
+        for byte in value.bytes() {
+            match byte {
+                b'A'..=b'Z' | b'a'..=b'z' | b'0'..=b'9' | b'-' | b'_' | b'.' | b'~' => out.push(byte as char),
+                _ => out.push_str(&format!("%{byte:02X}")),
+            }
+        }
+        out
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::sync::{Arc, Mutex};
+
+    /// Replays scripted frames, one script per connection, recording each connect cursor.
+    struct ScriptedSource {
+        connections: VecDeque<Vec<Result<StreamFrame, SyncError>>>,
+        current: VecDeque<Result<StreamFrame, SyncError>>,
+        connects: Arc<Mutex<Vec<Option<SyncCursor>>>>,
+    }
+
+    impl StreamSource for ScriptedSource {
+        fn connect<'a>(
+            &'a mut self,
+            _branch: &'a BranchId,
+            since: Option<&'a SyncCursor>,
+            _options: &'a StreamOptions,
+        ) -> BoxFuture<'a, Result<(), SyncError>> {
+            self.connects.lock().unwrap().push(since.copied());
+            let result = match self.connections.pop_front() {
+                Some(script) => {
+                    self.current = script.into();
+                    Ok(())
+                }
+                None => Err(SyncError::Network("refused".into())),
+            };
+            Box::pin(futures::future::ready(result))
+        }
+
+        fn next_frame(&mut self) -> BoxFuture<'_, Result<Option<StreamFrame>, SyncError>> {
+            let next = self.current.pop_front().transpose();
+            Box::pin(futures::future::ready(next))
+        }
+    }
+
+    fn frame(seq: u64, changes: Vec<StreamChange>, reset: bool) -> StreamFrame {
+        StreamFrame {
+            branch: BranchId::new("main"),
+            cursor: SyncCursor { epoch: 1, seq },
+            changes,
+            has_more: false,
+            reset,
+        }
+    }
+
+    fn put(key: &str, value: Option<&[u8]>) -> StreamChange {
+        StreamChange {
+            key: key.into(),
+            version: Some(1),
+            deleted: false,
+            value: value.map(<[u8]>::to_vec),
+        }
+    }
+
+    fn options() -> StreamOptions {
+        StreamOptions {
+            max_reconnects: 1,
+            reconnect_backoff: Duration::ZERO,
+            ..StreamOptions::default()
+        }
+    }
+
+    #[tokio::test]
+    async fn resumes_from_last_delivered_cursor() {
+        let connects = Arc::new(Mutex::new(Vec::new()));
+        let source = ScriptedSource {
+            connections: VecDeque::from(vec![
+                vec![
+                    Ok(frame(2, vec![put("a", Some(b"1")), put("big", None)], false)),
+                    Err(SyncError::Network("reset by peer".into())),
+                ],
+                vec![Ok(frame(
+                    3,
+                    vec![StreamChange {
+                        key: "a".into(),
+                        version: Some(2),
+                        deleted: true,
+                        value: None,
+                    }],
+                    false,
+                ))],
+            ]),
+            current: VecDeque::new(),
+            connects: connects.clone(),
+        };
+        let mut sub = Subscription::new(source, BranchId::new("main"), None, options());
+
+        match sub.next_event().await.unwrap() {
+            Some(SyncEvent::Applied { key, value, .. }) => {
+                assert_eq!(key, "a");
+                assert_eq!(value, Some(b"1".to_vec()));
+            }
+            other => panic!("unexpected {other:?}"),
+        }
+        // The cursor only advances once the whole frame has been handed out.
+        assert_eq!(sub.cursor(), None);
+        assert!(matches!(
+            sub.next_event().await.unwrap(),
+            Some(SyncEvent::Applied { value: None, .. })
+        ));
+        assert_eq!(sub.cursor(), Some(SyncCursor { epoch: 1, seq: 2 }));
+
+        assert!(matches!(
+            sub.next_event().await.unwrap(),
+            Some(SyncEvent::Deleted { version: Some(2), .. })
+        ));
+        assert_eq!(
+            *connects.lock().unwrap(),
+            vec![None, Some(SyncCursor { epoch: 1, seq: 2 })]
+        );
+        assert_eq!(sub.cursor(), Some(SyncCursor { epoch: 1, seq: 3 }));
+
+        // Both reconnect attempts are refused.
+        assert!(sub.next_event().await.is_err());
+        sub.close();
+        assert!(sub.next_event().await.unwrap().is_none());
+    }
+
+    #[tokio::test]
+    async fn surfaces_heartbeats_and_resets() {
+        let source = ScriptedSource {
+            connections: VecDeque::from(vec![vec![
+                Ok(frame(0, Vec::new(), false)),
+                Ok(frame(1, vec![put("a", Some(b"x"))], true)),
+            ]]),
+            current: VecDeque::new(),
+            connects: Arc::default(),
+        };
+        let stale = SyncCursor { epoch: 9, seq: 40 };
+        let mut sub = Subscription::new(source, BranchId::new("main"), Some(stale), options());
+        assert!(matches!(
+            sub.next_event().await.unwrap(),
+            Some(SyncEvent::Heartbeat)
+        ));
+        assert!(matches!(sub.next_event().await.unwrap(), Some(SyncEvent::Resync)));
+        assert!(matches!(
+            sub.next_event().await.unwrap(),
+            Some(SyncEvent::Applied { .. })
+        ));
+        assert_eq!(sub.cursor(), Some(SyncCursor { epoch: 1, seq: 1 }));
+    }
+}
@@ -0,0 +1,892 @@
+//! Wire formats for sync payloads.
+//!
+//! JSON stays the default so contract tests in other languages keep working. The binary
+//! format is a length-prefixed frame carrying varint-encoded fields, so values travel as raw
+//! bytes instead of JSON number arrays. Frames can be zstd-compressed per batch when the
+//! `zstd` feature is enabled.
+//!
+//! Frame layout:
+//!
+//! ```text
+//! [magic "ACS1"][kind: u8][flags: u8][body_len: u32 LE][body]
+//! body (FLAG_ZSTD) = [raw_len: varint][zstd(raw body)]
+//! ```
+//!
+//! Strings and byte strings are `[len: varint][bytes]`, options are a `0`/`1` tag followed by
+//! the value, and sequences are `[count: varint][items]`. Hashes are uniformly random, so they
+//! travel as fixed 8-byte little-endian words rather than varints.
+
+use acorn_core::BranchId;
+
+use crate::{
+    FetchRequest, MerkleEntriesRequest, MerkleEntriesResponse, MerkleHashesRequest, MerkleHashesResponse,
+    MerkleSummary, StreamChange, StreamFrame, SyncApplyRequest, SyncApplyResponse, SyncBatch, SyncConflict,
+    SyncConflictKind, SyncCursor, SyncError, SyncMutation, SyncPullResponse,
+};
+
+pub const JSON_CONTENT_TYPE: &str = "application/json";
+pub const BINARY_CONTENT_TYPE: &str = "application/x-acorn-sync";
+/// `Accept` value asking for zstd-compressed binary frames.
+pub const BINARY_ZSTD_ACCEPT: &str = "application/x-acorn-sync; compression=zstd";
+
+const MAGIC: &[u8; 4] = b"ACS1";
+const HEADER_LEN: usize = 10;
+const FLAG_ZSTD: u8 = 0x01;
+/// Bodies smaller than this are sent uncompressed even when zstd is requested.
+const COMPRESS_MIN_BYTES: usize = 512;
+/// Refuse to inflate frames beyond this size.
+#[cfg(feature = "zstd")]
+const MAX_DECODED_BYTES: u64 = 256 * 1024 * 1024;
+#[cfg(feature = "zstd")]
+const ZSTD_LEVEL: i32 = 3;
+
+/// Encoding used for a sync request or response body.
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub enum WireFormat {
+    #[default]
+    Json,
+    Binary,
+    BinaryZstd,
+}
+
+impl WireFormat {
+    pub fn content_type(&self) -> &'static str {
+        match self {
+            WireFormat::Json => JSON_CONTENT_TYPE,
+            WireFormat::Binary | WireFormat::BinaryZstd => BINARY_CONTENT_TYPE,
+        }
+    }
+
+    /// Value for the `Accept` header when asking for this format.
+    pub fn accept(&self) -> &'static str {
+        match self {
+            WireFormat::Json => JSON_CONTENT_TYPE,
+            WireFormat::Binary => BINARY_CONTENT_TYPE,
+            WireFormat::BinaryZstd => BINARY_ZSTD_ACCEPT,
+        }
+    }
+
+    /// Format of a body with the given `Content-Type`. Compression is carried inside the
+    /// frame, so both binary variants decode the same way.
+    pub fn from_content_type(content_type: Option<&str>) -> Self {
+        match content_type {
+            Some(value) if media_type(value) == BINARY_CONTENT_TYPE => WireFormat::Binary,
+            _ => WireFormat::Json,
+        }
+    }
+
+    /// Pick a response format from an `Accept` header; anything unrecognised gets JSON.
+    pub fn negotiate(accept: Option<&str>) -> Self {
+        let Some(accept) = accept else {
+            return WireFormat::Json;
+        };
+        for range in accept.split(',') {
+            if media_type(range) == BINARY_CONTENT_TYPE {
+                let zstd = range
+                    .split(';')
+                    .skip(1)
+                    .any(|param| param.trim().eq_ignore_ascii_case("compression=zstd"));
+                return if zstd && cfg!(feature = "zstd") {
+                    WireFormat::BinaryZstd
+                } else {
+                    WireFormat::Binary
+                };
+            }
+        }
+        WireFormat::Json
+    }
+
+    pub fn encode<M: WireMessage>(&self, message: &M) -> Result<Vec<u8>, SyncError> {
+        match self {
+            WireFormat::Json => serde_json::to_vec(message).map_err(|e| SyncError::Protocol(e.to_string())),
+            WireFormat::Binary => Ok(encode_frame(message, false)),
+            WireFormat::BinaryZstd => Ok(encode_frame(message, true)),
+        }
+    }
+
+    pub fn decode<M: WireMessage>(&self, bytes: &[u8]) -> Result<M, SyncError> {
+        match self {
+            WireFormat::Json => serde_json::from_slice(bytes).map_err(|e| SyncError::Protocol(e.to_string())),
+            WireFormat::Binary | WireFormat::BinaryZstd => decode_frame(bytes),
+        }
+    }
+}
+
+fn media_type(value: &str) -> &str {
+    value.split(';').next().unwrap_or("").trim()
+}
+
+/// Sync payloads that have a binary frame encoding.
+pub trait WireMessage: serde::Serialize + serde::de::DeserializeOwned + Sized {
+    const KIND: u8;
+    fn encode_body(&self, out: &mut Vec<u8>);
+    fn decode_body(reader: &mut Reader<'_>) -> Result<Self, SyncError>;
+}
+
+fn encode_frame<M: WireMessage>(message: &M, compress: bool) -> Vec<u8> {
+    let mut frame = Vec::with_capacity(256);
+    frame.extend_from_slice(MAGIC);
+    frame.push(M::KIND);
+    frame.push(0);
+    frame.extend_from_slice(&[0u8; 4]);
+    message.encode_body(&mut frame);
+
+    if compress && frame.len() - HEADER_LEN >= COMPRESS_MIN_BYTES {
+        if let Some(packed) = compress_body(&frame[HEADER_LEN..]) {
+            frame.truncate(HEADER_LEN);
+            frame[5] = FLAG_ZSTD;
+            frame.extend_from_slice(&packed);
+        }
+    }
+    let body_len = (frame.len() - HEADER_LEN) as u32;
+    frame[6..HEADER_LEN].copy_from_slice(&body_len.to_le_bytes());
+    frame
+}
+
+fn decode_frame<M: WireMessage>(bytes: &[u8]) -> Result<M, SyncError> {
+    if bytes.len() < HEADER_LEN || &bytes[..4] != MAGIC {
+        return Err(protocol("not a sync frame"));
+    }
+    if bytes[4] != M::KIND {
+        return Err(protocol(format!("unexpected frame kind {}", bytes[4])));
+    }
+    let flags = bytes[5];
+    let body_len = u32::from_le_bytes(bytes[6..HEADER_LEN].try_into().unwrap()) as usize;
+    let body = &bytes[HEADER_LEN..];
+    if body.len() != body_len {
+        return Err(protocol("frame length mismatch"));
+    }
+    let inflated;
+    let body = if flags & FLAG_ZSTD != 0 {
+        inflated = decompress_body(body)?;
+        &inflated[..]
+    } else {
+        body
+    };
+    let mut reader = Reader::new(body);
+    let message = M::decode_body(&mut reader)?;
+    if !reader.is_empty() {
+        return Err(protocol("trailing bytes after frame body"));
+    }
+    Ok(message)
+}
+
+#[cfg(feature = "zstd")]
+fn compress_body(raw: &[u8]) -> Option<Vec<u8>> {
+    let packed = zstd::bulk::compress(raw, ZSTD_LEVEL).ok()?;
+    let mut out = Vec::with_capacity(packed.len() + 5);
+    put_varint(&mut out, raw.len() as u64);
+    out.extend_from_slice(&packed);
+    // Incompressible payloads go out raw.
+    (out.len() < raw.len()).then_some(out)
+}
+
+#[cfg(not(feature = "zstd"))]
+fn compress_body(_raw: &[u8]) -> Option<Vec<u8>> {
+    None
+}
+
+#[cfg(feature = "zstd")]
+fn decompress_body(body: &[u8]) -> Result<Vec<u8>, SyncError> {
+    let mut reader = Reader::new(body);
+    let raw_len = reader.varint()?;
+    if raw_len > MAX_DECODED_BYTES {
+        return Err(protocol("compressed frame too large"));
+    }
+    let raw = zstd::bulk::decompress(reader.rest(), raw_len as usize).map_err(|e| protocol(e.to_string()))?;
+    if raw.len() as u64 != raw_len {
+        return Err(protocol("compressed frame length mismatch"));
+    }
+    Ok(raw)
+}
+
+#[cfg(not(feature = "zstd"))]
+fn decompress_body(_body: &[u8]) -> Result<Vec<u8>, SyncError> {
+    Err(protocol(
+        "zstd-compressed frame received but the zstd feature is disabled",
+    ))
+}
+
+fn protocol<S: Into<String>>(message: S) -> SyncError {
+    SyncError::Protocol(message.into())
+}
+
+fn put_varint(out: &mut Vec<u8>, mut value: u64) {
+    while value >= 0x80 {
+        out.push((value as u8) | 0x80);
+        value >>= 7;
+    }
+    out.push(value as u8);
+}
+
+fn put_bytes(out: &mut Vec<u8>, bytes: &[u8]) {
+    put_varint(out, bytes.len() as u64);
+    out.extend_from_slice(bytes);
+}
+
+fn put_fixed_u64(out: &mut Vec<u8>, value: u64) {
+    out.extend_from_slice(&value.to_le_bytes());
+}
+
+fn put_opt_u64(out: &mut Vec<u8>, value: Option<u64>) {
+    match value {
+        Some(v) => {
+            out.push(1);
+            put_varint(out, v);
+        }
+        None => out.push(0),
+    }
+}
+
+fn put_opt_bytes(out: &mut Vec<u8>, value: Option<&[u8]>) {
+    match value {
+        Some(v) => {
+            out.push(1);
+            put_bytes(out, v);
+        }
+        None => out.push(0),
+    }
+}
+
+/// Cursor over a frame body.
+pub struct Reader<'a> {
+    buf: &'a [u8],
+}
+
+impl<'a> Reader<'a> {
+    fn new(buf: &'a [u8]) -> Self {
+        Reader { buf }
+    }
+
+    fn is_empty(&self) -> bool {
+        self.buf.is_empty()
+    }
+
+    fn rest(&self) -> &'a [u8] {
+        self.buf
+    }
+
+    fn u8(&mut self) -> Result<u8, SyncError> {
+        let (first, rest) = self
+            .buf
+            .split_first()
+            .ok_or_else(|| protocol("truncated frame"))?;
+        self.buf = rest;
+        Ok(*first)
+    }
+
+    fn fixed_u64(&mut self) -> Result<u64, SyncError> {
+        if self.buf.len() < 8 {
+            return Err(protocol("truncated frame"));
+        }
+        let (head, rest) = self.buf.split_at(8);
+        self.buf = rest;
+        Ok(u64::from_le_bytes(head.try_into().unwrap()))
+    }
+
+    fn varint(&mut self) -> Result<u64, SyncError> {
+        let mut value = 0u64;
+        for shift in (0..64).step_by(7) {
+            let byte = self.u8()?;
+            value |= ((byte & 0x7f) as u64) << shift;
+            if byte & 0x80 == 0 {
+                return Ok(value);
+            }
+        }
+        Err(protocol("varint overflow"))
+    }
+
+    /// Sequence length, bounded by the bytes left so a corrupt count cannot over-allocate.
+    fn len(&mut self) -> Result<usize, SyncError> {
+        let len = self.varint()?;
+        if len > self.buf.len() as u64 {
+            return Err(protocol("length exceeds frame"));
+        }
+        Ok(len as usize)
+    }
+
+    fn bytes(&mut self) -> Result<&'a [u8], SyncError> {
+        let len = self.len()?;
+        let (head, rest) = self.buf.split_at(len);
+        self.buf = rest;
+        Ok(head)
+    }
+
+    fn string(&mut self) -> Result<String, SyncError> {
+        std::str::from_utf8(self.bytes()?)
+            .map(str::to_string)
+            .map_err(|_| protocol("invalid utf-8 string"))
+    }
+
+    fn bool(&mut self) -> Result<bool, SyncError> {
+        match self.u8()? {
+            0 => Ok(false),
+            1 => Ok(true),
+            other => Err(protocol(format!("invalid tag {other}"))),
+        }
+    }
+
+    fn opt_u64(&mut self) -> Result<Option<u64>, SyncError> {
+        Ok(if self.bool()? { Some(self.varint()?) } else { None })
+    }
+
+    fn opt_bytes(&mut self) -> Result<Option<Vec<u8>>, SyncError> {
+        Ok(if self.bool()? {
+            Some(self.bytes()?.to_vec())
+        } else {
+            None
+        })
+    }
+}
+
+fn encode_batch(batch: &SyncBatch, out: &mut Vec<u8>) {
+    put_bytes(out, batch.branch.as_str().as_bytes());
+    put_varint(out, batch.operations.len() as u64);
+    for op in &batch.operations {
+        match op {
+            SyncMutation::Put { key, value, version } => {
+                out.push(0);
+                put_bytes(out, key.as_bytes());
+                put_bytes(out, value);
+                put_opt_u64(out, *version);
+            }
+            SyncMutation::Delete { key, version } => {
+                out.push(1);
+                put_bytes(out, key.as_bytes());
+                put_opt_u64(out, *version);
+            }
+        }
+    }
+}
+
+fn decode_batch(reader: &mut Reader<'_>) -> Result<SyncBatch, SyncError> {
+    let branch = BranchId::new(reader.string()?);
+    let count = reader.len()?;
+    let mut operations = Vec::with_capacity(count);
+    for _ in 0..count {
+        let op = match reader.u8()? {
+            0 => SyncMutation::Put {
+                key: reader.string()?,
+                value: reader.bytes()?.to_vec(),
+                version: reader.opt_u64()?,
+            },
+            1 => SyncMutation::Delete {
+                key: reader.string()?,
+                version: reader.opt_u64()?,
+            },
+            other => return Err(protocol(format!("unknown mutation tag {other}"))),
+        };
+        operations.push(op);
+    }
+    Ok(SyncBatch { branch, operations })
+}
+
+impl WireMessage for SyncApplyRequest {
+    const KIND: u8 = 1;
+
+    fn encode_body(&self, out: &mut Vec<u8>) {
+        encode_batch(&self.batch, out);
+    }
+
+    fn decode_body(reader: &mut Reader<'_>) -> Result<Self, SyncError> {
+        Ok(SyncApplyRequest {
+            batch: decode_batch(reader)?,
+        })
+    }
+}
+
+impl WireMessage for SyncApplyResponse {
+    const KIND: u8 = 2;
+
+    fn encode_body(&self, out: &mut Vec<u8>) {
+        put_varint(out, self.applied as u64);
+        put_varint(out, self.conflicts.len() as u64);
+        for conflict in &self.conflicts {
+            put_bytes(out, conflict.key.as_bytes());
+            put_opt_bytes(out, conflict.remote_value.as_deref());
+            put_opt_bytes(out, conflict.local_value.as_deref());
+            put_opt_u64(out, conflict.remote_version);
+            put_opt_u64(out, conflict.local_version);
+            out.push(match conflict.kind {
+                SyncConflictKind::VersionMismatch => 0,
+                SyncConflictKind::MissingKey => 1,
+                SyncConflictKind::Unknown => 2,
+            });
+        }
+    }
+
+    fn decode_body(reader: &mut Reader<'_>) -> Result<Self, SyncError> {
+        let applied = reader.varint()? as usize;
+        let count = reader.len()?;
+        let mut conflicts = Vec::with_capacity(count);
+        for _ in 0..count {
+            conflicts.push(SyncConflict {
+                key: reader.string()?,
+                remote_value: reader.opt_bytes()?,
+                local_value: reader.opt_bytes()?,
+                remote_version: reader.opt_u64()?,
+                local_version: reader.opt_u64()?,
+                kind: match reader.u8()? {
+                    0 => SyncConflictKind::VersionMismatch,
+                    1 => SyncConflictKind::MissingKey,
+                    _ => SyncConflictKind::Unknown,
+                },
+            });
+        }
+        Ok(SyncApplyResponse { applied, conflicts })
+    }
+}
+
+impl WireMessage for SyncPullResponse {
+    const KIND: u8 = 3;
+
+    fn encode_body(&self, out: &mut Vec<u8>) {
+        encode_batch(&self.batch, out);
+        put_varint(out, self.versions.len() as u64);
+        for (key, version) in &self.versions {
+            put_bytes(out, key.as_bytes());
+            put_varint(out, *version);
+        }
+        put_varint(out, self.deleted.len() as u64);
+        for key in &self.deleted {
+            put_bytes(out, key.as_bytes());
+        }
+        put_varint(out, self.deleted_versions.len() as u64);
+        for (key, version) in &self.deleted_versions {
+            put_bytes(out, key.as_bytes());
+            put_opt_u64(out, *version);
+        }
+        match &self.cursor {
+            Some(cursor) => {
+                out.push(1);
+                put_varint(out, cursor.epoch);
+                put_varint(out, cursor.seq);
+            }
+            None => out.push(0),
+        }
+        out.push(self.has_more as u8);
+    }
+
+    fn decode_body(reader: &mut Reader<'_>) -> Result<Self, SyncError> {
+        let batch = decode_batch(reader)?;
+        let count = reader.len()?;
+        let mut versions = Vec::with_capacity(count);
+        for _ in 0..count {
+            versions.push((reader.string()?, reader.varint()?));
+        }
+        let count = reader.len()?;
+        let mut deleted = Vec::with_capacity(count);
+        for _ in 0..count {
+            deleted.push(reader.string()?);
+        }
+        let count = reader.len()?;
+        let mut deleted_versions = Vec::with_capacity(count);
+        for _ in 0..count {
+            deleted_versions.push((reader.string()?, reader.opt_u64()?));
+        }
+        let cursor = if reader.bool()? {
+            Some(SyncCursor {
+                epoch: reader.varint()?,
+                seq: reader.varint()?,
+            })
+        } else {
+            None
+        };
+        Ok(SyncPullResponse {
+            batch,
+            versions,
+            deleted,
+            deleted_versions,
+            cursor,
+            has_more: reader.bool()?,
+        })
+    }
+}
+
+impl WireMessage for StreamFrame {
+    const KIND: u8 = 4;
+
+    fn encode_body(&self, out: &mut Vec<u8>) {
+        put_bytes(out, self.branch.as_str().as_bytes());
+        put_varint(out, self.cursor.epoch);
+        put_varint(out, self.cursor.seq);
+        put_varint(out, self.changes.len() as u64);
+        for change in &self.changes {
+            put_bytes(out, change.key.as_bytes());
+            put_opt_u64(out, change.version);
+            out.push(change.deleted as u8);
+            put_opt_bytes(out, change.value.as_deref());
+        }
+        out.push(self.has_more as u8);
+        out.push(self.reset as u8);
+    }
+
+    fn decode_body(reader: &mut Reader<'_>) -> Result<Self, SyncError> {
+        let branch = BranchId::new(reader.string()?);
+        let cursor = SyncCursor {
+            epoch: reader.varint()?,
+            seq: reader.varint()?,
+        };
+        let count = reader.len()?;
+        let mut changes = Vec::with_capacity(count);
+        for _ in 0..count {
+            changes.push(StreamChange {
+                key: reader.string()?,
+                version: reader.opt_u64()?,
+                deleted: reader.bool()?,
+                value: reader.opt_bytes()?,
+            });
+        }
+        Ok(StreamFrame {
+            branch,
+            cursor,
+            changes,
+            has_more: reader.bool()?,
+            reset: reader.bool()?,
+        })
+    }
+}
+
+impl WireMessage for MerkleSummary {
+    const KIND: u8 = 5;
+
+    fn encode_body(&self, out: &mut Vec<u8>) {
+        put_varint(out, self.depth as u64);
+        put_fixed_u64(out, self.root);
+        put_varint(out, self.count);
+    }
+
+    fn decode_body(reader: &mut Reader<'_>) -> Result<Self, SyncError> {
+        Ok(MerkleSummary {
+            depth: reader.varint()? as u32,
+            root: reader.fixed_u64()?,
+            count: reader.varint()?,
+        })
+    }
+}
+
+fn put_u32s(out: &mut Vec<u8>, values: &[u32]) {
+    put_varint(out, values.len() as u64);
+    for value in values {
+        put_varint(out, *value as u64);
+    }
+}
+
+fn read_u32s(reader: &mut Reader<'_>) -> Result<Vec<u32>, SyncError> {
+    let count = reader.len()?;
+    let mut values = Vec::with_capacity(count);
+    for _ in 0..count {
+        values.push(u32::try_from(reader.varint()?).map_err(|_| protocol("index out of range"))?);
+    }
+    Ok(values)
+}
+
+impl WireMessage for MerkleHashesRequest {
+    const KIND: u8 = 6;
+
+    fn encode_body(&self, out: &mut Vec<u8>) {
+        put_bytes(out, self.branch.as_str().as_bytes());
+        put_varint(out, self.level as u64);
+        put_u32s(out, &self.nodes);
+    }
+
+    fn decode_body(reader: &mut Reader<'_>) -> Result<Self, SyncError> {
+        Ok(MerkleHashesRequest {
+            branch: BranchId::new(reader.string()?),
+            level: reader.varint()? as u32,
+            nodes: read_u32s(reader)?,
+        })
+    }
+}
+
+impl WireMessage for MerkleHashesResponse {
+    const KIND: u8 = 7;
+
+    fn encode_body(&self, out: &mut Vec<u8>) {
+        put_varint(out, self.hashes.len() as u64);
+        for hash in &self.hashes {
+            put_fixed_u64(out, *hash);
+        }
+    }
+
+    fn decode_body(reader: &mut Reader<'_>) -> Result<Self, SyncError> {
+        let count = reader.len()?;
+        let mut hashes = Vec::with_capacity(count);
+        for _ in 0..count {
+            hashes.push(reader.fixed_u64()?);
+        }
+        Ok(MerkleHashesResponse { hashes })
+    }
+}
+
+impl WireMessage for MerkleEntriesRequest {
+    const KIND: u8 = 8;
+
+    fn encode_body(&self, out: &mut Vec<u8>) {
+        put_bytes(out, self.branch.as_str().as_bytes());
+        put_u32s(out, &self.leaves);
+    }
+
+    fn decode_body(reader: &mut Reader<'_>) -> Result<Self, SyncError> {
+        Ok(MerkleEntriesRequest {
+            branch: BranchId::new(reader.string()?),
+            leaves: read_u32s(reader)?,
+        })
+    }
+}
+
+impl WireMessage for MerkleEntriesResponse {
+    const KIND: u8 = 9;
+
+    fn encode_body(&self, out: &mut Vec<u8>) {
+        put_varint(out, self.entries.len() as u64);
+        for (key, token) in &self.entries {
+            put_bytes(out, key.as_bytes());
+            put_fixed_u64(out, *token);
+        }
+    }
+
+    fn decode_body(reader: &mut Reader<'_>) -> Result<Self, SyncError> {
+        let count = reader.len()?;
+        let mut entries = Vec::with_capacity(count);
+        for _ in 0..count {
+            entries.push((reader.string()?, reader.fixed_u64()?));
+        }
+        Ok(MerkleEntriesResponse { entries })
+    }
+}
+
+impl WireMessage for FetchRequest {
+    const KIND: u8 = 10;
+
+    fn encode_body(&self, out: &mut Vec<u8>) {
+        put_bytes(out, self.branch.as_str().as_bytes());
+        put_varint(out, self.keys.len() as u64);
+        for key in &self.keys {
+            put_bytes(out, key.as_bytes());
+        }
+    }
+
+    fn decode_body(reader: &mut Reader<'_>) -> Result<Self, SyncError> {
+        let branch = BranchId::new(reader.string()?);
+        let count = reader.len()?;
+        let mut keys = Vec::with_capacity(count);
+        for _ in 0..count {
+            keys.push(reader.string()?);
+        }
+        Ok(FetchRequest { branch, keys })
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn pull_response() -> SyncPullResponse {
+        SyncPullResponse {
+            batch: SyncBatch {
+                branch: BranchId::new("main"),
+                operations: (0..64)
+                    .map(|i| SyncMutation::Put {
+                        key: format!("key-{i}"),
+                        value: vec![i as u8; 48],
+                        version: Some(i),
+                    })
+                    .chain(std::iter::once(SyncMutation::Delete {
+                        key: "gone".into(),
+                        version: None,
+                    }))
+                    .collect(),
+            },
+            versions: vec![("key-1".into(), 1), ("key-300".into(), 300)],
+            deleted: vec!["gone".into()],
+            deleted_versions: vec![("gone".into(), Some(9)), ("older".into(), None)],
+            cursor: Some(SyncCursor {
+                epoch: u64::MAX,
+                seq: 1 << 40,
+            }),
+            has_more: true,
+        }
+    }
+
+    #[test]
+    fn binary_frames_round_trip_and_beat_json() {
+        let response = pull_response();
+        let json = WireFormat::Json.encode(&response).unwrap();
+        let binary = WireFormat::Binary.encode(&response).unwrap();
+        assert!(
+            binary.len() * 3 < json.len(),
+            "{} vs {}",
+            binary.len(),
+            json.len()
+        );
+
+        let decoded: SyncPullResponse = WireFormat::Binary.decode(&binary).unwrap();
+        assert_eq!(
+            serde_json::to_value(&decoded).unwrap(),
+            serde_json::to_value(&response).unwrap()
+        );
+    }
+
+    #[test]
+    fn apply_messages_round_trip() {
+        let request = SyncApplyRequest {
+            batch: pull_response().batch,
+        };
+        let bytes = WireFormat::Binary.encode(&request).unwrap();
+        let decoded: SyncApplyRequest = WireFormat::Binary.decode(&bytes).unwrap();
+        assert_eq!(decoded.batch.operations.len(), 65);
+
+        let response = SyncApplyResponse {
+            applied: 3,
+            conflicts: vec![SyncConflict {
+                key: "k".into(),
+                remote_value: Some(vec![1, 2]),
+                local_value: None,
+                remote_version: Some(2),
+                local_version: Some(1),
+                kind: SyncConflictKind::MissingKey,
+            }],
+        };
+        let bytes = WireFormat::Binary.encode(&response).unwrap();
+        let decoded: SyncApplyResponse = WireFormat::Binary.decode(&bytes).unwrap();
+        assert_eq!(decoded.applied, 3);
+        assert!(matches!(decoded.conflicts[0].kind, SyncConflictKind::MissingKey));
+        assert_eq!(decoded.conflicts[0].remote_value, Some(vec![1, 2]));
+    }
+
+    #[test]
+    fn stream_frames_round_trip() {
+        let frame = StreamFrame {
+            branch: BranchId::new("main"),
+            cursor: SyncCursor { epoch: 3, seq: 70 },
+            changes: vec![
+                StreamChange {
+                    key: "inline".into(),
+                    version: Some(4),
+                    deleted: false,
+                    value: Some(vec![7; 32]),
+                },
+                StreamChange {
+                    key: "large".into(),
+                    version: Some(1),
+                    deleted: false,
+                    value: None,
+                },
+                StreamChange {
+                    key: "gone".into(),
+                    version: None,
+                    deleted: true,
+                    value: None,
+                },
+            ],
+            has_more: true,
+            reset: true,
+        };
+        for format in [WireFormat::Json, WireFormat::Binary] {
+            let bytes = format.encode(&frame).unwrap();
+            assert_eq!(format.decode::<StreamFrame>(&bytes).unwrap(), frame);
+        }
+    }
+
+    #[test]
+    fn merkle_messages_round_trip() {
+        let summary = MerkleSummary {
+            depth: 3,
+            root: u64::MAX - 1,
+            count: 100_000,
+        };
+        let hashes = MerkleHashesResponse {
+            hashes: (0..32u64)
+                .map(|i| i.wrapping_mul(0x9e37_79b9_7f4a_7c15))
+                .collect(),
+        };
+        let entries = MerkleEntriesResponse {
+            entries: vec![("a".into(), u64::MAX), ("b".into(), 0)],
+        };
+        for format in [WireFormat::Json, WireFormat::Binary] {
+            assert_eq!(
+                format
+                    .decode::<MerkleSummary>(&format.encode(&summary).unwrap())
+                    .unwrap(),
+                summary
+            );
+            assert_eq!(
+                format
+                    .decode::<MerkleHashesResponse>(&format.encode(&hashes).unwrap())
+                    .unwrap(),
+                hashes
+            );
+            assert_eq!(
+                format
+                    .decode::<MerkleEntriesResponse>(&format.encode(&entries).unwrap())
+                    .unwrap(),
+                entries
+            );
+
+            let request = MerkleHashesRequest {
+                branch: BranchId::new("main"),
+                level: 2,
+                nodes: vec![0, 255, 4095],
+            };
+            let decoded: MerkleHashesRequest = format.decode(&format.encode(&request).unwrap()).unwrap();
+            assert_eq!((decoded.level, decoded.nodes), (2, vec![0, 255, 4095]));
+
+            let request = FetchRequest {
+                branch: BranchId::new("main"),
+                keys: vec!["k1".into(), "k2".into()],
+            };
+            let decoded: FetchRequest = format.decode(&format.encode(&request).unwrap()).unwrap();
+            assert_eq!(decoded.keys, request.keys);
+        }
+        // Random 64-bit hashes cost 8 bytes each rather than a 10-byte varint
+        assert_eq!(
+            WireFormat::Binary.encode(&hashes).unwrap().len(),
+            HEADER_LEN + 1 + 8 * 32
+        );
+    }
+
+    #[test]
+    fn rejects_truncated_and_mismatched_frames() {
+        let bytes = WireFormat::Binary.encode(&pull_response()).unwrap();
+        assert!(WireFormat::Binary
+            .decode::<SyncPullResponse>(&bytes[..bytes.len() - 1])
+            .is_err());
+        assert!(WireFormat::Binary.decode::<SyncApplyResponse>(&bytes).is_err());
+        assert!(WireFormat::Binary.decode::<SyncPullResponse>(b"{}").is_err());
+    }
+
+    #[test]
+    fn negotiates_from_headers() {
+        assert_eq!(WireFormat::negotiate(None), WireFormat::Json);
+        assert_eq!(WireFormat::negotiate(Some("*/*")), WireFormat::Json);
+        assert_eq!(
+            WireFormat::negotiate(Some("application/json, application/x-acorn-sync")),
+            WireFormat::Binary
+        );
+        assert_eq!(
+            WireFormat::from_content_type(Some("application/x-acorn-sync; charset=binary")),
+            WireFormat::Binary
+        );
+        assert_eq!(
+            WireFormat::from_content_type(Some("application/json")),
+            WireFormat::Json
+        );
+    }
+
+    #[cfg(feature = "zstd")]
+    #[test]
+    fn zstd_frames_compress_and_round_trip() {
+        let response = pull_response();
+        assert_eq!(
+            WireFormat::negotiate(Some(BINARY_ZSTD_ACCEPT)),
+            WireFormat::BinaryZstd
+        );
+        let plain = WireFormat::Binary.encode(&response).unwrap();
+        let packed = WireFormat::BinaryZstd.encode(&response).unwrap();
+        assert!(packed.len() < plain.len());
+        assert_eq!(packed[5] & FLAG_ZSTD, FLAG_ZSTD);
+        let decoded: SyncPullResponse = WireFormat::Binary.decode(&packed).unwrap();
+        assert_eq!(decoded.batch.operations.len(), response.batch.operations.len());
+    }
+}
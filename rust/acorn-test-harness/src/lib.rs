@@ -6,6 +6,8 @@ use acorn_core::{
 };
 use std::time::{Duration, SystemTime};
 
+pub mod http;
+
 #[derive(Debug, Clone)]
 pub struct TrunkContract;
 
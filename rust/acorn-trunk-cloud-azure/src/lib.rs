@@ -10,6 +10,20 @@ use acorn_core::{
 };
 use parking_lot::RwLock;
 
+#[cfg(feature = "http-client")]
+mod store;
+
+pub use acorn_trunk_cloud::{CloudOptions, CloudStats, CloudTrunk, InMemoryObjectStore, ObjectStore};
+#[cfg(feature = "http-client")]
+pub use store::{AzureCredentials, AzureObjectStore};
+
+/// Cloud trunk over a blob container: buffered writes flushed as packs, range reads, block
+/// uploads for large values and ETag-revalidated caching (see [`acorn_trunk_cloud`]).
+#[cfg(feature = "http-client")]
+pub type AzureCloudTrunk = CloudTrunk<AzureObjectStore>;
+
+/// In-process stand-in with the Azure trunk's capabilities, for tests and the `mock` feature.
+/// `AzureCloudTrunk` (feature `http-client`) is the trunk that talks to Blob storage.
 #[derive(Debug, Default, Clone)]
 pub struct AzureTrunk {
     inner: Arc<RwLock<Inner>>,
@@ -0,0 +1,748 @@
+use std::fmt;
+
+use acorn_core::{AcornError, AcornResult};
+use acorn_trunk_cloud::http::{hmac_sha256, uri_encode, xml_escape, xml_text, xml_texts, UtcTime};
+use acorn_trunk_cloud::{GetResult, ObjectStore};
+use base64::engine::general_purpose::STANDARD as BASE64;
+use base64::Engine;
+use futures::future::BoxFuture;
+use reqwest::header::{AUTHORIZATION, ETAG};
+use reqwest::{Method, StatusCode};
+
+const API_VERSION: &str = "2021-08-06";
+
+/// How requests are authorized.
+#[derive(Clone)]
+pub enum AzureCredentials {
+    /// Decoded account key; requests are signed with Shared Key.
+    SharedKey(Vec<u8>),
+    /// SAS token query string (without the leading `?`), appended to every request.
+    Sas(String),
+}
+
+impl AzureCredentials {
+    /// Account key as shown in the portal (base64).
+    pub fn shared_key(key: &str) -> AcornResult<Self> {
+        BASE64
+            .decode(key.trim())
+            .map(AzureCredentials::SharedKey)
+            .map_err(|e| AcornError::Trunk(format!("invalid Azure account key: {e}")))
+    }
+
+    pub fn sas(token: &str) -> Self {
+        AzureCredentials::Sas(token.trim_start_matches('?').to_string())
+    }
+}
+
+impl fmt::Debug for AzureCredentials {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        match self {
+            AzureCredentials::SharedKey(_) => f.write_str("SharedKey(..)"),
+            AzureCredentials::Sas(_) => f.write_str("Sas(..)"),
+        }
+    }
+}
+
+/// Blob container as an [`ObjectStore`] for [`acorn_trunk_cloud::CloudTrunk`], over the Blob
+/// REST API. Multipart uploads map to staged blocks committed with a block list; Azure has no
+/// upload handle, so the blob name doubles as the upload id and uncommitted blocks expire on
+/// their own.
+#[derive(Debug, Clone)]
+pub struct AzureObjectStore {
+    client: reqwest::Client,
+    endpoint: reqwest::Url,
+    account: String,
+    container: String,
+    credentials: AzureCredentials,
+}
+
+impl AzureObjectStore {
+    /// `endpoint` is the account's blob endpoint, e.g. `https://{account}.blob.core.windows.net`
+    /// or `http://127.0.0.1:10000/devstoreaccount1` for Azurite.
+    pub fn new(
+        endpoint: &str,
+        account: impl Into<String>,
+        container: impl Into<String>,
+        credentials: AzureCredentials,
+    ) -> AcornResult<Self> {
+        let endpoint = reqwest::Url::parse(endpoint)
+            .map_err(|e| AcornError::Trunk(format!("invalid Azure endpoint {endpoint}: {e}")))?;
+        Ok(Self {
+            client: reqwest::Client::new(),
+            endpoint,
+            account: account.into(),
+            container: container.into(),
+            credentials,
+        })
+    }
+
+    /// Storage connection string with `AccountName` and `AccountKey` or
+    /// `SharedAccessSignature`, and optionally `BlobEndpoint` or
+    /// `DefaultEndpointsProtocol`/`EndpointSuffix`.
+    pub fn from_connection_string(connection: &str, container: impl Into<String>) -> AcornResult<Self> {
+        let field = |name: &str| {
+            connection.split(';').find_map(|pair| {
+                let (key, value) = pair.split_once('=')?;
+                key.trim()
+                    .eq_ignore_ascii_case(name)
+                    .then(|| value.trim().to_string())
+            })
+        };
+        let account = field("AccountName")
+            .ok_or_else(|| AcornError::Trunk("connection string has no AccountName".into()))?;
+        let credentials = match (field("AccountKey"), field("SharedAccessSignature")) {
+            (Some(key), _) => AzureCredentials::shared_key(&key)?,
+            (None, Some(sas)) => AzureCredentials::sas(&sas),
+            (None, None) => {
+                return Err(AcornError::Trunk(
+                    "connection string has neither AccountKey nor SharedAccessSignature".into(),
+                ))
+            }
+        };
+        let endpoint = field("BlobEndpoint").unwrap_or_else(|| {
+            let protocol = field("DefaultEndpointsProtocol").unwrap_or_else(|| "https".into());
+            let suffix = field("EndpointSuffix").unwrap_or_else(|| "core.windows.net".into());
+            format!("{protocol}://{account}.blob.{suffix}")
+        });
+        Self::new(&endpoint, account, container, credentials)
+    }
+
+    /// `AZURE_STORAGE_CONNECTION_STRING`, or `AZURE_STORAGE_ACCOUNT` with `AZURE_STORAGE_KEY`
+    /// or `AZURE_STORAGE_SAS_TOKEN` (endpoint from `AZURE_STORAGE_ENDPOINT`, defaulting to the
+    /// public cloud).
+    pub fn from_env(container: impl Into<String>) -> AcornResult<Self> {
+        if let Ok(connection) = std::env::var("AZURE_STORAGE_CONNECTION_STRING") {
+            return Self::from_connection_string(&connection, container);
+        }
+        let account = std::env::var("AZURE_STORAGE_ACCOUNT")
+            .map_err(|_| AcornError::Trunk("AZURE_STORAGE_ACCOUNT is not set".into()))?;
+        let credentials = match (
+            std::env::var("AZURE_STORAGE_KEY"),
+            std::env::var("AZURE_STORAGE_SAS_TOKEN"),
+        ) {
+            (Ok(key), _) => AzureCredentials::shared_key(&key)?,
+            (Err(_), Ok(sas)) => AzureCredentials::sas(&sas),
+            _ => {
+                return Err(AcornError::Trunk(
+                    "set AZURE_STORAGE_KEY or AZURE_STORAGE_SAS_TOKEN".into(),
+                ))
+            }
+        };
+        let endpoint = std::env::var("AZURE_STORAGE_ENDPOINT")
+            .unwrap_or_else(|_| format!("https://{account}.blob.core.windows.net"));
+        Self::new(&endpoint, account, container, credentials)
+    }
+
+    /// Use a caller-configured client (timeouts, proxies, TLS roots).
+    pub fn with_client(mut self, client: reqwest::Client) -> Self {
+        self.client = client;
+        self
+    }
+
+    pub fn container(&self) -> &str {
+        &self.container
+    }
+
+    fn path(&self, key: Option<&str>) -> String {
+        let mut path = format!(
+            "{}/{}",
+            self.endpoint.path().trim_end_matches('/'),
+            uri_encode(&self.container, false)
+        );
+        if let Some(key) = key {
+            path.push('/');
+            path.push_str(&uri_encode(key, true));
+        }
+        path
+    }
+
+    /// Sign (or attach the SAS token to) and send one request. `headers` are `x-ms-*` headers
+    /// and `if-none-match`, all covered by the Shared Key signature.
+    async fn send(
+        &self,
+        method: Method,
+        key: Option<&str>,
+        query: &[(&str, &str)],
+        headers: &[(&str, String)],
+        body: Vec<u8>,
+    ) -> AcornResult<reqwest::Response> {
+        let path = self.path(key);
+        let mut all_headers = vec![
+            ("x-ms-date", UtcTime::now().http_date()),
+            ("x-ms-version", API_VERSION.to_string()),
+        ];
+        all_headers.extend(headers.iter().map(|(name, value)| (*name, value.clone())));
+
+        let mut sent_query: Vec<String> = query
+            .iter()
+            .map(|(name, value)| format!("{}={}", uri_encode(name, false), uri_encode(value, false)))
+            .collect();
+        let authorization = match &self.credentials {
+            AzureCredentials::SharedKey(account_key) => {
+                let to_sign = string_to_sign(
+                    method.as_str(),
+                    body.len(),
+                    &all_headers,
+                    &self.account,
+                    &path,
+                    query,
+                );
+                Some(shared_key(&self.account, account_key, &to_sign))
+            }
+            AzureCredentials::Sas(token) => {
+                sent_query.push(token.clone());
+                None
+            }
+        };
+
+        let origin = &self.endpoint.origin().ascii_serialization();
+        let url = match sent_query.is_empty() {
+            true => format!("{origin}{path}"),
+            false => format!("{origin}{path}?{}", sent_query.join("&")),
+        };
+        let mut request = self.client.request(method, url).body(body);
+        if let Some(authorization) = authorization {
+            request = request.header(AUTHORIZATION, authorization);
+        }
+        for (name, value) in &all_headers {
+            request = request.header(*name, value);
+        }
+        request
+            .send()
+            .await
+            .map_err(|e| AcornError::Trunk(format!("Azure request failed: {e}")))
+    }
+}
+
+/// Shared Key string-to-sign for a request that sends no standard headers besides
+/// `Content-Length` and (optionally) `If-None-Match`; everything else goes in `x-ms-*`.
+fn string_to_sign(
+    method: &str,
+    content_length: usize,
+    headers: &[(&str, String)],
+    account: &str,
+    path: &str,
+    query: &[(&str, &str)],
+) -> String {
+    let if_none_match = headers
+        .iter()
+        .find(|(name, _)| name.eq_ignore_ascii_case("if-none-match"))
+        .map(|(_, value)| value.as_str())
+        .unwrap_or_default();
+    let content_length = match content_length {
+        0 => String::new(),
+        n => n.to_string(),
+    };
+
+    let mut ms_headers: Vec<_> = headers
+        .iter()
+        .map(|(name, value)| (name.to_ascii_lowercase(), value.trim().to_string()))
+        .filter(|(name, _)| name.starts_with("x-ms-"))
+        .collect();
+    ms_headers.sort();
+    let canonical_headers: String = ms_headers
+        .iter()
+        .map(|(name, value)| format!("{name}:{value}\n"))
+        .collect();
+
+    let mut params: Vec<_> = query
+        .iter()
+        .map(|(name, value)| (name.to_ascii_lowercase(), *value))
+        .collect();
+    params.sort();
+    let canonical_resource: String = params
+        .iter()
+        .map(|(name, value)| format!("\n{name}:{value}"))
+        .collect();
+
+    format!(
+        "{method}\n\n\n{content_length}\n\n\n\n\n\n{if_none_match}\n\n\n{canonical_headers}/{account}{path}{canonical_resource}"
+    )
+}
+
+fn shared_key(account: &str, account_key: &[u8], string_to_sign: &str) -> String {
+    let signature = BASE64.encode(hmac_sha256(account_key, string_to_sign.as_bytes()));
+    format!("SharedKey {account}:{signature}")
+}
+
+/// Block ids must all have the same length within a blob.
+fn block_id(part_number: u32) -> String {
+    BASE64.encode(format!("{part_number:010}"))
+}
+
+fn etag(response: &reqwest::Response) -> Option<String> {
+    response
+        .headers()
+        .get(ETAG)
+        .and_then(|value| value.to_str().ok())
+        .map(str::to_string)
+}
+
+async fn failure(op: &str, key: &str, response: reqwest::Response) -> AcornError {
+    let status = response.status();
+    let body = response.text().await.unwrap_or_default();
+    let code = xml_text(&body, "Code").unwrap_or_default();
+    AcornError::Trunk(format!("Azure {op} {key} failed: {status} {code}"))
+}
+
+async fn body(response: reqwest::Response) -> AcornResult<Vec<u8>> {
+    response
+        .bytes()
+        .await
+        .map(|bytes| bytes.to_vec())
+        .map_err(|e| AcornError::Trunk(format!("Azure response body: {e}")))
+}
+
+impl ObjectStore for AzureObjectStore {
+    fn put<'a>(&'a self, key: &'a str, body: Vec<u8>) -> BoxFuture<'a, AcornResult<Option<String>>> {
+        Box::pin(async move {
+            let headers = [("x-ms-blob-type", "BlockBlob".to_string())];
+            let response = self.send(Method::PUT, Some(key), &[], &headers, body).await?;
+            if !response.status().is_success() {
+                return Err(failure("Put Blob", key, response).await);
+            }
+            Ok(etag(&response))
+        })
+    }
+
+    fn get<'a>(
+        &'a self,
+        key: &'a str,
+        if_none_match: Option<&'a str>,
+    ) -> BoxFuture<'a, AcornResult<GetResult>> {
+        Box::pin(async move {
+            let headers: Vec<_> = if_none_match
+                .map(|tag| ("if-none-match", tag.to_string()))
+                .into_iter()
+                .collect();
+            let response = self
+                .send(Method::GET, Some(key), &[], &headers, Vec::new())
+                .await?;
+            match response.status() {
+                StatusCode::NOT_MODIFIED => Ok(GetResult::NotModified),
+                StatusCode::NOT_FOUND => Ok(GetResult::Missing),
+                status if status.is_success() => {
+                    let etag = etag(&response);
+                    Ok(GetResult::Body {
+                        bytes: body(response).await?,
+                        etag,
+                    })
+                }
+                _ => Err(failure("Get Blob", key, response).await),
+            }
+        })
+    }
+
+    fn get_range<'a>(
+        &'a self,
+        key: &'a str,
+        offset: u64,
+        len: u64,
+    ) -> BoxFuture<'a, AcornResult<Option<Vec<u8>>>> {
+        Box::pin(async move {
+            if len == 0 {
+                return Ok(Some(Vec::new()));
+            }
+            let range = [("x-ms-range", format!("bytes={}-{}", offset, offset + len - 1))];
+            let response = self.send(Method::GET, Some(key), &[], &range, Vec::new()).await?;
+            match response.status() {
+                StatusCode::NOT_FOUND => Ok(None),
+                StatusCode::PARTIAL_CONTENT => body(response).await.map(Some),
+                StatusCode::OK => {
+                    let bytes = body(response).await?;
+                    let start = (offset as usize).min(bytes.len());
+                    let end = (start + len as usize).min(bytes.len());
+                    Ok(Some(bytes[start..end].to_vec()))
+                }
+                _ => Err(failure("Get Blob", key, response).await),
+            }
+        })
+    }
+
+    fn delete<'a>(&'a self, key: &'a str) -> BoxFuture<'a, AcornResult<()>> {
+        Box::pin(async move {
+            let response = self.send(Method::DELETE, Some(key), &[], &[], Vec::new()).await?;
+            if !response.status().is_success() && response.status() != StatusCode::NOT_FOUND {
+                return Err(failure("Delete Blob", key, response).await);
+            }
+            Ok(())
+        })
+    }
+
+    fn list<'a>(&'a self, prefix: &'a str) -> BoxFuture<'a, AcornResult<Vec<String>>> {
+        Box::pin(async move {
+            let mut names = Vec::new();
+            let mut marker: Option<String> = None;
+            loop {
+                let mut query = vec![("restype", "container"), ("comp", "list"), ("prefix", prefix)];
+                if let Some(marker) = &marker {
+                    query.push(("marker", marker));
+                }
+                let response = self.send(Method::GET, None, &query, &[], Vec::new()).await?;
+                if !response.status().is_success() {
+                    return Err(failure("List Blobs", prefix, response).await);
+                }
+                let page = String::from_utf8_lossy(&body(response).await?).into_owned();
+                names.extend(xml_texts(&page, "Name"));
+                match xml_text(&page, "NextMarker") {
+                    Some(next) if !next.is_empty() => marker = Some(next),
+                    _ => return Ok(names),
+                }
+            }
+        })
+    }
+
+    fn create_multipart<'a>(&'a self, key: &'a str) -> BoxFuture<'a, AcornResult<Option<String>>> {
+        Box::pin(async move { Ok(Some(key.to_string())) })
+    }
+
+    fn upload_part<'a>(
+        &'a self,
+        key: &'a str,
+        _upload_id: &'a str,
+        part_number: u32,
+        body: Vec<u8>,
+    ) -> BoxFuture<'a, AcornResult<String>> {
+        Box::pin(async move {
+            let id = block_id(part_number);
+            let query = [("comp", "block"), ("blockid", id.as_str())];
+            let response = self.send(Method::PUT, Some(key), &query, &[], body).await?;
+            if !response.status().is_success() {
+                return Err(failure("Put Block", key, response).await);
+            }
+            Ok(id)
+        })
+    }
+
+    fn complete_multipart<'a>(
+        &'a self,
+        key: &'a str,
+        _upload_id: &'a str,
+        parts: Vec<(u32, String)>,
+    ) -> BoxFuture<'a, AcornResult<Option<String>>> {
+        Box::pin(async move {
+            let mut list = String::from("<?xml version=\"1.0\" encoding=\"utf-8\"?><BlockList>");
+            for (_, id) in parts {
+                list.push_str(&format!("<Latest>{}</Latest>", xml_escape(&id)));
+            }
+            list.push_str("</BlockList>");
+            let response = self
+                .send(
+                    Method::PUT,
+                    Some(key),
+                    &[("comp", "blocklist")],
+                    &[],
+                    list.into_bytes(),
+                )
+                .await?;
+            if !response.status().is_success() {
+                return Err(failure("Put Block List", key, response).await);
+            }
+            Ok(etag(&response))
+        })
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::collections::HashMap;
+    use std::sync::{Arc, Mutex};
+
+    use acorn_core::{BranchId, KeyedTrunk, Nut, Trunk};
+    use acorn_test_harness::http::{percent_decode, FakeHttpServer, HttpRequest, HttpResponse};
+    use acorn_trunk_cloud::http::{hex, sha256};
+    use acorn_trunk_cloud::{CloudOptions, CloudTrunk};
+
+    const ACCOUNT: &str = "devstoreaccount1";
+    // Azurite's well-known development key
+    const KEY: &str =
+        "Eby8vdM02xNOcqFlqUwJPLlmEtlCDXJ1OUzFT50uSRZ6IFsuFq2UVErCz4I6tq/K1SZFPTOtr/KBHBeksoGMGw==";
+
+    #[test]
+    fn string_to_sign_follows_the_shared_key_layout() {
+        let headers = [
+            ("x-ms-version", API_VERSION.to_string()),
+            ("x-ms-date", "Fri, 24 May 2013 00:00:00 GMT".to_string()),
+            ("if-none-match", "\"0x1\"".to_string()),
+        ];
+        let query = [("restype", "container"), ("comp", "list"), ("prefix", "a b")];
+        assert_eq!(
+            string_to_sign("GET", 0, &headers, "acct", "/box", &query),
+            "GET\n\n\n\n\n\n\n\n\n\"0x1\"\n\n\n\
+             x-ms-date:Fri, 24 May 2013 00:00:00 GMT\nx-ms-version:2021-08-06\n\
+             /acct/box\ncomp:list\nprefix:a b\nrestype:container"
+        );
+        assert_eq!(
+            string_to_sign("PUT", 3, &[], "acct", "/box/k", &[]),
+            "PUT\n\n\n3\n\n\n\n\n\n\n\n\n/acct/box/k"
+        );
+    }
+
+    #[test]
+    fn signs_the_documented_get_container_metadata_example() {
+        // The string-to-sign shown in Microsoft's "Authorize with Shared Key" documentation
+        let headers = [
+            ("x-ms-date", "Fri, 26 Jun 2015 23:39:12 GMT".to_string()),
+            ("x-ms-version", "2015-02-21".to_string()),
+        ];
+        let query = [("restype", "container"), ("comp", "metadata"), ("timeout", "20")];
+        let to_sign = string_to_sign("GET", 0, &headers, "myaccount", "/mycontainer", &query);
+        assert_eq!(
+            to_sign,
+            "GET\n\n\n\n\n\n\n\n\n\n\n\n\
+             x-ms-date:Fri, 26 Jun 2015 23:39:12 GMT\nx-ms-version:2015-02-21\n\
+             /myaccount/mycontainer\ncomp:metadata\nrestype:container\ntimeout:20"
+        );
+        // The documentation gives no signature for it; this one was computed separately with
+        // Python's hmac and base64 modules over the same string and Azurite's key
+        let key = BASE64.decode(KEY).unwrap();
+        assert_eq!(
+            shared_key("myaccount", &key, &to_sign),
+            "SharedKey myaccount:1u9lui2jDxj0+fpbHjQ5m5NnastJRSYM+PSmfi8TXx4="
+        );
+    }
+
+    #[test]
+    fn parses_connection_strings() {
+        let store = AzureObjectStore::from_connection_string(
+            &format!(
+                "DefaultEndpointsProtocol=http;AccountName={ACCOUNT};AccountKey={KEY};\
+                 BlobEndpoint=http://127.0.0.1:10000/{ACCOUNT};"
+            ),
+            "box",
+        )
+        .unwrap();
+        assert_eq!(store.path(Some("a b")), format!("/{ACCOUNT}/box/a%20b"));
+        assert!(matches!(store.credentials, AzureCredentials::SharedKey(_)));
+
+        let store = AzureObjectStore::from_connection_string(
+            "AccountName=acct;SharedAccessSignature=?sv=1&sig=x",
+            "box",
+        )
+        .unwrap();
+        assert_eq!(store.endpoint.as_str(), "https://acct.blob.core.windows.net/");
+        assert!(matches!(&store.credentials, AzureCredentials::Sas(token) if token == "sv=1&sig=x"));
+        assert!(AzureObjectStore::from_connection_string("AccountName=acct", "box").is_err());
+    }
+
+    /// Just enough of Blob storage for the cloud trunk, checking every request's signature.
+    #[derive(Default)]
+    struct FakeBlobs {
+        blobs: HashMap<String, Vec<u8>>,
+        blocks: HashMap<(String, String), Vec<u8>>,
+        requests: Vec<String>,
+    }
+
+    fn tag(bytes: &[u8]) -> String {
+        format!("\"0x{}\"", &hex(&sha256(bytes))[..16])
+    }
+
+    fn signature_matches(request: &HttpRequest, key: &[u8]) -> bool {
+        let headers: Vec<(&str, String)> = request
+            .headers
+            .iter()
+            .filter(|(name, _)| name.starts_with("x-ms-") || name == "if-none-match")
+            .map(|(name, value)| (name.as_str(), value.clone()))
+            .collect();
+        let query: Vec<(String, String)> = request
+            .raw_query
+            .iter()
+            .map(|(name, value)| (percent_decode(name), percent_decode(value)))
+            .collect();
+        let query: Vec<(&str, &str)> = query.iter().map(|(n, v)| (n.as_str(), v.as_str())).collect();
+        let to_sign = string_to_sign(
+            &request.method,
+            request.body.len(),
+            &headers,
+            ACCOUNT,
+            &request.raw_path,
+            &query,
+        );
+        request.header("authorization") == Some(shared_key(ACCOUNT, key, &to_sign).as_str())
+    }
+
+    fn handle(state: &Mutex<FakeBlobs>, key: &[u8], request: HttpRequest) -> HttpResponse {
+        if !signature_matches(&request, key) {
+            return HttpResponse::status(403).with_body("<Error><Code>AuthenticationFailed</Code></Error>");
+        }
+        if request.header("x-ms-version") != Some(API_VERSION) {
+            return HttpResponse::status(400);
+        }
+        let mut state = state.lock().unwrap();
+        let path = request.path();
+        let blob = path.strip_prefix("/box/").unwrap_or_default().to_string();
+        state.requests.push(format!(
+            "{} {} {}",
+            request.method,
+            path,
+            request.query("comp").unwrap_or_default()
+        ));
+
+        match (request.method.as_str(), request.query("comp").as_deref()) {
+            ("GET", Some("list")) => {
+                let prefix = request.query("prefix").unwrap_or_default();
+                let start: usize = request.query("marker").and_then(|m| m.parse().ok()).unwrap_or(0);
+                let mut names: Vec<_> = state.blobs.keys().filter(|k| k.starts_with(&prefix)).collect();
+                names.sort();
+                let page: String = names
+                    .iter()
+                    .skip(start)
+                    .take(2)
+                    .map(|n| format!("<Blob><Name>{}</Name></Blob>", xml_escape(n)))
+                    .collect();
+                let next = match start + 2 < names.len() {
+                    true => format!("<NextMarker>{}</NextMarker>", start + 2),
+                    false => "<NextMarker />".to_string(),
+                };
+                HttpResponse::status(200).with_body(format!(
+                    "<EnumerationResults><Blobs>{page}</Blobs>{next}</EnumerationResults>"
+                ))
+            }
+            ("GET", None) => {
+                let Some(data) = state.blobs.get(&blob) else {
+                    return HttpResponse::status(404).with_body("<Error><Code>BlobNotFound</Code></Error>");
+                };
+                if request.header("if-none-match") == Some(tag(data).as_str()) {
+                    return HttpResponse::status(304);
+                }
+                if let Some(range) = request
+                    .header("x-ms-range")
+                    .and_then(|r| r.strip_prefix("bytes="))
+                {
+                    let (start, end) = range.split_once('-').unwrap();
+                    let (start, end): (usize, usize) = (start.parse().unwrap(), end.parse().unwrap());
+                    return HttpResponse::status(206).with_body(data[start..=end].to_vec());
+                }
+                HttpResponse::status(200)
+                    .with_header("etag", tag(data))
+                    .with_body(data.clone())
+            }
+            ("PUT", None) => {
+                assert_eq!(request.header("x-ms-blob-type"), Some("BlockBlob"));
+                let etag = tag(&request.body);
+                state.blobs.insert(blob, request.body);
+                HttpResponse::status(201).with_header("etag", etag)
+            }
+            ("PUT", Some("block")) => {
+                let id = request.query("blockid").unwrap();
+                state.blocks.insert((blob, id), request.body);
+                HttpResponse::status(201)
+            }
+            ("PUT", Some("blocklist")) => {
+                let list = String::from_utf8(request.body).unwrap();
+                let mut data = Vec::new();
+                for id in xml_texts(&list, "Latest") {
+                    data.extend(state.blocks.remove(&(blob.clone(), id)).unwrap());
+                }
+                let etag = tag(&data);
+                state.blobs.insert(blob, data);
+                HttpResponse::status(201).with_header("etag", etag)
+            }
+            ("DELETE", None) => match state.blobs.remove(&blob) {
+                Some(_) => HttpResponse::status(202),
+                None => HttpResponse::status(404),
+            },
+            _ => HttpResponse::status(405),
+        }
+    }
+
+    fn fake_blobs() -> (FakeHttpServer, Arc<Mutex<FakeBlobs>>, AzureObjectStore) {
+        let state = Arc::new(Mutex::new(FakeBlobs::default()));
+        let served = state.clone();
+        let key = BASE64.decode(KEY).unwrap();
+        let server = FakeHttpServer::start(move |request| handle(&served, &key, request)).unwrap();
+        let store = AzureObjectStore::new(
+            &server.url(),
+            ACCOUNT,
+            "box",
+            AzureCredentials::shared_key(KEY).unwrap(),
+        )
+        .unwrap();
+        (server, state, store)
+    }
+
+    #[test]
+    fn cloud_trunk_round_trips_through_the_rest_api() {
+        let (_server, state, store) = fake_blobs();
+        let branch = BranchId::new("main");
+        let options = CloudOptions {
+            prefix: "azure test".into(),
+            pack_threshold_bytes: 64,
+            multipart_threshold_bytes: 128,
+            multipart_part_bytes: 100,
+            ..CloudOptions::default()
+        };
+        let writer = CloudTrunk::new(store.clone(), options.clone()).unwrap();
+        for i in 0..5 {
+            let value = format!("value {i}").into_bytes();
+            writer.put(&branch, &format!("key/{i}"), Nut { value }).unwrap();
+        }
+        let large: Vec<u8> = (0..=255).cycle().take(300).collect();
+        writer
+            .put(&branch, "large", Nut { value: large.clone() })
+            .unwrap();
+        writer.delete(&branch, "key/4").unwrap();
+        writer.flush().unwrap();
+
+        let reader = CloudTrunk::new(store, options).unwrap();
+        assert_eq!(reader.get(&branch, "key/2").unwrap().unwrap().value, b"value 2");
+        assert_eq!(reader.get(&branch, "large").unwrap().unwrap().value, large);
+        assert!(reader.get(&branch, "key/4").unwrap().is_none());
+        let mut keys = reader.keys(&branch);
+        keys.sort();
+        assert_eq!(keys, vec!["key/0", "key/1", "key/2", "key/3", "large"]);
+
+        let state = state.lock().unwrap();
+        assert!(state.blocks.is_empty());
+        // The large value alone takes three blocks; packs and index files may be staged too
+        let blocks = state.requests.iter().filter(|r| r.ends_with(" block")).count();
+        assert!(blocks >= 3, "{blocks} blocks staged");
+    }
+
+    #[tokio::test]
+    async fn conditional_and_range_reads_and_listing() {
+        let (_server, _state, store) = fake_blobs();
+        let etag = store.put("dir/a&b", b"0123456789".to_vec()).await.unwrap();
+        store.put("dir/c", b"c".to_vec()).await.unwrap();
+        store.put("dir/d", b"d".to_vec()).await.unwrap();
+        store.put("other", b"o".to_vec()).await.unwrap();
+
+        assert_eq!(
+            store.get("dir/a&b", etag.as_deref()).await.unwrap(),
+            GetResult::NotModified
+        );
+        assert!(matches!(
+            store.get("dir/a&b", Some("\"stale\"")).await.unwrap(),
+            GetResult::Body { bytes, .. } if bytes == b"0123456789"
+        ));
+        assert_eq!(store.get("missing", None).await.unwrap(), GetResult::Missing);
+        assert_eq!(
+            store.get_range("dir/a&b", 2, 3).await.unwrap(),
+            Some(b"234".to_vec())
+        );
+        assert_eq!(store.get_range("missing", 0, 1).await.unwrap(), None);
+
+        let mut listed = store.list("dir/").await.unwrap();
+        listed.sort();
+        assert_eq!(listed, vec!["dir/a&b", "dir/c", "dir/d"]);
+
+        store.delete("dir/c").await.unwrap();
+        store.delete("dir/c").await.unwrap();
+        assert_eq!(store.list("dir/").await.unwrap().len(), 2);
+    }
+
+    #[tokio::test]
+    async fn rejected_requests_surface_the_service_error() {
+        let (server, _state, _store) = fake_blobs();
+        let wrong = AzureObjectStore::new(
+            &server.url(),
+            ACCOUNT,
+            "box",
+            AzureCredentials::SharedKey(b"not the key".to_vec()),
+        )
+        .unwrap();
+        let err = wrong.put("k", b"v".to_vec()).await.unwrap_err();
+        assert!(err.to_string().contains("AuthenticationFailed"), "{err}");
+    }
+}
@@ -10,6 +10,20 @@ use acorn_core::{
 };
 use parking_lot::RwLock;
 
+#[cfg(feature = "http-client")]
+mod store;
+
+pub use acorn_trunk_cloud::{CloudOptions, CloudStats, CloudTrunk, InMemoryObjectStore, ObjectStore};
+#[cfg(feature = "http-client")]
+pub use store::{S3Credentials, S3ObjectStore};
+
+/// Cloud trunk over an S3 bucket: buffered writes flushed as packs, range reads, multipart
+/// uploads for large values and ETag-revalidated caching (see [`acorn_trunk_cloud`]).
+#[cfg(feature = "http-client")]
+pub type S3CloudTrunk = CloudTrunk<S3ObjectStore>;
+
+/// In-process stand-in with the S3 trunk's capabilities, for tests and the `mock` feature.
+/// `S3CloudTrunk` (feature `http-client`) is the trunk that talks to S3.
 #[derive(Debug, Default, Clone)]
 pub struct S3Trunk {
     inner: Arc<RwLock<Inner>>,
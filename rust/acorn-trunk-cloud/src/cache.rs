@@ -0,0 +1,174 @@
+use std::fs;
+use std::io::{Read, Seek, SeekFrom};
+use std::path::{Path, PathBuf};
+use std::sync::atomic::{AtomicU64, Ordering};
+
+use acorn_core::{AcornError, AcornResult};
+use serde::{Deserialize, Serialize};
+
+use crate::store::{GetResult, ObjectStore};
+
+#[derive(Debug, Serialize, Deserialize)]
+struct Meta {
+    key: String,
+    etag: Option<String>,
+}
+
+/// On-disk read-through cache of downloaded objects, one file per key plus a metadata file
+/// holding the full key and its ETag. Packs and index files never change once written, so
+/// they are served from disk without a request; objects that can be overwritten are
+/// revalidated with If-None-Match, so an unchanged object costs a 304 instead of a download.
+#[derive(Debug)]
+pub(crate) struct DiskCache {
+    dir: PathBuf,
+    hits: AtomicU64,
+    revalidated: AtomicU64,
+    downloads: AtomicU64,
+}
+
+impl DiskCache {
+    pub fn open(dir: &Path) -> AcornResult<Self> {
+        fs::create_dir_all(dir).map_err(|e| AcornError::Trunk(e.to_string()))?;
+        Ok(Self {
+            dir: dir.to_path_buf(),
+            hits: AtomicU64::new(0),
+            revalidated: AtomicU64::new(0),
+            downloads: AtomicU64::new(0),
+        })
+    }
+
+    pub fn hits(&self) -> u64 {
+        self.hits.load(Ordering::Relaxed)
+    }
+
+    pub fn revalidated(&self) -> u64 {
+        self.revalidated.load(Ordering::Relaxed)
+    }
+
+    pub fn downloads(&self) -> u64 {
+        self.downloads.load(Ordering::Relaxed)
+    }
+
+    /// Object that never changes once written: download once, then read from disk.
+    pub async fn get_immutable<S: ObjectStore + ?Sized>(
+        &self,
+        store: &S,
+        key: &str,
+    ) -> AcornResult<Option<Vec<u8>>> {
+        if let Some((bytes, _)) = self.read(key) {
+            self.hits.fetch_add(1, Ordering::Relaxed);
+            return Ok(Some(bytes));
+        }
+        self.download(store, key).await
+    }
+
+    /// Object that may be overwritten: revalidate the cached copy's ETag on every read.
+    pub async fn get_validated<S: ObjectStore + ?Sized>(
+        &self,
+        store: &S,
+        key: &str,
+    ) -> AcornResult<Option<Vec<u8>>> {
+        let Some((bytes, Some(etag))) = self.read(key) else {
+            return self.download(store, key).await;
+        };
+        match store.get(key, Some(&etag)).await? {
+            GetResult::NotModified => {
+                self.revalidated.fetch_add(1, Ordering::Relaxed);
+                Ok(Some(bytes))
+            }
+            GetResult::Body { bytes, etag } => {
+                self.downloads.fetch_add(1, Ordering::Relaxed);
+                self.store(key, &bytes, etag.as_deref());
+                Ok(Some(bytes))
+            }
+            GetResult::Missing => {
+                self.invalidate(key);
+                Ok(None)
+            }
+        }
+    }
+
+    /// Part of a cached object, without touching the store.
+    pub fn read_range(&self, key: &str, offset: u64, len: u64) -> Option<Vec<u8>> {
+        self.meta(key)?;
+        let mut file = fs::File::open(self.content_path(key)).ok()?;
+        if offset + len > file.metadata().ok()?.len() {
+            return None;
+        }
+        let mut bytes = vec![0; usize::try_from(len).ok()?];
+        file.seek(SeekFrom::Start(offset)).ok()?;
+        file.read_exact(&mut bytes).ok()?;
+        self.hits.fetch_add(1, Ordering::Relaxed);
+        Some(bytes)
+    }
+
+    /// Cache bytes this process just uploaded or downloaded. Failures only cost a later download.
+    pub fn store(&self, key: &str, bytes: &[u8], etag: Option<&str>) {
+        let meta = Meta {
+            key: key.to_string(),
+            etag: etag.map(str::to_string),
+        };
+        let result = serde_json::to_vec(&meta)
+            .map_err(std::io::Error::other)
+            .and_then(|meta| {
+                // Write then rename so a concurrent reader never sees a partial file
+                let content = self.content_path(key);
+                static TEMP: AtomicU64 = AtomicU64::new(0);
+                let temp = content.with_extension(format!(
+                    "{}-{}.tmp",
+                    std::process::id(),
+                    TEMP.fetch_add(1, Ordering::Relaxed)
+                ));
+                fs::write(&temp, bytes)?;
+                fs::rename(&temp, &content)?;
+                fs::write(self.meta_path(key), meta)
+            });
+        if let Err(err) = result {
+            tracing::warn!(key, error = %err, "failed to cache object on disk");
+        }
+    }
+
+    pub fn invalidate(&self, key: &str) {
+        let _ = fs::remove_file(self.meta_path(key));
+        let _ = fs::remove_file(self.content_path(key));
+    }
+
+    async fn download<S: ObjectStore + ?Sized>(&self, store: &S, key: &str) -> AcornResult<Option<Vec<u8>>> {
+        match store.get(key, None).await? {
+            GetResult::Body { bytes, etag } => {
+                self.downloads.fetch_add(1, Ordering::Relaxed);
+                self.store(key, &bytes, etag.as_deref());
+                Ok(Some(bytes))
+            }
+            _ => Ok(None),
+        }
+    }
+
+    fn read(&self, key: &str) -> Option<(Vec<u8>, Option<String>)> {
+        let meta = self.meta(key)?;
+        let bytes = fs::read(self.content_path(key)).ok()?;
+        Some((bytes, meta.etag))
+    }
+
+    /// Metadata of `key`, if cached under its own name (file names are hashes, so a different
+    /// key hashing to the same name reads as a miss).
+    fn meta(&self, key: &str) -> Option<Meta> {
+        let meta: Meta = serde_json::from_slice(&fs::read(self.meta_path(key)).ok()?).ok()?;
+        (meta.key == key).then_some(meta)
+    }
+
+    fn content_path(&self, key: &str) -> PathBuf {
+        self.dir.join(format!("{:016x}", fnv1a(key)))
+    }
+
+    fn meta_path(&self, key: &str) -> PathBuf {
+        self.dir.join(format!("{:016x}.meta", fnv1a(key)))
+    }
+}
+
+/// FNV-1a, stable across processes and Rust versions (unlike `DefaultHasher`).
+fn fnv1a(key: &str) -> u64 {
+    key.bytes().fold(0xcbf2_9ce4_8422_2325, |hash, byte| {
+        (hash ^ u64::from(byte)).wrapping_mul(0x0100_0000_01b3)
+    })
+}
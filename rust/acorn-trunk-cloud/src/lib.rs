@@ -0,0 +1,1292 @@
+//! Object-store trunk shared by the S3 and Azure crates.
+//!
+//! Writes are buffered and flushed as packs: each flush writes the small values of a branch back
+//! to back into one pack object (`{prefix}/{branch}/packs/{sequence}.pack`) followed by an index
+//! file (`{sequence}.idx`) giving each key's offset, length and version. The index is uploaded
+//! last, so it is the commit point. Values above `pack_threshold_bytes` get their own object
+//! (multipart above `multipart_threshold_bytes`) that the index points at, and deletes are
+//! tombstone entries. Later sequences win, so index files can be applied in any order.
+//!
+//! Single reads are byte-range GETs into a pack; `load_all` and `get_many` download whole
+//! packs in parallel instead of issuing one request per key. With `cache_dir` set, downloaded
+//! objects are kept on disk: packs and index files never change and are served without a
+//! request, large objects are revalidated by ETag.
+
+mod cache;
+#[cfg(feature = "http-client")]
+pub mod http;
+mod pack;
+mod store;
+
+use std::collections::{HashMap, HashSet};
+use std::future::Future;
+use std::path::PathBuf;
+use std::sync::atomic::{AtomicU64, Ordering};
+use std::sync::{Arc, OnceLock};
+
+use acorn_core::{
+    AcornError, AcornResult, BranchId, CapabilityAdvertiser, KeyedTrunk, Nut, TombstoneProvider, Trunk,
+    TrunkCapability,
+};
+use futures::stream::{self, StreamExt, TryStreamExt};
+use parking_lot::RwLock;
+
+use cache::DiskCache;
+use pack::{escape, next_sequence, BranchIndex, IndexEntry, IndexFile, Location};
+pub use store::{put_object, GetResult, InMemoryObjectStore, ObjectStore, StoreCounters};
+
+#[derive(Debug, Clone)]
+pub struct CloudOptions {
+    /// Key prefix for everything this trunk writes.
+    pub prefix: String,
+    /// Buffered writes (across branches) that trigger a flush.
+    pub flush_threshold: usize,
+    /// Values larger than this are stored as their own object instead of being packed.
+    pub pack_threshold_bytes: usize,
+    /// A flush starts a new pack once the current one reaches this size.
+    pub target_pack_bytes: usize,
+    /// Objects larger than this are uploaded in parts.
+    pub multipart_threshold_bytes: usize,
+    pub multipart_part_bytes: usize,
+    /// Requests in flight at once for bulk loads, flushes and multipart uploads.
+    pub max_parallel_requests: usize,
+    /// Directory for the on-disk read-through cache; `None` disables it.
+    pub cache_dir: Option<PathBuf>,
+}
+
+impl Default for CloudOptions {
+    fn default() -> Self {
+        Self {
+            prefix: "acorndb".into(),
+            flush_threshold: 256,
+            pack_threshold_bytes: 64 * 1024,
+            target_pack_bytes: 8 * 1024 * 1024,
+            multipart_threshold_bytes: 16 * 1024 * 1024,
+            multipart_part_bytes: 8 * 1024 * 1024,
+            max_parallel_requests: 16,
+            cache_dir: None,
+        }
+    }
+}
+
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct CloudStats {
+    pub buffered_writes: usize,
+    pub packs_written: u64,
+    pub objects_written: u64,
+    pub index_files_loaded: u64,
+    pub cache_hits: u64,
+    pub cache_revalidated: u64,
+    pub cache_downloads: u64,
+}
+
+/// Trunk over any [`ObjectStore`]. Cloning shares the buffer, index and cache.
+#[derive(Debug)]
+pub struct CloudTrunk<S: ObjectStore> {
+    shared: Arc<Shared<S>>,
+}
+
+impl<S: ObjectStore> Clone for CloudTrunk<S> {
+    fn clone(&self) -> Self {
+        Self {
+            shared: self.shared.clone(),
+        }
+    }
+}
+
+#[derive(Debug)]
+struct Shared<S> {
+    store: S,
+    options: CloudOptions,
+    cache: Option<DiskCache>,
+    state: RwLock<State>,
+    flush_lock: tokio::sync::Mutex<()>,
+    packs_written: AtomicU64,
+    objects_written: AtomicU64,
+    index_files_loaded: AtomicU64,
+}
+
+#[derive(Debug, Default)]
+struct State {
+    branches: HashMap<BranchId, BranchState>,
+    next_write: u64,
+}
+
+#[derive(Debug, Default)]
+struct BranchState {
+    index: BranchIndex,
+    pending: HashMap<String, Pending>,
+}
+
+/// A buffered write; `value: None` is a delete carrying the version it removed.
+#[derive(Debug, Clone)]
+struct Pending {
+    value: Option<Vec<u8>>,
+    version: u64,
+    write: u64,
+}
+
+impl BranchState {
+    fn current_version(&self, key: &str) -> Option<u64> {
+        match self.pending.get(key) {
+            Some(pending) => pending.value.as_ref().map(|_| pending.version),
+            None => self
+                .index
+                .entries
+                .get(key)
+                .filter(|entry| entry.location != Location::Deleted)
+                .map(|entry| entry.version),
+        }
+    }
+}
+
+impl<S: ObjectStore> CloudTrunk<S> {
+    pub fn new(store: S, options: CloudOptions) -> AcornResult<Self> {
+        let cache = options.cache_dir.as_deref().map(DiskCache::open).transpose()?;
+        Ok(Self {
+            shared: Arc::new(Shared {
+                store,
+                options,
+                cache,
+                state: RwLock::new(State::default()),
+                flush_lock: tokio::sync::Mutex::new(()),
+                packs_written: AtomicU64::new(0),
+                objects_written: AtomicU64::new(0),
+                index_files_loaded: AtomicU64::new(0),
+            }),
+        })
+    }
+
+    pub fn store(&self) -> &S {
+        &self.shared.store
+    }
+
+    pub fn stats(&self) -> CloudStats {
+        let shared = &self.shared;
+        let cache = shared.cache.as_ref();
+        CloudStats {
+            buffered_writes: shared.buffered_writes(),
+            packs_written: shared.packs_written.load(Ordering::Relaxed),
+            objects_written: shared.objects_written.load(Ordering::Relaxed),
+            index_files_loaded: shared.index_files_loaded.load(Ordering::Relaxed),
+            cache_hits: cache.map_or(0, DiskCache::hits),
+            cache_revalidated: cache.map_or(0, DiskCache::revalidated),
+            cache_downloads: cache.map_or(0, DiskCache::downloads),
+        }
+    }
+
+    /// Write every buffered put and delete.
+    pub async fn flush_async(&self) -> AcornResult<()> {
+        let shared = self.shared.clone();
+        run_io(async move { shared.flush().await }).await
+    }
+
+    pub fn flush(&self) -> AcornResult<()> {
+        let shared = self.shared.clone();
+        block_on_io(async move { shared.flush().await })
+    }
+
+    pub async fn get_async(&self, branch: &BranchId, key: &str) -> AcornResult<Option<Vec<u8>>> {
+        let (shared, branch, key) = (self.shared.clone(), branch.clone(), key.to_string());
+        run_io(async move { shared.get(&branch, &key).await }).await
+    }
+
+    /// Values of `keys` that exist, fetching packs and objects in parallel.
+    pub async fn get_many(
+        &self,
+        branch: &BranchId,
+        keys: &[String],
+    ) -> AcornResult<HashMap<String, Vec<u8>>> {
+        let (shared, branch, keys) = (self.shared.clone(), branch.clone(), keys.to_vec());
+        run_io(async move { shared.get_many(&branch, keys).await }).await
+    }
+
+    /// Every live key and value of `branch`, one request per pack, after picking up index files
+    /// written by other instances.
+    pub async fn load_all(&self, branch: &BranchId) -> AcornResult<Vec<(String, Vec<u8>)>> {
+        let (shared, branch) = (self.shared.clone(), branch.clone());
+        run_io(async move { shared.load_all(&branch).await }).await
+    }
+
+    /// Fold `branch`'s index files and packs into as few as `target_pack_bytes` allows,
+    /// dropping values that later writes replaced. Returns how many index files were replaced.
+    /// Other instances see the new packs after their next `refresh` or `load_all`.
+    pub async fn compact_async(&self, branch: &BranchId) -> AcornResult<usize> {
+        let (shared, branch) = (self.shared.clone(), branch.clone());
+        run_io(async move { shared.compact(&branch).await }).await
+    }
+
+    pub fn compact(&self, branch: &BranchId) -> AcornResult<usize> {
+        let (shared, branch) = (self.shared.clone(), branch.clone());
+        block_on_io(async move { shared.compact(&branch).await })
+    }
+
+    /// Pick up index files written by other instances since the index was loaded.
+    pub async fn refresh(&self, branch: &BranchId) -> AcornResult<()> {
+        let (shared, branch) = (self.shared.clone(), branch.clone());
+        run_io(async move { shared.refresh_index(&branch).await }).await
+    }
+
+    fn write(
+        &self,
+        branch: &BranchId,
+        key: &str,
+        value: Option<Vec<u8>>,
+        expected: Option<u64>,
+    ) -> AcornResult<()> {
+        let (shared, branch, key) = (self.shared.clone(), branch.clone(), key.to_string());
+        block_on_io(async move { shared.write(&branch, &key, value, expected).await })
+    }
+}
+
+impl<S: ObjectStore> Drop for CloudTrunk<S> {
+    fn drop(&mut self) {
+        // Last handle: write what is still buffered
+        if Arc::strong_count(&self.shared) == 1 && self.shared.buffered_writes() > 0 {
+            if let Err(err) = self.flush() {
+                tracing::warn!(error = %err, "failed to flush cloud trunk on drop");
+            }
+        }
+    }
+}
+
+impl<S: ObjectStore> Shared<S> {
+    fn parallel(&self) -> usize {
+        self.options.max_parallel_requests.max(1)
+    }
+
+    fn buffered_writes(&self) -> usize {
+        let state = self.state.read();
+        state.branches.values().map(|branch| branch.pending.len()).sum()
+    }
+
+    fn branch_prefix(&self, branch: &BranchId) -> String {
+        format!("{}/{}", self.options.prefix, escape(branch.as_str()))
+    }
+
+    fn packs_prefix(&self, branch: &BranchId) -> String {
+        format!("{}/packs/", self.branch_prefix(branch))
+    }
+
+    fn object_key(&self, branch: &BranchId, key: &str) -> String {
+        format!("{}/objects/{}", self.branch_prefix(branch), escape(key))
+    }
+
+    async fn ensure_index(&self, branch: &BranchId) -> AcornResult<()> {
+        let loaded = self
+            .state
+            .read()
+            .branches
+            .get(branch)
+            .is_some_and(|state| state.index.loaded);
+        if loaded {
+            return Ok(());
+        }
+        self.refresh_index(branch).await
+    }
+
+    async fn refresh_index(&self, branch: &BranchId) -> AcornResult<()> {
+        let keys = self.store.list(&self.packs_prefix(branch)).await?;
+        let unapplied: Vec<String> = {
+            let state = self.state.read();
+            let applied = state.branches.get(branch).map(|state| &state.index.applied);
+            keys.into_iter()
+                .filter(|key| key.ends_with(".idx") && !applied.is_some_and(|applied| applied.contains(key)))
+                .collect()
+        };
+
+        let files: Vec<(String, IndexFile)> = stream::iter(unapplied)
+            .map(|key| async move {
+                let file = match self.fetch_immutable(&key).await? {
+                    Some(bytes) => Some(IndexFile::decode(&bytes)?),
+                    None => None,
+                };
+                Ok::<_, AcornError>(file.map(|file| (key, file)))
+            })
+            .buffer_unordered(self.parallel())
+            .try_filter_map(|file| async move { Ok(file) })
+            .try_collect()
+            .await?;
+
+        let mut state = self.state.write();
+        let index = &mut state.branches.entry(branch.clone()).or_default().index;
+        for (key, file) in &files {
+            index.apply(key, file);
+        }
+        index.loaded = true;
+        self.index_files_loaded
+            .fetch_add(files.len() as u64, Ordering::Relaxed);
+        Ok(())
+    }
+
+    async fn get(&self, branch: &BranchId, key: &str) -> AcornResult<Option<Vec<u8>>> {
+        self.ensure_index(branch).await?;
+        let location = {
+            let state = self.state.read();
+            let Some(branch_state) = state.branches.get(branch) else {
+                return Ok(None);
+            };
+            if let Some(pending) = branch_state.pending.get(key) {
+                return Ok(pending.value.clone());
+            }
+            match branch_state.index.entries.get(key) {
+                Some(entry) => entry.location.clone(),
+                None => return Ok(None),
+            }
+        };
+
+        match location {
+            Location::Deleted => Ok(None),
+            Location::Packed { pack, offset, len } => self.read_packed(&pack, offset, len).await.map(Some),
+            Location::Object(object) => self.fetch_object(&object).await.map(Some),
+        }
+    }
+
+    async fn get_many(&self, branch: &BranchId, keys: Vec<String>) -> AcornResult<HashMap<String, Vec<u8>>> {
+        self.ensure_index(branch).await?;
+        let mut found = HashMap::new();
+        let mut packs: HashMap<String, Vec<(String, u64, u64)>> = HashMap::new();
+        let mut objects = Vec::new();
+        {
+            let state = self.state.read();
+            let Some(branch_state) = state.branches.get(branch) else {
+                return Ok(found);
+            };
+            for key in keys {
+                if let Some(pending) = branch_state.pending.get(&key) {
+                    if let Some(value) = &pending.value {
+                        found.insert(key, value.clone());
+                    }
+                    continue;
+                }
+                match branch_state.index.entries.get(&key).map(|entry| &entry.location) {
+                    Some(Location::Packed { pack, offset, len }) => {
+                        packs.entry(pack.clone()).or_default().push((key, *offset, *len))
+                    }
+                    Some(Location::Object(object)) => objects.push((key, object.clone())),
+                    Some(Location::Deleted) | None => {}
+                }
+            }
+        }
+
+        // One range GET for a lone key, otherwise the whole pack once
+        let packed: Vec<Vec<(String, Vec<u8>)>> = stream::iter(packs)
+            .map(|(pack, mut wanted)| async move {
+                if wanted.len() == 1 {
+                    let (key, offset, len) = wanted.remove(0);
+                    return Ok(vec![(key, self.read_packed(&pack, offset, len).await?)]);
+                }
+                let bytes = self.fetch_immutable(&pack).await?.ok_or_else(|| missing(&pack))?;
+                wanted
+                    .into_iter()
+                    .map(|(key, offset, len)| Ok((key, store::slice(&bytes, offset, len)?)))
+                    .collect::<AcornResult<Vec<_>>>()
+            })
+            .buffer_unordered(self.parallel())
+            .try_collect()
+            .await?;
+        found.extend(packed.into_iter().flatten());
+
+        let large: Vec<(String, Vec<u8>)> = stream::iter(objects)
+            .map(|(key, object)| async move { Ok::<_, AcornError>((key, self.fetch_object(&object).await?)) })
+            .buffer_unordered(self.parallel())
+            .try_collect()
+            .await?;
+        found.extend(large);
+        Ok(found)
+    }
+
+    async fn load_all(&self, branch: &BranchId) -> AcornResult<Vec<(String, Vec<u8>)>> {
+        self.refresh_index(branch).await?;
+        let keys = self.live_keys(branch);
+        let mut all: Vec<_> = self.get_many(branch, keys).await?.into_iter().collect();
+        all.sort_by(|a, b| a.0.cmp(&b.0));
+        Ok(all)
+    }
+
+    fn live_keys(&self, branch: &BranchId) -> Vec<String> {
+        let state = self.state.read();
+        let Some(branch_state) = state.branches.get(branch) else {
+            return Vec::new();
+        };
+        let mut keys: Vec<String> = branch_state
+            .index
+            .live()
+            .filter(|(key, _)| !branch_state.pending.contains_key(*key))
+            .map(|(key, _)| key.clone())
+            .chain(
+                branch_state
+                    .pending
+                    .iter()
+                    .filter(|(_, pending)| pending.value.is_some())
+                    .map(|(key, _)| key.clone()),
+            )
+            .collect();
+        keys.sort();
+        keys
+    }
+
+    /// Buffer a put (`Some`) or delete (`None`), enforcing `expected` when given, and flush once
+    /// `flush_threshold` writes are buffered.
+    async fn write(
+        &self,
+        branch: &BranchId,
+        key: &str,
+        value: Option<Vec<u8>>,
+        expected: Option<u64>,
+    ) -> AcornResult<()> {
+        self.ensure_index(branch).await?;
+        let buffered = {
+            let mut state = self.state.write();
+            state.next_write += 1;
+            let write = state.next_write;
+            let branch_state = state.branches.entry(branch.clone()).or_default();
+            let current = branch_state.current_version(key);
+            if let Some(expected) = expected {
+                if current != Some(expected) {
+                    return Err(AcornError::VersionConflict {
+                        expected: Some(expected),
+                        actual: current,
+                    });
+                }
+            }
+            let version = match (&value, current) {
+                (Some(_), current) => current.unwrap_or(0).saturating_add(1),
+                (None, Some(current)) => current,
+                (None, None) => return Err(AcornError::MissingKey(key.to_string())),
+            };
+            branch_state.pending.insert(
+                key.to_string(),
+                Pending {
+                    value,
+                    version,
+                    write,
+                },
+            );
+            state
+                .branches
+                .values()
+                .map(|branch| branch.pending.len())
+                .sum::<usize>()
+        };
+
+        if buffered >= self.options.flush_threshold.max(1) {
+            self.flush().await?;
+        }
+        Ok(())
+    }
+
+    async fn flush(&self) -> AcornResult<()> {
+        let _flushing = self.flush_lock.lock().await;
+        let snapshot: Vec<(BranchId, Vec<(String, Pending)>)> = {
+            let state = self.state.read();
+            state
+                .branches
+                .iter()
+                .filter(|(_, branch_state)| !branch_state.pending.is_empty())
+                .map(|(branch, branch_state)| {
+                    let mut writes: Vec<_> = branch_state
+                        .pending
+                        .iter()
+                        .map(|(key, pending)| (key.clone(), pending.clone()))
+                        .collect();
+                    writes.sort_by_key(|(_, pending)| pending.write);
+                    (branch.clone(), writes)
+                })
+                .collect()
+        };
+
+        for (branch, writes) in snapshot {
+            self.flush_branch(&branch, writes).await?;
+        }
+        Ok(())
+    }
+
+    /// Upload one branch's buffered writes: large objects first, then packs, then the index
+    /// files that reference them. Writes stay buffered (and readable) until their index is
+    /// applied, so a failed flush is retried by the next one.
+    async fn flush_branch(&self, branch: &BranchId, writes: Vec<(String, Pending)>) -> AcornResult<()> {
+        let mut files: Vec<(IndexFile, Vec<u8>)> = Vec::new();
+        let mut others = Vec::new();
+        let mut large = Vec::new();
+        for (key, pending) in &writes {
+            match &pending.value {
+                None => others.push(IndexEntry {
+                    key: key.clone(),
+                    version: pending.version,
+                    offset: 0,
+                    len: 0,
+                    object: None,
+                    deleted: true,
+                    sequence: None,
+                }),
+                Some(value) if value.len() > self.options.pack_threshold_bytes => {
+                    let object = self.object_key(branch, key);
+                    others.push(IndexEntry {
+                        key: key.clone(),
+                        version: pending.version,
+                        offset: 0,
+                        len: value.len() as u64,
+                        object: Some(object.clone()),
+                        deleted: false,
+                        sequence: None,
+                    });
+                    large.push((object, value));
+                }
+                Some(value) => self.pack_value(
+                    branch,
+                    &mut files,
+                    IndexEntry {
+                        key: key.clone(),
+                        version: pending.version,
+                        offset: 0,
+                        len: 0,
+                        object: None,
+                        deleted: false,
+                        sequence: None,
+                    },
+                    value,
+                ),
+            }
+        }
+        push_unpacked(&mut files, others);
+
+        // Items are indices: futures built from borrowed items would not be Send for every lifetime
+        let large = &large;
+        stream::iter(0..large.len())
+            .map(|i| async move {
+                let (object, value) = (&large[i].0, large[i].1);
+                let etag = self.put(object, value.clone()).await?;
+                if let Some(cache) = &self.cache {
+                    cache.store(object, value, etag.as_deref());
+                }
+                self.objects_written.fetch_add(1, Ordering::Relaxed);
+                Ok::<_, AcornError>(())
+            })
+            .buffer_unordered(self.parallel())
+            .try_collect::<Vec<()>>()
+            .await?;
+
+        let prefix = self.packs_prefix(branch);
+        self.upload_files(&prefix, &files).await?;
+
+        // Committed: apply the index files and drop the writes nobody replaced meanwhile
+        let stale_objects: Vec<String> = {
+            let mut state = self.state.write();
+            let branch_state = state.branches.entry(branch.clone()).or_default();
+            let stale = writes
+                .iter()
+                .filter(|(_, pending)| pending.value.is_none())
+                .filter_map(|(key, _)| {
+                    match branch_state.index.entries.get(key).map(|entry| &entry.location) {
+                        Some(Location::Object(object)) => Some(object.clone()),
+                        _ => None,
+                    }
+                })
+                .collect();
+            for (file, _) in &files {
+                branch_state
+                    .index
+                    .apply(&format!("{prefix}{}.idx", file.sequence), file);
+            }
+            for (key, pending) in &writes {
+                if branch_state
+                    .pending
+                    .get(key)
+                    .is_some_and(|current| current.write == pending.write)
+                {
+                    branch_state.pending.remove(key);
+                }
+            }
+            stale
+        };
+
+        for object in stale_objects {
+            if let Err(err) = self.store.delete(&object).await {
+                tracing::warn!(object, error = %err, "failed to delete object of a deleted key");
+            }
+            if let Some(cache) = &self.cache {
+                cache.invalidate(&object);
+            }
+        }
+        Ok(())
+    }
+
+    /// Append `value` to the last pack of `files`, starting a new one when it would grow past
+    /// `target_pack_bytes`; `entry` gets the value's offset and length.
+    fn pack_value(
+        &self,
+        branch: &BranchId,
+        files: &mut Vec<(IndexFile, Vec<u8>)>,
+        mut entry: IndexEntry,
+        value: &[u8],
+    ) {
+        let fits = files.last().is_some_and(|(file, body)| {
+            file.pack.is_some()
+                && (body.is_empty() || body.len() + value.len() <= self.options.target_pack_bytes)
+        });
+        if !fits {
+            let sequence = next_sequence();
+            let pack = format!("{}{sequence}.pack", self.packs_prefix(branch));
+            files.push((
+                IndexFile {
+                    sequence,
+                    pack: Some(pack),
+                    entries: Vec::new(),
+                },
+                Vec::new(),
+            ));
+        }
+        let (file, body) = files.last_mut().expect("pack was just started");
+        entry.offset = body.len() as u64;
+        entry.len = value.len() as u64;
+        file.entries.push(entry);
+        body.extend_from_slice(value);
+    }
+
+    /// Upload each pack followed by its index file.
+    async fn upload_files(&self, prefix: &str, files: &[(IndexFile, Vec<u8>)]) -> AcornResult<()> {
+        stream::iter(0..files.len())
+            .map(|i| {
+                let (file, body) = &files[i];
+                async move {
+                    if let Some(pack) = &file.pack {
+                        let etag = self.put(pack, body.clone()).await?;
+                        if let Some(cache) = &self.cache {
+                            cache.store(pack, body, etag.as_deref());
+                        }
+                        self.packs_written.fetch_add(1, Ordering::Relaxed);
+                    }
+                    let index_key = format!("{prefix}{}.idx", file.sequence);
+                    let bytes = file.encode()?;
+                    let etag = self.put(&index_key, bytes.clone()).await?;
+                    if let Some(cache) = &self.cache {
+                        cache.store(&index_key, &bytes, etag.as_deref());
+                    }
+                    Ok::<_, AcornError>(())
+                }
+            })
+            .buffer_unordered(self.parallel())
+            .try_collect::<Vec<()>>()
+            .await?;
+        Ok(())
+    }
+
+    /// Copy every entry that comes from an index file listed now into as few new packs and
+    /// index files as `target_pack_bytes` allows, then delete the listed index files and their
+    /// packs. Copies keep the entry's sequence, so a write that lands meanwhile, here or in
+    /// another instance, still wins. Index files go before their packs, and a pack is only
+    /// deleted along with its own index, so a pack whose index is still being uploaded
+    /// elsewhere is left alone. Tombstones are kept: they are what `tombstones()` reports.
+    async fn compact(&self, branch: &BranchId) -> AcornResult<usize> {
+        self.flush().await?;
+        let _flushing = self.flush_lock.lock().await;
+        let prefix = self.packs_prefix(branch);
+        let listed: HashSet<String> = self.store.list(&prefix).await?.into_iter().collect();
+        self.refresh_index(branch).await?;
+        let replaced: Vec<String> = listed
+            .iter()
+            .filter(|key| key.ends_with(".idx"))
+            .cloned()
+            .collect();
+        if replaced.len() < 2 {
+            return Ok(0);
+        }
+
+        let mut packed: HashMap<String, Vec<(IndexEntry, u64)>> = HashMap::new();
+        let mut others = Vec::new();
+        {
+            let state = self.state.read();
+            let index = &state.branches.get(branch).expect("index was just loaded").index;
+            for (key, entry) in &index.entries {
+                if !listed.contains(&entry.index) {
+                    continue;
+                }
+                let copy = IndexEntry {
+                    key: key.clone(),
+                    version: entry.version,
+                    offset: 0,
+                    len: 0,
+                    object: None,
+                    deleted: false,
+                    sequence: Some(entry.sequence.clone()),
+                };
+                match &entry.location {
+                    Location::Packed { pack, offset, len } => packed.entry(pack.clone()).or_default().push((
+                        IndexEntry {
+                            offset: *offset,
+                            ..copy
+                        },
+                        *len,
+                    )),
+                    Location::Object(object) => others.push(IndexEntry {
+                        object: Some(object.clone()),
+                        ..copy
+                    }),
+                    Location::Deleted => others.push(IndexEntry {
+                        deleted: true,
+                        ..copy
+                    }),
+                }
+            }
+        }
+
+        let mut packs: Vec<(String, Vec<(IndexEntry, u64)>)> = packed.into_iter().collect();
+        packs.sort_by(|a, b| a.0.cmp(&b.0));
+        let names: Vec<String> = packs.iter().map(|(pack, _)| pack.clone()).collect();
+        let bodies: Vec<Vec<u8>> = stream::iter(names)
+            .map(|pack| async move { self.fetch_immutable(&pack).await?.ok_or_else(|| missing(&pack)) })
+            .buffered(self.parallel())
+            .try_collect()
+            .await?;
+
+        let mut files = Vec::new();
+        for ((_, mut entries), body) in packs.into_iter().zip(&bodies) {
+            entries.sort_by_key(|(entry, _)| entry.offset);
+            for (entry, len) in entries {
+                let value = store::slice(body, entry.offset, len)?;
+                self.pack_value(branch, &mut files, entry, &value);
+            }
+        }
+        push_unpacked(&mut files, others);
+        self.upload_files(&prefix, &files).await?;
+
+        {
+            let mut state = self.state.write();
+            let index = &mut state.branches.entry(branch.clone()).or_default().index;
+            for (file, _) in &files {
+                index.apply(&format!("{prefix}{}.idx", file.sequence), file);
+            }
+            for key in &replaced {
+                index.applied.remove(key);
+            }
+        }
+
+        let old_packs = replaced
+            .iter()
+            .map(|key| format!("{}.pack", key.trim_end_matches(".idx")))
+            .filter(|pack| listed.contains(pack));
+        for key in replaced.iter().cloned().chain(old_packs) {
+            if let Err(err) = self.store.delete(&key).await {
+                tracing::warn!(key, error = %err, "failed to delete compacted pack object");
+            }
+            if let Some(cache) = &self.cache {
+                cache.invalidate(&key);
+            }
+        }
+        Ok(replaced.len())
+    }
+
+    async fn put(&self, key: &str, body: Vec<u8>) -> AcornResult<Option<String>> {
+        put_object(
+            &self.store,
+            key,
+            body,
+            self.options.multipart_threshold_bytes,
+            self.options.multipart_part_bytes,
+            self.parallel(),
+        )
+        .await
+    }
+
+    /// Packs and index files: never rewritten, so a cached copy is used as is.
+    async fn fetch_immutable(&self, key: &str) -> AcornResult<Option<Vec<u8>>> {
+        if let Some(cache) = &self.cache {
+            return cache.get_immutable(&self.store, key).await;
+        }
+        match self.store.get(key, None).await? {
+            GetResult::Body { bytes, .. } => Ok(Some(bytes)),
+            _ => Ok(None),
+        }
+    }
+
+    /// Large objects are rewritten in place, so a cached copy is revalidated by ETag.
+    async fn fetch_object(&self, key: &str) -> AcornResult<Vec<u8>> {
+        let bytes = match &self.cache {
+            Some(cache) => cache.get_validated(&self.store, key).await?,
+            None => match self.store.get(key, None).await? {
+                GetResult::Body { bytes, .. } => Some(bytes),
+                _ => None,
+            },
+        };
+        bytes.ok_or_else(|| missing(key))
+    }
+
+    async fn read_packed(&self, pack: &str, offset: u64, len: u64) -> AcornResult<Vec<u8>> {
+        if let Some(bytes) = self
+            .cache
+            .as_ref()
+            .and_then(|cache| cache.read_range(pack, offset, len))
+        {
+            return Ok(bytes);
+        }
+        self.store
+            .get_range(pack, offset, len)
+            .await?
+            .ok_or_else(|| missing(pack))
+    }
+}
+
+/// List large objects and tombstones in an index file without a pack.
+fn push_unpacked(files: &mut Vec<(IndexFile, Vec<u8>)>, entries: Vec<IndexEntry>) {
+    if !entries.is_empty() {
+        files.push((
+            IndexFile {
+                sequence: next_sequence(),
+                pack: None,
+                entries,
+            },
+            Vec::new(),
+        ));
+    }
+}
+
+fn missing(key: &str) -> AcornError {
+    AcornError::Trunk(format!("object {key} is referenced by the index but missing"))
+}
+
+fn io_runtime() -> AcornResult<&'static tokio::runtime::Runtime> {
+    static RUNTIME: OnceLock<Result<tokio::runtime::Runtime, String>> = OnceLock::new();
+    RUNTIME
+        .get_or_init(|| {
+            tokio::runtime::Builder::new_multi_thread()
+                .worker_threads(2)
+                .thread_name("acorn-cloud-io")
+                .enable_all()
+                .build()
+                .map_err(|e| e.to_string())
+        })
+        .as_ref()
+        .map_err(|e| AcornError::Trunk(e.clone()))
+}
+
+/// Run `fut` on the I/O runtime (the HTTP clients need tokio) and wait for it from any executor.
+async fn run_io<F, T>(fut: F) -> AcornResult<T>
+where
+    F: Future<Output = AcornResult<T>> + Send + 'static,
+    T: Send + 'static,
+{
+    io_runtime()?
+        .spawn(fut)
+        .await
+        .map_err(|e| AcornError::Trunk(e.to_string()))?
+}
+
+/// Blocking form of [`run_io`] for the synchronous trunk traits. A multi-threaded runtime's
+/// worker hands its other tasks off with `block_in_place` first. A current-thread runtime
+/// cannot, so its thread parks on a channel while the I/O runtime does the work.
+fn block_on_io<F, T>(fut: F) -> AcornResult<T>
+where
+    F: Future<Output = AcornResult<T>> + Send + 'static,
+    T: Send + 'static,
+{
+    use tokio::runtime::{Handle, RuntimeFlavor};
+
+    let runtime = io_runtime()?;
+    match Handle::try_current() {
+        Err(_) => runtime.block_on(fut),
+        Ok(handle) if handle.runtime_flavor() == RuntimeFlavor::MultiThread => {
+            tokio::task::block_in_place(|| runtime.block_on(fut))
+        }
+        Ok(_) => {
+            let (tx, rx) = std::sync::mpsc::channel();
+            runtime.spawn(async move {
+                let _ = tx.send(fut.await);
+            });
+            rx.recv().map_err(|e| AcornError::Trunk(e.to_string()))?
+        }
+    }
+}
+
+impl<S: ObjectStore> Trunk<Vec<u8>> for CloudTrunk<S> {
+    fn get(&self, branch: &BranchId, key: &str) -> AcornResult<Option<Nut<Vec<u8>>>> {
+        let (shared, branch, key) = (self.shared.clone(), branch.clone(), key.to_string());
+        let value = block_on_io(async move { shared.get(&branch, &key).await })?;
+        Ok(value.map(|value| Nut { value }))
+    }
+
+    fn put(&self, branch: &BranchId, key: &str, nut: Nut<Vec<u8>>) -> AcornResult<()> {
+        self.write(branch, key, Some(nut.value), None)
+    }
+
+    fn delete(&self, branch: &BranchId, key: &str) -> AcornResult<()> {
+        self.write(branch, key, None, None)
+    }
+
+    fn version(&self, branch: &BranchId, key: &str) -> Option<u64> {
+        let (shared, owned) = (self.shared.clone(), branch.clone());
+        let loaded = block_on_io(async move { shared.ensure_index(&owned).await });
+        if let Err(err) = loaded {
+            tracing::warn!(error = %err, "failed to load cloud index");
+            return None;
+        }
+        let state = self.shared.state.read();
+        state.branches.get(branch)?.current_version(key)
+    }
+
+    fn put_if_version(
+        &self,
+        branch: &BranchId,
+        key: &str,
+        expected: Option<u64>,
+        nut: Nut<Vec<u8>>,
+    ) -> AcornResult<()> {
+        self.write(branch, key, Some(nut.value), expected)
+    }
+
+    fn delete_if_version(&self, branch: &BranchId, key: &str, expected: Option<u64>) -> AcornResult<()> {
+        self.write(branch, key, None, expected)
+    }
+
+    fn capabilities(&self) -> &'static [TrunkCapability] {
+        &[TrunkCapability::Versions]
+    }
+}
+
+impl<S: ObjectStore> KeyedTrunk<Vec<u8>> for CloudTrunk<S> {
+    fn keys(&self, branch: &BranchId) -> Vec<String> {
+        let (shared, owned) = (self.shared.clone(), branch.clone());
+        if let Err(err) = block_on_io(async move { shared.ensure_index(&owned).await }) {
+            tracing::warn!(error = %err, "failed to load cloud index");
+        }
+        self.shared.live_keys(branch)
+    }
+}
+
+impl<S: ObjectStore> TombstoneProvider<Vec<u8>> for CloudTrunk<S> {
+    fn tombstones(&self, branch: &BranchId) -> Vec<(String, Option<u64>)> {
+        let state = self.shared.state.read();
+        let Some(branch_state) = state.branches.get(branch) else {
+            return Vec::new();
+        };
+        let committed = branch_state
+            .index
+            .entries
+            .iter()
+            .filter(|(key, entry)| {
+                entry.location == Location::Deleted && !branch_state.pending.contains_key(*key)
+            })
+            .map(|(key, entry)| (key.clone(), Some(entry.version)));
+        let buffered = branch_state
+            .pending
+            .iter()
+            .filter(|(_, pending)| pending.value.is_none())
+            .map(|(key, pending)| (key.clone(), Some(pending.version)));
+        committed.chain(buffered).collect()
+    }
+}
+
+impl<S: ObjectStore> CapabilityAdvertiser for CloudTrunk<S> {
+    fn capabilities(&self) -> &'static [TrunkCapability] {
+        &[TrunkCapability::Versions]
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[cfg(feature = "contract-tests")]
+    use acorn_test_harness::TrunkContract;
+
+    fn options() -> CloudOptions {
+        CloudOptions {
+            prefix: "test".into(),
+            flush_threshold: 10_000,
+            pack_threshold_bytes: 512,
+            ..CloudOptions::default()
+        }
+    }
+
+    fn trunk(
+        store: &Arc<InMemoryObjectStore>,
+        options: CloudOptions,
+    ) -> CloudTrunk<Arc<InMemoryObjectStore>> {
+        CloudTrunk::new(store.clone(), options).unwrap()
+    }
+
+    fn nut(value: &[u8]) -> Nut<Vec<u8>> {
+        Nut {
+            value: value.to_vec(),
+        }
+    }
+
+    fn temp_dir(name: &str) -> PathBuf {
+        let dir = std::env::temp_dir().join(format!("acorn-cloud-{name}-{}", next_sequence()));
+        let _ = std::fs::remove_dir_all(&dir);
+        dir
+    }
+
+    #[cfg(feature = "contract-tests")]
+    #[test]
+    fn contract_round_trip() {
+        let store = Arc::new(InMemoryObjectStore::new());
+        let trunk = trunk(&store, options());
+        TrunkContract::round_trip_bytes(&trunk).unwrap();
+        TrunkContract::assert_capabilities(&trunk, &[TrunkCapability::Versions]);
+    }
+
+    #[test]
+    fn buffered_writes_are_readable_and_survive_a_new_instance() {
+        let store = Arc::new(InMemoryObjectStore::new());
+        let branch = BranchId::new("main");
+        let writer = trunk(&store, options());
+        writer.put(&branch, "a", nut(b"one")).unwrap();
+        writer.put(&branch, "b", nut(b"two")).unwrap();
+        writer.put(&branch, "a", nut(b"three")).unwrap();
+        writer.delete(&branch, "b").unwrap();
+
+        assert_eq!(writer.get(&branch, "a").unwrap().unwrap().value, b"three");
+        assert!(writer.get(&branch, "b").unwrap().is_none());
+        assert_eq!(store.counters().puts, 0);
+        assert_eq!(writer.stats().buffered_writes, 2);
+
+        writer.flush().unwrap();
+        assert_eq!(writer.stats().buffered_writes, 0);
+
+        let reader = trunk(&store, options());
+        assert_eq!(reader.get(&branch, "a").unwrap().unwrap().value, b"three");
+        assert!(reader.get(&branch, "b").unwrap().is_none());
+        assert_eq!(reader.version(&branch, "a"), Some(2));
+        assert_eq!(reader.tombstones(&branch), vec![("b".to_string(), Some(1))]);
+        assert_eq!(reader.keys(&branch), vec!["a".to_string()]);
+    }
+
+    #[test]
+    fn load_all_takes_one_request_per_pack() {
+        let store = Arc::new(InMemoryObjectStore::new());
+        let branch = BranchId::new("bulk");
+        let writer = trunk(
+            &store,
+            CloudOptions {
+                target_pack_bytes: 2048,
+                ..options()
+            },
+        );
+        for i in 0..500 {
+            writer
+                .put(
+                    &branch,
+                    &format!("key-{i:03}"),
+                    nut(format!("value {i}").as_bytes()),
+                )
+                .unwrap();
+        }
+        writer.flush().unwrap();
+        let packs = writer.stats().packs_written;
+        assert!(packs > 1 && packs < 10, "{packs} packs");
+        assert_eq!(store.keys().len() as u64, packs * 2);
+
+        let reader = trunk(&store, options());
+        let before = store.counters();
+        let all = futures::executor::block_on(reader.load_all(&branch)).unwrap();
+        let after = store.counters();
+
+        assert_eq!(all.len(), 500);
+        assert_eq!(all[42], ("key-042".to_string(), b"value 42".to_vec()));
+        assert_eq!(after.gets - before.gets, packs * 2);
+        assert_eq!(after.range_gets, before.range_gets);
+    }
+
+    #[test]
+    fn single_reads_are_range_requests() {
+        let store = Arc::new(InMemoryObjectStore::new());
+        let branch = BranchId::new("range");
+        let writer = trunk(&store, options());
+        for i in 0..50 {
+            writer
+                .put(&branch, &format!("k{i}"), nut(&[i as u8; 16]))
+                .unwrap();
+        }
+        writer.flush().unwrap();
+
+        let reader = trunk(&store, options());
+        assert_eq!(reader.get(&branch, "k7").unwrap().unwrap().value, vec![7u8; 16]);
+        assert_eq!(reader.get(&branch, "k49").unwrap().unwrap().value, vec![49u8; 16]);
+        let counters = store.counters();
+        assert_eq!(counters.range_gets, 2);
+        assert_eq!(counters.gets, 1); // The index file
+
+        let many = futures::executor::block_on(reader.get_many(
+            &branch,
+            &["k1".to_string(), "k2".to_string(), "missing".to_string()],
+        ))
+        .unwrap();
+        assert_eq!(many.len(), 2);
+        assert_eq!(store.counters().gets, 2); // Two keys of one pack: the pack, once
+    }
+
+    #[test]
+    fn large_values_use_parallel_multipart_uploads() {
+        let store = Arc::new(InMemoryObjectStore::new());
+        let branch = BranchId::new("large");
+        let writer = trunk(
+            &store,
+            CloudOptions {
+                multipart_threshold_bytes: 1024,
+                multipart_part_bytes: 256,
+                ..options()
+            },
+        );
+        let big: Vec<u8> = (0..4096u32).map(|i| (i % 251) as u8).collect();
+        writer.put(&branch, "big", nut(&big)).unwrap();
+        writer.put(&branch, "small", nut(b"s")).unwrap();
+        writer.flush().unwrap();
+
+        assert_eq!(store.counters().parts, 16);
+        assert_eq!(store.open_uploads(), 0);
+        assert!(store.keys().contains(&"test/large/objects/big".to_string()));
+
+        let reader = trunk(&store, options());
+        assert_eq!(reader.get(&branch, "big").unwrap().unwrap().value, big);
+        let all = futures::executor::block_on(reader.load_all(&branch)).unwrap();
+        assert_eq!(all.len(), 2);
+
+        // Deleting a large value removes its object once the tombstone is committed
+        reader.delete(&branch, "big").unwrap();
+        reader.flush().unwrap();
+        assert!(!store.keys().contains(&"test/large/objects/big".to_string()));
+        assert!(trunk(&store, options()).get(&branch, "big").unwrap().is_none());
+    }
+
+    #[test]
+    fn versions_are_checked_against_committed_and_buffered_writes() {
+        let store = Arc::new(InMemoryObjectStore::new());
+        let branch = BranchId::new("cas");
+        let writer = trunk(&store, options());
+        writer.put(&branch, "k", nut(b"v1")).unwrap();
+        writer.flush().unwrap();
+
+        let other = trunk(&store, options());
+        assert!(matches!(
+            other.put_if_version(&branch, "k", Some(2), nut(b"v2")),
+            Err(AcornError::VersionConflict {
+                expected: Some(2),
+                actual: Some(1)
+            })
+        ));
+        other.put_if_version(&branch, "k", Some(1), nut(b"v2")).unwrap();
+        assert_eq!(other.version(&branch, "k"), Some(2));
+        assert!(other.delete_if_version(&branch, "k", Some(1)).is_err());
+        other.delete_if_version(&branch, "k", Some(2)).unwrap();
+        assert_eq!(other.version(&branch, "k"), None);
+        assert!(matches!(
+            other.delete(&branch, "k"),
+            Err(AcornError::MissingKey(_))
+        ));
+    }
+
+    #[test]
+    fn flush_threshold_and_drop_write_buffered_values() {
+        let store = Arc::new(InMemoryObjectStore::new());
+        let branch = BranchId::new("auto");
+        {
+            let writer = trunk(
+                &store,
+                CloudOptions {
+                    flush_threshold: 4,
+                    ..options()
+                },
+            );
+            for i in 0..6 {
+                writer.put(&branch, &format!("k{i}"), nut(b"v")).unwrap();
+            }
+            assert_eq!(writer.stats().packs_written, 1);
+            assert_eq!(writer.stats().buffered_writes, 2);
+        }
+
+        let reader = trunk(&store, options());
+        assert_eq!(reader.keys(&branch).len(), 6);
+    }
+
+    #[test]
+    fn disk_cache_serves_packs_and_revalidates_objects() {
+        let store = Arc::new(InMemoryObjectStore::new());
+        let branch = BranchId::new("cached");
+        let dir = temp_dir("cache");
+        let cached = CloudOptions {
+            cache_dir: Some(dir.clone()),
+            ..options()
+        };
+        let writer = trunk(&store, cached.clone());
+        for i in 0..20 {
+            writer.put(&branch, &format!("k{i}"), nut(b"small")).unwrap();
+        }
+        writer.put(&branch, "big", nut(&[1u8; 2048])).unwrap();
+        writer.flush().unwrap();
+        drop(writer);
+
+        let reader = trunk(&store, cached);
+        let before = store.counters();
+        let all = futures::executor::block_on(reader.load_all(&branch)).unwrap();
+        let after = store.counters();
+
+        assert_eq!(all.len(), 21);
+        assert_eq!(after.gets, before.gets); // Packs and index files from disk
+        assert_eq!(after.not_modified - before.not_modified, 1); // "big" revalidated
+        assert_eq!(reader.get(&branch, "k3").unwrap().unwrap().value, b"small");
+        assert_eq!(store.counters().range_gets, 0);
+        assert!(reader.stats().cache_hits >= 3);
+
+        let _ = std::fs::remove_dir_all(dir);
+    }
+
+    #[test]
+    fn compaction_folds_flushes_into_one_pack_keeping_latest_values_and_tombstones() {
+        let store = Arc::new(InMemoryObjectStore::new());
+        let branch = BranchId::new("compact");
+        let writer = trunk(&store, options());
+        for round in 0..3u8 {
+            for i in 0..10 {
+                writer.put(&branch, &format!("k{i}"), nut(&[round; 8])).unwrap();
+            }
+            writer.flush().unwrap();
+        }
+        writer.delete(&branch, "k3").unwrap();
+        writer.put(&branch, "big", nut(&[9u8; 2048])).unwrap();
+        writer.flush().unwrap();
+        assert_eq!(store.keys().len(), 3 * 2 + 1 + 1); // Packs, their index files, unpacked index, big
+
+        assert_eq!(writer.compact(&branch).unwrap(), 4);
+        let keys = store.keys();
+        assert_eq!(keys.iter().filter(|key| key.ends_with(".pack")).count(), 1);
+        assert_eq!(keys.iter().filter(|key| key.ends_with(".idx")).count(), 2);
+        assert_eq!(writer.get(&branch, "k5").unwrap().unwrap().value, vec![2u8; 8]);
+
+        let reader = trunk(&store, options());
+        let all = futures::executor::block_on(reader.load_all(&branch)).unwrap();
+        assert_eq!(all.len(), 10);
+        assert_eq!(all[0], ("big".to_string(), vec![9u8; 2048]));
+        assert_eq!(reader.get(&branch, "k7").unwrap().unwrap().value, vec![2u8; 8]);
+        assert_eq!(reader.version(&branch, "k7"), Some(3));
+        assert_eq!(reader.tombstones(&branch), vec![("k3".to_string(), Some(3))]);
+
+        // Nothing left to fold
+        assert_eq!(writer.compact(&branch).unwrap(), 2);
+        assert_eq!(writer.compact(&branch).unwrap(), 2);
+        assert_eq!(store.keys().len(), keys.len());
+    }
+
+    #[test]
+    fn writes_after_compaction_win_and_other_instances_follow_on_refresh() {
+        let store = Arc::new(InMemoryObjectStore::new());
+        let branch = BranchId::new("compact-shared");
+        let writer = trunk(&store, options());
+        for round in 0..2u8 {
+            writer.put(&branch, "a", nut(&[round])).unwrap();
+            writer.put(&branch, "b", nut(&[round])).unwrap();
+            writer.flush().unwrap();
+        }
+        let reader = trunk(&store, options());
+        assert_eq!(reader.get(&branch, "a").unwrap().unwrap().value, vec![1]);
+
+        writer.compact(&branch).unwrap();
+        writer.put(&branch, "a", nut(b"after")).unwrap();
+        writer.flush().unwrap();
+
+        futures::executor::block_on(reader.refresh(&branch)).unwrap();
+        assert_eq!(reader.get(&branch, "a").unwrap().unwrap().value, b"after");
+        assert_eq!(reader.get(&branch, "b").unwrap().unwrap().value, vec![1]);
+        assert_eq!(reader.version(&branch, "a"), Some(3));
+    }
+}
@@ -0,0 +1,247 @@
+use std::collections::{HashMap, HashSet};
+use std::sync::atomic::{AtomicU64, Ordering};
+use std::time::{SystemTime, UNIX_EPOCH};
+
+use acorn_core::{AcornError, AcornResult};
+use serde::{Deserialize, Serialize};
+
+/// Index file written after each pack (`{branch}/packs/{sequence}.idx`). It is uploaded last,
+/// so a flush is committed once its index exists.
+#[derive(Debug, Clone, Serialize, Deserialize)]
+pub(crate) struct IndexFile {
+    pub sequence: String,
+    #[serde(default, skip_serializing_if = "Option::is_none")]
+    pub pack: Option<String>,
+    pub entries: Vec<IndexEntry>,
+}
+
+#[derive(Debug, Clone, Serialize, Deserialize)]
+pub(crate) struct IndexEntry {
+    pub key: String,
+    pub version: u64,
+    #[serde(default)]
+    pub offset: u64,
+    #[serde(default)]
+    pub len: u64,
+    /// Object holding a value too large to pack.
+    #[serde(default, skip_serializing_if = "Option::is_none")]
+    pub object: Option<String>,
+    #[serde(default, skip_serializing_if = "std::ops::Not::not")]
+    pub deleted: bool,
+    /// Sequence of the flush that wrote the entry when it is not the file's own: compaction
+    /// copies entries into new files but keeps their sequence, so they never beat a newer write.
+    #[serde(default, skip_serializing_if = "Option::is_none")]
+    pub sequence: Option<String>,
+}
+
+impl IndexFile {
+    pub fn encode(&self) -> AcornResult<Vec<u8>> {
+        serde_json::to_vec(self).map_err(|e| AcornError::Serialization(e.to_string()))
+    }
+
+    pub fn decode(bytes: &[u8]) -> AcornResult<Self> {
+        serde_json::from_slice(bytes).map_err(|e| AcornError::Serialization(e.to_string()))
+    }
+}
+
+/// Where the current value of a key lives.
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub(crate) enum Location {
+    Packed { pack: String, offset: u64, len: u64 },
+    Object(String),
+    Deleted,
+}
+
+#[derive(Debug, Clone)]
+pub(crate) struct Entry {
+    pub sequence: String,
+    pub version: u64,
+    pub location: Location,
+    /// Index file the entry was read from.
+    pub index: String,
+}
+
+/// One branch's view of its index files. Entries from a later sequence win, so files can be
+/// applied in any order.
+#[derive(Debug, Default)]
+pub(crate) struct BranchIndex {
+    pub entries: HashMap<String, Entry>,
+    pub applied: HashSet<String>,
+    pub loaded: bool,
+}
+
+impl BranchIndex {
+    pub fn apply(&mut self, index_key: &str, file: &IndexFile) {
+        for entry in &file.entries {
+            let location = if entry.deleted {
+                Location::Deleted
+            } else if let Some(object) = &entry.object {
+                Location::Object(object.clone())
+            } else if let Some(pack) = &file.pack {
+                Location::Packed {
+                    pack: pack.clone(),
+                    offset: entry.offset,
+                    len: entry.len,
+                }
+            } else {
+                continue;
+            };
+
+            // A compacted copy has the sequence of the entry it was copied from; between the
+            // two the later index file (the copy) wins, whichever is applied first
+            let sequence = entry.sequence.as_ref().unwrap_or(&file.sequence);
+            let older = self
+                .entries
+                .get(&entry.key)
+                .is_some_and(|current| (sequence, index_key) < (&current.sequence, current.index.as_str()));
+            if !older {
+                self.entries.insert(
+                    entry.key.clone(),
+                    Entry {
+                        sequence: sequence.clone(),
+                        version: entry.version,
+                        location,
+                        index: index_key.to_string(),
+                    },
+                );
+            }
+        }
+        self.applied.insert(index_key.to_string());
+    }
+
+    pub fn live(&self) -> impl Iterator<Item = (&String, &Entry)> {
+        self.entries
+            .iter()
+            .filter(|(_, entry)| entry.location != Location::Deleted)
+    }
+}
+
+/// A sequence that sorts after every sequence this process issued before: wall-clock nanos,
+/// bumped on collisions, plus the process id to keep concurrent writers apart.
+pub(crate) fn next_sequence() -> String {
+    static LAST: AtomicU64 = AtomicU64::new(0);
+    let now = SystemTime::now()
+        .duration_since(UNIX_EPOCH)
+        .map(|d| d.as_nanos() as u64)
+        .unwrap_or(0);
+    let mut last = LAST.load(Ordering::Relaxed);
+    let nanos = loop {
+        let next = now.max(last + 1);
+        match LAST.compare_exchange_weak(last, next, Ordering::Relaxed, Ordering::Relaxed) {
+            Ok(_) => break next,
+            Err(current) => last = current,
+        }
+    };
+    format!("{nanos:020}-{:08x}", std::process::id())
+}
+
+/// Percent-encode everything but `[A-Za-z0-9._-]` so branch names and keys are safe path segments.
+pub(crate) fn escape(segment: &str) -> String {
+    let mut escaped = String::with_capacity(segment.len());
+    for byte in segment.bytes() {
+        if byte.is_ascii_alphanumeric() || matches!(byte, b'.' | b'_' | b'-') {
+            escaped.push(byte as char);
+        } else {
+            escaped.push_str(&format!("%{byte:02X}"));
+        }
+    }
+    escaped
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn file(sequence: &str, entries: Vec<IndexEntry>) -> IndexFile {
+        IndexFile {
+            sequence: sequence.into(),
+            pack: Some(format!("{sequence}.pack")),
+            entries,
+        }
+    }
+
+    fn packed(key: &str, version: u64, offset: u64) -> IndexEntry {
+        IndexEntry {
+            key: key.into(),
+            version,
+            offset,
+            len: 1,
+            object: None,
+            deleted: false,
+            sequence: None,
+        }
+    }
+
+    #[test]
+    fn later_sequences_win_in_any_order() {
+        let older = file("1", vec![packed("a", 1, 0), packed("b", 1, 1)]);
+        let mut tombstone = file("2", vec![]);
+        tombstone.entries.push(IndexEntry {
+            deleted: true,
+            ..packed("b", 1, 0)
+        });
+        let newer = file("3", vec![packed("a", 2, 7)]);
+
+        let mut index = BranchIndex::default();
+        index.apply("3.idx", &newer);
+        index.apply("2.idx", &tombstone);
+        index.apply("1.idx", &older);
+
+        assert_eq!(index.entries["a"].version, 2);
+        assert_eq!(
+            index.entries["a"].location,
+            Location::Packed {
+                pack: "3.pack".into(),
+                offset: 7,
+                len: 1
+            }
+        );
+        assert_eq!(index.entries["b"].location, Location::Deleted);
+        assert_eq!(index.live().count(), 1);
+        assert_eq!(index.applied.len(), 3);
+        assert_eq!(index.entries["a"].index, "3.idx");
+    }
+
+    #[test]
+    fn compacted_entries_keep_their_sequence() {
+        let newer = file("5", vec![packed("a", 3, 0)]);
+        let mut compacted = file("9", vec![packed("a", 2, 4), packed("b", 1, 5)]);
+        for entry in &mut compacted.entries {
+            entry.sequence = Some("4".into());
+        }
+
+        let mut index = BranchIndex::default();
+        index.apply("5.idx", &newer);
+        index.apply("9.idx", &compacted);
+        assert_eq!(index.entries["a"].version, 3);
+        assert_eq!(index.entries["b"].sequence, "4");
+        assert_eq!(index.entries["b"].index, "9.idx");
+
+        // A copy wins over the entry it was copied from in either order
+        let original = file("4", vec![packed("b", 1, 0)]);
+        for order in [["4.idx", "9.idx"], ["9.idx", "4.idx"]] {
+            let mut index = BranchIndex::default();
+            for key in order {
+                index.apply(key, if key == "4.idx" { &original } else { &compacted });
+            }
+            assert_eq!(index.entries["b"].index, "9.idx");
+        }
+    }
+
+    #[test]
+    fn index_files_round_trip() {
+        let original = file("1", vec![packed("a", 1, 0)]);
+        let decoded = IndexFile::decode(&original.encode().unwrap()).unwrap();
+        assert_eq!(decoded.sequence, "1");
+        assert_eq!(decoded.entries[0].key, "a");
+        assert!(!decoded.entries[0].deleted);
+    }
+
+    #[test]
+    fn sequences_increase_and_escape_keeps_segments_safe() {
+        let first = next_sequence();
+        let second = next_sequence();
+        assert!(second > first);
+        assert_eq!(escape("users/42 a"), "users%2F42%20a");
+    }
+}
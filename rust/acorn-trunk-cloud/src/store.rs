@@ -0,0 +1,392 @@
+use std::collections::HashMap;
+use std::sync::atomic::{AtomicU64, Ordering};
+
+use acorn_core::{AcornError, AcornResult};
+use futures::future::BoxFuture;
+use futures::stream::{self, StreamExt, TryStreamExt};
+use parking_lot::Mutex;
+
+/// Outcome of a (conditional) GET.
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub enum GetResult {
+    Body {
+        bytes: Vec<u8>,
+        etag: Option<String>,
+    },
+    /// The object still has the ETag passed as `if_none_match`.
+    NotModified,
+    Missing,
+}
+
+/// The subset of an object store (S3, Azure Blob) the cloud trunk needs.
+pub trait ObjectStore: Send + Sync + std::fmt::Debug + 'static {
+    /// Store `body` under `key`, returning the new ETag when the service reports one.
+    fn put<'a>(&'a self, key: &'a str, body: Vec<u8>) -> BoxFuture<'a, AcornResult<Option<String>>>;
+
+    fn get<'a>(
+        &'a self,
+        key: &'a str,
+        if_none_match: Option<&'a str>,
+    ) -> BoxFuture<'a, AcornResult<GetResult>>;
+
+    /// Read `len` bytes at `offset`. The default downloads the whole object.
+    fn get_range<'a>(
+        &'a self,
+        key: &'a str,
+        offset: u64,
+        len: u64,
+    ) -> BoxFuture<'a, AcornResult<Option<Vec<u8>>>> {
+        Box::pin(async move {
+            match self.get(key, None).await? {
+                GetResult::Body { bytes, .. } => slice(&bytes, offset, len).map(Some),
+                _ => Ok(None),
+            }
+        })
+    }
+
+    fn delete<'a>(&'a self, key: &'a str) -> BoxFuture<'a, AcornResult<()>>;
+
+    fn list<'a>(&'a self, prefix: &'a str) -> BoxFuture<'a, AcornResult<Vec<String>>>;
+
+    /// Smallest part the service accepts (S3 rejects parts under 5 MiB except the last).
+    fn min_part_bytes(&self) -> usize {
+        0
+    }
+
+    /// Start a multipart upload. `None` means the store has no multipart API and
+    /// [`put_object`] falls back to a single PUT.
+    fn create_multipart<'a>(&'a self, _key: &'a str) -> BoxFuture<'a, AcornResult<Option<String>>> {
+        Box::pin(async { Ok(None) })
+    }
+
+    /// Upload part `part_number` (from 1), returning the tag handed back to `complete_multipart`.
+    fn upload_part<'a>(
+        &'a self,
+        _key: &'a str,
+        _upload_id: &'a str,
+        _part_number: u32,
+        _body: Vec<u8>,
+    ) -> BoxFuture<'a, AcornResult<String>> {
+        Box::pin(async { Err(AcornError::NotImplemented) })
+    }
+
+    fn complete_multipart<'a>(
+        &'a self,
+        _key: &'a str,
+        _upload_id: &'a str,
+        _parts: Vec<(u32, String)>,
+    ) -> BoxFuture<'a, AcornResult<Option<String>>> {
+        Box::pin(async { Err(AcornError::NotImplemented) })
+    }
+
+    fn abort_multipart<'a>(&'a self, _key: &'a str, _upload_id: &'a str) -> BoxFuture<'a, AcornResult<()>> {
+        Box::pin(async { Ok(()) })
+    }
+}
+
+impl<T: ObjectStore + ?Sized> ObjectStore for std::sync::Arc<T> {
+    fn put<'a>(&'a self, key: &'a str, body: Vec<u8>) -> BoxFuture<'a, AcornResult<Option<String>>> {
+        (**self).put(key, body)
+    }
+
+    fn get<'a>(
+        &'a self,
+        key: &'a str,
+        if_none_match: Option<&'a str>,
+    ) -> BoxFuture<'a, AcornResult<GetResult>> {
+        (**self).get(key, if_none_match)
+    }
+
+    fn get_range<'a>(
+        &'a self,
+        key: &'a str,
+        offset: u64,
+        len: u64,
+    ) -> BoxFuture<'a, AcornResult<Option<Vec<u8>>>> {
+        (**self).get_range(key, offset, len)
+    }
+
+    fn delete<'a>(&'a self, key: &'a str) -> BoxFuture<'a, AcornResult<()>> {
+        (**self).delete(key)
+    }
+
+    fn list<'a>(&'a self, prefix: &'a str) -> BoxFuture<'a, AcornResult<Vec<String>>> {
+        (**self).list(prefix)
+    }
+
+    fn min_part_bytes(&self) -> usize {
+        (**self).min_part_bytes()
+    }
+
+    fn create_multipart<'a>(&'a self, key: &'a str) -> BoxFuture<'a, AcornResult<Option<String>>> {
+        (**self).create_multipart(key)
+    }
+
+    fn upload_part<'a>(
+        &'a self,
+        key: &'a str,
+        upload_id: &'a str,
+        part_number: u32,
+        body: Vec<u8>,
+    ) -> BoxFuture<'a, AcornResult<String>> {
+        (**self).upload_part(key, upload_id, part_number, body)
+    }
+
+    fn complete_multipart<'a>(
+        &'a self,
+        key: &'a str,
+        upload_id: &'a str,
+        parts: Vec<(u32, String)>,
+    ) -> BoxFuture<'a, AcornResult<Option<String>>> {
+        (**self).complete_multipart(key, upload_id, parts)
+    }
+
+    fn abort_multipart<'a>(&'a self, key: &'a str, upload_id: &'a str) -> BoxFuture<'a, AcornResult<()>> {
+        (**self).abort_multipart(key, upload_id)
+    }
+}
+
+/// Upload `body`, split into `part_bytes` parts sent `parallel` at a time once it is larger
+/// than `multipart_threshold`. A failed multipart upload is aborted so no parts are left behind.
+pub async fn put_object<S: ObjectStore + ?Sized>(
+    store: &S,
+    key: &str,
+    body: Vec<u8>,
+    multipart_threshold: usize,
+    part_bytes: usize,
+    parallel: usize,
+) -> AcornResult<Option<String>> {
+    if body.len() <= multipart_threshold {
+        return store.put(key, body).await;
+    }
+    let Some(upload_id) = store.create_multipart(key).await? else {
+        return store.put(key, body).await;
+    };
+
+    let part_bytes = part_bytes.max(store.min_part_bytes()).max(1);
+    let (body, upload_id_ref) = (&body, upload_id.as_str());
+    let part_count = body.len().div_ceil(part_bytes) as u32;
+    let uploaded: AcornResult<Vec<(u32, String)>> = stream::iter(1..=part_count)
+        .map(|part_number| async move {
+            let start = (part_number as usize - 1) * part_bytes;
+            let chunk = body[start..body.len().min(start + part_bytes)].to_vec();
+            let tag = store.upload_part(key, upload_id_ref, part_number, chunk).await?;
+            Ok((part_number, tag))
+        })
+        .buffer_unordered(parallel.max(1))
+        .try_collect()
+        .await;
+
+    let completed = match uploaded {
+        Ok(mut parts) => {
+            parts.sort_by_key(|(part_number, _)| *part_number);
+            store.complete_multipart(key, &upload_id, parts).await
+        }
+        Err(err) => Err(err),
+    };
+    if completed.is_err() {
+        if let Err(err) = store.abort_multipart(key, &upload_id).await {
+            tracing::warn!(key, error = %err, "failed to abort multipart upload");
+        }
+    }
+    completed
+}
+
+pub(crate) fn slice(bytes: &[u8], offset: u64, len: u64) -> AcornResult<Vec<u8>> {
+    let start = usize::try_from(offset).map_err(|_| range_err(offset, len))?;
+    let end = start
+        .checked_add(usize::try_from(len).map_err(|_| range_err(offset, len))?)
+        .filter(|end| *end <= bytes.len())
+        .ok_or_else(|| range_err(offset, len))?;
+    Ok(bytes[start..end].to_vec())
+}
+
+fn range_err(offset: u64, len: u64) -> AcornError {
+    AcornError::Trunk(format!("range {offset}+{len} is outside the object"))
+}
+
+/// Request counters, for tests and diagnostics.
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct StoreCounters {
+    pub puts: u64,
+    pub gets: u64,
+    pub range_gets: u64,
+    pub not_modified: u64,
+    pub parts: u64,
+    pub lists: u64,
+}
+
+/// Key and parts of an upload in progress.
+type Upload = (String, HashMap<u32, Vec<u8>>);
+
+/// Object store held in memory, with ETags, ranges and multipart uploads.
+#[derive(Debug, Default)]
+pub struct InMemoryObjectStore {
+    objects: Mutex<HashMap<String, (Vec<u8>, String)>>,
+    uploads: Mutex<HashMap<String, Upload>>,
+    next_etag: AtomicU64,
+    puts: AtomicU64,
+    gets: AtomicU64,
+    range_gets: AtomicU64,
+    not_modified: AtomicU64,
+    parts: AtomicU64,
+    lists: AtomicU64,
+}
+
+impl InMemoryObjectStore {
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    pub fn keys(&self) -> Vec<String> {
+        let mut keys: Vec<_> = self.objects.lock().keys().cloned().collect();
+        keys.sort();
+        keys
+    }
+
+    pub fn counters(&self) -> StoreCounters {
+        StoreCounters {
+            puts: self.puts.load(Ordering::Relaxed),
+            gets: self.gets.load(Ordering::Relaxed),
+            range_gets: self.range_gets.load(Ordering::Relaxed),
+            not_modified: self.not_modified.load(Ordering::Relaxed),
+            parts: self.parts.load(Ordering::Relaxed),
+            lists: self.lists.load(Ordering::Relaxed),
+        }
+    }
+
+    /// Uploads started but neither completed nor aborted.
+    pub fn open_uploads(&self) -> usize {
+        self.uploads.lock().len()
+    }
+
+    fn store(&self, key: &str, body: Vec<u8>) -> String {
+        let etag = format!("\"{}\"", self.next_etag.fetch_add(1, Ordering::Relaxed) + 1);
+        self.objects.lock().insert(key.to_string(), (body, etag.clone()));
+        etag
+    }
+}
+
+impl ObjectStore for InMemoryObjectStore {
+    fn put<'a>(&'a self, key: &'a str, body: Vec<u8>) -> BoxFuture<'a, AcornResult<Option<String>>> {
+        self.puts.fetch_add(1, Ordering::Relaxed);
+        Box::pin(async move { Ok(Some(self.store(key, body))) })
+    }
+
+    fn get<'a>(
+        &'a self,
+        key: &'a str,
+        if_none_match: Option<&'a str>,
+    ) -> BoxFuture<'a, AcornResult<GetResult>> {
+        let result = match self.objects.lock().get(key) {
+            None => GetResult::Missing,
+            Some((_, etag)) if Some(etag.as_str()) == if_none_match => {
+                self.not_modified.fetch_add(1, Ordering::Relaxed);
+                GetResult::NotModified
+            }
+            Some((bytes, etag)) => {
+                self.gets.fetch_add(1, Ordering::Relaxed);
+                GetResult::Body {
+                    bytes: bytes.clone(),
+                    etag: Some(etag.clone()),
+                }
+            }
+        };
+        Box::pin(async move { Ok(result) })
+    }
+
+    fn get_range<'a>(
+        &'a self,
+        key: &'a str,
+        offset: u64,
+        len: u64,
+    ) -> BoxFuture<'a, AcornResult<Option<Vec<u8>>>> {
+        self.range_gets.fetch_add(1, Ordering::Relaxed);
+        let result = self
+            .objects
+            .lock()
+            .get(key)
+            .map(|(bytes, _)| slice(bytes, offset, len))
+            .transpose();
+        Box::pin(async move { result })
+    }
+
+    fn delete<'a>(&'a self, key: &'a str) -> BoxFuture<'a, AcornResult<()>> {
+        self.objects.lock().remove(key);
+        Box::pin(async { Ok(()) })
+    }
+
+    fn list<'a>(&'a self, prefix: &'a str) -> BoxFuture<'a, AcornResult<Vec<String>>> {
+        self.lists.fetch_add(1, Ordering::Relaxed);
+        let keys = self
+            .objects
+            .lock()
+            .keys()
+            .filter(|key| key.starts_with(prefix))
+            .cloned()
+            .collect();
+        Box::pin(async move { Ok(keys) })
+    }
+
+    fn create_multipart<'a>(&'a self, key: &'a str) -> BoxFuture<'a, AcornResult<Option<String>>> {
+        let upload_id = format!("upload-{}", self.next_etag.fetch_add(1, Ordering::Relaxed) + 1);
+        self.uploads
+            .lock()
+            .insert(upload_id.clone(), (key.to_string(), HashMap::new()));
+        Box::pin(async move { Ok(Some(upload_id)) })
+    }
+
+    fn upload_part<'a>(
+        &'a self,
+        _key: &'a str,
+        upload_id: &'a str,
+        part_number: u32,
+        body: Vec<u8>,
+    ) -> BoxFuture<'a, AcornResult<String>> {
+        self.parts.fetch_add(1, Ordering::Relaxed);
+        let result = match self.uploads.lock().get_mut(upload_id) {
+            Some((_, parts)) => {
+                parts.insert(part_number, body);
+                Ok(format!("{upload_id}-{part_number}"))
+            }
+            None => Err(AcornError::Trunk(format!("unknown upload {upload_id}"))),
+        };
+        Box::pin(async move { result })
+    }
+
+    fn complete_multipart<'a>(
+        &'a self,
+        key: &'a str,
+        upload_id: &'a str,
+        parts: Vec<(u32, String)>,
+    ) -> BoxFuture<'a, AcornResult<Option<String>>> {
+        let result = match self.uploads.lock().remove(upload_id) {
+            Some((upload_key, mut uploaded)) if upload_key == key => {
+                let mut body = Vec::new();
+                let mut missing = None;
+                for (part_number, _) in &parts {
+                    match uploaded.remove(part_number) {
+                        Some(part) => body.extend_from_slice(&part),
+                        None => {
+                            missing = Some(*part_number);
+                            break;
+                        }
+                    }
+                }
+                match missing {
+                    Some(part_number) => {
+                        Err(AcornError::Trunk(format!("part {part_number} was not uploaded")))
+                    }
+                    None => Ok(Some(self.store(key, body))),
+                }
+            }
+            _ => Err(AcornError::Trunk(format!("unknown upload {upload_id}"))),
+        };
+        Box::pin(async move { result })
+    }
+
+    fn abort_multipart<'a>(&'a self, _key: &'a str, upload_id: &'a str) -> BoxFuture<'a, AcornResult<()>> {
+        self.uploads.lock().remove(upload_id);
+        Box::pin(async { Ok(()) })
+    }
+}
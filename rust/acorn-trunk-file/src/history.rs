@@ -0,0 +1,635 @@
+//! Binary append-only history log used by [`FileTrunk`](crate::FileTrunk).
+//!
+//! Each branch keeps one `events.bin` file under `.history/`. Records are length prefixed and
+//! checksummed so the log can be scanned without parsing, and every record carries its
+//! branch sequence number so [`HistoryLog::since`] can resume from a cursor. A sparse
+//! `(seq, offset)` checkpoint table lets readers seek close to the requested sequence instead
+//! of scanning from the start. The append handle stays open for the lifetime of the trunk.
+//!
+//! Record layout (little endian):
+//!
+//! ```text
+//! [body_len: u32][crc32(body): u32]
+//! body = [seq: u64][kind: u8][key_len: u32][key][value]
+//! ```
+//!
+//! Logs written by earlier releases as JSON lines (`events.log`) are migrated on first open.
+
+use std::fs::{self, File};
+use std::io::{self, Write};
+#[cfg(not(feature = "mmap"))]
+use std::io::{BufReader, Read, Seek, SeekFrom};
+#[cfg(feature = "mmap")]
+use std::ops::Range;
+use std::path::Path;
+
+use acorn_core::{AcornError, AcornResult, HistoryEvent, Nut, SequencedEvent};
+use parking_lot::{Condvar, Mutex};
+
+use crate::segment::{crc32, io_err};
+
+pub(crate) const LOG_FILE: &str = "events.bin";
+pub(crate) const LEGACY_LOG_FILE: &str = "events.log";
+
+const RECORD_PUT: u8 = 1;
+const RECORD_DELETE: u8 = 2;
+const HEADER_LEN: usize = 8;
+const BODY_FIXED_LEN: usize = 8 + 1 + 4;
+const MAX_BODY_LEN: u32 = u32::MAX >> 1;
+const CHECKPOINT_INTERVAL: u64 = 1024;
+#[cfg(not(feature = "mmap"))]
+const READ_BUFFER_BYTES: usize = 64 * 1024;
+
+/// Durability policy for history appends.
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Default)]
+pub enum HistorySync {
+    /// Appends reach the OS page cache; fsync happens on [`FileTrunk::flush_history`](crate::FileTrunk::flush_history).
+    #[default]
+    Buffered,
+    /// Each append returns once it is on disk. Concurrent appenders share one fsync.
+    GroupCommit,
+}
+
+#[derive(Debug)]
+pub(crate) struct HistoryLog {
+    path: std::path::PathBuf,
+    sync: HistorySync,
+    state: Mutex<LogState>,
+    synced: Condvar,
+}
+
+#[derive(Debug)]
+struct LogState {
+    file: File,
+    /// Separate handle so fsync can run without holding the append lock.
+    sync_handle: File,
+    len: u64,
+    last_seq: u64,
+    durable_seq: u64,
+    syncing: bool,
+    checkpoints: Vec<(u64, u64)>,
+    scratch: Vec<u8>,
+}
+
+impl HistoryLog {
+    pub(crate) fn open(dir: &Path, sync: HistorySync) -> AcornResult<Self> {
+        fs::create_dir_all(dir).map_err(io_err)?;
+        let path = dir.join(LOG_FILE);
+        let legacy = dir.join(LEGACY_LOG_FILE);
+        if legacy.exists() {
+            migrate_legacy(&legacy, &path)?;
+        }
+
+        let file = fs::OpenOptions::new()
+            .read(true)
+            .append(true)
+            .create(true)
+            .open(&path)
+            .map_err(io_err)?;
+        let file_len = file.metadata().map_err(io_err)?.len();
+
+        let mut checkpoints = Vec::new();
+        let mut last_seq = 0;
+        let mut valid_len = 0;
+        let mut cursor = RecordReader::open(&file, 0, file_len)?;
+        loop {
+            match cursor.step() {
+                Step::Record { seq, start, end } => {
+                    if (seq - 1).is_multiple_of(CHECKPOINT_INTERVAL) {
+                        checkpoints.push((seq, start));
+                    }
+                    last_seq = seq;
+                    valid_len = end;
+                }
+                Step::End => break,
+                Step::Corrupt(reason) => {
+                    tracing::warn!(path = %path.display(), offset = valid_len, %reason, "truncating torn history tail");
+                    break;
+                }
+            }
+        }
+        drop(cursor);
+        if valid_len < file_len {
+            file.set_len(valid_len).map_err(io_err)?;
+        }
+
+        let sync_handle = file.try_clone().map_err(io_err)?;
+        Ok(HistoryLog {
+            path,
+            sync,
+            state: Mutex::new(LogState {
+                file,
+                sync_handle,
+                len: valid_len,
+                last_seq,
+                durable_seq: last_seq,
+                syncing: false,
+                checkpoints,
+                scratch: Vec::new(),
+            }),
+            synced: Condvar::new(),
+        })
+    }
+
+    /// Append an event and return the sequence number assigned to it.
+    pub(crate) fn append(&self, event: &HistoryEvent<Vec<u8>>) -> AcornResult<u64> {
+        let mut state = self.state.lock();
+        let seq = state.last_seq + 1;
+        let LogState {
+            file, scratch, len, ..
+        } = &mut *state;
+        encode_record(scratch, seq, event)?;
+        if let Err(e) = write_record(file, scratch) {
+            // Cut off whatever part of the record got out, so later appends are not written
+            // after garbage that reopening would truncate them away with.
+            let _ = file.set_len(*len);
+            return Err(io_err(e));
+        }
+
+        let start = state.len;
+        state.len += state.scratch.len() as u64;
+        state.last_seq = seq;
+        if (seq - 1).is_multiple_of(CHECKPOINT_INTERVAL) {
+            state.checkpoints.push((seq, start));
+        }
+
+        if self.sync == HistorySync::GroupCommit {
+            self.wait_durable(&mut state, seq)?;
+        }
+        Ok(seq)
+    }
+
+    /// Force everything appended so far to disk.
+    pub(crate) fn flush(&self) -> AcornResult<()> {
+        let mut state = self.state.lock();
+        let seq = state.last_seq;
+        self.wait_durable(&mut state, seq)
+    }
+
+    pub(crate) fn last_seq(&self) -> u64 {
+        self.state.lock().last_seq
+    }
+
+    /// Stream events with a sequence greater than `since`, as of the moment of the call.
+    pub(crate) fn since(&self, since: u64) -> AcornResult<HistoryCursor> {
+        let (start, end) = {
+            let state = self.state.lock();
+            let idx = state
+                .checkpoints
+                .partition_point(|(seq, _)| *seq <= since.saturating_add(1));
+            let start = idx.checked_sub(1).map(|i| state.checkpoints[i].1).unwrap_or(0);
+            (start, state.len)
+        };
+        let file = File::open(&self.path).map_err(io_err)?;
+        Ok(HistoryCursor {
+            reader: RecordReader::open(&file, start, end)?,
+            since,
+            done: false,
+        })
+    }
+
+    /// Leader/follower group commit: the first waiter fsyncs on behalf of every append that
+    /// landed before it started; the rest wait on the condvar until their sequence is covered.
+    fn wait_durable(&self, state: &mut parking_lot::MutexGuard<'_, LogState>, seq: u64) -> AcornResult<()> {
+        loop {
+            if state.durable_seq >= seq {
+                return Ok(());
+            }
+            if state.syncing {
+                self.synced.wait(state);
+                continue;
+            }
+            state.syncing = true;
+            let target = state.last_seq;
+            let handle = state.sync_handle.try_clone();
+            let result =
+                parking_lot::MutexGuard::unlocked(state, || handle.and_then(|file| file.sync_data()));
+            state.syncing = false;
+            if result.is_ok() {
+                state.durable_seq = state.durable_seq.max(target);
+            }
+            self.synced.notify_all();
+            result.map_err(io_err)?;
+        }
+    }
+}
+
+/// Streaming iterator returned by [`crate::FileTrunk::history_since_checked`].
+pub struct HistoryCursor {
+    reader: RecordReader,
+    since: u64,
+    done: bool,
+}
+
+impl Iterator for HistoryCursor {
+    type Item = AcornResult<SequencedEvent<Vec<u8>>>;
+
+    fn next(&mut self) -> Option<Self::Item> {
+        while !self.done {
+            match self.reader.step() {
+                Step::Record { seq, .. } if seq <= self.since => continue,
+                Step::Record { seq, .. } => {
+                    return Some(decode_event(self.reader.body()).map(|event| SequencedEvent { seq, event }));
+                }
+                Step::End => self.done = true,
+                Step::Corrupt(reason) => {
+                    self.done = true;
+                    return Some(Err(AcornError::Trunk(format!(
+                        "corrupt history record: {reason}"
+                    ))));
+                }
+            }
+        }
+        None
+    }
+}
+
+enum Step {
+    Record { seq: u64, start: u64, end: u64 },
+    End,
+    Corrupt(String),
+}
+
+/// Sequential record reader over `[offset, end)` of a log file.
+struct RecordReader {
+    source: Source,
+    offset: u64,
+    end: u64,
+}
+
+enum Source {
+    #[cfg(feature = "mmap")]
+    Mapped {
+        map: memmap2::Mmap,
+        body: Range<usize>,
+    },
+    #[cfg(not(feature = "mmap"))]
+    Buffered {
+        reader: BufReader<File>,
+        body: Vec<u8>,
+    },
+    Empty,
+}
+
+impl RecordReader {
+    fn open(file: &File, offset: u64, end: u64) -> AcornResult<Self> {
+        if offset >= end {
+            return Ok(RecordReader {
+                source: Source::Empty,
+                offset,
+                end,
+            });
+        }
+        #[cfg(feature = "mmap")]
+        {
+            // Safety: the log is append-only while mapped; the only truncation happens in
+            // `HistoryLog::open` after its own reader has been dropped, and reads stop at `end`.
+            let map = unsafe { memmap2::MmapOptions::new().len(end as usize).map(file) }.map_err(io_err)?;
+            Ok(RecordReader {
+                source: Source::Mapped { map, body: 0..0 },
+                offset,
+                end,
+            })
+        }
+        #[cfg(not(feature = "mmap"))]
+        {
+            let mut file = file.try_clone().map_err(io_err)?;
+            file.seek(SeekFrom::Start(offset)).map_err(io_err)?;
+            Ok(RecordReader {
+                source: Source::Buffered {
+                    reader: BufReader::with_capacity(READ_BUFFER_BYTES, file),
+                    body: Vec::new(),
+                },
+                offset,
+                end,
+            })
+        }
+    }
+
+    fn body(&self) -> &[u8] {
+        match &self.source {
+            #[cfg(feature = "mmap")]
+            Source::Mapped { map, body } => &map[body.clone()],
+            #[cfg(not(feature = "mmap"))]
+            Source::Buffered { body, .. } => body,
+            Source::Empty => &[],
+        }
+    }
+
+    fn step(&mut self) -> Step {
+        if self.offset >= self.end {
+            return Step::End;
+        }
+        let remaining = self.end - self.offset;
+        if remaining < HEADER_LEN as u64 {
+            return Step::Corrupt("truncated header".into());
+        }
+        let start = self.offset;
+        let mut header = [0u8; HEADER_LEN];
+        if let Err(e) = self.read_header(&mut header) {
+            return Step::Corrupt(e.to_string());
+        }
+        let body_len = u32::from_le_bytes(header[0..4].try_into().unwrap());
+        let crc = u32::from_le_bytes(header[4..8].try_into().unwrap());
+        if body_len > MAX_BODY_LEN
+            || (body_len as usize) < BODY_FIXED_LEN
+            || body_len as u64 > remaining - HEADER_LEN as u64
+        {
+            return Step::Corrupt(format!("invalid body length {body_len}"));
+        }
+        if let Err(e) = self.read_body(body_len as usize) {
+            return Step::Corrupt(e.to_string());
+        }
+        let body = self.body();
+        if crc32(body) != crc {
+            return Step::Corrupt("checksum mismatch".into());
+        }
+        let seq = u64::from_le_bytes(body[0..8].try_into().unwrap());
+        if seq == 0 {
+            return Step::Corrupt("zero sequence".into());
+        }
+        self.offset = start + HEADER_LEN as u64 + body_len as u64;
+        Step::Record {
+            seq,
+            start,
+            end: self.offset,
+        }
+    }
+
+    fn read_header(&mut self, header: &mut [u8; HEADER_LEN]) -> io::Result<()> {
+        match &mut self.source {
+            #[cfg(feature = "mmap")]
+            Source::Mapped { map, .. } => {
+                let at = self.offset as usize;
+                header.copy_from_slice(&map[at..at + HEADER_LEN]);
+                Ok(())
+            }
+            #[cfg(not(feature = "mmap"))]
+            Source::Buffered { reader, .. } => reader.read_exact(header),
+            Source::Empty => Err(io::ErrorKind::UnexpectedEof.into()),
+        }
+    }
+
+    fn read_body(&mut self, len: usize) -> io::Result<()> {
+        match &mut self.source {
+            #[cfg(feature = "mmap")]
+            Source::Mapped { body, .. } => {
+                let at = self.offset as usize + HEADER_LEN;
+                *body = at..at + len;
+                Ok(())
+            }
+            #[cfg(not(feature = "mmap"))]
+            Source::Buffered { reader, body } => {
+                body.resize(len, 0);
+                reader.read_exact(body)
+            }
+            Source::Empty => Err(io::ErrorKind::UnexpectedEof.into()),
+        }
+    }
+}
+
+fn encode_record(out: &mut Vec<u8>, seq: u64, event: &HistoryEvent<Vec<u8>>) -> AcornResult<()> {
+    let (kind, key, value): (u8, &str, &[u8]) = match event {
+        HistoryEvent::Put { key, nut } => (RECORD_PUT, key, &nut.value),
+        HistoryEvent::Delete { key } => (RECORD_DELETE, key, &[]),
+    };
+    let body_len = BODY_FIXED_LEN + key.len() + value.len();
+    if body_len > MAX_BODY_LEN as usize || key.len() > u32::MAX as usize {
+        return Err(AcornError::Trunk(format!(
+            "history record for {key} is too large"
+        )));
+    }
+    out.clear();
+    out.reserve(HEADER_LEN + body_len);
+    out.extend_from_slice(&(body_len as u32).to_le_bytes());
+    out.extend_from_slice(&[0u8; 4]);
+    out.extend_from_slice(&seq.to_le_bytes());
+    out.push(kind);
+    out.extend_from_slice(&(key.len() as u32).to_le_bytes());
+    out.extend_from_slice(key.as_bytes());
+    out.extend_from_slice(value);
+    let crc = crc32(&out[HEADER_LEN..]);
+    out[4..8].copy_from_slice(&crc.to_le_bytes());
+    Ok(())
+}
+
+fn decode_event(body: &[u8]) -> AcornResult<HistoryEvent<Vec<u8>>> {
+    let corrupt = |what: &str| AcornError::Trunk(format!("corrupt history record: {what}"));
+    let kind = body[8];
+    let key_len = u32::from_le_bytes(body[9..13].try_into().unwrap()) as usize;
+    let rest = &body[BODY_FIXED_LEN..];
+    if key_len > rest.len() {
+        return Err(corrupt("key length"));
+    }
+    let key = std::str::from_utf8(&rest[..key_len])
+        .map_err(|_| corrupt("key is not utf-8"))?
+        .to_string();
+    match kind {
+        RECORD_PUT => Ok(HistoryEvent::Put {
+            key,
+            nut: Nut {
+                value: rest[key_len..].to_vec(),
+            },
+        }),
+        RECORD_DELETE => Ok(HistoryEvent::Delete { key }),
+        other => Err(corrupt(&format!("unknown kind {other}"))),
+    }
+}
+
+fn write_record(mut file: &File, record: &[u8]) -> io::Result<()> {
+    #[cfg(test)]
+    if tests::TORN_WRITE.with(|torn| torn.get()) {
+        file.write_all(&record[..record.len() / 2])?;
+        return Err(io::Error::other("injected torn write"));
+    }
+    file.write_all(record)
+}
+
+/// Rewrite a JSON-lines log as a binary log. The binary file is written to a temporary path
+/// and renamed into place before the legacy file is removed, so a crash at any point leaves
+/// one complete log behind.
+fn migrate_legacy(legacy: &Path, path: &Path) -> AcornResult<()> {
+    if path.exists() {
+        return fs::remove_file(legacy).map_err(io_err);
+    }
+    let data = fs::read(legacy).map_err(io_err)?;
+    let tmp = path.with_extension("bin.tmp");
+    let mut out = io::BufWriter::new(File::create(&tmp).map_err(io_err)?);
+    let mut record = Vec::new();
+    let mut seq = 0;
+    for line in data
+        .split(|b| *b == b'\n')
+        .filter(|line| !line.trim_ascii().is_empty())
+    {
+        // A crash mid-append leaves a torn last line; keep everything before it
+        let event: HistoryEvent<Vec<u8>> = match serde_json::from_slice(line) {
+            Ok(event) => event,
+            Err(e) => {
+                tracing::warn!(path = %legacy.display(), kept = seq, error = %e, "dropping unreadable legacy history tail");
+                break;
+            }
+        };
+        seq += 1;
+        encode_record(&mut record, seq, &event)?;
+        out.write_all(&record).map_err(io_err)?;
+    }
+    let file = out.into_inner().map_err(|e| io_err(e.into_error()))?;
+    file.sync_all().map_err(io_err)?;
+    fs::rename(&tmp, path).map_err(io_err)?;
+    fs::remove_file(legacy).map_err(io_err)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::cell::Cell;
+    use std::sync::Arc;
+
+    thread_local! {
+        /// Makes appends on this thread write half a record and fail.
+        pub(super) static TORN_WRITE: Cell<bool> = const { Cell::new(false) };
+    }
+
+    fn put(key: &str, value: &[u8]) -> HistoryEvent<Vec<u8>> {
+        HistoryEvent::Put {
+            key: key.to_string(),
+            nut: Nut {
+                value: value.to_vec(),
+            },
+        }
+    }
+
+    fn collect(log: &HistoryLog, since: u64) -> Vec<SequencedEvent<Vec<u8>>> {
+        log.since(since)
+            .unwrap()
+            .collect::<AcornResult<Vec<_>>>()
+            .unwrap()
+    }
+
+    #[test]
+    fn since_skips_to_cursor_across_checkpoints() {
+        let dir = tempfile::tempdir().unwrap();
+        let log = HistoryLog::open(dir.path(), HistorySync::Buffered).unwrap();
+        let total = CHECKPOINT_INTERVAL * 2 + 10;
+        for i in 0..total {
+            let event = if i % 3 == 0 {
+                HistoryEvent::Delete { key: format!("k{i}") }
+            } else {
+                put(&format!("k{i}"), &i.to_le_bytes())
+            };
+            assert_eq!(log.append(&event).unwrap(), i + 1);
+        }
+
+        assert_eq!(collect(&log, 0).len() as u64, total);
+        let since = CHECKPOINT_INTERVAL + 6;
+        let tail = collect(&log, since);
+        assert_eq!(tail.len() as u64, total - since);
+        assert_eq!(tail[0].seq, since + 1);
+        match &tail[0].event {
+            HistoryEvent::Put { key, nut } => {
+                assert_eq!(key, &format!("k{since}"));
+                assert_eq!(nut.value, since.to_le_bytes());
+            }
+            other => panic!("unexpected event {other:?}"),
+        }
+        assert!(collect(&log, total).is_empty());
+    }
+
+    #[test]
+    fn reopen_continues_sequence_and_truncates_torn_tail() {
+        let dir = tempfile::tempdir().unwrap();
+        {
+            let log = HistoryLog::open(dir.path(), HistorySync::GroupCommit).unwrap();
+            log.append(&put("a", b"1")).unwrap();
+            log.append(&put("b", b"2")).unwrap();
+        }
+        let path = dir.path().join(LOG_FILE);
+        let mut file = fs::OpenOptions::new().append(true).open(&path).unwrap();
+        file.write_all(&[42, 0, 0, 0, 1, 2]).unwrap();
+        drop(file);
+
+        let log = HistoryLog::open(dir.path(), HistorySync::Buffered).unwrap();
+        assert_eq!(log.last_seq(), 2);
+        assert_eq!(log.append(&HistoryEvent::Delete { key: "a".into() }).unwrap(), 3);
+        let events = collect(&log, 0);
+        assert_eq!(events.iter().map(|e| e.seq).collect::<Vec<_>>(), vec![1, 2, 3]);
+    }
+
+    #[test]
+    fn migrates_legacy_json_lines() {
+        let dir = tempfile::tempdir().unwrap();
+        let legacy = [put("a", b"x"), HistoryEvent::Delete { key: "a".into() }]
+            .iter()
+            .map(|event| serde_json::to_string(event).unwrap() + "\n")
+            .collect::<String>();
+        fs::write(dir.path().join(LEGACY_LOG_FILE), legacy).unwrap();
+
+        let log = HistoryLog::open(dir.path(), HistorySync::Buffered).unwrap();
+        assert!(!dir.path().join(LEGACY_LOG_FILE).exists());
+        let events = collect(&log, 0);
+        assert_eq!(events.len(), 2);
+        assert!(matches!(&events[1].event, HistoryEvent::Delete { key } if key == "a"));
+        assert_eq!(log.append(&put("b", b"y")).unwrap(), 3);
+    }
+
+    #[test]
+    fn failed_append_leaves_no_partial_record() {
+        let dir = tempfile::tempdir().unwrap();
+        let log = HistoryLog::open(dir.path(), HistorySync::Buffered).unwrap();
+        log.append(&put("a", b"1")).unwrap();
+
+        TORN_WRITE.with(|torn| torn.set(true));
+        let failed = log.append(&put("b", b"2"));
+        TORN_WRITE.with(|torn| torn.set(false));
+        assert!(failed.is_err());
+
+        assert_eq!(log.append(&put("c", b"3")).unwrap(), 2);
+        drop(log);
+        let log = HistoryLog::open(dir.path(), HistorySync::Buffered).unwrap();
+        let keys: Vec<_> = collect(&log, 0)
+            .into_iter()
+            .map(|e| match e.event {
+                HistoryEvent::Put { key, .. } | HistoryEvent::Delete { key } => (e.seq, key),
+            })
+            .collect();
+        assert_eq!(keys, vec![(1, "a".to_string()), (2, "c".to_string())]);
+    }
+
+    #[test]
+    fn migration_keeps_records_before_a_torn_legacy_line() {
+        let dir = tempfile::tempdir().unwrap();
+        let mut legacy = [put("a", b"x"), put("b", b"y")]
+            .iter()
+            .map(|event| serde_json::to_string(event).unwrap() + "\n")
+            .collect::<String>();
+        let torn = serde_json::to_string(&put("c", b"z")).unwrap();
+        legacy.push_str(&torn[..torn.len() / 2]);
+        fs::write(dir.path().join(LEGACY_LOG_FILE), legacy).unwrap();
+
+        let log = HistoryLog::open(dir.path(), HistorySync::Buffered).unwrap();
+        assert!(!dir.path().join(LEGACY_LOG_FILE).exists());
+        assert_eq!(collect(&log, 0).len(), 2);
+        assert_eq!(log.append(&put("c", b"z")).unwrap(), 3);
+    }
+
+    #[test]
+    fn group_commit_concurrent_appenders_get_unique_sequences() {
+        let dir = tempfile::tempdir().unwrap();
+        let log = Arc::new(HistoryLog::open(dir.path(), HistorySync::GroupCommit).unwrap());
+        let handles: Vec<_> = (0..8)
+            .map(|t| {
+                let log = log.clone();
+                std::thread::spawn(move || {
+                    (0..50)
+                        .map(|i| log.append(&put(&format!("t{t}-{i}"), b"v")).unwrap())
+                        .collect::<Vec<_>>()
+                })
+            })
+            .collect();
+        let mut seqs: Vec<u64> = handles.into_iter().flat_map(|h| h.join().unwrap()).collect();
+        seqs.sort_unstable();
+        assert_eq!(seqs, (1..=400).collect::<Vec<_>>());
+        assert_eq!(log.state.lock().durable_seq, 400);
+        assert_eq!(collect(&log, 0).len(), 400);
+    }
+}
@@ -4,14 +4,22 @@ use std::collections::HashMap;
 use std::fs;
 use std::path::PathBuf;
 use std::sync::Arc;
-use std::time::SystemTime;
+use std::time::{Duration, Instant, SystemTime};
 
 use acorn_core::{
-    AcornError, AcornResult, BranchId, CapabilityAdvertiser, HistoryEvent, HistoryProvider, KeyedTrunk, Nut,
-    TombstoneProvider, Trunk, TrunkCapability, Ttl, TtlCleaner, TtlProvider,
+    AcornError, AcornResult, BranchId, CapabilityAdvertiser, ExpiryIndex, HistoryEvent, HistoryIter,
+    HistoryProvider, KeyedTrunk, Nut, TombstoneProvider, Trunk, TrunkCapability, Ttl, TtlCleaner,
+    TtlCounters, TtlProvider, TtlStats,
 };
 use parking_lot::RwLock;
 
+mod history;
+mod segment;
+
+use history::HistoryLog;
+pub use history::{HistoryCursor, HistorySync};
+pub use segment::{CompactionStats, Compactor, SegmentOptions, SegmentStats, SegmentTrunk};
+
 #[derive(Debug, Clone)]
 pub struct FileTrunk {
     root: PathBuf,
@@ -19,6 +27,12 @@ pub struct FileTrunk {
     history_enabled: bool,
     versions_enabled: bool,
     tombstones: Arc<RwLock<HashMap<(BranchId, String), Option<u64>>>>,
+    history_sync: HistorySync,
+    history_logs: Arc<RwLock<HashMap<BranchId, Arc<HistoryLog>>>>,
+    /// Deadlines from the `.ttl` files, per branch. A branch is loaded by its first purge with
+    /// one directory scan; later writes keep it current so purges only read due keys.
+    expiry: Arc<RwLock<HashMap<BranchId, ExpiryIndex<String>>>>,
+    ttl: Arc<TtlCounters>,
 }
 
 impl FileTrunk {
@@ -29,6 +43,10 @@ impl FileTrunk {
             history_enabled: false,
             versions_enabled: false,
             tombstones: Arc::new(RwLock::new(HashMap::new())),
+            history_sync: HistorySync::default(),
+            history_logs: Arc::new(RwLock::new(HashMap::new())),
+            expiry: Arc::new(RwLock::new(HashMap::new())),
+            ttl: Arc::new(TtlCounters::default()),
         }
     }
 
@@ -39,6 +57,10 @@ impl FileTrunk {
             history_enabled: false,
             versions_enabled: false,
             tombstones: Arc::new(RwLock::new(HashMap::new())),
+            history_sync: HistorySync::default(),
+            history_logs: Arc::new(RwLock::new(HashMap::new())),
+            expiry: Arc::new(RwLock::new(HashMap::new())),
+            ttl: Arc::new(TtlCounters::default()),
         }
     }
 
@@ -49,6 +71,10 @@ impl FileTrunk {
             history_enabled: true,
             versions_enabled: true,
             tombstones: Arc::new(RwLock::new(HashMap::new())),
+            history_sync: HistorySync::default(),
+            history_logs: Arc::new(RwLock::new(HashMap::new())),
+            expiry: Arc::new(RwLock::new(HashMap::new())),
+            ttl: Arc::new(TtlCounters::default()),
         }
     }
 
@@ -59,9 +85,19 @@ impl FileTrunk {
             history_enabled: true,
             versions_enabled: true,
             tombstones: Arc::new(RwLock::new(HashMap::new())),
+            history_sync: HistorySync::default(),
+            history_logs: Arc::new(RwLock::new(HashMap::new())),
+            expiry: Arc::new(RwLock::new(HashMap::new())),
+            ttl: Arc::new(TtlCounters::default()),
         }
     }
 
+    /// Choose how history appends are made durable. Defaults to [`HistorySync::Buffered`].
+    pub fn with_history_sync(mut self, sync: HistorySync) -> Self {
+        self.history_sync = sync;
+        self
+    }
+
     pub fn init_filesystem(&self) -> AcornResult<()> {
         fs::create_dir_all(&self.root).map_err(|e| AcornError::Trunk(e.to_string()))
     }
@@ -100,6 +136,55 @@ impl FileTrunk {
         }
     }
 
+    fn ttl_path(&self, branch: &BranchId, key: &str) -> PathBuf {
+        self.branch_dir(branch).join(format!("{}.ttl", key))
+    }
+
+    fn read_expiry(&self, branch: &BranchId, key: &str) -> Option<SystemTime> {
+        let ms = fs::read_to_string(self.ttl_path(branch, key))
+            .ok()?
+            .parse::<u64>()
+            .ok()?;
+        Some(SystemTime::UNIX_EPOCH + Duration::from_millis(ms))
+    }
+
+    /// Update the deadline index of a branch that has been loaded; unloaded branches pick the
+    /// change up from disk when they are.
+    fn track_expiry(&self, branch: &BranchId, key: &str, deadline: Option<SystemTime>) {
+        if let Some(index) = self.expiry.write().get_mut(branch) {
+            index.set(&key.to_string(), deadline);
+        }
+    }
+
+    fn scan_expiry(&self, branch: &BranchId) -> ExpiryIndex<String> {
+        let mut index = ExpiryIndex::new();
+        if let Ok(entries) = fs::read_dir(self.branch_dir(branch)) {
+            for entry in entries.flatten() {
+                let name = entry.file_name();
+                let Some(key) = name.to_str().and_then(|n| n.strip_suffix(".ttl")) else {
+                    continue;
+                };
+                if let Some(deadline) = self.read_expiry(branch, key) {
+                    index.set(&key.to_string(), Some(deadline));
+                }
+            }
+        }
+        index
+    }
+
+    fn expire(&self, branch: &BranchId, key: &str) {
+        let version = self.current_version(branch, key);
+        let _ = fs::remove_file(self.ttl_path(branch, key));
+        let _ = fs::remove_file(self.branch_dir(branch).join(key));
+        self.clear_version(branch, key);
+        self.tombstones
+            .write()
+            .insert((branch.clone(), key.to_string()), version);
+        if self.history_enabled {
+            let _ = self.append_history(branch, HistoryEvent::Delete { key: key.to_string() });
+        }
+    }
+
     fn record_tombstone(&self, branch: &BranchId, key: &str) {
         let version = if self.versions_enabled {
             self.current_version(branch, key)
@@ -126,16 +211,13 @@ impl Trunk<Vec<u8>> for FileTrunk {
         let path = self.branch_dir(branch).join(key);
 
         if self.ttl_enabled {
-            let ttl_path = self.branch_dir(branch).join(format!("{}.ttl", key));
-            if let Ok(raw) = fs::read_to_string(&ttl_path) {
-                if let Ok(ms) = raw.parse::<u128>() {
-                    let expires_at = SystemTime::UNIX_EPOCH + std::time::Duration::from_millis(ms as u64);
-                    if SystemTime::now() >= expires_at {
-                        let _ = fs::remove_file(&path);
-                        let _ = fs::remove_file(&ttl_path);
-                        self.clear_version(branch, key);
-                        return Ok(None);
-                    }
+            if let Some(expires_at) = self.read_expiry(branch, key) {
+                if SystemTime::now() >= expires_at {
+                    let _ = fs::remove_file(&path);
+                    let _ = fs::remove_file(self.ttl_path(branch, key));
+                    self.clear_version(branch, key);
+                    self.track_expiry(branch, key, None);
+                    return Ok(None);
                 }
             }
         }
@@ -168,8 +250,8 @@ impl Trunk<Vec<u8>> for FileTrunk {
 
     fn delete(&self, branch: &BranchId, key: &str) -> AcornResult<()> {
         let path = self.branch_dir(branch).join(key);
-        let ttl_path = self.branch_dir(branch).join(format!("{}.ttl", key));
-        let _ = fs::remove_file(&ttl_path);
+        let _ = fs::remove_file(self.ttl_path(branch, key));
+        self.track_expiry(branch, key, None);
         fs::remove_file(&path).map_err(|e| {
             if e.kind() == std::io::ErrorKind::NotFound {
                 AcornError::MissingKey(key.to_string())
@@ -233,42 +315,40 @@ impl KeyedTrunk<Vec<u8>> for FileTrunk {
 
 impl TtlCleaner<Vec<u8>> for FileTrunk {
     fn purge_expired(&self, branch: &BranchId) -> usize {
-        let mut removed = 0usize;
-        let dir = self.branch_dir(branch);
-        if let Ok(entries) = fs::read_dir(dir) {
-            for entry in entries.flatten() {
-                let path = entry.path();
-                if let Some(name) = path.file_name().and_then(|n| n.to_str()) {
-                    if name.ends_with(".ttl") {
-                        if let Ok(raw) = fs::read_to_string(&path) {
-                            if let Ok(ms) = raw.parse::<u128>() {
-                                let expires_at =
-                                    SystemTime::UNIX_EPOCH + std::time::Duration::from_millis(ms as u64);
-                                if SystemTime::now() >= expires_at {
-                                    let key = name.trim_end_matches(".ttl");
-                                    let data_path = self.branch_dir(branch).join(key);
-                                    let version = self.current_version(branch, key);
-                                    let _ = fs::remove_file(&path);
-                                    let _ = fs::remove_file(&data_path);
-                                    self.clear_version(branch, key);
-                                    self.tombstones
-                                        .write()
-                                        .insert((branch.clone(), key.to_string()), version);
-                                    if self.history_enabled {
-                                        let _ = self.append_history(
-                                            branch,
-                                            HistoryEvent::Delete { key: key.to_string() },
-                                        );
-                                    }
-                                    removed += 1;
-                                }
-                            }
-                        }
-                    }
+        let started = Instant::now();
+        let now = SystemTime::now();
+        let due = {
+            let mut indexes = self.expiry.write();
+            indexes
+                .entry(branch.clone())
+                .or_insert_with(|| self.scan_expiry(branch))
+                .take_due(now)
+        };
+
+        let mut purged = Vec::new();
+        let mut moved = Vec::new();
+        for (key, _) in due {
+            // The .ttl file is the source of truth; it may have been rewritten behind the index
+            match self.read_expiry(branch, &key) {
+                Some(current) if current <= now => {
+                    self.expire(branch, &key);
+                    purged.push(current);
                 }
+                Some(current) => moved.push((key, current)),
+                None => {}
             }
         }
-        removed
+        for (key, deadline) in moved {
+            self.track_expiry(branch, &key, Some(deadline));
+        }
+        self.ttl.record(started, now, purged.iter().copied());
+        purged.len()
+    }
+
+    /// `tracked` covers the branches purged at least once.
+    fn ttl_stats(&self) -> TtlStats {
+        let tracked = self.expiry.read().values().map(ExpiryIndex::len).sum();
+        self.ttl.snapshot(tracked)
     }
 }
 
@@ -317,11 +397,9 @@ impl TtlProvider<Vec<u8>> for FileTrunk {
             .expires_at
             .duration_since(SystemTime::UNIX_EPOCH)
             .map_err(|e| AcornError::Trunk(e.to_string()))?;
-        fs::write(
-            dir.join(format!("{}.ttl", key)),
-            expires_at.as_millis().to_string(),
-        )
-        .map_err(|e| AcornError::Trunk(e.to_string()))?;
+        fs::write(self.ttl_path(branch, key), expires_at.as_millis().to_string())
+            .map_err(|e| AcornError::Trunk(e.to_string()))?;
+        self.track_expiry(branch, key, Some(ttl.expires_at));
 
         let _ = self.bump_version(branch, key)?;
         self.tombstones.write().remove(&(branch.clone(), key.to_string()));
@@ -343,18 +421,45 @@ impl FileTrunk {
         self.branch_dir(branch).join(".history")
     }
 
+    /// Open (or return the already open) history log for a branch.
+    fn history_log(&self, branch: &BranchId) -> AcornResult<Arc<HistoryLog>> {
+        if let Some(log) = self.history_logs.read().get(branch) {
+            return Ok(log.clone());
+        }
+        let mut logs = self.history_logs.write();
+        if let Some(log) = logs.get(branch) {
+            return Ok(log.clone());
+        }
+        let log = Arc::new(HistoryLog::open(&self.history_dir(branch), self.history_sync)?);
+        logs.insert(branch.clone(), log.clone());
+        Ok(log)
+    }
+
     fn append_history(&self, branch: &BranchId, event: HistoryEvent<Vec<u8>>) -> AcornResult<()> {
+        self.history_log(branch)?.append(&event).map(|_| ())
+    }
+
+    /// Fsync every open history log.
+    pub fn flush_history(&self) -> AcornResult<()> {
+        let logs: Vec<_> = self.history_logs.read().values().cloned().collect();
+        logs.iter().try_for_each(|log| log.flush())
+    }
+
+    /// Stream history events with a sequence number greater than `since` without loading the
+    /// whole log. Returns `None` when history is disabled or the branch has no log, which the
+    /// [`HistoryProvider`] impl reports as an empty history.
+    pub fn history_since_checked(&self, branch: &BranchId, since: u64) -> AcornResult<Option<HistoryCursor>> {
+        if !self.history_enabled {
+            return Ok(None);
+        }
         let dir = self.history_dir(branch);
-        fs::create_dir_all(&dir).map_err(|e| AcornError::Trunk(e.to_string()))?;
-        let path = dir.join("events.log");
-        let mut file = fs::OpenOptions::new()
-            .create(true)
-            .append(true)
-            .open(&path)
-            .map_err(|e| AcornError::Trunk(e.to_string()))?;
-        let line = serde_json::to_string(&event).map_err(|e| AcornError::Trunk(e.to_string()))?;
-        use std::io::Write;
-        writeln!(file, "{}", line).map_err(|e| AcornError::Trunk(e.to_string()))
+        if !self.history_logs.read().contains_key(branch)
+            && !dir.join(history::LOG_FILE).exists()
+            && !dir.join(history::LEGACY_LOG_FILE).exists()
+        {
+            return Ok(None);
+        }
+        self.history_log(branch)?.since(since).map(Some)
     }
 
     pub fn keys(&self, branch: &BranchId) -> Vec<String> {
@@ -383,26 +488,20 @@ impl FileTrunk {
 
 impl HistoryProvider<Vec<u8>> for FileTrunk {
     fn history(&self, branch: &BranchId) -> AcornResult<Vec<HistoryEvent<Vec<u8>>>> {
-        if !self.history_enabled {
-            return Ok(Vec::new());
-        }
-
-        let path = self.history_dir(branch).join("events.log");
-        if !path.exists() {
-            return Ok(Vec::new());
+        match self.history_since_checked(branch, 0)? {
+            Some(cursor) => cursor.map(|sequenced| sequenced.map(|s| s.event)).collect(),
+            None => Ok(Vec::new()),
         }
+    }
 
-        let data = fs::read_to_string(&path).map_err(|e| AcornError::Trunk(e.to_string()))?;
-        let mut events = Vec::new();
-        for line in data.lines() {
-            if line.trim().is_empty() {
-                continue;
-            }
-            let event: HistoryEvent<Vec<u8>> =
-                serde_json::from_str(line).map_err(|e| AcornError::Trunk(e.to_string()))?;
-            events.push(event);
+    fn history_since<'a>(&'a self, branch: &BranchId, since: u64) -> AcornResult<HistoryIter<'a, Vec<u8>>>
+    where
+        Vec<u8>: 'a,
+    {
+        match self.history_since_checked(branch, since)? {
+            Some(cursor) => Ok(Box::new(cursor)),
+            None => Ok(Box::new(std::iter::empty())),
         }
-        Ok(events)
     }
 }
 #[cfg(test)]
@@ -412,8 +511,6 @@ mod tests {
     #[cfg(feature = "contract-tests")]
     use acorn_test_harness::TrunkContract;
     use std::fs;
-    #[cfg(feature = "contract-tests")]
-    use std::io::Read;
 
     #[test]
     fn put_get_delete_round_trip() {
@@ -466,6 +563,41 @@ mod tests {
         assert!(trunk.get(&branch, "key").unwrap().is_none());
     }
 
+    #[test]
+    fn purge_reads_only_due_deadlines_after_first_scan() {
+        let tmp_dir = tempfile::tempdir().unwrap();
+        let trunk = FileTrunk::with_ttl(tmp_dir.path());
+        let branch = BranchId::new("main");
+        let soon = || Ttl {
+            expires_at: SystemTime::now() + std::time::Duration::from_millis(10),
+        };
+        let later = Ttl {
+            expires_at: SystemTime::now() + std::time::Duration::from_secs(60),
+        };
+        trunk
+            .put_with_ttl(&branch, "a", Nut { value: b"a".to_vec() }, soon())
+            .unwrap();
+        trunk
+            .put_with_ttl(&branch, "keep", Nut { value: b"k".to_vec() }, later)
+            .unwrap();
+
+        // First purge loads the branch from its .ttl files
+        assert_eq!(trunk.purge_expired(&branch), 0);
+        assert_eq!(trunk.ttl_stats().tracked, 2);
+
+        trunk
+            .put_with_ttl(&branch, "b", Nut { value: b"b".to_vec() }, soon())
+            .unwrap();
+        std::thread::sleep(std::time::Duration::from_millis(20));
+        assert_eq!(trunk.purge_expired(&branch), 2);
+
+        let mut keys = trunk.keys(&branch);
+        keys.sort();
+        assert_eq!(keys, vec!["keep".to_string()]);
+        let stats = trunk.ttl_stats();
+        assert_eq!((stats.tracked, stats.purged, stats.purges), (1, 2, 2));
+    }
+
     #[cfg(feature = "contract-tests")]
     #[test]
     fn contract_round_trip_and_capabilities() {
@@ -614,11 +746,43 @@ mod tests {
         let trunk = FileTrunk::with_history(tmp_dir.path());
         TrunkContract::history_put_delete(&trunk).unwrap();
 
-        // ensure history file exists and has content
-        let hist_path = tmp_dir.path().join("history-contract/.history/events.log");
-        let mut contents = String::new();
-        let mut file = std::fs::File::open(hist_path).unwrap();
-        file.read_to_string(&mut contents).unwrap();
-        assert!(contents.contains("history-key"));
+        // ensure the binary history log exists and has content
+        let hist_path = tmp_dir.path().join("history-contract/.history/events.bin");
+        let contents = fs::read(&hist_path).unwrap();
+        assert!(contents
+            .windows(b"history-key".len())
+            .any(|w| w == b"history-key"));
+    }
+
+    #[test]
+    fn history_since_streams_from_cursor_and_survives_reopen() {
+        let tmp_dir = tempfile::tempdir().unwrap();
+        let branch = BranchId::new("stream");
+        {
+            let trunk = FileTrunk::with_history(tmp_dir.path()).with_history_sync(HistorySync::GroupCommit);
+            for i in 0..5 {
+                trunk
+                    .put(&branch, &format!("k{i}"), Nut { value: vec![i] })
+                    .unwrap();
+            }
+            trunk.delete(&branch, "k0").unwrap();
+        }
+
+        let trunk = FileTrunk::with_history(tmp_dir.path());
+        let tail: Vec<_> = trunk
+            .history_since(&branch, 4)
+            .unwrap()
+            .collect::<AcornResult<_>>()
+            .unwrap();
+        assert_eq!(tail.iter().map(|e| e.seq).collect::<Vec<_>>(), vec![5, 6]);
+        assert!(matches!(&tail[1].event, HistoryEvent::Delete { key } if key == "k0"));
+
+        trunk.put(&branch, "k9", Nut { value: vec![9] }).unwrap();
+        trunk.flush_history().unwrap();
+        assert_eq!(trunk.history(&branch).unwrap().len(), 7);
+        assert!(trunk
+            .history_since_checked(&BranchId::new("empty"), 0)
+            .unwrap()
+            .is_none());
     }
 }
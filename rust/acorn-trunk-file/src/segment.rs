@@ -0,0 +1,1641 @@
+//! Append-only segment log storage mode.
+//!
+//! Every mutation is appended to the active segment of its branch as a single checksummed
+//! record `(kind, key, version, ttl, payload)`. An in-memory index maps each live key to the
+//! record holding its latest value, so point reads are one positioned read and `keys()`,
+//! `version()` and `tombstones()` never touch the filesystem. Sealed segments whose dead-byte
+//! ratio crosses a threshold are rewritten by [`SegmentTrunk::compact`], either on demand or
+//! from a background [`Compactor`]. Compaction copies live records into a new segment without
+//! holding the branch lock; readers and writers only wait while the segments are swapped.
+//!
+//! Record layout (little endian):
+//!
+//! ```text
+//! [body_len: u32][crc32(body): u32]
+//! body = [kind: u8][version: u64][expires_at_ms: u64][key_len: u32][value_len: u32][key][value]
+//! ```
+//!
+//! `version == 0` and `expires_at_ms == 0` mean "none".
+
+use std::collections::{BTreeMap, HashMap, HashSet};
+use std::fs::{self, File};
+use std::io::{self, BufReader, Read, Write};
+use std::path::{Path, PathBuf};
+use std::sync::atomic::{AtomicBool, Ordering};
+use std::sync::Arc;
+use std::thread::JoinHandle;
+use std::time::{Duration, Instant, SystemTime};
+
+use acorn_core::{
+    AcornError, AcornResult, BranchId, CapabilityAdvertiser, ExpiryIndex, KeyedTrunk, Nut, TombstoneProvider,
+    Trunk, TrunkCapability, Ttl, TtlCleaner, TtlCounters, TtlProvider, TtlStats,
+};
+use parking_lot::{Mutex, RwLock};
+
+const RECORD_PUT: u8 = 1;
+const RECORD_DELETE: u8 = 2;
+const HEADER_LEN: u64 = 8;
+const BODY_FIXED_LEN: u64 = 1 + 8 + 8 + 4 + 4;
+const MAX_BODY_LEN: u32 = u32::MAX >> 1;
+const SEGMENT_EXT: &str = "seg";
+
+/// Tuning knobs for [`SegmentTrunk`].
+#[derive(Debug, Clone)]
+pub struct SegmentOptions {
+    /// Roll over to a new segment once the active one would exceed this size.
+    pub max_segment_bytes: u64,
+    /// Sealed segments with at least this fraction of dead bytes are compacted.
+    pub compaction_ratio: f64,
+    /// `fdatasync` the active segment after every append.
+    pub sync_on_write: bool,
+}
+
+impl Default for SegmentOptions {
+    fn default() -> Self {
+        SegmentOptions {
+            max_segment_bytes: 64 * 1024 * 1024,
+            compaction_ratio: 0.5,
+            sync_on_write: false,
+        }
+    }
+}
+
+/// Space accounting for one branch.
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct SegmentStats {
+    pub segments: usize,
+    pub total_bytes: u64,
+    pub dead_bytes: u64,
+}
+
+/// Outcome of a compaction pass.
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct CompactionStats {
+    pub segments_compacted: usize,
+    pub bytes_copied: u64,
+    pub bytes_reclaimed: u64,
+}
+
+/// File-backed trunk storing branches as append-only segment logs.
+#[derive(Debug, Clone)]
+pub struct SegmentTrunk {
+    root: PathBuf,
+    options: SegmentOptions,
+    branches: Arc<RwLock<HashMap<BranchId, Arc<RwLock<BranchLog>>>>>,
+    ttl: Arc<TtlCounters>,
+    /// One compaction pass at a time, so two passes never pick the same victims.
+    compaction: Arc<Mutex<()>>,
+}
+
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+struct Location {
+    segment: u32,
+    offset: u64,
+    len: u32,
+}
+
+#[derive(Debug, Clone, Copy)]
+struct IndexEntry {
+    loc: Location,
+    key_len: u32,
+    value_len: u32,
+    version: u64,
+    expires_at: Option<SystemTime>,
+}
+
+impl IndexEntry {
+    fn value_offset(&self) -> u64 {
+        self.loc.offset + HEADER_LEN + BODY_FIXED_LEN + self.key_len as u64
+    }
+
+    fn is_expired(&self, now: SystemTime) -> bool {
+        self.expires_at.is_some_and(|expires_at| now >= expires_at)
+    }
+}
+
+/// What a write requires of the key it replaces.
+#[derive(Debug, Clone, Copy)]
+enum Expect {
+    Any,
+    Version(u64),
+    /// Neither live, expired nor tombstoned.
+    Unseen,
+}
+
+#[derive(Debug, Clone, Copy)]
+struct Tombstone {
+    version: Option<u64>,
+    loc: Location,
+}
+
+#[derive(Debug)]
+struct Segment {
+    file: File,
+    len: u64,
+    dead: u64,
+}
+
+#[derive(Debug)]
+struct BranchLog {
+    dir: PathBuf,
+    segments: BTreeMap<u32, Segment>,
+    active: u32,
+    index: HashMap<String, IndexEntry>,
+    tombstones: HashMap<String, Tombstone>,
+    /// Deadlines of the live keys that have one, rebuilt by replay along with `index`.
+    expiry: ExpiryIndex<String>,
+}
+
+struct DecodedRecord {
+    kind: u8,
+    version: u64,
+    expires_ms: u64,
+    key: String,
+    value_len: u32,
+}
+
+impl SegmentTrunk {
+    pub fn new<P: Into<PathBuf>>(root: P) -> Self {
+        Self::with_options(root, SegmentOptions::default())
+    }
+
+    pub fn with_options<P: Into<PathBuf>>(root: P, options: SegmentOptions) -> Self {
+        SegmentTrunk {
+            root: root.into(),
+            options,
+            branches: Arc::new(RwLock::new(HashMap::new())),
+            ttl: Arc::new(TtlCounters::default()),
+            compaction: Arc::new(Mutex::new(())),
+        }
+    }
+
+    pub fn init_filesystem(&self) -> AcornResult<()> {
+        fs::create_dir_all(&self.root).map_err(io_err)
+    }
+
+    fn segments_dir(&self, branch: &BranchId) -> PathBuf {
+        self.root.join(branch.to_string()).join("segments")
+    }
+
+    /// Resolve the in-memory log for `branch`, replaying its segments on first use.
+    /// Returns `None` when the branch has never been written and `create` is false.
+    fn branch(&self, branch: &BranchId, create: bool) -> AcornResult<Option<Arc<RwLock<BranchLog>>>> {
+        if let Some(log) = self.branches.read().get(branch) {
+            return Ok(Some(log.clone()));
+        }
+
+        let mut branches = self.branches.write();
+        if let Some(log) = branches.get(branch) {
+            return Ok(Some(log.clone()));
+        }
+        let dir = self.segments_dir(branch);
+        if !create && !dir.exists() {
+            return Ok(None);
+        }
+        let log = Arc::new(RwLock::new(BranchLog::open(dir)?));
+        branches.insert(branch.clone(), log.clone());
+        Ok(Some(log))
+    }
+
+    fn branch_or_create(&self, branch: &BranchId) -> AcornResult<Arc<RwLock<BranchLog>>> {
+        self.branch(branch, true)?
+            .ok_or_else(|| AcornError::Trunk(format!("failed to open branch {}", branch)))
+    }
+
+    pub fn current_version(&self, branch: &BranchId, key: &str) -> Option<u64> {
+        let log = self.branch(branch, false).ok().flatten()?;
+        let guard = log.read();
+        guard.live(key, SystemTime::now()).map(|entry| entry.version)
+    }
+
+    /// [`Trunk::put_if_version`] that returns the version it wrote, decided under the same lock
+    /// as the version check.
+    pub fn put_if_version_returning(
+        &self,
+        branch: &BranchId,
+        key: &str,
+        expected: Option<u64>,
+        nut: Nut<Vec<u8>>,
+    ) -> AcornResult<u64> {
+        let expect = expected.map_or(Expect::Any, Expect::Version);
+        self.write_entry(branch, key, expect, &nut.value, None)
+    }
+
+    /// Write `key` only if it is neither live nor tombstoned, returning version 1. Otherwise
+    /// fails with [`AcornError::VersionConflict`] carrying the live version, if any.
+    pub fn create_if_unseen(&self, branch: &BranchId, key: &str, nut: Nut<Vec<u8>>) -> AcornResult<u64> {
+        self.write_entry(branch, key, Expect::Unseen, &nut.value, None)
+    }
+
+    pub fn keys(&self, branch: &BranchId) -> Vec<String> {
+        let Ok(Some(log)) = self.branch(branch, false) else {
+            return Vec::new();
+        };
+        let now = SystemTime::now();
+        let guard = log.read();
+        guard
+            .index
+            .iter()
+            .filter(|(_, entry)| !entry.is_expired(now))
+            .map(|(k, _)| k.clone())
+            .collect()
+    }
+
+    pub fn stats(&self, branch: &BranchId) -> Option<SegmentStats> {
+        let log = self.branch(branch, false).ok().flatten()?;
+        let guard = log.read();
+        Some(SegmentStats {
+            segments: guard.segments.len(),
+            total_bytes: guard.segments.values().map(|s| s.len).sum(),
+            dead_bytes: guard.segments.values().map(|s| s.dead).sum(),
+        })
+    }
+
+    /// Flush the active segment of every open branch to stable storage.
+    pub fn flush(&self) -> AcornResult<()> {
+        let logs: Vec<_> = self.branches.read().values().cloned().collect();
+        for log in logs {
+            let guard = log.read();
+            if let Some(segment) = guard.segments.get(&guard.active) {
+                segment.file.sync_data().map_err(io_err)?;
+            }
+        }
+        Ok(())
+    }
+
+    /// Rewrite sealed segments of `branch` whose dead ratio exceeds the configured threshold.
+    pub fn compact(&self, branch: &BranchId) -> AcornResult<CompactionStats> {
+        match self.branch(branch, false)? {
+            Some(log) => self.compact_log(&log),
+            None => Ok(CompactionStats::default()),
+        }
+    }
+
+    /// Compact every branch that has been opened by this trunk.
+    pub fn compact_all(&self) -> AcornResult<CompactionStats> {
+        let logs: Vec<_> = self.branches.read().values().cloned().collect();
+        let mut total = CompactionStats::default();
+        for log in logs {
+            let stats = self.compact_log(&log)?;
+            total.segments_compacted += stats.segments_compacted;
+            total.bytes_copied += stats.bytes_copied;
+            total.bytes_reclaimed += stats.bytes_reclaimed;
+        }
+        Ok(total)
+    }
+
+    /// Run [`SegmentTrunk::compact_all`] on a background thread every `interval`.
+    pub fn spawn_compactor(&self, interval: Duration) -> Compactor {
+        let trunk = self.clone();
+        let stop = Arc::new(AtomicBool::new(false));
+        let flag = stop.clone();
+        let handle = std::thread::spawn(move || {
+            let tick = interval
+                .min(Duration::from_millis(50))
+                .max(Duration::from_millis(1));
+            let mut waited = Duration::ZERO;
+            while !flag.load(Ordering::Relaxed) {
+                std::thread::sleep(tick);
+                waited += tick;
+                if waited < interval {
+                    continue;
+                }
+                waited = Duration::ZERO;
+                if let Err(e) = trunk.compact_all() {
+                    tracing::warn!("segment compaction failed: {}", e);
+                }
+            }
+        });
+        Compactor {
+            stop,
+            handle: Some(handle),
+        }
+    }
+
+    /// Copy the live records of the victim segments into a new segment, then swap it in.
+    ///
+    /// The victims are chosen and their live records listed under a read lock. A short write
+    /// lock then seals the active segment and reserves the id after it for the copy, so records
+    /// written while copying land in a later segment and still win on replay. The copy is
+    /// written, synced and renamed into place without any lock; the write lock is taken again
+    /// only to point the index at the copies that are still current and drop the victims.
+    /// Tombstones are not copied when no surviving older segment holds their key.
+    fn compact_log(&self, log: &RwLock<BranchLog>) -> AcornResult<CompactionStats> {
+        let _pass = self.compaction.lock();
+        let Some(plan) = log.read().plan_compaction(&self.options)? else {
+            return Ok(CompactionStats::default());
+        };
+        let (output, dir) = {
+            let mut guard = log.write();
+            (guard.reserve_segment()?, guard.dir.clone())
+        };
+
+        let copied = plan.copy_into(&dir, output)?;
+        let file = if copied.records.is_empty() {
+            None
+        } else {
+            Some(open_segment(&segment_path(&dir, output))?)
+        };
+        let stats = CompactionStats {
+            segments_compacted: plan.victims.len(),
+            bytes_copied: copied.len,
+            bytes_reclaimed: log.write().install_compaction(output, file, &plan, &copied),
+        };
+
+        // Oldest first: a dropped tombstone stays on disk until every older victim, which may
+        // hold a put of its key, is gone, so a crash part way through cannot resurrect it.
+        for id in plan.victims.keys() {
+            fs::remove_file(segment_path(&dir, *id)).map_err(io_err)?;
+        }
+        sync_dir(&dir).map_err(io_err)?;
+        Ok(stats)
+    }
+
+    fn write_entry(
+        &self,
+        branch: &BranchId,
+        key: &str,
+        expect: Expect,
+        value: &[u8],
+        expires_at: Option<SystemTime>,
+    ) -> AcornResult<u64> {
+        let log = self.branch_or_create(branch)?;
+        let mut guard = log.write();
+        // An expired entry is already gone for readers and CAS callers, so it starts over at
+        // version 1 rather than continuing from the stale one.
+        let live = guard.live(key, SystemTime::now());
+        let current = live.map(|entry| entry.version);
+        let conflict = match expect {
+            Expect::Any => false,
+            Expect::Version(expected) => current != Some(expected),
+            Expect::Unseen => guard.index.contains_key(key) || guard.tombstones.contains_key(key),
+        };
+        if conflict {
+            return Err(AcornError::VersionConflict {
+                expected: match expect {
+                    Expect::Version(expected) => Some(expected),
+                    _ => None,
+                },
+                actual: current,
+            });
+        }
+        let version = current.unwrap_or(0).saturating_add(1);
+        // A `None` expiry keeps the TTL of a still-live entry.
+        let expires_at = expires_at.or(live.and_then(|entry| entry.expires_at));
+        guard.put(&self.options, key, version, value, expires_at)?;
+        Ok(version)
+    }
+
+    fn remove_entry(&self, branch: &BranchId, key: &str, expected: Option<u64>) -> AcornResult<()> {
+        let log = self.branch(branch, false)?;
+        let mut guard = log.as_ref().map(|log| log.write());
+        let now = SystemTime::now();
+        let current = guard
+            .as_ref()
+            .and_then(|g| g.live(key, now))
+            .map(|entry| entry.version);
+        if let Some(expected) = expected {
+            if current != Some(expected) {
+                return Err(AcornError::VersionConflict {
+                    expected: Some(expected),
+                    actual: current,
+                });
+            }
+        }
+        match (guard.as_mut(), current) {
+            (Some(guard), Some(_)) => guard.delete(&self.options, key),
+            _ => Err(AcornError::MissingKey(key.to_string())),
+        }
+    }
+}
+
+/// Handle for a background compaction thread; stops the thread when dropped.
+#[derive(Debug)]
+pub struct Compactor {
+    stop: Arc<AtomicBool>,
+    handle: Option<JoinHandle<()>>,
+}
+
+impl Compactor {
+    pub fn stop(mut self) {
+        self.shutdown();
+    }
+
+    fn shutdown(&mut self) {
+        self.stop.store(true, Ordering::Relaxed);
+        if let Some(handle) = self.handle.take() {
+            let _ = handle.join();
+        }
+    }
+}
+
+impl Drop for Compactor {
+    fn drop(&mut self) {
+        self.shutdown();
+    }
+}
+
+impl BranchLog {
+    fn open(dir: PathBuf) -> AcornResult<Self> {
+        fs::create_dir_all(&dir).map_err(io_err)?;
+        // A compaction copy that never got renamed into place; its victims are all still here
+        for entry in fs::read_dir(&dir).map_err(io_err)?.flatten() {
+            if entry.path().extension().is_some_and(|ext| ext == "tmp") {
+                fs::remove_file(entry.path()).map_err(io_err)?;
+            }
+        }
+        let mut ids: Vec<u32> = fs::read_dir(&dir)
+            .map_err(io_err)?
+            .flatten()
+            .filter_map(|entry| {
+                let path = entry.path();
+                if path.extension()? != SEGMENT_EXT {
+                    return None;
+                }
+                path.file_stem()?.to_str()?.parse().ok()
+            })
+            .collect();
+        ids.sort_unstable();
+
+        let mut log = BranchLog {
+            dir,
+            segments: BTreeMap::new(),
+            active: 0,
+            index: HashMap::new(),
+            tombstones: HashMap::new(),
+            expiry: ExpiryIndex::new(),
+        };
+
+        let last = ids.last().copied();
+        for id in ids {
+            let path = log.segment_path(id);
+            let file = open_segment(&path)?;
+            log.segments.insert(
+                id,
+                Segment {
+                    file: file.try_clone().map_err(io_err)?,
+                    len: 0,
+                    dead: 0,
+                },
+            );
+            let valid_len = log.replay(id, file)?;
+            let actual_len = fs::metadata(&path).map_err(io_err)?.len();
+            if valid_len < actual_len {
+                if Some(id) != last {
+                    return Err(AcornError::Trunk(format!(
+                        "corrupt record in sealed segment {} at offset {}",
+                        path.display(),
+                        valid_len
+                    )));
+                }
+                tracing::warn!(
+                    "truncating torn tail of {} ({} -> {} bytes)",
+                    path.display(),
+                    actual_len,
+                    valid_len
+                );
+                let segment = &log.segments[&id];
+                segment.file.set_len(valid_len).map_err(io_err)?;
+            }
+            if let Some(segment) = log.segments.get_mut(&id) {
+                segment.len = valid_len;
+            }
+            log.active = id;
+        }
+
+        if log.segments.is_empty() {
+            log.create_segment(1)?;
+        }
+        Ok(log)
+    }
+
+    fn segment_path(&self, id: u32) -> PathBuf {
+        segment_path(&self.dir, id)
+    }
+
+    fn create_segment(&mut self, id: u32) -> AcornResult<()> {
+        let file = open_segment(&self.segment_path(id))?;
+        self.segments.insert(
+            id,
+            Segment {
+                file,
+                len: 0,
+                dead: 0,
+            },
+        );
+        self.active = id;
+        Ok(())
+    }
+
+    /// Replay one segment into the index, returning the length of its valid prefix.
+    fn replay(&mut self, id: u32, file: File) -> AcornResult<u64> {
+        let mut reader = BufReader::with_capacity(256 * 1024, file);
+        let mut offset = 0u64;
+        let mut header = [0u8; HEADER_LEN as usize];
+        let mut body = Vec::new();
+        loop {
+            if read_full(&mut reader, &mut header).map_err(io_err)? < header.len() {
+                break;
+            }
+            let body_len = u32::from_le_bytes(header[0..4].try_into().unwrap());
+            let crc = u32::from_le_bytes(header[4..8].try_into().unwrap());
+            if body_len as u64 <= BODY_FIXED_LEN || body_len > MAX_BODY_LEN {
+                break;
+            }
+            body.resize(body_len as usize, 0);
+            if read_full(&mut reader, &mut body).map_err(io_err)? < body.len() || crc32(&body) != crc {
+                break;
+            }
+            let Some(record) = decode_body(&body) else {
+                break;
+            };
+            let loc = Location {
+                segment: id,
+                offset,
+                len: (HEADER_LEN + body_len as u64) as u32,
+            };
+            self.apply(record, loc);
+            offset += loc.len as u64;
+        }
+        Ok(offset)
+    }
+
+    fn apply(&mut self, record: DecodedRecord, loc: Location) {
+        match record.kind {
+            RECORD_PUT => {
+                let entry = IndexEntry {
+                    loc,
+                    key_len: record.key.len() as u32,
+                    value_len: record.value_len,
+                    version: record.version,
+                    expires_at: (record.expires_ms != 0)
+                        .then(|| SystemTime::UNIX_EPOCH + Duration::from_millis(record.expires_ms)),
+                };
+                if let Some(tomb) = self.tombstones.remove(&record.key) {
+                    self.mark_dead(tomb.loc);
+                }
+                if entry.expires_at.is_some() || !self.expiry.is_empty() {
+                    self.expiry.set(&record.key, entry.expires_at);
+                }
+                if let Some(prev) = self.index.insert(record.key, entry) {
+                    self.mark_dead(prev.loc);
+                }
+            }
+            _ => {
+                if let Some(prev) = self.index.remove(&record.key) {
+                    self.mark_dead(prev.loc);
+                    if prev.expires_at.is_some() {
+                        self.expiry.remove(&record.key);
+                    }
+                }
+                let tomb = Tombstone {
+                    version: (record.version != 0).then_some(record.version),
+                    loc,
+                };
+                if let Some(prev) = self.tombstones.insert(record.key, tomb) {
+                    self.mark_dead(prev.loc);
+                }
+            }
+        }
+    }
+
+    /// Index entry of `key` unless it has expired; expired entries wait for a read or purge to
+    /// drop them but count as absent until then.
+    fn live(&self, key: &str, now: SystemTime) -> Option<IndexEntry> {
+        self.index
+            .get(key)
+            .filter(|entry| !entry.is_expired(now))
+            .copied()
+    }
+
+    fn mark_dead(&mut self, loc: Location) {
+        if let Some(segment) = self.segments.get_mut(&loc.segment) {
+            segment.dead += loc.len as u64;
+        }
+    }
+
+    fn append(&mut self, options: &SegmentOptions, record: &[u8]) -> AcornResult<Location> {
+        let active_len = self.segments[&self.active].len;
+        if active_len > 0 && active_len + record.len() as u64 > options.max_segment_bytes {
+            self.create_segment(self.active + 1)?;
+        }
+
+        let id = self.active;
+        let segment = self.segments.get_mut(&id).expect("active segment is open");
+        let offset = segment.len;
+        if let Err(e) = (&segment.file).write_all(record) {
+            let _ = segment.file.set_len(offset);
+            return Err(io_err(e));
+        }
+        if options.sync_on_write {
+            segment.file.sync_data().map_err(io_err)?;
+        }
+        segment.len += record.len() as u64;
+        Ok(Location {
+            segment: id,
+            offset,
+            len: record.len() as u32,
+        })
+    }
+
+    fn put(
+        &mut self,
+        options: &SegmentOptions,
+        key: &str,
+        version: u64,
+        value: &[u8],
+        expires_at: Option<SystemTime>,
+    ) -> AcornResult<()> {
+        let expires_ms = match expires_at {
+            Some(at) => at
+                .duration_since(SystemTime::UNIX_EPOCH)
+                .map_err(|e| AcornError::Trunk(e.to_string()))?
+                .as_millis() as u64,
+            None => 0,
+        };
+        let record = encode_record(RECORD_PUT, key, version, expires_ms, value)?;
+        let loc = self.append(options, &record)?;
+        self.apply(
+            DecodedRecord {
+                kind: RECORD_PUT,
+                version,
+                expires_ms,
+                key: key.to_string(),
+                value_len: value.len() as u32,
+            },
+            loc,
+        );
+        Ok(())
+    }
+
+    fn delete(&mut self, options: &SegmentOptions, key: &str) -> AcornResult<()> {
+        let version = self.index.get(key).map(|entry| entry.version).unwrap_or(0);
+        let record = encode_record(RECORD_DELETE, key, version, 0, &[])?;
+        let loc = self.append(options, &record)?;
+        self.apply(
+            DecodedRecord {
+                kind: RECORD_DELETE,
+                version,
+                expires_ms: 0,
+                key: key.to_string(),
+                value_len: 0,
+            },
+            loc,
+        );
+        Ok(())
+    }
+
+    fn read_value(&self, entry: &IndexEntry) -> AcornResult<Vec<u8>> {
+        let segment = self
+            .segments
+            .get(&entry.loc.segment)
+            .ok_or_else(|| AcornError::Trunk(format!("segment {} missing", entry.loc.segment)))?;
+        let mut value = vec![0u8; entry.value_len as usize];
+        read_at(&segment.file, &mut value, entry.value_offset()).map_err(io_err)?;
+        Ok(value)
+    }
+
+    /// Victims and the live records in them, or `None` when no sealed segment is dead enough.
+    fn plan_compaction(&self, options: &SegmentOptions) -> AcornResult<Option<CompactionPlan>> {
+        let victims: BTreeMap<u32, (File, u64)> = self
+            .segments
+            .iter()
+            .filter(|(id, segment)| {
+                **id != self.active
+                    && segment.len > 0
+                    && segment.dead as f64 / segment.len as f64 >= options.compaction_ratio
+            })
+            .map(|(id, segment)| Ok((*id, (segment.file.try_clone().map_err(io_err)?, segment.len))))
+            .collect::<AcornResult<_>>()?;
+        if victims.is_empty() {
+            return Ok(None);
+        }
+
+        let records: Vec<(String, bool, Location)> = self
+            .index
+            .iter()
+            .map(|(k, e)| (k.clone(), false, e.loc))
+            .chain(self.tombstones.iter().map(|(k, t)| (k.clone(), true, t.loc)))
+            .filter(|(_, _, loc)| victims.contains_key(&loc.segment))
+            .collect();
+
+        // Sealed segments that outlive this pass and are older than some victim tombstone;
+        // they are scanned for the tombstoned keys while copying
+        let newest_tombstone = records
+            .iter()
+            .filter(|(_, is_tombstone, _)| *is_tombstone)
+            .map(|(_, _, loc)| loc.segment)
+            .max();
+        let older = match newest_tombstone {
+            Some(newest) => self
+                .segments
+                .range(..newest)
+                .filter(|(id, _)| !victims.contains_key(id))
+                .map(|(id, segment)| Ok((*id, (segment.file.try_clone().map_err(io_err)?, segment.len))))
+                .collect::<AcornResult<_>>()?,
+            None => BTreeMap::new(),
+        };
+
+        Ok(Some(CompactionPlan {
+            victims,
+            records,
+            older,
+        }))
+    }
+
+    /// Seal the active segment and return an id that sorts after everything written so far
+    /// and before everything written from now on. An empty active segment gives up its own id.
+    fn reserve_segment(&mut self) -> AcornResult<u32> {
+        let active = self.active;
+        if self.segments[&active].len == 0 {
+            self.create_segment(active + 1)?;
+            self.segments.remove(&active);
+            fs::remove_file(self.segment_path(active)).map_err(io_err)?;
+            return Ok(active);
+        }
+        self.create_segment(active + 2)?;
+        Ok(active + 1)
+    }
+
+    /// Point the index at the copies still current and drop the victims from the segment map.
+    /// Records superseded while copying count as dead in the new segment. Returns the bytes
+    /// reclaimed: what the victims occupied less what was copied out of them.
+    fn install_compaction(
+        &mut self,
+        output: u32,
+        file: Option<File>,
+        plan: &CompactionPlan,
+        copied: &CopiedRecords,
+    ) -> u64 {
+        let mut dead = 0u64;
+        for ((key, is_tombstone, old), new_loc) in &copied.records {
+            let current = if *is_tombstone {
+                self.tombstones.get_mut(key).map(|tomb| &mut tomb.loc)
+            } else {
+                self.index.get_mut(key).map(|entry| &mut entry.loc)
+            };
+            match current {
+                Some(loc) if loc == old => *loc = *new_loc,
+                _ => dead += new_loc.len as u64,
+            }
+        }
+        for (key, loc) in &copied.dropped {
+            if self.tombstones.get(key).is_some_and(|tomb| tomb.loc == *loc) {
+                self.tombstones.remove(key);
+            }
+        }
+        if let Some(file) = file {
+            self.segments.insert(
+                output,
+                Segment {
+                    file,
+                    len: copied.len,
+                    dead,
+                },
+            );
+        }
+
+        let mut removed = 0;
+        for id in plan.victims.keys() {
+            if let Some(segment) = self.segments.remove(id) {
+                removed += segment.len;
+            }
+        }
+        removed.saturating_sub(copied.len)
+    }
+}
+
+/// What a compaction pass copies, captured under the branch's read lock.
+struct CompactionPlan {
+    /// Victim segments with a handle and their length.
+    victims: BTreeMap<u32, (File, u64)>,
+    /// `(key, is_tombstone, location)` of every live record in a victim.
+    records: Vec<(String, bool, Location)>,
+    /// Surviving sealed segments older than some victim tombstone.
+    older: BTreeMap<u32, (File, u64)>,
+}
+
+/// Records written to a compaction segment.
+struct CopiedRecords {
+    /// Each copied record and where its copy lives.
+    records: Vec<((String, bool, Location), Location)>,
+    /// Tombstones left out of the copy.
+    dropped: Vec<(String, Location)>,
+    len: u64,
+}
+
+impl CompactionPlan {
+    /// Write the records worth keeping to segment `output` in `dir`: into a temporary file
+    /// first, synced and renamed into place so a crash never leaves a partial segment.
+    fn copy_into(&self, dir: &Path, output: u32) -> AcornResult<CopiedRecords> {
+        let droppable = self.droppable_tombstones()?;
+        let mut copied = CopiedRecords {
+            records: Vec::new(),
+            dropped: Vec::new(),
+            len: 0,
+        };
+        let path = segment_path(dir, output);
+        let tmp = path.with_extension(format!("{SEGMENT_EXT}.tmp"));
+        let mut writer = io::BufWriter::with_capacity(256 * 1024, File::create(&tmp).map_err(io_err)?);
+        let mut buf = Vec::new();
+        for record in &self.records {
+            let (key, is_tombstone, loc) = record;
+            if *is_tombstone && droppable.contains(key) {
+                copied.dropped.push((key.clone(), *loc));
+                continue;
+            }
+            buf.resize(loc.len as usize, 0);
+            read_at(&self.victims[&loc.segment].0, &mut buf, loc.offset).map_err(io_err)?;
+            writer.write_all(&buf).map_err(io_err)?;
+            copied.records.push((
+                record.clone(),
+                Location {
+                    segment: output,
+                    offset: copied.len,
+                    len: loc.len,
+                },
+            ));
+            copied.len += loc.len as u64;
+        }
+        let file = writer.into_inner().map_err(|e| io_err(e.into_error()))?;
+
+        if copied.records.is_empty() {
+            drop(file);
+            fs::remove_file(&tmp).map_err(io_err)?;
+            return Ok(copied);
+        }
+        // The victims may hold the only durable copy of these records, so the copy reaches
+        // disk before a victim is removed, whatever `sync_on_write` says.
+        let synced = sync_segment(&file).and_then(|()| fs::rename(&tmp, &path));
+        if let Err(e) = synced {
+            let _ = fs::remove_file(&tmp);
+            return Err(io_err(e));
+        }
+        sync_dir(dir).map_err(io_err)?;
+        Ok(copied)
+    }
+
+    /// Victim tombstones whose key appears in no surviving segment older than them.
+    fn droppable_tombstones(&self) -> AcornResult<HashSet<String>> {
+        let mut droppable: HashMap<&str, u32> = self
+            .records
+            .iter()
+            .filter(|(_, is_tombstone, _)| *is_tombstone)
+            .map(|(key, _, loc)| (key.as_str(), loc.segment))
+            .collect();
+        for (id, (file, len)) in &self.older {
+            if droppable.is_empty() {
+                break;
+            }
+            for key in segment_keys(file, *len).map_err(io_err)? {
+                if droppable.get(key.as_str()).is_some_and(|segment| id < segment) {
+                    droppable.remove(key.as_str());
+                }
+            }
+        }
+        Ok(droppable.into_keys().map(str::to_string).collect())
+    }
+}
+
+impl Trunk<Vec<u8>> for SegmentTrunk {
+    fn get(&self, branch: &BranchId, key: &str) -> AcornResult<Option<Nut<Vec<u8>>>> {
+        let Some(log) = self.branch(branch, false)? else {
+            return Ok(None);
+        };
+        {
+            let guard = log.read();
+            match guard.index.get(key) {
+                None => return Ok(None),
+                Some(entry) if !entry.is_expired(SystemTime::now()) => {
+                    return guard.read_value(entry).map(|value| Some(Nut { value }));
+                }
+                Some(_) => {}
+            }
+        }
+
+        let mut guard = log.write();
+        match guard.index.get(key).copied() {
+            Some(entry) if entry.is_expired(SystemTime::now()) => {
+                guard.delete(&self.options, key)?;
+                Ok(None)
+            }
+            Some(entry) => guard.read_value(&entry).map(|value| Some(Nut { value })),
+            None => Ok(None),
+        }
+    }
+
+    fn put(&self, branch: &BranchId, key: &str, nut: Nut<Vec<u8>>) -> AcornResult<()> {
+        self.write_entry(branch, key, Expect::Any, &nut.value, None)
+            .map(|_| ())
+    }
+
+    fn delete(&self, branch: &BranchId, key: &str) -> AcornResult<()> {
+        self.remove_entry(branch, key, None)
+    }
+
+    fn version(&self, branch: &BranchId, key: &str) -> Option<u64> {
+        self.current_version(branch, key)
+    }
+
+    fn put_if_version(
+        &self,
+        branch: &BranchId,
+        key: &str,
+        expected: Option<u64>,
+        nut: Nut<Vec<u8>>,
+    ) -> AcornResult<()> {
+        self.put_if_version_returning(branch, key, expected, nut)
+            .map(|_| ())
+    }
+
+    fn delete_if_version(&self, branch: &BranchId, key: &str, expected: Option<u64>) -> AcornResult<()> {
+        self.remove_entry(branch, key, expected)
+    }
+}
+
+impl KeyedTrunk<Vec<u8>> for SegmentTrunk {
+    fn keys(&self, branch: &BranchId) -> Vec<String> {
+        SegmentTrunk::keys(self, branch)
+    }
+}
+
+impl TombstoneProvider<Vec<u8>> for SegmentTrunk {
+    fn tombstones(&self, branch: &BranchId) -> Vec<(String, Option<u64>)> {
+        let Ok(Some(log)) = self.branch(branch, false) else {
+            return Vec::new();
+        };
+        let guard = log.read();
+        guard
+            .tombstones
+            .iter()
+            .map(|(k, t)| (k.clone(), t.version))
+            .collect()
+    }
+}
+
+impl TtlProvider<Vec<u8>> for SegmentTrunk {
+    fn put_with_ttl(&self, branch: &BranchId, key: &str, nut: Nut<Vec<u8>>, ttl: Ttl) -> AcornResult<()> {
+        self.write_entry(branch, key, Expect::Any, &nut.value, Some(ttl.expires_at))
+            .map(|_| ())
+    }
+}
+
+impl TtlCleaner<Vec<u8>> for SegmentTrunk {
+    fn purge_expired(&self, branch: &BranchId) -> usize {
+        let Ok(Some(log)) = self.branch(branch, false) else {
+            return 0;
+        };
+        let started = Instant::now();
+        let now = SystemTime::now();
+        if !log.read().expiry.has_due(now) {
+            self.ttl.record(started, now, []);
+            return 0;
+        }
+        let mut guard = log.write();
+        let mut purged = Vec::new();
+        for (key, deadline) in guard.expiry.take_due(now) {
+            match guard.delete(&self.options, &key) {
+                Ok(()) => purged.push(deadline),
+                Err(e) => {
+                    tracing::warn!("failed to purge expired key {}: {}", key, e);
+                    // Keep it due so the next purge retries
+                    guard.expiry.set(&key, Some(deadline));
+                }
+            }
+        }
+        self.ttl.record(started, now, purged.iter().copied());
+        purged.len()
+    }
+
+    fn ttl_stats(&self) -> TtlStats {
+        let logs: Vec<_> = self.branches.read().values().cloned().collect();
+        let tracked = logs.iter().map(|log| log.read().expiry.len()).sum();
+        self.ttl.snapshot(tracked)
+    }
+}
+
+impl CapabilityAdvertiser for SegmentTrunk {
+    fn capabilities(&self) -> &'static [TrunkCapability] {
+        &[TrunkCapability::Ttl, TrunkCapability::Versions]
+    }
+}
+
+pub(crate) fn io_err(e: io::Error) -> AcornError {
+    AcornError::Trunk(e.to_string())
+}
+
+fn segment_path(dir: &Path, id: u32) -> PathBuf {
+    dir.join(format!("{:08}.{}", id, SEGMENT_EXT))
+}
+
+/// Keys of every record in the first `len` bytes of a sealed segment, which replay has
+/// already validated.
+fn segment_keys(file: &File, len: u64) -> io::Result<Vec<String>> {
+    let mut keys = Vec::new();
+    let mut fixed = [0u8; (HEADER_LEN + BODY_FIXED_LEN) as usize];
+    let mut offset = 0u64;
+    while offset + fixed.len() as u64 <= len {
+        read_at(file, &mut fixed, offset)?;
+        let body_len = u32::from_le_bytes(fixed[0..4].try_into().unwrap());
+        let key_len = u32::from_le_bytes(fixed[25..29].try_into().unwrap());
+        let mut key = vec![0u8; key_len as usize];
+        read_at(file, &mut key, offset + fixed.len() as u64)?;
+        keys.push(String::from_utf8_lossy(&key).into_owned());
+        offset += HEADER_LEN + body_len as u64;
+    }
+    Ok(keys)
+}
+
+fn open_segment(path: &Path) -> AcornResult<File> {
+    fs::OpenOptions::new()
+        .read(true)
+        .append(true)
+        .create(true)
+        .open(path)
+        .map_err(io_err)
+}
+
+fn encode_record(kind: u8, key: &str, version: u64, expires_ms: u64, value: &[u8]) -> AcornResult<Vec<u8>> {
+    let body_len = BODY_FIXED_LEN + key.len() as u64 + value.len() as u64;
+    if body_len > MAX_BODY_LEN as u64 {
+        return Err(AcornError::Trunk(format!("record for key {} is too large", key)));
+    }
+    let mut record = Vec::with_capacity((HEADER_LEN + body_len) as usize);
+    record.extend_from_slice(&(body_len as u32).to_le_bytes());
+    record.extend_from_slice(&[0u8; 4]);
+    record.push(kind);
+    record.extend_from_slice(&version.to_le_bytes());
+    record.extend_from_slice(&expires_ms.to_le_bytes());
+    record.extend_from_slice(&(key.len() as u32).to_le_bytes());
+    record.extend_from_slice(&(value.len() as u32).to_le_bytes());
+    record.extend_from_slice(key.as_bytes());
+    record.extend_from_slice(value);
+    let crc = crc32(&record[HEADER_LEN as usize..]);
+    record[4..8].copy_from_slice(&crc.to_le_bytes());
+    Ok(record)
+}
+
+fn decode_body(body: &[u8]) -> Option<DecodedRecord> {
+    let kind = body[0];
+    if kind != RECORD_PUT && kind != RECORD_DELETE {
+        return None;
+    }
+    let version = u64::from_le_bytes(body[1..9].try_into().ok()?);
+    let expires_ms = u64::from_le_bytes(body[9..17].try_into().ok()?);
+    let key_len = u32::from_le_bytes(body[17..21].try_into().ok()?) as usize;
+    let value_len = u32::from_le_bytes(body[21..25].try_into().ok()?);
+    let key_start = BODY_FIXED_LEN as usize;
+    if key_start + key_len + value_len as usize != body.len() {
+        return None;
+    }
+    let key = std::str::from_utf8(&body[key_start..key_start + key_len]).ok()?;
+    Some(DecodedRecord {
+        kind,
+        version,
+        expires_ms,
+        key: key.to_string(),
+        value_len,
+    })
+}
+
+/// Read until `buf` is full or EOF, returning the number of bytes read.
+fn read_full<R: Read>(reader: &mut R, buf: &mut [u8]) -> io::Result<usize> {
+    let mut filled = 0;
+    while filled < buf.len() {
+        match reader.read(&mut buf[filled..]) {
+            Ok(0) => break,
+            Ok(n) => filled += n,
+            Err(e) if e.kind() == io::ErrorKind::Interrupted => continue,
+            Err(e) => return Err(e),
+        }
+    }
+    Ok(filled)
+}
+
+fn sync_segment(file: &File) -> io::Result<()> {
+    #[cfg(test)]
+    if tests::FAIL_SYNC.with(|fail| fail.get()) {
+        return Err(io::Error::other("injected sync failure"));
+    }
+    file.sync_data()
+}
+
+/// Make file creations in `dir` durable. Windows cannot open a directory for this and
+/// persists its entries with the files themselves.
+#[cfg(unix)]
+fn sync_dir(dir: &Path) -> io::Result<()> {
+    File::open(dir)?.sync_all()
+}
+
+#[cfg(windows)]
+fn sync_dir(_dir: &Path) -> io::Result<()> {
+    Ok(())
+}
+
+#[cfg(unix)]
+fn read_at(file: &File, buf: &mut [u8], offset: u64) -> io::Result<()> {
+    use std::os::unix::fs::FileExt;
+    file.read_exact_at(buf, offset)
+}
+
+#[cfg(windows)]
+fn read_at(file: &File, buf: &mut [u8], offset: u64) -> io::Result<()> {
+    use std::os::windows::fs::FileExt;
+    let mut filled = 0;
+    while filled < buf.len() {
+        let n = file.seek_read(&mut buf[filled..], offset + filled as u64)?;
+        if n == 0 {
+            return Err(io::ErrorKind::UnexpectedEof.into());
+        }
+        filled += n;
+    }
+    Ok(())
+}
+
+const CRC_TABLE: [u32; 256] = {
+    let mut table = [0u32; 256];
+    let mut i = 0;
+    while i < 256 {
+        let mut c = i as u32;
+        let mut k = 0;
+        while k < 8 {
+            c = if c & 1 != 0 {
+                0xEDB8_8320 ^ (c >> 1)
+            } else {
+                c >> 1
+            };
+            k += 1;
+        }
+        table[i] = c;
+        i += 1;
+    }
+    table
+};
+
+/// CRC-32 (IEEE) used to detect torn or corrupt records.
+pub(crate) fn crc32(bytes: &[u8]) -> u32 {
+    let mut crc = !0u32;
+    for b in bytes {
+        crc = CRC_TABLE[((crc ^ *b as u32) & 0xff) as usize] ^ (crc >> 8);
+    }
+    !crc
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    #[cfg(feature = "contract-tests")]
+    use acorn_test_harness::TrunkContract;
+    use std::cell::Cell;
+    use std::collections::BTreeSet;
+
+    thread_local! {
+        /// Makes compaction's segment syncs fail on this thread.
+        pub(super) static FAIL_SYNC: Cell<bool> = const { Cell::new(false) };
+    }
+
+    fn nut(bytes: &[u8]) -> Nut<Vec<u8>> {
+        Nut {
+            value: bytes.to_vec(),
+        }
+    }
+
+    #[test]
+    fn crc32_matches_reference_vector() {
+        assert_eq!(crc32(b"123456789"), 0xCBF4_3926);
+    }
+
+    #[test]
+    fn put_get_delete_round_trip() {
+        let tmp_dir = tempfile::tempdir().unwrap();
+        let trunk = SegmentTrunk::new(tmp_dir.path());
+        let branch = BranchId::new("main");
+
+        trunk.put(&branch, "key", nut(b"hello")).unwrap();
+        assert_eq!(
+            trunk.get(&branch, "key").unwrap().unwrap().value,
+            b"hello".to_vec()
+        );
+        assert_eq!(trunk.current_version(&branch, "key"), Some(1));
+
+        trunk.delete(&branch, "key").unwrap();
+        assert!(trunk.get(&branch, "key").unwrap().is_none());
+        assert_eq!(trunk.tombstones(&branch), vec![("key".to_string(), Some(1))]);
+        assert!(matches!(
+            trunk.delete(&branch, "key"),
+            Err(AcornError::MissingKey(_))
+        ));
+    }
+
+    #[test]
+    fn cas_put_and_delete_use_index_versions() {
+        let tmp_dir = tempfile::tempdir().unwrap();
+        let trunk = SegmentTrunk::new(tmp_dir.path());
+        let branch = BranchId::new("cas");
+
+        trunk.put_if_version(&branch, "key", None, nut(b"v1")).unwrap();
+        trunk.put_if_version(&branch, "key", Some(1), nut(b"v2")).unwrap();
+        assert!(matches!(
+            trunk.put_if_version(&branch, "key", Some(1), nut(b"v3")),
+            Err(AcornError::VersionConflict {
+                expected: Some(1),
+                actual: Some(2)
+            })
+        ));
+        assert!(trunk.delete_if_version(&branch, "key", Some(2)).is_ok());
+        assert!(matches!(
+            trunk.delete_if_version(&branch, "key", Some(2)),
+            Err(AcornError::VersionConflict {
+                expected: Some(2),
+                actual: None
+            })
+        ));
+    }
+
+    #[test]
+    fn reopen_rebuilds_index_versions_and_tombstones() {
+        let tmp_dir = tempfile::tempdir().unwrap();
+        let branch = BranchId::new("reopen");
+        {
+            let trunk = SegmentTrunk::new(tmp_dir.path());
+            trunk.put(&branch, "a", nut(b"a1")).unwrap();
+            trunk.put(&branch, "a", nut(b"a2")).unwrap();
+            trunk.put(&branch, "b", nut(b"b1")).unwrap();
+            trunk.delete(&branch, "b").unwrap();
+        }
+
+        let trunk = SegmentTrunk::new(tmp_dir.path());
+        assert_eq!(trunk.get(&branch, "a").unwrap().unwrap().value, b"a2".to_vec());
+        assert_eq!(trunk.current_version(&branch, "a"), Some(2));
+        assert!(trunk.get(&branch, "b").unwrap().is_none());
+        assert_eq!(trunk.keys(&branch), vec!["a".to_string()]);
+        assert_eq!(trunk.tombstones(&branch), vec![("b".to_string(), Some(1))]);
+    }
+
+    #[test]
+    fn torn_tail_is_truncated_on_replay() {
+        let tmp_dir = tempfile::tempdir().unwrap();
+        let branch = BranchId::new("torn");
+        {
+            let trunk = SegmentTrunk::new(tmp_dir.path());
+            trunk.put(&branch, "ok", nut(b"intact")).unwrap();
+        }
+        let segment = tmp_dir.path().join("torn/segments/00000001.seg");
+        let intact_len = fs::metadata(&segment).unwrap().len();
+        let mut file = fs::OpenOptions::new().append(true).open(&segment).unwrap();
+        file.write_all(&[42, 0, 0, 0, 1, 2]).unwrap();
+        drop(file);
+
+        let trunk = SegmentTrunk::new(tmp_dir.path());
+        assert_eq!(
+            trunk.get(&branch, "ok").unwrap().unwrap().value,
+            b"intact".to_vec()
+        );
+        assert_eq!(fs::metadata(&segment).unwrap().len(), intact_len);
+
+        trunk.put(&branch, "next", nut(b"after")).unwrap();
+        drop(trunk);
+        let trunk = SegmentTrunk::new(tmp_dir.path());
+        assert_eq!(
+            trunk.get(&branch, "next").unwrap().unwrap().value,
+            b"after".to_vec()
+        );
+    }
+
+    #[test]
+    fn segments_roll_over_and_compaction_reclaims_dead_space() {
+        let tmp_dir = tempfile::tempdir().unwrap();
+        let options = SegmentOptions {
+            max_segment_bytes: 256,
+            compaction_ratio: 0.5,
+            sync_on_write: false,
+        };
+        let trunk = SegmentTrunk::with_options(tmp_dir.path(), options.clone());
+        let branch = BranchId::new("compact");
+
+        for round in 0..10u8 {
+            for key in ["a", "b", "c"] {
+                trunk.put(&branch, key, nut(&[round; 32])).unwrap();
+            }
+        }
+        trunk.put(&branch, "gone", nut(b"x")).unwrap();
+        trunk.delete(&branch, "gone").unwrap();
+
+        let before = trunk.stats(&branch).unwrap();
+        assert!(before.segments > 1);
+        assert!(before.dead_bytes > 0);
+
+        let stats = trunk.compact(&branch).unwrap();
+        assert!(stats.segments_compacted > 0);
+        assert!(stats.bytes_reclaimed > 0);
+        let after = trunk.stats(&branch).unwrap();
+        assert!(after.total_bytes < before.total_bytes);
+
+        for key in ["a", "b", "c"] {
+            assert_eq!(trunk.get(&branch, key).unwrap().unwrap().value, vec![9u8; 32]);
+            assert_eq!(trunk.current_version(&branch, key), Some(10));
+        }
+        assert_eq!(trunk.tombstones(&branch), vec![("gone".to_string(), Some(1))]);
+
+        drop(trunk);
+        let trunk = SegmentTrunk::with_options(tmp_dir.path(), options);
+        for key in ["a", "b", "c"] {
+            assert_eq!(trunk.get(&branch, key).unwrap().unwrap().value, vec![9u8; 32]);
+        }
+        assert_eq!(trunk.tombstones(&branch), vec![("gone".to_string(), Some(1))]);
+    }
+
+    fn segment_files(dir: &Path) -> BTreeSet<PathBuf> {
+        fs::read_dir(dir)
+            .unwrap()
+            .flatten()
+            .map(|entry| entry.path())
+            .filter(|path| path.extension().is_some_and(|ext| ext == SEGMENT_EXT))
+            .collect()
+    }
+
+    #[test]
+    fn compaction_keeps_victims_until_copies_are_synced() {
+        let tmp_dir = tempfile::tempdir().unwrap();
+        let options = SegmentOptions {
+            max_segment_bytes: 256,
+            compaction_ratio: 0.5,
+            sync_on_write: false,
+        };
+        let trunk = SegmentTrunk::with_options(tmp_dir.path(), options.clone());
+        let branch = BranchId::new("compact-sync");
+        // Still live in the first segment, so compaction has to copy it
+        trunk.put(&branch, "keep", nut(b"kept")).unwrap();
+        for round in 0..10u8 {
+            for key in ["a", "b", "c"] {
+                trunk.put(&branch, key, nut(&[round; 32])).unwrap();
+            }
+        }
+        let branch_dir = trunk.segments_dir(&branch);
+        let before = segment_files(&branch_dir);
+
+        FAIL_SYNC.with(|fail| fail.set(true));
+        let failed = trunk.compact(&branch);
+        FAIL_SYNC.with(|fail| fail.set(false));
+        assert!(failed.is_err());
+        assert!(segment_files(&branch_dir).is_superset(&before));
+
+        let stats = trunk.compact(&branch).unwrap();
+        assert!(stats.segments_compacted > 0);
+        assert!(!segment_files(&branch_dir).is_superset(&before));
+        drop(trunk);
+        let trunk = SegmentTrunk::with_options(tmp_dir.path(), options);
+        for key in ["a", "b", "c"] {
+            assert_eq!(trunk.get(&branch, key).unwrap().unwrap().value, vec![9u8; 32]);
+        }
+        assert_eq!(
+            trunk.get(&branch, "keep").unwrap().unwrap().value,
+            b"kept".to_vec()
+        );
+    }
+
+    #[test]
+    fn writes_during_a_compaction_copy_win_over_the_copies() {
+        let tmp_dir = tempfile::tempdir().unwrap();
+        let options = SegmentOptions {
+            max_segment_bytes: 256,
+            compaction_ratio: 0.5,
+            sync_on_write: false,
+        };
+        let trunk = SegmentTrunk::with_options(tmp_dir.path(), options.clone());
+        let branch = BranchId::new("compact-race");
+        trunk.put(&branch, "keep", nut(b"old")).unwrap();
+        trunk.put(&branch, "moved", nut(b"old")).unwrap();
+        for round in 0..10u8 {
+            trunk.put(&branch, "hot", nut(&[round; 32])).unwrap();
+        }
+
+        // The steps of compact_log, with writes landing between the copy and the swap
+        let log = trunk.branch(&branch, false).unwrap().unwrap();
+        let plan = log.read().plan_compaction(&options).unwrap().unwrap();
+        let output = log.write().reserve_segment().unwrap();
+        let dir = log.read().dir.clone();
+        let copied = plan.copy_into(&dir, output).unwrap();
+        trunk.put(&branch, "moved", nut(b"new")).unwrap();
+        trunk.put(&branch, "hot", nut(b"newest")).unwrap();
+        let file = open_segment(&segment_path(&dir, output)).unwrap();
+        log.write().install_compaction(output, Some(file), &plan, &copied);
+        for id in plan.victims.keys() {
+            fs::remove_file(segment_path(&dir, *id)).unwrap();
+        }
+        assert!(log.read().segments[&output].dead > 0);
+        drop(log);
+
+        let check = |trunk: &SegmentTrunk| {
+            assert_eq!(
+                trunk.get(&branch, "keep").unwrap().unwrap().value,
+                b"old".to_vec()
+            );
+            assert_eq!(
+                trunk.get(&branch, "moved").unwrap().unwrap().value,
+                b"new".to_vec()
+            );
+            assert_eq!(
+                trunk.get(&branch, "hot").unwrap().unwrap().value,
+                b"newest".to_vec()
+            );
+        };
+        check(&trunk);
+        drop(trunk);
+        check(&SegmentTrunk::with_options(tmp_dir.path(), options));
+    }
+
+    #[test]
+    fn compaction_drops_tombstones_no_older_segment_needs() {
+        let tmp_dir = tempfile::tempdir().unwrap();
+        let options = SegmentOptions {
+            max_segment_bytes: 256,
+            compaction_ratio: 0.5,
+            sync_on_write: false,
+        };
+        let trunk = SegmentTrunk::with_options(tmp_dir.path(), options.clone());
+        let branch = BranchId::new("compact-tombstones");
+        // "pinned" stays live in the first segment, which therefore survives compaction
+        // and keeps the tombstone of "shadowed" needed
+        trunk.put(&branch, "pinned", nut(&[0; 120])).unwrap();
+        trunk.put(&branch, "shadowed", nut(&[0; 40])).unwrap();
+        trunk.put(&branch, "gone", nut(&[0; 200])).unwrap();
+        trunk.delete(&branch, "gone").unwrap();
+        trunk.delete(&branch, "shadowed").unwrap();
+        for round in 0..10u8 {
+            trunk.put(&branch, "hot", nut(&[round; 100])).unwrap();
+        }
+        assert_eq!(trunk.tombstones(&branch).len(), 2);
+
+        let stats = trunk.compact(&branch).unwrap();
+        assert!(stats.segments_compacted > 0);
+        let expected = vec![("shadowed".to_string(), Some(1))];
+        assert_eq!(trunk.tombstones(&branch), expected);
+
+        drop(trunk);
+        let trunk = SegmentTrunk::with_options(tmp_dir.path(), options);
+        assert_eq!(trunk.tombstones(&branch), expected);
+        assert!(trunk.get(&branch, "gone").unwrap().is_none());
+        assert!(trunk.get(&branch, "shadowed").unwrap().is_none());
+        assert_eq!(trunk.get(&branch, "pinned").unwrap().unwrap().value, vec![0; 120]);
+    }
+
+    #[test]
+    fn background_compactor_runs_until_dropped() {
+        let tmp_dir = tempfile::tempdir().unwrap();
+        let trunk = SegmentTrunk::with_options(
+            tmp_dir.path(),
+            SegmentOptions {
+                max_segment_bytes: 128,
+                ..SegmentOptions::default()
+            },
+        );
+        let branch = BranchId::new("bg");
+        for round in 0..20u8 {
+            trunk.put(&branch, "hot", nut(&[round; 40])).unwrap();
+        }
+        let before = trunk.stats(&branch).unwrap();
+
+        let compactor = trunk.spawn_compactor(Duration::from_millis(5));
+        std::thread::sleep(Duration::from_millis(100));
+        compactor.stop();
+
+        assert!(trunk.stats(&branch).unwrap().segments < before.segments);
+        assert_eq!(trunk.get(&branch, "hot").unwrap().unwrap().value, vec![19u8; 40]);
+    }
+
+    #[test]
+    fn ttl_expiry_and_purge() {
+        let tmp_dir = tempfile::tempdir().unwrap();
+        let trunk = SegmentTrunk::new(tmp_dir.path());
+        let branch = BranchId::new("ttl");
+        let ttl = Ttl {
+            expires_at: SystemTime::now() + Duration::from_millis(10),
+        };
+        trunk.put_with_ttl(&branch, "short", nut(b"s"), ttl).unwrap();
+        trunk.put_with_ttl(&branch, "other", nut(b"o"), ttl).unwrap();
+        trunk.put(&branch, "keep", nut(b"k")).unwrap();
+        assert!(trunk.get(&branch, "short").unwrap().is_some());
+
+        std::thread::sleep(Duration::from_millis(20));
+        assert!(trunk.get(&branch, "short").unwrap().is_none());
+        assert_eq!(trunk.purge_expired(&branch), 1);
+        assert_eq!(trunk.keys(&branch), vec!["keep".to_string()]);
+    }
+
+    #[test]
+    fn ttl_deadlines_survive_reopen() {
+        let tmp_dir = tempfile::tempdir().unwrap();
+        let branch = BranchId::new("ttl");
+        {
+            let trunk = SegmentTrunk::new(tmp_dir.path());
+            let ttl = Ttl {
+                expires_at: SystemTime::now() + Duration::from_millis(10),
+            };
+            let later = Ttl {
+                expires_at: SystemTime::now() + Duration::from_secs(3600),
+            };
+            trunk.put_with_ttl(&branch, "short", nut(b"s"), ttl).unwrap();
+            trunk.put_with_ttl(&branch, "kept", nut(b"k"), ttl).unwrap();
+            trunk.put(&branch, "kept", nut(b"k2")).unwrap();
+            trunk.put_with_ttl(&branch, "renewed", nut(b"r"), ttl).unwrap();
+            trunk.put_with_ttl(&branch, "renewed", nut(b"r2"), later).unwrap();
+        }
+
+        // The untimed put of "kept" carried its deadline over
+        let trunk = SegmentTrunk::new(tmp_dir.path());
+        std::thread::sleep(Duration::from_millis(20));
+        assert_eq!(trunk.purge_expired(&branch), 2);
+        let stats = trunk.ttl_stats();
+        assert_eq!((stats.tracked, stats.purged, stats.purges), (1, 2, 1));
+        assert_eq!(trunk.keys(&branch), vec!["renewed".to_string()]);
+    }
+
+    #[test]
+    fn put_over_expired_entry_restarts_version() {
+        let tmp_dir = tempfile::tempdir().unwrap();
+        let trunk = SegmentTrunk::new(tmp_dir.path());
+        let branch = BranchId::new("expired-cas");
+        trunk.put(&branch, "k", nut(b"1")).unwrap();
+        trunk.put(&branch, "k", nut(b"2")).unwrap();
+        let soon = Ttl {
+            expires_at: SystemTime::now() + Duration::from_millis(5),
+        };
+        trunk.put_with_ttl(&branch, "k", nut(b"3"), soon).unwrap();
+        std::thread::sleep(Duration::from_millis(10));
+
+        // Expired reads as absent, and a CAS against "absent" creates it afresh
+        assert_eq!(trunk.current_version(&branch, "k"), None);
+        assert!(matches!(
+            trunk.put_if_version(&branch, "k", Some(3), nut(b"x")),
+            Err(AcornError::VersionConflict {
+                expected: Some(3),
+                actual: None
+            })
+        ));
+        trunk.put_if_version(&branch, "k", None, nut(b"4")).unwrap();
+        assert_eq!(trunk.current_version(&branch, "k"), Some(1));
+        trunk.put_if_version(&branch, "k", Some(1), nut(b"5")).unwrap();
+        assert_eq!(trunk.current_version(&branch, "k"), Some(2));
+        assert_eq!(trunk.ttl_stats().tracked, 0);
+
+        trunk.put_with_ttl(&branch, "plain", nut(b"a"), soon).unwrap();
+        std::thread::sleep(Duration::from_millis(10));
+        trunk.put(&branch, "plain", nut(b"b")).unwrap();
+        assert_eq!(trunk.current_version(&branch, "plain"), Some(1));
+        assert_eq!(trunk.get(&branch, "plain").unwrap().unwrap().value, b"b".to_vec());
+    }
+
+    #[test]
+    fn delete_treats_expired_entries_as_absent() {
+        let tmp_dir = tempfile::tempdir().unwrap();
+        let trunk = SegmentTrunk::new(tmp_dir.path());
+        let branch = BranchId::new("expired-delete");
+        let soon = Ttl {
+            expires_at: SystemTime::now() + Duration::from_millis(5),
+        };
+        trunk.put_with_ttl(&branch, "a", nut(b"a"), soon).unwrap();
+        trunk.put_with_ttl(&branch, "b", nut(b"b"), soon).unwrap();
+        std::thread::sleep(Duration::from_millis(10));
+
+        assert!(matches!(
+            trunk.delete_if_version(&branch, "a", Some(1)),
+            Err(AcornError::VersionConflict {
+                expected: Some(1),
+                actual: None
+            })
+        ));
+        assert!(matches!(
+            trunk.delete(&branch, "b"),
+            Err(AcornError::MissingKey(_))
+        ));
+    }
+
+    #[test]
+    fn untimed_put_keeps_the_ttl_of_a_live_entry() {
+        let tmp_dir = tempfile::tempdir().unwrap();
+        let trunk = SegmentTrunk::new(tmp_dir.path());
+        let branch = BranchId::new("keep-ttl");
+        let soon = Ttl {
+            expires_at: SystemTime::now() + Duration::from_millis(10),
+        };
+        trunk.put_with_ttl(&branch, "k", nut(b"1"), soon).unwrap();
+        trunk.put(&branch, "k", nut(b"2")).unwrap();
+        trunk.put_if_version(&branch, "k", Some(2), nut(b"3")).unwrap();
+        assert_eq!(trunk.ttl_stats().tracked, 1);
+
+        std::thread::sleep(Duration::from_millis(20));
+        assert!(trunk.get(&branch, "k").unwrap().is_none());
+        assert_eq!(trunk.purge_expired(&branch), 0);
+    }
+
+    #[cfg(feature = "contract-tests")]
+    #[test]
+    fn contract_round_trip_and_ttl() {
+        let tmp_dir = tempfile::tempdir().unwrap();
+        let trunk = SegmentTrunk::new(tmp_dir.path());
+        TrunkContract::round_trip_bytes(&trunk).unwrap();
+        TrunkContract::assert_capabilities(&trunk, &[TrunkCapability::Ttl, TrunkCapability::Versions]);
+        TrunkContract::ttl_expiry(&trunk).unwrap();
+    }
+}
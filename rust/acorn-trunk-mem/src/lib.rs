@@ -1,32 +1,134 @@
 #![allow(dead_code)]
 
+use std::collections::hash_map::RandomState;
 use std::collections::HashMap;
+use std::hash::BuildHasher;
+use std::sync::atomic::{AtomicU64, Ordering};
 use std::sync::Arc;
-use std::time::SystemTime;
+use std::time::{Instant, SystemTime};
 
 use acorn_core::{
-    AcornError, AcornResult, BranchId, CapabilityAdvertiser, HistoryEvent, HistoryProvider, KeyedTrunk, Nut,
-    TombstoneProvider, Trunk, TrunkCapability, Ttl, TtlCleaner, TtlProvider,
+    AcornError, AcornResult, BranchId, CapabilityAdvertiser, ExpiryIndex, HistoryEvent, HistoryIter,
+    HistoryProvider, KeyedTrunk, Nut, SequencedEvent, TombstoneProvider, Trunk, TrunkCapability, Ttl,
+    TtlCleaner, TtlCounters, TtlProvider, TtlStats,
 };
 use parking_lot::RwLock;
 
-#[derive(Debug, Clone, Default)]
+/// In-memory trunk. State is split per branch, and each branch is further split into
+/// hash-striped shards so writers on unrelated keys (or branches) do not contend on one lock.
+#[derive(Debug, Clone)]
 pub struct MemoryTrunk {
-    inner: Arc<RwLock<Inner>>,
+    inner: Arc<Inner>,
 }
 
-#[derive(Debug, Default)]
+#[derive(Debug)]
 struct Inner {
-    data: HashMap<(BranchId, String), Vec<u8>>,
-    history: HashMap<BranchId, Vec<HistoryEvent<Vec<u8>>>>,
-    ttl: HashMap<(BranchId, String), SystemTime>,
-    versions: HashMap<(BranchId, String), u64>,
-    tombstones: HashMap<(BranchId, String), Option<u64>>,
+    shard_mask: usize,
+    hasher: RandomState,
+    branches: RwLock<HashMap<BranchId, Arc<BranchShards>>>,
+    ttl: TtlCounters,
+}
+
+/// Per-branch state: the shard stripes plus a branch-wide sequence used to order history.
+///
+/// Sequences are taken from one atomic counter, but each event is appended to its own shard,
+/// so a reader walking the shards could see seq 11 before seq 10 has landed. `in_flight`
+/// holds, per shard, a lower bound of the sequence its writer is appending (0 when idle).
+/// Everything below the smallest of them is in history, so a reader that stops there cannot
+/// step over a sequence a slower writer has yet to append.
+#[derive(Debug)]
+struct BranchShards {
+    shards: Box<[RwLock<Shard>]>,
+    in_flight: Box<[InFlight]>,
+    sequence: AtomicU64,
+}
+
+/// On its own cache line, so writers on neighbouring shards do not contend on it.
+#[derive(Debug, Default)]
+#[repr(align(64))]
+struct InFlight(AtomicU64);
+
+/// A sequence number taken for one history append; it is committed when dropped, which must
+/// happen after the append.
+struct SeqTicket<'a> {
+    slot: &'a InFlight,
+    seq: u64,
+}
+
+impl Drop for SeqTicket<'_> {
+    fn drop(&mut self) {
+        self.slot.0.store(0, Ordering::SeqCst);
+    }
+}
+
+#[derive(Debug, Default)]
+struct Shard {
+    entries: HashMap<String, Entry>,
+    tombstones: HashMap<String, Option<u64>>,
+    history: Vec<(u64, HistoryEvent<Vec<u8>>)>,
+    /// Deadlines of the entries that have one, so purges skip the rest.
+    expiry: ExpiryIndex<String>,
+}
+
+/// What a write requires of the key it replaces.
+#[derive(Debug, Clone, Copy)]
+enum Expect {
+    Any,
+    Version(u64),
+    /// Neither live nor tombstoned.
+    Unseen,
+}
+
+#[derive(Debug)]
+struct Entry {
+    value: Vec<u8>,
+    version: u64,
+    expires_at: Option<SystemTime>,
+}
+
+impl Entry {
+    fn is_expired(&self, now: SystemTime) -> bool {
+        self.expires_at.is_some_and(|expires_at| now >= expires_at)
+    }
+
+    fn is_expired_now(&self) -> bool {
+        self.expires_at.is_some() && self.is_expired(SystemTime::now())
+    }
+}
+
+impl Default for MemoryTrunk {
+    fn default() -> Self {
+        Self::new()
+    }
 }
 
 impl MemoryTrunk {
+    /// Single-stripe trunk; branches still get independent maps.
     pub fn new() -> Self {
-        Self::default()
+        Self::sharded(1)
+    }
+
+    /// Trunk with `shards` hash-striped locks per branch (rounded up to a power of two).
+    pub fn sharded(shards: usize) -> Self {
+        let shards = shards.max(1).next_power_of_two();
+        MemoryTrunk {
+            inner: Arc::new(Inner {
+                shard_mask: shards - 1,
+                hasher: RandomState::new(),
+                branches: RwLock::new(HashMap::new()),
+                ttl: TtlCounters::default(),
+            }),
+        }
+    }
+
+    /// Trunk striped to the number of available cores.
+    pub fn sharded_for_host() -> Self {
+        let cores = std::thread::available_parallelism().map(|n| n.get()).unwrap_or(1);
+        Self::sharded(cores * 4)
+    }
+
+    pub fn shard_count(&self) -> usize {
+        self.inner.shard_mask + 1
     }
 
     pub fn health_check(&self) -> AcornResult<()> {
@@ -34,92 +136,282 @@ impl MemoryTrunk {
     }
 
     pub fn keys(&self, branch: &BranchId) -> Vec<String> {
-        let guard = self.inner.read();
-        guard
-            .data
-            .keys()
-            .filter(|(b, _)| b == branch)
-            .map(|(_, k)| k.clone())
-            .collect()
+        let Some(state) = self.branch(branch) else {
+            return Vec::new();
+        };
+        let now = SystemTime::now();
+        let mut keys = Vec::new();
+        for shard in state.shards.iter() {
+            let guard = shard.read();
+            keys.extend(
+                guard
+                    .entries
+                    .iter()
+                    .filter(|(_, entry)| !entry.is_expired(now))
+                    .map(|(k, _)| k.clone()),
+            );
+        }
+        keys
     }
 
     pub fn current_version(&self, branch: &BranchId, key: &str) -> Option<u64> {
-        let guard = self.inner.read();
-        guard.versions.get(&(branch.clone(), key.to_string())).copied()
+        let state = self.branch(branch)?;
+        let guard = state.shard(&self.inner, key).read();
+        guard
+            .entries
+            .get(key)
+            .filter(|entry| !entry.is_expired_now())
+            .map(|entry| entry.version)
+    }
+
+    fn branch(&self, branch: &BranchId) -> Option<Arc<BranchShards>> {
+        self.inner.branches.read().get(branch).cloned()
+    }
+
+    fn branch_or_insert(&self, branch: &BranchId) -> Arc<BranchShards> {
+        if let Some(state) = self.branch(branch) {
+            return state;
+        }
+        let shards = self.shard_count();
+        self.inner
+            .branches
+            .write()
+            .entry(branch.clone())
+            .or_insert_with(|| Arc::new(BranchShards::new(shards)))
+            .clone()
+    }
+
+    /// [`Trunk::put_if_version`] that returns the version it wrote, decided under the same lock
+    /// as the version check.
+    pub fn put_if_version_returning(
+        &self,
+        branch: &BranchId,
+        key: &str,
+        expected: Option<u64>,
+        nut: Nut<Vec<u8>>,
+    ) -> AcornResult<u64> {
+        let expect = expected.map_or(Expect::Any, Expect::Version);
+        self.write_entry(branch, key, expect, nut.value, None)
+    }
+
+    /// Write `key` only if it is neither live nor tombstoned, returning version 1. Otherwise
+    /// fails with [`AcornError::VersionConflict`] carrying the live version, if any.
+    pub fn create_if_unseen(&self, branch: &BranchId, key: &str, nut: Nut<Vec<u8>>) -> AcornResult<u64> {
+        self.write_entry(branch, key, Expect::Unseen, nut.value, None)
+    }
+
+    fn write_entry(
+        &self,
+        branch: &BranchId,
+        key: &str,
+        expect: Expect,
+        value: Vec<u8>,
+        expires_at: Option<SystemTime>,
+    ) -> AcornResult<u64> {
+        let state = self.branch_or_insert(branch);
+        let idx = state.shard_index(&self.inner, key);
+        let mut guard = state.shards[idx].write();
+        let (current, expired) = match guard.entries.get(key) {
+            Some(entry) if entry.is_expired_now() => (None, true),
+            Some(entry) => (Some(entry.version), false),
+            None => (None, false),
+        };
+        let conflict = match expect {
+            Expect::Any => false,
+            Expect::Version(expected) => current != Some(expected),
+            // An expired entry counts as deleted
+            Expect::Unseen => current.is_some() || expired || guard.tombstones.contains_key(key),
+        };
+        if conflict {
+            return Err(AcornError::VersionConflict {
+                expected: match expect {
+                    Expect::Version(expected) => Some(expected),
+                    _ => None,
+                },
+                actual: current,
+            });
+        }
+        // An expired entry is already gone for readers and CAS callers. Record its removal, as
+        // a read or purge would, so history and sync see it die before the key restarts at 1.
+        if expired {
+            let seq = state.next_seq(idx);
+            guard.remove(seq.seq, key);
+        }
+        let seq = state.next_seq(idx);
+        Ok(guard.store(seq.seq, key, value, expires_at))
+    }
+
+    fn remove_entry(&self, branch: &BranchId, key: &str, expected: Option<u64>) -> AcornResult<()> {
+        let Some(state) = self.branch(branch) else {
+            return match expected {
+                Some(expected) => Err(AcornError::VersionConflict {
+                    expected: Some(expected),
+                    actual: None,
+                }),
+                None => Err(AcornError::MissingKey(key.to_string())),
+            };
+        };
+        let idx = state.shard_index(&self.inner, key);
+        let mut guard = state.shards[idx].write();
+        let current = guard
+            .entries
+            .get(key)
+            .filter(|entry| !entry.is_expired_now())
+            .map(|entry| entry.version);
+        if let Some(expected) = expected {
+            if current != Some(expected) {
+                return Err(AcornError::VersionConflict {
+                    expected: Some(expected),
+                    actual: current,
+                });
+            }
+        }
+        if current.is_none() {
+            return Err(AcornError::MissingKey(key.to_string()));
+        }
+        let seq = state.next_seq(idx);
+        guard.remove(seq.seq, key);
+        Ok(())
+    }
+}
+
+impl BranchShards {
+    fn new(shards: usize) -> Self {
+        BranchShards {
+            shards: (0..shards).map(|_| RwLock::new(Shard::default())).collect(),
+            in_flight: (0..shards).map(|_| InFlight::default()).collect(),
+            sequence: AtomicU64::new(0),
+        }
+    }
+
+    fn shard_index(&self, inner: &Inner, key: &str) -> usize {
+        if inner.shard_mask == 0 {
+            return 0;
+        }
+        inner.hasher.hash_one(key) as usize & inner.shard_mask
+    }
+
+    fn shard(&self, inner: &Inner, key: &str) -> &RwLock<Shard> {
+        &self.shards[self.shard_index(inner, key)]
+    }
+
+    /// Take the next sequence number for an append to shard `idx`. Call with that shard's
+    /// write lock held and drop the ticket before taking another, so each shard has at most one
+    /// append in flight and its history stays in sequence order.
+    fn next_seq(&self, idx: usize) -> SeqTicket<'_> {
+        let slot = &self.in_flight[idx];
+        // Publish a lower bound before taking the number. A reader whose load of `sequence`
+        // already covers our number is then sure to see the bound.
+        let floor = self.sequence.load(Ordering::SeqCst) + 1;
+        slot.0.store(floor, Ordering::SeqCst);
+        let seq = self.sequence.fetch_add(1, Ordering::SeqCst) + 1;
+        SeqTicket { slot, seq }
+    }
+
+    /// Highest sequence below which every append has completed.
+    fn committed(&self) -> u64 {
+        let last = self.sequence.load(Ordering::SeqCst);
+        self.in_flight
+            .iter()
+            .map(|slot| slot.0.load(Ordering::SeqCst))
+            .filter(|floor| *floor != 0)
+            .fold(last, |committed, floor| committed.min(floor - 1))
+    }
+}
+
+impl Shard {
+    /// Insert or overwrite `key`, returning its new version. A `None` expiry keeps the TTL of a
+    /// still-live entry.
+    fn store(&mut self, seq: u64, key: &str, value: Vec<u8>, expires_at: Option<SystemTime>) -> u64 {
+        self.history.push((
+            seq,
+            HistoryEvent::Put {
+                key: key.to_string(),
+                nut: Nut { value: value.clone() },
+            },
+        ));
+        self.tombstones.remove(key);
+        let (version, expires_at) = match self.entries.get_mut(key) {
+            Some(entry) => {
+                if expires_at.is_some() {
+                    entry.expires_at = expires_at;
+                }
+                entry.version = entry.version.saturating_add(1);
+                entry.value = value;
+                (entry.version, entry.expires_at)
+            }
+            None => {
+                self.entries.insert(
+                    key.to_string(),
+                    Entry {
+                        value,
+                        version: 1,
+                        expires_at,
+                    },
+                );
+                (1, expires_at)
+            }
+        };
+        if expires_at.is_some() || !self.expiry.is_empty() {
+            self.expiry.set(&key.to_string(), expires_at);
+        }
+        version
+    }
+
+    fn remove(&mut self, seq: u64, key: &str) -> Option<Entry> {
+        let removed = self.entries.remove(key)?;
+        if removed.expires_at.is_some() {
+            self.expiry.remove(&key.to_string());
+        }
+        self.tombstones.insert(key.to_string(), Some(removed.version));
+        self.history
+            .push((seq, HistoryEvent::Delete { key: key.to_string() }));
+        Some(removed)
     }
 }
 
 impl Trunk<Vec<u8>> for MemoryTrunk {
     fn get(&self, branch: &BranchId, key: &str) -> AcornResult<Option<Nut<Vec<u8>>>> {
-        let mut guard = self.inner.write();
-        if let Some(expires_at) = guard.ttl.get(&(branch.clone(), key.to_string())) {
-            if SystemTime::now() >= *expires_at {
-                guard.ttl.remove(&(branch.clone(), key.to_string()));
-                guard.data.remove(&(branch.clone(), key.to_string()));
-                let removed_version = guard.versions.remove(&(branch.clone(), key.to_string()));
-                guard
-                    .tombstones
-                    .insert((branch.clone(), key.to_string()), removed_version);
-                guard
-                    .history
-                    .entry(branch.clone())
-                    .or_default()
-                    .push(HistoryEvent::Delete { key: key.to_string() });
-                return Ok(None);
+        let Some(state) = self.branch(branch) else {
+            return Ok(None);
+        };
+        let idx = state.shard_index(&self.inner, key);
+        let shard = &state.shards[idx];
+        {
+            let guard = shard.read();
+            match guard.entries.get(key) {
+                None => return Ok(None),
+                Some(entry) if !entry.is_expired_now() => {
+                    return Ok(Some(Nut {
+                        value: entry.value.clone(),
+                    }))
+                }
+                Some(_) => {}
             }
         }
 
-        Ok(guard
-            .data
-            .get(&(branch.clone(), key.to_string()))
-            .cloned()
-            .map(|value| Nut { value }))
+        // Expired: upgrade to a write lock and re-check, a concurrent put may have refreshed it.
+        let mut guard = shard.write();
+        match guard.entries.get(key) {
+            Some(entry) if entry.is_expired_now() => {
+                let seq = state.next_seq(idx);
+                guard.remove(seq.seq, key);
+                Ok(None)
+            }
+            Some(entry) => Ok(Some(Nut {
+                value: entry.value.clone(),
+            })),
+            None => Ok(None),
+        }
     }
 
     fn put(&self, branch: &BranchId, key: &str, nut: Nut<Vec<u8>>) -> AcornResult<()> {
-        let mut guard = self.inner.write();
-        let next_version = guard
-            .versions
-            .get(&(branch.clone(), key.to_string()))
-            .copied()
-            .unwrap_or(0)
-            .saturating_add(1);
-        guard
-            .versions
-            .insert((branch.clone(), key.to_string()), next_version);
-        guard
-            .history
-            .entry(branch.clone())
-            .or_default()
-            .push(HistoryEvent::Put {
-                key: key.to_string(),
-                nut: Nut {
-                    value: nut.value.clone(),
-                },
-            });
-        guard.tombstones.remove(&(branch.clone(), key.to_string()));
-        guard.data.insert((branch.clone(), key.to_string()), nut.value);
-        Ok(())
+        self.write_entry(branch, key, Expect::Any, nut.value, None)
+            .map(|_| ())
     }
 
     fn delete(&self, branch: &BranchId, key: &str) -> AcornResult<()> {
-        let mut guard = self.inner.write();
-        guard
-            .data
-            .remove(&(branch.clone(), key.to_string()))
-            .map(|_| {
-                let removed_version = guard.versions.remove(&(branch.clone(), key.to_string()));
-                guard
-                    .tombstones
-                    .insert((branch.clone(), key.to_string()), removed_version);
-                guard
-                    .history
-                    .entry(branch.clone())
-                    .or_default()
-                    .push(HistoryEvent::Delete { key: key.to_string() });
-            })
-            .ok_or_else(|| AcornError::MissingKey(key.to_string()))?;
-        Ok(())
+        self.remove_entry(branch, key, None)
     }
 
     fn version(&self, branch: &BranchId, key: &str) -> Option<u64> {
@@ -133,64 +425,12 @@ impl Trunk<Vec<u8>> for MemoryTrunk {
         expected: Option<u64>,
         nut: Nut<Vec<u8>>,
     ) -> AcornResult<()> {
-        let mut guard = self.inner.write();
-        let current = guard.versions.get(&(branch.clone(), key.to_string())).copied();
-        if let Some(expected) = expected {
-            if current != Some(expected) {
-                return Err(AcornError::VersionConflict {
-                    expected: Some(expected),
-                    actual: current,
-                });
-            }
-        }
-        let next_version = current.unwrap_or(0).saturating_add(1);
-        guard
-            .versions
-            .insert((branch.clone(), key.to_string()), next_version);
-        guard
-            .history
-            .entry(branch.clone())
-            .or_default()
-            .push(HistoryEvent::Put {
-                key: key.to_string(),
-                nut: Nut {
-                    value: nut.value.clone(),
-                },
-            });
-        guard.tombstones.remove(&(branch.clone(), key.to_string()));
-        guard.data.insert((branch.clone(), key.to_string()), nut.value);
-        Ok(())
+        self.put_if_version_returning(branch, key, expected, nut)
+            .map(|_| ())
     }
 
     fn delete_if_version(&self, branch: &BranchId, key: &str, expected: Option<u64>) -> AcornResult<()> {
-        let mut guard = self.inner.write();
-        let current = guard.versions.get(&(branch.clone(), key.to_string())).copied();
-        if let Some(expected) = expected {
-            if current != Some(expected) {
-                return Err(AcornError::VersionConflict {
-                    expected: Some(expected),
-                    actual: current,
-                });
-            }
-        }
-
-        guard
-            .data
-            .remove(&(branch.clone(), key.to_string()))
-            .map(|_| {
-                let removed_version = guard.versions.remove(&(branch.clone(), key.to_string()));
-                guard
-                    .tombstones
-                    .insert((branch.clone(), key.to_string()), removed_version);
-                guard
-                    .history
-                    .entry(branch.clone())
-                    .or_default()
-                    .push(HistoryEvent::Delete { key: key.to_string() });
-            })
-            .ok_or_else(|| AcornError::MissingKey(key.to_string()))?;
-
-        Ok(())
+        self.remove_entry(branch, key, expected)
     }
 }
 
@@ -202,42 +442,50 @@ impl KeyedTrunk<Vec<u8>> for MemoryTrunk {
 
 impl TombstoneProvider<Vec<u8>> for MemoryTrunk {
     fn tombstones(&self, branch: &BranchId) -> Vec<(String, Option<u64>)> {
-        let guard = self.inner.read();
-        guard
-            .tombstones
-            .iter()
-            .filter(|((b, _), _)| b == branch)
-            .map(|((_, k), v)| (k.clone(), *v))
-            .collect()
+        let Some(state) = self.branch(branch) else {
+            return Vec::new();
+        };
+        let mut tombstones = Vec::new();
+        for shard in state.shards.iter() {
+            let guard = shard.read();
+            tombstones.extend(guard.tombstones.iter().map(|(k, v)| (k.clone(), *v)));
+        }
+        tombstones
     }
 }
 
 impl TtlCleaner<Vec<u8>> for MemoryTrunk {
     fn purge_expired(&self, branch: &BranchId) -> usize {
-        let mut guard = self.inner.write();
+        let Some(state) = self.branch(branch) else {
+            return 0;
+        };
+        let started = Instant::now();
         let now = SystemTime::now();
-        let mut removed = 0usize;
-        let keys: Vec<_> = guard
-            .ttl
-            .iter()
-            .filter(|((b, _), expires)| b == branch && **expires <= now)
-            .map(|((_, k), _)| k.clone())
-            .collect();
-        for key in keys {
-            removed += 1;
-            guard.ttl.remove(&(branch.clone(), key.clone()));
-            guard.data.remove(&(branch.clone(), key.clone()));
-            let removed_version = guard.versions.remove(&(branch.clone(), key.clone()));
-            guard
-                .tombstones
-                .insert((branch.clone(), key.clone()), removed_version);
-            guard
-                .history
-                .entry(branch.clone())
-                .or_default()
-                .push(HistoryEvent::Delete { key });
+        let mut deadlines = Vec::new();
+        for (idx, shard) in state.shards.iter().enumerate() {
+            // Shards with nothing due cost a read lock and a peek at their earliest deadline
+            if !shard.read().expiry.has_due(now) {
+                continue;
+            }
+            let mut guard = shard.write();
+            for (key, deadline) in guard.expiry.take_due(now) {
+                let seq = state.next_seq(idx);
+                guard.remove(seq.seq, &key);
+                deadlines.push(deadline);
+            }
         }
-        removed
+        self.inner.ttl.record(started, now, deadlines.iter().copied());
+        deadlines.len()
+    }
+
+    fn ttl_stats(&self) -> TtlStats {
+        let branches: Vec<_> = self.inner.branches.read().values().cloned().collect();
+        let tracked = branches
+            .iter()
+            .flat_map(|state| state.shards.iter())
+            .map(|shard| shard.read().expiry.len())
+            .sum();
+        self.inner.ttl.snapshot(tracked)
     }
 }
 
@@ -253,38 +501,56 @@ impl CapabilityAdvertiser for MemoryTrunk {
 
 impl TtlProvider<Vec<u8>> for MemoryTrunk {
     fn put_with_ttl(&self, branch: &BranchId, key: &str, nut: Nut<Vec<u8>>, ttl: Ttl) -> AcornResult<()> {
-        let mut guard = self.inner.write();
-        let next_version = guard
-            .versions
-            .get(&(branch.clone(), key.to_string()))
-            .copied()
-            .unwrap_or(0)
-            .saturating_add(1);
-        guard
-            .versions
-            .insert((branch.clone(), key.to_string()), next_version);
-        guard
-            .ttl
-            .insert((branch.clone(), key.to_string()), ttl.expires_at);
-        guard
-            .history
-            .entry(branch.clone())
-            .or_default()
-            .push(HistoryEvent::Put {
-                key: key.to_string(),
-                nut: Nut {
-                    value: nut.value.clone(),
-                },
-            });
-        guard.data.insert((branch.clone(), key.to_string()), nut.value);
-        Ok(())
+        self.write_entry(branch, key, Expect::Any, nut.value, Some(ttl.expires_at))
+            .map(|_| ())
     }
 }
 
 impl HistoryProvider<Vec<u8>> for MemoryTrunk {
     fn history(&self, branch: &BranchId) -> AcornResult<Vec<HistoryEvent<Vec<u8>>>> {
-        let guard = self.inner.read();
-        Ok(guard.history.get(branch).cloned().unwrap_or_else(Vec::new))
+        Ok(self
+            .sequenced_history(branch, 0)
+            .into_iter()
+            .map(|sequenced| sequenced.event)
+            .collect())
+    }
+
+    fn history_since<'a>(&'a self, branch: &BranchId, since: u64) -> AcornResult<HistoryIter<'a, Vec<u8>>>
+    where
+        Vec<u8>: 'a,
+    {
+        Ok(Box::new(
+            self.sequenced_history(branch, since).into_iter().map(Ok),
+        ))
+    }
+}
+
+impl MemoryTrunk {
+    fn sequenced_history(&self, branch: &BranchId, since: u64) -> Vec<SequencedEvent<Vec<u8>>> {
+        let Some(state) = self.branch(branch) else {
+            return Vec::new();
+        };
+        // Shards are read one at a time, so a later shard may already hold a sequence whose
+        // predecessor lands in an earlier one after it was read. Events past the watermark
+        // taken up front are left for the next call.
+        let committed = state.committed();
+        let mut events = Vec::new();
+        for shard in state.shards.iter() {
+            let guard = shard.read();
+            // Each shard appends in sequence order, so only its tail can be newer than `since`.
+            let start = guard.history.partition_point(|(seq, _)| *seq <= since);
+            let end = guard.history.partition_point(|(seq, _)| *seq <= committed);
+            events.extend(
+                guard.history[start..end.max(start)]
+                    .iter()
+                    .map(|(seq, event)| SequencedEvent {
+                        seq: *seq,
+                        event: event.clone(),
+                    }),
+            );
+        }
+        events.sort_unstable_by_key(|sequenced| sequenced.seq);
+        events
     }
 }
 
@@ -294,8 +560,6 @@ mod tests {
     use acorn_core::{CapabilityAdvertiser, EncodedTree, JsonCodec, Tree};
     #[cfg(feature = "contract-tests")]
     use acorn_test_harness::TrunkContract;
-    #[cfg(feature = "contract-tests")]
-    use acorn_test_harness::TrunkContract;
     use serde::{Deserialize, Serialize};
 
     #[test]
@@ -336,8 +600,7 @@ mod tests {
             .unwrap();
         trunk.delete(&branch, "key").unwrap();
 
-        let inner = trunk.inner.read();
-        let history = inner.history.get(&branch).cloned().unwrap();
+        let history = trunk.history(&branch).unwrap();
         assert_eq!(history.len(), 2);
         match &history[0] {
             HistoryEvent::Put { key, nut } => {
@@ -477,6 +740,274 @@ mod tests {
         assert!(matches!(res, Err(AcornError::VersionConflict { .. })));
     }
 
+    #[test]
+    fn sharded_trunk_keeps_history_order_across_shards() {
+        let trunk = MemoryTrunk::sharded(8);
+        let branch = BranchId::new("sharded");
+        assert_eq!(trunk.shard_count(), 8);
+
+        for i in 0..32 {
+            trunk
+                .put(&branch, &format!("key-{i}"), Nut { value: vec![i as u8] })
+                .unwrap();
+        }
+        trunk.delete(&branch, "key-3").unwrap();
+
+        let history = trunk.history(&branch).unwrap();
+        assert_eq!(history.len(), 33);
+        for (i, event) in history.iter().take(32).enumerate() {
+            match event {
+                HistoryEvent::Put { key, .. } => assert_eq!(key, &format!("key-{i}")),
+                _ => panic!("expected put history"),
+            }
+        }
+        assert!(matches!(&history[32], HistoryEvent::Delete { key } if key == "key-3"));
+
+        let mut keys = trunk.keys(&branch);
+        keys.sort();
+        assert_eq!(keys.len(), 31);
+        assert_eq!(trunk.tombstones(&branch), vec![("key-3".to_string(), Some(1))]);
+    }
+
+    #[test]
+    fn history_since_never_skips_sequences_under_concurrent_writers() {
+        let trunk = MemoryTrunk::sharded(8);
+        let branch = BranchId::new("cursor");
+        let writers = 8;
+        let writes = 500;
+
+        std::thread::scope(|scope| {
+            for t in 0..writers {
+                let trunk = trunk.clone();
+                let branch = branch.clone();
+                scope.spawn(move || {
+                    for i in 0..writes {
+                        trunk
+                            .put(&branch, &format!("w{t}-k{i}"), Nut { value: vec![t as u8] })
+                            .unwrap();
+                    }
+                });
+            }
+
+            // A cursor that follows the writers must see every sequence exactly once
+            let mut cursor = 0;
+            while cursor < (writers * writes) as u64 {
+                for event in trunk.history_since(&branch, cursor).unwrap() {
+                    let seq = event.unwrap().seq;
+                    assert_eq!(seq, cursor + 1, "sequence {} skipped", cursor + 1);
+                    cursor = seq;
+                }
+            }
+        });
+    }
+
+    #[test]
+    fn history_since_stops_below_a_sequence_still_being_appended() {
+        let trunk = MemoryTrunk::sharded(8);
+        let branch = BranchId::new("watermark");
+        let state = trunk.branch_or_insert(&branch);
+
+        // Seq 1 taken by a writer that has not appended yet (its shard lock is not held here,
+        // so the reader below can walk every shard) while seq 2 lands. A real writer holds
+        // its shard's lock until the ticket drops, so the fast key must be on another shard.
+        let slow = state.shard_index(&trunk.inner, "slow");
+        let fast = (0..)
+            .map(|i| format!("fast-{i}"))
+            .find(|key| state.shard_index(&trunk.inner, key) != slow)
+            .unwrap();
+        let ticket = state.next_seq(slow);
+        trunk.put(&branch, &fast, Nut { value: vec![2] }).unwrap();
+        assert!(trunk.history_since(&branch, 0).unwrap().next().is_none());
+
+        state
+            .shard(&trunk.inner, "slow")
+            .write()
+            .store(ticket.seq, "slow", vec![1], None);
+        drop(ticket);
+        let seqs: Vec<u64> = trunk
+            .history_since(&branch, 0)
+            .unwrap()
+            .map(|event| event.unwrap().seq)
+            .collect();
+        assert_eq!(seqs, vec![1, 2]);
+    }
+
+    #[test]
+    fn branches_are_isolated() {
+        let trunk = MemoryTrunk::sharded(4);
+        let a = BranchId::new("a");
+        let b = BranchId::new("b");
+
+        trunk.put(&a, "key", Nut { value: b"a".to_vec() }).unwrap();
+        assert!(trunk.get(&b, "key").unwrap().is_none());
+        assert_eq!(trunk.current_version(&b, "key"), None);
+        assert!(trunk.keys(&b).is_empty());
+        assert!(matches!(trunk.delete(&b, "key"), Err(AcornError::MissingKey(_))));
+    }
+
+    #[test]
+    fn concurrent_cas_writers_never_lose_updates() {
+        let trunk = MemoryTrunk::sharded(16);
+        let branch = BranchId::new("cas-counter");
+        trunk.put(&branch, "counter", Nut { value: vec![0] }).unwrap();
+
+        std::thread::scope(|scope| {
+            for _ in 0..8 {
+                let trunk = trunk.clone();
+                let branch = branch.clone();
+                scope.spawn(move || {
+                    let mut wins = 0;
+                    while wins < 50 {
+                        let current = trunk.current_version(&branch, "counter");
+                        if trunk
+                            .put_if_version(&branch, "counter", current, Nut { value: vec![1] })
+                            .is_ok()
+                        {
+                            wins += 1;
+                        }
+                    }
+                });
+            }
+        });
+
+        assert_eq!(trunk.current_version(&branch, "counter"), Some(1 + 8 * 50));
+    }
+
+    #[test]
+    fn concurrent_writers_on_separate_branches() {
+        let trunk = MemoryTrunk::sharded_for_host();
+        std::thread::scope(|scope| {
+            for t in 0..8 {
+                let trunk = trunk.clone();
+                scope.spawn(move || {
+                    let branch = BranchId::new(format!("branch-{t}"));
+                    for i in 0..200 {
+                        trunk
+                            .put(&branch, &format!("k{i}"), Nut { value: vec![t as u8] })
+                            .unwrap();
+                    }
+                });
+            }
+        });
+
+        for t in 0..8 {
+            let branch = BranchId::new(format!("branch-{t}"));
+            assert_eq!(trunk.keys(&branch).len(), 200);
+            assert_eq!(trunk.history(&branch).unwrap().len(), 200);
+        }
+    }
+
+    #[test]
+    fn purge_expired_removes_only_due_entries() {
+        let trunk = MemoryTrunk::sharded(4);
+        let branch = BranchId::new("purge");
+        let soon = Ttl {
+            expires_at: SystemTime::now() + std::time::Duration::from_millis(5),
+        };
+        trunk
+            .put_with_ttl(&branch, "short", Nut { value: b"s".to_vec() }, soon)
+            .unwrap();
+        trunk
+            .put(&branch, "forever", Nut { value: b"f".to_vec() })
+            .unwrap();
+
+        std::thread::sleep(std::time::Duration::from_millis(10));
+        assert_eq!(trunk.purge_expired(&branch), 1);
+        assert_eq!(trunk.keys(&branch), vec!["forever".to_string()]);
+        assert_eq!(trunk.tombstones(&branch), vec![("short".to_string(), Some(1))]);
+
+        let stats = trunk.ttl_stats();
+        assert_eq!((stats.tracked, stats.purged, stats.purges), (0, 1, 1));
+        assert!(stats.max_lag >= std::time::Duration::from_millis(5));
+        assert_eq!(trunk.purge_expired(&branch), 0);
+    }
+
+    #[test]
+    fn put_over_expired_entry_restarts_version() {
+        let trunk = MemoryTrunk::sharded(4);
+        let branch = BranchId::new("expired-cas");
+        trunk.put(&branch, "k", Nut { value: b"1".to_vec() }).unwrap();
+        trunk.put(&branch, "k", Nut { value: b"2".to_vec() }).unwrap();
+        let soon = Ttl {
+            expires_at: SystemTime::now() + std::time::Duration::from_millis(5),
+        };
+        trunk
+            .put_with_ttl(&branch, "k", Nut { value: b"3".to_vec() }, soon)
+            .unwrap();
+        std::thread::sleep(std::time::Duration::from_millis(10));
+
+        // Expired reads as absent, and a CAS against "absent" creates it afresh
+        assert_eq!(trunk.current_version(&branch, "k"), None);
+        trunk
+            .put_if_version(&branch, "k", None, Nut { value: b"4".to_vec() })
+            .unwrap();
+        assert_eq!(trunk.current_version(&branch, "k"), Some(1));
+        trunk
+            .put_if_version(&branch, "k", Some(1), Nut { value: b"5".to_vec() })
+            .unwrap();
+        assert_eq!(trunk.current_version(&branch, "k"), Some(2));
+        assert_eq!(trunk.ttl_stats().tracked, 0);
+
+        trunk
+            .put_with_ttl(&branch, "plain", Nut { value: b"a".to_vec() }, soon)
+            .unwrap();
+        std::thread::sleep(std::time::Duration::from_millis(10));
+        trunk.put(&branch, "plain", Nut { value: b"b".to_vec() }).unwrap();
+        assert_eq!(trunk.current_version(&branch, "plain"), Some(1));
+        assert_eq!(trunk.get(&branch, "plain").unwrap().unwrap().value, b"b".to_vec());
+
+        // The expiry is recorded as a delete before the key starts over, so a history reader
+        // does not see version 1 follow version 3
+        let plain: Vec<&'static str> = trunk
+            .history_since(&branch, 0)
+            .unwrap()
+            .filter_map(|event| match event.unwrap().event {
+                HistoryEvent::Put { key, .. } if key == "plain" => Some("put"),
+                HistoryEvent::Delete { key } if key == "plain" => Some("delete"),
+                _ => None,
+            })
+            .collect();
+        assert_eq!(plain, vec!["put", "delete", "put"]);
+        assert!(trunk.tombstones(&branch).iter().all(|(key, _)| key != "plain"));
+    }
+
+    #[test]
+    fn delete_treats_expired_entries_as_absent() {
+        let trunk = MemoryTrunk::new();
+        let branch = BranchId::new("expired-delete");
+        let soon = Ttl {
+            expires_at: SystemTime::now() + std::time::Duration::from_millis(5),
+        };
+        trunk
+            .put_with_ttl(&branch, "a", Nut { value: b"a".to_vec() }, soon)
+            .unwrap();
+        trunk
+            .put_with_ttl(&branch, "b", Nut { value: b"b".to_vec() }, soon)
+            .unwrap();
+        std::thread::sleep(std::time::Duration::from_millis(10));
+
+        assert!(matches!(
+            trunk.delete_if_version(&branch, "a", Some(1)),
+            Err(AcornError::VersionConflict {
+                expected: Some(1),
+                actual: None
+            })
+        ));
+        assert!(matches!(
+            trunk.delete(&branch, "b"),
+            Err(AcornError::MissingKey(_))
+        ));
+    }
+
+    #[cfg(feature = "contract-tests")]
+    #[test]
+    fn contract_sharded_round_trip_and_ttl() {
+        let trunk = MemoryTrunk::sharded(16);
+        TrunkContract::round_trip_bytes(&trunk).unwrap();
+        TrunkContract::ttl_expiry(&trunk).unwrap();
+        TrunkContract::history_put_delete(&trunk).unwrap();
+    }
+
     #[cfg(feature = "contract-tests")]
     #[test]
     fn contract_round_trip_and_ttl() {